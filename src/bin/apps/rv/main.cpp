@@ -52,6 +52,7 @@
 #include <PyTwkApp/PyInterface.h>
 #include <IPCore/Application.h>
 #include <IPCore/NodeDefinition.h>
+#include <IPCore/Session.h>
 #include <RvApp/CommandsModule.h>
 #include <RvApp/PyCommandsModule.h>
 #include <RvApp/Options.h>
@@ -566,16 +567,19 @@ int utf8Main(int argc, char* argv[])
     TWK_DEPLOY_SHOW_LOCAL_BANNER(cout);
 
     //
-    //  Get CPU info and tell the EXR library to use them all
+    //  EXR decodes on the TwkFB pool (see TwkFBThreadPool.h) with as
+    //  many chunks in flight as the pool has threads. -exrcpus sizes
+    //  the pool.
     //
 
     if (opts.exrcpus > 0)
     {
+        TwkFB::ThreadPool::setNumThreads(opts.exrcpus);
         Imf::setGlobalThreadCount(opts.exrcpus);
     }
     else
     {
-        Imf::setGlobalThreadCount(TwkUtil::SystemInfo::numCPUs() > 1 ? (TwkUtil::SystemInfo::numCPUs() - 1) : 1);
+        Imf::setGlobalThreadCount(TwkFB::ThreadPool::getNumThreads());
     }
 
     //
@@ -855,6 +859,21 @@ int utf8Main(int argc, char* argv[])
     pthread_win32_process_detach_np();
 #endif
 
+    //
+    //  The eval and caching threads feed the decode pool so they have
+    //  to stop before it does
+    //
+
+    const TwkApp::Document::Documents& docs = TwkApp::Document::documents();
+
+    for (size_t i = 0; i < docs.size(); i++)
+    {
+        if (IPCore::Session* session = dynamic_cast<IPCore::Session*>(docs[i]))
+        {
+            session->graph().finishCachingThread();
+        }
+    }
+
     TwkFB::ThreadPool::shutdown();
     TwkMovie::GenericIO::shutdown(); // Shutdown TwkMovie::GenericIO plugins
     TwkFB::GenericIO::shutdown();    // Shutdown TwkFB::GenericIO plugins
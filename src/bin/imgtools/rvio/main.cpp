@@ -1259,9 +1259,8 @@ int utf8Main(int argc, char* argv[])
             "-inpremult", ARG_FLAG(&inpremult), "premultiply alpha and color", "-inunpremult", ARG_FLAG(&inunpremult),
             "un-premultiply alpha and color", "-exposure %f", &exposure, "Apply relative exposure change (in stops)", "-scale %f", &scale,
             "Scale input image geometry", "-resize %d [%d]", &resizex, &resizey, "Resize input image geometry to exact size on input",
-            //       "-resampleMethod %S", &resampleMethod, "Resampling method
-            //       (area, linear, cubic, nearest, default=%s)",
-            //       resampleMethod,
+            "-resampleMethod %S", &resampleMethod,
+            "Resampling method for -scale and -resize (area, linear, box, triangle, mitchell, lanczos3, default=%s)", resampleMethod,
             "-dlut %S", &dlut, "Apply display LUT", "-flip", ARG_FLAG(&flipImage),
             "Flip image (flip vertical) (keep orientation flags the same)", "-flop", ARG_FLAG(&flopImage),
             "Flop image (flip horizontal) (keep orientation flags the same)", "-yryby %d %d %d", &ysamples, &rysamples, &bysamples,
@@ -1299,14 +1298,14 @@ int utf8Main(int argc, char* argv[])
             "-debug", ARG_SUBR(&Rv::parseDebugKeyWords), "Debug category", "-version", ARG_FLAG(&showVersion), "Show RVIO version number",
             "-iomethod %d [%d]", &iomethod, &iosize,
             "I/O Method (overrides all) (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             iomethod, iosize, "-exrcpus %d", &opts.exrcpus, "EXR thread count (default=%d)", opts.exrcpus, "-exrRGBA",
             ARG_FLAG(&opts.exrRGBA), "EXR Always read as RGBA (default=false)", "-exrInherit", ARG_FLAG(&opts.exrInherit),
             "EXR guess channel inheritance (default=false)", "-exrNoOneChannel", ARG_FLAG(&opts.exrNoOneChannel),
             "EXR never use one channel planar images (default=false)", "-exrIOMethod %d [%d]", &opts.exrIOMethod, &opts.exrIOSize,
             "EXR I/O Method (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             opts.exrIOMethod, opts.exrIOSize, "-exrReadWindowIsDisplayWindow", ARG_FLAG(&opts.exrReadWindowIsDisplayWindow),
             "EXR read window is display window (default=false)", "-exrReadWindow %d", &opts.exrReadWindow,
@@ -1315,27 +1314,27 @@ int utf8Main(int argc, char* argv[])
             opts.exrReadWindow, "-jpegRGBA", ARG_FLAG(&opts.jpegRGBA), "Make JPEG four channel RGBA on read (default=no, use RGB or YUV)",
             "-jpegIOMethod %d [%d]", &opts.jpegIOMethod, &opts.jpegIOSize,
             "JPEG I/O Method (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             opts.exrIOMethod, opts.exrIOSize, "-cinpixel %S", &opts.cinPixel, "Cineon pixel storage (default=%s)", opts.cinPixel,
             "-cinchroma", ARG_FLAG(&opts.cinchroma), "Use Cineon chromaticity values (for default reader only)", "-cinIOMethod %d [%d]",
             &opts.cinIOMethod, &opts.cinIOSize,
             "Cineon I/O Method (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             opts.cinIOMethod, opts.cinIOSize, "-dpxpixel %S", &opts.dpxPixel, "DPX pixel storage (default=%s)", opts.dpxPixel, "-dpxchroma",
             ARG_FLAG(&opts.dpxchroma), "Use DPX chromaticity values (for default reader only)", "-dpxIOMethod %d [%d]", &opts.dpxIOMethod,
             &opts.dpxIOSize,
             "DPX I/O Method (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             opts.dpxIOMethod, opts.dpxIOSize, "-tgaIOMethod %d [%d]", &opts.tgaIOMethod, &opts.tgaIOSize,
             "TARGA I/O Method (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             opts.tgaIOMethod, opts.tgaIOSize, "-tiffIOMethod %d [%d]", &opts.tiffIOMethod, &opts.tiffIOSize,
             "TIFF I/O Method (0=standard, 1=buffered, 2=unbuffered, "
-            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "
+            "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "
             "optional chunk size (default=%d)",
             opts.tgaIOMethod, opts.tgaIOSize, "-init %S", &initscript, "Override init script", "-err-to-out", ARG_FLAG(&err2out),
             "Output errors to standard output (instead of standard error)", "-strictlicense", ARG_FLAG(&strictlicense),
@@ -26,9 +26,11 @@
 #include <MovieProxy/MovieProxy.h>
 #include <TwkDeploy/Deploy.h>
 #include <TwkMovie/MovieIO.h>
+#include <TwkMovie/MediaInfoIndex.h>
 #include <TwkContainer/GTOReader.h>
 #include <TwkUtil/File.h>
 #include <TwkUtil/FrameUtils.h>
+#include <TwkUtil/PathConform.h>
 #include <algorithm>
 #include <arg.h>
 #include <iomanip>
@@ -286,6 +288,50 @@ string lsAlignedLongOuput(vector<vector<string>>& listing, bool x2 = true)
     return out.str();
 }
 
+//
+//  Opens each movie or sequence so the readers store what they find in
+//  the media info index. Entries which are still up to date are left
+//  alone.
+//
+
+void indexMedia(const vector<string>& media)
+{
+    for (size_t i = 0; i < media.size(); i++)
+    {
+        const string& path = media[i];
+
+        if (path.substr(0, 14) == "RVImageSource|")
+            continue;
+
+        MediaInfoIndex::Entry entry;
+        const string key = pathConform(path);
+
+        if (MediaInfoIndex::find(key, entry) && MediaInfoIndex::validate(key, entry.stamps))
+            continue;
+
+        try
+        {
+            if (MovieReader* reader = TwkMovie::GenericIO::movieReader(path, bruteForce))
+            {
+                try
+                {
+                    reader->open(path);
+                }
+                catch (std::exception& exc)
+                {
+                    cerr << "ERROR: " << path << ": " << exc.what() << endl;
+                }
+
+                delete reader;
+            }
+        }
+        catch (std::exception& exc)
+        {
+            cerr << "ERROR: " << path << ": " << exc.what() << endl;
+        }
+    }
+}
+
 string lsExtended(const string& seq, bool yaml = false)
 {
     YAML::Emitter out_yaml;
@@ -642,6 +688,7 @@ int utf8Main(int argc, char** argv)
     int ns = 0;
     int showFormats = 0;
     int yaml = 0;
+    int index = 0;
     char* debugString = 0;
     char* outputFile = 0;
 
@@ -658,7 +705,8 @@ int utf8Main(int argc, char** argv)
                   &outputFile, "Output log file. Results will be printed to stdout by default", "-nr", ARG_FLAG(&nr),
                   "Do not show frame ranges", "-ns", ARG_FLAG(&ns), "Do not infer sequences (list each file separately)", "-min %d",
                   &minseq, "Minimum number of files considered a sequence (default=%d)", minseq, "-formats", ARG_FLAG(&showFormats),
-                  "List image/movie formats", "-yaml", ARG_FLAG(&yaml), "Output in YAML format. (-x only)", "-version",
+                  "List image/movie formats", "-yaml", ARG_FLAG(&yaml), "Output in YAML format. (-x only)", "-index", ARG_FLAG(&index),
+                  "Open each movie/sequence to pre-warm the media info index (.rv session media as named in the session)", "-version",
                   ARG_FLAG(&showVersion), "Show rvls version number", "-debug %S", &debugString, "Debug category (only 'plugins' for now)",
                   NULL)
         < 0)
@@ -725,6 +773,14 @@ int utf8Main(int argc, char** argv)
 
     TwkFB::GenericIO::compileExtensionSet(predicateFileExtensions());
 
+    //
+    //  The listings never read an image so they would never validate an
+    //  entry, only -index uses it.
+    //
+
+    if (index)
+        MediaInfoIndex::setDefaultDirectory(bundle.cacheItemPath("MediaInfoIndex", ""));
+
     if (inputFiles.empty())
     {
         inputFiles.push_back(".");
@@ -733,6 +789,7 @@ int utf8Main(int argc, char** argv)
     try
     {
         vector<string> allfiles;
+        vector<string> sessionMedia;
 
         for (int i = 0; i < inputFiles.size(); i++)
         {
@@ -759,6 +816,7 @@ int utf8Main(int argc, char** argv)
             else if (path.size() > 2 && path.substr(path.size() - 3, path.size() - 1) == ".rv")
             {
                 allfiles = readSession(path);
+                sessionMedia.insert(sessionMedia.end(), allfiles.begin(), allfiles.end());
             }
             else
             {
@@ -779,7 +837,13 @@ int utf8Main(int argc, char** argv)
         }
         std::sort(seqs.begin(), seqs.end());
 
-        if (l)
+        if (index)
+        {
+            indexMedia(sessionMedia);
+            indexMedia(seqs);
+            MediaInfoIndex::outputStats(out);
+        }
+        else if (l)
         {
             vector<vector<string>> listing(seqs.size() + 1);
             listing.front().push_back("w");
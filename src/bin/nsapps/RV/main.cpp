@@ -533,7 +533,8 @@ int main(int argc, char* argv[])
     TWK_DEPLOY_SHOW_LOCAL_BANNER(cout);
 
     //
-    //  Get CPU info and tell the EXR library to use them all
+    //  EXR decodes on the TwkFB pool (see TwkFBThreadPool.h), by
+    //  default with as many chunks in flight as the pool has threads
     //
 
     if (opts.exrcpus > 0)
@@ -542,7 +543,7 @@ int main(int argc, char* argv[])
     }
     else
     {
-        Imf::setGlobalThreadCount(TwkUtil::SystemInfo::numCPUs() > 1 ? (TwkUtil::SystemInfo::numCPUs() - 1) : 1);
+        Imf::setGlobalThreadCount(TwkFB::ThreadPool::getNumThreads());
     }
 
     //
@@ -263,8 +263,18 @@ namespace IPCore
         {
             if (sp->size())
             {
-                if (sp->front() == "linear")
+                const string& m = sp->front();
+
+                if (m == "linear")
                     s.method = TwkFBAux::LinearInterpolation;
+                else if (m == "box")
+                    s.method = TwkFBAux::BoxInterpolation;
+                else if (m == "triangle")
+                    s.method = TwkFBAux::TriangleInterpolation;
+                else if (m == "mitchell")
+                    s.method = TwkFBAux::MitchellInterpolation;
+                else if (m == "lanczos3")
+                    s.method = TwkFBAux::Lanczos3Interpolation;
             }
         }
 
@@ -580,7 +590,7 @@ namespace IPCore
 
                     if (fb0 != fb1)
                     {
-                        TwkFBAux::resize(fb0, fb1);
+                        TwkFBAux::resize(fb0, fb1, s.method);
                         img->fb = fb1;
                         delete fb0;
                     }
@@ -600,7 +610,7 @@ namespace IPCore
 
                     if (fb != in)
                     {
-                        TwkFBAux::resize(in, fb);
+                        TwkFBAux::resize(in, fb, s.method);
                     }
 
                     img->fb = fb;
@@ -616,7 +626,7 @@ namespace IPCore
 
                     if (fb0 != in)
                     {
-                        TwkFBAux::resize(in, fb0);
+                        TwkFBAux::resize(in, fb0, s.method);
 
                         if (in->isYRYBYPlanar() || in->isYRYBY())
                         {
@@ -60,6 +60,7 @@ namespace IPCore
         virtual ~FormatIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
 
         Params params() const;
@@ -504,12 +504,13 @@ namespace Rv
         "crosshatch)",                                                                                                                     \
         "-formats", ARG_FLAG(&opt.showFormats), "Show all supported image and movie formats", "-apple", ARG_FLAG(&opt.apple),              \
         "Use Quicktime and NSImage libraries (on OS X)", "-cinalt", ARG_FLAG(&opt.cinalt), "Use alternate Cineon/DPX readers",             \
-        "-exrcpus %d", &opt.exrcpus, "EXR thread count (default=%d)", opt.exrcpus, "-exrRGBA", ARG_FLAG(&opt.exrRGBA),                     \
+        "-exrcpus %d", &opt.exrcpus, "EXR and decode pool thread count (default=%d)", opt.exrcpus,                                         \
+        "-exrRGBA", ARG_FLAG(&opt.exrRGBA),                                                                                                \
         "EXR Always read as RGBA (default=false)", "-exrInherit", ARG_FLAG(&opt.exrInherit),                                               \
         "EXR guess channel inheritance (default=false)", "-exrNoOneChannel", ARG_FLAG(&opt.exrNoOneChannel),                               \
         "EXR never use one channel planar images (default=false)", "-exrIOMethod %d [%d]", &opt.exrIOMethod, &opt.exrIOSize,               \
         "EXR I/O Method (0=standard, 1=buffered, 2=unbuffered, 3=MemoryMap, "                                                              \
-        "4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and optional chunk "                                                              \
+        "4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and optional chunk "                                                   \
         "size (default=%d)",                                                                                                               \
         opts.exrIOMethod, opts.exrIOSize, "-exrReadWindowIsDisplayWindow", ARG_FLAG(&opts.exrReadWindowIsDisplayWindow),                   \
         "EXR read window is display window (default=false)", "-exrReadWindow %d", &opt.exrReadWindow,                                      \
@@ -518,27 +519,27 @@ namespace Rv
         opts.exrReadWindow, "-jpegRGBA", ARG_FLAG(&opt.jpegRGBA), "Make JPEG four channel RGBA on read (default=no, use RGB or YUV)",      \
         "-jpegIOMethod %d [%d]", &opt.jpegIOMethod, &opt.jpegIOSize,                                                                       \
         "JPEG I/O Method (0=standard, 1=buffered, 2=unbuffered, 3=MemoryMap, "                                                             \
-        "4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and optional chunk "                                                              \
+        "4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and optional chunk "                                                   \
         "size (default=%d)",                                                                                                               \
         opts.exrIOMethod, opts.exrIOSize, "-cinpixel %S", &opt.cinPixel, "Cineon pixel storage (default=%s)", opt.cinPixel, "-cinchroma",  \
         ARG_FLAG(&opt.cinchroma), "Use Cineon chromaticity values (for default reader only)", "-cinIOMethod %d [%d]", &opt.cinIOMethod,    \
         &opt.cinIOSize,                                                                                                                    \
         "Cineon I/O Method (0=standard, 1=buffered, 2=unbuffered, "                                                                        \
-        "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "                                                                \
+        "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "                                                     \
         "optional chunk size (default=%d)",                                                                                                \
         opts.cinIOMethod, opts.cinIOSize, "-dpxpixel %S", &opt.dpxPixel, "DPX pixel storage (default=%s)", opt.dpxPixel, "-dpxchroma",     \
         ARG_FLAG(&opt.dpxchroma), "Use DPX chromaticity values (for default reader only)", "-dpxIOMethod %d [%d]", &opt.dpxIOMethod,       \
         &opt.dpxIOSize,                                                                                                                    \
         "DPX I/O Method (0=standard, 1=buffered, 2=unbuffered, 3=MemoryMap, "                                                              \
-        "4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and optional chunk "                                                              \
+        "4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and optional chunk "                                                   \
         "size (default=%d)",                                                                                                               \
         opts.dpxIOMethod, opts.dpxIOSize, "-tgaIOMethod %d [%d]", &opt.tgaIOMethod, &opt.tgaIOSize,                                        \
         "TARGA I/O Method (0=standard, 1=buffered, 2=unbuffered, "                                                                         \
-        "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and "                                                                \
+        "3=MemoryMap, 4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and "                                                     \
         "optional chunk size (default=%d)",                                                                                                \
         opts.tgaIOMethod, opts.tgaIOSize, "-tiffIOMethod %d [%d]", &opt.tiffIOMethod, &opt.tiffIOSize,                                     \
         "TIFF I/O Method (0=standard, 1=buffered, 2=unbuffered, 3=MemoryMap, "                                                             \
-        "4=AsyncBuffered, 5=AsyncUnbuffered, default=%d) and optional chunk "                                                              \
+        "4=AsyncBuffered, 5=AsyncUnbuffered, 6=IOUring, default=%d) and optional chunk "                                                   \
         "size (default=%d)",                                                                                                               \
         opts.tgaIOMethod, opts.tgaIOSize, "-lic %S", &opt.licarg, "Use specific license file", "-noPrefs", ARG_FLAG(&opt.noPrefs),         \
         "Ignore preferences", "-resetPrefs", ARG_FLAG(&opt.resetPrefs), "Reset preferences to default values", "-qtcss %S", &opt.qtcss,    \
@@ -43,6 +43,7 @@
 #include <TwkApp/VideoDevice.h>
 #include <TwkContainer/PropertyContainer.h>
 #include <TwkFB/IO.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkAudio/AudioFormats.h>
 #include <TwkMovie/MovieIO.h>
 #include <TwkUtil/SystemInfo.h>
@@ -1870,7 +1871,7 @@ namespace Rv
     {
         if (m_ui.exrNumThreadsEdit->text() == "0")
         {
-            Imf::setGlobalThreadCount(TwkUtil::SystemInfo::numCPUs() > 1 ? (TwkUtil::SystemInfo::numCPUs() - 1) : 1);
+            Imf::setGlobalThreadCount(TwkFB::ThreadPool::getNumThreads());
         }
         else
         {
@@ -1885,7 +1886,7 @@ namespace Rv
             m_ui.exrNumThreadsEdit->setText("0");
             m_ui.exrNumThreadsEdit->setEnabled(false);
             m_ui.exrThreadsLabel->setEnabled(false);
-            Imf::setGlobalThreadCount(TwkUtil::SystemInfo::numCPUs() > 1 ? (TwkUtil::SystemInfo::numCPUs() - 1) : 1);
+            Imf::setGlobalThreadCount(TwkFB::ThreadPool::getNumThreads());
         }
         else
         {
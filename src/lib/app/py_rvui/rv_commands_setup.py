@@ -317,6 +317,14 @@ all_mu_commands = [
     "sourceMediaRepsAndNodes",
     "devicePixelRatio",
     "waitForProgressiveLoading",
+    "setSourceCacheQuota",
+    "setSourceCacheWeight",
+    "setFairShareCaching",
+    "fairShareCaching",
+    "sourceCacheInfo",
+    "setScrubPrefetch",
+    "scrubPrefetch",
+    "prefetchCacheInfo",
 ]
 
 
@@ -19,6 +19,7 @@
 #include <math.h>
 #include <string>
 #include <vector>
+#include <deque>
 #include <sstream>
 #include <sys/types.h>
 #ifdef WIN32
@@ -33,6 +34,19 @@
 #include <stl_ext/replace_alloc.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+
+#ifdef PLATFORM_LINUX
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_SINGLE_MMAP)
+#define TWK_HAVE_IO_URING
+#endif
+#endif
 
 #if defined(PLATFORM_APPLE_MACH_BSD)
 //
@@ -590,6 +604,438 @@ namespace TwkUtil
 #endif //  PLATFORM_LINUX
 #endif //  _POSIX_ASYNCHRONOUS_IO
 
+    //
+    //  io_uring, through the system calls directly (no liburing). One
+    //  ring serves every file of a batch: the reads are split into
+    //  chunks and the queue is kept full across files, so a batch of
+    //  frames keeps an NVMe drive or a parallel NFS mount busy even when
+    //  each frame is small. The destination buffers are registered with
+    //  the ring when the kernel allows it (READ_FIXED saves mapping the
+    //  pages on every request) otherwise READV is used.
+    //
+
+    struct UringFile
+    {
+        int fd;
+        size_t offset;      //  File offset of the first byte
+        size_t size;        //  Bytes to read through the ring
+        char* buffer;
+        size_t requested;   //  Bytes requested so far
+        size_t chunkSize;   //  Bytes per request
+        int bufferIndex;    //  Registered buffer or -1
+    };
+
+#ifdef TWK_HAVE_IO_URING
+
+    class UringReadRequestList
+    {
+    public:
+        UringReadRequestList(int depth);
+        ~UringReadRequestList();
+
+        //
+        //  False if the kernel doesn't do io_uring (or isn't allowed
+        //  to), in which case read() can't be used.
+        //
+
+        bool valid() const { return m_ring >= 0; }
+
+        //
+        //  A ring is reused for many reads, up to entries() of them in
+        //  flight. One whose read failed can't be: requests the kernel
+        //  didn't take may still be in its queue.
+        //
+
+        unsigned int entries() const { return m_entries; }
+
+        bool failed() const { return m_error != 0; }
+
+        //
+        //  Reads all the files with up to depth requests in flight,
+        //  throws if any of the reads fails. Every request the kernel
+        //  took has completed by then: the buffers can be freed.
+        //
+
+        void read(vector<UringFile>& files, unsigned int depth);
+
+    private:
+        struct Request
+        {
+            size_t file;
+            size_t offset;
+            size_t size;
+            struct iovec iov;
+        };
+
+        void release();
+        void prepare(Request&, const vector<UringFile>&, bool fixed);
+        bool enter();
+        void reap(vector<UringFile>& files);
+
+        int m_ring;
+        unsigned int m_entries;
+
+        void* m_sqRing;
+        size_t m_sqRingSize;
+        void* m_cqRing;
+        size_t m_cqRingSize;
+        struct io_uring_sqe* m_sqes;
+        size_t m_sqesSize;
+
+        unsigned int* m_sqTail;
+        unsigned int m_sqMask;
+        unsigned int* m_sqArray;
+        unsigned int* m_cqHead;
+        unsigned int* m_cqTail;
+        unsigned int m_cqMask;
+        struct io_uring_cqe* m_cqes;
+
+        vector<Request> m_requests;
+        vector<size_t> m_freeRequests;
+        vector<size_t> m_retries;  //  Short reads to finish
+        unsigned int m_pending;    //  Queued but not yet taken by the kernel
+        unsigned int m_inFlight;   //  Taken by the kernel, not completed
+        int m_error;
+    };
+
+    UringReadRequestList::UringReadRequestList(int depth)
+        : m_ring(-1)
+        , m_entries(0)
+        , m_sqRing(MAP_FAILED)
+        , m_sqRingSize(0)
+        , m_cqRing(MAP_FAILED)
+        , m_cqRingSize(0)
+        , m_sqes((struct io_uring_sqe*)MAP_FAILED)
+        , m_sqesSize(0)
+        , m_pending(0)
+        , m_inFlight(0)
+        , m_error(0)
+    {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+
+        m_ring = syscall(__NR_io_uring_setup, max(depth, 1), &params);
+        if (m_ring < 0)
+            return;
+
+        //
+        //  Kernels before 5.4 map the two rings separately
+        //
+
+        const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (single)
+            m_sqRingSize = m_cqRingSize = max(m_sqRingSize, m_cqRingSize);
+        m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+        m_sqRing = mmap(0, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+        if (single)
+            m_cqRing = m_sqRing;
+        else
+            m_cqRing = mmap(0, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+        m_sqes = (struct io_uring_sqe*)mmap(0, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+
+        if (m_sqRing == MAP_FAILED || m_cqRing == MAP_FAILED || m_sqes == MAP_FAILED)
+        {
+            release();
+            return;
+        }
+
+        char* sq = (char*)m_sqRing;
+        char* cq = (char*)m_cqRing;
+
+        m_sqTail = (unsigned int*)(sq + params.sq_off.tail);
+        m_sqMask = *(unsigned int*)(sq + params.sq_off.ring_mask);
+        m_sqArray = (unsigned int*)(sq + params.sq_off.array);
+        m_cqHead = (unsigned int*)(cq + params.cq_off.head);
+        m_cqTail = (unsigned int*)(cq + params.cq_off.tail);
+        m_cqMask = *(unsigned int*)(cq + params.cq_off.ring_mask);
+        m_cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+        //
+        //  The completion queue is at least as big as the submission
+        //  queue so it can't overflow with one request per entry.
+        //
+
+        m_entries = params.sq_entries;
+        m_requests.resize(m_entries);
+        for (size_t i = 0; i < m_entries; ++i)
+            m_freeRequests.push_back(m_entries - 1 - i);
+    }
+
+    UringReadRequestList::~UringReadRequestList() { release(); }
+
+    void UringReadRequestList::release()
+    {
+        if (m_sqes != MAP_FAILED)
+            munmap(m_sqes, m_sqesSize);
+        if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+            munmap(m_cqRing, m_cqRingSize);
+        if (m_sqRing != MAP_FAILED)
+            munmap(m_sqRing, m_sqRingSize);
+        if (m_ring >= 0)
+            close(m_ring);
+
+        m_sqes = (struct io_uring_sqe*)MAP_FAILED;
+        m_cqRing = m_sqRing = MAP_FAILED;
+        m_ring = -1;
+    }
+
+    void UringReadRequestList::prepare(Request& r, const vector<UringFile>& files, bool fixed)
+    {
+        const UringFile& f = files[r.file];
+        const unsigned int tail = *m_sqTail;
+        const unsigned int index = tail & m_sqMask;
+        struct io_uring_sqe* sqe = m_sqes + index;
+
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->fd = f.fd;
+        sqe->off = f.offset + r.offset;
+        sqe->user_data = &r - &m_requests[0];
+
+        if (fixed && f.bufferIndex >= 0)
+        {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = (unsigned long)(f.buffer + r.offset);
+            sqe->len = r.size;
+            sqe->buf_index = f.bufferIndex;
+        }
+        else
+        {
+            r.iov.iov_base = f.buffer + r.offset;
+            r.iov.iov_len = r.size;
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = (unsigned long)&r.iov;
+            sqe->len = 1;
+        }
+
+        m_sqArray[index] = index;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++m_pending;
+    }
+
+    //
+    //  Hand the queued requests to the kernel and wait for at least one
+    //  completion. Returns false if the ring refuses them.
+    //
+
+    bool UringReadRequestList::enter()
+    {
+        for (;;)
+        {
+            int n = syscall(__NR_io_uring_enter, m_ring, m_pending, 1, IORING_ENTER_GETEVENTS, 0, 0);
+
+            if (n >= 0)
+            {
+                m_pending -= n;
+                m_inFlight += n;
+                return true;
+            }
+
+            if (errno == EINTR)
+                continue;
+
+            //
+            //  EAGAIN and EBUSY mean the kernel is out of resources
+            //  until some of the current requests complete.
+            //
+
+            if ((errno == EAGAIN || errno == EBUSY) && m_inFlight)
+            {
+                if (syscall(__NR_io_uring_enter, m_ring, 0, 1, IORING_ENTER_GETEVENTS, 0, 0) >= 0 || errno == EINTR)
+                    return true;
+            }
+
+            if (!m_error)
+                m_error = errno;
+            return false;
+        }
+    }
+
+    void UringReadRequestList::reap(vector<UringFile>& files)
+    {
+        unsigned int head = *m_cqHead;
+
+        while (head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+        {
+            const struct io_uring_cqe* cqe = m_cqes + (head & m_cqMask);
+            const size_t index = cqe->user_data;
+            Request& r = m_requests[index];
+
+            --m_inFlight;
+
+            if (cqe->res < 0)
+            {
+                if (!m_error)
+                    m_error = -cqe->res;
+                m_freeRequests.push_back(index);
+            }
+            else if (cqe->res == 0)
+            {
+                if (!m_error)
+                    m_error = EIO;
+                m_freeRequests.push_back(index);
+            }
+            else if (size_t(cqe->res) < r.size)
+            {
+                r.offset += cqe->res;
+                r.size -= cqe->res;
+                m_retries.push_back(index);
+            }
+            else
+            {
+                m_freeRequests.push_back(index);
+            }
+
+            ++head;
+        }
+
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    void UringReadRequestList::read(vector<UringFile>& files, unsigned int depth)
+    {
+        //
+        //  Registering fails for more than UIO_MAXIOV buffers, buffers
+        //  over 1GB or, on kernels before 5.12, when the pinned pages
+        //  would go over RLIMIT_MEMLOCK.
+        //
+
+        vector<struct iovec> buffers;
+        bool fixed = files.size() <= 1024;
+
+        for (size_t i = 0; i < files.size() && fixed; ++i)
+        {
+            UringFile& f = files[i];
+
+            if (f.size > (size_t(1) << 30))
+                fixed = false;
+            else if (f.size)
+            {
+                struct iovec iov;
+                iov.iov_base = f.buffer;
+                iov.iov_len = f.size;
+                f.bufferIndex = buffers.size();
+                buffers.push_back(iov);
+            }
+        }
+
+        if (fixed && !buffers.empty())
+        {
+            fixed = syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_BUFFERS, &buffers[0], buffers.size()) == 0;
+        }
+
+        size_t next = 0;
+
+        for (;;)
+        {
+            //
+            //  Fill the queue, unfinished short reads first. Nothing new
+            //  is started once a read has failed.
+            //
+
+            while (!m_error && !m_retries.empty())
+            {
+                prepare(m_requests[m_retries.back()], files, fixed);
+                m_retries.pop_back();
+            }
+
+            while (!m_error && !m_freeRequests.empty() && m_inFlight + m_pending < depth && next < files.size())
+            {
+                UringFile& f = files[next];
+
+                if (f.requested == f.size)
+                {
+                    ++next;
+                    continue;
+                }
+
+                Request& r = m_requests[m_freeRequests.back()];
+                m_freeRequests.pop_back();
+
+                r.file = next;
+                r.offset = f.requested;
+                r.size = min(f.chunkSize, f.size - f.requested);
+                f.requested += r.size;
+
+                prepare(r, files, fixed);
+            }
+
+            if (m_inFlight == 0 && m_pending == 0)
+                break;
+
+            if (!enter())
+            {
+                //
+                //  The requests the kernel didn't take are dropped but
+                //  the ones in flight still write to the buffers, so
+                //  keep waiting for them. Only a ring that can't even
+                //  wait gives up on them.
+                //
+
+                if (m_pending == 0)
+                    break;
+                m_pending = 0;
+                continue;
+            }
+
+            reap(files);
+        }
+
+        if (fixed && !buffers.empty())
+            syscall(__NR_io_uring_register, m_ring, IORING_UNREGISTER_BUFFERS, 0, 0);
+
+        if (m_error)
+        {
+            TWK_THROW_EXC_STREAM("io_uring read failed: " << strerror(m_error));
+        }
+    }
+
+#else //  TWK_HAVE_IO_URING
+
+    class UringReadRequestList
+    {
+    public:
+        UringReadRequestList(int) {}
+
+        bool valid() const { return false; }
+
+        unsigned int entries() const { return 0; }
+
+        bool failed() const { return false; }
+
+        void read(vector<UringFile>&, unsigned int) {}
+    };
+
+#endif //  TWK_HAVE_IO_URING
+
+    static bool uringAvailable()
+    {
+        static const bool available = UringReadRequestList(1).valid();
+        return available;
+    }
+
+    //
+    //  Setting up a ring (and mapping its queues) costs about as much as
+    //  reading a small frame, so each thread keeps one for all of its
+    //  reads. It's replaced when a read wants it deeper or when a read
+    //  failed on it. Returns 0 without io_uring.
+    //
+
+    static UringReadRequestList* threadRing(int depth)
+    {
+        static thread_local unique_ptr<UringReadRequestList> ring;
+
+        if (!uringAvailable())
+            return 0;
+
+        if (!ring || ring->failed() || ring->entries() < unsigned(max(depth, 1)))
+            ring.reset(new UringReadRequestList(depth));
+
+        return ring->valid() ? ring.get() : 0;
+    }
+
     static int bufferingMessageCount = 0;
 
     FileStream::FileStream(const string& filename, Type type, size_t size, int maxInFlight, bool deleteOnDestruction)
@@ -623,30 +1069,28 @@ namespace TwkUtil
         initialize();
     }
 
-    void FileStream::initialize()
-    {
-        if (m_type == ASyncBuffering)
-        {
-            //
-            //  Async only works on descriptors opened with O_DIRECT.
-            //
-            m_type = ASyncNonBuffering;
-        }
+    //
+    //  Opens m_file, with O_DIRECT for the unbuffered types if the
+    //  filesystem allows it, and finds the number of bytes to read.
+    //  Returns true for O_DIRECT.
+    //
 
-        /*
-        cerr << "FileStream, size " << m_chunkSize <<
-                " m_type " << m_type <<
-                " thread " << pthread_self() << "   " <<
-                mbps() << " MB/sec " << endl;
-        */
+    bool FileStream::openFile()
+    {
+        //
+        //  Open the file
+        //
 
-        MbpsCalculator::Monitor mon(mbpsCalc);
+        int direct = (m_type == ASyncNonBuffering || m_type == NonBuffering || m_type == IOUring) ? O_DIRECT : 0;
 
         //
-        //  Open the file
+        //  io_uring reads at the start offset so it has to be aligned
+        //  for O_DIRECT too.
         //
 
-        int direct = (m_type == ASyncNonBuffering || m_type == NonBuffering) ? O_DIRECT : 0;
+        if (m_type == IOUring && m_startOffset % 512)
+            direct = 0;
+
         m_file = TwkUtil::open(m_filename.c_str(), O_RDONLY | direct);
 
         if (m_file == -1)
@@ -660,7 +1104,8 @@ namespace TwkUtil
                          << endl;
                 }
                 direct = 0;
-                m_type = Buffering;
+                if (m_type != IOUring)
+                    m_type = Buffering;
                 m_file = TwkUtil::open(m_filename.c_str(), O_RDONLY);
             }
 
@@ -701,6 +1146,393 @@ namespace TwkUtil
             m_chunkSize = max(size_t(512), 512 * (m_chunkSize / 512));
         }
 
+        return direct != 0;
+    }
+
+    //
+    //  Sets up an io_uring read of the O_DIRECT readable part of the
+    //  file. finishUring() reads the rest and closes the file.
+    //
+
+    void FileStream::openForUring(UringFile& f)
+    {
+        const bool direct = openFile();
+
+        m_rawdata = MemPool::alloc(m_fileSize);
+        if (!m_rawdata)
+        {
+            close(m_file);
+            m_file = -1;
+            TWK_THROW_EXC_STREAM("Out of memory");
+        }
+
+        f.fd = m_file;
+        f.offset = m_startOffset;
+        f.size = direct ? m_fileSize - m_fileSize % 512 : m_fileSize;
+        f.buffer = (char*)m_rawdata;
+        f.requested = 0;
+        f.chunkSize = max(m_chunkSize, size_t(512));
+        f.bufferIndex = -1;
+    }
+
+    void FileStream::finishUring(UringFile& f)
+    {
+        close(m_file);
+        m_file = -1;
+
+        if (size_t leftOverSize = m_fileSize - f.size)
+        {
+            int file = TwkUtil::open(m_filename.c_str(), O_RDONLY);
+
+            if (file == -1 || -1 == pread(file, f.buffer + f.size, leftOverSize, f.offset + f.size))
+            {
+                if (file != -1)
+                    close(file);
+                TWK_THROW_EXC_STREAM("read2: " << strerror(errno) << ": " << m_filename);
+            }
+            close(file);
+        }
+    }
+
+    void FileStream::readMany(const vector<string>& filenames, vector<FileStream*>& streams, size_t chunkSize, int maxInFlight,
+                              bool deleteOnDestruction)
+    {
+        streams.clear();
+
+        UringReadRequestList* ring = threadRing(maxInFlight);
+        vector<UringFile> files;
+
+        try
+        {
+            if (!ring)
+            {
+                for (size_t i = 0; i < filenames.size(); ++i)
+                {
+                    streams.push_back(new FileStream(filenames[i], ASyncNonBuffering, chunkSize, maxInFlight, deleteOnDestruction));
+                }
+                return;
+            }
+
+            MbpsCalculator::Monitor mon(mbpsCalc);
+            size_t bytes = 0;
+
+            files.reserve(filenames.size());
+
+            for (size_t i = 0; i < filenames.size(); ++i)
+            {
+                FileStream* s = new FileStream(filenames[i], chunkSize, maxInFlight, deleteOnDestruction, Deferred());
+                streams.push_back(s);
+
+                files.push_back(UringFile());
+                files.back().fd = -1;
+                s->openForUring(files.back());
+                bytes += s->m_fileSize;
+            }
+
+            ring->read(files, max(maxInFlight, 1));
+
+            for (size_t i = 0; i < streams.size(); ++i)
+            {
+                streams[i]->finishUring(files[i]);
+            }
+
+            mon.setBytes(bytes);
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < streams.size(); ++i)
+            {
+                if (streams[i]->m_file != -1)
+                    close(streams[i]->m_file);
+                streams[i]->m_deleteOnDestruction = true;
+                delete streams[i];
+            }
+
+            streams.clear();
+            throw;
+        }
+    }
+
+    //
+    //  Files read by readAhead() waiting for a FileStream to take them,
+    //  oldest first. Each remembers the file's size and modification
+    //  time so a file changed since is read again. The data of a file
+    //  still being read is 0: a FileStream opened on it meanwhile reads
+    //  the file itself and takes the entry out so the read ahead data
+    //  is dropped when it arrives. Their bytes (counting those being
+    //  read) are in readAheadTotal.
+    //
+
+    struct ReadAheadFile
+    {
+        string filename;
+        void* data;
+        size_t size;
+        off_t fileSize;
+        struct timespec modified;
+    };
+
+    static const size_t readAheadMaxBytes = size_t(256) << 20;
+    static pthread_mutex_t readAheadLock = PTHREAD_MUTEX_INITIALIZER;
+    static deque<ReadAheadFile> readAheadFiles;
+    static atomic<size_t> readAheadTotal(0);
+
+    static struct timespec modificationTime(const struct stat& sb)
+    {
+#ifdef PLATFORM_APPLE_MACH_BSD
+        return sb.st_mtimespec;
+#else
+        return sb.st_mtim;
+#endif
+    }
+
+    static deque<ReadAheadFile>::iterator findReadAhead(const string& filename)
+    {
+        deque<ReadAheadFile>::iterator i = readAheadFiles.begin();
+
+        while (i != readAheadFiles.end() && i->filename != filename)
+            ++i;
+
+        return i;
+    }
+
+    static bool takeReadAhead(const string& filename, void*& data, ssize_t& size)
+    {
+        ReadAheadFile file;
+
+        pthread_mutex_lock(&readAheadLock);
+
+        deque<ReadAheadFile>::iterator i = findReadAhead(filename);
+        const bool found = i != readAheadFiles.end();
+
+        if (found)
+        {
+            file = *i;
+            readAheadFiles.erase(i);
+            readAheadTotal -= file.size;
+        }
+
+        pthread_mutex_unlock(&readAheadLock);
+
+        if (!found || !file.data)
+            return false;
+
+        struct stat sb;
+
+        if (TwkUtil::stat(filename.c_str(), &sb) || sb.st_size != file.fileSize
+            || modificationTime(sb).tv_sec != file.modified.tv_sec || modificationTime(sb).tv_nsec != file.modified.tv_nsec)
+        {
+            FileStream::deleteDataPointer(file.data);
+            return false;
+        }
+
+        data = file.data;
+        size = file.size;
+        return true;
+    }
+
+    //
+    //  Drops the oldest files read ahead until the rest fit
+    //
+
+    static void trimReadAhead()
+    {
+        for (deque<ReadAheadFile>::iterator i = readAheadFiles.begin(); readAheadTotal > readAheadMaxBytes && i != readAheadFiles.end();)
+        {
+            if (!i->data)
+            {
+                ++i;
+                continue;
+            }
+
+            readAheadTotal -= i->size;
+            FileStream::deleteDataPointer(i->data);
+            i = readAheadFiles.erase(i);
+        }
+    }
+
+    size_t FileStream::readAheadBytes() { return readAheadTotal; }
+
+    void FileStream::readAhead(const vector<string>& filenames, size_t chunkSize, int maxInFlight)
+    {
+        if (filenames.empty() || !uringAvailable())
+            return;
+
+        vector<ReadAheadFile> files;
+        vector<string> names;
+        size_t bytes = 0;
+
+        for (size_t i = 0; i < filenames.size(); ++i)
+        {
+            struct stat sb;
+
+            if (TwkUtil::stat(filenames[i].c_str(), &sb) || !S_ISREG(sb.st_mode) || !sb.st_size
+                || bytes + sb.st_size > readAheadMaxBytes)
+            {
+                continue;
+            }
+
+            ReadAheadFile file;
+            file.filename = filenames[i];
+            file.data = 0;
+            file.size = sb.st_size;
+            file.fileSize = sb.st_size;
+            file.modified = modificationTime(sb);
+            files.push_back(file);
+            bytes += sb.st_size;
+        }
+
+        //
+        //  Claim the files nobody has read ahead yet, their bytes count
+        //  from now on
+        //
+
+        pthread_mutex_lock(&readAheadLock);
+
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            if (findReadAhead(files[i].filename) != readAheadFiles.end())
+                continue;
+
+            readAheadFiles.push_back(files[i]);
+            readAheadTotal += files[i].size;
+            names.push_back(files[i].filename);
+        }
+
+        trimReadAhead();
+
+        pthread_mutex_unlock(&readAheadLock);
+
+        if (names.empty())
+            return;
+
+        vector<FileStream*> streams;
+
+        try
+        {
+            readMany(names, streams, chunkSize, maxInFlight, false);
+        }
+        catch (...)
+        {
+            //
+            //  The frames report their own errors when they're read
+            //
+        }
+
+        pthread_mutex_lock(&readAheadLock);
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            deque<ReadAheadFile>::iterator f = findReadAhead(names[i]);
+            void* data = i < streams.size() ? streams[i]->data() : 0;
+            const size_t size = i < streams.size() ? streams[i]->size() : 0;
+
+            if (i < streams.size())
+                delete streams[i];
+
+            //
+            //  Taken (or dropped) while it was being read
+            //
+
+            if (f == readAheadFiles.end() || f->data || !data)
+            {
+                if (f != readAheadFiles.end() && !f->data)
+                {
+                    readAheadTotal -= f->size;
+                    readAheadFiles.erase(f);
+                }
+
+                if (data)
+                    deleteDataPointer(data);
+                continue;
+            }
+
+            readAheadTotal -= f->size;
+            readAheadTotal += size;
+            f->data = data;
+            f->size = size;
+        }
+
+        trimReadAhead();
+
+        pthread_mutex_unlock(&readAheadLock);
+    }
+
+    FileStream::FileStream(const string& filename, size_t size, int maxInFlight, bool deleteOnDestruction, Deferred)
+        : m_filename(filename)
+        , m_type(IOUring)
+        , m_chunkSize(size)
+        , m_rawdata(0)
+        , m_fileSize(0)
+        , m_startOffset(0)
+        , m_readSize(0)
+        , m_size(0)
+        , m_private(0)
+        , m_file(-1)
+        , m_maxInFlight(maxInFlight)
+        , m_deleteOnDestruction(deleteOnDestruction)
+    {
+    }
+
+    static int uringMessageCount = 0;
+
+    void FileStream::initialize()
+    {
+        if (m_type == ASyncBuffering)
+        {
+            //
+            //  Async only works on descriptors opened with O_DIRECT.
+            //
+            m_type = ASyncNonBuffering;
+        }
+
+        if (m_type == IOUring)
+        {
+            if (!m_startOffset && !m_readSize && takeReadAhead(m_filename, m_rawdata, m_fileSize))
+                return;
+
+            if (UringReadRequestList* ring = threadRing(m_maxInFlight))
+            {
+                MbpsCalculator::Monitor mon(mbpsCalc);
+                vector<UringFile> files(1);
+
+                openForUring(files[0]);
+
+                try
+                {
+                    ring->read(files, max(m_maxInFlight, 1));
+                }
+                catch (...)
+                {
+                    close(m_file);
+                    MemPool::dealloc(m_rawdata);
+                    m_rawdata = 0;
+                    throw;
+                }
+
+                finishUring(files[0]);
+                mon.setBytes(m_fileSize);
+                return;
+            }
+
+            if (uringMessageCount++ < 5)
+            {
+                cerr << "WARNING: io_uring is not available, falling back to asynchronous unbuffered reads." << endl;
+            }
+            m_type = ASyncNonBuffering;
+        }
+
+        /*
+        cerr << "FileStream, size " << m_chunkSize <<
+                " m_type " << m_type <<
+                " thread " << pthread_self() << "   " <<
+                mbps() << " MB/sec " << endl;
+        */
+
+        MbpsCalculator::Monitor mon(mbpsCalc);
+
+        const bool direct = openFile();
+
         //
         //  We can't read non-multiple-of-512-sized files with
         //  O_DIRECT, so read in two steps.  First the multiple of
@@ -749,14 +1581,24 @@ namespace TwkUtil
         }
         else if (m_type == MemoryMap)
         {
-            m_rawdata = mmap(0, m_fileSize, PROT_READ, MAP_SHARED, m_file, 0);
-            posix_madvise(m_rawdata, m_fileSize, POSIX_MADV_SEQUENTIAL | POSIX_MADV_WILLNEED);
+            //
+            //  The mapping is private so the pages can be modified in
+            //  place (copy on write) when the data is handed over to a
+            //  FrameBuffer. The offset of a mapping has to be page aligned.
+            //
+
+            const size_t skip = m_startOffset % size_t(sysconf(_SC_PAGESIZE));
+            void* base = mmap(0, m_fileSize + skip, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_file, m_startOffset - skip);
+            close(m_file);
 
-            if (m_rawdata == MAP_FAILED)
+            if (base == MAP_FAILED)
             {
-                close(m_file);
+                m_rawdata = 0;
                 TWK_THROW_EXC_STREAM("MMap: " << strerror(errno) << ": " << m_filename);
             }
+
+            m_rawdata = (char*)base + skip;
+            posix_madvise(base, m_fileSize + skip, POSIX_MADV_SEQUENTIAL | POSIX_MADV_WILLNEED);
         }
 
         //
@@ -781,10 +1623,9 @@ namespace TwkUtil
     {
         if (m_type == MemoryMap)
         {
-            if (m_rawdata && m_fileSize)
+            if (m_rawdata && m_fileSize && m_deleteOnDestruction)
             {
-                munmap(m_rawdata, m_fileSize);
-                close(m_file);
+                unmapMemory(m_rawdata, m_fileSize);
             }
         }
         else if (m_deleteOnDestruction)
@@ -795,6 +1636,28 @@ namespace TwkUtil
 
     void FileStream::deleteDataPointer(void* p) { MemPool::dealloc(p); }
 
+    bool FileStream::releaseMemoryMap()
+    {
+        if (m_type != MemoryMap || !m_rawdata)
+            return false;
+
+        struct stat sb;
+
+        if (TwkUtil::stat(m_filename.c_str(), &sb) || sb.st_size < off_t(m_startOffset + m_fileSize))
+        {
+            return false;
+        }
+
+        m_deleteOnDestruction = false;
+        return true;
+    }
+
+    void FileStream::unmapMemory(void* p, size_t size)
+    {
+        const size_t skip = size_t(p) % size_t(sysconf(_SC_PAGESIZE));
+        munmap((char*)p - skip, size + skip);
+    }
+
 #else
 
     struct WinStreamPrivate;
@@ -894,6 +1757,9 @@ namespace TwkUtil
 
     void FileStream::initialize()
     {
+        if (m_type == IOUring)
+            m_type = ASyncNonBuffering;
+
         WinStreamPrivate* imp = new WinStreamPrivate;
         m_private = imp;
 
@@ -1011,7 +1877,12 @@ namespace TwkUtil
         }
         else if (m_type == MemoryMap)
         {
-            imp->m_map = CreateFileMapping(imp->m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+            //
+            //  Copy on write view, see the unix version. The offset of a
+            //  view has to be a multiple of the allocation granularity.
+            //
+
+            imp->m_map = CreateFileMapping(imp->m_file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
 
             if (!imp->m_map || imp->m_map == INVALID_HANDLE_VALUE)
             {
@@ -1019,13 +1890,21 @@ namespace TwkUtil
                 TWK_THROW_EXC_STREAM("CreateFileMapping: cannot open " << m_filename);
             }
 
-            m_rawdata = (void*)MapViewOfFile(imp->m_map, FILE_MAP_READ, 0, 0, 0);
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            const ULONGLONG skip = m_startOffset % info.dwAllocationGranularity;
+            const ULONGLONG offset = m_startOffset - skip;
 
-            if (!m_rawdata)
+            char* base = (char*)MapViewOfFile(imp->m_map, FILE_MAP_COPY, DWORD(offset >> 32), DWORD(offset & 0xffffffff),
+                                              SIZE_T(m_fileSize + skip));
+
+            if (!base)
             {
                 CloseHandle(imp->m_file);
                 TWK_THROW_EXC_STREAM("MapViewOfFile: cannot open " << m_filename);
             }
+
+            m_rawdata = base + skip;
         }
         else if (m_type == ASyncBuffering || m_type == ASyncNonBuffering)
         {
@@ -1111,8 +1990,8 @@ namespace TwkUtil
 
         if (imp->m_map)
         {
-            if (m_rawdata)
-                UnmapViewOfFile(m_rawdata);
+            if (m_rawdata && m_deleteOnDestruction)
+                unmapMemory(m_rawdata, m_fileSize);
             if (imp->m_map != INVALID_HANDLE_VALUE)
                 CloseHandle(imp->m_map);
             if (imp->m_file && imp->m_file != INVALID_HANDLE_VALUE)
@@ -1128,6 +2007,52 @@ namespace TwkUtil
 
     void FileStream::deleteDataPointer(void* p) { MemPool::dealloc(p); }
 
+    void FileStream::readMany(const vector<string>& filenames, vector<FileStream*>& streams, size_t chunkSize, int maxInFlight,
+                              bool deleteOnDestruction)
+    {
+        streams.clear();
+
+        try
+        {
+            for (size_t i = 0; i < filenames.size(); ++i)
+            {
+                streams.push_back(new FileStream(filenames[i], ASyncNonBuffering, chunkSize, maxInFlight, deleteOnDestruction));
+            }
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < streams.size(); ++i)
+            {
+                streams[i]->m_deleteOnDestruction = true;
+                delete streams[i];
+            }
+
+            streams.clear();
+            throw;
+        }
+    }
+
+    bool FileStream::releaseMemoryMap()
+    {
+        //
+        //  Windows won't truncate a file while a view of it is mapped
+        //
+
+        if (m_type != MemoryMap || !m_rawdata)
+            return false;
+        m_deleteOnDestruction = false;
+        return true;
+    }
+
+    void FileStream::readAhead(const vector<string>&, size_t, int) {}
+
+    void FileStream::unmapMemory(void* p, size_t size)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        UnmapViewOfFile((char*)p - size_t(p) % info.dwAllocationGranularity);
+    }
+
 #endif
 
 } // namespace TwkUtil
@@ -0,0 +1,489 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <TwkUtil/HugePagePool.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+
+#ifdef PLATFORM_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef PLATFORM_WINDOWS
+#include <malloc.h>
+#endif
+
+namespace TwkUtil
+{
+    using namespace std;
+
+    namespace
+    {
+
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> LockGuard;
+
+        const size_t ArenasPerNode = 4;
+        const size_t NumShards = 64;
+        const size_t PageSize = 4096;
+
+        size_t roundUp(size_t n, size_t m) { return (n + m - 1) / m * m; }
+
+        size_t numNodes()
+        {
+#ifdef PLATFORM_LINUX
+            //
+            //  "0" or "0-1" etc
+            //
+
+            size_t n = 1;
+
+            if (FILE* file = fopen("/sys/devices/system/node/online", "r"))
+            {
+                char buf[256];
+
+                if (fgets(buf, sizeof(buf), file))
+                {
+                    const char* last = strrchr(buf, '-');
+                    if (!last)
+                        last = strrchr(buf, ',');
+                    n = size_t(atoi(last ? last + 1 : buf)) + 1;
+                }
+
+                fclose(file);
+            }
+
+            return std::min(std::max(n, size_t(1)), size_t(64));
+#else
+            return 1;
+#endif
+        }
+
+        int currentNode()
+        {
+#if defined(PLATFORM_LINUX) && defined(SYS_getcpu)
+            unsigned int cpu = 0;
+            unsigned int node = 0;
+            if (syscall(SYS_getcpu, &cpu, &node, 0) == 0)
+                return int(node);
+#endif
+            return 0;
+        }
+
+        void bindToNode(void* p, size_t size, int node, size_t nodes)
+        {
+#if defined(PLATFORM_LINUX) && defined(SYS_mbind)
+            if (nodes > 1)
+            {
+                //
+                //  MPOL_PREFERRED: the pages go to node when it has room
+                //  no matter which thread touches them first
+                //
+
+                const int mpolPreferred = 1;
+                unsigned long mask = 1UL << node;
+                syscall(SYS_mbind, p, size, mpolPreferred, &mask, sizeof(mask) * 8, 0);
+            }
+#endif
+        }
+
+        void prefaultPages(void* p, size_t size)
+        {
+#if defined(PLATFORM_LINUX)
+            //
+            //  MADV_POPULATE_WRITE (Linux 5.14) does it in one go
+            //
+
+            const int populateWrite = 23;
+            if (madvise(p, size, populateWrite) == 0)
+                return;
+#endif
+            volatile unsigned char* c = (volatile unsigned char*)p;
+            for (size_t i = 0; i < size; i += PageSize)
+                c[i] = 0;
+        }
+
+    } // namespace
+
+    struct HugePagePool::Block
+    {
+        void* ptr;
+        size_t size;
+        size_t requested;
+        size_t arena;
+        list<Block*>::iterator lruPos;
+    };
+
+    //
+    //  Free blocks by size class, most recently freed last, and by age
+    //  for eviction, most recently freed first
+    //
+
+    struct HugePagePool::Arena
+    {
+        typedef map<size_t, vector<Block*>> Bins;
+
+        Mutex mutex;
+        Bins bins;
+        list<Block*> lru;
+        int node;
+
+        Block* take(size_t classSize)
+        {
+            Bins::iterator i = bins.find(classSize);
+            if (i == bins.end() || i->second.empty())
+                return 0;
+
+            Block* b = i->second.back();
+            i->second.pop_back();
+            lru.erase(b->lruPos);
+            return b;
+        }
+
+        void put(Block* b)
+        {
+            bins[b->size].push_back(b);
+            lru.push_front(b);
+            b->lruPos = lru.begin();
+        }
+
+        Block* takeOldest()
+        {
+            if (lru.empty())
+                return 0;
+
+            Block* b = lru.back();
+            lru.pop_back();
+
+            vector<Block*>& bin = bins[b->size];
+            bin.erase(std::find(bin.begin(), bin.end(), b));
+            return b;
+        }
+    };
+
+    //
+    //  Which block a pointer belongs to, split by address so that
+    //  deallocs don't all wait on one lock
+    //
+
+    struct HugePagePool::Shard
+    {
+        Mutex mutex;
+        unordered_map<const void*, Block*> blocks;
+    };
+
+    float HugePagePool::Stats::hitRate() const { return allocs ? float(hits + remoteHits) / float(allocs) : 0.0f; }
+
+    float HugePagePool::Stats::fragmentation() const
+    {
+        const size_t mapped = usedClassBytes + freeBytes;
+        return mapped ? float(mapped - usedBytes) / float(mapped) : 0.0f;
+    }
+
+    HugePagePool::HugePagePool(size_t poolSize, bool prefault, bool hugetlb)
+        : m_poolSize(poolSize)
+        , m_prefault(prefault)
+        , m_hugetlb(hugetlb)
+        , m_nodes(numNodes())
+        , m_arenasPerNode(ArenasPerNode)
+        , m_freeBytes(0)
+        , m_freeBlocks(0)
+        , m_usedBytes(0)
+        , m_usedClassBytes(0)
+        , m_usedBlocks(0)
+        , m_allocs(0)
+        , m_hits(0)
+        , m_remoteHits(0)
+        , m_misses(0)
+        , m_evictions(0)
+    {
+        for (size_t i = 0; i < m_nodes * m_arenasPerNode; i++)
+        {
+            m_arenas.push_back(new Arena);
+            m_arenas.back()->node = int(i / m_arenasPerNode);
+        }
+
+        for (size_t i = 0; i < NumShards; i++)
+            m_shards.push_back(new Shard);
+    }
+
+    HugePagePool::~HugePagePool()
+    {
+        for (size_t i = 0; i < m_arenas.size(); i++)
+        {
+            while (Block* b = m_arenas[i]->takeOldest())
+                unmapBlock(b);
+            delete m_arenas[i];
+        }
+
+        for (size_t i = 0; i < m_shards.size(); i++)
+            delete m_shards[i];
+    }
+
+    size_t HugePagePool::sizeClass(size_t size)
+    {
+        size_t s = roundUp(std::max(size, size_t(1)), HugePageSize);
+
+        if (s > 16 * HugePageSize)
+        {
+            int log2 = 0;
+            for (size_t n = s; n > 1; n >>= 1)
+                log2++;
+            s = roundUp(s, size_t(1) << (log2 - 4));
+        }
+
+        return s;
+    }
+
+    size_t HugePagePool::homeArena() const
+    {
+        static thread_local size_t stripe = hash<thread::id>()(this_thread::get_id()) % ArenasPerNode;
+        const size_t node = size_t(currentNode()) % m_nodes;
+        return node * m_arenasPerNode + stripe;
+    }
+
+    HugePagePool::Block* HugePagePool::mapBlock(size_t classSize, int node)
+    {
+        void* p = 0;
+
+#ifdef PLATFORM_LINUX
+        if (m_hugetlb)
+        {
+            p = mmap(0, classSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p == MAP_FAILED)
+                p = 0;
+        }
+
+        if (!p)
+        {
+            //
+            //  Map an extra huge page and trim so the block starts on a
+            //  2MB boundary, then ask for transparent huge pages
+            //
+
+            const size_t mapSize = classSize + HugePageSize;
+            unsigned char* m = (unsigned char*)mmap(0, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (m == MAP_FAILED)
+                return 0;
+
+            unsigned char* a = (unsigned char*)roundUp(size_t(m), HugePageSize);
+            if (a != m)
+                munmap(m, a - m);
+            if (m + mapSize != a + classSize)
+                munmap(a + classSize, (m + mapSize) - (a + classSize));
+
+            p = a;
+            madvise(p, classSize, MADV_HUGEPAGE);
+        }
+
+        bindToNode(p, classSize, node, m_nodes);
+#elif defined(PLATFORM_WINDOWS)
+        p = _aligned_malloc(classSize, HugePageSize);
+#else
+        if (posix_memalign(&p, HugePageSize, classSize) != 0)
+            p = 0;
+#endif
+
+        if (!p)
+            return 0;
+
+        if (m_prefault)
+            prefaultPages(p, classSize);
+
+        Block* b = new Block;
+        b->ptr = p;
+        b->size = classSize;
+        b->requested = 0;
+        b->arena = 0;
+
+        Shard* shard = m_shards[(size_t(p) / HugePageSize) % NumShards];
+        LockGuard lock(shard->mutex);
+        shard->blocks[p] = b;
+
+        return b;
+    }
+
+    void HugePagePool::unmapBlock(Block* b)
+    {
+        {
+            Shard* shard = m_shards[(size_t(b->ptr) / HugePageSize) % NumShards];
+            LockGuard lock(shard->mutex);
+            shard->blocks.erase(b->ptr);
+        }
+
+#ifdef PLATFORM_LINUX
+        munmap(b->ptr, b->size);
+#elif defined(PLATFORM_WINDOWS)
+        _aligned_free(b->ptr);
+#else
+        free(b->ptr);
+#endif
+
+        delete b;
+    }
+
+    HugePagePool::Block* HugePagePool::findBlock(const void* ptr)
+    {
+        Shard* shard = m_shards[(size_t(ptr) / HugePageSize) % NumShards];
+        LockGuard lock(shard->mutex);
+        unordered_map<const void*, Block*>::const_iterator i = shard->blocks.find(ptr);
+        return i == shard->blocks.end() ? 0 : i->second;
+    }
+
+    void* HugePagePool::alloc(size_t size)
+    {
+        const size_t classSize = sizeClass(size);
+        const size_t home = homeArena();
+        const size_t nodeStart = home - home % m_arenasPerNode;
+        Block* b = 0;
+
+        m_allocs++;
+
+        //
+        //  The home arena, the other ones of this node, then the other
+        //  nodes
+        //
+
+        for (size_t i = 0; !b && i < m_arenas.size(); i++)
+        {
+            const size_t a = i < m_arenasPerNode ? nodeStart + (home - nodeStart + i) % m_arenasPerNode
+                                                 : (nodeStart + i) % m_arenas.size();
+
+            Arena* arena = m_arenas[a];
+            LockGuard lock(arena->mutex);
+
+            if ((b = arena->take(classSize)))
+            {
+                m_freeBytes -= b->size;
+                m_freeBlocks--;
+
+                if (i < m_arenasPerNode)
+                    m_hits++;
+                else
+                    m_remoteHits++;
+            }
+        }
+
+        if (!b)
+        {
+            if (!(b = mapBlock(classSize, m_arenas[home]->node)))
+                return 0;
+
+            b->arena = home;
+            m_misses++;
+        }
+
+        b->requested = size;
+        m_usedBytes += size;
+        m_usedClassBytes += b->size;
+        m_usedBlocks++;
+
+        return b->ptr;
+    }
+
+    bool HugePagePool::dealloc(void* ptr)
+    {
+        Block* b = ptr ? findBlock(ptr) : 0;
+        if (!b)
+            return false;
+
+        m_usedBytes -= b->requested;
+        m_usedClassBytes -= b->size;
+        m_usedBlocks--;
+
+        //
+        //  Back to the arena it came from, which is on the node its pages
+        //  are on. Make room by dropping the least recently freed blocks
+        //  of that arena, or drop this one if that's not enough.
+        //
+        //  The other arenas' deallocs don't take this lock so the room
+        //  is claimed with a compare-exchange: whoever loses looks again.
+        //
+
+        vector<Block*> evicted;
+
+        {
+            Arena* arena = m_arenas[b->arena];
+            LockGuard lock(arena->mutex);
+
+            for (;;)
+            {
+                size_t freeBytes = m_freeBytes.load();
+
+                if (freeBytes + b->size <= m_poolSize)
+                {
+                    if (m_freeBytes.compare_exchange_weak(freeBytes, freeBytes + b->size))
+                    {
+                        arena->put(b);
+                        m_freeBlocks++;
+                        b = 0;
+                        break;
+                    }
+                }
+                else if (Block* old = arena->takeOldest())
+                {
+                    m_freeBytes -= old->size;
+                    m_freeBlocks--;
+                    evicted.push_back(old);
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        if (b)
+            evicted.push_back(b);
+
+        for (size_t i = 0; i < evicted.size(); i++)
+            unmapBlock(evicted[i]);
+
+        m_evictions += evicted.size();
+
+        return true;
+    }
+
+    HugePagePool::Stats HugePagePool::stats() const
+    {
+        Stats s;
+        s.allocs = m_allocs;
+        s.hits = m_hits;
+        s.remoteHits = m_remoteHits;
+        s.misses = m_misses;
+        s.evictions = m_evictions;
+        s.usedBlocks = m_usedBlocks;
+        s.usedBytes = m_usedBytes;
+        s.usedClassBytes = m_usedClassBytes;
+        s.freeBlocks = m_freeBlocks;
+        s.freeBytes = m_freeBytes;
+        s.nodes = m_nodes;
+        s.arenas = m_arenas.size();
+        return s;
+    }
+
+    void HugePagePool::outputStats(ostream& o) const
+    {
+        const Stats s = stats();
+        const size_t MB = 1024 * 1024;
+
+        o << "MP: huge pages, " << s.nodes << " node(s), " << s.arenas << " arenas, " << s.allocs << " allocs, hit rate "
+          << s.hitRate() * 100.0f << "% (" << s.remoteHits << " remote), " << s.evictions << " evictions, " << s.usedBlocks
+          << " blocks/" << s.usedBytes / MB << "MB in use, " << s.freeBlocks << " blocks/" << s.freeBytes / MB << "MB free, fragmentation "
+          << s.fragmentation() * 100.0f << "%" << endl;
+    }
+
+} // namespace TwkUtil
@@ -6,6 +6,7 @@
 //
 //******************************************************************************
 #include <TwkUtil/MemPool.h>
+#include <TwkUtil/HugePagePool.h>
 #include <TwkUtil/Timer.h>
 #include <iostream>
 #include <sys/types.h>
@@ -76,6 +77,7 @@ namespace TwkUtil
         , m_allocSlop(allocSlop)
         , m_shortCircuit(false)
         , m_debugOutput(false)
+        , m_hugePages(0)
     {
         m_freeList = new FreeList(m_poolSize, m_allocSlop);
     }
@@ -100,13 +102,26 @@ namespace TwkUtil
         if (getenv("TWK_MEM_POOL_DEBUG"))
             globalMemPool->m_debugOutput = true;
 
+        if (getenv("TWK_MEM_POOL_HUGE_PAGES") && !globalMemPool->m_shortCircuit)
+        {
+            globalMemPool->m_hugePages =
+                new HugePagePool(poolSize, getenv("TWK_MEM_POOL_PREFAULT") != 0, getenv("TWK_MEM_POOL_HUGETLB") != 0);
+        }
+
         if (globalMemPool->m_debugOutput)
         {
             cerr << "MP: size " << poolSize / (1024 * 1024) << "MB, minElemSize " << float(minElemSize) / (1024.0 * 1024.0) << ", slop "
-                 << allocSlop << ", shortCircuit " << globalMemPool->m_shortCircuit << endl;
+                 << allocSlop << ", shortCircuit " << globalMemPool->m_shortCircuit << ", hugePages " << (globalMemPool->m_hugePages != 0)
+                 << endl;
         }
     }
 
+    void MemPool::outputStats(ostream& o)
+    {
+        if (globalMemPool && globalMemPool->m_hugePages)
+            globalMemPool->m_hugePages->outputStats(o);
+    }
+
     void* MemPool::alloc(size_t size)
     {
         //  If not initialized, fallback to original behavior
@@ -120,6 +135,26 @@ namespace TwkUtil
         DebugTimer tmr(mp.m_debugOutput, true);
         bool hit = false;
 
+        //
+        //  The huge page pool does its own locking
+        //
+
+        if (mp.m_hugePages && size >= mp.m_minElemSize)
+        {
+            const size_t misses = mp.m_debugOutput ? mp.m_hugePages->stats().misses : 0;
+            void* ptr = mp.m_hugePages->alloc(size);
+
+            if (mp.m_debugOutput)
+            {
+                hit = mp.m_hugePages->stats().misses == misses;
+                cerr << "MP: alloc " << size / (1024 * 1024) << "MB " << ((hit) ? "hit, " : "miss, ") << 1000.0 * tmr.stop() << "ms" << endl;
+                if (!hit)
+                    mp.m_hugePages->outputStats(cerr);
+            }
+
+            return ptr;
+        }
+
         LockGuard lg(mp.m_mutex);
 
         void* ptr = 0;
@@ -163,6 +198,13 @@ namespace TwkUtil
 
         MemPool& mp(*globalMemPool);
 
+        if (mp.m_hugePages)
+        {
+            if (!mp.m_hugePages->dealloc(ptr))
+                TWK_DEALLOCATE(ptr);
+            return;
+        }
+
         LockGuard lg(mp.m_mutex);
 
         ElemMap::iterator i = mp.m_elemMap.find(ptr);
@@ -8,6 +8,7 @@
 #ifndef __TwkUtil__FileStream__h__
 #define __TwkUtil__FileStream__h__
 #include <string>
+#include <vector>
 #ifdef WIN32
 #define ssize_t long
 #endif
@@ -15,6 +16,7 @@
 
 namespace TwkUtil
 {
+    struct UringFile;
 
     /// Stream a file
 
@@ -32,6 +34,12 @@ namespace TwkUtil
     /// If deleteOnDestruction is false: you need to use the macro
     /// TWK_DEALLOCATE to free the memory returned by data();
     ///
+    /// IOUring reads through a Linux io_uring with O_DIRECT and
+    /// registered buffers, keeping maxInFlight chunkSize reads queued.
+    /// Each thread sets up one ring and reuses it for all its reads.
+    /// Where io_uring isn't available (other platforms, older kernels,
+    /// seccomp) it behaves like ASyncNonBuffering.
+    ///
 
     class TWKUTIL_EXPORT FileStream
     {
@@ -42,7 +50,8 @@ namespace TwkUtil
             NonBuffering,
             MemoryMap,
             ASyncBuffering,
-            ASyncNonBuffering
+            ASyncNonBuffering,
+            IOUring
         };
 
         FileStream(const std::string& filename, size_t startOffset, size_t readSize, Type type = Buffering, size_t chunkSize = 61440,
@@ -61,6 +70,52 @@ namespace TwkUtil
 
         static void deleteDataPointer(void*);
 
+        //
+        //  Hands the mapping of a MemoryMap stream over to the caller
+        //  who has to pass data() and size() to unmapMemory() when done
+        //  with it. Returns false if the stream isn't memory mapped or
+        //  if the file has been truncated since it was mapped: touching
+        //  a page past the end of the file raises SIGBUS. The mapping is
+        //  copy on write: the pages can be modified in place without
+        //  changing the file. A file truncated after the hand over can
+        //  still fault on pages that weren't read yet.
+        //
+
+        bool releaseMemoryMap();
+
+        static void unmapMemory(void*, size_t);
+
+        //
+        //  Reads all of the files in one IOUring batch: their chunks
+        //  share a single queue maxInFlight deep so look-ahead caching
+        //  can keep many (small) frames in flight at once. streams gets
+        //  one new FileStream per filename, in order, which the caller
+        //  has to delete. Throws if any of the files can't be read, in
+        //  which case none are returned.
+        //
+
+        static void readMany(const std::vector<std::string>& filenames, std::vector<FileStream*>& streams, size_t chunkSize = 61440,
+                             int maxInFlight = 64, bool deleteOnDestruction = true);
+
+        //
+        //  Reads the files in one readMany() batch and keeps their data
+        //  until an IOUring FileStream is opened on one of them (whole,
+        //  from the start) which then takes it instead of reading the
+        //  file. Up to 256MB are kept, the oldest files are dropped
+        //  first. Files changed since they were read ahead are read
+        //  again. Does nothing without io_uring and never throws: the
+        //  frames report their own errors when they're read. It waits
+        //  for the reads, call it from a thread that can (MovieFB runs
+        //  it on the decode pool). A FileStream opened on a file still
+        //  being read ahead doesn't wait for it, it reads the file.
+        //
+        //  readAheadBytes() is how many bytes are kept or being read,
+        //  TwkFB::Cache counts them against its budget.
+        //
+
+        static void readAhead(const std::vector<std::string>& filenames, size_t chunkSize = 61440, int maxInFlight = 64);
+        static size_t readAheadBytes();
+
         //
         //  Return MB/sec throughput.  Note that this doesn't work for
         //  MemoryMap IO operations, since the actual IO in that case is
@@ -71,7 +126,16 @@ namespace TwkUtil
         static void resetMbps();
 
     private:
+        struct Deferred
+        {
+        };
+
+        FileStream(const std::string& filename, size_t chunkSize, int maxInFlight, bool deleteOnDestruction, Deferred);
+
         void initialize();
+        bool openFile();
+        void openForUring(UringFile&);
+        void finishUring(UringFile&);
 
     private:
         std::string m_filename;
@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __TwkUtil__HugePagePool__h__
+#define __TwkUtil__HugePagePool__h__
+#include <TwkUtil/dll_defs.h>
+#include <atomic>
+#include <iostream>
+#include <stddef.h>
+#include <vector>
+
+namespace TwkUtil
+{
+
+    //
+    //  The MemPool backend used for large blocks when TWK_MEM_POOL_HUGE_PAGES
+    //  is set. Blocks are aligned to and sized in multiples of 2MB so they
+    //  can be backed by huge pages (transparent ones, or hugetlbfs pages
+    //  when TWK_MEM_POOL_HUGETLB is set too) which saves TLB misses when
+    //  the pixels are walked or uploaded.
+    //
+    //  Sizes are rounded up to a size class: a multiple of 2MB up to 32MB
+    //  then sixteen classes per power of two, so at most 1/16th of a block
+    //  is wasted. Freed blocks are kept in per class bins of an arena for
+    //  reuse until the pool holds poolSize bytes, after which the least
+    //  recently freed ones of the arena are unmapped.
+    //
+    //  There are a few arenas per NUMA node, each with its own lock. A
+    //  thread allocates from one of the arenas of the node it's running
+    //  on and only looks at the other nodes when those have nothing of
+    //  the right size. New blocks are bound to the node of the thread
+    //  allocating them, and can be faulted in right away (prefault) so
+    //  that the pages aren't first touched by a decoder or upload thread
+    //  later on, possibly on the other socket.
+    //
+
+    class TWKUTIL_EXPORT HugePagePool
+    {
+    public:
+        static const size_t HugePageSize = 2 * 1024 * 1024;
+
+        struct Stats
+        {
+            size_t allocs;         //  Calls to alloc()
+            size_t hits;           //  Reused a free block of the thread's node
+            size_t remoteHits;     //  Reused a free block of another node
+            size_t misses;         //  Mapped a new block
+            size_t evictions;      //  Free blocks unmapped to stay under poolSize
+            size_t usedBlocks;     //  Blocks handed out
+            size_t usedBytes;      //  Bytes asked for by those
+            size_t usedClassBytes; //  Their size class bytes
+            size_t freeBlocks;     //  Blocks in the bins
+            size_t freeBytes;      //  Their bytes
+            size_t nodes;
+            size_t arenas;
+
+            //
+            //  Fraction of allocs served from the bins
+            //
+
+            float hitRate() const;
+
+            //
+            //  Fraction of the mapped bytes not holding anything asked
+            //  for: size class rounding plus the blocks sitting in the
+            //  bins
+            //
+
+            float fragmentation() const;
+        };
+
+        HugePagePool(size_t poolSize, bool prefault, bool hugetlb);
+        ~HugePagePool();
+
+        void* alloc(size_t size);
+
+        //
+        //  Returns false if ptr didn't come from alloc()
+        //
+
+        bool dealloc(void* ptr);
+
+        Stats stats() const;
+        void outputStats(std::ostream&) const;
+
+        static size_t sizeClass(size_t size);
+
+    private:
+        struct Block;
+        struct Arena;
+        struct Shard;
+
+        typedef std::atomic<size_t> Counter;
+
+        Block* mapBlock(size_t classSize, int node);
+        void unmapBlock(Block*);
+        Block* findBlock(const void* ptr);
+        size_t homeArena() const;
+
+    private:
+        size_t m_poolSize;
+        bool m_prefault;
+        bool m_hugetlb;
+        size_t m_nodes;
+        size_t m_arenasPerNode;
+        std::vector<Arena*> m_arenas;
+        std::vector<Shard*> m_shards;
+        Counter m_freeBytes;
+        Counter m_freeBlocks;
+        Counter m_usedBytes;
+        Counter m_usedClassBytes;
+        Counter m_usedBlocks;
+        Counter m_allocs;
+        Counter m_hits;
+        Counter m_remoteHits;
+        Counter m_misses;
+        Counter m_evictions;
+    };
+
+} // namespace TwkUtil
+
+#endif // __TwkUtil__HugePagePool__h__
@@ -16,10 +16,12 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_guard.hpp>
 
+#include <iosfwd>
 #include <map>
 
 namespace TwkUtil
 {
+    class HugePagePool;
 
     //
     //  A Pool of large blocks of memory used in file IO and as FrameBuffers.
@@ -37,6 +39,11 @@ namespace TwkUtil
     //  We assume that the target pool size and minimum element size is such
     //  that the pool will have a small number of elements (< 100).
     //
+    //  If TWK_MEM_POOL_HUGE_PAGES is set the large blocks come from a
+    //  HugePagePool instead, which scales to many more blocks and threads
+    //  (see HugePagePool.h). TWK_MEM_POOL_PREFAULT and TWK_MEM_POOL_HUGETLB
+    //  set its options.
+    //
 
     class TWKUTIL_EXPORT MemPool
     {
@@ -56,6 +63,13 @@ namespace TwkUtil
 
         static void initialize();
 
+        //
+        //  Hit rate and such of the huge page pool, nothing otherwise.
+        //  Also output on each miss when TWK_MEM_POOL_DEBUG is set.
+        //
+
+        static void outputStats(std::ostream&);
+
     private:
         class FreeList;
         class PoolElem;
@@ -71,8 +85,9 @@ namespace TwkUtil
         bool m_shortCircuit; //  Fallback to former behavior
         bool m_debugOutput;
 
-        FreeList* m_freeList; //  List of blocks available for re-use
-        ElemMap m_elemMap;    //  Map of ptrs to all PoolElems (free or in-use)
+        FreeList* m_freeList;      //  List of blocks available for re-use
+        ElemMap m_elemMap;         //  Map of ptrs to all PoolElems (free or in-use)
+        HugePagePool* m_hugePages; //  Replaces the above if not null
 
         Mutex m_mutex;
     };
@@ -486,8 +486,26 @@ namespace TwkFB
             Read10Bit::readRGBA16(filename, data, fb, w, h, maxData, false, swap);
             break;
         case RGB10_A2:
-            Read10Bit::readRGB10_A2(filename, data, fb, w, h, maxData, swap);
+        {
+            //
+            //  When the file is memory mapped the fb can point straight
+            //  into it: the 10 bit filled pixels are what GL takes. Big
+            //  endian files are copied instead of swapped in place, which
+            //  would write to every page of the mapping.
+            //
+
+            FrameBuffer::DataOwnerPtr mapping;
+
+            if (!swap && size_t(data) % 16 == 0 && size_t(4 * w * h) <= maxData)
+            {
+                mapping = adoptMemoryMap(fmap);
+            }
+
+            Read10Bit::readRGB10_A2(filename, data, fb, w, h, maxData, swap, mapping != 0, (unsigned char*)fmap.data());
+            if (mapping)
+                fb.setDataOwner(mapping);
             break;
+        }
         case A2_BGR10:
             Read10Bit::readA2_BGR10(filename, data, fb, w, h, maxData, swap);
             break;
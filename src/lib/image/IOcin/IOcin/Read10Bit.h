@@ -8,6 +8,7 @@
 #ifndef __Read10Bit__Read10Bit__h__
 #define __Read10Bit__Read10Bit__h__
 #include <TwkExc/TwkExcException.h>
+#include <TwkFB/FastConversion.h>
 #include <TwkFB/FrameBuffer.h>
 #include <TwkUtil/ByteSwap.h>
 #include <TwkFB/IO.h>
@@ -89,29 +90,57 @@ namespace TwkFB
 
         static void planarConfig(TwkFB::FrameBuffer&, int, int, TwkFB::FrameBuffer::DataType);
 
-        static void readRGB8(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        //
+        //  The functions taking a parallel flag can decode bands of
+        //  scanlines concurrently on the TwkFB::ThreadPool. Those
+        //  taking a packing (a DPXUnpackPacking, see FastConversion.h)
+        //  can read DPX filling method B and unpadded data too.
+        //
+
+        static void readRGB8(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                             bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
         static void readRGBA8(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool alpha,
                               bool swap);
 
-        static void readRGB16(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        static void readRGB16(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                              bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
         static void readRGBA16(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool alpha,
                                bool swap);
 
         static void readRGB10_A2(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
-                                 bool useRaw = false, unsigned char* deletePointer = 0);
+                                 bool useRaw = false, unsigned char* deletePointer = 0, bool parallel = false);
 
-        static void readA2_BGR10(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        static void readA2_BGR10(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                                 bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
-        static void readRGB8_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        static void readRGB8_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                                    bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
-        static void readRGB16_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        static void readRGB16_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                                     bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
         //
 
         static void readYCrYCb8_422_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes,
                                            bool swap);
+
+    private:
+        //
+        //  Scanlines y0 up to y1 of the above into an already configured fb
+        //
+
+        static void readRGB8Rows(const unsigned char*, TwkFB::FrameBuffer&, int w, int y0, int y1, size_t maxbytes, bool swap,
+                                 int packing);
+        static void readRGB16Rows(const unsigned char*, TwkFB::FrameBuffer&, int w, int y0, int y1, size_t maxbytes, bool swap,
+                                  int packing);
+        static void readA2_BGR10Rows(const unsigned char*, TwkFB::FrameBuffer&, int w, int y0, int y1, size_t maxbytes, bool swap,
+                                     int packing);
+        static void readRGB8_PLANARRows(const unsigned char*, TwkFB::FrameBuffer&, int w, int y0, int y1, size_t maxbytes, bool swap,
+                                        int packing);
+        static void readRGB16_PLANARRows(const unsigned char*, TwkFB::FrameBuffer&, int w, int y0, int y1, size_t maxbytes, bool swap,
+                                         int packing);
     };
 
 } // namespace TwkFB
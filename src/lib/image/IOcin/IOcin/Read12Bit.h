@@ -8,6 +8,7 @@
 #ifndef __Read12Bit__Read12Bit__h__
 #define __Read12Bit__Read12Bit__h__
 #include <TwkExc/TwkExcException.h>
+#include <TwkFB/FastConversion.h>
 #include <TwkFB/FrameBuffer.h>
 #include <TwkUtil/ByteSwap.h>
 #include <TwkFB/IO.h>
@@ -39,11 +40,20 @@ namespace TwkFB
 
         static void planarConfig(TwkFB::FrameBuffer&, int, int, TwkFB::FrameBuffer::DataType);
 
-        static void readRGB8_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        //
+        //  If parallel bands of scanlines are decoded concurrently on the
+        //  TwkFB::ThreadPool. packing is a DPXUnpackPacking (see
+        //  FastConversion.h).
+        //
+
+        static void readRGB8_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                                    bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
-        static void readRGB16_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        static void readRGB16_PLANAR(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                                     bool parallel = false, int packing = DPX_UNPACK_FILLED_A);
 
-        static void readNoPaddingRGB16(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap);
+        static void readNoPaddingRGB16(const std::string&, const unsigned char*, TwkFB::FrameBuffer&, int, int, size_t maxbytes, bool swap,
+                                       bool parallel = false);
     };
 
 } // namespace TwkFB
@@ -6,7 +6,9 @@
 //******************************************************************************
 #include <IOcin/Read10Bit.h>
 #include <TwkFB/Exception.h>
+#include <TwkFB/FastConversion.h>
 #include <TwkFB/Operations.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkMath/Iostream.h>
 #include <TwkMath/Color.h>
 #include <TwkUtil/Timer.h>
@@ -40,6 +42,39 @@ namespace TwkFB
 #define restrict __restrict
 #endif
 
+    namespace
+    {
+
+        //
+        //  Calls rows(y0, y1) over all h scanlines. If parallel they're
+        //  split into bands run concurrently on the TwkFB::ThreadPool.
+        //
+
+        template <typename F> void forEachRowBand(int h, bool parallel, const F& rows)
+        {
+            if (parallel && h > 0)
+            {
+                TwkFB::ThreadPool::parallelFor(0, size_t(h), 64, [&](size_t b, size_t e) { rows(int(b), int(e)); });
+            }
+            else
+            {
+                rows(0, h);
+            }
+        }
+
+        //
+        //  The end of the rows from y0 up to y1 which are all in the
+        //  first maxBytes of the data
+        //
+
+        int completeRows(int y1, int w, size_t maxBytes, int packing)
+        {
+            const size_t rowSize = unpackDPX_rowSize(w, 10, packing);
+            return maxBytes ? int(std::min(size_t(y1), maxBytes / rowSize)) : y1;
+        }
+
+    } // namespace
+
     void Read10Bit::planarConfig(FrameBuffer& fb, int w, int h, FrameBuffer::DataType type)
     {
         //
@@ -249,229 +284,94 @@ namespace TwkFB
     }
 
     void Read10Bit::readRGB8_PLANAR(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                    bool swap)
+                                    bool swap, bool parallel, int packing)
     {
         planarConfig(fb, w, h, FrameBuffer::UCHAR);
 
+        forEachRowBand(h, parallel, [&](int y0, int y1) { readRGB8_PLANARRows(data, fb, w, y0, y1, maxBytes, swap, packing); });
+    }
+
+    void Read10Bit::readRGB8_PLANARRows(const unsigned char* data, FrameBuffer& fb, int w, int y0, int y1, size_t maxBytes, bool swap,
+                                        int packing)
+    {
         FrameBuffer* R = &fb;
         FrameBuffer* G = R->nextPlane();
         FrameBuffer* B = G->nextPlane();
+        const int end = completeRows(y1, w, maxBytes, packing);
+        const size_t rowSize = unpackDPX_rowSize(w, 10, packing);
 
-        const float slop = 1.0 / 1023.0 / 2.0;
-
-        if (swap)
+        if (y0 < end)
         {
-            for (int y = 0; y < h; y++)
-            {
-                Pixel* in = (Pixel*)(data + y * w * sizeof(U32));
-                Pixel* lim = (Pixel*)(data + (y + 1) * w * sizeof(U32));
-                if (maxBytes && ((char*)lim - (char*)data) > maxBytes)
-                    break;
-                U8* out = fb.scanline<U8>(y);
-
-                U8* restrict r = R->scanline<U8>(y);
-                U8* restrict g = G->scanline<U8>(y);
-                U8* restrict b = B->scanline<U8>(y);
-
-                for (U8* restrict end = r + w; r < end; r++, g++, b++, in++)
-                {
-                    Pixel p;
-                    const U32 v = in->pixelWord;
-
-                    p.pixelWord = ((v & 0xff000000) >> 24) | ((v & 0x00ff0000) >> 8) | ((v & 0x0000ff00) << 8) | ((v & 0x000000ff) << 24);
-
-                    // const U8 rv = U8((float(p.red) / 1023.0f + slop) *
-                    // 255.0f); const U8 gv = U8((float(p.green) / 1023.0f +
-                    // slop) * 255.0f); const U8 bv = U8((float(p.blue) /
-                    // 1023.0f + slop) * 255.0f);
-
-                    const U8 rv = p.red == 0x3ff ? p.red_most : ((p.red + 1) >> 2);
-                    const U8 gv = p.green == 0x3ff ? p.green_most : ((p.green + 1) >> 2);
-                    const U8 bv = p.blue == 0x3ff ? p.blue_most : ((p.blue + 1) >> 2);
-
-                    // const U8 rv = p.red_most;
-                    // const U8 gv = p.green_most;
-                    // const U8 bv = p.blue_most;
-
-                    *r = rv;
-                    *g = gv;
-                    *b = bv;
-                }
-            }
-        }
-        else
-        {
-
-            for (int y = 0; y < h; y++)
-            {
-                Pixel* in = (Pixel*)(data + y * w * sizeof(U32));
-                Pixel* lim = (Pixel*)(data + (y + 1) * w * sizeof(U32));
-                if (maxBytes && ((char*)lim - (char*)data) > maxBytes)
-                    break;
-                U8* out = fb.scanline<U8>(y);
-
-                U8* restrict r = R->scanline<U8>(y);
-                U8* restrict g = G->scanline<U8>(y);
-                U8* restrict b = B->scanline<U8>(y);
-
-                for (U8* restrict end = r + w; r < end; r++, g++, b++, in++)
-                {
-                    Pixel p = *in;
-
-                    // const U8 rv = U8((float(p.red) / 1023.0f + slop) *
-                    // 255.0f); const U8 gv = U8((float(p.green) / 1023.0f +
-                    // slop) * 255.0f); const U8 bv = U8((float(p.blue) /
-                    // 1023.0f + slop) * 255.0f); const U8 rv = p.red_most;
-                    // const U8 gv = p.green_most;
-                    // const U8 bv = p.blue_most;
-                    const U8 rv = p.red == 0x3ff ? p.red_most : ((p.red + 1) >> 2);
-                    const U8 gv = p.green == 0x3ff ? p.green_most : ((p.green + 1) >> 2);
-                    const U8 bv = p.blue == 0x3ff ? p.blue_most : ((p.blue + 1) >> 2);
-
-                    *r = rv;
-                    *g = gv;
-                    *b = bv;
-                }
-            }
+            unpackDPX10_to_planarRGB8(w, end - y0, data + y0 * rowSize, rowSize, R->scanline<U8>(y0), G->scanline<U8>(y0),
+                                      B->scanline<U8>(y0), R->scanlinePaddedSize(), packing, swap);
         }
     }
 
-    void Read10Bit::readRGB8(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes, bool swap)
+    void Read10Bit::readRGB8(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes, bool swap,
+                             bool parallel, int packing)
     {
         fb.restructure(w, h, 0, 3, FrameBuffer::UCHAR, 0, 0, FrameBuffer::TOPLEFT, true);
 
-        for (int y = 0; y < h; y++)
-        {
-            Pixel* in = (Pixel*)(data + y * w * sizeof(U32));
-            Pixel* lim = (Pixel*)(data + (y + 1) * w * sizeof(U32));
-            if (maxBytes && ((char*)lim - (char*)data) > maxBytes)
-                break;
-            U8* out = fb.scanline<U8>(y);
-
-            if (swap)
-            {
-                for (U8* end = out + w * 3; out < end; in++)
-                {
-                    Pixel p;
-                    const U32 v = in->pixelWord;
-
-                    p.pixelWord = ((v & 0xff000000) >> 24) | ((v & 0x00ff0000) >> 8) | ((v & 0x0000ff00) << 8) | ((v & 0x000000ff) << 24);
+        forEachRowBand(h, parallel, [&](int y0, int y1) { readRGB8Rows(data, fb, w, y0, y1, maxBytes, swap, packing); });
+    }
 
-                    const U8 rv = p.red == 0x3ff ? p.red_most : ((p.red + 1) >> 2);
-                    const U8 gv = p.green == 0x3ff ? p.green_most : ((p.green + 1) >> 2);
-                    const U8 bv = p.blue == 0x3ff ? p.blue_most : ((p.blue + 1) >> 2);
+    void Read10Bit::readRGB8Rows(const unsigned char* data, FrameBuffer& fb, int w, int y0, int y1, size_t maxBytes, bool swap,
+                                 int packing)
+    {
+        const int end = completeRows(y1, w, maxBytes, packing);
+        const size_t rowSize = unpackDPX_rowSize(w, 10, packing);
 
-                    *out = rv;
-                    out++;
-                    *out = gv;
-                    out++;
-                    *out = bv;
-                    out++;
-                }
-            }
-            else
-            {
-                for (U8* end = out + w * 3; out < end; in++)
-                {
-                    Pixel p = *in;
-
-                    const U8 rv = p.red == 0x3ff ? p.red_most : ((p.red + 1) >> 2);
-                    const U8 gv = p.green == 0x3ff ? p.green_most : ((p.green + 1) >> 2);
-                    const U8 bv = p.blue == 0x3ff ? p.blue_most : ((p.blue + 1) >> 2);
-
-                    *out = rv;
-                    out++;
-                    *out = gv;
-                    out++;
-                    *out = bv;
-                    out++;
-                }
-            }
+        if (y0 < end)
+        {
+            unpackDPX10_to_RGB8(w, end - y0, data + y0 * rowSize, rowSize, fb.scanline<U8>(y0), fb.scanlinePaddedSize(), 3, packing, swap);
         }
     }
 
-    void Read10Bit::readRGB16(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes, bool swap)
+    void Read10Bit::readRGB16(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes, bool swap,
+                              bool parallel, int packing)
     {
         fb.restructure(w, h, 0, 3, FrameBuffer::USHORT, 0, 0, FrameBuffer::TOPLEFT, true);
 
-        for (int y = 0; y < h; y++)
-        {
-            Pixel* in = (Pixel*)(data + y * w * sizeof(U32));
-            Pixel* lim = (Pixel*)(data + (y + 1) * w * sizeof(U32));
-            if (maxBytes && ((char*)lim - (char*)data) > maxBytes)
-                break;
-            U16* out = fb.scanline<U16>(y);
-
-            if (swap)
-            {
-                for (U16* end = out + w * 3; out < end; in++)
-                {
-                    Pixel p;
-                    const U32 v = in->pixelWord;
-
-                    p.pixelWord = ((v & 0xff000000) >> 24) | ((v & 0x00ff0000) >> 8) | ((v & 0x0000ff00) << 8) | ((v & 0x000000ff) << 24);
-
-                    //
-                    //  We used to make 16bit values from 10bit values by just
-                    //  shifting (16bit = 10bit << 6), which mapps the 10bit
-                    //  values onto the "lattice points" within the 16bit range
-                    //  separated by 2^6.  But these values are "really"
-                    //  supposed to represent the floating range 0.0-1.0, so
-                    //  only hitting these lattice points is actually wrong. The
-                    //  mappping is correct for 0.0, but the error increases as
-                    //  we approach 1.0.  In particular:
-                    //
-                    //  "10bit 1.0" == 1111111111 is mapped to 1111111111000000
-                    //  != 1111111111111111 = "16bit 1.0"
-                    //
-                    //  This would be fine if we were going to just shift back
-                    //  at some point, but these 16bit values really _will_ be
-                    //  converted to floating point during rendering, and
-                    //  rounding errors etc mean that even a 10bit "pass
-                    //  through" with 16bit textures may result in errors large
-                    //  enough that the output 10bit value will differ from the
-                    //  input by 1 code value.
-                    //
-                    //  So we now convert from 10bit to 16bit by "passing
-                    //  through" a floating point value, to ensure that 0->0 and
-                    //  1->1 (and presumably everything inbetween is optimally
-                    //  mapped.
-                    //
-
-                    const U16 rv = U16((double(65535l * p.red) / 1023.0l));
-                    const U16 gv = U16((double(65535l * p.green) / 1023.0l));
-                    const U16 bv = U16((double(65535l * p.blue) / 1023.0l));
-
-                    *out = rv;
-                    out++;
-                    *out = gv;
-                    out++;
-                    *out = bv;
-                    out++;
-                }
-            }
-            else
-            {
-                for (U16* end = out + w * 3; out < end; in++)
-                {
-                    Pixel p = *in;
+        forEachRowBand(h, parallel, [&](int y0, int y1) { readRGB16Rows(data, fb, w, y0, y1, maxBytes, swap, packing); });
+    }
 
-                    //
-                    //  See above comment
-                    //
+    void Read10Bit::readRGB16Rows(const unsigned char* data, FrameBuffer& fb, int w, int y0, int y1, size_t maxBytes, bool swap,
+                                  int packing)
+    {
+        //
+        //  We used to make 16bit values from 10bit values by just
+        //  shifting (16bit = 10bit << 6), which mapps the 10bit
+        //  values onto the "lattice points" within the 16bit range
+        //  separated by 2^6.  But these values are "really"
+        //  supposed to represent the floating range 0.0-1.0, so
+        //  only hitting these lattice points is actually wrong. The
+        //  mappping is correct for 0.0, but the error increases as
+        //  we approach 1.0.  In particular:
+        //
+        //  "10bit 1.0" == 1111111111 is mapped to 1111111111000000
+        //  != 1111111111111111 = "16bit 1.0"
+        //
+        //  This would be fine if we were going to just shift back
+        //  at some point, but these 16bit values really _will_ be
+        //  converted to floating point during rendering, and
+        //  rounding errors etc mean that even a 10bit "pass
+        //  through" with 16bit textures may result in errors large
+        //  enough that the output 10bit value will differ from the
+        //  input by 1 code value.
+        //
+        //  So we now convert from 10bit to 16bit like 65535 * v /
+        //  1023, to ensure that 0->0 and 1->1 (and presumably
+        //  everything inbetween is optimally mapped. The unpack
+        //  functions do that with integer math.
+        //
 
-                    const U16 rv = U16((double(65535l * p.red) / 1023.0l));
-                    const U16 gv = U16((double(65535l * p.green) / 1023.0l));
-                    const U16 bv = U16((double(65535l * p.blue) / 1023.0l));
+        const int end = completeRows(y1, w, maxBytes, packing);
+        const size_t rowSize = unpackDPX_rowSize(w, 10, packing);
 
-                    *out = rv;
-                    out++;
-                    *out = gv;
-                    out++;
-                    *out = bv;
-                    out++;
-                }
-            }
+        if (y0 < end)
+        {
+            unpackDPX10_to_RGB16(w, end - y0, data + y0 * rowSize, rowSize, fb.scanline<U16>(y0), fb.scanlinePaddedSize(), 3, packing,
+                                 swap);
         }
     }
 
@@ -667,71 +567,35 @@ namespace TwkFB
     }
 
     void Read10Bit::readRGB16_PLANAR(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                     bool swap)
+                                     bool swap, bool parallel, int packing)
     {
         planarConfig(fb, w, h, FrameBuffer::USHORT);
 
+        forEachRowBand(h, parallel, [&](int y0, int y1) { readRGB16_PLANARRows(data, fb, w, y0, y1, maxBytes, swap, packing); });
+    }
+
+    void Read10Bit::readRGB16_PLANARRows(const unsigned char* data, FrameBuffer& fb, int w, int y0, int y1, size_t maxBytes, bool swap,
+                                         int packing)
+    {
         FrameBuffer* R = &fb;
         FrameBuffer* G = R->nextPlane();
         FrameBuffer* B = G->nextPlane();
+        const int end = completeRows(y1, w, maxBytes, packing);
+        const size_t rowSize = unpackDPX_rowSize(w, 10, packing);
 
-        for (int y = 0; y < h; y++)
-        {
-            Pixel* in = (Pixel*)(data + y * w * sizeof(U32));
-            Pixel* lim = (Pixel*)(data + (y + 1) * w * sizeof(U32));
-            if (maxBytes && ((char*)lim - (char*)data) > maxBytes)
-                break;
-
-            U16* restrict r = R->scanline<U16>(y);
-            U16* restrict g = G->scanline<U16>(y);
-            U16* restrict b = B->scanline<U16>(y);
-
-            if (swap)
-            {
-                for (U16* restrict end = r + w; r < end; r++, g++, b++, in++)
-                {
-                    Pixel p;
-                    const U32 v = in->pixelWord;
-
-                    p.pixelWord = ((v & 0xff000000) >> 24) | ((v & 0x00ff0000) >> 8) | ((v & 0x0000ff00) << 8) | ((v & 0x000000ff) << 24);
-
-                    //
-                    //  See big comment in readRGB16() above.
-                    //
-
-                    const U16 rv = U16((double(65535l * p.red) / 1023.0l));
-                    const U16 gv = U16((double(65535l * p.green) / 1023.0l));
-                    const U16 bv = U16((double(65535l * p.blue) / 1023.0l));
-
-                    *r = rv;
-                    *g = gv;
-                    *b = bv;
-                }
-            }
-            else
-            {
-                for (U16* restrict end = r + w; r < end; r++, g++, b++, in++)
-                {
-                    Pixel p = *in;
-
-                    //
-                    //  See big comment in readRGB16() above.
-                    //
-
-                    const U16 rv = U16((double(65535l * p.red) / 1023.0l));
-                    const U16 gv = U16((double(65535l * p.green) / 1023.0l));
-                    const U16 bv = U16((double(65535l * p.blue) / 1023.0l));
+        //
+        //  See big comment in readRGB16Rows() above.
+        //
 
-                    *r = rv;
-                    *g = gv;
-                    *b = bv;
-                }
-            }
+        if (y0 < end)
+        {
+            unpackDPX10_to_planarRGB16(w, end - y0, data + y0 * rowSize, rowSize, R->scanline<U16>(y0), G->scanline<U16>(y0),
+                                       B->scanline<U16>(y0), R->scanlinePaddedSize(), packing, swap);
         }
     }
 
     void Read10Bit::readRGB10_A2(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                 bool swap, bool useRaw, unsigned char* deletePointer)
+                                 bool swap, bool useRaw, unsigned char* deletePointer, bool parallel)
     {
         fb.restructure(w, h, 0, 1, FrameBuffer::PACKED_R10_G10_B10_X2, useRaw ? (unsigned char*)data : 0, 0, FrameBuffer::TOPLEFT, true, 0,
                        0, useRaw ? deletePointer : 0);
@@ -741,14 +605,17 @@ namespace TwkFB
 
         if (!useRaw)
         {
-            if (maxBytes < fb.allocSize())
-            {
-                memcpy(fb.pixels<char>(), data, maxBytes);
-            }
-            else
-            {
-                memcpy(fb.pixels<char>(), data, sizeof(Pixel) * w * h);
-            }
+            const size_t n = maxBytes < fb.allocSize() ? maxBytes : sizeof(Pixel) * w * h;
+            const size_t rowSize = sizeof(Pixel) * w;
+
+            forEachRowBand(h, parallel,
+                           [&](int y0, int y1)
+                           {
+                               const size_t b = y0 * rowSize;
+                               const size_t e = std::min(n, y1 * rowSize);
+                               if (b < e)
+                                   memcpy(fb.pixels<char>() + b, data + b, e - b);
+                           });
         }
 
         // if (useRaw) cout << "READ10: used raw" << endl;
@@ -757,7 +624,8 @@ namespace TwkFB
         {
             Timer t;
             t.start();
-            TwkUtil::swapWords(fb.pixels<char>(), w * h);
+            forEachRowBand(h, parallel,
+                           [&](int y0, int y1) { TwkUtil::swapWords(fb.pixels<char>() + y0 * sizeof(Pixel) * w, (y1 - y0) * w); });
             // cout << "READ10: swapped time = "
             //<< t.elapsed()
             //<< endl;
@@ -765,43 +633,23 @@ namespace TwkFB
     }
 
     void Read10Bit::readA2_BGR10(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                 bool swap)
+                                 bool swap, bool parallel, int packing)
     {
         fb.restructure(w, h, 0, 1, FrameBuffer::PACKED_X2_B10_G10_R10, 0, 0, FrameBuffer::TOPLEFT, true, 0, 0);
 
-        for (int y = 0; y < h; y++)
-        {
-            Pixel* in = (Pixel*)(data + y * w * sizeof(U32));
-            Pixel* lim = (Pixel*)(data + (y + 1) * w * sizeof(U32));
-            if (maxBytes && ((char*)lim - (char*)data) > maxBytes)
-                break;
-            Pixel10Rev* out = fb.scanline<Pixel10Rev>(y);
-
-            if (swap)
-            {
-                for (Pixel10Rev* end = out + w; out < end; in++)
-                {
-                    Pixel p;
-                    const U32 v = in->pixelWord;
+        forEachRowBand(h, parallel, [&](int y0, int y1) { readA2_BGR10Rows(data, fb, w, y0, y1, maxBytes, swap, packing); });
+    }
 
-                    p.pixelWord = ((v & 0xff000000) >> 24) | ((v & 0x00ff0000) >> 8) | ((v & 0x0000ff00) << 8) | ((v & 0x000000ff) << 24);
+    void Read10Bit::readA2_BGR10Rows(const unsigned char* data, FrameBuffer& fb, int w, int y0, int y1, size_t maxBytes, bool swap,
+                                     int packing)
+    {
+        const int end = completeRows(y1, w, maxBytes, packing);
+        const size_t rowSize = unpackDPX_rowSize(w, 10, packing);
 
-                    out->red = p.red;
-                    out->green = p.green;
-                    out->blue = p.blue;
-                    out++;
-                }
-            }
-            else
-            {
-                for (Pixel10Rev* end = out + w; out < end; in++)
-                {
-                    out->red = in->red;
-                    out->green = in->green;
-                    out->blue = in->blue;
-                    out++;
-                }
-            }
+        if (y0 < end)
+        {
+            unpackDPX10_to_A2BGR10(w, end - y0, data + y0 * rowSize, rowSize, fb.scanline<uint32_t>(y0), fb.scanlinePaddedSize(),
+                                   packing, swap);
         }
     }
 
@@ -6,6 +6,7 @@
 //******************************************************************************
 #include <IOcin/Read12Bit.h>
 #include <TwkFB/Exception.h>
+#include <TwkFB/FastConversion.h>
 #include <TwkFB/Operations.h>
 #include <TwkMath/Iostream.h>
 #include <TwkUtil/Interrupt.h>
@@ -46,161 +47,65 @@ namespace TwkFB
     }
 
     void Read12Bit::readRGB8_PLANAR(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                    bool swap)
+                                    bool swap, bool parallel, int packing)
     {
         planarConfig(fb, w, h, FrameBuffer::UCHAR);
 
         FrameBuffer* R = &fb;
         FrameBuffer* G = R->nextPlane();
         FrameBuffer* B = G->nextPlane();
+        const size_t rowSize = unpackDPX_rowSize(w, 12, packing);
+        const size_t stride = R->scanlinePaddedSize();
+        const size_t rows = maxBytes ? std::min(size_t(h), maxBytes / rowSize) : size_t(h);
 
-        for (int y = 0; y < h; y++)
-        {
-            U16* in = (U16*)(data + y * w * sizeof(U16) * 3);
-            if (maxBytes && ((char*)in - (char*)data) > maxBytes)
-                break;
-
-            U8* restrict r = R->scanline<U8>(y);
-            U8* restrict g = G->scanline<U8>(y);
-            U8* restrict b = B->scanline<U8>(y);
-
-            if (swap)
-            {
-                for (U8* restrict end = r + w; r < end; r++, g++, b++)
-                {
-                    U16 p[3];
-                    p[0] = *in;
-                    in++;
-                    p[1] = *in;
-                    in++;
-                    p[2] = *in;
-                    in++;
-
-                    swapShorts(p, 3);
+        //
+        //  This should be doing some type of rounding
+        //
 
-                    // This should be doing some type of rounding
-                    *r = p[0] >> 8;
-                    *g = p[1] >> 8;
-                    *b = p[2] >> 8;
-                }
-            }
-            else
-            {
-                for (U8* restrict end = r + w; r < end; r++, g++, b++)
-                {
-                    // This should be doing some type of rounding
-                    *r = *in >> 8;
-                    in++;
-                    *g = *in >> 8;
-                    in++;
-                    *b = *in >> 8;
-                    in++;
-                }
-            }
+        if (parallel)
+        {
+            unpackDPX12_to_planarRGB8_MP(w, rows, data, rowSize, R->pixels<U8>(), G->pixels<U8>(), B->pixels<U8>(), stride, packing, swap);
+        }
+        else
+        {
+            unpackDPX12_to_planarRGB8(w, rows, data, rowSize, R->pixels<U8>(), G->pixels<U8>(), B->pixels<U8>(), stride, packing, swap);
         }
     }
 
     void Read12Bit::readRGB16_PLANAR(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                     bool swap)
+                                     bool swap, bool parallel, int packing)
     {
         planarConfig(fb, w, h, FrameBuffer::USHORT);
 
         FrameBuffer* R = &fb;
         FrameBuffer* G = R->nextPlane();
         FrameBuffer* B = G->nextPlane();
+        const size_t rowSize = unpackDPX_rowSize(w, 12, packing);
+        const size_t stride = R->scanlinePaddedSize();
+        const size_t rows = maxBytes ? std::min(size_t(h), maxBytes / rowSize) : size_t(h);
 
-        for (int y = 0; y < h; y++)
+        if (parallel)
         {
-            U16* in = (U16*)(data + y * w * sizeof(U16) * 3);
-            if (maxBytes && ((char*)in - (char*)data) > maxBytes)
-                break;
-
-            U16* restrict r = R->scanline<U16>(y);
-            U16* restrict g = G->scanline<U16>(y);
-            U16* restrict b = B->scanline<U16>(y);
-
-            if (swap)
-            {
-                for (U16* restrict end = r + w; r < end; r++, g++, b++)
-                {
-                    U16 p[3];
-                    p[0] = *in;
-                    in++;
-                    p[1] = *in;
-                    in++;
-                    p[2] = *in;
-                    in++;
-
-                    swapShorts(p, 3);
-
-                    *r = p[0];
-                    *g = p[1];
-                    *b = p[2];
-                }
-            }
-            else
-            {
-                for (U16* restrict end = r + w; r < end; r++, g++, b++)
-                {
-                    *r = *in;
-                    in++;
-                    *g = *in;
-                    in++;
-                    *b = *in;
-                    in++;
-                }
-            }
+            unpackDPX12_to_planarRGB16_MP(w, rows, data, rowSize, R->pixels<U16>(), G->pixels<U16>(), B->pixels<U16>(), stride, packing,
+                                          swap);
+        }
+        else
+        {
+            unpackDPX12_to_planarRGB16(w, rows, data, rowSize, R->pixels<U16>(), G->pixels<U16>(), B->pixels<U16>(), stride, packing,
+                                       swap);
         }
     }
 
     void Read12Bit::readNoPaddingRGB16(const string& filename, const unsigned char* data, FrameBuffer& fb, int w, int h, size_t maxBytes,
-                                       bool swap)
+                                       bool swap, bool parallel)
     {
-        planarConfig(fb, w, h, FrameBuffer::USHORT);
-
-        unsigned char* data2 = 0;
-
-        if (swap)
-        {
-            data2 = new unsigned char[maxBytes];
-            memcpy(data2, data, maxBytes);
-            TwkUtil::swapWords(data2, (maxBytes / 4));
-        }
-
-        FrameBuffer* R = &fb;
-        FrameBuffer* G = R->nextPlane();
-        FrameBuffer* B = G->nextPlane();
-
-        U16* elements[] = {R->pixels<U16>(), G->pixels<U16>(), B->pixels<U16>()};
-
         //
-        //  Loop over the nibbles
+        //  The 12 bit values follow each other least significant bits
+        //  first in (byte swapped if swap) 32 bit words and end up
+        //  shifted up by 4 like the filled ones.
         //
 
-        size_t nibbleIndex = 0;
-        size_t valueIndex = 0;
-        size_t elemIndex = 0;
-        size_t iteration = 0;
-
-        for (const unsigned char *p = (swap ? data2 : data), *e = p + maxBytes; p < e;)
-        {
-            const U16 nibble = *p & (nibbleIndex == 0 ? 0x0f : 0xf0);
-            if (valueIndex == 0)
-                *(elements[elemIndex]) = 0;
-            *(elements[elemIndex]) |= nibble << (valueIndex * 4 + 4 * (1 - nibbleIndex));
-
-            nibbleIndex ^= 0x1;
-            valueIndex = (valueIndex + 1) % 3;
-
-            if (nibbleIndex == 0)
-                p++;
-            if (valueIndex == 0)
-                elements[elemIndex]++;
-            elemIndex = (iteration / 3) % 3;
-            iteration++;
-        }
-
-        delete[] data2;
+        readRGB16_PLANAR(filename, data, fb, w, h, maxBytes, swap, parallel, DPX_UNPACK_PACKED);
     }
 
 } //  End namespace TwkFB
@@ -12,6 +12,7 @@
 #include <IOcin/Read12Bit.h>
 #include <TwkFB/Exception.h>
 #include <TwkFB/Operations.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkMath/Iostream.h>
 #include <TwkUtil/Interrupt.h>
 #include <TwkUtil/StdioBuf.h>
@@ -1030,10 +1031,10 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
             }
         }
 
-        if (inputBits == 10 && header.image.image_element[0].packing == IOdpx::DPX_PAD_NONE)
+        if (inputBits == 10 && header.image.image_element[0].packing == IOdpx::DPX_PAD_NONE && (alpha || packedYUV))
         {
             //  Some writers just put 0s in header, but we can't read "unfilled"
-            //  10bit pixels anyway, so try LSB Filling.
+            //  10bit RGBA or YUV pixels anyway, so try LSB Filling.
 
             cerr << "WARNING: DPX metadata specifies unaligned pixels: ignoring" << endl;
             header.image.image_element[0].packing = IOdpx::DPX_PAD_LSB_WORD;
@@ -1041,7 +1042,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
 
         const U16 packing0 = header.image.image_element[0].packing;
 
-        if (((inputBits == 10 || inputBits == 12) && packing0 == IOdpx::DPX_PAD_MSB_WORD) || inputBits == 32 || inputBits == 64
+        if ((inputBits == 10 && packing0 != IOdpx::DPX_PAD_LSB_WORD && (alpha || packedYUV)) || inputBits == 32 || inputBits == 64
             || !threeOrFourChannel)
         {
             TWK_THROW_STREAM(UnsupportedException, "DPX: unsupported internal layout " << filename);
@@ -1098,7 +1099,8 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
             fbi.dataType = FrameBuffer::USHORT;
             break;
         case RGB10_A2:
-            fbi.dataType = FrameBuffer::PACKED_R10_G10_B10_X2;
+            fbi.dataType = packing0 == IOdpx::DPX_PAD_LSB_WORD || inputBits != 10 ? FrameBuffer::PACKED_R10_G10_B10_X2
+                                                                                   : FrameBuffer::PACKED_X2_B10_G10_R10;
             break;
         case A2_BGR10:
             fbi.dataType = FrameBuffer::PACKED_X2_B10_G10_R10;
@@ -1157,6 +1159,18 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
 
         int numImages = header.image.element_number;
 
+        //
+        //  With MemoryMappedIO the raw paths point the fbs into the (copy
+        //  on write) mapping. Big endian files are read into fbs of their
+        //  own instead: swapping in place would write to every page and
+        //  copy the whole file anyway.
+        //
+
+        FrameBuffer::DataOwnerPtr mapping;
+
+        if (m_iotype == MemoryMappedIO && !swap)
+            mapping = adoptMemoryMap(fstream);
+
         for (size_t i = 0; i < numImages; i++) // only first image to start with
         {
             if (request.views.empty() && i > 0)
@@ -1224,8 +1238,22 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                 readerComment << "Assumed LSB padding from data size" << endl;
             }
 
-            if (((inputBits == 10 || inputBits == 12) && packing == IOdpx::DPX_PAD_MSB_WORD) || inputBits == 32 || inputBits == 64
-                || !threeOrFourChannel)
+            if (inputBits == 10 && packing == IOdpx::DPX_PAD_NONE && (alpha || packedYUV))
+            {
+                packing = (U16)IOdpx::DPX_PAD_LSB_WORD;
+                readerComment << "Assumed LSB padding for unpadded RGBA/YUV" << endl;
+            }
+
+            //
+            //  The 10 bit RGB readers (other than the RGBA8 and RGBA16
+            //  ones) and the 12 bit ones unpack all the DPX packings
+            //  with the FastConversion.h unpackDPX functions.
+            //
+
+            const bool filledA = packing == IOdpx::DPX_PAD_LSB_WORD;
+            const bool packingOK = filledA || inputBits != 10 || (!alpha && !packedYUV && m_format != RGBA8 && m_format != RGBA16);
+
+            if (!packingOK || inputBits == 32 || inputBits == 64 || !threeOrFourChannel)
             {
                 TWK_THROW_STREAM(UnsupportedException, "DPX: unsupported internal layout " << filename);
             }
@@ -1234,18 +1262,24 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
             // RAW OPTIMIZATION:
             //
             // Should probably make this 4096 not 16 for alignment, but
-            // the GL manuals imply 16 is ok. Its definitely not possibly
-            // to use raw for MemoryMappedIO because the memory *will* be
-            // unmapped no matter what. (It will core dump to remind you
-            // of this).
+            // the GL manuals imply 16 is ok. With MemoryMappedIO the fb
+            // can only be raw if it keeps the mapping alive.
             //
 
             const size_t alignment = size_t(data) & 0xFFF;
-            const bool canUseRaw = size_t(data) % 16 == 0 && m_iotype != MemoryMappedIO;
+            const bool canUseRaw = size_t(data) % 16 == 0 && (m_iotype != MemoryMappedIO || mapping);
             bool didUseRaw = false;
 
             bool readit = false;
 
+            //
+            //  The scanlines of (most) 10 bit layouts are independent so
+            //  the display frame can be unpacked in bands by the
+            //  TwkFB::ThreadPool.
+            //
+
+            const bool parallel = request.parallelDecode && TwkFB::ThreadPool::getNumThreads() > 0;
+
             try
             {
                 if (inputBits == 10)
@@ -1267,7 +1301,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                             if (alpha)
                                 Read10Bit::readRGBA8(filename, data, fb, w, h, maxData, true, swap);
                             else
-                                Read10Bit::readRGB8(filename, data, fb, w, h, maxData, swap);
+                                Read10Bit::readRGB8(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             readit = true;
                             break;
                         }
@@ -1280,7 +1314,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                             if (alpha)
                                 Read10Bit::readRGBA16(filename, data, fb, w, h, maxData, alpha, swap);
                             else
-                                Read10Bit::readRGB16(filename, data, fb, w, h, maxData, swap);
+                                Read10Bit::readRGB16(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             readit = true;
                             break;
                         }
@@ -1295,6 +1329,15 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                                 Read10Bit::readRGBA8(filename, data, fb, w, h, maxData, true, swap);
                                 nonspec = true;
                             }
+                            else if (!filledA)
+                            {
+                                //
+                                //  Only method A words are already
+                                //  laid out like RGB10_A2 pixels
+                                //
+
+                                Read10Bit::readA2_BGR10(filename, data, fb, w, h, maxData, swap, parallel, packing);
+                            }
                             else
                             {
                                 //
@@ -1305,7 +1348,8 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                                 const bool partial = size_t(4 * w * h) > maxData;
                                 didUseRaw = canUseRaw && !partial;
 
-                                Read10Bit::readRGB10_A2(filename, data, fb, w, h, maxData, swap, didUseRaw, (unsigned char*)fstream.data());
+                                Read10Bit::readRGB10_A2(filename, data, fb, w, h, maxData, swap, didUseRaw, (unsigned char*)fstream.data(),
+                                                        parallel);
                             }
 
                             readit = true;
@@ -1322,7 +1366,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                             {
                                 didUseRaw = false;
 
-                                Read10Bit::readA2_BGR10(filename, data, fb, w, h, maxData, swap);
+                                Read10Bit::readA2_BGR10(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             }
 
                             readit = true;
@@ -1337,7 +1381,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                             }
                             else
                             {
-                                Read10Bit::readRGB8_PLANAR(filename, data, fb, w, h, maxData, swap);
+                                Read10Bit::readRGB8_PLANAR(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             }
 
                             readit = true;
@@ -1352,7 +1396,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                             }
                             else
                             {
-                                Read10Bit::readRGB16_PLANAR(filename, data, fb, w, h, maxData, swap);
+                                Read10Bit::readRGB16_PLANAR(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             }
 
                             readit = true;
@@ -1375,7 +1419,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                 {
                     if (packing == IOdpx::DPX_PAD_NONE)
                     {
-                        Read12Bit::readNoPaddingRGB16(filename, data, fb, w, h, maxData, swap);
+                        Read12Bit::readNoPaddingRGB16(filename, data, fb, w, h, maxData, swap, parallel);
                     }
                     else
                     {
@@ -1385,14 +1429,14 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                         case RGB8:
                         case RGBA8:
                         case RGB8_PLANAR:
-                            Read12Bit::readRGB8_PLANAR(filename, data, fb, w, h, maxData, swap);
+                            Read12Bit::readRGB8_PLANAR(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             break;
                         case RGB10_A2:
                         case A2_BGR10:
                         case RGB16:
                         case RGBA16:
                         case RGB16_PLANAR:
-                            Read12Bit::readRGB16_PLANAR(filename, data, fb, w, h, maxData, swap);
+                            Read12Bit::readRGB16_PLANAR(filename, data, fb, w, h, maxData, swap, parallel, packing);
                             break;
                         }
 
@@ -1495,14 +1539,17 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                 if (swap)
                     str << "Swapped ";
                 if (didUseRaw)
-                    str << "Raw ";
+                    str << (m_iotype == MemoryMappedIO ? "Mapped " : "Raw ");
                 str << " LSbs=0x" << hex << alignment << " ";
                 fb.newAttribute("IOdpx/Other", str.str());
             }
 
             if (didUseRaw)
             {
-                fstream.setDeleteOnDestruction(false);
+                if (mapping)
+                    fb.setDataOwner(mapping);
+                else
+                    fstream.setDeleteOnDestruction(false);
             }
 
             switch (header.image.orientation)
@@ -87,7 +87,8 @@ namespace TwkFB
     void IOexr::readMultiPartChannelList(const std::string& filename, const std::string& view, FrameBuffer& fb,
                                          Imf::MultiPartInputFile& file, vector<MultiPartChannel>& channelsRead, bool convertYRYBY,
                                          bool planar3channel, bool allChannels, bool inheritChannels, bool noOneChannelPlanes,
-                                         bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window)
+                                         bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window,
+                                         const ReadRequest& request)
     {
         // Move the outfb setup and attributes to
         // a new function.
@@ -98,6 +99,29 @@ namespace TwkFB
         FrameBuffer* outfb = &fb;
         Imath::Box2i dspWin = file.header(partNum).displayWindow();
         Imath::Box2i datWin = file.header(partNum).dataWindow();
+
+        //
+        //  A mip/rip map level is only read if every part has the same
+        //  data window and tiling (they all share the rows of outfb)
+        //
+
+        int level = subsetLevel(file.header(partNum), request);
+
+        for (size_t i = 0; level > 0 && i < channelsRead.size(); i++)
+        {
+            const Imf::Header& header = file.header(channelsRead[i].partNumber);
+
+            if (header.dataWindow() != datWin || !header.hasTileDescription()
+                || !(header.tileDescription() == file.header(partNum).tileDescription()))
+            {
+                level = 0;
+            }
+        }
+
+        const Imath::Box2i levelWin = subsetWindows(file.header(partNum), level, request, dspWin, datWin);
+        Imath::Box2i levelUnionWin = levelWin;
+        levelUnionWin.extendBy(dspWin);
+
         Imath::Box2i unionWin;
         unionWin.extendBy(datWin);
         unionWin.extendBy(dspWin);
@@ -111,7 +135,7 @@ namespace TwkFB
         case IOexr::DataWindow:
             bufWin.extendBy(datWin);
             if (readWindowIsDisplayWindow)
-                dspWin = bufWin;
+                dspWin = levelWin;
             break;
         default:
         case IOexr::DataInsideDisplayWindow:
@@ -140,7 +164,7 @@ namespace TwkFB
         case IOexr::UnionWindow:
             bufWin.extendBy(unionWin);
             if (readWindowIsDisplayWindow)
-                dspWin = bufWin;
+                dspWin = levelUnionWin;
             break;
         }
 
@@ -830,12 +854,9 @@ namespace TwkFB
             LOG.log("Reading part %d into framebuffer %d... ", (*it), i);
 #endif
             // From set of parts
-            Imf::InputPart inpart(file, (*it));
-            inpart.setFrameBuffer(exrFrameBuffer[*it]);
-
             try
             {
-                inpart.readPixels(datWin.min.y, datWin.max.y);
+                readPartPixels(filename, file, *it, exrFrameBuffer[*it], datWin.min.y, datWin.max.y, request.parallelDecode, *outfb, level);
             }
             catch (...)
             {
@@ -1024,9 +1045,38 @@ namespace TwkFB
         rcl.push_back(mpChannel);
     }
 
+    bool IOexr::restrictToConsumedChannels(vector<MultiPartChannel>& channels, const ReadRequest& request)
+    {
+        if (request.consumedChannels.empty())
+            return false;
+
+        vector<MultiPartChannel> nchannels;
+
+        for (size_t i = 0; i < channels.size(); i++)
+        {
+            const MultiPartChannel& c = channels[i];
+
+            if (c.name == "RY" || c.name == "BY")
+                return false;
+
+            if (request.consumesChannel(c.name) || request.consumesChannel(c.fullname))
+                nchannels.push_back(c);
+        }
+
+        //
+        //  Parts without any of the channels aren't read at all
+        //
+
+        if (nchannels.empty())
+            return false;
+
+        channels.swap(nchannels);
+        return true;
+    }
+
     void IOexr::readImagesFromMultiPartFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const std::string& filename,
                                             const string& requestedView, const string& requestedLayer, const string& requestedChannel,
-                                            const bool requestedAllChannels) const
+                                            const bool requestedAllChannels, const ReadRequest& request) const
     {
 #ifdef DEBUG_IOEXR
         LOG.log("Reading multipart exr with %d parts.", file.parts());
@@ -1161,6 +1211,14 @@ namespace TwkFB
             } // if (!requestedLayer.empty())
         } // end of parts loop
 
+        //
+        //  If the caller won't use alpha don't let the inherited channel
+        //  search go looking for one either
+        //
+
+        if (restrictToConsumedChannels(requestedMPChannelList, request))
+            stripAlpha = stripAlpha || !request.consumesChannel("A");
+
         if (requestedMPChannelList.empty())
         {
             // NB: This really should not happen but could if an
@@ -1181,7 +1239,7 @@ namespace TwkFB
 
         readMultiPartChannelList(filename, requestedView, *fbs.back(), file, requestedMPChannelList, m_convertYRYBY, m_planar3channel,
                                  requestedAllChannels, m_inheritChannels, m_noOneChannelPlanes, stripAlpha, m_readWindowIsDisplayWindow,
-                                 m_readWindow);
+                                 m_readWindow, request);
 
         if (!requestedChannel.empty())
         {
@@ -53,11 +53,28 @@ namespace TwkFB
     void IOexr::readMultiViewChannelList(const std::string& filename, const std::string& layer, const std::string& view, FrameBuffer& fb,
                                          Imf::MultiPartInputFile& file, int partNum, Imf::ChannelList& cl, bool useRGBAReader,
                                          bool convertYRYBY, bool planar3channel, bool allChannels, bool inheritChannels,
-                                         bool noOneChannelPlanes, bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window)
+                                         bool noOneChannelPlanes, bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window,
+                                         const ReadRequest& request)
     {
         FrameBuffer* outfb = &fb;
         Imath::Box2i dspWin = file.header(partNum).displayWindow();
         Imath::Box2i datWin = file.header(partNum).dataWindow();
+
+        //
+        //  Mip/rip map levels can't go through the RGBA reader
+        //
+
+        int level = 0;
+
+        if (!useRGBAReader && !(convertYRYBY && (cl.findChannel("RY") || cl.findChannel("BY"))))
+        {
+            level = subsetLevel(file.header(partNum), request);
+        }
+
+        const Imath::Box2i levelWin = subsetWindows(file.header(partNum), level, request, dspWin, datWin);
+        Imath::Box2i levelUnionWin = levelWin;
+        levelUnionWin.extendBy(dspWin);
+
         Imath::Box2i unionWin;
         unionWin.extendBy(datWin);
         unionWin.extendBy(dspWin);
@@ -71,7 +88,7 @@ namespace TwkFB
         case IOexr::DataWindow:
             bufWin.extendBy(datWin);
             if (readWindowIsDisplayWindow)
-                dspWin = bufWin;
+                dspWin = levelWin;
             break;
         default:
         case IOexr::DataInsideDisplayWindow:
@@ -100,7 +117,7 @@ namespace TwkFB
         case IOexr::UnionWindow:
             bufWin.extendBy(unionWin);
             if (readWindowIsDisplayWindow)
-                dspWin = bufWin;
+                dspWin = levelUnionWin;
             break;
         }
 
@@ -227,7 +244,7 @@ namespace TwkFB
 #endif
         }
 
-        if (!planarYRYBY && noOneChannelPlanes && channelNames.size() == 3)
+        if (!planarYRYBY && noOneChannelPlanes && channelNames.size() == 3 && level == 0)
         {
             useRGBAReader = true;
         }
@@ -667,12 +684,9 @@ namespace TwkFB
                 }
             }
 
-            Imf::InputPart inpart(file, partNum);
-            inpart.setFrameBuffer(exrFrameBuffer);
-
             try
             {
-                inpart.readPixels(datWin.min.y, datWin.max.y);
+                readPartPixels(filename, file, partNum, exrFrameBuffer, datWin.min.y, datWin.max.y, request.parallelDecode, *outfb, level);
             }
             catch (...)
             {
@@ -730,10 +744,30 @@ namespace TwkFB
         }
     }
 
+    bool IOexr::restrictToConsumedChannels(Imf::ChannelList& cl, const ReadRequest& request)
+    {
+        if (request.consumedChannels.empty() || cl.findChannel("RY") || cl.findChannel("BY"))
+            return false;
+
+        Imf::ChannelList ncl;
+
+        for (Imf::ChannelList::ConstIterator i = cl.begin(); i != cl.end(); ++i)
+        {
+            if (request.consumesChannel(i.name()))
+                ncl.insert(i.name(), i.channel());
+        }
+
+        if (ncl.begin() == ncl.end())
+            return false;
+
+        cl = ncl;
+        return true;
+    }
+
     void IOexr::readImagesFromMultiViewFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const string& filename,
                                             const string& requestedView, const string& requestedLayer, const string& requestedChannel,
                                             const bool requestedAllChannels, const int partNum, const ViewNames& views,
-                                            bool requestedViewIsDefaultView) const
+                                            bool requestedViewIsDefaultView, const ReadRequest& request) const
     {
 #ifdef DEBUG_IOEXR
         LOG.log("Reading multiview exr with views:");
@@ -814,12 +848,18 @@ namespace TwkFB
         //  Get a list of all the channels in the file and then decide
         //  what to do with them.
         //
+        //  If the caller won't use alpha don't let the inherited channel
+        //  search go looking for one either.
+        //
         fbs.push_back(new FrameBuffer());
         if (requestedLayer.empty())
         {
+            if (restrictToConsumedChannels(cl, request))
+                stripAlpha = stripAlpha || !request.consumesChannel("A");
+
             readMultiViewChannelList(filename, requestedLayer, requestedView, *fbs.back(), file, partNum, cl, m_rgbaOnly, m_convertYRYBY,
                                      m_planar3channel, requestedAllChannels, m_inheritChannels, m_noOneChannelPlanes, stripAlpha,
-                                     m_readWindowIsDisplayWindow, m_readWindow);
+                                     m_readWindowIsDisplayWindow, m_readWindow, request);
         }
         else
         {
@@ -837,9 +877,12 @@ namespace TwkFB
                 ncl.insert(ci.name(), ci.channel());
             }
 
+            if (restrictToConsumedChannels(ncl, request))
+                stripAlpha = stripAlpha || !request.consumesChannel("A");
+
             readMultiViewChannelList(filename, requestedLayer, requestedView, *fbs.back(), file, partNum, ncl, m_rgbaOnly, m_convertYRYBY,
                                      m_planar3channel, requestedAllChannels, m_inheritChannels, m_noOneChannelPlanes, stripAlpha,
-                                     m_readWindowIsDisplayWindow, m_readWindow);
+                                     m_readWindowIsDisplayWindow, m_readWindow, request);
         }
 
         if (!requestedChannel.empty())
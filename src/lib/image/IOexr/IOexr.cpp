@@ -20,6 +20,7 @@
 #include <ImfTileDescriptionAttribute.h>
 #include <ImfMultiPartInputFile.h>
 #include <ImfInputPart.h>
+#include <ImfTiledInputPart.h>
 #include <ImfInputFile.h>
 #include <ImfRgbaFile.h>
 #include <ImfIntAttribute.h>
@@ -41,6 +42,7 @@
 #include <TwkMath/Vec2.h>
 #include <TwkFB/Exception.h>
 #include <TwkFB/Operations.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <algorithm>
 #include <iostream>
 #include <iterator>
@@ -1146,6 +1148,124 @@ namespace TwkFB
         }
     }
 
+    static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    static int ceilDiv(int a, int b) { return -floorDiv(-a, b); }
+
+    int IOexr::subsetLevel(const Imf::Header& header, const ReadRequest& request)
+    {
+        if (!request.hasResolution() || !header.hasTileDescription())
+            return 0;
+
+        const Imf::TileDescription& td = header.tileDescription();
+
+        if (td.mode != Imf::MIPMAP_LEVELS && td.mode != Imf::RIPMAP_LEVELS)
+            return 0;
+
+        //
+        //  Rip maps are read along the diagonal so the smaller side
+        //  limits the levels. Rounding down gives the fewest levels.
+        //
+
+        const Imath::Box2i& dw = header.dataWindow();
+        const int w = dw.max.x - dw.min.x + 1;
+        const int h = dw.max.y - dw.min.y + 1;
+        const int size = td.mode == Imf::MIPMAP_LEVELS ? std::max(w, h) : std::min(w, h);
+        int maxLevel = 0;
+
+        while ((size >> (maxLevel + 1)) > 0)
+            maxLevel++;
+
+        return request.reductionLevel(maxLevel);
+    }
+
+    Imath::Box2i IOexr::subsetWindows(const Imf::Header& header, int level, const ReadRequest& request, Imath::Box2i& dspWin,
+                                      Imath::Box2i& datWin)
+    {
+        const int s = 1 << level;
+
+        if (level > 0)
+        {
+            const Imf::TileDescription& td = header.tileDescription();
+            const bool roundUp = td.roundingMode == Imf::ROUND_UP;
+            const Imath::V2i dsize = datWin.size() + Imath::V2i(1, 1);
+            const Imath::V2i ssize = dspWin.size() + Imath::V2i(1, 1);
+            const Imath::V2i offset = datWin.min - dspWin.min;
+
+            const int lw = std::max(1, roundUp ? ceilDiv(dsize.x, s) : dsize.x / s);
+            const int lh = std::max(1, roundUp ? ceilDiv(dsize.y, s) : dsize.y / s);
+
+            datWin.max = datWin.min + Imath::V2i(lw - 1, lh - 1);
+            dspWin.min = datWin.min - Imath::V2i(floorDiv(offset.x, s), floorDiv(offset.y, s));
+            dspWin.max = dspWin.min + Imath::V2i(std::max(1, ceilDiv(ssize.x, s)) - 1, std::max(1, ceilDiv(ssize.y, s)) - 1);
+        }
+
+        const Imath::Box2i levelWin = datWin;
+
+        if (request.hasRegion())
+        {
+            int y0 = std::max(datWin.min.y, dspWin.min.y + floorDiv(request.y0, s));
+            int y1 = std::min(datWin.max.y, dspWin.min.y + ceilDiv(request.y1, s) - 1);
+
+            if (level > 0)
+            {
+                const int th = header.tileDescription().ySize;
+                y0 = datWin.min.y + floorDiv(y0 - datWin.min.y, th) * th;
+                y1 = std::min(datWin.max.y, datWin.min.y + (floorDiv(y1 - datWin.min.y, th) + 1) * th - 1);
+            }
+
+            //
+            //  Nothing in the data window: read all of it
+            //
+
+            if (y0 <= y1)
+            {
+                datWin.min.y = y0;
+                datWin.max.y = y1;
+            }
+        }
+
+        return levelWin;
+    }
+
+    void IOexr::readPartPixels(const std::string& filename, Imf::MultiPartInputFile& file, int partNum,
+                               const Imf::FrameBuffer& frameBuffer, int y0, int y1, bool parallel, FrameBuffer& fb, int level)
+    {
+        if (level > 0)
+        {
+            Imf::TiledInputPart inpart(file, partNum);
+            inpart.setFrameBuffer(frameBuffer);
+            const int th = inpart.tileYSize();
+            const int dy = inpart.dataWindowForLevel(level, level).min.y;
+            inpart.readTiles(0, inpart.numXTiles(level) - 1, (y0 - dy) / th, (y1 - dy) / th, level, level);
+            return;
+        }
+
+        //
+        //  Each band reopens the file and rereads the header so don't
+        //  bother unless there's a good number of scanlines per band.
+        //
+
+        const size_t minBandHeight = 256;
+
+        if (!parallel || TwkFB::ThreadPool::getNumThreads() == 0 || size_t(y1 - y0 + 1) < 2 * minBandHeight)
+        {
+            Imf::InputPart inpart(file, partNum);
+            inpart.setFrameBuffer(frameBuffer);
+            inpart.readPixels(y0, y1);
+            return;
+        }
+
+        TwkFB::ThreadPool::parallelFor(size_t(y0), size_t(y1) + 1, minBandHeight,
+                                       [&](size_t b, size_t e)
+                                       {
+                                           Imf::MultiPartInputFile bandFile(filename.c_str());
+                                           Imf::InputPart inpart(bandFile, partNum);
+                                           inpart.setFrameBuffer(frameBuffer);
+                                           inpart.readPixels(int(b), int(e) - 1);
+                                       });
+    }
+
     void IOexr::readImages(FrameBufferVector& fbs, const std::string& filename, const ReadRequest& request) const
     {
         if (m_iotype == StandardIO)
@@ -1218,7 +1338,8 @@ namespace TwkFB
             }
 
             // Implies read a MultiPart file
-            readImagesFromMultiPartFile(file, fbs, filename, requestedView, requestedLayer, requestedChannel, request.allChannels);
+            readImagesFromMultiPartFile(file, fbs, filename, requestedView, requestedLayer, requestedChannel, request.allChannels,
+                                        request);
         }
         else
         {
@@ -1252,7 +1373,7 @@ namespace TwkFB
             }
 
             readImagesFromMultiViewFile(file, fbs, filename, requestedView, requestedLayer, requestedChannel, request.allChannels, partNum,
-                                        views, (requestedView == defaultView));
+                                        views, (requestedView == defaultView), request);
         }
     }
 
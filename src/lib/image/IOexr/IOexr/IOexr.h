@@ -12,6 +12,7 @@
 #include <TwkFB/IO.h>
 #include <ImfMultiPartInputFile.h>
 #include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
 #include <map>
 #include <string>
 #include <set>
@@ -118,12 +119,13 @@ namespace TwkFB
 
         void readImagesFromMultiPartFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const std::string& filename,
                                          const std::string& requestedView, const std::string& requestedLayer,
-                                         const std::string& requestedChannel, const bool requestedAllChannels) const;
+                                         const std::string& requestedChannel, const bool requestedAllChannels,
+                                         const ReadRequest& request) const;
 
         void readImagesFromMultiViewFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const std::string& filename,
                                          const std::string& requestedView, const std::string& requestedLayer,
                                          const std::string& requestedBaseChannel, const bool requestedAllChannels, const int partNum,
-                                         const ViewNames& views, bool requestedViewIsDefaultView) const;
+                                         const ViewNames& views, bool requestedViewIsDefaultView, const ReadRequest& request) const;
 
         void writeImagesToMultiPartFile(const ConstFrameBufferVector& fbs, const std::string& filename, const WriteRequest& request) const;
 
@@ -149,6 +151,18 @@ namespace TwkFB
         static void addToMultiPartChannelList(std::vector<MultiPartChannel>& rcl, const int partNumber, const std::string& partName,
                                               const std::string& channelName, const Imf::Channel& channel);
 
+        //
+        //  Drop the channels the request doesn't consume (see
+        //  ReadRequest::consumedChannels) so they aren't decoded. The
+        //  list is left alone if nothing would be left or it has
+        //  luminance/chroma channels. Returns true if it was
+        //  restricted.
+        //
+
+        static bool restrictToConsumedChannels(Imf::ChannelList& cl, const ReadRequest& request);
+
+        static bool restrictToConsumedChannels(std::vector<MultiPartChannel>& channels, const ReadRequest& request);
+
         static bool isAMultiPartSharedAttribute(const std::string& name);
 
         static bool isAces(const Imf::Chromaticities& c);
@@ -221,7 +235,7 @@ namespace TwkFB
                                              FrameBuffer& fb, Imf::MultiPartInputFile& file, int partNum, Imf::ChannelList& cl,
                                              bool useRGBAReader, bool convertYRYBY, bool planar3channel, bool allChannels,
                                              bool inheritChannels, bool noOneChannelPlanes, bool stripAlpha, bool readWindowIsDisplayWindow,
-                                             IOexr::ReadWindow window);
+                                             IOexr::ReadWindow window, const ReadRequest& request);
 
         static void getBiggerFrameBufferAndEXRPixelType(const Imf::Channel& channel, FrameBuffer::DataType& fbDataType,
                                                         Imf::PixelType& exrPixelType);
@@ -229,7 +243,35 @@ namespace TwkFB
         static void readMultiPartChannelList(const std::string& filename, const std::string& view, FrameBuffer& fb,
                                              Imf::MultiPartInputFile& file, std::vector<MultiPartChannel>& channelsRead, bool convertYRYBY,
                                              bool planar3channel, bool allChannels, bool inheritChannels, bool noOneChannelPlanes,
-                                             bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window);
+                                             bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window,
+                                             const ReadRequest& request);
+
+        //
+        //  Reads scanlines y0 to y1 of part into frameBuffer. If parallel
+        //  the scanlines are split into bands which are decoded
+        //  concurrently, each from its own handle on the file. A non-0
+        //  level reads the tiles of that mip/rip map level holding the
+        //  scanlines (always serially).
+        //
+
+        static void readPartPixels(const std::string& filename, Imf::MultiPartInputFile& file, int partNum,
+                                   const Imf::FrameBuffer& frameBuffer, int y0, int y1, bool parallel, FrameBuffer& fb,
+                                   int level = 0);
+
+        //
+        //  The resolution and region of a request. subsetLevel() is the
+        //  mip/rip map level to read (0 unless the part is tiled with
+        //  levels). subsetWindows() changes the windows of the part to
+        //  the ones at level (the display window is scaled around the
+        //  data window) and restricts the rows of datWin to the ones
+        //  holding the region, rounded out to whole tiles when level
+        //  isn't 0. It returns the whole data window of the level.
+        //
+
+        static int subsetLevel(const Imf::Header& header, const ReadRequest& request);
+
+        static Imath::Box2i subsetWindows(const Imf::Header& header, int level, const ReadRequest& request, Imath::Box2i& dspWin,
+                                          Imath::Box2i& datWin);
 
         static bool stripViewFromName(std::string& name, const std::string& view);
 
@@ -104,14 +104,22 @@ namespace TwkFB
         }
     }
 
-    void copyScanLine(ojph::codestream* codestream, ojph::ui32 width, ojph::ui32 channels, ojph::ui32 row, ojph::ui32 component,
-                      FrameBuffer::DataType dtype, int bit_offset, FrameBuffer* fb)
+    //
+    //  Pulls the next line of component from the codestream and copies
+    //  width samples starting at x0 to row of the fb. A negative row
+    //  just discards the line.
+    //
+
+    void copyScanLine(ojph::codestream* codestream, ojph::ui32 x0, ojph::ui32 width, ojph::ui32 channels, int row,
+                      ojph::ui32 component, FrameBuffer::DataType dtype, int bit_offset, FrameBuffer* fb)
     {
 
         ojph::ui32 comp_num;
         ojph::line_buf* line = codestream->pull(comp_num);
-        const ojph::si32* sp = line->i32;
+        const ojph::si32* sp = line->i32 + x0;
         assert(comp_num == component);
+        if (row < 0)
+            return;
         if (dtype == FrameBuffer::UCHAR)
         {
             unsigned char* dout = fb->scanline<unsigned char>(row);
@@ -133,7 +141,7 @@ namespace TwkFB
         }
     }
 
-    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb)
+    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb, const FrameBufferIO::ReadRequest& request)
     {
         ojph::codestream codestream;
         codestream.read_headers(infile);
@@ -141,12 +149,23 @@ namespace TwkFB
         // codestream.enable_resilience();
         ojph::param_siz siz = codestream.access_siz();
         ojph::param_nlt nlt = codestream.access_nlt();
+
+        //
+        //  A reduced resolution skips decoding the finest wavelet
+        //  levels entirely (power of two steps, rounded up)
+        //
+
+        const int level = request.reductionLevel(codestream.access_cod().get_num_decompositions());
+
+        if (level > 0)
+            codestream.restrict_input_resolution(level, level);
+
         codestream.create();
 
         int bit_offset = 0;
         const int ch = siz.get_num_components();
-        const int w = siz.get_recon_width(0);
-        const int h = siz.get_recon_height(0);
+        const int fullw = siz.get_recon_width(0);
+        const int fullh = siz.get_recon_height(0);
         bool nlt_is_signed;
         ojph::ui8 nlt_bit_depth;
         ojph::ui8 nl_type;
@@ -160,6 +179,24 @@ namespace TwkFB
         if (has_nlt)
             TWK_THROW_STREAM(UnsupportedException, "HTJ2K: unsupported notlinear transform in jpeg2000 image");
 
+        //
+        //  The codestream is still decoded a line at a time, but only
+        //  the region's rows and columns are kept and decoding stops
+        //  after its last row when the components are interleaved.
+        //
+
+        int x0, y0, x1, y1;
+
+        if (!request.regionAtLevel(level, fullw, fullh, x0, y0, x1, y1))
+        {
+            x0 = y0 = 0;
+            x1 = fullw;
+            y1 = fullh;
+        }
+
+        const int w = x1 - x0;
+        const int h = y1 - y0;
+
         // 4. Wrap the decoded image in a FrameBuffer
         FrameBuffer::DataType dtype = FrameBuffer::USHORT;
 
@@ -201,16 +238,19 @@ namespace TwkFB
         {
             // Its pretty rare for RGB to be planar, possibily the most common case is a single channel image
             for (ojph::ui32 c = 0; c < siz.get_num_components(); ++c)
-                for (ojph::ui32 i = 0; i < h; ++i)
-                    copyScanLine(&codestream, w, ch, i, c, dtype, bit_offset, fb);
+                for (int i = 0; i < fullh; ++i)
+                    copyScanLine(&codestream, x0, w, ch, i >= y0 && i < y1 ? i - y0 : -1, c, dtype, bit_offset, fb);
         }
         else
         {
-            for (ojph::ui32 i = 0; i < h; ++i)
+            for (int i = 0; i < y1; ++i)
                 for (ojph::ui32 c = 0; c < siz.get_num_components(); ++c)
-                    copyScanLine(&codestream, w, ch, i, c, dtype, bit_offset, fb);
+                    copyScanLine(&codestream, x0, w, ch, i >= y0 ? i - y0 : -1, c, dtype, bit_offset, fb);
         }
 
+        if (request.hasResolution() || request.hasRegion())
+            fb->setUncrop(fullw, fullh, x0, y0);
+
         return fb;
     }
 
@@ -222,7 +262,7 @@ namespace TwkFB
         ojph::j2c_infile j2c_file;
         j2c_file.open(filename.c_str());
 
-        decodeHTJ2K(&j2c_file, &fb);
+        decodeHTJ2K(&j2c_file, &fb, request);
     }
 
 } // namespace TwkFB
@@ -35,8 +35,10 @@ namespace TwkFB
     /// @brief Decode a HTJ2K file into a FrameBuffer
     /// @param infile ojph::infile_base object that provides the input stream
     /// @param fb if non-NULL, decode into this FrameBuffer, otherwise create a new one
+    /// @param request resolution and region to decode (the whole image by default)
     /// @return fb
-    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb = NULL);
+    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb = NULL,
+                             const FrameBufferIO::ReadRequest& request = FrameBufferIO::ReadRequest());
 
 } // namespace TwkFB
 
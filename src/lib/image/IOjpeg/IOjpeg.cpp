@@ -12,6 +12,8 @@
 #include <TwkUtil/File.h>
 #include <TwkUtil/FileStream.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <cmath>
 
 extern "C"
 {
@@ -292,20 +294,72 @@ namespace TwkFB
             outformat = informat;
         }
 
+        //
+        //  A reduced resolution comes from the DCT scaling (n/8 with
+        //  libjpeg-turbo, 1/2, 1/4 or 1/8 otherwise, always rounded
+        //  up). Subsets go through the RGB(A) readers.
+        //
+
+        const bool subset = request.hasResolution() || request.hasRegion();
+
+        if (subset && outformat == YUV)
+            outformat = RGB;
+
+        if (request.hasResolution())
+        {
+            cinfo.scale_num = std::max(1, std::min(8, int(std::ceil(request.resolution * 8.0f))));
+            cinfo.scale_denom = 8;
+        }
+
         if (outformat == YUV)
             cinfo.raw_data_out = TRUE;
 
         jpeg_start_decompress(&cinfo);
         throwError(state);
 
+        const size_t fullWidth = cinfo.output_width;
+        const size_t fullHeight = cinfo.output_height;
+        size_t y0 = 0;
+        size_t y1 = fullHeight;
+        JDIMENSION x0 = 0;
+
+        if (request.hasRegion())
+        {
+            const double sx = double(fullWidth) / double(cinfo.image_width);
+            const double sy = double(fullHeight) / double(cinfo.image_height);
+            x0 = JDIMENSION(std::min(double(fullWidth - 1), std::max(0.0, std::floor(request.x0 * sx))));
+            y0 = size_t(std::min(double(fullHeight - 1), std::max(0.0, std::floor(request.y0 * sy))));
+            y1 = size_t(std::min(double(fullHeight), std::max(double(y0 + 1), std::ceil(request.y1 * sy))));
+
+#ifdef LIBJPEG_TURBO_VERSION
+            //
+            //  Only the iMCU columns holding the region are decoded, x0
+            //  moves back to the column boundary
+            //
+
+            JDIMENSION x1 = JDIMENSION(std::min(double(fullWidth), std::max(double(x0 + 1), std::ceil(request.x1 * sx))));
+            JDIMENSION width = x1 - x0;
+            jpeg_crop_scanline(&cinfo, &x0, &width);
+            throwError(state);
+
+            if (y0 > 0)
+            {
+                jpeg_skip_scanlines(&cinfo, JDIMENSION(y0));
+                throwError(state);
+            }
+#else
+            x0 = 0;
+#endif
+        }
+
         switch (outformat)
         {
         default:
         case RGB:
-            readImageRGB(fb, state, cinfo);
+            readImageRGB(fb, state, cinfo, y0, y1);
             break;
         case RGBA:
-            readImageRGBA(fb, state, cinfo);
+            readImageRGBA(fb, state, cinfo, y0, y1);
             break;
         case YUV:
             readImageYUV(fb, state, cinfo);
@@ -313,7 +367,19 @@ namespace TwkFB
         }
 
         readAttributes(fb, cinfo);
-        jpeg_finish_decompress(&cinfo);
+
+        if (subset)
+            fb.setUncrop(fullWidth, fullHeight, x0, y0);
+
+        if (cinfo.output_scanline < cinfo.output_height)
+        {
+            jpeg_abort_decompress(&cinfo);
+        }
+        else
+        {
+            jpeg_finish_decompress(&cinfo);
+        }
+
         jpeg_destroy_decompress(&cinfo);
     }
 
@@ -747,53 +813,72 @@ namespace TwkFB
         fb.newAttribute("JPEG/Version", ver.str());
     }
 
-    void IOjpeg::readImageRGB(FrameBuffer& fb, const FileState& state, Decompressor& cinfo) const
+    //
+    //  Skips the scanlines before y0 if they weren't already skipped
+    //  (libjpeg without jpeg_skip_scanlines)
+    //
+
+    static void discardScanlines(IOjpeg::Decompressor& cinfo, size_t y0)
+    {
+        if (cinfo.output_scanline >= y0)
+            return;
+
+        vector<unsigned char> buffer(cinfo.output_width * cinfo.output_components);
+        unsigned char* scanline = &buffer.front();
+
+        while (cinfo.output_scanline < y0)
+        {
+            jpeg_read_scanlines(&cinfo, &scanline, 1);
+        }
+    }
+
+    void IOjpeg::readImageRGB(FrameBuffer& fb, const FileState& state, Decompressor& cinfo, size_t y0, size_t y1) const
     {
         //
         //  This is the basic JPEG -> RGB interleaved reader.
-        //  It allows libjpeg to do the color conversion.
+        //  It allows libjpeg to do the color conversion. Only the
+        //  scanlines y0 to y1 (from the top) are stored.
         //
 
-        size_t pixels = cinfo.output_width * cinfo.output_height;
-        size_t bytes = pixels * cinfo.output_components;
-        size_t scanline_bytes = cinfo.output_components * cinfo.output_width;
         size_t w = cinfo.output_width;
-        size_t h = cinfo.output_height;
+        size_t h = y1 - y0;
         size_t components = cinfo.output_components;
 
         fb.restructure(w, h, 0, components, FrameBuffer::UCHAR);
 
-        while (cinfo.output_scanline < h)
+        discardScanlines(cinfo, y0);
+        throwError(state);
+
+        while (cinfo.output_scanline < y1)
         {
-            int l = cinfo.output_scanline;
+            int l = cinfo.output_scanline - y0;
             unsigned char* scanline = fb.scanline<unsigned char>(h - l - 1);
             jpeg_read_scanlines(&cinfo, &scanline, 1);
             throwError(state);
         }
     }
 
-    void IOjpeg::readImageRGBA(FrameBuffer& fb, const FileState& state, Decompressor& cinfo) const
+    void IOjpeg::readImageRGBA(FrameBuffer& fb, const FileState& state, Decompressor& cinfo, size_t y0, size_t y1) const
     {
         //
         //  This is the basic JPEG -> RGB interleaved reader.
         //  It allows libjpeg to do the color conversion.
         //
 
-        size_t pixels = cinfo.output_width * cinfo.output_height;
-        size_t bytes = pixels * cinfo.output_components;
-        size_t scanline_bytes = cinfo.output_components * cinfo.output_width;
         size_t w = cinfo.output_width;
-        size_t h = cinfo.output_height;
-        size_t components = cinfo.output_components;
+        size_t h = y1 - y0;
 
         fb.restructure(w, h, 0, 4, FrameBuffer::UCHAR);
         vector<unsigned char> buffer(w * 3);
         unsigned char* inscanline = &buffer.front();
         const unsigned char* endp = &buffer.back();
 
-        while (cinfo.output_scanline < h)
+        discardScanlines(cinfo, y0);
+        throwError(state);
+
+        while (cinfo.output_scanline < y1)
         {
-            int l = cinfo.output_scanline;
+            int l = cinfo.output_scanline - y0;
             unsigned char* scanline = fb.scanline<unsigned char>(h - l - 1);
             jpeg_read_scanlines(&cinfo, &inscanline, 1);
 
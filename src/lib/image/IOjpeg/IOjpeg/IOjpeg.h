@@ -76,8 +76,8 @@ namespace TwkFB
         mutable bool m_error;
 
     private:
-        void readImageRGB(FrameBuffer& fb, const FileState&, Decompressor&) const;
-        void readImageRGBA(FrameBuffer& fb, const FileState&, Decompressor&) const;
+        void readImageRGB(FrameBuffer& fb, const FileState&, Decompressor&, size_t y0, size_t y1) const;
+        void readImageRGBA(FrameBuffer& fb, const FileState&, Decompressor&, size_t y0, size_t y1) const;
         void readImageYUV(FrameBuffer& fb, const FileState&, Decompressor&) const;
 
         bool canReadAsYUV(const Decompressor&) const;
@@ -5,6 +5,7 @@
 //
 //******************************************************************************
 #include <IOtiff/IOtiff.h>
+#include <IOtiff/TiffChunkDecoder.h>
 #include <iostream>
 #include <string>
 #include <stl_ext/string_algo.h>
@@ -14,10 +15,15 @@
 #include <TwkMath/Mat44.h>
 #include <TwkMath/Iostream.h>
 #include <TwkFB/Operations.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkUtil/FileStream.h>
 #include <TwkUtil/File.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 #if TIFFLIB_VERSION >= 20031226
 #define HAS_TIFFFIELDWITHTAG 1
@@ -172,6 +178,7 @@ namespace TwkFB
         : StreamingFrameBufferIO("IOtiff", "m1", ioMethod, chunkSize, maxAsync)
         , m_rgbPlanar(rgbPlanar)
         , m_addAlphaTo3Channel(addAlphaTo3Channel)
+        , m_parallelChunks(true)
     {
         TIFFSetErrorHandler(0);
         TIFFSetWarningHandler(0);
@@ -232,6 +239,8 @@ namespace TwkFB
             return m_addAlphaTo3Channel;
         else if (name == "rgbPlanar")
             return m_rgbPlanar;
+        else if (name == "parallelChunks")
+            return m_parallelChunks;
         return StreamingFrameBufferIO::getBoolAttribute(name);
     }
 
@@ -241,6 +250,8 @@ namespace TwkFB
             m_addAlphaTo3Channel = value;
         else if (name == "rgbPlanar")
             m_rgbPlanar = value;
+        else if (name == "parallelChunks")
+            m_parallelChunks = value;
         else
             StreamingFrameBufferIO::setBoolAttribute(name, value);
     }
@@ -947,32 +958,33 @@ namespace TwkFB
         }
     }
 
-    static void readContiguousTiledImage(TIFF* tif, int w, int h, FrameBuffer& img)
+    //
+    //  The pixels of a tiled image to read: whole tiles, clipped to the
+    //  image. The fb holds x0, y0 - x1, y1 at its origin.
+    //
+
+    struct TileRegion
     {
-        tsize_t rowsize = TIFFTileRowSize(tif);
+        uint32 x0;
+        uint32 y0;
+        uint32 x1;
+        uint32 y1;
+    };
 
-        unsigned short orient = ORIENTATION_TOPLEFT;
-        bool flip = false;
-        bool flop = false;
-        TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
-        flip = orient == ORIENTATION_TOPLEFT || orient == ORIENTATION_TOPRIGHT;
-        flop = orient == ORIENTATION_TOPRIGHT || orient == ORIENTATION_BOTRIGHT;
+    //
+    //  Reads the rows of tiles from tileRowBegin up to tileRowEnd of
+    //  region into img. Returns false if a tile couldn't be read.
+    //
 
-        if (flip)
-        {
-            img.setOrientation(flop ? FrameBuffer::TOPRIGHT : FrameBuffer::TOPLEFT);
-        }
-        else
-        {
-            img.setOrientation(flop ? FrameBuffer::BOTTOMRIGHT : FrameBuffer::NATURAL);
-        }
+    static bool readContiguousTileRows(TIFF* tif, FrameBuffer& img, const TileRegion& region, uint32 tileRowBegin, uint32 tileRowEnd)
+    {
+        tsize_t rowsize = TIFFTileRowSize(tif);
+        bool ok = true;
 
         if (unsigned char* buf = (unsigned char*)_TIFFmalloc(TIFFTileSize(tif)))
         {
-            uint32 tw, th, w, h;
+            uint32 tw, th;
 
-            TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
-            TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
             TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
             TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
 
@@ -981,36 +993,37 @@ namespace TwkFB
             TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
             TIFFGetField(tif, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
 
-            // These checks are to handle the case where the
-            // tile is larger than the image size.
-            //
-            uint32 copy_rowsize = ((w < tw) ? (w * rowsize / tw) : rowsize);
+            const uint32 rowEnd = std::min(region.y1, region.y0 + tileRowEnd * th);
 
-            for (uint32 row = 0; row < h; row += th)
+            for (uint32 row = region.y0 + tileRowBegin * th; ok && row < rowEnd; row += th)
             {
-                for (uint32 col = 0; col < w; col += tw)
+                for (uint32 col = region.x0; col < region.x1; col += tw)
                 {
                     if (TIFFReadTile(tif, buf, col, row, 0, 0) < 0)
                     {
-                        _TIFFfree(buf);
-                        return; // just return on partially read image
+                        ok = false; // just return on partially read image
+                        break;
                     }
                     else
                     {
                         //
-                        //  Copy the tile row over to the fb
+                        //  Copy the tile row over to the fb. These checks
+                        //  are to handle the tiles which hang off the
+                        //  edge of the image.
                         //
 
-                        for (int y = 0; y < th && row + y < h; y++)
+                        const uint32 copy_rowsize = (region.x1 - col < tw) ? ((region.x1 - col) * rowsize / tw) : rowsize;
+
+                        for (int y = 0; y < th && row + y < rowEnd; y++)
                         {
                             if (sampleFormat == SAMPLEFORMAT_INT)
                             {
                                 storeIntAsNormalizedFloatSamples(bitsPerSample, copy_rowsize, buf + y * rowsize,
-                                                                 &img.pixel<float>(col, row + y));
+                                                                 &img.pixel<float>(col - region.x0, row - region.y0 + y));
                             }
                             else
                             {
-                                unsigned char* s = &img.pixel<unsigned char>(col, row + y);
+                                unsigned char* s = &img.pixel<unsigned char>(col - region.x0, row - region.y0 + y);
                                 memcpy(s, buf + y * rowsize, copy_rowsize);
                             }
                         }
@@ -1020,9 +1033,76 @@ namespace TwkFB
 
             _TIFFfree(buf);
         }
+
+        return ok;
+    }
+
+    //
+    //  If parallel the rows of tiles are split into bands which are
+    //  decoded concurrently, each through its own handle on the file
+    //  (libtiff handles are not thread safe).
+    //
+
+    static void readContiguousTiledImage(TIFF* tif, const TileRegion& region, FrameBuffer& img, bool parallel = false,
+                                         const string& filename = string())
+    {
+        unsigned short orient = ORIENTATION_TOPLEFT;
+        bool flip = false;
+        bool flop = false;
+        TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
+        flip = orient == ORIENTATION_TOPLEFT || orient == ORIENTATION_TOPRIGHT;
+        flop = orient == ORIENTATION_TOPRIGHT || orient == ORIENTATION_BOTRIGHT;
+
+        if (flip)
+        {
+            img.setOrientation(flop ? FrameBuffer::TOPRIGHT : FrameBuffer::TOPLEFT);
+        }
+        else
+        {
+            img.setOrientation(flop ? FrameBuffer::BOTTOMRIGHT : FrameBuffer::NATURAL);
+        }
+
+        uint32 th = 0;
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
+
+        if (!th)
+            return;
+
+        const uint32 tileRows = (region.y1 - region.y0 + th - 1) / th;
+
+        if (!parallel)
+        {
+            readContiguousTileRows(tif, img, region, 0, tileRows);
+            return;
+        }
+
+        //
+        //  The band handles find the directory by its offset so this
+        //  works for SubIFDs too
+        //
+
+        const size_t minBandTileRows = std::max(size_t(1), size_t(256 / th));
+        const toff_t dirOffset = TIFFCurrentDirOffset(tif);
+
+        TwkFB::ThreadPool::parallelFor(0, tileRows, minBandTileRows,
+                                       [&](size_t b, size_t e)
+                                       {
+#ifdef _MSC_VER
+                                           TIFF* btif = TIFFOpenW(UNICODE_C_STR(filename.c_str()), "r");
+#else
+                                           TIFF* btif = TIFFOpen(UNICODE_C_STR(filename.c_str()), "r");
+#endif
+                                           if (!btif)
+                                               return;
+
+                                           if (TIFFSetSubDirectory(btif, dirOffset))
+                                               readContiguousTileRows(btif, img, region, uint32(b), uint32(e));
+
+                                           TIFFClose(btif);
+                                       });
     }
 
-    static void readPlanarTiledImage(TIFF* tif, int w, int h, FrameBuffer& img)
+    static void readPlanarTiledImage(TIFF* tif, const TileRegion& region, FrameBuffer& img)
     {
         tsize_t rowsize = TIFFTileRowSize(tif);
         unsigned short orient = ORIENTATION_TOPLEFT;
@@ -1045,13 +1125,11 @@ namespace TwkFB
 
         if (unsigned char* buf = (unsigned char*)_TIFFmalloc(TIFFTileSize(tif)))
         {
-            uint32 tw, th, w, h;
+            uint32 tw, th;
             unsigned short d = DEFAULT_TIFFTAG_SAMPLESPERPIXEL_VALUE;
             unsigned short sampleFormat = DEFAULT_TIFFTAG_SAMPLEFORMAT_VALUE;
             unsigned short bitsPerSample = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
 
-            TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
-            TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
             TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
             TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
             TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &d);
@@ -1060,18 +1138,13 @@ namespace TwkFB
 
             FrameBuffer* fb = &img;
 
-            // These checks are to handle the case where the
-            // tile is larger than the image size.
-            //
-            uint32 copy_rowsize = ((w < tw) ? (w * rowsize / tw) : rowsize);
-
             for (uint32 plane = 0; plane < d && fb; plane++)
             {
                 fb->setOrientation(o);
 
-                for (uint32 row = 0; row < h; row += th)
+                for (uint32 row = region.y0; row < region.y1; row += th)
                 {
-                    for (uint32 col = 0; col < w; col += tw)
+                    for (uint32 col = region.x0; col < region.x1; col += tw)
                     {
                         if (TIFFReadTile(tif, buf, col, row, 0, plane) < 0)
                         {
@@ -1081,19 +1154,23 @@ namespace TwkFB
                         else
                         {
                             //
-                            //  Copy the tile row over to the fb
+                            //  Copy the tile row over to the fb. These
+                            //  checks are to handle the tiles which hang
+                            //  off the edge of the image.
                             //
 
-                            for (int y = 0; y < th && row + y < h; y++)
+                            const uint32 copy_rowsize = (region.x1 - col < tw) ? ((region.x1 - col) * rowsize / tw) : rowsize;
+
+                            for (int y = 0; y < th && row + y < region.y1; y++)
                             {
                                 if (sampleFormat == SAMPLEFORMAT_INT)
                                 {
                                     storeIntAsNormalizedFloatSamples(bitsPerSample, copy_rowsize, buf + y * rowsize,
-                                                                     &fb->pixel<float>(col, row + y));
+                                                                     &fb->pixel<float>(col - region.x0, row - region.y0 + y));
                                 }
                                 else
                                 {
-                                    unsigned char* s = &fb->pixel<unsigned char>(col, row + y);
+                                    unsigned char* s = &fb->pixel<unsigned char>(col - region.x0, row - region.y0 + y);
                                     memcpy(s, buf + y * rowsize, copy_rowsize);
                                 }
                             }
@@ -1108,6 +1185,223 @@ namespace TwkFB
         }
     }
 
+    //
+    //  Reads the strips or tiles of region raw, one after the other
+    //  through tif, and decodes them concurrently on the pool (see
+    //  TiffChunkDecoder.h). img has to be structured already. Returns
+    //  false if there aren't enough chunks, the compression or layout
+    //  isn't handled or a chunk can't be read or decoded: the serial
+    //  readers are used then.
+    //
+
+    static bool readChunksParallel(TIFF* tif, const TileRegion& region, FrameBuffer& img)
+    {
+        unsigned short compression = COMPRESSION_NONE;
+        unsigned short predictor = PREDICTOR_NONE;
+        unsigned short fillOrder = FILLORDER_MSB2LSB;
+        unsigned short config = PLANARCONFIG_CONTIG;
+        unsigned short samplesPerPixel = DEFAULT_TIFFTAG_SAMPLESPERPIXEL_VALUE;
+        unsigned short sampleFormat = DEFAULT_TIFFTAG_SAMPLEFORMAT_VALUE;
+        unsigned short bitsPerSample = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
+        unsigned short orient = ORIENTATION_TOPLEFT;
+        uint32 height = 0;
+
+        TIFFGetField(tif, TIFFTAG_COMPRESSION, &compression);
+        TIFFGetField(tif, TIFFTAG_PREDICTOR, &predictor);
+        TIFFGetField(tif, TIFFTAG_FILLORDER, &fillOrder);
+        TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &config);
+        TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+        TIFFGetField(tif, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
+        TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+        TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height);
+
+        const bool tiled = TIFFIsTiled(tif) != 0;
+        const bool separate = config == PLANARCONFIG_SEPARATE;
+
+        //
+        //  The signed samples are normalized to float on the way
+        //
+
+        if (sampleFormat == SAMPLEFORMAT_INT || fillOrder != FILLORDER_MSB2LSB || (tiled && !separate && samplesPerPixel > 4))
+        {
+            return false;
+        }
+
+        const TiffChunkFormat format = {compression, predictor, bitsPerSample, separate ? 1 : int(samplesPerPixel),
+                                        TIFFIsByteSwapped(tif) != 0};
+
+        if (!canDecodeTiffChunk(format))
+            return false;
+
+        uint32 tw = region.x1 - region.x0;
+        uint32 th = height;
+        size_t rowBytes;
+
+        if (tiled)
+        {
+            TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
+            TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
+            rowBytes = TIFFTileRowSize(tif);
+        }
+        else
+        {
+            TIFFGetField(tif, TIFFTAG_ROWSPERSTRIP, &th);
+            th = std::min(th, height);
+            rowBytes = TIFFScanlineSize(tif);
+        }
+
+        if (!tw || !th || !rowBytes)
+            return false;
+
+        struct Chunk
+        {
+            uint32 index;
+            int plane;
+            uint32 x;
+            uint32 y;
+            uint32 rows;
+            std::vector<unsigned char> data;
+        };
+
+        const int planes = separate ? samplesPerPixel : 1;
+        std::vector<Chunk> chunks;
+
+        for (int p = 0; p < planes; p++)
+        {
+            for (uint32 y = region.y0; y < region.y1; y += th)
+            {
+                for (uint32 x = region.x0; x < region.x1; x += tw)
+                {
+                    Chunk c;
+                    c.index = tiled ? TIFFComputeTile(tif, x, y, 0, p) : TIFFComputeStrip(tif, y, p);
+                    c.plane = p;
+                    c.x = x;
+                    c.y = y;
+                    c.rows = tiled ? th : std::min(th, height - y);
+                    chunks.push_back(c);
+                }
+            }
+        }
+
+        if (chunks.size() < 2)
+            return false;
+
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            Chunk& c = chunks[i];
+            const uint64_t size = TIFFGetStrileByteCount(tif, c.index);
+
+            if (!size)
+                return false;
+
+            c.data.resize(size);
+
+            const tmsize_t n =
+                tiled ? TIFFReadRawTile(tif, c.index, &c.data.front(), size) : TIFFReadRawStrip(tif, c.index, &c.data.front(), size);
+
+            if (n != tmsize_t(size))
+                return false;
+        }
+
+        //
+        //  Same orientations as the serial readers: scanline images
+        //  are read bottom up, tiled ones keep theirs
+        //
+
+        const bool flip = orient == ORIENTATION_TOPLEFT || orient == ORIENTATION_TOPRIGHT;
+        const bool flop = orient == ORIENTATION_TOPRIGHT || orient == ORIENTATION_BOTRIGHT;
+        const bool deinterleave = !tiled && !separate && img.isPlanar();
+
+        std::vector<FrameBuffer*> fbs;
+
+        for (FrameBuffer* fb = &img; fb; fb = fb->nextPlane())
+        {
+            fbs.push_back(fb);
+
+            if (tiled)
+            {
+                if (flip)
+                    fb->setOrientation(flop ? FrameBuffer::TOPRIGHT : FrameBuffer::TOPLEFT);
+                else
+                    fb->setOrientation(flop ? FrameBuffer::BOTTOMRIGHT : FrameBuffer::NATURAL);
+            }
+            else if (flop)
+            {
+                fb->setOrientation(FrameBuffer::BOTTOMRIGHT);
+            }
+        }
+
+        std::atomic<bool> ok(true);
+
+        TwkFB::ThreadPool::parallelFor(0, chunks.size(), 1,
+                                       [&](size_t b, size_t e)
+                                       {
+                                           std::vector<unsigned char> buf(rowBytes * th);
+
+                                           for (size_t i = b; i < e && ok; i++)
+                                           {
+                                               const Chunk& c = chunks[i];
+
+                                               if (c.plane >= int(fbs.size()))
+                                                   continue;
+
+                                               if (!decodeTiffChunk(format, &c.data.front(), c.data.size(), &buf.front(), rowBytes, c.rows))
+                                               {
+                                                   ok = false;
+                                                   break;
+                                               }
+
+                                               FrameBuffer* fb = fbs[c.plane];
+                                               const size_t copy = (region.x1 - c.x < tw) ? (region.x1 - c.x) * rowBytes / tw : rowBytes;
+
+                                               for (uint32 r = 0; r < c.rows && c.y + r < region.y1; r++)
+                                               {
+                                                   const unsigned char* src = &buf[r * rowBytes];
+                                                   const int y = int(c.y + r);
+
+                                                   if (tiled)
+                                                   {
+                                                       memcpy(&fb->pixel<unsigned char>(c.x - region.x0, y - region.y0), src, copy);
+                                                       continue;
+                                                   }
+
+                                                   const int flipY = flip ? int(height) - y - 1 : y;
+
+                                                   if (!deinterleave)
+                                                   {
+                                                       memcpy(&fb->pixel<unsigned char>(0, flipY), src, rowBytes);
+                                                       continue;
+                                                   }
+
+                                                   const int w = region.x1 - region.x0;
+
+                                                   for (int p = 0; p < int(fbs.size()) && p < samplesPerPixel; p++)
+                                                   {
+                                                       switch (bitsPerSample)
+                                                       {
+                                                       case 8:
+                                                           copyScanlineSamples(src + p, &fbs[p]->pixel<unsigned char>(0, flipY), w, 1,
+                                                                               samplesPerPixel - 1);
+                                                           break;
+                                                       case 16:
+                                                           copyScanlineSamples((const unsigned short*)src + p,
+                                                                               &fbs[p]->pixel<unsigned short>(0, flipY), w, 1,
+                                                                               samplesPerPixel - 1);
+                                                           break;
+                                                       case 32:
+                                                           copyScanlineSamples((const float*)src + p, &fbs[p]->pixel<float>(0, flipY), w, 1,
+                                                                               samplesPerPixel - 1);
+                                                           break;
+                                                       }
+                                                   }
+                                               }
+                                           }
+                                       });
+
+        return ok;
+    }
+
     void IOtiff::getImageInfo(const std::string& filename, FBInfo& fbi) const
     {
 #ifdef _MSC_VER
@@ -1327,6 +1621,131 @@ namespace TwkFB
         return toff_t(stream->stream.size());
     }
 
+    //
+    //  An uncompressed scanline image in native byte order whose strips
+    //  follow each other in a memory mapped file is used in place: the
+    //  fb points at the first strip and keeps the mapping. Returns false
+    //  if the stream or the layout don't allow it.
+    //
+
+    static bool readMappedScanlineImage(TIFF* tif, StreamData* stream, int w, int h, int nchannels, FrameBuffer::DataType type,
+                                        int bitsPerSample, FrameBuffer& fb)
+    {
+        unsigned short compression = COMPRESSION_NONE;
+        unsigned short orient = ORIENTATION_TOPLEFT;
+        TIFFGetField(tif, TIFFTAG_COMPRESSION, &compression);
+        TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
+
+        const size_t bytesPerChannel = bitsPerSample / 8;
+
+        if (!stream || compression != COMPRESSION_NONE || (orient != ORIENTATION_TOPLEFT && orient != ORIENTATION_BOTLEFT)
+            || bitsPerSample % 8 || !bytesPerChannel || (bytesPerChannel > 1 && TIFFIsByteSwapped(tif)))
+        {
+            return false;
+        }
+
+        const tsize_t rowSize = TIFFScanlineSize(tif);
+        toff_t* offsets = 0;
+        toff_t* counts = 0;
+
+        if (rowSize != tsize_t(w * nchannels * bytesPerChannel) || !TIFFGetField(tif, TIFFTAG_STRIPOFFSETS, &offsets)
+            || !TIFFGetField(tif, TIFFTAG_STRIPBYTECOUNTS, &counts))
+        {
+            return false;
+        }
+
+        toff_t end = offsets[0];
+
+        for (tstrip_t i = 0, n = TIFFNumberOfStrips(tif); i < n; i++)
+        {
+            if (offsets[i] != end)
+                return false;
+            end += counts[i];
+        }
+
+        unsigned char* data = (unsigned char*)stream->stream.data() + offsets[0];
+
+        if (end - offsets[0] < toff_t(rowSize) * h || end > toff_t(stream->stream.size()) || size_t(data) % bytesPerChannel)
+        {
+            return false;
+        }
+
+        FrameBuffer::DataOwnerPtr mapping = StreamingFrameBufferIO::adoptMemoryMap(stream->stream);
+
+        if (!mapping)
+            return false;
+
+        fb.restructure(w, h, 0, nchannels, type, data, 0, orient == ORIENTATION_TOPLEFT ? FrameBuffer::TOPLEFT : FrameBuffer::BOTTOMLEFT,
+                       false);
+        fb.setDataOwner(mapping);
+        return true;
+    }
+
+    //
+    //  Makes the smallest reduced resolution version of the current
+    //  image at least resolution times its width the current one.
+    //  These are either SubIFDs of the image or the directories which
+    //  follow it flagged FILETYPE_REDUCEDIMAGE (pyramid TIFFs). Returns
+    //  false and leaves the directory alone if there isn't one.
+    //
+
+    static bool setReducedResolutionDirectory(TIFF* tif, float resolution)
+    {
+        uint32 fullWidth = 0;
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &fullWidth);
+
+        const toff_t fullOffset = TIFFCurrentDirOffset(tif);
+        const double minWidth = double(fullWidth) * resolution;
+        uint32 bestWidth = fullWidth;
+        toff_t bestOffset = fullOffset;
+
+        vector<toff_t> candidates;
+        uint16 numSubIFDs = 0;
+        toff_t* subIFDs = 0;
+
+        if (TIFFGetField(tif, TIFFTAG_SUBIFD, &numSubIFDs, &subIFDs))
+        {
+            candidates.assign(subIFDs, subIFDs + numSubIFDs);
+        }
+
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            uint32 subfileType = 0;
+            uint32 w = 0;
+
+            if (TIFFSetSubDirectory(tif, candidates[i]) && TIFFGetField(tif, TIFFTAG_SUBFILETYPE, &subfileType)
+                && (subfileType & FILETYPE_REDUCEDIMAGE) && TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w) && w >= minWidth && w < bestWidth)
+            {
+                bestWidth = w;
+                bestOffset = candidates[i];
+            }
+        }
+
+        //
+        //  The next full resolution directory is another page
+        //
+
+        TIFFSetSubDirectory(tif, fullOffset);
+
+        while (TIFFReadDirectory(tif))
+        {
+            uint32 subfileType = 0;
+            uint32 w = 0;
+
+            if (!TIFFGetField(tif, TIFFTAG_SUBFILETYPE, &subfileType) || !(subfileType & FILETYPE_REDUCEDIMAGE))
+                break;
+
+            if (TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w) && w >= minWidth && w < bestWidth)
+            {
+                bestWidth = w;
+                bestOffset = TIFFCurrentDirOffset(tif);
+            }
+        }
+
+        TIFFSetSubDirectory(tif, bestOffset);
+        return bestOffset != fullOffset;
+    }
+
     void IOtiff::readImage(FrameBuffer& fb, const std::string& filename, const ReadRequest& request) const
     {
         TIFF* tif = NULL;
@@ -1355,6 +1774,18 @@ namespace TwkFB
                 TWK_THROW_STREAM(Exception, "TIFF: cannot open \"" << filename << "\"");
             }
 
+            //
+            //  The full size is needed to place a region read from a
+            //  reduced resolution directory
+            //
+
+            int fullWidth = 0;
+            int fullHeight = 0;
+            TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &fullWidth);
+            TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &fullHeight);
+
+            const bool reduced = request.hasResolution() && setReducedResolutionDirectory(tif, request.resolution);
+
             int width;
             int height;
             unsigned short bitsPerSample = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
@@ -1453,7 +1884,52 @@ namespace TwkFB
                 TWK_THROW_STREAM(UnsupportedException, "TIFF: Unsupported bit depth (" << bitsPerSample << ") trying to read " << filename);
             }
 
-            if (config == PLANARCONFIG_SEPARATE)
+            //
+            //  Only the tiles holding a region are read (top left
+            //  orientation only, otherwise the whole image is)
+            //
+
+            TileRegion region = {0, 0, uint32(width), uint32(height)};
+            unsigned short orient = ORIENTATION_TOPLEFT;
+            TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
+
+            const bool regionRead = request.hasRegion() && TIFFIsTiled(tif) && !readAsRGBA && orient == ORIENTATION_TOPLEFT;
+
+            if (regionRead)
+            {
+                uint32 tw = 1, th = 1;
+                TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
+                TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
+
+                const double sx = double(width) / double(fullWidth);
+                const double sy = double(height) / double(fullHeight);
+                const uint32 x0 = uint32(std::max(0.0, std::min(double(width - 1), std::floor(request.x0 * sx))));
+                const uint32 y0 = uint32(std::max(0.0, std::min(double(height - 1), std::floor(request.y0 * sy))));
+                const uint32 x1 = uint32(std::max(double(x0 + 1), std::min(double(width), std::ceil(request.x1 * sx))));
+                const uint32 y1 = uint32(std::max(double(y0 + 1), std::min(double(height), std::ceil(request.y1 * sy))));
+
+                region.x0 = x0 / tw * tw;
+                region.y0 = y0 / th * th;
+                region.x1 = std::min(uint32(width), (x1 + tw - 1) / tw * tw);
+                region.y1 = std::min(uint32(height), (y1 + th - 1) / th * th);
+            }
+
+            const int fbWidth = region.x1 - region.x0;
+            const int fbHeight = region.y1 - region.y0;
+
+            const bool mapped = !readAsRGBA && !TIFFIsTiled(tif) && config == PLANARCONFIG_CONTIG && sampleFormat != SAMPLEFORMAT_INT
+                                && (samplesPerPixel == 1 || (dataType != FrameBuffer::USHORT && samplesPerPixel <= 4))
+                                && readMappedScanlineImage(tif, stream, width, height, samplesPerPixel, dataType, bitsPerSample, fb);
+
+            //
+            //  Interleaved 16 bit scanline images of more than one
+            //  channel are read into planes
+            //
+
+            const bool asPlanar = !readAsRGBA && !TIFFIsTiled(tif) && config == PLANARCONFIG_CONTIG
+                                  && !(samplesPerPixel == 1 || (dataType != FrameBuffer::USHORT && samplesPerPixel <= 4));
+
+            if (config == PLANARCONFIG_SEPARATE || asPlanar)
             {
                 const char* chanNames[] = {"R", "G", "B", "A", "Z", "X", "Y", "P", "D", "Q"};
 
@@ -1464,17 +1940,28 @@ namespace TwkFB
                     planeNames.push_back(string(chanNames[i]));
                 }
 
-                fb.restructurePlanar(width, height, planeNames, dataType, FrameBuffer::NATURAL);
+                fb.restructurePlanar(fbWidth, fbHeight, planeNames, dataType, FrameBuffer::NATURAL);
             }
-            else
+            else if (!mapped)
             {
-                fb.restructure(width, height, 0, min((int)samplesPerPixel, 4),
+                fb.restructure(fbWidth, fbHeight, 0, min((int)samplesPerPixel, 4),
                                dataType); // interleaved, we can only do 4 channels
             }
 
             string message = "Reading TIFF " + stl_ext::basename(filename);
 
-            if (readAsRGBA)
+            //
+            //  The display frame's strips or tiles are decoded
+            //  concurrently if the compression allows it
+            //
+
+            const bool chunked = m_parallelChunks && request.parallelDecode && TwkFB::ThreadPool::getNumThreads() > 0;
+
+            if (mapped)
+            {
+                fb.newAttribute("TIFF/PlanarConfig", string("Contiguous Mapped"));
+            }
+            else if (readAsRGBA)
             {
                 uint32* p = fb.begin<uint32>();
                 const uint32* e = fb.end<uint32>();
@@ -1489,16 +1976,31 @@ namespace TwkFB
                 }
 #endif
             }
+            else if (chunked && readChunksParallel(tif, region, fb))
+            {
+                fb.newAttribute("TIFF/PlanarConfig",
+                                string(TIFFIsTiled(tif) ? "Tiled " : "") + (config == PLANARCONFIG_CONTIG ? "Contiguous" : "Separate"));
+            }
             else if (TIFFIsTiled(tif))
             {
                 if (config == PLANARCONFIG_CONTIG)
                 {
-                    readContiguousTiledImage(tif, width, height, fb);
+                    //
+                    //  The display frame gets decoded with all the pool
+                    //  threads. (Non-standard I/O streams the whole file
+                    //  into memory per handle so it isn't worth it.)
+                    //
+
+                    const bool parallel =
+                        request.parallelDecode && m_iotype == StandardIO && TwkFB::ThreadPool::getNumThreads() > 0;
+
+                    readContiguousTiledImage(tif, region, fb, parallel, filename);
+
                     fb.newAttribute("TIFF/PlanarConfig", string("Tiled Contiguous"));
                 }
                 else
                 {
-                    readPlanarTiledImage(tif, width, height, fb);
+                    readPlanarTiledImage(tif, region, fb);
                     fb.newAttribute("TIFF/PlanarConfig", string("Tiled Separate"));
                 }
             }
@@ -1512,19 +2014,6 @@ namespace TwkFB
                     }
                     else
                     {
-                        const char* chanNames[] = {"R", "G", "B", "A", "Z", "X", "Y", "P", "D", "Q"};
-
-                        if (!fb.isPlanar())
-                        {
-                            StringVector planeNames;
-
-                            for (int i = 0; i < samplesPerPixel && i < 10; i++)
-                            {
-                                planeNames.push_back(string(chanNames[i]));
-                            }
-
-                            fb.restructurePlanar(width, height, planeNames, dataType, FrameBuffer::NATURAL);
-                        }
                         readContiguousScanlineImageAsPlanar(tif, width, height, fb);
                     }
 
@@ -1639,6 +2128,12 @@ namespace TwkFB
                 fb.copyFrom(fbv[0]);
                 delete fbv[0];
             }
+
+            if (reduced)
+                fb.newAttribute("TIFF/ReducedResolution", float(width) / float(fullWidth));
+
+            if (regionRead)
+                fb.setUncrop(width, height, region.x0, region.y0);
         }
         catch (...)
         {
@@ -35,6 +35,7 @@ namespace TwkFB
     private:
         bool m_addAlphaTo3Channel;
         bool m_rgbPlanar;
+        bool m_parallelChunks;
     };
 
 } // namespace TwkFB
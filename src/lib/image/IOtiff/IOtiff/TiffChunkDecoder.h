@@ -0,0 +1,47 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IOtiff__TiffChunkDecoder__h__
+#define __IOtiff__TiffChunkDecoder__h__
+#include <stddef.h>
+
+namespace TwkFB
+{
+
+    //
+    //  Decodes the data of a strip or tile as read by TIFFReadRawStrip()
+    //  or TIFFReadRawTile() without going through libtiff, so the
+    //  chunks of an image can be decoded concurrently. Handles no
+    //  compression, LZW, deflate and PackBits with no, horizontal or
+    //  floating point prediction of 8, 16 and 32 bit samples. The
+    //  results are the same as libtiff's (native byte order).
+    //
+    //  samplesPerPixel is per pixel of the chunk: 1 for separate
+    //  planes. byteSwapped is true if the file byte order is not the
+    //  native one.
+    //
+
+    struct TiffChunkFormat
+    {
+        unsigned short compression;
+        unsigned short predictor;
+        int bitsPerSample;
+        int samplesPerPixel;
+        bool byteSwapped;
+    };
+
+    bool canDecodeTiffChunk(const TiffChunkFormat& format);
+
+    //
+    //  Decodes rows rows of rowBytes into out. Returns false if the
+    //  data is short or corrupt or is old style (pre libtiff 5) LZW.
+    //
+
+    bool decodeTiffChunk(const TiffChunkFormat& format, const unsigned char* in, size_t inSize, unsigned char* out, size_t rowBytes,
+                         size_t rows);
+
+} // namespace TwkFB
+
+#endif // __IOtiff__TiffChunkDecoder__h__
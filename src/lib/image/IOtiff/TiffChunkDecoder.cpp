@@ -0,0 +1,336 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IOtiff/TiffChunkDecoder.h>
+
+#include <tiff.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+namespace TwkFB
+{
+    namespace
+    {
+
+        //
+        //  libtiff's LZW: codes are read most significant bit first,
+        //  9 to 12 bits wide, and get wider one code early.
+        //
+
+        bool decodeLZW(const unsigned char* in, size_t inSize, unsigned char* out, size_t outSize)
+        {
+            if (inSize >= 2 && in[0] == 0 && (in[1] & 0x1))
+                return false;
+
+            const unsigned int clearCode = 256;
+            const unsigned int eoiCode = 257;
+            const unsigned int firstFree = 258;
+            const unsigned int maxCodes = 4096;
+
+            unsigned short prefix[maxCodes];
+            unsigned short length[maxCodes];
+            unsigned char suffix[maxCodes];
+            unsigned char first[maxCodes];
+
+            for (unsigned int i = 0; i < 256; i++)
+            {
+                prefix[i] = 0;
+                length[i] = 1;
+                suffix[i] = (unsigned char)i;
+                first[i] = (unsigned char)i;
+            }
+
+            const size_t totalBits = inSize * 8;
+            size_t bitPos = 0;
+            size_t pos = 0;
+            unsigned int width = 9;
+            unsigned int nextCode = firstFree;
+            int oldCode = -1;
+
+            while (pos < outSize && bitPos + width <= totalBits)
+            {
+                const size_t byte = bitPos >> 3;
+                const unsigned int word = (unsigned int)(in[byte]) << 16 | (byte + 1 < inSize ? (unsigned int)(in[byte + 1]) << 8 : 0)
+                                          | (byte + 2 < inSize ? (unsigned int)(in[byte + 2]) : 0);
+                const unsigned int code = (word >> (24 - (bitPos & 7) - width)) & ((1u << width) - 1);
+
+                bitPos += width;
+
+                if (code == eoiCode)
+                    break;
+
+                if (code == clearCode)
+                {
+                    width = 9;
+                    nextCode = firstFree;
+                    oldCode = -1;
+                    continue;
+                }
+
+                if (oldCode < 0)
+                {
+                    if (code >= 256)
+                        return false;
+
+                    out[pos++] = (unsigned char)code;
+                    oldCode = code;
+                    continue;
+                }
+
+                if (code > nextCode || (code >= 256 && code < firstFree))
+                    return false;
+
+                if (nextCode < maxCodes)
+                {
+                    prefix[nextCode] = (unsigned short)oldCode;
+                    suffix[nextCode] = code < nextCode ? first[code] : first[oldCode];
+                    first[nextCode] = first[oldCode];
+                    length[nextCode] = length[oldCode] + 1;
+                    nextCode++;
+
+                    if (nextCode >= (1u << width) - 1 && width < 12)
+                        width++;
+                }
+                else if (code == nextCode)
+                {
+                    return false;
+                }
+
+                //
+                //  The string is written back to front, dropping what
+                //  doesn't fit
+                //
+
+                const size_t n = std::min(size_t(length[code]), outSize - pos);
+                unsigned int c = code;
+
+                for (size_t i = length[code]; i > n; i--)
+                    c = prefix[c];
+
+                for (size_t i = n; i > 0; i--)
+                {
+                    out[pos + i - 1] = suffix[c];
+                    c = prefix[c];
+                }
+
+                pos += n;
+                oldCode = code;
+            }
+
+            return pos == outSize;
+        }
+
+        bool decodeDeflate(const unsigned char* in, size_t inSize, unsigned char* out, size_t outSize)
+        {
+            z_stream z;
+            memset(&z, 0, sizeof(z));
+
+            if (inflateInit(&z) != Z_OK)
+                return false;
+
+            z.next_in = const_cast<Bytef*>(in);
+            z.avail_in = uInt(inSize);
+            z.next_out = out;
+            z.avail_out = uInt(outSize);
+
+            //
+            //  A full buffer is fine even if the stream goes on
+            //
+
+            inflate(&z, Z_FINISH);
+            const bool ok = z.total_out == outSize;
+            inflateEnd(&z);
+
+            return ok;
+        }
+
+        bool decodePackBits(const unsigned char* in, size_t inSize, unsigned char* out, size_t outSize)
+        {
+            size_t i = 0;
+            size_t pos = 0;
+
+            while (pos < outSize && i < inSize)
+            {
+                const int n = (signed char)in[i++];
+
+                if (n >= 0)
+                {
+                    if (i + n + 1 > inSize)
+                        return false;
+
+                    const size_t count = std::min(size_t(n + 1), outSize - pos);
+                    memcpy(out + pos, in + i, count);
+                    i += n + 1;
+                    pos += count;
+                }
+                else if (n != -128)
+                {
+                    if (i >= inSize)
+                        return false;
+
+                    const size_t count = std::min(size_t(1 - n), outSize - pos);
+                    memset(out + pos, in[i++], count);
+                    pos += count;
+                }
+            }
+
+            return pos == outSize;
+        }
+
+        void swapBytes(unsigned char* p, size_t size, size_t bytes)
+        {
+            for (unsigned char* e = p + size - size % bytes; p < e; p += bytes)
+            {
+                std::reverse(p, p + bytes);
+            }
+        }
+
+        template <typename T> void accumulate(unsigned char* row, size_t rowBytes, size_t stride)
+        {
+            T* p = reinterpret_cast<T*>(row);
+            const size_t n = rowBytes / sizeof(T);
+
+            for (size_t i = stride; i < n; i++)
+            {
+                p[i] = T(p[i] + p[i - stride]);
+            }
+        }
+
+        //
+        //  The floating point predictor differences the bytes and
+        //  stores each value's bytes in planes, most significant first
+        //
+
+        void floatingPointAccumulate(unsigned char* row, size_t rowBytes, size_t stride, size_t bytes, std::vector<unsigned char>& tmp)
+        {
+            accumulate<unsigned char>(row, rowBytes, stride);
+
+            const size_t n = rowBytes / bytes;
+            tmp.assign(row, row + rowBytes);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t b = 0; b < bytes; b++)
+                {
+#ifdef __BIG_ENDIAN__
+                    row[i * bytes + b] = tmp[b * n + i];
+#else
+                    row[i * bytes + b] = tmp[(bytes - b - 1) * n + i];
+#endif
+                }
+            }
+        }
+
+    } // namespace
+
+    bool canDecodeTiffChunk(const TiffChunkFormat& format)
+    {
+        switch (format.compression)
+        {
+        case COMPRESSION_NONE:
+        case COMPRESSION_LZW:
+        case COMPRESSION_ADOBE_DEFLATE:
+        case COMPRESSION_DEFLATE:
+        case COMPRESSION_PACKBITS:
+            break;
+        default:
+            return false;
+        }
+
+        if (format.bitsPerSample != 8 && format.bitsPerSample != 16 && format.bitsPerSample != 32)
+            return false;
+
+        if (format.predictor == PREDICTOR_FLOATINGPOINT && format.bitsPerSample == 8)
+            return false;
+
+        return format.samplesPerPixel > 0
+               && (format.predictor == PREDICTOR_NONE || format.predictor == PREDICTOR_HORIZONTAL
+                   || format.predictor == PREDICTOR_FLOATINGPOINT);
+    }
+
+    bool decodeTiffChunk(const TiffChunkFormat& format, const unsigned char* in, size_t inSize, unsigned char* out, size_t rowBytes,
+                         size_t rows)
+    {
+        const size_t outSize = rowBytes * rows;
+        bool predicted = false;
+        bool ok = false;
+
+        switch (format.compression)
+        {
+        case COMPRESSION_NONE:
+            ok = inSize >= outSize;
+            if (ok)
+                memcpy(out, in, outSize);
+            break;
+        case COMPRESSION_LZW:
+            ok = decodeLZW(in, inSize, out, outSize);
+            predicted = true;
+            break;
+        case COMPRESSION_ADOBE_DEFLATE:
+        case COMPRESSION_DEFLATE:
+            ok = decodeDeflate(in, inSize, out, outSize);
+            predicted = true;
+            break;
+        case COMPRESSION_PACKBITS:
+            ok = decodePackBits(in, inSize, out, outSize);
+            break;
+        default:
+            break;
+        }
+
+        if (!ok)
+            return false;
+
+        //
+        //  Only the LZW and deflate codecs use the predictor tag. The
+        //  floating point predictor's bytes are in a fixed order.
+        //
+
+        const unsigned short predictor = predicted ? format.predictor : (unsigned short)PREDICTOR_NONE;
+        const size_t bytes = format.bitsPerSample / 8;
+        const size_t stride = format.samplesPerPixel;
+
+        if (format.byteSwapped && bytes > 1 && predictor != PREDICTOR_FLOATINGPOINT)
+        {
+            swapBytes(out, outSize, bytes);
+        }
+
+        if (predictor == PREDICTOR_HORIZONTAL)
+        {
+            for (size_t r = 0; r < rows; r++)
+            {
+                unsigned char* row = out + r * rowBytes;
+
+                switch (bytes)
+                {
+                case 1:
+                    accumulate<unsigned char>(row, rowBytes, stride);
+                    break;
+                case 2:
+                    accumulate<unsigned short>(row, rowBytes, stride);
+                    break;
+                case 4:
+                    accumulate<unsigned int>(row, rowBytes, stride);
+                    break;
+                }
+            }
+        }
+        else if (predictor == PREDICTOR_FLOATINGPOINT)
+        {
+            std::vector<unsigned char> tmp;
+
+            for (size_t r = 0; r < rows; r++)
+            {
+                floatingPointAccumulate(out + r * rowBytes, rowBytes, stride, bytes, tmp);
+            }
+        }
+
+        return true;
+    }
+
+} // namespace TwkFB
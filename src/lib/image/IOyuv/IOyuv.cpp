@@ -7,6 +7,7 @@
 #include <TwkFB/Operations.h>
 #include <TwkUtil/ByteSwap.h>
 #include <TwkUtil/File.h>
+#include <TwkUtil/FileStream.h>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
@@ -22,7 +23,7 @@ namespace TwkFB
     using namespace std;
 
     IOyuv::IOyuv()
-        : FrameBufferIO("IOyuv", "mx")
+        : StreamingFrameBufferIO("IOyuv", "mx")
     {
         //
         //  Indicate which extensions this plugin will handle The
@@ -116,6 +117,26 @@ namespace TwkFB
 
         imageDimensions(filesize, width, height);
 
+        if (m_iotype == MemoryMappedIO)
+        {
+            //
+            //  The file is 2vuy so the renderer can take it as is
+            //
+
+            TwkUtil::FileStream fstream(filename, TwkUtil::FileStream::MemoryMap);
+            FrameBuffer::DataOwnerPtr mapping = adoptMemoryMap(fstream);
+
+            if (mapping)
+            {
+                fb.restructure(width, height, 0, 1, FrameBuffer::PACKED_Cb8_Y8_Cr8_Y8, (unsigned char*)fstream.data(), 0,
+                               FrameBuffer::TOPLEFT, false);
+                fb.setDataOwner(mapping);
+                fb.setPrimaryColorSpace(ColorSpace::Rec601());
+                fb.setConversion(ColorSpace::Rec601());
+                return;
+            }
+        }
+
         FrameBuffer::StringVector channels(3);
         channels[0] = "Y";
         channels[1] = "U";
@@ -8,13 +8,19 @@
 #define __YUVPLUGIN_H__
 
 #include <TwkFB/FrameBuffer.h>
-#include <TwkFB/IO.h>
+#include <TwkFB/StreamingIO.h>
 #include <stdio.h>
 
 namespace TwkFB
 {
 
-    class IOyuv : public FrameBufferIO
+    //
+    //  With MemoryMappedIO the image is a single PACKED_Cb8_Y8_Cr8_Y8
+    //  plane pointing into the mapped file instead of Y, U and V
+    //  planes filled from it.
+    //
+
+    class IOyuv : public StreamingFrameBufferIO
     {
     public:
         IOyuv();
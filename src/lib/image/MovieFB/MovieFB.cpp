@@ -9,9 +9,11 @@
 #include <MovieFB/MovieFBWriter.h>
 #include <TwkFB/IO.h>
 #include <TwkFB/Exception.h>
+#include <TwkFB/StreamingIO.h>
 #include <TwkMovie/MovieIO.h>
 #include <TwkMovie/Movie.h>
 #include <TwkUtil/File.h>
+#include <TwkUtil/FileStream.h>
 #include <TwkUtil/FrameUtils.h>
 #include <TwkUtil/PathConform.h>
 #include <boost/filesystem/operations.hpp>
@@ -57,17 +59,68 @@ namespace TwkMovie
 
     int MovieFBIO::m_readerCount = 0;
 
+    //
+    //  Reads a batch of frame files into the FileStream read ahead on
+    //  the decode pool so the caching thread can go on decoding the
+    //  frames it already has.
+    //
+
+    class ReadAheadTask : public ILMTHREAD_NAMESPACE::Task
+    {
+    public:
+        ReadAheadTask(ILMTHREAD_NAMESPACE::TaskGroup* group, const vector<string>& files, size_t chunkSize, int maxInFlight)
+            : ILMTHREAD_NAMESPACE::Task(group)
+            , m_files(files)
+            , m_chunkSize(chunkSize)
+            , m_maxInFlight(maxInFlight)
+        {
+        }
+
+        virtual void execute()
+        {
+            try
+            {
+                FileStream::readAhead(m_files, m_chunkSize, m_maxInFlight);
+            }
+            catch (...)
+            {
+                //
+                //  The frames are read again when they're needed
+                //
+            }
+        }
+
+    private:
+        vector<string> m_files;
+        size_t m_chunkSize;
+        int m_maxInFlight;
+    };
+
     MovieFB::MovieFB()
         : MovieReader()
         , m_frameInfoValid(false)
         , m_imgio(0)
+        , m_fromIndex(false)
+        , m_readAheadBegin(0)
+        , m_readAheadEnd(0)
+        , m_readAheadTasks(new ILMTHREAD_NAMESPACE::TaskGroup())
     {
         pthread_mutex_init(&m_frameLock, 0);
+        pthread_mutex_init(&m_indexLock, 0);
 
         m_threadSafe = true;
     }
 
-    MovieFB::~MovieFB() { pthread_mutex_destroy(&m_frameLock); }
+    MovieFB::~MovieFB()
+    {
+        //
+        //  Waits for the read ahead still in flight
+        //
+
+        delete m_readAheadTasks;
+        pthread_mutex_destroy(&m_frameLock);
+        pthread_mutex_destroy(&m_indexLock);
+    }
 
     Movie* MovieFB::clone() const
     {
@@ -143,6 +196,17 @@ namespace TwkMovie
         m_info = info;
         m_filehash = stl_ext::hash(m_filename);
 
+        if (!openFromIndex())
+            readMediaInfo();
+    }
+
+    //
+    //  Scans the frames and reads the headers, then stores what was
+    //  found in the index
+    //
+
+    void MovieFB::readMediaInfo()
+    {
         updateFrameInfo();
 
         //
@@ -350,6 +414,148 @@ namespace TwkMovie
         //  Allow fps==0.0 to pass through if there was no appropriate
         //  attribute; it'll pick up the session default fps later.
         //
+
+        storeInIndex(existingFiles, successFrame);
+    }
+
+    //
+    //  A hit leaves the media alone until imagesAtFrame() validates the
+    //  entry. Only the ends of m_frames are used once the frame map is
+    //  built so they are all that's restored of it.
+    //
+
+    bool MovieFB::openFromIndex()
+    {
+        MediaInfoIndex::Entry entry;
+
+        if (!MediaInfoIndex::find(m_imagePattern, entry) || entry.frames.empty())
+            return false;
+
+        const FrameBufferIO* imgio = 0;
+        const TwkFB::GenericIO::Plugins& plugins = TwkFB::GenericIO::allPlugins();
+
+        for (TwkFB::GenericIO::Plugins::const_iterator i = plugins.begin(); i != plugins.end() && !imgio; ++i)
+        {
+            if ((*i)->identifier() == entry.plugin)
+                imgio = *i;
+        }
+
+        if (!imgio)
+            return false;
+
+        pthread_mutex_lock(&m_frameLock);
+
+        m_frameMap.clear();
+
+        for (size_t i = 0; i < entry.frames.size(); i++)
+        {
+            m_frameMap[entry.frames[i]] = FrameFile(entry.files[i]);
+        }
+
+        m_frames.clear();
+        m_frames.push_back(entry.info.start);
+        if (entry.info.end != entry.info.start)
+            m_frames.push_back(entry.info.end);
+
+        m_indexStamps = entry.stamps;
+        m_fromIndex = true;
+        m_frameInfoValid = true;
+
+        pthread_mutex_unlock(&m_frameLock);
+
+        m_imgio = imgio;
+        m_imgInfo = entry.info;
+        m_info = entry.info;
+
+        return true;
+    }
+
+    //
+    //  The entry is stamped with the directory of a sequence (frames
+    //  coming and going change it) and the files whose headers were
+    //  read.
+    //
+
+    void MovieFB::storeInIndex(const ExistingFileList& files, int infoFrame)
+    {
+        if (!MediaInfoIndex::enabled() || !m_imgio || infoFrame < 0)
+            return;
+
+        MediaInfoIndex::Entry entry;
+        entry.path = m_imagePattern;
+        entry.plugin = m_imgio->identifier();
+        entry.info = m_info;
+        entry.info.privateData = 0;
+
+        const string& infoFile = files[infoFrame].name;
+
+        if (files.size() > 1 || infoFile != m_imagePattern)
+        {
+            string dir = dirname(infoFile);
+            if (!MediaInfoIndex::addStamp(dir.empty() ? string("/") : dir, entry.stamps))
+                return;
+        }
+
+        if (!MediaInfoIndex::addStamp(infoFile, entry.stamps))
+            return;
+
+        if (infoFrame != 0 && files[0].exists && !MediaInfoIndex::addStamp(files[0].name, entry.stamps))
+            return;
+
+        pthread_mutex_lock(&m_frameLock);
+
+        for (FrameMap::const_iterator i = m_frameMap.begin(); i != m_frameMap.end(); ++i)
+        {
+            entry.frames.push_back(i->first);
+            entry.files.push_back(i->second.fileName);
+        }
+
+        pthread_mutex_unlock(&m_frameLock);
+
+        MediaInfoIndex::store(entry);
+    }
+
+    bool MovieFB::indexEntryUnchecked() const
+    {
+        pthread_mutex_lock(&m_frameLock);
+        const bool unchecked = m_fromIndex;
+        pthread_mutex_unlock(&m_frameLock);
+        return unchecked;
+    }
+
+    //
+    //  A stale entry is read again from the media, which replaces
+    //  m_info and the frame map and stores a new entry. Other readers
+    //  wait on m_indexLock until that's done and m_fromIndex is
+    //  cleared.
+    //
+
+    void MovieFB::validateIndexEntry()
+    {
+        pthread_mutex_lock(&m_indexLock);
+
+        try
+        {
+            if (indexEntryUnchecked() && !MediaInfoIndex::validate(m_imagePattern, m_indexStamps))
+            {
+                cout << "INFO: " << m_imagePattern << " changed since it was indexed, re-reading it" << endl;
+                invalidateFileSystemInfo();
+                readMediaInfo();
+            }
+        }
+        catch (...)
+        {
+            pthread_mutex_lock(&m_frameLock);
+            m_fromIndex = false;
+            pthread_mutex_unlock(&m_frameLock);
+            pthread_mutex_unlock(&m_indexLock);
+            throw;
+        }
+
+        pthread_mutex_lock(&m_frameLock);
+        m_fromIndex = false;
+        pthread_mutex_unlock(&m_frameLock);
+        pthread_mutex_unlock(&m_indexLock);
     }
 
     bool MovieFB::fileAndIdAtFrame(int& frame, string& filename, ostream& idstream, bool nearby)
@@ -407,6 +613,9 @@ namespace TwkMovie
 
     void MovieFB::imagesAtFrame(const ReadRequest& mrequest, FrameBufferVector& fbs)
     {
+        if (indexEntryUnchecked())
+            validateIndexEntry();
+
         updateFrameInfo();
 
         int frame = mrequest.frame;
@@ -417,6 +626,13 @@ namespace TwkMovie
         request.layers = mrequest.layers;
         request.channels = mrequest.channels;
         request.parameters = mrequest.parameters;
+        request.parallelDecode = mrequest.parallelDecode;
+        request.resolution = mrequest.resolution;
+        request.x0 = mrequest.x0;
+        request.y0 = mrequest.y0;
+        request.x1 = mrequest.x1;
+        request.y1 = mrequest.y1;
+        request.consumedChannels = mrequest.consumedChannels;
 
         //
         //  May throw (which is fine). If the image is missing and it
@@ -436,6 +652,16 @@ namespace TwkMovie
 
         m_imgio->readImages(fbs, filename, request);
 
+        //
+        //  The caching threads (not the frame on screen) read the files
+        //  of the next frames in one io_uring batch
+        //
+
+        if (found && !mrequest.parallelDecode && m_imgio->getIntAttribute("iotype") == StreamingFrameBufferIO::IOUringIO)
+        {
+            readAhead(frame);
+        }
+
         //  We read something, and didn't throw, so update readtime.  Note that
         //  "frame" may now be other than request.frame, since we may have
         //  encountered a missing frame.
@@ -471,6 +697,13 @@ namespace TwkMovie
                 fb->idstream() << ":" << fb->attribute<string>("Channel");
             }
 
+            //
+            //  Has to match identifiersAtFrame() whether or not the
+            //  reader could read a subset
+            //
+
+            fb->idstream() << request.subsetIdentifier();
+
             if (FBAttribute* a = fb->findAttribute("File"))
             {
                 fb->deleteAttribute(a);
@@ -486,6 +719,43 @@ namespace TwkMovie
         }
     }
 
+    void MovieFB::readAhead(int frame)
+    {
+        const int readAheadFrames = 8;
+        vector<string> files;
+
+        pthread_mutex_lock(&m_frameLock);
+
+        //
+        //  Start a new batch once half of the last one has been used,
+        //  or if frame isn't in it (a jump or a reverse step).
+        //
+
+        const bool inBatch = frame >= m_readAheadBegin && frame < m_readAheadEnd;
+        const int begin = inBatch ? m_readAheadEnd : frame + 1;
+
+        if (begin - frame <= readAheadFrames / 2)
+        {
+            const int end = frame + 1 + readAheadFrames;
+
+            for (FrameMap::const_iterator i = m_frameMap.lower_bound(begin); i != m_frameMap.end() && i->first < end; ++i)
+            {
+                files.push_back(i->second.fileName);
+            }
+
+            m_readAheadBegin = frame;
+            m_readAheadEnd = end;
+        }
+
+        pthread_mutex_unlock(&m_frameLock);
+
+        if (!files.empty())
+        {
+            TwkFB::ThreadPool::addTask(
+                new ReadAheadTask(m_readAheadTasks, files, m_imgio->getIntAttribute("iosize"), max(m_imgio->getIntAttribute("iomaxAsync"), 64)));
+        }
+    }
+
     void MovieFB::identifiersAtFrame(const ReadRequest& request, IdentifierVector& ids)
     {
         //
@@ -581,6 +851,7 @@ namespace TwkMovie
                 }
             }
 
+            id << request.subsetIdentifier();
             ids.push_back(id.str());
         }
     }
@@ -8,8 +8,10 @@
 #ifndef __MovieFB__MovieFB__h__
 #define __MovieFB__MovieFB__h__
 #include <TwkFB/FrameBuffer.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkMovie/Movie.h>
 #include <TwkMovie/MovieIO.h>
+#include <TwkMovie/MediaInfoIndex.h>
 #include <TwkUtil/FileSequence.h>
 #include <TwkUtil/FrameUtils.h>
 #include <string>
@@ -109,6 +111,12 @@ namespace TwkMovie
         bool fileAndIdAtFrame(int& frame, std::string&, std::ostream&, bool);
         void updateFrameInfo();
         bool getImageInfo(const std::string& filename);
+        void readMediaInfo();
+        bool openFromIndex();
+        void storeInIndex(const TwkUtil::ExistingFileList&, int infoFrame);
+        bool indexEntryUnchecked() const;
+        void validateIndexEntry();
+        void readAhead(int frame);
 
     protected:
         std::string m_sequencePattern;
@@ -118,11 +126,17 @@ namespace TwkMovie
         TwkUtil::FrameList m_frames;
 
         mutable pthread_mutex_t m_frameLock;
+        pthread_mutex_t m_indexLock;
 
         const FrameBufferIO* m_imgio;
         TwkFB::FBInfo m_imgInfo;
         unsigned long m_filehash;
         bool m_frameInfoValid;
+        bool m_fromIndex;
+        MediaInfoIndex::StampVector m_indexStamps;
+        int m_readAheadBegin;
+        int m_readAheadEnd;
+        ILMTHREAD_NAMESPACE::TaskGroup* m_readAheadTasks;
     };
 
     //
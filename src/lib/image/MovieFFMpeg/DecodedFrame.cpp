@@ -0,0 +1,148 @@
+//******************************************************************************
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#include <MovieFFMpeg/DecodedFrame.h>
+#include <TwkFB/FastConversion.h>
+#include <memory>
+
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace TwkMovie
+{
+    using namespace TwkFB;
+
+    namespace
+    {
+
+        //
+        // Keeps the buffers of a decoded frame alive for as long as
+        // FrameBuffer planes point into them.
+        //
+
+        class AVFrameOwner : public FrameBuffer::DataOwner
+        {
+        public:
+            explicit AVFrameOwner(AVFrame* frame)
+                : m_frame(frame)
+            {
+            }
+
+            ~AVFrameOwner() { av_frame_free(&m_frame); }
+
+        private:
+            AVFrame* m_frame;
+        };
+
+    } // namespace
+
+    FrameBuffer* wrapDecodedFrame(AVFrame* frame, int width, int height, FrameBuffer::Orientation orientation)
+    {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+        const uint64_t excluded = AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL
+                                  | AV_PIX_FMT_FLAG_BITSTREAM;
+
+        if (!frame->buf[0] || !av_frame_is_writable(frame) || !desc || (desc->flags & excluded) || !(desc->flags & AV_PIX_FMT_FLAG_PLANAR)
+            || desc->nb_components < 3)
+        {
+            return nullptr;
+        }
+
+        const int bits = desc->comp[0].depth;
+        const int numPlanes = av_pix_fmt_count_planes(static_cast<AVPixelFormat>(frame->format));
+        const bool alpha = desc->flags & AV_PIX_FMT_FLAG_ALPHA;
+
+        for (int c = 0; c < desc->nb_components; c++)
+        {
+            if (desc->comp[c].shift || desc->comp[c].depth != bits)
+                return nullptr;
+        }
+
+        if (bits < 8 || bits > 16 || (alpha && bits != 8))
+            return nullptr;
+
+        //
+        // Either one plane per component or Y and UV, U first
+        //
+
+        const bool biPlanar = numPlanes == 2 && !alpha && bits == 8 && desc->comp[1].plane == 1 && desc->comp[2].plane == 1
+                              && desc->comp[1].offset < desc->comp[2].offset;
+
+        if (!biPlanar)
+        {
+            if (numPlanes != desc->nb_components)
+                return nullptr;
+
+            for (int c = 0; c < desc->nb_components; c++)
+            {
+                if (desc->comp[c].plane != c)
+                    return nullptr;
+            }
+        }
+
+        const FrameBuffer::DataType dataType = bits > 8 ? FrameBuffer::USHORT : FrameBuffer::UCHAR;
+        const int bytes = bits > 8 ? 2 : 1;
+        FrameBuffer::StringVector names[4] = {{"Y"}, {"U"}, {"V"}, {"A"}};
+
+        if (biPlanar)
+            names[1].push_back("V");
+
+        for (int p = 0; p < numPlanes; p++)
+        {
+            const int pixelSize = bytes * int(names[p].size());
+
+            if (frame->linesize[p] <= 0 || frame->linesize[p] % pixelSize || size_t(frame->data[p]) % bytes)
+            {
+                return nullptr;
+            }
+        }
+
+        AVFrame* ref = av_frame_alloc();
+
+        if (!ref)
+            return nullptr;
+
+        av_frame_move_ref(ref, frame);
+
+        FrameBuffer::DataOwnerPtr owner = std::make_shared<AVFrameOwner>(ref);
+        FrameBuffer* out = nullptr;
+
+        for (int p = 0; p < numPlanes; p++)
+        {
+            const bool chroma = p == 1 || p == 2;
+            const int w = chroma ? AV_CEIL_RSHIFT(width, desc->log2_chroma_w) : width;
+            const int h = chroma ? AV_CEIL_RSHIFT(height, desc->log2_chroma_h) : height;
+            const int extraScanlinePixels = ref->linesize[p] / (bytes * int(names[p].size())) - w;
+
+            //
+            // Nothing else holds the buffers, the samples can move to
+            // the top bits where they are
+            //
+
+            if (bits > 8 && bits < 16)
+            {
+                uint16_t* samples = reinterpret_cast<uint16_t*>(ref->data[p]);
+                planarN_to_planar16_MP(w, h, samples, ref->linesize[p], samples, ref->linesize[p], bits);
+            }
+
+            FrameBuffer* fb = new FrameBuffer(FrameBuffer::PixelCoordinates, w, h, 0, names[p].size(), dataType, ref->data[p], &names[p],
+                                              orientation, false, 0, extraScanlinePixels);
+            fb->setDataOwner(owner);
+
+            if (out)
+                out->appendPlane(fb);
+            else
+                out = fb;
+        }
+
+        return out;
+    }
+
+} // namespace TwkMovie
@@ -6,15 +6,20 @@
 //
 //******************************************************************************
 #include <MovieFFMpeg/MovieFFMpeg.h>
+#include <MovieFFMpeg/DecodedFrame.h>
+#include <MovieFFMpeg/PacketIndex.h>
 #include <TwkFB/Operations.h>
 #include <TwkExc/Exception.h>
 #include <TwkMovie/Exception.h>
+#include <TwkMovie/MediaInfoIndex.h>
 #include <TwkMovie/Movie.h>
 #include <TwkMovie/ReformattingMovie.h>
 #include <TwkAudio/Audio.h>
 #include <TwkAudio/Interlace.h>
+#include <TwkFB/Cache.h>
 #include <TwkFB/FastMemcpy.h>
 #include <TwkFB/FastConversion.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkUtil/EnvVar.h>
 #include <TwkUtil/Timer.h>
 #include <TwkUtil/PathConform.h>
@@ -29,9 +34,17 @@
 #include <stl_ext/string_algo.h>
 #include <string>
 #include <set>
+#include <deque>
+#include <list>
+#include <map>
 #include <limits>
 #include <cmath>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <fstream>
+#include <sstream>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/thread/mutex.hpp>
@@ -63,6 +76,9 @@ extern "C"
 #endif
 
 static ENVVAR_BOOL(evUseUploadedMovieForStreaming, "RV_SHOTGRID_USE_UPLOADED_MOVIE_FOR_STREAMING", false);
+static ENVVAR_BOOL(evPacketIndex, "RV_FFMPEG_PACKET_INDEX", true);
+static ENVVAR_INT(evFrameWindowMB, "RV_FFMPEG_FRAME_WINDOW_MB", 512);
+static ENVVAR_BOOL(evZeroCopy, "RV_FFMPEG_ZERO_COPY", true);
 
 namespace TwkMovie
 {
@@ -274,6 +290,133 @@ namespace TwkMovie
         AVBufferRef* deviceContext;
     };
 
+    //
+    // FrameWindow keeps references to the frames the decoder produced on
+    // its way to a target frame after a seek back (it decodes forward
+    // from the keyframe before it), so stepping or playing backwards
+    // through a long GOP finds them here instead of seeking and decoding
+    // the GOP again for every frame. Only the GOP of the last seek back
+    // is kept: forward playback never looks here. The windows of all
+    // readers (each caching thread has its own) share one byte budget
+    // and one least recently used order, so a reader makes room by
+    // dropping whichever frame, its own or another reader's, was used
+    // longest ago. The bytes are taken out of the frame cache's
+    // capacity. Hardware frames aren't kept, they belong to a fixed
+    // size pool.
+    //
+
+    class FrameWindow
+    {
+    public:
+        FrameWindow() {}
+
+        ~FrameWindow() { clear(); }
+
+        void add(int frame, const AVFrame* avFrame, size_t budget)
+        {
+            if (!avFrame->buf[0] || avFrame->hw_frames_ctx)
+                return;
+
+            const int bytes = frameBytes(avFrame);
+            if (bytes <= 0 || size_t(bytes) > budget)
+                return;
+
+            AVFrame* f = av_frame_clone(avFrame);
+            if (!f)
+                return;
+
+            Shared& sh = shared();
+            lock_guard<mutex> guard(sh.mutex);
+
+            remove(frame);
+
+            while (sh.totalBytes + bytes > budget)
+            {
+                const LRUEntry& e = sh.lru.front();
+                e.first->remove(e.second);
+            }
+
+            m_frames[frame] = Item(f, sh.lru.insert(sh.lru.end(), LRUEntry(this, frame)));
+            sh.totalBytes += bytes;
+            TwkFB::Cache::addOutsideBytes(bytes);
+        }
+
+        bool find(int frame, AVFrame* avFrame)
+        {
+            lock_guard<mutex> guard(shared().mutex);
+
+            ItemMap::iterator i = m_frames.find(frame);
+            if (i == m_frames.end())
+                return false;
+
+            LRU& lru = shared().lru;
+            lru.splice(lru.end(), lru, i->second.second);
+            av_frame_unref(avFrame);
+            return av_frame_ref(avFrame, i->second.first) >= 0;
+        }
+
+        void clear()
+        {
+            lock_guard<mutex> guard(shared().mutex);
+
+            while (!m_frames.empty())
+            {
+                remove(m_frames.begin()->first);
+            }
+        }
+
+    private:
+        typedef pair<FrameWindow*, int> LRUEntry;
+        typedef list<LRUEntry> LRU;
+        typedef pair<AVFrame*, LRU::iterator> Item;
+        typedef map<int, Item> ItemMap;
+
+        struct Shared
+        {
+            Shared()
+                : totalBytes(0)
+            {
+            }
+
+            size_t totalBytes;
+            LRU lru;
+            std::mutex mutex;
+        };
+
+        //
+        // Never destroyed: readers can outlive static destruction
+        //
+
+        static Shared& shared()
+        {
+            static Shared* s = new Shared();
+            return *s;
+        }
+
+        static int frameBytes(const AVFrame* f) { return av_image_get_buffer_size(AVPixelFormat(f->format), f->width, f->height, 1); }
+
+        //
+        // Callers hold shared().mutex
+        //
+
+        void remove(int frame)
+        {
+            ItemMap::iterator i = m_frames.find(frame);
+            if (i == m_frames.end())
+                return;
+
+            AVFrame* f = i->second.first;
+            const size_t bytes = frameBytes(f);
+            shared().totalBytes -= bytes;
+            TwkFB::Cache::removeOutsideBytes(bytes);
+            av_frame_free(&f);
+            shared().lru.erase(i->second.second);
+            m_frames.erase(i);
+        }
+
+        ItemMap m_frames;
+    };
+
     struct VideoTrack
     {
         VideoTrack()
@@ -285,6 +428,8 @@ namespace TwkMovie
             , isOpen(false)
             , useOpenJPH(false)
             , useAppleProRes(false)
+            , fillWindow(false)
+            , windowStartTS(AV_NOPTS_VALUE)
             , rotate(false)
             , colrType("")
             , avCodecContext(0)
@@ -344,6 +489,9 @@ namespace TwkMovie
         bool useOpenJPH;
         bool useAppleProRes;
         set<int64_t> tsSet;
+        FrameWindow frameWindow;
+        bool fillWindow;       // decoding forward after a seek back
+        int64_t windowStartTS; // first keyframe decoded since then
         FrameBuffer fb;
         struct SwsContext* imgConvertContext;
         AVPacket* videoPacket;
@@ -629,6 +777,127 @@ namespace TwkMovie
         }
     }
 
+    namespace
+    {
+        //
+        // Time from the seek until the target frame is decoded, with and
+        // without the packet index. RV_FFMPEG_SEEK_STATS prints them at
+        // exit.
+        //
+
+        struct SeekStats
+        {
+            struct Counter
+            {
+                Counter()
+                    : count(0)
+                    , seconds(0)
+                    , maxSeconds(0)
+                {
+                }
+
+                size_t count;
+                double seconds;
+                double maxSeconds;
+            };
+
+            ~SeekStats()
+            {
+                if (!getenv("RV_FFMPEG_SEEK_STATS"))
+                    return;
+
+                const char* names[2] = {"demuxer", "packet index"};
+
+                for (int i = 0; i < 2; i++)
+                {
+                    const Counter& c = counters[i];
+
+                    if (c.count)
+                    {
+                        cout << "INFO: MovieFFMpeg: " << c.count << " seeks with " << names[i] << ", " << 1000.0 * c.seconds / c.count
+                             << " ms average, " << 1000.0 * c.maxSeconds << " ms max" << endl;
+                    }
+                }
+            }
+
+            void add(bool indexed, double seconds)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                Counter& c = counters[indexed ? 1 : 0];
+                c.count++;
+                c.seconds += seconds;
+                c.maxSeconds = max(c.maxSeconds, seconds);
+            }
+
+            std::mutex mutex;
+            Counter counters[2];
+        };
+
+        SeekStats seekStats;
+
+        //
+        // How many decoded frames of each codec and pixel format were
+        // wrapped by wrapDecodedFrame(), copied because something else
+        // still referenced them (the decoder's reference frames) or
+        // copied because the renderer can't take the format as it is.
+        // RV_FFMPEG_ZERO_COPY_STATS prints them at exit.
+        //
+
+        struct ZeroCopyStats
+        {
+            struct Counter
+            {
+                Counter()
+                    : wrapped(0)
+                    , referenced(0)
+                    , unsupported(0)
+                {
+                }
+
+                size_t wrapped;
+                size_t referenced;
+                size_t unsupported;
+            };
+
+            ZeroCopyStats()
+                : enabled(getenv("RV_FFMPEG_ZERO_COPY_STATS") != 0)
+            {
+            }
+
+            ~ZeroCopyStats()
+            {
+                for (map<string, Counter>::const_iterator i = counters.begin(); i != counters.end(); ++i)
+                {
+                    const Counter& c = i->second;
+                    cout << "INFO: MovieFFMpeg: " << i->first << ": " << c.wrapped << " frames wrapped, " << c.referenced
+                         << " copied (referenced), " << c.unsupported << " copied (format)" << endl;
+                }
+            }
+
+            void add(const AVCodecContext* context, int pixelFormat, bool wrapped, bool referenced)
+            {
+                const char* format = av_get_pix_fmt_name(static_cast<AVPixelFormat>(pixelFormat));
+                const string name = string(context->codec ? context->codec->name : "unknown") + " " + (format ? format : "unknown");
+
+                std::lock_guard<std::mutex> lock(mutex);
+                Counter& c = counters[name];
+
+                if (wrapped)
+                    c.wrapped++;
+                else if (referenced)
+                    c.referenced++;
+                else
+                    c.unsupported++;
+            }
+
+            const bool enabled;
+            std::mutex mutex;
+            map<string, Counter> counters;
+        };
+
+        ZeroCopyStats zeroCopyStats;
+    } // namespace
+
     namespace
     {
         constexpr int rv_seek_frame_offset = 1;
@@ -890,6 +1159,54 @@ namespace TwkMovie
             return best;
         }
 
+        //
+        // Planar YUV of 9 to 15 bits (yuv420p10le, yuv422p10le,
+        // yuv444p12le ...) going to the 16 bit format of the same layout
+        // only has its samples shifted up, which is what sws_scale() does
+        // for them (its planar copy, the range isn't full). Returns false
+        // for anything else.
+        //
+
+        bool shiftPlanarYUVTo16(const AVFrame* srcFrame, AVFrame* dstFrame, int width, int height)
+        {
+            const AVPixFmtDescriptor* in = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(srcFrame->format));
+            const AVPixFmtDescriptor* out = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(dstFrame->format));
+            const uint64_t excluded = AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_HWACCEL
+                                      | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM;
+
+            if (!in || !out || (in->flags & excluded) || (out->flags & excluded) || !(in->flags & AV_PIX_FMT_FLAG_PLANAR)
+                || !(out->flags & AV_PIX_FMT_FLAG_PLANAR) || in->nb_components != 3 || out->nb_components != 3
+                || in->log2_chroma_w != out->log2_chroma_w || in->log2_chroma_h != out->log2_chroma_h)
+            {
+                return false;
+            }
+
+            const int bits = in->comp[0].depth;
+
+            for (int c = 0; c < 3; c++)
+            {
+                if (in->comp[c].plane != c || out->comp[c].plane != c || in->comp[c].shift || out->comp[c].shift
+                    || in->comp[c].depth != bits || out->comp[c].depth != 16 || srcFrame->linesize[c] < 0)
+                {
+                    return false;
+                }
+            }
+
+            if (bits <= 8 || bits > 16)
+                return false;
+
+            for (int p = 0; p < 3; p++)
+            {
+                const int w = p ? AV_CEIL_RSHIFT(width, in->log2_chroma_w) : width;
+                const int h = p ? AV_CEIL_RSHIFT(height, in->log2_chroma_h) : height;
+
+                planarN_to_planar16_MP(w, h, reinterpret_cast<const uint16_t*>(srcFrame->data[p]), srcFrame->linesize[p],
+                                       reinterpret_cast<uint16_t*>(dstFrame->data[p]), dstFrame->linesize[p], bits);
+            }
+
+            return true;
+        }
+
         bool isMetadataField(string check)
         {
             for (const char** p = metadataFieldsArray; *p; p++)
@@ -1185,6 +1502,9 @@ namespace TwkMovie
 
         if (m_avFormatContext)
             avformat_close_input(&m_avFormatContext);
+
+        m_packetIndex.reset();
+        m_packetIndexChecked = false;
     }
 
     void MovieFFMpegReader::audioConfigure(const AudioConfiguration& config)
@@ -1446,8 +1766,10 @@ namespace TwkMovie
         }
 #endif
 
-        // Open the codec
-        (*avCodecContext)->thread_count = m_io->codecThreads();
+        // Open the codec, by default with its share of the decode pool
+        const int codecThreads = m_io->codecThreads();
+        (*avCodecContext)->thread_count = codecThreads > 0 ? codecThreads : int(TwkFB::ThreadPool::codecThreadCount());
+        TwkFB::ThreadPool::addExternalThreads(TwkFB::ThreadPool::FFmpegSubsystem, size_t((*avCodecContext)->thread_count));
         if (avcodec_open2(*avCodecContext, avCodec, nullptr) < 0)
         {
             std::cerr << "ERROR: MovieFFMpeg: Failed to open codec '" << avCodec->name << "' for " << m_filename << '\n';
@@ -3037,6 +3359,14 @@ namespace TwkMovie
         }
 #endif
 
+        // sws_scale() converts these a row at a time on one thread, with no
+        // x86 SIMD for the shift. These are the common outputs of software
+        // HEVC, ProRes and DNxHR decoding.
+        if (shiftPlanarYUVTo16(srcFrame, dstFrame, width, height))
+        {
+            return;
+        }
+
         // Reuse or allocate a new image conversion context
         // Note: If track->imgConvertContext is NULL, sws_getCachedContext
         // just calls sws_getContext() to get a new context. Otherwise, it
@@ -3543,7 +3873,8 @@ namespace TwkMovie
         }
 
         avcodec_flush_buffers(track->avCodecContext);
-        if (av_seek_frame(m_avFormatContext, track->number, seekTarget, AVSEEK_FLAG_BACKWARD) < 0)
+        m_seekIndexed = seekWithPacketIndex(seekTarget, track);
+        if (!m_seekIndexed && av_seek_frame(m_avFormatContext, track->number, seekTarget, AVSEEK_FLAG_BACKWARD) < 0)
         {
             // Try from the start if targeted seek fails
             if (av_seek_frame(m_avFormatContext, -1, m_avFormatContext->start_time, 0) < 0)
@@ -3565,6 +3896,82 @@ namespace TwkMovie
 #endif
     }
 
+    bool MovieFFMpegReader::seekWithPacketIndex(int64_t seekTarget, VideoTrack* track)
+    {
+        //
+        // Only worth it for long GOP local files the demuxer has no index
+        // for. The first seek decides for the life of the reader.
+        //
+
+        if (!m_packetIndexChecked)
+        {
+            m_packetIndexChecked = true;
+
+            AVStream* stream = m_avFormatContext->streams[track->number];
+
+            if (evPacketIndex.getValue() && m_info.slowRandomAccess && !TwkUtil::pathIsURL(m_filename)
+                && avformat_index_get_entries_count(stream) < 2)
+            {
+                vector<int> streams;
+                for (size_t i = 0; i < m_videoTracks.size(); i++)
+                    streams.push_back(m_videoTracks[i]->number);
+
+                m_packetIndex = PacketIndex::acquire(m_filename, streams);
+            }
+        }
+
+        PacketIndex::Keyframe keyframe;
+
+        if (!m_packetIndex || !m_packetIndex->keyframeBefore(track->number, seekTarget, keyframe))
+            return false;
+
+        //
+        // A byte seek lands exactly on the keyframe's packet, otherwise
+        // ask for the keyframe's own timestamp.
+        //
+
+        if (keyframe.pos >= 0 && !(m_avFormatContext->iformat->flags & AVFMT_NO_BYTE_SEEK)
+            && av_seek_frame(m_avFormatContext, track->number, keyframe.pos, AVSEEK_FLAG_BYTE) >= 0)
+        {
+            return true;
+        }
+
+        const int64_t ts = keyframe.dts != AV_NOPTS_VALUE ? keyframe.dts : keyframe.ts;
+        return av_seek_frame(m_avFormatContext, track->number, ts, AVSEEK_FLAG_BACKWARD) >= 0;
+    }
+
+    bool MovieFFMpegReader::keyframesAround(int frame, int& before, int& after) const
+    {
+        //
+        // Only known once a seek has brought in the packet index
+        //
+
+        if (!m_packetIndex || m_videoTracks.empty() || !m_avFormatContext)
+            return false;
+
+        const int stream = m_videoTracks.front()->number;
+        const AVStream* videoStream = m_avFormatContext->streams[stream];
+        const double frameDur = double(videoStream->time_base.den) / (double(videoStream->time_base.num) * m_info.fps);
+        const int64_t decodeFrame = int64_t(frame) - m_info.start + 1 + m_formatStartFrame;
+        const int64_t ts = int64_t((decodeFrame - rv_seek_frame_offset) * frameDur);
+
+        PacketIndex::Keyframe keyframe;
+        if (!m_packetIndex->keyframeBefore(stream, ts, keyframe))
+            return false;
+
+        const int offset = int(m_info.start - 1 - m_formatStartFrame);
+        before = int(double(keyframe.ts) / frameDur + 1.49) + offset;
+
+        if (m_packetIndex->keyframeAfter(stream, ts, keyframe))
+            after = int(double(keyframe.ts) / frameDur + 1.49) + offset;
+        else if (m_packetIndex->complete())
+            after = m_info.end + 1;
+        else
+            return false;
+
+        return true;
+    }
+
     bool MovieFFMpegReader::readPacketFromStream(const int inframe, VideoTrack* track)
     {
         bool finalPacket = false;
@@ -3742,6 +4149,31 @@ namespace TwkMovie
                 const int64_t lastTS = (pktPTS == AV_NOPTS_VALUE) ? pktDTS : pktPTS;
                 track->lastDecodedVideo = int(double(lastTS) / frameDur + 1.49);
 
+                if (track->fillWindow)
+                {
+                    //
+                    // Leading frames of an open GOP come out after the
+                    // keyframe but before it in time and may reference the
+                    // previous GOP: only frames from the keyframe on are
+                    // kept, and none the decoder flagged as corrupt.
+                    //
+
+                    const AVFrame* f = track->videoFrame;
+#ifdef AV_FRAME_FLAG_KEY
+                    const bool key = f->flags & AV_FRAME_FLAG_KEY;
+#else
+                    const bool key = f->key_frame;
+#endif
+
+                    if (track->windowStartTS == AV_NOPTS_VALUE && key)
+                        track->windowStartTS = lastTS;
+
+                    if (track->windowStartTS != AV_NOPTS_VALUE && lastTS >= track->windowStartTS && !(f->flags & AV_FRAME_FLAG_CORRUPT))
+                    {
+                        track->frameWindow.add(track->lastDecodedVideo, track->videoFrame, size_t(evFrameWindowMB.getValue()) << 20);
+                    }
+                }
+
                 // If the last timestamp is now equal to or greater than either
                 // the best possible timestamp for inframe or the last of the
                 // stream then we are no longer searching.
@@ -3803,8 +4235,28 @@ namespace TwkMovie
         // FFmpeg with a default value of 12 even for intra-frame compression
         // codecs (such as Apple Pro Res for example).
         const int nearFrameThreshold = (m_info.slowRandomAccess && videoCodecContext->gop_size != 0) ? videoCodecContext->gop_size : 1;
-        if (track->lastDecodedVideo == -1 || track->lastDecodedVideo >= inframe || track->lastDecodedVideo < (inframe - nearFrameThreshold))
+        //
+        // A frame decoded on the way to an earlier target is still in the
+        // window: no need to seek back and decode its GOP again.
+        //
+
+        const bool inWindow = track->frameWindow.find(inframe, track->videoFrame);
+        TwkUtil::Timer seekTimer;
+
+        if (!inWindow
+            && (track->lastDecodedVideo == -1 || track->lastDecodedVideo >= inframe
+                || track->lastDecodedVideo < (inframe - nearFrameThreshold)))
         {
+            //
+            // The window only holds the GOP of the latest seek back
+            //
+
+            track->frameWindow.clear();
+            track->fillWindow = track->lastDecodedVideo != -1 && track->lastDecodedVideo >= inframe && !track->useOpenJPH
+                                && !track->useAppleProRes && evFrameWindowMB.getValue() > 0;
+            track->windowStartTS = AV_NOPTS_VALUE;
+
+            seekTimer.start();
             seekToFrame(inframe, frameDur, videoStream, track);
         }
 
@@ -3816,7 +4268,11 @@ namespace TwkMovie
         m_timingDetails->startTimer("decode");
 #endif
 
-        const bool frameFinished = findImageWithBestTimestamp(inframe, frameDur, videoStream, track);
+        const bool frameFinished = inWindow || findImageWithBestTimestamp(inframe, frameDur, videoStream, track);
+        track->fillWindow = false;
+
+        if (seekTimer.isRunning())
+            seekStats.add(m_seekIndexed, seekTimer.stop());
 
         // Remove earlier timestamps
         int64_t prune = (inframe - 2) * frameDur;
@@ -3894,6 +4350,30 @@ namespace TwkMovie
             }
         }
 
+        //
+        // Hand the decoded frame over as it is when the renderer can take
+        // it and nothing else references it (the frame window or the
+        // decoder). The FrameBuffer takes its buffers instead of a copy
+        // and videoFrame is left empty.
+        //
+
+        if (!track->rotate && evZeroCopy.getValue())
+        {
+            const int pixelFormat = videoFrame->format;
+            const bool referenced = zeroCopyStats.enabled && videoFrame->buf[0] && !av_frame_is_writable(videoFrame);
+            FrameBuffer* wrapped = wrapDecodedFrame(videoFrame, width, height, track->fb.orientation());
+
+            if (zeroCopyStats.enabled)
+                zeroCopyStats.add(videoCodecContext, pixelFormat, wrapped != 0, referenced);
+
+            if (wrapped)
+            {
+                av_frame_free(&softwareFrame);
+                addTimecode(inframe, track);
+                return wrapped;
+            }
+        }
+
         //
         // Determine the native pixel format and make an effort to reconfigure
         // the frame buffer we plan to return to match so we don't have to scale
@@ -3934,6 +4414,7 @@ namespace TwkMovie
         FrameBuffer::DataType dataType = (bitSize > 8) ? FrameBuffer::USHORT : FrameBuffer::UCHAR;
         FrameBuffer::StringVector chans(3);
         FrameBuffer* out = 0;
+        bool gbrPlanes = false;
         av_image_fill_arrays(outFrame->data, outFrame->linesize, nullptr, nativeFormat, width, height, 1 /*align*/);
 
         // Note: We're about to use offset_plus1 here to derive the RGB channel
@@ -3973,6 +4454,18 @@ namespace TwkMovie
         }
             out = new FrameBuffer(width, height, chans.size(), dataType, NULL, &chans);
             break;
+        case AV_PIX_FMT_GBRP16:
+            // Planar 16 bit RGB is copied as is into planar R, G and B
+            // FrameBuffers. The rotation below only knows YUV planes so
+            // rotated movies are converted like the other formats.
+            if (!track->rotate)
+            {
+                const FrameBuffer::StringVector planeNames = {"R", "G", "B"};
+                out = new FrameBuffer();
+                out->restructurePlanar(width, height, planeNames, FrameBuffer::USHORT, track->fb.orientation());
+                gbrPlanes = true;
+                break;
+            }
         default:
             nativeFormat = getBestRVFormat(nativeFormat);
             outFrame->format = nativeFormat;
@@ -4004,6 +4497,17 @@ namespace TwkMovie
             outFrame->data[p] = fb->pixels<unsigned char>();
         }
 
+        if (gbrPlanes)
+        {
+            // FFmpeg's plane order is G, B, R
+            FrameBuffer* planes[3] = {out->nextPlane(), out->nextPlane()->nextPlane(), out};
+            for (int p = 0; p < 3; p++)
+            {
+                outFrame->data[p] = planes[p]->pixels<unsigned char>();
+                outFrame->linesize[p] = int(planes[p]->scanlinePaddedSize());
+            }
+        }
+
 #if DB_TIMING & DB_LEVEL
         m_timingDetails->startTimer("copyFrame");
 #endif
@@ -4059,6 +4563,12 @@ namespace TwkMovie
         // Add Timecode if necessary
         //
 
+        addTimecode(inframe, track);
+        return out;
+    }
+
+    void MovieFFMpegReader::addTimecode(int inframe, VideoTrack* track)
+    {
         if (m_timecodeTrack != -1)
         {
             AVStream* tsStream = m_avFormatContext->streams[m_timecodeTrack];
@@ -4084,8 +4594,6 @@ namespace TwkMovie
             av_timecode_make_string(&avTimecode, tcString, inframe - 1);
             track->fb.attribute<string>("Timecode") = string(tcString);
         }
-
-        return out;
     }
 
     void MovieFFMpegReader::imagesAtFrame(const ReadRequest& request, FrameBufferVector& fbs)
@@ -0,0 +1,48 @@
+//******************************************************************************
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __MovieFFMpeg__DecodedFrame__h__
+#define __MovieFFMpeg__DecodedFrame__h__
+#include <TwkFB/FrameBuffer.h>
+
+struct AVFrame;
+
+namespace TwkMovie
+{
+
+    //
+    // Hands the buffers of a decoded frame over to FrameBuffer planes
+    // pointing into them, with its linesizes as scanline padding, if it
+    // is something the planar YUV shaders draw as it is: 8 bit Y, U, V
+    // (and A) planes, 9 to 16 bit Y, U, V planes or 8 bit Y plus
+    // interleaved UV (nv12, nv16, nv24). 9 to 15 bit samples are shifted
+    // up to 16 bits in place, like the copy in MovieFFMpeg does.
+    //
+    // Only a frame nothing else references (av_frame_is_writable()) is
+    // taken: the decoder keeps its reference frames and the frame window
+    // keeps frames decoded after a seek back, and pixels changed through
+    // the FrameBuffer would show up in later decodes.
+    //
+    // That limits who benefits. Intra-only decoders (ProRes, DNxHD/HR,
+    // MJPEG and the like) hand over frames nobody else holds and are
+    // wrapped. Long-GOP decoders (H.264, HEVC, AV1, VP9, MPEG-2) keep
+    // their I and P frames, and the non-reference frames still held for
+    // output reordering, so most of their frames are copied, including
+    // 10 bit 4:2:2 H.264 and HEVC. RV_FFMPEG_ZERO_COPY_STATS prints
+    // how many frames of each codec and pixel format were wrapped or
+    // copied and why.
+    //
+    // On success the frame's references move to the FrameBuffer, which
+    // frees them when it's deleted or its data is released, and frame
+    // is left empty. Returns nullptr and leaves frame alone otherwise.
+    //
+
+    TwkFB::FrameBuffer* wrapDecodedFrame(AVFrame* frame, int width, int height, TwkFB::FrameBuffer::Orientation orientation);
+
+} // namespace TwkMovie
+
+#endif // __MovieFFMpeg__DecodedFrame__h__
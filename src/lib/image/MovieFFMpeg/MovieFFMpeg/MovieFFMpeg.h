@@ -52,6 +52,7 @@ namespace TwkMovie
     class VideoTrack;
     class ContextPool;
     class HardwareContext;
+    class PacketIndex;
 
     //
     //  class MovieFFMpegIO
@@ -168,6 +169,7 @@ namespace TwkMovie
         virtual void audioConfigure(const AudioConfiguration& config);
 
         virtual void scan();
+        virtual bool keyframesAround(int frame, int& before, int& after) const;
 
         float scanProgress() const { return 1.0; }
 
@@ -226,6 +228,7 @@ namespace TwkMovie
         FrameBuffer* decodeImageAtFrame(int inframe, VideoTrack* track);
         FrameBuffer* configureYUVPlanes(FrameBuffer::DataType dataType, int width, int height, int rowSpan, int rowSpanUV, int usampling,
                                         int vsampling, bool addAlpha, FrameBuffer::Orientation orientation);
+        void addTimecode(int inframe, VideoTrack* track);
         void identifier(int frame, std::ostream&);
 
         // Seek to the requested frame and perform drain if requested.
@@ -233,6 +236,11 @@ namespace TwkMovie
         // list.
         void seekToFrame(int inframe, double frameDur, AVStream* videoStream, VideoTrack* track);
 
+        // Seek to the last keyframe before seekTarget found by the packet
+        // index, building or loading the index on first use. Returns false
+        // if there's no index or it can't answer yet.
+        bool seekWithPacketIndex(int64_t seekTarget, VideoTrack* track);
+
         // Read a packet from the video stream and updates the timestamp track
         // list if necessary.
         // Returns true if it reaches the last packet.
@@ -278,6 +286,9 @@ namespace TwkMovie
         bool m_cloning{false};
         bool m_mustReadFirstFrame{false};
         AVPixelFormat m_pxlFormatOnOpen{AV_PIX_FMT_NONE};
+        std::shared_ptr<PacketIndex> m_packetIndex;
+        bool m_packetIndexChecked{false};
+        bool m_seekIndexed{false};
 
         friend class ContextPool;
     };
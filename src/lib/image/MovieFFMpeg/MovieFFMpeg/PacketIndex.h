@@ -0,0 +1,100 @@
+//******************************************************************************
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __MovieFFMpeg__PacketIndex__h__
+#define __MovieFFMpeg__PacketIndex__h__
+#include <TwkMovie/MediaInfoIndex.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+namespace TwkMovie
+{
+
+    //
+    // PacketIndex keeps the timestamps and byte positions of the video
+    // keyframes of a movie so seekToFrame() can go straight to the last
+    // one before its target. The demuxer's own seeking guesses when a
+    // file has no usable index (MPEG-TS, some MXF, variable frame rate
+    // H.264) and can land far from the target, leaving a long decode
+    // forward.
+    //
+    // The index is built by a thread demuxing (not decoding) the file
+    // with its own AVFormatContext and saved as a sidecar of the media
+    // info index, validated by the movie's mtime and size. Readers of
+    // the same file share one. Until it's complete a lookup is only
+    // answered if a later keyframe has already been seen.
+    //
+
+    class PacketIndex
+    {
+    public:
+        struct Keyframe
+        {
+            int64_t ts; // pts, dts if there's none
+            int64_t dts;
+            int64_t pos;
+        };
+
+        typedef std::vector<Keyframe> Keyframes;
+        typedef std::map<int, Keyframes> StreamMap;
+
+        static std::shared_ptr<PacketIndex> acquire(const std::string& filename, const std::vector<int>& streams);
+
+        //
+        // Number of indexes held by a reader right now
+        //
+
+        static size_t numShared();
+
+        ~PacketIndex();
+
+        bool keyframeBefore(int stream, int64_t ts, Keyframe& keyframe) const;
+
+        //
+        // The first keyframe after ts. False if there's none or it isn't
+        // indexed yet.
+        //
+
+        bool keyframeAfter(int stream, int64_t ts, Keyframe& keyframe) const;
+
+        //
+        // complete() once the whole file is indexed, loaded() if that
+        // came from the sidecar file rather than demuxing the movie
+        //
+
+        bool complete() const { return m_complete; }
+
+        bool loaded() const { return m_loaded; }
+
+    private:
+        PacketIndex(const std::string& filename, const std::vector<int>& streams);
+
+        bool load();
+        void save() const;
+        void build();
+
+        static int interrupted(void* index) { return static_cast<PacketIndex*>(index)->m_cancel ? 1 : 0; }
+
+        std::string m_filename;
+        MediaInfoIndex::StampVector m_stamps;
+        mutable std::mutex m_mutex;
+        StreamMap m_keyframes;
+        std::atomic<bool> m_complete;
+        std::atomic<bool> m_cancel;
+        bool m_loaded;
+        std::thread m_thread;
+    };
+
+} // namespace TwkMovie
+
+#endif // __MovieFFMpeg__PacketIndex__h__
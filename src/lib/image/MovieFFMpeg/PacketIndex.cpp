@@ -0,0 +1,333 @@
+//******************************************************************************
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#include <MovieFFMpeg/PacketIndex.h>
+#include <TwkUtil/File.h>
+#include <TwkUtil/Timer.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+}
+
+namespace TwkMovie
+{
+    using namespace std;
+
+    namespace
+    {
+        const char packetIndexMagic[4] = {'R', 'V', 'P', 'I'};
+        const uint32_t packetIndexVersion = 1;
+
+        typedef map<string, weak_ptr<PacketIndex>> PacketIndexMap;
+
+        std::mutex packetIndexMutex;
+        PacketIndexMap* packetIndexes = new PacketIndexMap();
+
+        bool keyframeLess(int64_t ts, const PacketIndex::Keyframe& k) { return ts < k.ts; }
+    } // namespace
+
+    PacketIndex::PacketIndex(const string& filename, const vector<int>& streams)
+        : m_filename(filename)
+        , m_complete(false)
+        , m_cancel(false)
+        , m_loaded(false)
+    {
+        for (size_t i = 0; i < streams.size(); i++)
+            m_keyframes[streams[i]];
+
+        if (MediaInfoIndex::addStamp(m_filename, m_stamps) && load())
+        {
+            m_loaded = true;
+            m_complete = true;
+        }
+        else
+        {
+            m_thread = thread(&PacketIndex::build, this);
+        }
+    }
+
+    PacketIndex::~PacketIndex()
+    {
+        m_cancel = true;
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    shared_ptr<PacketIndex> PacketIndex::acquire(const string& filename, const vector<int>& streams)
+    {
+        std::lock_guard<std::mutex> lock(packetIndexMutex);
+
+        shared_ptr<PacketIndex> index = (*packetIndexes)[filename].lock();
+
+        if (!index)
+        {
+            //
+            // The last reader to let go removes the entry. Another one
+            // may have replaced it by then, so only an expired entry is
+            // removed.
+            //
+
+            index.reset(new PacketIndex(filename, streams),
+                        [](PacketIndex* p)
+                        {
+                            {
+                                std::lock_guard<std::mutex> lock(packetIndexMutex);
+                                PacketIndexMap::iterator i = packetIndexes->find(p->m_filename);
+                                if (i != packetIndexes->end() && i->second.expired())
+                                    packetIndexes->erase(i);
+                            }
+
+                            delete p;
+                        });
+
+            (*packetIndexes)[filename] = index;
+        }
+
+        return index;
+    }
+
+    size_t PacketIndex::numShared()
+    {
+        std::lock_guard<std::mutex> lock(packetIndexMutex);
+        return packetIndexes->size();
+    }
+
+    bool PacketIndex::keyframeBefore(int stream, int64_t ts, Keyframe& keyframe) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        StreamMap::const_iterator s = m_keyframes.find(stream);
+        if (s == m_keyframes.end() || s->second.empty())
+            return false;
+
+        const Keyframes& keyframes = s->second;
+        Keyframes::const_iterator i = upper_bound(keyframes.begin(), keyframes.end(), ts, keyframeLess);
+
+        if (i == keyframes.end() && !m_complete)
+            return false;
+
+        keyframe = i == keyframes.begin() ? *i : *(i - 1);
+        return true;
+    }
+
+    bool PacketIndex::keyframeAfter(int stream, int64_t ts, Keyframe& keyframe) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        StreamMap::const_iterator s = m_keyframes.find(stream);
+        if (s == m_keyframes.end())
+            return false;
+
+        const Keyframes& keyframes = s->second;
+        Keyframes::const_iterator i = upper_bound(keyframes.begin(), keyframes.end(), ts, keyframeLess);
+
+        if (i == keyframes.end())
+            return false;
+
+        keyframe = *i;
+        return true;
+    }
+
+    bool PacketIndex::load()
+    {
+        const string path = MediaInfoIndex::sidecarFile(m_filename, ".rvpi");
+        if (path.empty())
+            return false;
+
+        ifstream file(path.c_str(), ios::binary);
+        if (!file)
+            return false;
+
+        char magic[4];
+        uint32_t version = 0;
+        uint32_t pathSize = 0;
+        file.read(magic, 4);
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(&pathSize), sizeof(pathSize));
+
+        if (!file || memcmp(magic, packetIndexMagic, 4) || version != packetIndexVersion || pathSize != m_filename.size())
+            return false;
+
+        string name(pathSize, ' ');
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        uint32_t nstreams = 0;
+        file.read(&name[0], pathSize);
+        file.read(reinterpret_cast<char*>(&mtime), sizeof(mtime));
+        file.read(reinterpret_cast<char*>(&size), sizeof(size));
+        file.read(reinterpret_cast<char*>(&nstreams), sizeof(nstreams));
+
+        if (!file || name != m_filename || mtime != m_stamps.front().mtime || size != m_stamps.front().size)
+            return false;
+
+        StreamMap keyframes;
+
+        for (uint32_t i = 0; i < nstreams && file; i++)
+        {
+            int32_t stream = 0;
+            uint32_t count = 0;
+            file.read(reinterpret_cast<char*>(&stream), sizeof(stream));
+            file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+            if (!file || count > (1u << 28))
+                return false;
+
+            Keyframes& k = keyframes[stream];
+            k.resize(count);
+            if (count)
+                file.read(reinterpret_cast<char*>(&k.front()), count * sizeof(Keyframe));
+        }
+
+        //
+        // An index made for other streams doesn't do
+        //
+
+        for (StreamMap::const_iterator i = m_keyframes.begin(); i != m_keyframes.end(); ++i)
+        {
+            if (keyframes.find(i->first) == keyframes.end())
+                return false;
+        }
+
+        if (!file)
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keyframes.swap(keyframes);
+        return true;
+    }
+
+    void PacketIndex::save() const
+    {
+        const string path = MediaInfoIndex::sidecarFile(m_filename, ".rvpi");
+        if (path.empty() || m_stamps.empty())
+            return;
+
+        ostringstream tmp;
+        tmp << path << "." << this << ".tmp";
+
+        try
+        {
+            boost::filesystem::create_directories(boost::filesystem::path(UNICODE_STR(path)).parent_path());
+
+            {
+                ofstream file(tmp.str().c_str(), ios::binary | ios::trunc);
+                const uint32_t pathSize = m_filename.size();
+                const uint32_t nstreams = m_keyframes.size();
+
+                file.write(packetIndexMagic, 4);
+                file.write(reinterpret_cast<const char*>(&packetIndexVersion), sizeof(packetIndexVersion));
+                file.write(reinterpret_cast<const char*>(&pathSize), sizeof(pathSize));
+                file.write(m_filename.data(), pathSize);
+                file.write(reinterpret_cast<const char*>(&m_stamps.front().mtime), sizeof(int64_t));
+                file.write(reinterpret_cast<const char*>(&m_stamps.front().size), sizeof(uint64_t));
+                file.write(reinterpret_cast<const char*>(&nstreams), sizeof(nstreams));
+
+                for (StreamMap::const_iterator i = m_keyframes.begin(); i != m_keyframes.end(); ++i)
+                {
+                    const int32_t stream = i->first;
+                    const uint32_t count = i->second.size();
+                    file.write(reinterpret_cast<const char*>(&stream), sizeof(stream));
+                    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+                    if (count)
+                        file.write(reinterpret_cast<const char*>(&i->second.front()), count * sizeof(Keyframe));
+                }
+
+                if (!file)
+                    throw runtime_error("write failed");
+            }
+
+            boost::filesystem::rename(boost::filesystem::path(UNICODE_STR(tmp.str())), boost::filesystem::path(UNICODE_STR(path)));
+        }
+        catch (const std::exception& exc)
+        {
+            cout << "WARNING: MovieFFMpeg: cannot save the packet index of " << m_filename << ": " << exc.what() << endl;
+            boost::system::error_code ec;
+            boost::filesystem::remove(boost::filesystem::path(UNICODE_STR(tmp.str())), ec);
+        }
+    }
+
+    void PacketIndex::build()
+    {
+        TwkUtil::Timer timer(true);
+
+        AVFormatContext* context = avformat_alloc_context();
+        context->interrupt_callback.callback = &PacketIndex::interrupted;
+        context->interrupt_callback.opaque = this;
+
+        const string path = "file:" + m_filename;
+
+        if (avformat_open_input(&context, path.c_str(), 0, 0) != 0)
+            return;
+
+        if (avformat_find_stream_info(context, 0) < 0)
+        {
+            avformat_close_input(&context);
+            return;
+        }
+
+        for (unsigned int i = 0; i < context->nb_streams; i++)
+        {
+            if (m_keyframes.find(i) == m_keyframes.end())
+                context->streams[i]->discard = AVDISCARD_ALL;
+        }
+
+        AVPacket* packet = av_packet_alloc();
+        size_t count = 0;
+        int ret = 0;
+
+        while (!m_cancel && (ret = av_read_frame(context, packet)) >= 0)
+        {
+            const int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            StreamMap::iterator s = m_keyframes.find(packet->stream_index);
+
+            if ((packet->flags & AV_PKT_FLAG_KEY) && ts != AV_NOPTS_VALUE && s != m_keyframes.end())
+            {
+                const Keyframe keyframe = {ts, packet->dts, packet->pos};
+                Keyframes& keyframes = s->second;
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (keyframes.empty() || keyframes.back().ts <= ts)
+                    keyframes.push_back(keyframe);
+                else
+                    keyframes.insert(upper_bound(keyframes.begin(), keyframes.end(), ts, keyframeLess), keyframe);
+
+                count++;
+            }
+
+            av_packet_unref(packet);
+        }
+
+        av_packet_free(&packet);
+        avformat_close_input(&context);
+
+        //
+        // A read error leaves the index incomplete, it's still good for
+        // the part of the file it covers.
+        //
+
+        if (ret != AVERROR_EOF)
+            return;
+
+        m_complete = true;
+        save();
+
+        if (getenv("RV_FFMPEG_SEEK_STATS"))
+        {
+            cout << "INFO: MovieFFMpeg: indexed " << count << " keyframes of " << m_filename << " in " << timer.elapsed() << " sec" << endl;
+        }
+    }
+
+} // namespace TwkMovie
@@ -8,7 +8,9 @@
 
 #include <TwkFB/Exception.h>
 #include <TwkFB/Cache.h>
+#include <TwkUtil/FileStream.h>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <list>
 
@@ -49,6 +51,7 @@ namespace TwkFB
 
     static Cache::LockLog _locklog;
     static bool _debug = false;
+    static std::atomic<size_t> _outsideBytes(0);
 
     bool& Cache::debug() { return _debug; }
 
@@ -125,7 +128,8 @@ namespace TwkFB
         : m_full(false)
         , m_maxBytes(1024 * 1024 * 250)
         , // default is 250Mb
-        m_currentBytes(0)
+        m_budget(m_maxBytes)
+        , m_currentBytes(0)
         , m_retrieveTime(0)
     {
         pthread_mutex_init(&m_mutex, 0);
@@ -158,11 +162,24 @@ namespace TwkFB
         //
         if (4 == sizeof(void*))
             m = min(m, size_t(2560) * size_t(1024 * 1024));
-        m_maxBytes = m;
+        m_budget = m;
+        updateCapacity();
 
         //  cerr << "Cache::setMemoryUsage after " << m_maxBytes << endl;
     }
 
+    void Cache::updateCapacity()
+    {
+        m_maxBytes = m_budget - min(outsideBytes(), m_budget / 2);
+        m_full = (m_currentBytes >= m_maxBytes);
+    }
+
+    void Cache::addOutsideBytes(size_t bytes) { _outsideBytes += bytes; }
+
+    void Cache::removeOutsideBytes(size_t bytes) { _outsideBytes -= bytes; }
+
+    size_t Cache::outsideBytes() { return _outsideBytes + TwkUtil::FileStream::readAheadBytes(); }
+
     void Cache::clearInternal()
     {
         DB("clearInternal()");
@@ -176,7 +193,7 @@ namespace TwkFB
 
         for (FBMap::iterator i = m_map.begin(); i != m_map.end(); ++i)
         {
-            if (i->second->isCacheLocked())
+            if (i->second->isCacheLocked() || !retirePins(i->second))
             {
                 lockedFBs.push_back(i->second);
                 DB("    fb is locked: " << i->second << " " << i->first);
@@ -186,6 +203,7 @@ namespace TwkFB
                 if (Cache::debug())
                     cout << "DELETING: " << i->second << " : " << i->second->identifier() << endl;
                 m_trashCan->remove(i->second);
+                forgetFB(i->second);
                 delete i->second;
             }
         }
@@ -198,7 +216,7 @@ namespace TwkFB
         {
             FrameBuffer* fb = lockedFBs[i];
             m_map[fb->identifier()] = fb;
-            bytes += fb->totalImageSize();
+            bytes += cachedSize(fb);
         }
         DB("    after clearing, Cache holds " << m_map.size() << " fbs (" << bytes << " bytes)");
 
@@ -219,7 +237,7 @@ namespace TwkFB
             size_t refcount = fbReferenceCount(fb);
             DBL(DB_FLUSH, "flush() fb " << fb << " count " << refcount);
 
-            if (refcount <= 1)
+            if (refcount <= 1 && retirePins(fb))
             {
                 if (Cache::debug())
                     cout << "DELETING: " << fb << " : " << fb->identifier() << endl;
@@ -335,18 +353,34 @@ namespace TwkFB
 
         FrameBuffer* fb = 0;
         size_t freedBytes = 0;
+        vector<FrameBuffer*> pinned;
 
         while (freedBytes < bytes && (fb = m_trashCan->popOldest()))
         {
+            //
+            //  Something is still using the pixels (it pinned the fb
+            //  before its last frame let go of it), try it next time
+            //
+
+            if (!retirePins(fb))
+            {
+                pinned.push_back(fb);
+                continue;
+            }
+
             DBL(DB_TCFREE, "freeTrash() freeing bytes " << fb->totalImageSize() << " (" << fb->identifier() << ")");
             m_map.erase(fb->identifier());
-            const size_t totalImagesize = deleteFB(fb);
+            const size_t adoptedSize = cachedSize(fb);
+            const size_t totalImagesize = aboutToDeleteFB(fb) ? adoptedSize : deleteFB(fb);
 
             m_currentBytes -= totalImagesize;
             freedBytes += totalImagesize;
             m_full = (m_currentBytes >= m_maxBytes);
         }
 
+        for (size_t i = 0; i < pinned.size(); i++)
+            m_trashCan->add(pinned[i]);
+
         return (freedBytes >= bytes);
     }
 
@@ -404,6 +438,7 @@ namespace TwkFB
         if (fb->inCache())
             return ok;
 
+        updateCapacity();
         size_t bytes = fb->totalImageSize();
 
         //  cerr << "Cache::add " << bytes << " to " << m_currentBytes << " of "
@@ -509,7 +544,8 @@ namespace TwkFB
         if (fb)
         {
             // Consider the frame buffer size (including its sub-planes).
-            deletedBytes = fb->totalImageSize();
+            deletedBytes = cachedSize(fb);
+            forgetFB(fb);
 
             // Check to see if this buffer has proxy-buffer that must also be
             // deleted.
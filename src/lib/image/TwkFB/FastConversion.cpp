@@ -8,11 +8,13 @@
 
 #include <TwkFB/FastConversion.h>
 
+#include <TwkFB/SIMDKernels.h>
 #include <TwkFB/TwkFBThreadPool.h>
 #include <TwkUtil/sgcHop.h>
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 using namespace ILMTHREAD_NAMESPACE;
 
@@ -974,3 +976,427 @@ void packedAYUV64_to_planarYUVA16(std::size_t width, std::size_t height, const u
         outCr[i] = pixelsBuf[i].Cr;
     }
 }
+
+//------------------------------------------------------------------------------
+// DPX/Cineon 10 and 12 bit unpacking.
+//
+// The filled rows go to the SIMD kernels when the CPU has them, the others
+// (and the packed data) are read a component at a time by DPXRowReader. The
+// kernels give the same values bit for bit.
+//
+namespace
+{
+    inline uint32_t dpxSwap32(uint32_t v) { return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24); }
+
+    // 65535 * v / 1023 rounded down: 64 * v + 21 * v / 341 with the
+    // division done as a multiply and shift which is exact for v < 1024.
+    inline uint32_t dpx10To16(uint32_t v) { return (v << 6) + ((v * 1033221u) >> 24); }
+
+    inline uint32_t dpx10To8(uint32_t v) { return std::min((v + 1) >> 2, 255u); }
+
+    // Returns the R, G and B components of a row in turn: 10 bit values or
+    // 12 bit ones scaled to 16 bits (method A words are passed through).
+    class DPXRowReader
+    {
+    public:
+        DPXRowReader(const uint8_t* row, int bits, int packing, bool swap)
+            : _row(row)
+            , _bits(bits)
+            , _packing(packing)
+            , _swap(swap)
+            , _index(0)
+            , _bitBuffer(0)
+            , _bitCount(0)
+            , _word(0)
+        {
+        }
+
+        uint32_t next()
+        {
+            if (_packing == DPX_UNPACK_PACKED)
+            {
+                if (_bitCount < _bits)
+                {
+                    _bitBuffer |= uint64_t(word32(_index++)) << _bitCount;
+                    _bitCount += 32;
+                }
+
+                const uint32_t v = uint32_t(_bitBuffer) & ((1u << _bits) - 1);
+                _bitBuffer >>= _bits;
+                _bitCount -= _bits;
+                return _bits == 10 ? v : v << 4;
+            }
+            else if (_bits == 10)
+            {
+                const int c = int(_index++ % 3);
+
+                if (c == 0)
+                {
+                    _word = word32(_index / 3);
+                    if (_packing == DPX_UNPACK_FILLED_A)
+                        _word >>= 2;
+                }
+
+                return (_word >> (20 - 10 * c)) & 0x3ff;
+            }
+            else
+            {
+                uint16_t w;
+                memcpy(&w, _row + _index++ * sizeof(uint16_t), sizeof(w));
+                if (_swap)
+                    w = uint16_t((w >> 8) | (w << 8));
+                return _packing == DPX_UNPACK_FILLED_A ? w : uint16_t(w << 4);
+            }
+        }
+
+    private:
+        uint32_t word32(size_t i) const
+        {
+            uint32_t w;
+            memcpy(&w, _row + i * sizeof(uint32_t), sizeof(w));
+            return _swap ? dpxSwap32(w) : w;
+        }
+
+        const uint8_t* _row;
+        const int _bits;
+        const int _packing;
+        const bool _swap;
+        size_t _index;
+        uint64_t _bitBuffer;
+        int _bitCount;
+        uint32_t _word;
+    };
+
+    bool simdUnpackDPX(int bits, const uint8_t* in, TwkFB::SIMD::UnpackLayout layout, void* const* out, size_t width, int packing,
+                       bool swap)
+    {
+        if (packing == DPX_UNPACK_PACKED)
+            return false;
+
+        const bool msbPadded = packing == DPX_UNPACK_FILLED_B;
+
+        return bits == 10 ? TwkFB::SIMD::unpack10(in, layout, out, width, msbPadded, swap)
+                          : TwkFB::SIMD::unpack12(in, layout, out, width, msbPadded, swap);
+    }
+
+    template <typename T> T* dpxRow(T* buf, size_t y, size_t stride)
+    {
+        return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(buf) + y * stride);
+    }
+
+    template <typename T> const T* dpxRow(const T* buf, size_t y, size_t stride)
+    {
+        return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(buf) + y * stride);
+    }
+
+    template <typename T>
+    void unpackDPX_interleaved(int bits, size_t width, size_t height, const void* inBuf, size_t inStride, T* outBuf, size_t outStride,
+                               int nchannels, int packing, bool swap, TwkFB::SIMD::UnpackLayout layout3,
+                               TwkFB::SIMD::UnpackLayout layout4, uint32_t (*convert)(uint32_t), T alpha)
+    {
+        const uint8_t* in = static_cast<const uint8_t*>(inBuf);
+
+        for (size_t y = 0; y < height; y++)
+        {
+            T* out = dpxRow(outBuf, y, outStride);
+            void* outs[] = {out};
+
+            if (simdUnpackDPX(bits, in + y * inStride, nchannels == 4 ? layout4 : layout3, outs, width, packing, swap))
+                continue;
+
+            DPXRowReader reader(in + y * inStride, bits, packing, swap);
+
+            for (T *p = out, *e = out + width * nchannels; p < e; p += nchannels)
+            {
+                p[0] = T(convert(reader.next()));
+                p[1] = T(convert(reader.next()));
+                p[2] = T(convert(reader.next()));
+                if (nchannels == 4)
+                    p[3] = alpha;
+            }
+        }
+    }
+
+    template <typename T>
+    void unpackDPX_planar(int bits, size_t width, size_t height, const void* inBuf, size_t inStride, T* outR, T* outG, T* outB,
+                          size_t outStride, int packing, bool swap, TwkFB::SIMD::UnpackLayout layout, uint32_t (*convert)(uint32_t))
+    {
+        const uint8_t* in = static_cast<const uint8_t*>(inBuf);
+
+        for (size_t y = 0; y < height; y++)
+        {
+            T* r = dpxRow(outR, y, outStride);
+            T* g = dpxRow(outG, y, outStride);
+            T* b = dpxRow(outB, y, outStride);
+            void* outs[] = {r, g, b};
+
+            if (simdUnpackDPX(bits, in + y * inStride, layout, outs, width, packing, swap))
+                continue;
+
+            DPXRowReader reader(in + y * inStride, bits, packing, swap);
+
+            for (size_t x = 0; x < width; x++)
+            {
+                r[x] = T(convert(reader.next()));
+                g[x] = T(convert(reader.next()));
+                b[x] = T(convert(reader.next()));
+            }
+        }
+    }
+
+    uint32_t dpx16To16(uint32_t v) { return v; }
+
+    uint32_t dpx16To8(uint32_t v) { return v >> 8; }
+
+    // Runs rows(y0, y1) over bands of height rows on the TwkFB::ThreadPool
+    void forEachDPXBand(size_t height, const TwkFB::ThreadPool::RangeFunction& rows)
+    {
+        TwkFB::ThreadPool::parallelFor(0, height, 16, rows);
+    }
+} // namespace
+
+//------------------------------------------------------------------------------
+//
+size_t unpackDPX_rowSize(size_t width, int bits, int packing)
+{
+    if (packing == DPX_UNPACK_PACKED)
+        return (width * 3 * bits + 31) / 32 * sizeof(uint32_t);
+    return bits == 10 ? width * sizeof(uint32_t) : width * 3 * sizeof(uint16_t);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_RGB16(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                          uint16_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap)
+{
+    unpackDPX_interleaved<uint16_t>(10, width, height, inBuf, inStride, outBuf, outStride, nchannels, packing, swap,
+                                    TwkFB::SIMD::UnpackRGB16, TwkFB::SIMD::UnpackRGBA16, dpx10To16, 65535);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_RGB16_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                             uint16_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX10_to_RGB16(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                            dpxRow(outBuf, y0, outStride), outStride, nchannels, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_RGB8(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                         uint8_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap)
+{
+    unpackDPX_interleaved<uint8_t>(10, width, height, inBuf, inStride, outBuf, outStride, nchannels, packing, swap,
+                                   TwkFB::SIMD::UnpackRGB8, TwkFB::SIMD::UnpackRGBA8, dpx10To8, 255);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_RGB8_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                            uint8_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX10_to_RGB8(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                           dpxRow(outBuf, y0, outStride), outStride, nchannels, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_planarRGB16(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG, uint16_t* FASTMEMCPYRESTRICT outB,
+                                size_t outStride, int packing, bool swap)
+{
+    unpackDPX_planar<uint16_t>(10, width, height, inBuf, inStride, outR, outG, outB, outStride, packing, swap, TwkFB::SIMD::UnpackPlanar16,
+                               dpx10To16);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_planarRGB16_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                   uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG,
+                                   uint16_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX10_to_planarRGB16(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                                  dpxRow(outR, y0, outStride), dpxRow(outG, y0, outStride), dpxRow(outB, y0, outStride),
+                                                  outStride, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_planarRGB8(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                               uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG, uint8_t* FASTMEMCPYRESTRICT outB,
+                               size_t outStride, int packing, bool swap)
+{
+    unpackDPX_planar<uint8_t>(10, width, height, inBuf, inStride, outR, outG, outB, outStride, packing, swap, TwkFB::SIMD::UnpackPlanar8,
+                              dpx10To8);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_planarRGB8_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                  uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG, uint8_t* FASTMEMCPYRESTRICT outB,
+                                  size_t outStride, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX10_to_planarRGB8(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                                 dpxRow(outR, y0, outStride), dpxRow(outG, y0, outStride), dpxRow(outB, y0, outStride),
+                                                 outStride, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_A2BGR10(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                            uint32_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int packing, bool swap)
+{
+    const uint8_t* in = static_cast<const uint8_t*>(inBuf);
+
+    for (size_t y = 0; y < height; y++)
+    {
+        uint32_t* out = dpxRow(outBuf, y, outStride);
+        void* outs[] = {out};
+
+        if (simdUnpackDPX(10, in + y * inStride, TwkFB::SIMD::UnpackA2BGR10, outs, width, packing, swap))
+            continue;
+
+        DPXRowReader reader(in + y * inStride, 10, packing, swap);
+
+        for (uint32_t *p = out, *e = out + width; p < e; p++)
+        {
+            const uint32_t r = reader.next();
+            const uint32_t g = reader.next();
+            const uint32_t b = reader.next();
+            *p = r | (g << 10) | (b << 20);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX10_to_A2BGR10_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                               uint32_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX10_to_A2BGR10(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                              dpxRow(outBuf, y0, outStride), outStride, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX12_to_planarRGB16(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG, uint16_t* FASTMEMCPYRESTRICT outB,
+                                size_t outStride, int packing, bool swap)
+{
+    unpackDPX_planar<uint16_t>(12, width, height, inBuf, inStride, outR, outG, outB, outStride, packing, swap, TwkFB::SIMD::UnpackPlanar16,
+                               dpx16To16);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX12_to_planarRGB16_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                   uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG,
+                                   uint16_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX12_to_planarRGB16(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                                  dpxRow(outR, y0, outStride), dpxRow(outG, y0, outStride), dpxRow(outB, y0, outStride),
+                                                  outStride, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX12_to_planarRGB8(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                               uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG, uint8_t* FASTMEMCPYRESTRICT outB,
+                               size_t outStride, int packing, bool swap)
+{
+    unpackDPX_planar<uint8_t>(12, width, height, inBuf, inStride, outR, outG, outB, outStride, packing, swap, TwkFB::SIMD::UnpackPlanar8,
+                              dpx16To8);
+}
+
+//------------------------------------------------------------------------------
+//
+void unpackDPX12_to_planarRGB8_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                  uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG, uint8_t* FASTMEMCPYRESTRICT outB,
+                                  size_t outStride, int packing, bool swap)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       unpackDPX12_to_planarRGB8(width, y1 - y0, static_cast<const uint8_t*>(inBuf) + y0 * inStride, inStride,
+                                                 dpxRow(outR, y0, outStride), dpxRow(outG, y0, outStride), dpxRow(outB, y0, outStride),
+                                                 outStride, packing, swap);
+                   });
+}
+
+//------------------------------------------------------------------------------
+//
+void planarN_to_planar16(size_t width, size_t height, const uint16_t* inBuf, size_t inStride, uint16_t* outBuf, size_t outStride,
+                         int bits)
+{
+    const int shift = 16 - bits;
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(inBuf);
+    uint8_t* out = reinterpret_cast<uint8_t*>(outBuf);
+
+    for (size_t y = 0; y < height; y++)
+    {
+        const uint16_t* src = reinterpret_cast<const uint16_t*>(in + y * inStride);
+        uint16_t* dst = reinterpret_cast<uint16_t*>(out + y * outStride);
+
+        if (TwkFB::SIMD::shiftLeft16(src, dst, width, shift))
+            continue;
+
+        for (size_t x = 0; x < width; x++)
+        {
+            dst[x] = uint16_t(src[x] << shift);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+void planarN_to_planar16_MP(size_t width, size_t height, const uint16_t* inBuf, size_t inStride, uint16_t* outBuf, size_t outStride,
+                            int bits)
+{
+    HOP_PROF_FUNC();
+
+    forEachDPXBand(height,
+                   [&](size_t y0, size_t y1)
+                   {
+                       planarN_to_planar16(width, y1 - y0, dpxRow(inBuf, y0, inStride), inStride, dpxRow(outBuf, y0, outStride),
+                                           outStride, bits);
+                   });
+}
@@ -484,6 +484,8 @@ namespace TwkFB
                 }
             }
 
+            m_dataOwner.reset();
+
             if (m_allocSize || data)
             {
                 m_data = data ? data : (unsigned char*)allocateLargeBlock(m_allocSize);
@@ -774,6 +776,7 @@ namespace TwkFB
             }
         }
 
+        m_dataOwner.reset();
         clearAttributes();
     }
 
@@ -1999,6 +2002,7 @@ namespace TwkFB
                     const_cast<FrameBuffer*>(fb)->pixels<unsigned char>(), &fb->channelNames(), fb->orientation(), false,
                     fb->extraScanlines(), fb->scanlinePixelPadding());
 
+        m_dataOwner = fb->m_dataOwner;
         fb->copyAttributesTo(this);
         setPixelAspectRatio(fb->pixelAspectRatio());
         if (isRootPlane())
@@ -2415,11 +2419,25 @@ namespace TwkFB
         memcpy(data, m_data, m_allocSize);
         m_data = data;
         m_deleteDataOnDestruction = true;
+        m_dataOwner.reset();
 
         if (nextPlane())
             nextPlane()->ownData();
     }
 
+    FrameBuffer::DataOwner::~DataOwner() {}
+
+    void FrameBuffer::setDataOwner(const DataOwnerPtr& owner)
+    {
+        m_dataOwner = owner;
+
+        if (owner)
+        {
+            m_deleteDataOnDestruction = false;
+            m_deletePointer = 0;
+        }
+    }
+
     void FrameBuffer::relinquishDataAndReset()
     {
         assert(m_data != (unsigned char*)0xdeadc0de);
@@ -2436,6 +2454,51 @@ namespace TwkFB
         return;
     }
 
+    void FrameBuffer::releaseData()
+    {
+        assert(m_deleteDataOnDestruction || m_dataOwner);
+
+        if (m_dataOwner)
+        {
+            m_dataOwner.reset();
+            m_data = 0;
+            m_deletePointer = 0;
+        }
+        else if (m_deleteDataOnDestruction)
+        {
+            if (m_deletePointer)
+            {
+                deallocateLargeBlock(m_deletePointer);
+            }
+            else if (m_data)
+            {
+                deallocateLargeBlock(m_data);
+            }
+
+            m_data = 0;
+            m_deletePointer = 0;
+        }
+
+        if (nextPlane())
+            nextPlane()->releaseData();
+    }
+
+    void FrameBuffer::reallocateData()
+    {
+        if (!m_data && m_allocSize)
+        {
+            m_data = (unsigned char*)allocateLargeBlock(m_allocSize);
+
+            if (!m_data)
+                TWK_THROW_STREAM(IOException, "Out of memory");
+
+            m_deleteDataOnDestruction = true;
+        }
+
+        if (nextPlane())
+            nextPlane()->reallocateData();
+    }
+
     void FrameBuffer::appendPlane(FrameBuffer* fb)
     {
         if (!fb)
@@ -2514,6 +2577,7 @@ namespace TwkFB
         restructure(fb->width(), fb->height(), fb->depth(), fb->numChannels(), fb->dataType(), fb->pixels<unsigned char>(),
                     &fb->channelNames(), fb->orientation(), false);
 
+        m_dataOwner = fb->m_dataOwner;
         fb->copyAttributesTo(this);
         if (isRootPlane())
             setIdentifier(fb->identifier());
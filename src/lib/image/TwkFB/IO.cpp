@@ -16,6 +16,7 @@
 #include <dlfcn.h>
 #include <sys/types.h>
 #include <mutex>
+#include <cmath>
 
 /* AJG - stricmp */
 #ifdef _MSC_VER
@@ -104,6 +105,86 @@ namespace TwkFB
 
     FrameBufferIO::~FrameBufferIO() {}
 
+    int FrameBufferIO::ReadRequest::reductionLevel(int maxLevel) const
+    {
+        int level = 0;
+
+        if (hasResolution())
+        {
+            while (level < maxLevel && std::ldexp(1.0f, -(level + 1)) >= resolution)
+                level++;
+        }
+
+        return level;
+    }
+
+    bool FrameBufferIO::ReadRequest::regionAtLevel(int level, int width, int height, int& rx0, int& ry0, int& rx1, int& ry1) const
+    {
+        rx0 = 0;
+        ry0 = 0;
+        rx1 = width;
+        ry1 = height;
+
+        if (hasRegion())
+        {
+            const int s = 1 << level;
+            rx0 = std::max(rx0, x0 / s);
+            ry0 = std::max(ry0, y0 / s);
+            rx1 = std::min(rx1, (x1 + s - 1) / s);
+            ry1 = std::min(ry1, (y1 + s - 1) / s);
+        }
+
+        return rx1 > rx0 && ry1 > ry0;
+    }
+
+    string FrameBufferIO::ReadRequest::subsetIdentifier() const
+    {
+        if (!hasResolution() && !hasRegion() && consumedChannels.empty())
+            return "";
+
+        ostringstream str;
+        if (hasResolution())
+            str << "@r" << resolution;
+        if (hasRegion())
+            str << "@" << x0 << "," << y0 << "-" << x1 << "," << y1;
+
+        if (!consumedChannels.empty())
+        {
+            //
+            //  Same set, same identifier
+            //
+
+            StringVector names = consumedChannels;
+            sort(names.begin(), names.end());
+            names.erase(unique(names.begin(), names.end()), names.end());
+
+            str << "@c";
+            for (size_t i = 0; i < names.size(); i++)
+                str << (i ? "," : "") << names[i];
+        }
+
+        return str.str();
+    }
+
+    bool FrameBufferIO::ReadRequest::consumesChannel(const string& name) const
+    {
+        if (consumedChannels.empty())
+            return true;
+
+        const bool qualified = name.find('.') != string::npos;
+        const string base = name.substr(name.rfind('.') + 1);
+
+        for (size_t i = 0; i < consumedChannels.size(); i++)
+        {
+            const string& c = consumedChannels[i];
+
+            if (c == name || c == base || (!qualified && c.substr(c.rfind('.') + 1) == name))
+                return true;
+        }
+
+        return false;
+    }
+
     void FrameBufferIO::addType(const std::string& e, const std::string& d, unsigned int c) { m_exts.push_back(ImageTypeInfo(e, d, c)); }
 
     void FrameBufferIO::addType(const std::string& e, const std::string& d, unsigned int c, const StringPairVector& comps)
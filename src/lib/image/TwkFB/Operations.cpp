@@ -8,6 +8,8 @@
 
 #include <TwkFB/Operations.h>
 #include <TwkFB/FrameBuffer.h>
+#include <TwkFB/SIMDKernels.h>
+#include <TwkFB/TwkFBThreadPool.h>
 
 #include <ImfRgbaYca.h>
 #include <ImfChromaticities.h>
@@ -25,9 +27,11 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <half.h>
 #include <limits>
+#include <mutex>
 #include <string.h>
 
 namespace TwkFB
@@ -93,6 +97,35 @@ namespace TwkFB
 
         template <> unsigned int roundingCenter<unsigned int, unsigned char>() { return 0xffffff / 2; }
 
+        //
+        //  Calls f(row0, row1) over bands of [0, nrows) on the TwkFB
+        //  thread pool. A band is at least minBandBytes worth of rowBytes
+        //  rows (the bytes read and written per row) so small images and
+        //  crops are done by the caller without paying for the tasks.
+        //
+
+        const size_t minBandBytes = 256 * 1024;
+
+        void parallelRows(size_t nrows, size_t rowBytes, const ThreadPool::RangeFunction& f)
+        {
+            const size_t grain = std::max(minBandBytes / std::max(rowBytes, size_t(1)), size_t(1));
+            ThreadPool::parallelFor(0, nrows, grain, f);
+        }
+
+        //
+        //  The value types SIMD::convert() has kernels for
+        //
+
+        template <typename T> SIMD::ValueType simdType() { return SIMD::NumValueTypes; }
+
+        template <> SIMD::ValueType simdType<unsigned char>() { return SIMD::U8; }
+
+        template <> SIMD::ValueType simdType<unsigned short>() { return SIMD::U16; }
+
+        template <> SIMD::ValueType simdType<half>() { return SIMD::Half; }
+
+        template <> SIMD::ValueType simdType<float>() { return SIMD::Float; }
+
         //
         //  Specialized copy functions. These are scanline based in case the
         //  fb has scanline padding (presumably for alignment) at some point
@@ -100,14 +133,15 @@ namespace TwkFB
         //  and sequence viewing so optimization here is a good thing.
         //
 
-        template <typename A, typename B> void copyFloatingToFloating(const FrameBuffer* a, FrameBuffer* b)
+        template <typename A, typename B> void copyFloatingToFloating(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const A* in = a->pixels<A>();
-            const A* end = in + a->numChannels() * w * h * d;
-            B* out = b->pixels<B>();
+            const size_t n = a->numChannels() * a->width();
+            const A* in = a->pixels<A>() + n * row0;
+            const A* end = a->pixels<A>() + n * row1;
+            B* out = b->pixels<B>() + n * row0;
+
+            if (SIMD::convert(simdType<A>(), in, simdType<B>(), out, end - in))
+                return;
 
             for (; in < end; in++, out++)
             {
@@ -115,16 +149,14 @@ namespace TwkFB
             }
         }
 
-        template <typename A, typename B> void copyIntegralToIntegral(const FrameBuffer* a, FrameBuffer* b)
+        template <typename A, typename B> void copyIntegralToIntegral(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
             const size_t adigits = numeric_limits<A>::digits;
             const size_t bdigits = numeric_limits<B>::digits;
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const A* in = a->pixels<A>();
-            const A* end = in + a->numChannels() * w * h * d;
-            B* out = b->pixels<B>();
+            const size_t n = a->numChannels() * a->width();
+            const A* in = a->pixels<A>() + n * row0;
+            const A* end = a->pixels<A>() + n * row1;
+            B* out = b->pixels<B>() + n * row0;
 
             if (adigits > bdigits)
             {
@@ -152,14 +184,15 @@ namespace TwkFB
             }
         }
 
-        template <typename I, typename F> void copyIntegralToFloating(const FrameBuffer* a, FrameBuffer* b)
+        template <typename I, typename F> void copyIntegralToFloating(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const I* in = a->pixels<I>();
-            const I* end = in + a->numChannels() * w * h * d;
-            F* out = b->pixels<F>();
+            const size_t n = a->numChannels() * a->width();
+            const I* in = a->pixels<I>() + n * row0;
+            const I* end = a->pixels<I>() + n * row1;
+            F* out = b->pixels<F>() + n * row0;
+
+            if (SIMD::convert(simdType<I>(), in, simdType<F>(), out, end - in))
+                return;
 
             // For the UINT 32bit case, just pass through the value.
             if (numeric_limits<I>::digits == 32)
@@ -178,15 +211,16 @@ namespace TwkFB
             }
         }
 
-        template <typename F, typename I> void copyFloatingToIntegral(const FrameBuffer* a, FrameBuffer* b)
+        template <typename F, typename I> void copyFloatingToIntegral(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
             const double slop = roundingSlop<F, I>();
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const F* in = a->pixels<F>();
-            const F* end = in + a->numChannels() * w * h * d;
-            I* out = b->pixels<I>();
+            const size_t n = a->numChannels() * a->width();
+            const F* in = a->pixels<F>() + n * row0;
+            const F* end = a->pixels<F>() + n * row1;
+            I* out = b->pixels<I>() + n * row0;
+
+            if (SIMD::convert(simdType<F>(), in, simdType<I>(), out, end - in))
+                return;
 
             // For the UINT 32bit case, just pass through the value.
             if (numeric_limits<I>::digits == 32)
@@ -205,14 +239,11 @@ namespace TwkFB
             }
         }
 
-        template <typename F, typename P> void copyIntegral10BitToFloating(const FrameBuffer* a, FrameBuffer* b)
+        template <typename F, typename P> void copyIntegral10BitToFloating(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const F* in = a->pixels<F>();
-            const F* end = in + w * h * d;
-            P* out = b->pixels<P>();
+            const F* in = a->pixels<F>() + a->width() * row0;
+            const F* end = a->pixels<F>() + a->width() * row1;
+            P* out = b->pixels<P>() + 3 * a->width() * row0;
 
             for (; in < end; in++)
             {
@@ -230,15 +261,12 @@ namespace TwkFB
             }
         }
 
-        template <typename F, typename P> void copyFloatingToIntegral10Bit(const FrameBuffer* a, FrameBuffer* b)
+        template <typename F, typename P> void copyFloatingToIntegral10Bit(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
             const double slop = 1.0 / 1023.0 / 2.0;
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const F* in = a->pixels<F>();
-            const F* end = in + a->numChannels() * w * h * d;
-            P* out = b->pixels<P>();
+            const F* in = a->pixels<F>() + a->numChannels() * a->width() * row0;
+            const F* end = a->pixels<F>() + a->numChannels() * a->width() * row1;
+            P* out = b->pixels<P>() + a->width() * row0;
 
             for (; in < end; out++)
             {
@@ -251,16 +279,13 @@ namespace TwkFB
             }
         }
 
-        template <typename B, typename P> void copyIntegral10BitToIntegral(const FrameBuffer* a, FrameBuffer* b)
+        template <typename B, typename P> void copyIntegral10BitToIntegral(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
             const size_t adigits = 10;
             const size_t bdigits = numeric_limits<P>::digits;
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const B* in = a->pixels<B>();
-            const B* end = in + w * h * d;
-            P* out = b->pixels<P>();
+            const B* in = a->pixels<B>() + a->width() * row0;
+            const B* end = a->pixels<B>() + a->width() * row1;
+            P* out = b->pixels<P>() + 3 * a->width() * row0;
 
             const int bits = ((bdigits < adigits) ? 0 : ((int)bdigits - (int)adigits));
 
@@ -275,14 +300,12 @@ namespace TwkFB
             }
         }
 
-        template <> void copyIntegral10BitToIntegral<unsigned char, Pixel10>(const FrameBuffer* a, FrameBuffer* b)
+        template <>
+        void copyIntegral10BitToIntegral<unsigned char, Pixel10>(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const Pixel10* in = a->pixels<Pixel10>();
-            const Pixel10* end = in + w * h * d;
-            unsigned char* out = b->pixels<unsigned char>();
+            const Pixel10* in = a->pixels<Pixel10>() + a->width() * row0;
+            const Pixel10* end = a->pixels<Pixel10>() + a->width() * row1;
+            unsigned char* out = b->pixels<unsigned char>() + 3 * a->width() * row0;
 
             for (; in < end; in++)
             {
@@ -295,14 +318,12 @@ namespace TwkFB
             }
         }
 
-        template <> void copyIntegral10BitToIntegral<unsigned char, Pixel10Rev>(const FrameBuffer* a, FrameBuffer* b)
+        template <>
+        void copyIntegral10BitToIntegral<unsigned char, Pixel10Rev>(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
-            const size_t w = a->width();
-            const size_t h = a->height();
-            const size_t d = a->depth() == 0 ? 1 : a->depth();
-            const Pixel10Rev* in = a->pixels<Pixel10Rev>();
-            const Pixel10Rev* end = in + w * h * d;
-            unsigned char* out = b->pixels<unsigned char>();
+            const Pixel10Rev* in = a->pixels<Pixel10Rev>() + a->width() * row0;
+            const Pixel10Rev* end = a->pixels<Pixel10Rev>() + a->width() * row1;
+            unsigned char* out = b->pixels<unsigned char>() + 3 * a->width() * row0;
 
             for (; in < end; in++)
             {
@@ -317,247 +338,288 @@ namespace TwkFB
 
     } // namespace
 
-    //
-    //  General copy
-    //
-
-    void copyPlane(const FrameBuffer* a, FrameBuffer* b)
+    namespace
     {
-        assert(a->width() == b->width() && a->height() == b->height());
-
-        int numColorsA = (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2 || a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10
-                          || a->dataType() == FrameBuffer::PACKED_Y8_Cb8_Y8_Cr8 || a->dataType() == FrameBuffer::PACKED_Cb8_Y8_Cr8_Y8)
-                             ? 3
-                             : a->numChannels();
-
-        int numColorsB = (b->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2 || a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10
-                          || b->dataType() == FrameBuffer::PACKED_Y8_Cb8_Y8_Cr8 || b->dataType() == FrameBuffer::PACKED_Cb8_Y8_Cr8_Y8)
-                             ? 3
-                             : a->numChannels();
 
-        assert(numColorsA == numColorsB);
-
-        bool fallback = false;
+        //
+        //  Copies rows [row0, row1) of a plane, counting the rows of
+        //  every depth slice. Returns false if there's no specialized
+        //  copy between the two types.
+        //
 
-        if (a->dataType() == b->dataType())
+        bool copyPlaneRows(const FrameBuffer* a, FrameBuffer* b, size_t row0, size_t row1)
         {
-            memcpy(b->pixels<unsigned char>(), a->pixels<unsigned char>(), a->dataSize());
-        }
-        else if (b->dataType() == FrameBuffer::UCHAR)
-        {
-            if (a->dataType() == FrameBuffer::HALF)
-            {
-                copyFloatingToIntegral<half, uchar>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::FLOAT)
-            {
-                copyFloatingToIntegral<float, uchar>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::USHORT)
-            {
-                copyIntegralToIntegral<ushort, uchar>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::UINT)
-            {
-                copyIntegralToIntegral<uint32, uchar>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
-            {
-                copyIntegral10BitToIntegral<Pixel10, uchar>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
-            {
-                copyIntegral10BitToIntegral<Pixel10Rev, uchar>(a, b);
-            }
-            else
-            {
-                fallback = true;
-            }
-        }
-        else if (b->dataType() == FrameBuffer::USHORT)
-        {
-            if (a->dataType() == FrameBuffer::HALF)
-            {
-                copyFloatingToIntegral<half, ushort>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::FLOAT)
-            {
-                copyFloatingToIntegral<float, ushort>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::USHORT)
-            {
-                copyIntegralToIntegral<ushort, ushort>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
-            {
-                copyIntegral10BitToIntegral<Pixel10, ushort>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
-            {
-                copyIntegral10BitToIntegral<Pixel10Rev, ushort>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::UINT)
-            {
-                copyIntegralToIntegral<uint32, ushort>(a, b);
-            }
-            else
-            {
-                fallback = true;
-            }
-        }
-        else if (b->dataType() == FrameBuffer::UINT)
-        {
-            if (a->dataType() == FrameBuffer::HALF)
-            {
-                copyFloatingToIntegral<half, uint32>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::FLOAT)
-            {
-                copyFloatingToIntegral<float, uint32>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::USHORT)
-            {
-                copyIntegralToIntegral<ushort, uint32>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
-            {
-                copyIntegral10BitToIntegral<Pixel10, uint32>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
-            {
-                copyIntegral10BitToIntegral<Pixel10, uint32>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::UINT)
-            {
-                copyIntegralToIntegral<uint32, uint32>(a, b);
-            }
-            else
-            {
-                fallback = true;
-            }
-        }
-        else if (b->dataType() == FrameBuffer::HALF)
-        {
-            if (a->dataType() == FrameBuffer::UCHAR)
-            {
-                copyIntegralToFloating<uchar, half>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::USHORT)
-            {
-                copyIntegralToFloating<ushort, half>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::FLOAT)
-            {
-                copyFloatingToFloating<float, half>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
-            {
-                copyIntegral10BitToFloating<Pixel10, half>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
-            {
-                copyIntegral10BitToFloating<Pixel10Rev, half>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::UINT)
-            {
-                copyIntegralToFloating<uint32, half>(a, b);
-            }
-            else
-            {
-                fallback = true;
-            }
-        }
-        else if (b->dataType() == FrameBuffer::FLOAT)
-        {
-            if (a->dataType() == FrameBuffer::HALF)
-            {
-                copyFloatingToFloating<half, float>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::UCHAR)
-            {
-                copyIntegralToFloating<uchar, float>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::USHORT)
+            bool fallback = false;
+
+            if (b->dataType() == FrameBuffer::UCHAR)
             {
-                copyIntegralToFloating<ushort, float>(a, b);
+                if (a->dataType() == FrameBuffer::HALF)
+                {
+                    copyFloatingToIntegral<half, uchar>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::FLOAT)
+                {
+                    copyFloatingToIntegral<float, uchar>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::USHORT)
+                {
+                    copyIntegralToIntegral<ushort, uchar>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::UINT)
+                {
+                    copyIntegralToIntegral<uint32, uchar>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
+                {
+                    copyIntegral10BitToIntegral<Pixel10, uchar>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
+                {
+                    copyIntegral10BitToIntegral<Pixel10Rev, uchar>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
-            else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
+            else if (b->dataType() == FrameBuffer::USHORT)
             {
-                copyIntegral10BitToFloating<Pixel10, float>(a, b);
+                if (a->dataType() == FrameBuffer::HALF)
+                {
+                    copyFloatingToIntegral<half, ushort>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::FLOAT)
+                {
+                    copyFloatingToIntegral<float, ushort>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::USHORT)
+                {
+                    copyIntegralToIntegral<ushort, ushort>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
+                {
+                    copyIntegral10BitToIntegral<Pixel10, ushort>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
+                {
+                    copyIntegral10BitToIntegral<Pixel10Rev, ushort>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::UINT)
+                {
+                    copyIntegralToIntegral<uint32, ushort>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
-            else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
+            else if (b->dataType() == FrameBuffer::UINT)
             {
-                copyIntegral10BitToFloating<Pixel10Rev, float>(a, b);
+                if (a->dataType() == FrameBuffer::HALF)
+                {
+                    copyFloatingToIntegral<half, uint32>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::FLOAT)
+                {
+                    copyFloatingToIntegral<float, uint32>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::USHORT)
+                {
+                    copyIntegralToIntegral<ushort, uint32>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
+                {
+                    copyIntegral10BitToIntegral<Pixel10, uint32>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
+                {
+                    copyIntegral10BitToIntegral<Pixel10, uint32>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::UINT)
+                {
+                    copyIntegralToIntegral<uint32, uint32>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
-            else if (a->dataType() == FrameBuffer::UINT)
+            else if (b->dataType() == FrameBuffer::HALF)
             {
-                copyIntegralToFloating<uint32, float>(a, b);
+                if (a->dataType() == FrameBuffer::UCHAR)
+                {
+                    copyIntegralToFloating<uchar, half>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::USHORT)
+                {
+                    copyIntegralToFloating<ushort, half>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::FLOAT)
+                {
+                    copyFloatingToFloating<float, half>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
+                {
+                    copyIntegral10BitToFloating<Pixel10, half>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
+                {
+                    copyIntegral10BitToFloating<Pixel10Rev, half>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::UINT)
+                {
+                    copyIntegralToFloating<uint32, half>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
-            else
+            else if (b->dataType() == FrameBuffer::FLOAT)
             {
-                fallback = true;
+                if (a->dataType() == FrameBuffer::HALF)
+                {
+                    copyFloatingToFloating<half, float>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::UCHAR)
+                {
+                    copyIntegralToFloating<uchar, float>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::USHORT)
+                {
+                    copyIntegralToFloating<ushort, float>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
+                {
+                    copyIntegral10BitToFloating<Pixel10, float>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
+                {
+                    copyIntegral10BitToFloating<Pixel10Rev, float>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::UINT)
+                {
+                    copyIntegralToFloating<uint32, float>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
-        }
-        else if (b->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
-        {
-            if (a->dataType() == FrameBuffer::HALF)
+            else if (b->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2)
             {
-                copyFloatingToIntegral10Bit<half, Pixel10>(a, b);
+                if (a->dataType() == FrameBuffer::HALF)
+                {
+                    copyFloatingToIntegral10Bit<half, Pixel10>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::FLOAT)
+                {
+                    copyFloatingToIntegral10Bit<float, Pixel10>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
-            else if (a->dataType() == FrameBuffer::FLOAT)
+            else if (b->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
             {
-                copyFloatingToIntegral10Bit<float, Pixel10>(a, b);
+                if (a->dataType() == FrameBuffer::HALF)
+                {
+                    copyFloatingToIntegral10Bit<half, Pixel10Rev>(a, b, row0, row1);
+                }
+                else if (a->dataType() == FrameBuffer::FLOAT)
+                {
+                    copyFloatingToIntegral10Bit<float, Pixel10Rev>(a, b, row0, row1);
+                }
+                else
+                {
+                    fallback = true;
+                }
             }
             else
             {
                 fallback = true;
             }
+
+            return !fallback;
         }
-        else if (b->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10)
-        {
-            if (a->dataType() == FrameBuffer::HALF)
-            {
-                copyFloatingToIntegral10Bit<half, Pixel10Rev>(a, b);
-            }
-            else if (a->dataType() == FrameBuffer::FLOAT)
-            {
-                copyFloatingToIntegral10Bit<float, Pixel10Rev>(a, b);
-            }
-            else
-            {
-                fallback = true;
-            }
+
+    } // namespace
+
+    //
+    //  General copy
+    //
+
+    void copyPlane(const FrameBuffer* a, FrameBuffer* b)
+    {
+        assert(a->width() == b->width() && a->height() == b->height());
+
+        int numColorsA = (a->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2 || a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10
+                          || a->dataType() == FrameBuffer::PACKED_Y8_Cb8_Y8_Cr8 || a->dataType() == FrameBuffer::PACKED_Cb8_Y8_Cr8_Y8)
+                             ? 3
+                             : a->numChannels();
+
+        int numColorsB = (b->dataType() == FrameBuffer::PACKED_R10_G10_B10_X2 || a->dataType() == FrameBuffer::PACKED_X2_B10_G10_R10
+                          || b->dataType() == FrameBuffer::PACKED_Y8_Cb8_Y8_Cr8 || b->dataType() == FrameBuffer::PACKED_Cb8_Y8_Cr8_Y8)
+                             ? 3
+                             : a->numChannels();
+
+        assert(numColorsA == numColorsB);
+
+        bool fallback = false;
+
+        if (a->dataType() == b->dataType())
+        {
+            memcpy(b->pixels<unsigned char>(), a->pixels<unsigned char>(), a->dataSize());
         }
         else
         {
-            fallback = true;
+            const size_t d = a->depth() == 0 ? 1 : a->depth();
+            atomic<bool> copied(true);
+
+            parallelRows(a->height() * d, a->scanlineSize() + b->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             if (!copyPlaneRows(a, b, row0, row1))
+                                 copied = false;
+                         });
+
+            fallback = !copied;
         }
 
         if (fallback)
         {
             if (a->numChannels() == 3)
             {
-                for (int y = 0; y < b->height(); y++)
-                {
-                    for (int x = 0; x < b->width(); x++)
-                    {
-                        float p[4];
-                        a->getPixel4f(x, y, p);
-                        b->setPixel3f(p[0], p[1], p[2], x, y);
-                    }
-                }
+                parallelRows(b->height(), a->scanlineSize() + b->scanlineSize(),
+                             [&](size_t row0, size_t row1)
+                             {
+                                 for (int y = int(row0); y < int(row1); y++)
+                                 {
+                                     for (int x = 0; x < b->width(); x++)
+                                     {
+                                         float p[4];
+                                         a->getPixel4f(x, y, p);
+                                         b->setPixel3f(p[0], p[1], p[2], x, y);
+                                     }
+                                 }
+                             });
             }
             else if (a->numChannels() == 4)
             {
-                for (int y = 0; y < b->height(); y++)
-                {
-                    for (int x = 0; x < b->width(); x++)
-                    {
-                        float p[4];
-                        a->getPixel4f(x, y, p);
-                        b->setPixel4f(p[0], p[1], p[2], p[3], x, y);
-                    }
-                }
+                parallelRows(b->height(), a->scanlineSize() + b->scanlineSize(),
+                             [&](size_t row0, size_t row1)
+                             {
+                                 for (int y = int(row0); y < int(row1); y++)
+                                 {
+                                     for (int x = 0; x < b->width(); x++)
+                                     {
+                                         float p[4];
+                                         a->getPixel4f(x, y, p);
+                                         b->setPixel4f(p[0], p[1], p[2], p[3], x, y);
+                                     }
+                                 }
+                             });
             }
             else
             {
@@ -657,31 +719,47 @@ namespace TwkFB
     namespace
     {
 
+        //
+        //  Calls F on the scanline, or its SIMD kernel if it has one
+        //
+
+        void batchTransform(ColorTransformFunc F, float* scanline, int nchannels, int nelements, void* data);
+
         template <typename A, typename B>
         void applyFloatingToFloating(const FrameBuffer* a, FrameBuffer* b, ColorTransformFunc F, void* data)
         {
             unsigned int n = a->width() * a->numChannels();
             unsigned int nrow = a->height();
 
-            vector<float> scanline(n);
-
-            for (int row = 0; row < nrow; row++)
-            {
-                const A* ap = a->FrameBuffer::scanline<A>(row);
-                B* bp = b->FrameBuffer::scanline<B>(row);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, ap++)
-                {
-                    *fp = float(*ap);
-                }
-
-                F(&scanline.front(), &scanline.front(), a->numChannels(), a->width(), data);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
-                {
-                    *bp = B(*fp);
-                }
-            }
+            parallelRows(nrow, a->scanlineSize() + b->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<float> scanline(n);
+
+                             for (int row = int(row0); row < int(row1); row++)
+                             {
+                                 const A* ap = a->FrameBuffer::scanline<A>(row);
+                                 B* bp = b->FrameBuffer::scanline<B>(row);
+
+                                 if (!SIMD::convert(simdType<A>(), ap, SIMD::Float, &scanline.front(), n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, ap++)
+                                     {
+                                         *fp = float(*ap);
+                                     }
+                                 }
+
+                                 batchTransform(F, &scanline.front(), a->numChannels(), a->width(), data);
+
+                                 if (!SIMD::convert(SIMD::Float, &scanline.front(), simdType<B>(), bp, n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
+                                     {
+                                         *bp = B(*fp);
+                                     }
+                                 }
+                             }
+                         });
         }
 
         template <typename P> void applyIntegral10ToIntegral10(const FrameBuffer* a, FrameBuffer* b, ColorTransformFunc F, void* data)
@@ -690,39 +768,44 @@ namespace TwkFB
             unsigned int n = a->width() * 3;
             unsigned int nrow = a->height();
 
-            vector<float> scanline(n);
             float slop = 1.0 / 1023.0 / 2.0;
 
-            for (int row = 0; row < nrow; row++)
-            {
-                const P* ap = a->FrameBuffer::scanline<P>(row);
-                P* bp = b->FrameBuffer::scanline<P>(row);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; ap++)
-                {
-                    *fp = ap->red / 1023.0f;
-                    fp++;
-                    *fp = ap->green / 1023.0f;
-                    fp++;
-                    *fp = ap->blue / 1023.0f;
-                    fp++;
-                }
-
-                F(&scanline.front(), &scanline.front(), 3, a->width(), data);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; bp++)
-                {
-                    P p;
-                    p.red = int(clamp(*fp + slop, 0.0f, 1.0f) * 1023.0f);
-                    fp++;
-                    p.green = int(clamp(*fp + slop, 0.0f, 1.0f) * 1023.0f);
-                    fp++;
-                    p.blue = int(clamp(*fp + slop, 0.0f, 1.0f) * 1023.0f);
-                    fp++;
-
-                    *bp = p;
-                }
-            }
+            parallelRows(nrow, a->scanlineSize() + b->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<float> scanline(n);
+
+                             for (int row = int(row0); row < int(row1); row++)
+                             {
+                                 const P* ap = a->FrameBuffer::scanline<P>(row);
+                                 P* bp = b->FrameBuffer::scanline<P>(row);
+
+                                 for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; ap++)
+                                 {
+                                     *fp = ap->red / 1023.0f;
+                                     fp++;
+                                     *fp = ap->green / 1023.0f;
+                                     fp++;
+                                     *fp = ap->blue / 1023.0f;
+                                     fp++;
+                                 }
+
+                                 F(&scanline.front(), &scanline.front(), 3, a->width(), data);
+
+                                 for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; bp++)
+                                 {
+                                     P p;
+                                     p.red = int(clamp(*fp + slop, 0.0f, 1.0f) * 1023.0f);
+                                     fp++;
+                                     p.green = int(clamp(*fp + slop, 0.0f, 1.0f) * 1023.0f);
+                                     fp++;
+                                     p.blue = int(clamp(*fp + slop, 0.0f, 1.0f) * 1023.0f);
+                                     fp++;
+
+                                     *bp = p;
+                                 }
+                             }
+                         });
         }
 
         template <typename A, typename B>
@@ -736,25 +819,35 @@ namespace TwkFB
             float adiv = pow(2.0, double(numeric_limits<A>::digits)) - 1.0;
             float bmult = pow(2.0, double(numeric_limits<B>::digits)) - 1.0;
 
-            vector<float> scanline(n);
-
-            for (int row = 0; row < nrow; row++)
-            {
-                const A* ap = a->FrameBuffer::scanline<A>(row);
-                B* bp = b->FrameBuffer::scanline<B>(row);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, ap++)
-                {
-                    *fp = float(*ap) / adiv;
-                }
-
-                F(&scanline.front(), &scanline.front(), a->numChannels(), a->width(), data);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
-                {
-                    *bp = B(clamp(*fp, 0.0f, 1.0f) * bmult);
-                }
-            }
+            parallelRows(nrow, a->scanlineSize() + b->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<float> scanline(n);
+
+                             for (int row = int(row0); row < int(row1); row++)
+                             {
+                                 const A* ap = a->FrameBuffer::scanline<A>(row);
+                                 B* bp = b->FrameBuffer::scanline<B>(row);
+
+                                 if (!SIMD::convert(simdType<A>(), ap, SIMD::Float, &scanline.front(), n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, ap++)
+                                     {
+                                         *fp = float(*ap) / adiv;
+                                     }
+                                 }
+
+                                 batchTransform(F, &scanline.front(), a->numChannels(), a->width(), data);
+
+                                 if (!SIMD::convert(SIMD::Float, &scanline.front(), simdType<B>(), bp, n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
+                                     {
+                                         *bp = B(clamp(*fp, 0.0f, 1.0f) * bmult);
+                                     }
+                                 }
+                             }
+                         });
         }
 
         template <typename I, typename F>
@@ -764,32 +857,36 @@ namespace TwkFB
             unsigned int nrow = a->height();
 
             float adiv = pow(2.0, double(numeric_limits<I>::digits)) - 1.0;
-            vector<float> scanline(n);
-
-            for (int row = 0; row < nrow; row++)
-            {
-                const I* ap = a->FrameBuffer::scanline<I>(row);
-                F* bp = b->FrameBuffer::scanline<F>(row);
-
-                for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, ap++)
-                {
-                    *fp = float(*ap) / adiv;
-                }
-
-                if (numeric_limits<float>::digits == numeric_limits<F>::digits)
-                {
-                    C(&scanline.front(), &scanline.front(), a->numChannels(), a->width(), data);
-                }
-                else
-                {
-                    C(&scanline.front(), &scanline.front(), a->numChannels(), a->width(), data);
 
-                    for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
-                    {
-                        *bp = F(*fp);
-                    }
-                }
-            }
+            parallelRows(nrow, a->scanlineSize() + b->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<float> scanline(n);
+
+                             for (int row = int(row0); row < int(row1); row++)
+                             {
+                                 const I* ap = a->FrameBuffer::scanline<I>(row);
+                                 F* bp = b->FrameBuffer::scanline<F>(row);
+
+                                 if (!SIMD::convert(simdType<I>(), ap, SIMD::Float, &scanline.front(), n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, ap++)
+                                     {
+                                         *fp = float(*ap) / adiv;
+                                     }
+                                 }
+
+                                 batchTransform(C, &scanline.front(), a->numChannels(), a->width(), data);
+
+                                 if (!SIMD::convert(SIMD::Float, &scanline.front(), simdType<F>(), bp, n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
+                                     {
+                                         *bp = F(*fp);
+                                     }
+                                 }
+                             }
+                         });
         }
 
         template <typename F, typename I>
@@ -798,32 +895,38 @@ namespace TwkFB
             unsigned int n = a->width() * a->numChannels();
             unsigned int nrow = a->height();
             float bmult = pow(2.0, double(numeric_limits<I>::digits)) - 1.0;
-            vector<float> scanline(n);
 
-            for (int row = 0; row < nrow; row++)
-            {
-                const F* ap = a->FrameBuffer::scanline<F>(row);
-                I* bp = b->FrameBuffer::scanline<I>(row);
-                float* fp = &scanline.front();
+            parallelRows(nrow, a->scanlineSize() + b->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<float> scanline(n);
 
-                for (const F* ep = ap + n; ap < ep; ap++, fp++)
-                {
-                    *fp = *ap;
-                }
+                             for (int row = int(row0); row < int(row1); row++)
+                             {
+                                 const F* ap = a->FrameBuffer::scanline<F>(row);
+                                 I* bp = b->FrameBuffer::scanline<I>(row);
 
-                C(fp, fp, a->numChannels(), a->width(), data);
+                                 if (!SIMD::convert(simdType<F>(), ap, SIMD::Float, &scanline.front(), n))
+                                 {
+                                     float* fp = &scanline.front();
 
-                for (float* ep = fp + n; fp < ep; fp++, bp++)
-                {
-                    F v = *fp;
-                    if (v > 1.0f)
-                        v = 1.0f;
-                    else if (v < 0.0f)
-                        v = 0.0f;
+                                     for (const F* ep = ap + n; ap < ep; ap++, fp++)
+                                     {
+                                         *fp = *ap;
+                                     }
+                                 }
 
-                    *bp = I(clamp(*fp, 0.0f, 1.0f) * bmult + 0.49);
-                }
-            }
+                                 batchTransform(C, &scanline.front(), a->numChannels(), a->width(), data);
+
+                                 if (!SIMD::convert(SIMD::Float, &scanline.front(), simdType<I>(), bp, n))
+                                 {
+                                     for (float *fp = &scanline.front(), *ep = fp + n; fp < ep; fp++, bp++)
+                                     {
+                                         *bp = I(clamp(*fp, 0.0f, 1.0f) * bmult + 0.49);
+                                     }
+                                 }
+                             }
+                         });
         }
 
     } // namespace
@@ -1005,29 +1108,37 @@ namespace TwkFB
         {
             if (a->numChannels() <= 3)
             {
-                for (int y = 0; y < b->height(); y++)
-                {
-                    for (int x = 0; x < b->width(); x++)
-                    {
-                        float p[4];
-                        a->getPixel4f(x, y, p);
-                        F(p, p, 3, 1, data);
-                        b->setPixel3f(p[0], p[1], p[2], x, y);
-                    }
-                }
+                parallelRows(b->height(), a->scanlineSize() + b->scanlineSize(),
+                             [&](size_t row0, size_t row1)
+                             {
+                                 for (int y = int(row0); y < int(row1); y++)
+                                 {
+                                     for (int x = 0; x < b->width(); x++)
+                                     {
+                                         float p[4];
+                                         a->getPixel4f(x, y, p);
+                                         F(p, p, 3, 1, data);
+                                         b->setPixel3f(p[0], p[1], p[2], x, y);
+                                     }
+                                 }
+                             });
             }
             else if (a->numChannels() == 4)
             {
-                for (int y = 0; y < b->height(); y++)
-                {
-                    for (int x = 0; x < b->width(); x++)
-                    {
-                        float p[4];
-                        a->getPixel4f(x, y, p);
-                        F(p, p, 4, 1, data);
-                        b->setPixel4f(p[0], p[1], p[2], p[3], x, y);
-                    }
-                }
+                parallelRows(b->height(), a->scanlineSize() + b->scanlineSize(),
+                             [&](size_t row0, size_t row1)
+                             {
+                                 for (int y = int(row0); y < int(row1); y++)
+                                 {
+                                     for (int x = 0; x < b->width(); x++)
+                                     {
+                                         float p[4];
+                                         a->getPixel4f(x, y, p);
+                                         F(p, p, 4, 1, data);
+                                         b->setPixel4f(p[0], p[1], p[2], p[3], x, y);
+                                     }
+                                 }
+                             });
             }
             else
             {
@@ -1659,6 +1770,140 @@ namespace TwkFB
         }
     }
 
+    namespace
+    {
+
+        void batchTransform(ColorTransformFunc F, float* scanline, int nchannels, int nelements, void* data)
+        {
+            SIMD::TransformParams params;
+            SIMD::TransformKind kind = SIMD::NumTransformKinds;
+            bool* mask = 0;
+
+            for (int i = 0; i < 4; i++)
+            {
+                params.mask[i] = i < 3;
+                params.values[i] = 1.0f;
+            }
+
+            if (F == sRGBtoLinearTransform)
+            {
+                kind = SIMD::SRGBToLinear;
+                mask = reinterpret_cast<bool*>(data);
+            }
+            else if (F == linearToSRGBTransform)
+            {
+                kind = SIMD::LinearToSRGB;
+                mask = reinterpret_cast<bool*>(data);
+            }
+            else if (F == Rec709toLinearTransform)
+            {
+                kind = SIMD::Rec709ToLinear;
+                mask = reinterpret_cast<bool*>(data);
+            }
+            else if (F == linearToRec709Transform)
+            {
+                kind = SIMD::LinearToRec709;
+                mask = reinterpret_cast<bool*>(data);
+            }
+            else if (F == logLinearTransform || F == linearLogTransform)
+            {
+                kind = F == logLinearTransform ? SIMD::CineonLogToLinear : SIMD::LinearToCineonLog;
+                mask = reinterpret_cast<bool*>(data);
+                params.constants[0] = cinblack;
+                params.constants[1] = cinwbdiff;
+            }
+            else if (F == logCToLinearTransform)
+            {
+                //
+                //  Same derived constants as logCToLinearTransform()
+                //
+
+                const LogCTransformParams* p = reinterpret_cast<const LogCTransformParams*>(data);
+                const float eg = p->LogCEncodingGain;
+                const float eo = p->LogCEncodingOffset;
+                const float gs = p->LogCGraySignal;
+                const float X = gs / (eg * p->LogCLinearSlope);
+
+                kind = SIMD::LogCToLinear;
+                mask = p->chmap;
+                params.constants[0] = 1.0f / eg;
+                params.constants[1] = -eo / eg;
+                params.constants[2] = gs;
+                params.constants[3] = p->LogCBlackSignal - p->LogCBlackOffset * gs;
+                params.constants[4] = X;
+                params.constants[5] =
+                    -(eo + eg * (p->LogCLinearSlope * (p->LogCBlackOffset - p->LogCBlackSignal / gs) + p->LogCLinearOffset)) * X;
+                params.constants[6] = p->LogCLinearCutPoint;
+            }
+            else if (F == linearToLogCTransform)
+            {
+                const LogCTransformParams* p = reinterpret_cast<const LogCTransformParams*>(data);
+                const float eg = p->LogCEncodingGain;
+                const float eo = p->LogCEncodingOffset;
+
+                kind = SIMD::LinearToLogC;
+                mask = p->chmap;
+                params.constants[0] = p->LogCBlackOffset;
+                params.constants[1] = p->LogCBlackSignal;
+                params.constants[2] = p->LogCGraySignal;
+                params.constants[3] = p->LogCCutPoint;
+                params.constants[4] = p->LogCLinearSlope * eg;
+                params.constants[5] = p->LogCLinearOffset * eg + eo;
+                params.constants[6] = eg;
+                params.constants[7] = eo;
+            }
+            else if (F == gammaTransform || F == powerTransform)
+            {
+                const float* v = reinterpret_cast<const float*>(data);
+                kind = SIMD::Power;
+
+                for (int i = 0; i < 3; i++)
+                {
+                    params.values[i] = F == gammaTransform ? 1.0f / v[i] : v[i];
+
+                    //
+                    //  pow(0, e) isn't 0 for these, leave them to F
+                    //
+
+                    if (!(params.values[i] > 0.0f) || !isfinite(params.values[i]))
+                        kind = SIMD::NumTransformKinds;
+                }
+            }
+            else if (F == premultTransform)
+            {
+                kind = SIMD::Premult;
+            }
+            else if (F == unpremultTransform)
+            {
+                kind = SIMD::Unpremult;
+            }
+            else if (F == linearColorTransform)
+            {
+                const Mat44f& M = *reinterpret_cast<const Mat44f*>(data);
+                kind = SIMD::Matrix;
+
+                for (int r = 0; r < 4; r++)
+                {
+                    for (int c = 0; c < 4; c++)
+                        params.constants[r * 4 + c] = M[r][c];
+                }
+            }
+
+            if (mask)
+            {
+                for (int i = 0; i < 4; i++)
+                    params.mask[i] = i < nchannels && mask[i];
+            }
+
+            if (kind == SIMD::NumTransformKinds
+                || !SIMD::transform(kind, params, scanline, scanline, nchannels, nelements, F, data))
+            {
+                F(scanline, scanline, nchannels, nelements, data);
+            }
+        }
+
+    } // namespace
+
     void channelLUTTransform(const float* inPixels, float* outPixels, int channels, int nelements, void* data)
     {
         //
@@ -1985,30 +2230,37 @@ namespace TwkFB
         FrameBuffer* fnew =
             new FrameBuffer(f->coordinateType(), f->width(), f->height(), f->depth(), 3, d, 0, &names, f->orientation(), true);
 
+        void (*copyRows)(const FrameBuffer*, FrameBuffer*, size_t, size_t) = 0;
+
         switch (d)
         {
         case FrameBuffer::HALF:
-            copyIntegral10BitToFloating<P, half>(f, fnew);
+            copyRows = copyIntegral10BitToFloating<P, half>;
             break;
         case FrameBuffer::FLOAT:
-            copyIntegral10BitToFloating<P, float>(f, fnew);
+            copyRows = copyIntegral10BitToFloating<P, float>;
             break;
         case FrameBuffer::DOUBLE:
-            copyIntegral10BitToFloating<P, double>(f, fnew);
+            copyRows = copyIntegral10BitToFloating<P, double>;
             break;
         case FrameBuffer::UCHAR:
-            copyIntegral10BitToIntegral<P, unsigned char>(f, fnew);
+            copyRows = copyIntegral10BitToIntegral<P, unsigned char>;
             break;
         case FrameBuffer::USHORT:
-            copyIntegral10BitToIntegral<P, unsigned short>(f, fnew);
+            copyRows = copyIntegral10BitToIntegral<P, unsigned short>;
             break;
         case FrameBuffer::UINT:
-            copyIntegral10BitToIntegral<P, unsigned int>(f, fnew);
+            copyRows = copyIntegral10BitToIntegral<P, unsigned int>;
             break;
         default:
             abort();
         }
 
+        const size_t depth = f->depth() == 0 ? 1 : f->depth();
+
+        parallelRows(f->height() * depth, f->scanlineSize() + fnew->scanlineSize(),
+                     [&](size_t row0, size_t row1) { copyRows(f, fnew, row0, row1); });
+
         return fnew;
     }
 
@@ -2056,6 +2308,69 @@ namespace TwkFB
         return result;
     }
 
+    namespace
+    {
+
+        SIMD::ValueType simdType(FrameBuffer::DataType t)
+        {
+            switch (t)
+            {
+            case FrameBuffer::UCHAR:
+                return SIMD::U8;
+            case FrameBuffer::USHORT:
+                return SIMD::U16;
+            case FrameBuffer::HALF:
+                return SIMD::Half;
+            case FrameBuffer::FLOAT:
+                return SIMD::Float;
+            default:
+                return SIMD::NumValueTypes;
+            }
+        }
+
+        //
+        //  When both have the same channel order the per pixel
+        //  get/setPixel4f() in resample() is just a conversion of each
+        //  scanline. Returns false if it can't be done that way.
+        //
+
+        bool resampleScanlines(const FrameBuffer* a, FrameBuffer* b)
+        {
+            const SIMD::ValueType at = simdType(a->dataType());
+            const SIMD::ValueType bt = simdType(b->dataType());
+            const size_t nc = a->numChannels();
+
+            if (at == SIMD::NumValueTypes || bt == SIMD::NumValueTypes || nc > 4)
+                return false;
+
+            for (size_t i = 0; i < nc; i++)
+            {
+                if (a->pixel4Permute()[i] != b->pixel4Permute()[i])
+                    return false;
+            }
+
+            const size_t n = a->width() * nc;
+
+            //
+            //  Whether there's a kernel for the pair is the same for
+            //  every scanline so the first one answers it
+            //
+
+            if (b->height() == 0 || !SIMD::convert(at, a->scanline<unsigned char>(0), bt, b->scanline<unsigned char>(0), n))
+            {
+                return false;
+            }
+
+            for (int y = 1; y < b->height(); y++)
+            {
+                SIMD::convert(at, a->scanline<unsigned char>(y), bt, b->scanline<unsigned char>(y), n);
+            }
+
+            return true;
+        }
+
+    } // namespace
+
     void resample(const FrameBuffer* a, FrameBuffer* b)
     {
         for (; a && b; a = a->nextPlane(), b = b->nextPlane())
@@ -2068,7 +2383,7 @@ namespace TwkFB
             {
                 memcpy(b->pixels<unsigned char>(), a->pixels<unsigned char>(), a->scanlineSize() * a->height());
             }
-            else
+            else if (!resampleScanlines(a, b))
             {
                 for (int y = 0; y < b->height(); y++)
                 {
@@ -2103,25 +2418,40 @@ namespace TwkFB
             //  possibly ignore max value (shadow maps)
             //
 
-            for (int y = 0; y < fb->height(); y++)
-            {
-                // unsigned char* b = fb->scanline<unsigned char>(y);
-                unsigned char* b = getscanline(fb, y); // 3.2 compiler bug requires this
-                const unsigned char* e = b + fb->scanlineSize();
-                unsigned int count = 1; // 1 pulls computation out of mod below
-
-                for (const T* p = reinterpret_cast<const T*>(b); p < reinterpret_cast<const T*>(e); p++, count++)
-                {
-                    if (skipLast && (count % nc) == 0)
-                        continue;
-                    if (discardmax && *p >= maxval)
-                        continue;
-                    if (mx < *p)
-                        mx = *p;
-                    if (mn > *p)
-                        mn = *p;
-                }
-            }
+            mutex m;
+
+            parallelRows(fb->height(), fb->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             T bandmn = numeric_limits<T>::max();
+                             T bandmx = -bandmn;
+
+                             for (int y = int(row0); y < int(row1); y++)
+                             {
+                                 // unsigned char* b = fb->scanline<unsigned char>(y);
+                                 unsigned char* b = getscanline(fb, y); // 3.2 compiler bug requires this
+                                 const unsigned char* e = b + fb->scanlineSize();
+                                 unsigned int count = 1; // 1 pulls computation out of mod below
+
+                                 for (const T* p = reinterpret_cast<const T*>(b); p < reinterpret_cast<const T*>(e); p++, count++)
+                                 {
+                                     if (skipLast && (count % nc) == 0)
+                                         continue;
+                                     if (discardmax && *p >= maxval)
+                                         continue;
+                                     if (bandmx < *p)
+                                         bandmx = *p;
+                                     if (bandmn > *p)
+                                         bandmn = *p;
+                                 }
+                             }
+
+                             lock_guard<mutex> lock(m);
+                             if (mx < bandmx)
+                                 mx = bandmx;
+                             if (mn > bandmn)
+                                 mn = bandmn;
+                         });
 
             //
             //  Apply the normalization to the data
@@ -2129,32 +2459,36 @@ namespace TwkFB
 
             const T r = mx - mn;
 
-            for (int y = 0; y < fb->height(); y++)
-            {
-                // unsigned char* b = fb->scanline<unsigned char>(y);
-                unsigned char* b = getscanline(fb, y); // 3.2 compiler bug requires this
-                unsigned char* e = b + fb->scanlineSize();
-                unsigned int count = 1; // 1 pulls computation out of mod below
-
-                for (T* p = reinterpret_cast<T*>(b); p < reinterpret_cast<const T*>(e); p++, count++)
-                {
-                    if (skipLast && (count % nc) == 0)
-                        continue;
-
-                    if (discardmax && *p >= maxval)
-                    {
-                        *p = T(0);
-                    }
-                    else if (invert)
-                    {
-                        *p = T(1.0) - T(double(*p) / double(r) - double(mn) / double(r));
-                    }
-                    else
-                    {
-                        *p = T(double(*p) / double(r) - double(mn) / double(r));
-                    }
-                }
-            }
+            parallelRows(fb->height(), fb->scanlineSize() * 2,
+                         [&](size_t row0, size_t row1)
+                         {
+                             for (int y = int(row0); y < int(row1); y++)
+                             {
+                                 // unsigned char* b = fb->scanline<unsigned char>(y);
+                                 unsigned char* b = getscanline(fb, y); // 3.2 compiler bug requires this
+                                 unsigned char* e = b + fb->scanlineSize();
+                                 unsigned int count = 1; // 1 pulls computation out of mod below
+
+                                 for (T* p = reinterpret_cast<T*>(b); p < reinterpret_cast<const T*>(e); p++, count++)
+                                 {
+                                     if (skipLast && (count % nc) == 0)
+                                         continue;
+
+                                     if (discardmax && *p >= maxval)
+                                     {
+                                         *p = T(0);
+                                     }
+                                     else if (invert)
+                                     {
+                                         *p = T(1.0) - T(double(*p) / double(r) - double(mn) / double(r));
+                                     }
+                                     else
+                                     {
+                                         *p = T(double(*p) / double(r) - double(mn) / double(r));
+                                     }
+                                 }
+                             }
+                         });
 
             fb->newAttribute("NormalizedMax", mx);
             fb->newAttribute("NormalizedMin", mn);
@@ -2372,29 +2706,42 @@ namespace TwkFB
 
             const size_t chunkSize = out->pixelSize();
             const size_t pixelSize = in->pixelSize();
-            const unsigned char* inp = in->pixels<unsigned char>();
-            unsigned char* outp = out->pixels<unsigned char>();
 
-            for (const unsigned char* endp = inp + in->planeSize(); inp < endp; inp += pixelSize, outp += chunkSize)
-            {
-                memcpy(outp, inp, chunkSize);
-            }
+            parallelRows(in->height(), in->scanlineSize() + out->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             for (int y = int(row0); y < int(row1); y++)
+                             {
+                                 const unsigned char* inp = in->scanline<unsigned char>(y);
+                                 unsigned char* outp = out->scanline<unsigned char>(y);
+
+                                 for (const unsigned char* endp = inp + in->width() * pixelSize; inp < endp;
+                                      inp += pixelSize, outp += chunkSize)
+                                 {
+                                     memcpy(outp, inp, chunkSize);
+                                 }
+                             }
+                         });
         }
         else
         {
-            for (int y = 0; y < in->height(); y++)
-            {
-                for (int x = 0; x < in->width(); x++)
-                {
-                    unsigned char* p0 = &(in->pixel<unsigned char>(x, y));
-                    unsigned char* p1 = &(out->pixel<unsigned char>(x, y));
-
-                    for (int q = 0; q < cindex.size(); q++)
-                    {
-                        memcpy(p1 + q * b, p0 + cindex[q] * b, b);
-                    }
-                }
-            }
+            parallelRows(in->height(), in->scanlineSize() + out->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             for (int y = int(row0); y < int(row1); y++)
+                             {
+                                 for (int x = 0; x < in->width(); x++)
+                                 {
+                                     unsigned char* p0 = &(in->pixel<unsigned char>(x, y));
+                                     unsigned char* p1 = &(out->pixel<unsigned char>(x, y));
+
+                                     for (int q = 0; q < cindex.size(); q++)
+                                     {
+                                         memcpy(p1 + q * b, p0 + cindex[q] * b, b);
+                                     }
+                                 }
+                             }
+                         });
         }
 
         if (in1 != in)
@@ -2431,84 +2778,77 @@ namespace TwkFB
     // We'll discuss what 'applyGamma' means, but for now, this is silly :)
     void linearizeFromGamma(const FrameBuffer* a, FrameBuffer* b, float fromGamma) { applyGamma(a, b, fromGamma); }
 
-    template <class T> void minMaxInteger(const FrameBuffer* fb, std::vector<float>& mins, std::vector<float>& maxs)
+    namespace
     {
-        mins.resize(fb->numChannels());
-        maxs.resize(fb->numChannels());
-
-        const size_t nrow = fb->height();
-        const size_t nchannels = fb->numChannels();
-        const size_t scanlineSize = fb->scanlineSize() / sizeof(T);
-        const T maxValue = numeric_limits<T>::max();
-
-        fill(mins.begin(), mins.end(), numeric_limits<float>::max());
-        fill(maxs.begin(), maxs.end(), numeric_limits<float>::min());
 
-        for (int row = 0; row < nrow; row++)
-        {
-            const T* begin = reinterpret_cast<const T*>(getscanline(fb, row));
-            const T* end = begin + scanlineSize;
+        //
+        //  Per channel min and max of the values scaled by 1 / divisor
+        //  (the max of an integer type to normalize it)
+        //
 
-            for (int ch = 0; ch < nchannels; ch++)
-            {
-                float cmax = numeric_limits<float>::min();
-                float cmin = numeric_limits<float>::max();
+        template <class T> void minMaxRows(const FrameBuffer* fb, std::vector<float>& mins, std::vector<float>& maxs, double divisor)
+        {
+            const size_t nchannels = fb->numChannels();
+            const size_t scanlineSize = fb->scanlineSize() / sizeof(T);
+            mutex m;
+
+            mins.resize(nchannels);
+            maxs.resize(nchannels);
+            fill(mins.begin(), mins.end(), numeric_limits<float>::max());
+            fill(maxs.begin(), maxs.end(), -numeric_limits<float>::max());
+
+            parallelRows(fb->height(), fb->scanlineSize(),
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<float> bandmins(nchannels, numeric_limits<float>::max());
+                             vector<float> bandmaxs(nchannels, -numeric_limits<float>::max());
+
+                             for (int row = int(row0); row < int(row1); row++)
+                             {
+                                 const T* begin = reinterpret_cast<const T*>(getscanline(fb, row));
+                                 const T* end = begin + scanlineSize;
+
+                                 for (int ch = 0; ch < nchannels; ch++)
+                                 {
+                                     float cmax = bandmaxs[ch];
+                                     float cmin = bandmins[ch];
+
+                                     for (const T* p = begin + ch; p < end; p += nchannels)
+                                     {
+                                         float v = double(*p) / divisor;
+                                         if (v > cmax)
+                                             cmax = v;
+                                         if (v < cmin)
+                                             cmin = v;
+                                     }
+
+                                     bandmaxs[ch] = cmax;
+                                     bandmins[ch] = cmin;
+                                 }
+                             }
+
+                             lock_guard<mutex> lock(m);
+
+                             for (int ch = 0; ch < nchannels; ch++)
+                             {
+                                 if (mins[ch] > bandmins[ch])
+                                     mins[ch] = bandmins[ch];
+                                 if (maxs[ch] < bandmaxs[ch])
+                                     maxs[ch] = bandmaxs[ch];
+                             }
+                         });
+        }
 
-                for (const T* p = begin + ch; p < end; p += nchannels)
-                {
-                    float v = double(*p) / double(maxValue);
-                    if (v > cmax)
-                        cmax = v;
-                    if (v < cmin)
-                        cmin = v;
-                }
+    } // namespace
 
-                if (mins[ch] > cmin)
-                    mins[ch] = cmin;
-                if (maxs[ch] < cmax)
-                    maxs[ch] = cmax;
-            }
-        }
+    template <class T> void minMaxInteger(const FrameBuffer* fb, std::vector<float>& mins, std::vector<float>& maxs)
+    {
+        minMaxRows<T>(fb, mins, maxs, double(numeric_limits<T>::max()));
     }
 
-    template <class T> void minMaxFloat(const FrameBuffer* fb, std::vector<float> mins, std::vector<float> maxs)
+    template <class T> void minMaxFloat(const FrameBuffer* fb, std::vector<float>& mins, std::vector<float>& maxs)
     {
-        mins.resize(fb->numChannels());
-        maxs.resize(fb->numChannels());
-
-        const size_t nrow = fb->height();
-        const size_t nchannels = fb->numChannels();
-        const size_t scanlineSize = fb->scanlineSize() / sizeof(T);
-        const T maxValue = numeric_limits<T>::max();
-
-        fill(mins.begin(), mins.end(), numeric_limits<float>::max());
-        fill(maxs.begin(), maxs.end(), numeric_limits<float>::min());
-
-        for (int row = 0; row < nrow; row++)
-        {
-            const T* begin = reinterpret_cast<const T*>(getscanline(fb, row));
-            const T* end = begin + scanlineSize;
-
-            for (int ch = 0; ch < nchannels; ch++)
-            {
-                float cmax = numeric_limits<float>::min();
-                float cmin = numeric_limits<float>::max();
-
-                for (const T* p = begin + ch; p < end; p += nchannels)
-                {
-                    float v = *p;
-                    if (v > cmax)
-                        cmax = v;
-                    if (v < cmin)
-                        cmin = v;
-                }
-
-                if (mins[ch] > cmin)
-                    mins[ch] = cmin;
-                if (maxs[ch] < cmax)
-                    maxs[ch] = cmax;
-            }
-        }
+        minMaxRows<T>(fb, mins, maxs, 1.0);
     }
 
     void minMax(const FrameBuffer* fb, std::vector<float>& minValues, std::vector<float>& maxValues)
@@ -2543,16 +2883,26 @@ namespace TwkFB
         for (FrameBuffer* fb = flipMe->firstPlane(); fb; fb = fb->nextPlane())
         {
             int ymax = fb->height() - 1;
-            vector<unsigned char> temp(fb->scanlineSize());
 
-            for (int y = 0; y < (ymax + 1) / 2; y++)
-            {
-                memcpy(&temp.front(), fb->scanline<unsigned char>(y), fb->scanlineSize());
+            //
+            //  Each band swaps rows from the top half with their
+            //  mirror in the bottom half
+            //
 
-                memcpy(fb->scanline<unsigned char>(y), fb->scanline<unsigned char>(ymax - y), fb->scanlineSize());
+            parallelRows((ymax + 1) / 2, fb->scanlineSize() * 2,
+                         [&](size_t row0, size_t row1)
+                         {
+                             vector<unsigned char> temp(fb->scanlineSize());
 
-                memcpy(fb->scanline<unsigned char>(ymax - y), &temp.front(), fb->scanlineSize());
-            }
+                             for (int y = int(row0); y < int(row1); y++)
+                             {
+                                 memcpy(&temp.front(), fb->scanline<unsigned char>(y), fb->scanlineSize());
+
+                                 memcpy(fb->scanline<unsigned char>(y), fb->scanline<unsigned char>(ymax - y), fb->scanlineSize());
+
+                                 memcpy(fb->scanline<unsigned char>(ymax - y), &temp.front(), fb->scanlineSize());
+                             }
+                         });
         }
     }
 
@@ -2560,19 +2910,46 @@ namespace TwkFB
     {
         for (FrameBuffer* fb = flopMe->firstPlane(); fb; fb = fb->nextPlane())
         {
-            for (int y = 0; y < fb->height(); y++)
-            {
-                for (int x = 0; x < fb->width() / 2; x++)
-                {
-                    // SLOOOOOOW!
-                    float pLeft[4], pRight[4];
-                    fb->getPixel4f(x, y, pLeft);
-                    fb->getPixel4f(fb->width() - 1 - x, y, pRight);
+            //
+            //  When every pixel has its own bytes they can just be
+            //  swapped. The packed 4:2:2 types share chroma between
+            //  pixels so those go through get/setPixel4f().
+            //
 
-                    fb->setPixel4f(pRight[0], pRight[1], pRight[2], pRight[3], x, y);
-                    fb->setPixel4f(pLeft[0], pLeft[1], pLeft[2], pLeft[3], fb->width() - 1 - x, y);
-                }
-            }
+            const bool swapPixels = fb->dataType() >= FrameBuffer::UCHAR && fb->dataType() <= FrameBuffer::PACKED_X2_B10_G10_R10;
+            const size_t pixelSize = fb->pixelSize();
+
+            parallelRows(fb->height(), fb->scanlineSize() * 2,
+                         [&](size_t row0, size_t row1)
+                         {
+                             unsigned char temp[64];
+
+                             for (int y = int(row0); y < int(row1); y++)
+                             {
+                                 for (int x = 0; x < fb->width() / 2; x++)
+                                 {
+                                     if (swapPixels && pixelSize <= sizeof(temp))
+                                     {
+                                         unsigned char* pLeft = &(fb->pixel<unsigned char>(x, y));
+                                         unsigned char* pRight = &(fb->pixel<unsigned char>(fb->width() - 1 - x, y));
+
+                                         memcpy(temp, pLeft, pixelSize);
+                                         memcpy(pLeft, pRight, pixelSize);
+                                         memcpy(pRight, temp, pixelSize);
+                                     }
+                                     else
+                                     {
+                                         // SLOOOOOOW!
+                                         float pLeft[4], pRight[4];
+                                         fb->getPixel4f(x, y, pLeft);
+                                         fb->getPixel4f(fb->width() - 1 - x, y, pRight);
+
+                                         fb->setPixel4f(pRight[0], pRight[1], pRight[2], pRight[3], x, y);
+                                         fb->setPixel4f(pLeft[0], pLeft[1], pLeft[2], pLeft[3], fb->width() - 1 - x, y);
+                                     }
+                                 }
+                             }
+                         });
         }
     }
 
@@ -3732,12 +4109,16 @@ namespace TwkFB
         FrameBuffer* crop = new FrameBuffer(fb->coordinateType(), x1 - x0 + 1, y1 - y0 + 1, fb->depth(), fb->numChannels(), fb->dataType(),
                                             0, &fb->channelNames(), fb->orientation(), true);
 
-        for (int row = y0; row <= y1; row++)
-        {
-            const unsigned char* src = fb->scanline<unsigned char>(row) + x0 * fb->pixelSize();
-            unsigned char* dst = crop->scanline<unsigned char>(row - y0);
-            memcpy(dst, src, crop->scanlineSize());
-        }
+        parallelRows(y1 - y0 + 1, crop->scanlineSize() * 2,
+                     [&](size_t row0, size_t row1)
+                     {
+                         for (int row = y0 + int(row0); row < y0 + int(row1); row++)
+                         {
+                             const unsigned char* src = fb->scanline<unsigned char>(row) + x0 * fb->pixelSize();
+                             unsigned char* dst = crop->scanline<unsigned char>(row - y0);
+                             memcpy(dst, src, crop->scanlineSize());
+                         }
+                     });
 
         return crop;
     }
@@ -3888,13 +4269,20 @@ namespace TwkFB
 
             out->restructure(nw, nh, in->depth(), in->numChannels(), in->dataType(), NULL, &in->channelNames(), in->orientation());
 
-            for (int row = int(fy0 * ysampling * h + 0.499), nrow = 0; row < int(fy1 * ysampling * h + 0.499) && nrow < out->height();
-                 row++, nrow++)
-            {
-                const unsigned char* src = in->scanline<unsigned char>(row) + size_t(fx0 * xsampling * in->width()) * in->pixelSize();
-                unsigned char* dst = out->scanline<unsigned char>(nrow);
-                memcpy(dst, src, out->scanlineSize());
-            }
+            const int firstRow = int(fy0 * ysampling * h + 0.499);
+            const int nrows = std::min(int(fy1 * ysampling * h + 0.499) - firstRow, out->height());
+            const size_t xoffset = size_t(fx0 * xsampling * in->width()) * in->pixelSize();
+
+            parallelRows(std::max(nrows, 0), out->scanlineSize() * 2,
+                         [&](size_t row0, size_t row1)
+                         {
+                             for (int nrow = int(row0); nrow < int(row1); nrow++)
+                             {
+                                 const unsigned char* src = in->scanline<unsigned char>(firstRow + nrow) + xoffset;
+                                 unsigned char* dst = out->scanline<unsigned char>(nrow);
+                                 memcpy(dst, src, out->scanlineSize());
+                             }
+                         });
 
             if (append)
                 outfb->appendPlane(out);
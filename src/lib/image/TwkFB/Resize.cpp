@@ -0,0 +1,536 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <TwkFB/Resize.h>
+#include <TwkFB/Exception.h>
+#include <TwkFB/Operations.h>
+#include <TwkFB/SIMDKernels.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <half.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+namespace TwkFB
+{
+    using namespace std;
+
+    namespace
+    {
+
+        const size_t minBandBytes = 256 * 1024;
+
+        float boxFilter(float x) { return x >= -0.5f && x < 0.5f ? 1.0f : 0.0f; }
+
+        float triangleFilter(float x)
+        {
+            x = fabs(x);
+            return x < 1.0f ? 1.0f - x : 0.0f;
+        }
+
+        float mitchellFilter(float x)
+        {
+            const float B = 1.0f / 3.0f;
+            const float C = 1.0f / 3.0f;
+
+            x = fabs(x);
+
+            if (x < 1.0f)
+            {
+                return ((12.0f - 9.0f * B - 6.0f * C) * x * x * x + (-18.0f + 12.0f * B + 6.0f * C) * x * x + (6.0f - 2.0f * B)) / 6.0f;
+            }
+            else if (x < 2.0f)
+            {
+                return ((-B - 6.0f * C) * x * x * x + (6.0f * B + 30.0f * C) * x * x + (-12.0f * B - 48.0f * C) * x + (8.0f * B + 24.0f * C))
+                       / 6.0f;
+            }
+
+            return 0.0f;
+        }
+
+        float sinc(float x)
+        {
+            if (x == 0.0f)
+                return 1.0f;
+            x *= float(M_PI);
+            return sin(x) / x;
+        }
+
+        float lanczos3Filter(float x)
+        {
+            x = fabs(x);
+            return x < 3.0f ? sinc(x) * sinc(x / 3.0f) : 0.0f;
+        }
+
+        struct Filter
+        {
+            float (*func)(float);
+            float support;
+        };
+
+        Filter filterFor(ResizeFilter f)
+        {
+            Filter filter;
+
+            switch (f)
+            {
+            case BoxFilter:
+                filter.func = boxFilter;
+                filter.support = 0.5f;
+                break;
+            case TriangleFilter:
+                filter.func = triangleFilter;
+                filter.support = 1.0f;
+                break;
+            default:
+            case MitchellFilter:
+                filter.func = mitchellFilter;
+                filter.support = 2.0f;
+                break;
+            case Lanczos3Filter:
+                filter.func = lanczos3Filter;
+                filter.support = 3.0f;
+                break;
+            }
+
+            return filter;
+        }
+
+        //
+        //  The polyphase weights for one axis. Output i is the sum over
+        //  k < ntaps of weights[i * ntaps + k] times input first[i] + k.
+        //  Every output has the same number of taps (padded with zero
+        //  weights) and the windows are moved inside the input at the
+        //  edges, where the weights of samples past the edge are added
+        //  to the edge sample, so the inner loops never need to check.
+        //
+
+        struct Taps
+        {
+            int ntaps;
+            vector<int> first;
+            vector<float> weights;
+        };
+
+        void computeTaps(ResizeFilter f, int in, int out, Taps& taps)
+        {
+            taps.first.resize(out);
+
+            if (in == out)
+            {
+                taps.ntaps = 1;
+                taps.weights.assign(out, 1.0f);
+                for (int i = 0; i < out; i++)
+                    taps.first[i] = i;
+                return;
+            }
+
+            //
+            //  When shrinking the filter is stretched to cover the input
+            //  pixels each output one covers
+            //
+
+            const Filter filter = filterFor(f);
+            const double scale = double(in) / double(out);
+            const double fscale = std::max(scale, 1.0);
+            const double support = filter.support * fscale;
+
+            vector<int> lo(out);
+            vector<int> hi(out);
+            taps.ntaps = 1;
+
+            for (int i = 0; i < out; i++)
+            {
+                const double center = (i + 0.5) * scale - 0.5;
+                lo[i] = int(floor(center - support));
+                hi[i] = int(ceil(center + support));
+                const int a = std::max(lo[i], 0);
+                const int b = std::min(hi[i], in - 1);
+                taps.ntaps = std::max(taps.ntaps, b - a + 1);
+            }
+
+            taps.ntaps = std::min(taps.ntaps, in);
+            taps.weights.assign(size_t(out) * taps.ntaps, 0.0f);
+
+            for (int i = 0; i < out; i++)
+            {
+                const double center = (i + 0.5) * scale - 0.5;
+                const int first = std::min(std::max(lo[i], 0), in - taps.ntaps);
+                float* w = &taps.weights[size_t(i) * taps.ntaps];
+                double sum = 0;
+
+                taps.first[i] = first;
+
+                for (int j = lo[i]; j <= hi[i]; j++)
+                {
+                    const float v = filter.func(float((j - center) / fscale));
+                    w[std::min(std::max(j, 0), in - 1) - first] += v;
+                    sum += v;
+                }
+
+                if (sum != 0.0)
+                {
+                    for (int k = 0; k < taps.ntaps; k++)
+                        w[k] = float(w[k] / sum);
+                }
+                else
+                {
+                    const int nearest = std::min(std::max(int(floor(center + 0.5)), 0), in - 1);
+                    w[nearest - first] = 1.0f;
+                }
+            }
+        }
+
+        bool isPacked(FrameBuffer::DataType t) { return t >= FrameBuffer::PACKED_R10_G10_B10_X2; }
+
+        //
+        //  Returns row y of fb as float values, converted into buffer
+        //  unless fb is already float. Integers are normalized like
+        //  copyConvert() does: 32 bit ones are passed through.
+        //
+
+        const float* floatRow(const FrameBuffer* fb, int y, float* buffer)
+        {
+            const size_t n = size_t(fb->width()) * fb->numChannels();
+
+            switch (fb->dataType())
+            {
+            case FrameBuffer::FLOAT:
+                return fb->scanline<float>(y);
+            case FrameBuffer::UCHAR:
+            {
+                const unsigned char* p = fb->scanline<unsigned char>(y);
+                if (!SIMD::convert(SIMD::U8, p, SIMD::Float, buffer, n))
+                {
+                    for (size_t i = 0; i < n; i++)
+                        buffer[i] = float(p[i]) / 255.0f;
+                }
+                break;
+            }
+            case FrameBuffer::USHORT:
+            {
+                const unsigned short* p = fb->scanline<unsigned short>(y);
+                if (!SIMD::convert(SIMD::U16, p, SIMD::Float, buffer, n))
+                {
+                    for (size_t i = 0; i < n; i++)
+                        buffer[i] = float(p[i]) / 65535.0f;
+                }
+                break;
+            }
+            case FrameBuffer::HALF:
+            {
+                const half* p = fb->scanline<half>(y);
+                if (!SIMD::convert(SIMD::Half, p, SIMD::Float, buffer, n))
+                {
+                    for (size_t i = 0; i < n; i++)
+                        buffer[i] = p[i];
+                }
+                break;
+            }
+            case FrameBuffer::UINT:
+            {
+                const unsigned int* p = fb->scanline<unsigned int>(y);
+                for (size_t i = 0; i < n; i++)
+                    buffer[i] = float(p[i]);
+                break;
+            }
+            case FrameBuffer::DOUBLE:
+            {
+                const double* p = fb->scanline<double>(y);
+                for (size_t i = 0; i < n; i++)
+                    buffer[i] = float(p[i]);
+                break;
+            }
+            default:
+                break;
+            }
+
+            return buffer;
+        }
+
+        template <typename T> void storeIntegral(const float* in, T* out, size_t n, float maxValue)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                const float v = std::min(std::max(in[i], 0.0f), 1.0f);
+                out[i] = T(v * maxValue + 0.5f);
+            }
+        }
+
+        void storeRow(const float* row, FrameBuffer* fb, int y)
+        {
+            const size_t n = size_t(fb->width()) * fb->numChannels();
+
+            switch (fb->dataType())
+            {
+            case FrameBuffer::UCHAR:
+            {
+                unsigned char* p = fb->scanline<unsigned char>(y);
+                if (!SIMD::convert(SIMD::Float, row, SIMD::U8, p, n))
+                    storeIntegral(row, p, n, 255.0f);
+                break;
+            }
+            case FrameBuffer::USHORT:
+            {
+                unsigned short* p = fb->scanline<unsigned short>(y);
+                if (!SIMD::convert(SIMD::Float, row, SIMD::U16, p, n))
+                    storeIntegral(row, p, n, 65535.0f);
+                break;
+            }
+            case FrameBuffer::HALF:
+            {
+                half* p = fb->scanline<half>(y);
+                if (!SIMD::convert(SIMD::Float, row, SIMD::Half, p, n))
+                {
+                    for (size_t i = 0; i < n; i++)
+                        p[i] = row[i];
+                }
+                break;
+            }
+            case FrameBuffer::UINT:
+            {
+                unsigned int* p = fb->scanline<unsigned int>(y);
+                for (size_t i = 0; i < n; i++)
+                    p[i] = (unsigned int)(std::min(std::max(double(row[i]), 0.0), 4294967295.0) + 0.5);
+                break;
+            }
+            case FrameBuffer::DOUBLE:
+            {
+                double* p = fb->scanline<double>(y);
+                for (size_t i = 0; i < n; i++)
+                    p[i] = row[i];
+                break;
+            }
+            case FrameBuffer::FLOAT:
+            {
+                float* p = fb->scanline<float>(y);
+                if (p != row)
+                    memcpy(p, row, n * sizeof(float));
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        void verticalPass(const float* const* rows, const float* weights, int nrows, float* out, size_t n)
+        {
+            if (SIMD::weightedSum(rows, weights, nrows, out, n))
+                return;
+
+            for (size_t i = 0; i < n; i++)
+                out[i] = weights[0] * rows[0][i];
+
+            for (int k = 1; k < nrows; k++)
+            {
+                const float w = weights[k];
+                const float* row = rows[k];
+                for (size_t i = 0; i < n; i++)
+                    out[i] += w * row[i];
+            }
+        }
+
+        void horizontalPass(const float* in, float* out, int nchannels, const Taps& taps)
+        {
+            const size_t npixels = taps.first.size();
+            const int ntaps = taps.ntaps;
+
+            if (SIMD::filterPixels(in, out, nchannels, npixels, &taps.first.front(), &taps.weights.front(), ntaps))
+            {
+                return;
+            }
+
+            const float* w = &taps.weights.front();
+
+            for (size_t i = 0; i < npixels; i++, w += ntaps)
+            {
+                const float* p = in + size_t(taps.first[i]) * nchannels;
+
+                for (int c = 0; c < nchannels; c++, out++)
+                {
+                    float acc = 0;
+                    for (int k = 0; k < ntaps; k++)
+                        acc += w[k] * p[k * nchannels + c];
+                    *out = acc;
+                }
+            }
+        }
+
+        //
+        //  Each output scanline is the vertical pass over the input rows
+        //  under it (at the input width) followed by the horizontal pass.
+        //  Bands keep the last ntaps converted input rows around since
+        //  neighboring output rows mostly share them.
+        //
+
+        void resizePlane(const FrameBuffer* a, FrameBuffer* b, ResizeFilter filter)
+        {
+            if (a->numChannels() != b->numChannels())
+            {
+                TWK_THROW_EXC_STREAM("filteredResize: plane has " << a->numChannels() << " channels, destination has " << b->numChannels());
+            }
+
+            if (isPacked(b->dataType()))
+            {
+                TWK_THROW_EXC_STREAM("filteredResize: can't resize into packed type " << b->dataType());
+            }
+
+            if (!a->width() || !a->height() || !b->width() || !b->height())
+                return;
+
+            Taps xtaps;
+            Taps ytaps;
+            computeTaps(filter, a->width(), b->width(), xtaps);
+            computeTaps(filter, a->height(), b->height(), ytaps);
+
+            const int nc = a->numChannels();
+            const int ah = a->height();
+            const int bh = b->height();
+            const int depth = std::min(a->depth(), b->depth());
+            const size_t an = size_t(a->width()) * nc;
+            const size_t bn = size_t(b->width()) * nc;
+            const bool floatIn = a->dataType() == FrameBuffer::FLOAT;
+            const bool floatOut = b->dataType() == FrameBuffer::FLOAT;
+            const size_t rowBytes = b->scanlineSize() + size_t(double(a->scanlineSize()) * ah / bh);
+            const size_t grain = std::max(minBandBytes / std::max(rowBytes, size_t(1)), size_t(1));
+
+            ThreadPool::parallelFor(0, size_t(bh) * depth, grain,
+                                    [&](size_t row0, size_t row1)
+                                    {
+                                        const int ntaps = ytaps.ntaps;
+                                        vector<float> ring(floatIn ? 0 : an * ntaps);
+                                        vector<int> ringRow(ntaps, -1);
+                                        vector<const float*> rows(ntaps);
+                                        vector<float> column(an);
+                                        vector<float> outRow(floatOut ? 0 : bn);
+
+                                        for (size_t r = row0; r < row1; r++)
+                                        {
+                                            const int z = int(r / bh);
+                                            const int y = int(r % bh);
+                                            const int first = z * ah + ytaps.first[y];
+
+                                            for (int k = 0; k < ntaps; k++)
+                                            {
+                                                const int ay = first + k;
+                                                const int slot = ay % ntaps;
+
+                                                if (floatIn)
+                                                {
+                                                    rows[k] = a->scanline<float>(ay);
+                                                }
+                                                else
+                                                {
+                                                    float* buffer = &ring[size_t(slot) * an];
+                                                    if (ringRow[slot] != ay)
+                                                        floatRow(a, ay, buffer);
+                                                    ringRow[slot] = ay;
+                                                    rows[k] = buffer;
+                                                }
+                                            }
+
+                                            float* out = floatOut ? b->scanline<float>(int(r)) : &outRow.front();
+
+                                            verticalPass(&rows.front(), &ytaps.weights[size_t(y) * ntaps], ntaps, &column.front(), an);
+                                            horizontalPass(&column.front(), out, nc, xtaps);
+
+                                            if (!floatOut)
+                                                storeRow(out, b, int(r));
+                                        }
+                                    });
+        }
+
+    } // namespace
+
+    void filteredResize(const FrameBuffer* from, FrameBuffer* to, ResizeFilter filter)
+    {
+        const FrameBuffer* a = from;
+        FrameBuffer* b = to;
+
+        for (; a && b; a = a->nextPlane(), b = b->nextPlane())
+        {
+            if (isPacked(a->dataType()))
+            {
+                FrameBuffer* unpacked = copyConvertPlane(a, FrameBuffer::FLOAT);
+                resizePlane(unpacked, b, filter);
+                delete unpacked;
+            }
+            else
+            {
+                resizePlane(a, b, filter);
+            }
+        }
+    }
+
+    FrameBuffer* filteredResize(const FrameBuffer* from, int width, int height, ResizeFilter filter)
+    {
+        const double sx = double(width) / double(from->width());
+        const double sy = double(height) / double(from->height());
+        FrameBuffer* result = 0;
+
+        for (const FrameBuffer* f = from->firstPlane(); f; f = f->nextPlane())
+        {
+            FrameBuffer* unpacked = isPacked(f->dataType()) ? copyConvertPlane(f, FrameBuffer::FLOAT) : 0;
+            const FrameBuffer* a = unpacked ? unpacked : f;
+            const FrameBuffer::DataType type = unpacked ? FrameBuffer::HALF : a->dataType();
+            const int w = result ? std::max(int(a->width() * sx + 0.5), 1) : width;
+            const int h = result ? std::max(int(a->height() * sy + 0.5), 1) : height;
+
+            FrameBuffer::StringVector names = a->channelNames();
+            FrameBuffer* b = new FrameBuffer(a->coordinateType(), w, h, a->depth(), a->numChannels(), type, 0, &names,
+                                             a->orientation(), true);
+
+            try
+            {
+                resizePlane(a, b, filter);
+            }
+            catch (...)
+            {
+                delete unpacked;
+                delete b;
+                delete result;
+                throw;
+            }
+
+            a->copyAttributesTo(b);
+            delete unpacked;
+
+            if (result)
+                result->appendPlane(b);
+            else
+                result = b;
+        }
+
+        result->idstream() << from->identifier() << ":resize/" << resizeFilterName(filter) << "/" << width << "x" << height;
+
+        if (from->uncrop())
+        {
+            result->setUncrop(int(from->uncropWidth() * sx), int(from->uncropHeight() * sy), int(from->uncropX() * sx),
+                              int(from->uncropY() * sy));
+        }
+
+        return result;
+    }
+
+    const char* resizeFilterName(ResizeFilter filter)
+    {
+        switch (filter)
+        {
+        case BoxFilter:
+            return "box";
+        case TriangleFilter:
+            return "triangle";
+        case MitchellFilter:
+            return "mitchell";
+        case Lanczos3Filter:
+            return "lanczos3";
+        default:
+            return "unknown";
+        }
+    }
+
+} // namespace TwkFB
@@ -0,0 +1,51 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __TwkFB__SIMDKernelTable__h__
+#define __TwkFB__SIMDKernelTable__h__
+#include <TwkFB/SIMDKernels.h>
+
+namespace TwkFB
+{
+    namespace SIMD
+    {
+
+        //
+        //  One per instruction set, filled in by the file compiled for
+        //  it. Null entries have no kernel at that level.
+        //
+
+        struct KernelTable
+        {
+            typedef void (*ConvertKernel)(const void* in, void* out, size_t n);
+
+            typedef void (*TransformKernel)(const TransformParams&, const float* in, float* out, int nchannels, size_t nelements,
+                                            ColorTransformFunc fallback, void* data);
+
+            typedef void (*WeightedSumKernel)(const float* const* rows, const float* weights, int nrows, float* out, size_t n);
+
+            typedef void (*FilterPixelsKernel)(const float* in, float* out, size_t npixels, const int* first, const float* weights,
+                                               int ntaps);
+
+            typedef void (*UnpackKernel)(const void* in, void* const* out, size_t n, bool msbPadded, bool swap);
+
+            typedef void (*ShiftKernel)(const void* in, void* out, size_t n, int shift);
+
+            ConvertKernel convert[NumValueTypes][NumValueTypes];
+            TransformKernel transform[NumTransformKinds];
+            WeightedSumKernel weightedSum;
+            FilterPixelsKernel filterPixels4;
+            UnpackKernel unpack10[NumUnpackLayouts];
+            UnpackKernel unpack12[NumUnpackLayouts];
+            ShiftKernel shiftLeft16;
+        };
+
+        void fillKernelTableSSE41(KernelTable&);
+        void fillKernelTableAVX2(KernelTable&);
+
+    } // namespace SIMD
+} // namespace TwkFB
+
+#endif // __TwkFB__SIMDKernelTable__h__
@@ -0,0 +1,238 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <TwkFB/SIMDKernels.h>
+#include "SIMDKernelTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace TwkFB
+{
+    namespace SIMD
+    {
+        namespace
+        {
+
+            Level cpuLevel()
+            {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+                __builtin_cpu_init();
+
+                if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c"))
+                {
+                    return AVX2;
+                }
+
+                if (__builtin_cpu_supports("sse4.1"))
+                    return SSE41;
+#elif defined(_M_X64)
+                int info[4];
+                __cpuid(info, 1);
+
+                const bool sse41 = (info[2] & (1 << 19)) != 0;
+                const bool fma = (info[2] & (1 << 12)) != 0;
+                const bool f16c = (info[2] & (1 << 29)) != 0;
+                const bool osxsave = (info[2] & (1 << 27)) != 0;
+
+                //
+                //  The OS has to save the ymm registers too
+                //
+
+                const bool ymm = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+
+                __cpuidex(info, 7, 0);
+                const bool avx2 = (info[1] & (1 << 5)) != 0;
+
+                if (avx2 && fma && f16c && ymm)
+                    return AVX2;
+                if (sse41)
+                    return SSE41;
+#endif
+                return Scalar;
+            }
+
+            struct Kernels
+            {
+                Kernels()
+                    : detected(cpuLevel())
+                    , current(detected)
+                {
+                    memset(tables, 0, sizeof(tables));
+                    fillKernelTableSSE41(tables[SSE41]);
+                    fillKernelTableAVX2(tables[AVX2]);
+
+                    if (const char* s = getenv("RV_TWKFB_SIMD"))
+                    {
+                        Level cap = detected;
+
+                        if (!strcmp(s, "scalar"))
+                            cap = Scalar;
+                        else if (!strcmp(s, "sse4"))
+                            cap = SSE41;
+                        else if (!strcmp(s, "avx2"))
+                            cap = AVX2;
+
+                        if (cap < current)
+                            current = cap;
+                    }
+                }
+
+                Level detected;
+                Level current;
+                KernelTable tables[AVX2 + 1];
+            };
+
+            Kernels& kernels()
+            {
+                static Kernels k;
+                return k;
+            }
+
+        } // namespace
+
+        Level detectedLevel() { return kernels().detected; }
+
+        Level level() { return kernels().current; }
+
+        void setLevel(Level l)
+        {
+            Kernels& k = kernels();
+            k.current = l < k.detected ? l : k.detected;
+        }
+
+        const char* levelName(Level l)
+        {
+            switch (l)
+            {
+            case SSE41:
+                return "SSE4.1";
+            case AVX2:
+                return "AVX2";
+            default:
+                return "scalar";
+            }
+        }
+
+        bool convert(ValueType fromType, const void* in, ValueType toType, void* out, size_t n)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || fromType >= NumValueTypes || toType >= NumValueTypes)
+                return false;
+
+            if (KernelTable::ConvertKernel f = k.tables[k.current].convert[fromType][toType])
+            {
+                f(in, out, n);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool transform(TransformKind kind, const TransformParams& params, const float* in, float* out, int nchannels, size_t nelements,
+                       ColorTransformFunc fallback, void* data)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || kind >= NumTransformKinds || nchannels < 1 || nchannels > 4)
+                return false;
+
+            if (KernelTable::TransformKernel f = k.tables[k.current].transform[kind])
+            {
+                f(params, in, out, nchannels, nelements, fallback, data);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool weightedSum(const float* const* rows, const float* weights, int nrows, float* out, size_t n)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || nrows < 1)
+                return false;
+
+            if (KernelTable::WeightedSumKernel f = k.tables[k.current].weightedSum)
+            {
+                f(rows, weights, nrows, out, n);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool filterPixels(const float* in, float* out, int nchannels, size_t npixels, const int* first, const float* weights, int ntaps)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || nchannels != 4 || ntaps < 1)
+                return false;
+
+            if (KernelTable::FilterPixelsKernel f = k.tables[k.current].filterPixels4)
+            {
+                f(in, out, npixels, first, weights, ntaps);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool unpack10(const void* in, UnpackLayout layout, void* const* out, size_t n, bool msbPadded, bool swap)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || layout >= NumUnpackLayouts)
+                return false;
+
+            if (KernelTable::UnpackKernel f = k.tables[k.current].unpack10[layout])
+            {
+                f(in, out, n, msbPadded, swap);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool unpack12(const void* in, UnpackLayout layout, void* const* out, size_t n, bool msbPadded, bool swap)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || layout >= NumUnpackLayouts)
+                return false;
+
+            if (KernelTable::UnpackKernel f = k.tables[k.current].unpack12[layout])
+            {
+                f(in, out, n, msbPadded, swap);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool shiftLeft16(const void* in, void* out, size_t n, int shift)
+        {
+            const Kernels& k = kernels();
+
+            if (k.current == Scalar || shift < 0 || shift > 15)
+                return false;
+
+            if (KernelTable::ShiftKernel f = k.tables[k.current].shiftLeft16)
+            {
+                f(in, out, n, shift);
+                return true;
+            }
+
+            return false;
+        }
+
+    } // namespace SIMD
+} // namespace TwkFB
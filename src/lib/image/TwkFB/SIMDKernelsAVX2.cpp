@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Compiled with AVX2, FMA and F16C enabled (see CMakeLists.txt). Only
+//  called once SIMD::level() has checked the CPU has them.
+//
+
+#include "SIMDKernelTable.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+#define TWKFB_SIMD_F16C
+
+namespace TwkFB
+{
+    namespace SIMD
+    {
+        namespace
+        {
+            struct V
+            {
+                typedef __m256 F;
+                typedef __m256i I;
+
+                static const size_t N = 8;
+
+                static F set1(float f) { return _mm256_set1_ps(f); }
+
+                static F loadu(const float* p) { return _mm256_loadu_ps(p); }
+
+                static void storeu(float* p, F v) { _mm256_storeu_ps(p, v); }
+
+                static F add(F a, F b) { return _mm256_add_ps(a, b); }
+
+                static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+
+                static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+
+                static F div(F a, F b) { return _mm256_div_ps(a, b); }
+
+                static F min(F a, F b) { return _mm256_min_ps(a, b); }
+
+                static F max(F a, F b) { return _mm256_max_ps(a, b); }
+
+                static F fmadd(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+
+                static F floor(F a) { return _mm256_floor_ps(a); }
+
+                static F cmpeq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+
+                static F cmpneq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+
+                static F cmplt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+
+                static F cmple(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+
+                static F cmpgt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+
+                static F cmpge(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+
+                static F and_(F a, F b) { return _mm256_and_ps(a, b); }
+
+                static F or_(F a, F b) { return _mm256_or_ps(a, b); }
+
+                static F andnot(F a, F b) { return _mm256_andnot_ps(a, b); }
+
+                static F blendv(F a, F b, F m) { return _mm256_blendv_ps(a, b, m); }
+
+                static int movemask(F a) { return _mm256_movemask_ps(a); }
+
+                static I castToInt(F a) { return _mm256_castps_si256(a); }
+
+                static F castToFloat(I a) { return _mm256_castsi256_ps(a); }
+
+                static F cvt(I a) { return _mm256_cvtepi32_ps(a); }
+
+                static I cvtt(F a) { return _mm256_cvttps_epi32(a); }
+
+                static I set1i(int i) { return _mm256_set1_epi32(i); }
+
+                static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+
+                static I subi(I a, I b) { return _mm256_sub_epi32(a, b); }
+
+                static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+
+                static I ori(I a, I b) { return _mm256_or_si256(a, b); }
+
+                static I mulloi(I a, I b) { return _mm256_mullo_epi32(a, b); }
+
+                static I mini(I a, I b) { return _mm256_min_epi32(a, b); }
+
+                static I srli23(I a) { return _mm256_srli_epi32(a, 23); }
+
+                static I slli23(I a) { return _mm256_slli_epi32(a, 23); }
+
+                template <int S> static I srli(I a) { return _mm256_srli_epi32(a, S); }
+
+                template <int S> static I slli(I a) { return _mm256_slli_epi32(a, S); }
+
+                static I bswap32(I a)
+                {
+                    return _mm256_shuffle_epi8(a, _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5,
+                                                                   4, 11, 10, 9, 8, 15, 14, 13, 12));
+                }
+
+                static I sll16(I a, __m128i count) { return _mm256_sll_epi16(a, count); }
+
+                static I loadi(const void* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+                static void storei(void* p, I v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+
+                static const size_t Quads = 2;
+
+                static __m128i quad(I a, size_t i) { return i ? _mm256_extracti128_si256(a, 1) : _mm256_castsi256_si128(a); }
+
+                static I loadU8(const unsigned char* p)
+                {
+                    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+                }
+
+                static I loadU16(const unsigned short* p)
+                {
+                    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+                }
+
+                //
+                //  The packs work within 128 bit lanes, so pack the two
+                //  halves together.
+                //
+
+                static void storeU8(unsigned char* p, I v)
+                {
+                    const __m128i w = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(w, w));
+                }
+
+                static void storeU16(unsigned short* p, I v)
+                {
+                    const __m128i w = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), w);
+                }
+
+                template <typename H> static F loadHalf(const H* p)
+                {
+                    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+                }
+
+                template <typename H> static void storeHalf(H* p, F v)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+                }
+
+                static float halfToFloat(unsigned short h) { return _cvtsh_ss(h); }
+
+                static unsigned short floatToHalf(float f) { return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT); }
+            };
+
+        } // namespace
+    } // namespace SIMD
+} // namespace TwkFB
+
+#include "SIMDKernelsImpl.h"
+
+void TwkFB::SIMD::fillKernelTableAVX2(KernelTable& t) { fillKernelTable(t); }
+
+#else
+
+void TwkFB::SIMD::fillKernelTableAVX2(KernelTable& t) {}
+
+#endif
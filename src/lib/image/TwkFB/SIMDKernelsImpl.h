@@ -0,0 +1,1031 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  The kernels, written once against a small vector interface V which
+//  the including file defines for its instruction set before including
+//  this. V provides:
+//
+//      F, I            float and int32 vectors of N lanes
+//      arithmetic      add sub mul div min max fmadd floor
+//      comparisons     cmpeq cmpneq cmplt cmple cmpgt cmpge (all ones
+//                      masks)
+//      logic           and_ or_ andnot (~a & b) blendv (b where m)
+//      movemask        a bit per lane
+//      integers        castToInt castToFloat cvt cvtt set1i addi subi
+//                      andi ori mulloi mini srli23 slli23 srli<S>
+//                      slli<S> bswap32 (per lane byte swap)
+//      load/store      loadu storeu loadU8 loadU16 storeU8 storeU16
+//                      (the integer ones convert to/from int32 lanes)
+//                      loadi storei (N int32s)
+//      16 bit lanes    sll16 (shift left by the count in an __m128i)
+//      quads           Quads, quad(v, i): the ith 128 bit part of v
+//
+//  and, when TWKFB_SIMD_F16C is defined, loadHalf and storeHalf and
+//  their scalar versions halfToFloat and floatToHalf (on the bits).
+//
+//  Everything is in an anonymous namespace so each instruction set
+//  gets its own copy. That's also why nothing here calls inline
+//  functions from other headers (std::min, half's conversions, ...):
+//  the copy compiled here with this file's instructions could be the
+//  one the linker keeps for the whole library.
+//
+
+#include "SIMDKernelTable.h"
+#include <TwkFB/SIMDKernels.h>
+#include <half.h>
+#include <float.h>
+#include <string.h>
+
+namespace TwkFB
+{
+    namespace SIMD
+    {
+        namespace
+        {
+            typedef V::F F;
+            typedef V::I I;
+
+            const size_t N = V::N;
+
+            inline float clampf(float v, float lo, float hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+            inline unsigned int minu(unsigned int a, unsigned int b) { return a < b ? a : b; }
+
+            //
+            //  The vector of lane values for the jth vector of a run of
+            //  interleaved pixels with nchannels channels: lane l holds
+            //  channel (j * N + l) % nchannels.
+            //
+
+            inline F phaseVector(const float* values, int nchannels, int j)
+            {
+                float lanes[N];
+
+                for (size_t l = 0; l < N; l++)
+                {
+                    lanes[l] = values[(j * N + l) % nchannels];
+                }
+
+                return V::loadu(lanes);
+            }
+
+            inline F allOnes() { return V::castToFloat(V::set1i(-1)); }
+
+            inline F isFinite(F x)
+            {
+                //
+                //  NaNs fail every comparison
+                //
+
+                const F a = V::andnot(V::set1(-0.0f), x);
+                return V::cmple(a, V::set1(FLT_MAX));
+            }
+
+            //
+            //  Natural log of positive normal x. Cephes logf, within a
+            //  couple of ulp.
+            //
+
+            inline F vlog(F x)
+            {
+                const I bits = V::castToInt(x);
+                F e = V::cvt(V::subi(V::srli23(bits), V::set1i(127)));
+                F m = V::castToFloat(V::ori(V::andi(bits, V::set1i(0x007fffff)), V::set1i(0x3f800000)));
+
+                const F big = V::cmpgt(m, V::set1(1.41421356237f));
+                m = V::blendv(m, V::mul(m, V::set1(0.5f)), big);
+                e = V::add(e, V::and_(big, V::set1(1.0f)));
+
+                const F t = V::sub(m, V::set1(1.0f));
+                const F z = V::mul(t, t);
+
+                F y = V::set1(7.0376836292e-2f);
+                y = V::fmadd(y, t, V::set1(-1.1514610310e-1f));
+                y = V::fmadd(y, t, V::set1(1.1676998740e-1f));
+                y = V::fmadd(y, t, V::set1(-1.2420140846e-1f));
+                y = V::fmadd(y, t, V::set1(1.4249322787e-1f));
+                y = V::fmadd(y, t, V::set1(-1.6668057665e-1f));
+                y = V::fmadd(y, t, V::set1(2.0000714765e-1f));
+                y = V::fmadd(y, t, V::set1(-2.4999993993e-1f));
+                y = V::fmadd(y, t, V::set1(3.3333331174e-1f));
+                y = V::mul(V::mul(y, t), z);
+                y = V::fmadd(e, V::set1(-2.12194440e-4f), y);
+                y = V::fmadd(z, V::set1(-0.5f), y);
+
+                return V::fmadd(e, V::set1(0.693359375f), V::add(t, y));
+            }
+
+            //
+            //  e^x, Cephes expf. Underflows to 0, x must be < 88.3
+            //
+
+            inline F vexp(F x)
+            {
+                const F under = V::cmplt(x, V::set1(-87.3f));
+                x = V::min(V::max(x, V::set1(-87.3f)), V::set1(88.3f));
+
+                const F n = V::floor(V::fmadd(x, V::set1(1.44269504089f), V::set1(0.5f)));
+                F r = V::sub(x, V::mul(n, V::set1(0.693359375f)));
+                r = V::sub(r, V::mul(n, V::set1(-2.12194440e-4f)));
+
+                F y = V::set1(1.9875691500e-4f);
+                y = V::fmadd(y, r, V::set1(1.3981999507e-3f));
+                y = V::fmadd(y, r, V::set1(8.3334519073e-3f));
+                y = V::fmadd(y, r, V::set1(4.1665795894e-2f));
+                y = V::fmadd(y, r, V::set1(1.6666665459e-1f));
+                y = V::fmadd(y, r, V::set1(5.0000001201e-1f));
+                y = V::fmadd(V::mul(y, r), r, V::add(r, V::set1(1.0f)));
+
+                const F scale = V::castToFloat(V::slli23(V::addi(V::cvtt(n), V::set1i(127))));
+
+                return V::andnot(under, V::mul(y, scale));
+            }
+
+            //
+            //  b^e for b >= 0 and e > 0. Sets bad where it can't do it.
+            //
+
+            inline F vpow(F b, F e, F& bad)
+            {
+                const F zero = V::cmpeq(b, V::set1(0.0f));
+                const F normal = V::and_(V::cmpge(b, V::set1(FLT_MIN)), isFinite(b));
+                const F arg = V::mul(e, vlog(V::blendv(b, V::set1(1.0f), zero)));
+
+                bad = V::or_(V::andnot(V::or_(zero, normal), allOnes()), V::cmpgt(arg, V::set1(88.0f)));
+
+                return V::andnot(zero, vexp(arg));
+            }
+
+            //
+            //  Element wise transforms. Each takes the vector of the jth
+            //  phase, returns the transformed values and ors into bad the
+            //  lanes it can't do.
+            //
+
+            struct SRGBToLinearOp
+            {
+                SRGBToLinearOp(const TransformParams&, int) {}
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F lin = V::cmple(x, V::set1(0.04045f));
+                    F b;
+                    const F c = vpow(V::div(V::add(x, V::set1(0.055f)), V::set1(1.055f)), V::set1(2.4f), b);
+                    bad = V::or_(bad, V::andnot(lin, b));
+                    return V::blendv(c, V::div(x, V::set1(12.92f)), lin);
+                }
+            };
+
+            struct LinearToSRGBOp
+            {
+                LinearToSRGBOp(const TransformParams&, int) {}
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F lin = V::cmple(x, V::set1(0.0031308f));
+                    F b;
+                    const F c = V::fmadd(vpow(x, V::set1(1.0f / 2.4f), b), V::set1(1.055f), V::set1(-0.055f));
+                    bad = V::or_(bad, V::andnot(lin, b));
+                    return V::blendv(c, V::mul(x, V::set1(12.92f)), lin);
+                }
+            };
+
+            struct Rec709ToLinearOp
+            {
+                Rec709ToLinearOp(const TransformParams&, int) {}
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F lin = V::cmple(x, V::set1(0.081f));
+                    F b;
+                    const F c = vpow(V::div(V::add(x, V::set1(0.099f)), V::set1(1.099f)), V::set1(1.0f / 0.45f), b);
+                    bad = V::or_(bad, V::andnot(lin, b));
+                    return V::blendv(c, V::div(x, V::set1(4.5f)), lin);
+                }
+            };
+
+            struct LinearToRec709Op
+            {
+                LinearToRec709Op(const TransformParams&, int) {}
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F lin = V::cmple(x, V::set1(0.018f));
+                    F b;
+                    const F c = V::fmadd(vpow(x, V::set1(0.45f), b), V::set1(1.099f), V::set1(-0.099f));
+                    bad = V::or_(bad, V::andnot(lin, b));
+                    return V::blendv(c, V::mul(x, V::set1(4.5f)), lin);
+                }
+            };
+
+            //
+            //  constants: cinblack, cinwhite - cinblack
+            //
+
+            struct CineonLogToLinearOp
+            {
+                CineonLogToLinearOp(const TransformParams& p, int)
+                    : black(V::set1(p.constants[0]))
+                    , range(V::set1(p.constants[1]))
+                {
+                }
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F arg = V::mul(x, V::set1(float(3.41 * 2.30258509299404568402)));
+                    bad = V::or_(bad, V::cmpgt(arg, V::set1(88.0f)));
+                    return V::div(V::sub(vexp(arg), black), range);
+                }
+
+                F black;
+                F range;
+            };
+
+            struct LinearToCineonLogOp
+            {
+                LinearToCineonLogOp(const TransformParams& p, int)
+                    : black(V::set1(p.constants[0]))
+                    , range(V::set1(p.constants[1]))
+                {
+                }
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F arg = V::fmadd(x, range, black);
+                    const F normal = V::and_(V::cmpge(arg, V::set1(FLT_MIN)), isFinite(arg));
+                    bad = V::or_(bad, V::andnot(normal, allOnes()));
+                    return V::mul(vlog(V::blendv(V::set1(1.0f), arg, normal)), V::set1(float(0.43429448190325182765 / 3.41)));
+                }
+
+                F black;
+                F range;
+            };
+
+            //
+            //  constants: A B C D X Y cutoff, see logCToLinearTransform()
+            //
+
+            struct LogCToLinearOp
+            {
+                LogCToLinearOp(const TransformParams& p, int)
+                {
+                    for (int i = 0; i < 7; i++)
+                        k[i] = V::set1(p.constants[i]);
+                }
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F lin = V::cmple(x, k[6]);
+                    const F arg = V::mul(V::fmadd(x, k[0], k[1]), V::set1(2.30258509299f));
+                    bad = V::or_(bad, V::andnot(lin, V::cmpgt(arg, V::set1(88.0f))));
+                    const F c = V::fmadd(vexp(arg), k[2], k[3]);
+                    return V::blendv(c, V::fmadd(x, k[4], k[5]), lin);
+                }
+
+                F k[7];
+            };
+
+            //
+            //  constants: bo pbs gs cutoff ls*eg lo*eg+eo eg eo, see
+            //  linearToLogCTransform()
+            //
+
+            struct LinearToLogCOp
+            {
+                LinearToLogCOp(const TransformParams& p, int)
+                {
+                    for (int i = 0; i < 8; i++)
+                        k[i] = V::set1(p.constants[i]);
+                }
+
+                F operator()(F x, int, F& bad) const
+                {
+                    const F xr = V::add(k[0], V::div(V::sub(V::max(x, V::set1(0.0f)), k[1]), k[2]));
+                    const F lin = V::cmple(xr, k[3]);
+                    const F normal = V::and_(V::cmpge(xr, V::set1(FLT_MIN)), isFinite(xr));
+                    bad = V::or_(bad, V::andnot(V::or_(lin, normal), allOnes()));
+                    const F c = V::fmadd(V::mul(vlog(V::blendv(V::set1(1.0f), xr, normal)), V::set1(0.43429448190f)), k[6], k[7]);
+                    return V::blendv(c, V::fmadd(xr, k[4], k[5]), lin);
+                }
+
+                F k[8];
+            };
+
+            struct PowerOp
+            {
+                PowerOp(const TransformParams& p, int nchannels)
+                {
+                    for (int j = 0; j < nchannels; j++)
+                        e[j] = phaseVector(p.values, nchannels, j);
+                }
+
+                F operator()(F x, int j, F& bad) const
+                {
+                    F b;
+                    const F c = vpow(x, e[j], b);
+                    bad = V::or_(bad, b);
+                    return c;
+                }
+
+                F e[4];
+            };
+
+            //
+            //  Runs Op over blocks of N pixels (nchannels vectors). The
+            //  channels not in the mask keep what's in out. A block with
+            //  a lane Op can't do is done by fallback instead.
+            //
+
+            template <class Op>
+            void maskedTransform(const TransformParams& p, const float* in, float* out, int nchannels, size_t nelements,
+                                 ColorTransformFunc fallback, void* data)
+            {
+                const Op op(p, nchannels);
+                const size_t blockSize = N * nchannels;
+                const size_t nblocks = nelements / N;
+
+                float maskValues[4];
+                F mask[4];
+
+                for (int c = 0; c < nchannels; c++)
+                    maskValues[c] = p.mask[c] ? 1.0f : 0.0f;
+
+                for (int j = 0; j < nchannels; j++)
+                    mask[j] = V::cmpneq(phaseVector(maskValues, nchannels, j), V::set1(0.0f));
+
+                for (size_t b = 0; b < nblocks; b++)
+                {
+                    const float* ip = in + b * blockSize;
+                    float* op_ = out + b * blockSize;
+                    F result[4];
+                    F bad = V::set1(0.0f);
+
+                    for (int j = 0; j < nchannels; j++)
+                    {
+                        const F x = V::loadu(ip + j * N);
+                        F xbad = V::andnot(isFinite(x), allOnes());
+                        const F y = op(x, j, xbad);
+
+                        result[j] = V::blendv(V::loadu(op_ + j * N), y, mask[j]);
+                        bad = V::or_(bad, V::and_(xbad, mask[j]));
+                    }
+
+                    if (V::movemask(bad))
+                    {
+                        fallback(ip, op_, nchannels, N, data);
+                    }
+                    else
+                    {
+                        for (int j = 0; j < nchannels; j++)
+                            V::storeu(op_ + j * N, result[j]);
+                    }
+                }
+
+                if (nelements > nblocks * N)
+                {
+                    fallback(in + nblocks * blockSize, out + nblocks * blockSize, nchannels, nelements - nblocks * N, data);
+                }
+            }
+
+            //
+            //  Pixel at a time transforms of 4 channel (or 3 for Matrix)
+            //  pixels with SSE, which every level has.
+            //
+
+            void premultKernel(const TransformParams&, const float* in, float* out, int nchannels, size_t nelements,
+                               ColorTransformFunc fallback, void* data)
+            {
+                if (nchannels != 4)
+                {
+                    fallback(in, out, nchannels, nelements, data);
+                    return;
+                }
+
+                for (size_t i = 0; i < nelements; i++, in += 4, out += 4)
+                {
+                    const __m128 v = _mm_loadu_ps(in);
+                    const __m128 a = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+                    _mm_storeu_ps(out, _mm_blend_ps(_mm_mul_ps(v, a), _mm_loadu_ps(out), 0x8));
+                }
+            }
+
+            void unpremultKernel(const TransformParams&, const float* in, float* out, int nchannels, size_t nelements,
+                                 ColorTransformFunc fallback, void* data)
+            {
+                if (nchannels != 4)
+                {
+                    fallback(in, out, nchannels, nelements, data);
+                    return;
+                }
+
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 zero = _mm_setzero_ps();
+
+                for (size_t i = 0; i < nelements; i++, in += 4, out += 4)
+                {
+                    const __m128 v = _mm_loadu_ps(in);
+                    const __m128 a = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+                    const __m128 r = _mm_blendv_ps(one, _mm_div_ps(v, a), _mm_cmpneq_ps(a, zero));
+                    _mm_storeu_ps(out, _mm_blend_ps(r, _mm_loadu_ps(out), 0x8));
+                }
+            }
+
+            //
+            //  M * (r, g, b, 1) with the homogeneous divide, like
+            //  Mat44f * Vec3f. Alpha passes through.
+            //
+
+            void matrixKernel(const TransformParams& p, const float* in, float* out, int nchannels, size_t nelements,
+                              ColorTransformFunc fallback, void* data)
+            {
+                if (nchannels != 3 && nchannels != 4)
+                {
+                    fallback(in, out, nchannels, nelements, data);
+                    return;
+                }
+
+                const float* m = p.constants;
+                const __m128 c0 = _mm_setr_ps(m[0], m[4], m[8], m[12]);
+                const __m128 c1 = _mm_setr_ps(m[1], m[5], m[9], m[13]);
+                const __m128 c2 = _mm_setr_ps(m[2], m[6], m[10], m[14]);
+                const __m128 c3 = _mm_setr_ps(m[3], m[7], m[11], m[15]);
+
+                //
+                //  A 3 channel pixel is read with the first value of the
+                //  next one so the last one is left to fallback.
+                //
+
+                const size_t n = nchannels == 4 ? nelements : (nelements ? nelements - 1 : 0);
+
+                for (size_t i = 0; i < n; i++, in += nchannels, out += nchannels)
+                {
+                    const __m128 v = _mm_loadu_ps(in);
+                    __m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))), c3);
+                    r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                    r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                    r = _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+
+                    if (nchannels == 4)
+                    {
+                        _mm_storeu_ps(out, _mm_blend_ps(r, v, 0x8));
+                    }
+                    else
+                    {
+                        _mm_storel_pi(reinterpret_cast<__m64*>(out), r);
+                        _mm_store_ss(out + 2, _mm_movehl_ps(r, r));
+                    }
+                }
+
+                if (n < nelements)
+                    fallback(in, out, nchannels, nelements - n, data);
+            }
+
+            //
+            //  Resize passes. The vertical one runs along whole rows so
+            //  it's done N values at a time, the horizontal one a 4
+            //  channel pixel at a time with SSE.
+            //
+
+            void weightedSumKernel(const float* const* rows, const float* weights, int nrows, float* out, size_t n)
+            {
+                size_t i = 0;
+
+                for (; i + N <= n; i += N)
+                {
+                    F acc = V::mul(V::set1(weights[0]), V::loadu(rows[0] + i));
+
+                    for (int k = 1; k < nrows; k++)
+                    {
+                        acc = V::fmadd(V::set1(weights[k]), V::loadu(rows[k] + i), acc);
+                    }
+
+                    V::storeu(out + i, acc);
+                }
+
+                for (; i < n; i++)
+                {
+                    float acc = weights[0] * rows[0][i];
+                    for (int k = 1; k < nrows; k++)
+                        acc += weights[k] * rows[k][i];
+                    out[i] = acc;
+                }
+            }
+
+            void filterPixels4Kernel(const float* in, float* out, size_t npixels, const int* first, const float* weights, int ntaps)
+            {
+                for (size_t i = 0; i < npixels; i++, out += 4, weights += ntaps)
+                {
+                    const float* p = in + size_t(first[i]) * 4;
+                    __m128 acc = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(p));
+
+                    for (int k = 1; k < ntaps; k++)
+                    {
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(p + k * 4)));
+                    }
+
+                    _mm_storeu_ps(out, acc);
+                }
+            }
+
+            //
+            //  Value conversions
+            //
+
+            template <int T> struct Value;
+
+            template <> struct Value<U8>
+            {
+                typedef unsigned char Type;
+
+                static F load(const Type* p) { return V::div(V::cvt(V::loadU8(p)), V::set1(255.0f)); }
+
+                static void store(Type* p, F v)
+                {
+                    v = V::min(V::max(V::add(v, V::set1(0.5f / 255.0f)), V::set1(0.0f)), V::set1(1.0f));
+                    V::storeU8(p, V::cvtt(V::mul(v, V::set1(255.0f))));
+                }
+
+                static float scalarLoad(const Type* p) { return float(*p) / 255.0f; }
+
+                static void scalarStore(Type* p, float v) { *p = Type(clampf(v + 0.5f / 255.0f, 0.0f, 1.0f) * 255.0f); }
+            };
+
+            template <> struct Value<U16>
+            {
+                typedef unsigned short Type;
+
+                static F load(const Type* p) { return V::div(V::cvt(V::loadU16(p)), V::set1(65535.0f)); }
+
+                static void store(Type* p, F v)
+                {
+                    v = V::min(V::max(V::add(v, V::set1(0.5f / 65535.0f)), V::set1(0.0f)), V::set1(1.0f));
+                    V::storeU16(p, V::cvtt(V::mul(v, V::set1(65535.0f))));
+                }
+
+                static float scalarLoad(const Type* p) { return float(*p) / 65535.0f; }
+
+                static void scalarStore(Type* p, float v) { *p = Type(clampf(v + 0.5f / 65535.0f, 0.0f, 1.0f) * 65535.0f); }
+            };
+
+            template <> struct Value<Float>
+            {
+                typedef float Type;
+
+                static F load(const Type* p) { return V::loadu(p); }
+
+                static void store(Type* p, F v) { V::storeu(p, v); }
+
+                static float scalarLoad(const Type* p) { return *p; }
+
+                static void scalarStore(Type* p, float v) { *p = v; }
+            };
+
+#ifdef TWKFB_SIMD_F16C
+            template <> struct Value<Half>
+            {
+                typedef half Type;
+
+                static F load(const Type* p) { return V::loadHalf(p); }
+
+                static void store(Type* p, F v) { V::storeHalf(p, v); }
+
+                static float scalarLoad(const Type* p)
+                {
+                    unsigned short bits;
+                    memcpy(&bits, p, sizeof(bits));
+                    return V::halfToFloat(bits);
+                }
+
+                static void scalarStore(Type* p, float v)
+                {
+                    const unsigned short bits = V::floatToHalf(v);
+                    memcpy(p, &bits, sizeof(bits));
+                }
+            };
+#endif
+
+            template <int A, int B> void convertKernel(const void* in, void* out, size_t n)
+            {
+                typedef typename Value<A>::Type TA;
+                typedef typename Value<B>::Type TB;
+
+                const TA* a = reinterpret_cast<const TA*>(in);
+                TB* b = reinterpret_cast<TB*>(out);
+                size_t i = 0;
+
+                for (; i + N <= n; i += N)
+                {
+                    Value<B>::store(b + i, Value<A>::load(a + i));
+                }
+
+                for (; i < n; i++)
+                {
+                    Value<B>::scalarStore(b + i, Value<A>::scalarLoad(a + i));
+                }
+            }
+
+            //
+            //  DPX/Cineon unpacking. The 10 bit kernels split N words at
+            //  a time into R, G and B lanes, the interleaved layouts are
+            //  then written 4 pixels at a time with SSE shuffles. The 12
+            //  bit ones pull the channels out of 8 pixels at a time with
+            //  SSE, which every level has.
+            //
+
+            inline unsigned int swap32(unsigned int v) { return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24); }
+
+            //
+            //  65535 * v / 1023 is 64 * v + 21 * v / 341, the second
+            //  part is a multiply and shift which is exact for v < 1024
+            //
+
+            inline unsigned int dpx10To16(unsigned int v) { return (v << 6) + ((v * 1033221u) >> 24); }
+
+            inline unsigned int dpx10To8(unsigned int v) { return minu((v + 1) >> 2, 255u); }
+
+            inline I dpx10To16(I v) { return V::addi(V::slli<6>(v), V::srli<24>(V::mulloi(v, V::set1i(1033221)))); }
+
+            inline I dpx10To8(I v) { return V::mini(V::srli<2>(V::addi(v, V::set1i(1))), V::set1i(255)); }
+
+            inline void storeRGB16x4(unsigned short* p, __m128i r, __m128i g, __m128i b)
+            {
+                const __m128i rg = _mm_packus_epi32(r, g);
+                const __m128i bb = _mm_packus_epi32(b, b);
+                const __m128i rgLo = _mm_setr_epi8(0, 1, 8, 9, -1, -1, 2, 3, 10, 11, -1, -1, 4, 5, 12, 13);
+                const __m128i bbLo = _mm_setr_epi8(-1, -1, -1, -1, 0, 1, -1, -1, -1, -1, 2, 3, -1, -1, -1, -1);
+                const __m128i rgHi = _mm_setr_epi8(-1, -1, 6, 7, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+                const __m128i bbHi = _mm_setr_epi8(4, 5, -1, -1, -1, -1, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+                const __m128i lo = _mm_or_si128(_mm_shuffle_epi8(rg, rgLo), _mm_shuffle_epi8(bb, bbLo));
+                const __m128i hi = _mm_or_si128(_mm_shuffle_epi8(rg, rgHi), _mm_shuffle_epi8(bb, bbHi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), lo);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(p + 8), hi);
+            }
+
+            inline void storeRGBA16x4(unsigned short* p, __m128i r, __m128i g, __m128i b)
+            {
+                const __m128i rg = _mm_packus_epi32(r, g);
+                const __m128i ba = _mm_packus_epi32(b, _mm_set1_epi32(65535));
+                const __m128i rgs = _mm_unpacklo_epi16(rg, _mm_srli_si128(rg, 8));
+                const __m128i bas = _mm_unpacklo_epi16(ba, _mm_srli_si128(ba, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_unpacklo_epi32(rgs, bas));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 8), _mm_unpackhi_epi32(rgs, bas));
+            }
+
+            inline void storeRGB8x4(unsigned char* p, __m128i r, __m128i g, __m128i b)
+            {
+                const __m128i v = _mm_packus_epi16(_mm_packus_epi32(r, g), _mm_packus_epi32(b, b));
+                const __m128i s = _mm_shuffle_epi8(v, _mm_setr_epi8(0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11, -1, -1, -1, -1));
+                const int last = _mm_cvtsi128_si32(_mm_srli_si128(s, 8));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(p), s);
+                memcpy(p + 8, &last, sizeof(last));
+            }
+
+            inline void storeRGBA8x4(unsigned char* p, __m128i r, __m128i g, __m128i b)
+            {
+                const __m128i v = _mm_packus_epi16(_mm_packus_epi32(r, g), _mm_packus_epi32(b, _mm_set1_epi32(255)));
+                const __m128i s = _mm_shuffle_epi8(v, _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p), s);
+            }
+
+            //
+            //  store() writes the N pixels starting at pixel i,
+            //  scalarStore() one
+            //
+
+            template <int L> struct Unpack10;
+
+            template <> struct Unpack10<UnpackRGB8>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    unsigned char* p = reinterpret_cast<unsigned char*>(out[0]) + i * 3;
+                    r = dpx10To8(r);
+                    g = dpx10To8(g);
+                    b = dpx10To8(b);
+
+                    for (size_t q = 0; q < V::Quads; q++)
+                    {
+                        storeRGB8x4(p + q * 12, V::quad(r, q), V::quad(g, q), V::quad(b, q));
+                    }
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    unsigned char* p = reinterpret_cast<unsigned char*>(out[0]) + i * 3;
+                    p[0] = dpx10To8(r);
+                    p[1] = dpx10To8(g);
+                    p[2] = dpx10To8(b);
+                }
+            };
+
+            template <> struct Unpack10<UnpackRGBA8>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    unsigned char* p = reinterpret_cast<unsigned char*>(out[0]) + i * 4;
+                    r = dpx10To8(r);
+                    g = dpx10To8(g);
+                    b = dpx10To8(b);
+
+                    for (size_t q = 0; q < V::Quads; q++)
+                    {
+                        storeRGBA8x4(p + q * 16, V::quad(r, q), V::quad(g, q), V::quad(b, q));
+                    }
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    unsigned char* p = reinterpret_cast<unsigned char*>(out[0]) + i * 4;
+                    p[0] = dpx10To8(r);
+                    p[1] = dpx10To8(g);
+                    p[2] = dpx10To8(b);
+                    p[3] = 255;
+                }
+            };
+
+            template <> struct Unpack10<UnpackRGB16>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    unsigned short* p = reinterpret_cast<unsigned short*>(out[0]) + i * 3;
+                    r = dpx10To16(r);
+                    g = dpx10To16(g);
+                    b = dpx10To16(b);
+
+                    for (size_t q = 0; q < V::Quads; q++)
+                    {
+                        storeRGB16x4(p + q * 12, V::quad(r, q), V::quad(g, q), V::quad(b, q));
+                    }
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    unsigned short* p = reinterpret_cast<unsigned short*>(out[0]) + i * 3;
+                    p[0] = dpx10To16(r);
+                    p[1] = dpx10To16(g);
+                    p[2] = dpx10To16(b);
+                }
+            };
+
+            template <> struct Unpack10<UnpackRGBA16>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    unsigned short* p = reinterpret_cast<unsigned short*>(out[0]) + i * 4;
+                    r = dpx10To16(r);
+                    g = dpx10To16(g);
+                    b = dpx10To16(b);
+
+                    for (size_t q = 0; q < V::Quads; q++)
+                    {
+                        storeRGBA16x4(p + q * 16, V::quad(r, q), V::quad(g, q), V::quad(b, q));
+                    }
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    unsigned short* p = reinterpret_cast<unsigned short*>(out[0]) + i * 4;
+                    p[0] = dpx10To16(r);
+                    p[1] = dpx10To16(g);
+                    p[2] = dpx10To16(b);
+                    p[3] = 65535;
+                }
+            };
+
+            template <> struct Unpack10<UnpackPlanar8>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    V::storeU8(reinterpret_cast<unsigned char*>(out[0]) + i, dpx10To8(r));
+                    V::storeU8(reinterpret_cast<unsigned char*>(out[1]) + i, dpx10To8(g));
+                    V::storeU8(reinterpret_cast<unsigned char*>(out[2]) + i, dpx10To8(b));
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    reinterpret_cast<unsigned char*>(out[0])[i] = dpx10To8(r);
+                    reinterpret_cast<unsigned char*>(out[1])[i] = dpx10To8(g);
+                    reinterpret_cast<unsigned char*>(out[2])[i] = dpx10To8(b);
+                }
+            };
+
+            template <> struct Unpack10<UnpackPlanar16>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    V::storeU16(reinterpret_cast<unsigned short*>(out[0]) + i, dpx10To16(r));
+                    V::storeU16(reinterpret_cast<unsigned short*>(out[1]) + i, dpx10To16(g));
+                    V::storeU16(reinterpret_cast<unsigned short*>(out[2]) + i, dpx10To16(b));
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    reinterpret_cast<unsigned short*>(out[0])[i] = dpx10To16(r);
+                    reinterpret_cast<unsigned short*>(out[1])[i] = dpx10To16(g);
+                    reinterpret_cast<unsigned short*>(out[2])[i] = dpx10To16(b);
+                }
+            };
+
+            template <> struct Unpack10<UnpackA2BGR10>
+            {
+                static void store(void* const* out, size_t i, I r, I g, I b)
+                {
+                    V::storei(reinterpret_cast<unsigned int*>(out[0]) + i, V::ori(r, V::ori(V::slli<10>(g), V::slli<20>(b))));
+                }
+
+                static void scalarStore(void* const* out, size_t i, unsigned int r, unsigned int g, unsigned int b)
+                {
+                    reinterpret_cast<unsigned int*>(out[0])[i] = r | (g << 10) | (b << 20);
+                }
+            };
+
+            template <int L> void unpack10Kernel(const void* in, void* const* out, size_t n, bool msbPadded, bool swap)
+            {
+                const unsigned int* words = reinterpret_cast<const unsigned int*>(in);
+                const I mask = V::set1i(0x3ff);
+                size_t i = 0;
+
+                for (; i + N <= n; i += N)
+                {
+                    I w = V::loadi(words + i);
+                    if (swap)
+                        w = V::bswap32(w);
+                    if (!msbPadded)
+                        w = V::srli<2>(w);
+
+                    Unpack10<L>::store(out, i, V::andi(V::srli<20>(w), mask), V::andi(V::srli<10>(w), mask), V::andi(w, mask));
+                }
+
+                for (; i < n; i++)
+                {
+                    unsigned int w = swap ? swap32(words[i]) : words[i];
+                    if (!msbPadded)
+                        w >>= 2;
+
+                    Unpack10<L>::scalarStore(out, i, (w >> 20) & 0x3ff, (w >> 10) & 0x3ff, w & 0x3ff);
+                }
+            }
+
+            //
+            //  Shuffles pulling channel c of 8 pixels (24 words) out of
+            //  each of the three vectors holding them, swapping the
+            //  bytes of each word too if swap.
+            //
+
+            struct Deinterleave3x16
+            {
+                __m128i masks[3][3];
+
+                Deinterleave3x16(bool swap)
+                {
+                    for (int c = 0; c < 3; c++)
+                    {
+                        for (int s = 0; s < 3; s++)
+                        {
+                            signed char m[16];
+
+                            for (int j = 0; j < 16; j++)
+                            {
+                                const int byte = (3 * (j / 2) + c) * 2 + (j % 2);
+                                m[j] = byte / 16 == s ? char((byte % 16) ^ (swap ? 1 : 0)) : char(-1);
+                            }
+
+                            masks[c][s] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m));
+                        }
+                    }
+                }
+
+                __m128i channel(const __m128i* v, int c) const
+                {
+                    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v[0], masks[c][0]), _mm_shuffle_epi8(v[1], masks[c][1])),
+                                        _mm_shuffle_epi8(v[2], masks[c][2]));
+                }
+            };
+
+            template <int L> void unpack12Kernel(const void* in, void* const* out, size_t n, bool msbPadded, bool swap)
+            {
+                const unsigned short* words = reinterpret_cast<const unsigned short*>(in);
+                const Deinterleave3x16 d(swap);
+                const __m128i mask = _mm_set1_epi16(0x0fff);
+                size_t i = 0;
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    const __m128i* p = reinterpret_cast<const __m128i*>(words + i * 3);
+                    const __m128i v[3] = {_mm_loadu_si128(p), _mm_loadu_si128(p + 1), _mm_loadu_si128(p + 2)};
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        const __m128i x = d.channel(v, c);
+
+                        if (L == UnpackPlanar16)
+                        {
+                            const __m128i y = msbPadded ? _mm_slli_epi16(x, 4) : x;
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(reinterpret_cast<unsigned short*>(out[c]) + i), y);
+                        }
+                        else
+                        {
+                            const __m128i y = msbPadded ? _mm_srli_epi16(_mm_and_si128(x, mask), 4) : _mm_srli_epi16(x, 8);
+                            _mm_storel_epi64(reinterpret_cast<__m128i*>(reinterpret_cast<unsigned char*>(out[c]) + i),
+                                             _mm_packus_epi16(y, y));
+                        }
+                    }
+                }
+
+                for (; i < n; i++)
+                {
+                    for (int c = 0; c < 3; c++)
+                    {
+                        unsigned int x = words[i * 3 + c];
+                        if (swap)
+                            x = ((x >> 8) | (x << 8)) & 0xffff;
+
+                        if (L == UnpackPlanar16)
+                            reinterpret_cast<unsigned short*>(out[c])[i] = msbPadded ? (x << 4) & 0xffff : x;
+                        else
+                            reinterpret_cast<unsigned char*>(out[c])[i] = msbPadded ? (x & 0x0fff) >> 4 : x >> 8;
+                    }
+                }
+            }
+
+            void shiftLeft16Kernel(const void* in, void* out, size_t n, int shift)
+            {
+                const unsigned short* src = reinterpret_cast<const unsigned short*>(in);
+                unsigned short* dst = reinterpret_cast<unsigned short*>(out);
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                const size_t step = sizeof(I) / sizeof(unsigned short);
+                size_t i = 0;
+
+                for (; i + step * 2 <= n; i += step * 2)
+                {
+                    const I a = V::loadi(src + i);
+                    const I b = V::loadi(src + i + step);
+                    V::storei(dst + i, V::sll16(a, count));
+                    V::storei(dst + i + step, V::sll16(b, count));
+                }
+
+                for (; i + step <= n; i += step)
+                {
+                    V::storei(dst + i, V::sll16(V::loadi(src + i), count));
+                }
+
+                for (; i < n; i++)
+                {
+                    dst[i] = (unsigned short)(src[i] << shift);
+                }
+            }
+
+            void fillKernelTable(KernelTable& t)
+            {
+                memset(&t, 0, sizeof(KernelTable));
+
+                t.convert[U8][Float] = convertKernel<U8, Float>;
+                t.convert[U16][Float] = convertKernel<U16, Float>;
+                t.convert[Float][U8] = convertKernel<Float, U8>;
+                t.convert[Float][U16] = convertKernel<Float, U16>;
+
+#ifdef TWKFB_SIMD_F16C
+                t.convert[Half][Float] = convertKernel<Half, Float>;
+                t.convert[Float][Half] = convertKernel<Float, Half>;
+                t.convert[U8][Half] = convertKernel<U8, Half>;
+                t.convert[U16][Half] = convertKernel<U16, Half>;
+                t.convert[Half][U8] = convertKernel<Half, U8>;
+                t.convert[Half][U16] = convertKernel<Half, U16>;
+#endif
+
+                t.transform[SRGBToLinear] = maskedTransform<SRGBToLinearOp>;
+                t.transform[LinearToSRGB] = maskedTransform<LinearToSRGBOp>;
+                t.transform[Rec709ToLinear] = maskedTransform<Rec709ToLinearOp>;
+                t.transform[LinearToRec709] = maskedTransform<LinearToRec709Op>;
+                t.transform[CineonLogToLinear] = maskedTransform<CineonLogToLinearOp>;
+                t.transform[LinearToCineonLog] = maskedTransform<LinearToCineonLogOp>;
+                t.transform[LogCToLinear] = maskedTransform<LogCToLinearOp>;
+                t.transform[LinearToLogC] = maskedTransform<LinearToLogCOp>;
+                t.transform[Power] = maskedTransform<PowerOp>;
+                t.transform[Premult] = premultKernel;
+                t.transform[Unpremult] = unpremultKernel;
+                t.transform[Matrix] = matrixKernel;
+
+                t.weightedSum = weightedSumKernel;
+                t.filterPixels4 = filterPixels4Kernel;
+
+                t.unpack10[UnpackRGB8] = unpack10Kernel<UnpackRGB8>;
+                t.unpack10[UnpackRGBA8] = unpack10Kernel<UnpackRGBA8>;
+                t.unpack10[UnpackRGB16] = unpack10Kernel<UnpackRGB16>;
+                t.unpack10[UnpackRGBA16] = unpack10Kernel<UnpackRGBA16>;
+                t.unpack10[UnpackPlanar8] = unpack10Kernel<UnpackPlanar8>;
+                t.unpack10[UnpackPlanar16] = unpack10Kernel<UnpackPlanar16>;
+                t.unpack10[UnpackA2BGR10] = unpack10Kernel<UnpackA2BGR10>;
+                t.unpack12[UnpackPlanar8] = unpack12Kernel<UnpackPlanar8>;
+                t.unpack12[UnpackPlanar16] = unpack12Kernel<UnpackPlanar16>;
+
+                t.shiftLeft16 = shiftLeft16Kernel;
+            }
+
+        } // namespace
+    } // namespace SIMD
+} // namespace TwkFB
@@ -0,0 +1,155 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Compiled with SSE4.1 enabled (see CMakeLists.txt). Only called once
+//  SIMD::level() has checked the CPU has it.
+//
+
+#include "SIMDKernelTable.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <smmintrin.h>
+#include <string.h>
+
+namespace TwkFB
+{
+    namespace SIMD
+    {
+        namespace
+        {
+            struct V
+            {
+                typedef __m128 F;
+                typedef __m128i I;
+
+                static const size_t N = 4;
+
+                static F set1(float f) { return _mm_set1_ps(f); }
+
+                static F loadu(const float* p) { return _mm_loadu_ps(p); }
+
+                static void storeu(float* p, F v) { _mm_storeu_ps(p, v); }
+
+                static F add(F a, F b) { return _mm_add_ps(a, b); }
+
+                static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+
+                static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+
+                static F div(F a, F b) { return _mm_div_ps(a, b); }
+
+                static F min(F a, F b) { return _mm_min_ps(a, b); }
+
+                static F max(F a, F b) { return _mm_max_ps(a, b); }
+
+                static F fmadd(F a, F b, F c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+                static F floor(F a) { return _mm_floor_ps(a); }
+
+                static F cmpeq(F a, F b) { return _mm_cmpeq_ps(a, b); }
+
+                static F cmpneq(F a, F b) { return _mm_cmpneq_ps(a, b); }
+
+                static F cmplt(F a, F b) { return _mm_cmplt_ps(a, b); }
+
+                static F cmple(F a, F b) { return _mm_cmple_ps(a, b); }
+
+                static F cmpgt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+
+                static F cmpge(F a, F b) { return _mm_cmpge_ps(a, b); }
+
+                static F and_(F a, F b) { return _mm_and_ps(a, b); }
+
+                static F or_(F a, F b) { return _mm_or_ps(a, b); }
+
+                static F andnot(F a, F b) { return _mm_andnot_ps(a, b); }
+
+                static F blendv(F a, F b, F m) { return _mm_blendv_ps(a, b, m); }
+
+                static int movemask(F a) { return _mm_movemask_ps(a); }
+
+                static I castToInt(F a) { return _mm_castps_si128(a); }
+
+                static F castToFloat(I a) { return _mm_castsi128_ps(a); }
+
+                static F cvt(I a) { return _mm_cvtepi32_ps(a); }
+
+                static I cvtt(F a) { return _mm_cvttps_epi32(a); }
+
+                static I set1i(int i) { return _mm_set1_epi32(i); }
+
+                static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+
+                static I subi(I a, I b) { return _mm_sub_epi32(a, b); }
+
+                static I andi(I a, I b) { return _mm_and_si128(a, b); }
+
+                static I ori(I a, I b) { return _mm_or_si128(a, b); }
+
+                static I mulloi(I a, I b) { return _mm_mullo_epi32(a, b); }
+
+                static I mini(I a, I b) { return _mm_min_epi32(a, b); }
+
+                static I srli23(I a) { return _mm_srli_epi32(a, 23); }
+
+                static I slli23(I a) { return _mm_slli_epi32(a, 23); }
+
+                template <int S> static I srli(I a) { return _mm_srli_epi32(a, S); }
+
+                template <int S> static I slli(I a) { return _mm_slli_epi32(a, S); }
+
+                static I bswap32(I a) { return _mm_shuffle_epi8(a, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)); }
+
+                static I sll16(I a, __m128i count) { return _mm_sll_epi16(a, count); }
+
+                static I loadi(const void* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+                static void storei(void* p, I v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+                static const size_t Quads = 1;
+
+                static __m128i quad(I a, size_t) { return a; }
+
+                static I loadU8(const unsigned char* p)
+                {
+                    int v;
+                    memcpy(&v, p, sizeof(v));
+                    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v));
+                }
+
+                static I loadU16(const unsigned short* p)
+                {
+                    return _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+                }
+
+                static void storeU8(unsigned char* p, I v)
+                {
+                    const __m128i w = _mm_packus_epi32(v, v);
+                    const int b = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+                    memcpy(p, &b, sizeof(b));
+                }
+
+                static void storeU16(unsigned short* p, I v)
+                {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi32(v, v));
+                }
+            };
+
+        } // namespace
+    } // namespace SIMD
+} // namespace TwkFB
+
+#include "SIMDKernelsImpl.h"
+
+void TwkFB::SIMD::fillKernelTableSSE41(KernelTable& t) { fillKernelTable(t); }
+
+#else
+
+void TwkFB::SIMD::fillKernelTableSSE41(KernelTable& t) {}
+
+#endif
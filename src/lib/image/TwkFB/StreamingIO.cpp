@@ -6,11 +6,33 @@
 //
 //
 #include <TwkFB/StreamingIO.h>
+#include <TwkUtil/FileStream.h>
 
 namespace TwkFB
 {
     using namespace std;
 
+    namespace
+    {
+
+        class MappedFile : public FrameBuffer::DataOwner
+        {
+        public:
+            MappedFile(void* data, size_t size)
+                : m_data(data)
+                , m_size(size)
+            {
+            }
+
+            virtual ~MappedFile() { TwkUtil::FileStream::unmapMemory(m_data, m_size); }
+
+        private:
+            void* m_data;
+            size_t m_size;
+        };
+
+    } // namespace
+
     StreamingFrameBufferIO::~StreamingFrameBufferIO() {}
 
     int StreamingFrameBufferIO::getIntAttribute(const std::string& name) const
@@ -34,4 +56,11 @@ namespace TwkFB
             m_iotype = (IOType)value;
     }
 
+    FrameBuffer::DataOwnerPtr StreamingFrameBufferIO::adoptMemoryMap(TwkUtil::FileStream& stream)
+    {
+        if (!stream.releaseMemoryMap())
+            return FrameBuffer::DataOwnerPtr();
+        return FrameBuffer::DataOwnerPtr(new MappedFile(stream.data(), stream.size()));
+    }
+
 } // namespace TwkFB
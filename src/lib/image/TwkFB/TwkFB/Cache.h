@@ -77,6 +77,20 @@ namespace TwkFB
 
         size_t capacity() const { return m_maxBytes; }
 
+        size_t budget() const { return m_budget; }
+
+        //
+        //  Image memory held outside any cache (e.g. decoded frames a
+        //  movie reader keeps around) is counted here, so are the files
+        //  read ahead by TwkUtil::FileStream. Each cache's capacity is
+        //  its budget less these bytes, but never less than half of the
+        //  budget.
+        //
+
+        static void addOutsideBytes(size_t bytes);
+        static void removeOutsideBytes(size_t bytes);
+        static size_t outsideBytes();
+
         size_t used() const { return m_currentBytes; }
 
         //
@@ -192,6 +206,16 @@ namespace TwkFB
 
         static void lock(FrameBuffer* fb) { fb->lockCache(); }
 
+        //
+        //  An fb has to be retired before it's deleted or its pixels are
+        //  released. Returns false if it's pinned: leave it alone. A
+        //  retired fb can't be pinned until restorePins() is called.
+        //
+
+        static bool retirePins(FrameBuffer* fb) { return fb->retireCachePins(); }
+
+        static void restorePins(FrameBuffer* fb) { fb->restoreCachePins(); }
+
         virtual void clearInternal();
 
         //
@@ -205,6 +229,28 @@ namespace TwkFB
 
         bool freeTrash(size_t bytes);
         int trashCount() const;
+
+        //
+        //  Called by freeTrash() just before an unreferenced fb is
+        //  deleted to make room. The fb is no longer in the map. A
+        //  derived cache can keep the contents somewhere cheaper than
+        //  RAM: returning true takes the fb over, it's not deleted and
+        //  forgetFB() is left to the derived cache.
+        //
+
+        virtual bool aboutToDeleteFB(FrameBuffer*) { return false; }
+
+        //
+        //  The number of bytes the cache accounts for a cached fb and a
+        //  hook called just before any cached fb is deleted. A derived
+        //  cache which holds some fbs in another form (e.g. compressed)
+        //  overrides both.
+        //
+
+        virtual size_t cachedSize(const FrameBuffer* fb) const { return fb->totalImageSize(); }
+
+        virtual void forgetFB(FrameBuffer*) {}
+
         bool trashContains(FrameBuffer* fb);
         size_t deleteFB(FrameBuffer* fb);
 
@@ -223,9 +269,17 @@ namespace TwkFB
 
         bool hasOneReference(FrameBuffer* fb) const { return fb->m_cacheRef == 1; }
 
+        //
+        //  Recomputes the capacity from the budget and the current
+        //  outside bytes
+        //
+
+        void updateCapacity();
+
     protected:
         bool m_full;
         size_t m_maxBytes;
+        size_t m_budget;
         size_t m_currentBytes;
         size_t m_retrieveTime;
         FBMap m_map;
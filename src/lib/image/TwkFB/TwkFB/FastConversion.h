@@ -230,6 +230,145 @@ extern "C"
     TWKFB_EXPORT void packedBGRA64BE_to_packedABGR64LE_MP(size_t width, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
                                                           uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride);
 
+    /// @brief Packing of 10 and 12 bit DPX/Cineon components, the values of
+    /// the DPX image element packing field.
+    ///
+    /// DPX_UNPACK_PACKED components follow each other with no padding, least
+    /// significant bits first in each 32-bit word, and each row starts on a
+    /// word. DPX_UNPACK_FILLED_A (the common one) fills a 32-bit word per 10
+    /// bit pixel or a 16-bit word per 12 bit component with the padding in
+    /// the least significant bits, DPX_UNPACK_FILLED_B in the most
+    /// significant bits. In a 10 bit pixel word R is the most significant
+    /// component.
+    enum DPXUnpackPacking
+    {
+        DPX_UNPACK_PACKED = 0,
+        DPX_UNPACK_FILLED_A = 1,
+        DPX_UNPACK_FILLED_B = 2
+    };
+
+    /// @brief Returns the size in bytes of a row of DPX/Cineon RGB pixels.
+    ///
+    /// @param width The number of pixels per row.
+    /// @param bits The bits per component, 10 or 12.
+    /// @param packing A DPXUnpackPacking.
+    TWKFB_EXPORT size_t unpackDPX_rowSize(size_t width, int bits, int packing);
+
+    /// @brief Unpacks 10 bit DPX/Cineon RGB pixels to interleaved RGB or RGBA
+    /// 16-bits.
+    ///
+    /// Values v go to 65535 * v / 1023 rounded down and alpha, if there's
+    /// one, is 65535. Uses the SIMD kernels (TwkFB/SIMDKernels.h) for the
+    /// filled packings when the CPU has them.
+    ///
+    /// @param width The number of pixels per row.
+    /// @param height The number of rows.
+    /// @param inBuf The input buffer.
+    /// @param inStride The stride of the input buffer in bytes.
+    /// @param outBuf The output buffer.
+    /// @param outStride The stride of the output buffer in bytes.
+    /// @param nchannels The number of output channels, 3 or 4.
+    /// @param packing A DPXUnpackPacking.
+    /// @param swap Byte swap the input words.
+    TWKFB_EXPORT void unpackDPX10_to_RGB16(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                           uint16_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX10_to_RGB16_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                              uint16_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing,
+                                              bool swap);
+
+    /// @brief Unpacks 10 bit DPX/Cineon RGB pixels to interleaved RGB or RGBA
+    /// 8-bits.
+    ///
+    /// Values v go to min((v + 1) >> 2, 255) and alpha, if there's one, is
+    /// 255. Parameters as for unpackDPX10_to_RGB16().
+    TWKFB_EXPORT void unpackDPX10_to_RGB8(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                          uint8_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX10_to_RGB8_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                             uint8_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int nchannels, int packing, bool swap);
+
+    /// @brief Unpacks 10 bit DPX/Cineon RGB pixels to planar RGB 16-bits.
+    ///
+    /// @param width The number of pixels per row.
+    /// @param height The number of rows.
+    /// @param inBuf The input buffer.
+    /// @param inStride The stride of the input buffer in bytes.
+    /// @param outR The output channel buffer of the R component.
+    /// @param outG The output channel buffer of the G component.
+    /// @param outB The output channel buffer of the B component.
+    /// @param outStride The stride of each output channel buffer in bytes.
+    /// @param packing A DPXUnpackPacking.
+    /// @param swap Byte swap the input words.
+    TWKFB_EXPORT void unpackDPX10_to_planarRGB16(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                 uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG,
+                                                 uint16_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX10_to_planarRGB16_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                    uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG,
+                                                    uint16_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+
+    /// @brief Unpacks 10 bit DPX/Cineon RGB pixels to planar RGB 8-bits.
+    ///
+    /// Parameters as for unpackDPX10_to_planarRGB16().
+    TWKFB_EXPORT void unpackDPX10_to_planarRGB8(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG,
+                                                uint8_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX10_to_planarRGB8_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                   uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG,
+                                                   uint8_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+
+    /// @brief Unpacks 10 bit DPX/Cineon RGB pixels to the 32-bit words of
+    /// FrameBuffer::PACKED_X2_B10_G10_R10 (R in the least significant bits).
+    ///
+    /// Parameters as for unpackDPX10_to_RGB16() less nchannels.
+    TWKFB_EXPORT void unpackDPX10_to_A2BGR10(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                             uint32_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX10_to_A2BGR10_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                uint32_t* FASTMEMCPYRESTRICT outBuf, size_t outStride, int packing, bool swap);
+
+    /// @brief Unpacks 12 bit DPX RGB pixels to planar RGB 16-bits.
+    ///
+    /// Method A words are passed through, the other packings have their 12
+    /// bit values shifted up by 4. swap byte swaps the 16-bit words of the
+    /// filled packings and the 32-bit ones of DPX_UNPACK_PACKED. Parameters
+    /// as for unpackDPX10_to_planarRGB16().
+    TWKFB_EXPORT void unpackDPX12_to_planarRGB16(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                 uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG,
+                                                 uint16_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX12_to_planarRGB16_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                    uint16_t* FASTMEMCPYRESTRICT outR, uint16_t* FASTMEMCPYRESTRICT outG,
+                                                    uint16_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+
+    /// @brief Unpacks 12 bit DPX RGB pixels to planar RGB 8-bits (the top 8
+    /// bits of the 12 bit values).
+    ///
+    /// Parameters as for unpackDPX12_to_planarRGB16().
+    TWKFB_EXPORT void unpackDPX12_to_planarRGB8(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG,
+                                                uint8_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+    TWKFB_EXPORT void unpackDPX12_to_planarRGB8_MP(size_t width, size_t height, const void* FASTMEMCPYRESTRICT inBuf, size_t inStride,
+                                                   uint8_t* FASTMEMCPYRESTRICT outR, uint8_t* FASTMEMCPYRESTRICT outG,
+                                                   uint8_t* FASTMEMCPYRESTRICT outB, size_t outStride, int packing, bool swap);
+
+    /// @brief Moves planar 9 to 15 bit samples, like those of FFmpeg's
+    /// yuv420p10le, yuv422p10le or yuv444p12le, to 16-bits.
+    ///
+    /// Values are shifted up by 16 - bits, which is what sws_scale() does
+    /// going to the 16-bit format of the same layout when the range isn't
+    /// full. Uses the SIMD kernels (TwkFB/SIMDKernels.h) when the CPU has
+    /// them. Call once per plane. The input and output can be the same
+    /// plane with the same stride, to shift it in place.
+    ///
+    /// @param width The number of samples per row of the plane.
+    /// @param height The number of rows of the plane.
+    /// @param inBuf The input plane.
+    /// @param inStride The stride of the input plane in bytes.
+    /// @param outBuf The output plane.
+    /// @param outStride The stride of the output plane in bytes.
+    /// @param bits The bits per input sample, 9 to 16.
+    TWKFB_EXPORT void planarN_to_planar16(size_t width, size_t height, const uint16_t* inBuf, size_t inStride, uint16_t* outBuf,
+                                          size_t outStride, int bits);
+    TWKFB_EXPORT void planarN_to_planar16_MP(size_t width, size_t height, const uint16_t* inBuf, size_t inStride, uint16_t* outBuf,
+                                             size_t outStride, int bits);
+
 #ifdef __cplusplus
 }
 #endif
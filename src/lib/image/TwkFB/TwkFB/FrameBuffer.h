@@ -12,6 +12,7 @@
 #include <TwkMath/Chromaticities.h>
 #include <assert.h>
 #include <atomic>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -550,6 +551,40 @@ namespace TwkFB
         void ownData();
         void relinquishDataAndReset();
 
+        //
+        //  Free the pixels of all planes but keep the structure. A cache
+        //  that holds the pixels in some other form (compressed, on disk)
+        //  uses this and calls reallocateData() to get uninitialized
+        //  pixels back before filling them in again. Only valid for an
+        //  fb that owns its data.
+        //
+
+        void releaseData();
+        void reallocateData();
+
+        bool hasData() const { return m_data != 0; }
+
+        //
+        //  Pixels that live in something else than a large block, like
+        //  a memory mapped file, can be handed to restructure() with
+        //  deleteOnDestruction false and kept alive by a DataOwner. Each
+        //  plane pointing into it holds a reference, reference copies
+        //  share it and the last one going away deletes it. ownData()
+        //  and releaseData() let go of it.
+        //
+
+        class TWKFB_EXPORT DataOwner
+        {
+        public:
+            virtual ~DataOwner();
+        };
+
+        typedef std::shared_ptr<DataOwner> DataOwnerPtr;
+
+        void setDataOwner(const DataOwnerPtr& owner);
+
+        const DataOwnerPtr& dataOwner() const { return m_dataOwner; }
+
         //
         //  Planar FrameBuffers are a linked list of FrameBuffers. A Plane
         //  could be a layer (with RGB for each plane for example), or it
@@ -962,11 +997,43 @@ namespace TwkFB
 
         bool hasStaticRef() const { return m_staticRef != 0; }
 
+        //
+        //  Pins let a thread use the pixels of a cached fb without the
+        //  cache lock (see FBCache::pinFrameItems()). The cache retires
+        //  an fb before deleting it or releasing its pixels, which fails
+        //  while it's pinned. cachePin() fails once it's retired.
+        //
+
+        bool cachePin() const
+        {
+            int n = m_cachePins.load(std::memory_order_relaxed);
+
+            while (n >= 0)
+            {
+                if (m_cachePins.compare_exchange_weak(n, n + 1, std::memory_order_acquire))
+                    return true;
+            }
+
+            return false;
+        }
+
+        void cacheUnpin() const { m_cachePins.fetch_sub(1, std::memory_order_release); }
+
+        bool isCachePinned() const { return m_cachePins.load(std::memory_order_acquire) > 0; }
+
     private:
         void lockCache() { m_cacheLock++; }
 
         void unlockCache() { m_cacheLock = m_cacheLock > 0 ? m_cacheLock - 1 : 0; }
 
+        bool retireCachePins()
+        {
+            int n = 0;
+            return m_cachePins.compare_exchange_strong(n, -1, std::memory_order_acquire) || n < 0;
+        }
+
+        void restoreCachePins() { m_cachePins.store(0, std::memory_order_release); }
+
     protected:
         void recalcStrides();
         void clear();
@@ -982,6 +1049,7 @@ namespace TwkFB
         CoordinateTypes m_coordinateType;
         bool m_deleteDataOnDestruction;
         unsigned char* m_deletePointer;
+        DataOwnerPtr m_dataOwner;
         unsigned char* m_data;
         int m_width;
         int m_height;
@@ -1027,6 +1095,7 @@ namespace TwkFB
         size_t m_cacheRef;
 
         mutable std::atomic<int> m_staticRef{0};
+        mutable std::atomic<int> m_cachePins{0}; // -1 once retired
 
         //
         // Names of each channel
@@ -292,6 +292,7 @@ namespace TwkFB
                 , useInputStructure(false)
                 , preferSubsampledPlanar(false)
                 , bruteForce(false)
+                , parallelDecode(false)
                 , x0(0)
                 , y0(0)
                 , x1(0)
@@ -311,6 +312,15 @@ namespace TwkFB
 
             bool bruteForce;
 
+            //
+            //  If true the image is wanted right away (e.g. its the frame
+            //  on screen). Readers which can should split the decode
+            //  into tile or scanline chunks and run them concurrently on
+            //  the TwkFB::ThreadPool.
+            //
+
+            bool parallelDecode;
+
             //
             //  To read a subset or derezed version of the image you can
             //  set these to non-0. If the reader does succeed in reading
@@ -325,6 +335,15 @@ namespace TwkFB
             //  is reader dependent. Not all readers are expected to have
             //  this ability.
             //
+            //  The region x0, y0 - x1, y1 is half open and in full
+            //  resolution pixels with the origin at the top left of the
+            //  image (the display window origin for EXR). Readers can
+            //  return any scale at or above the requested one (e.g. the
+            //  nearest power of two level) and any superset of the
+            //  region. The returned FB holds the pixels read with its
+            //  uncrop set to the whole (scaled) image and the offset of
+            //  what was read.
+            //
 
             float resolution;
 
@@ -333,6 +352,34 @@ namespace TwkFB
             int x1;
             int y1;
 
+            bool hasResolution() const { return resolution > 0.0f && resolution < 1.0f; }
+
+            bool hasRegion() const { return x1 > x0 && y1 > y0; }
+
+            //
+            //  The largest power of two reduction level (0 is full
+            //  size, 1 half size, etc) no smaller than resolution
+            //
+
+            int reductionLevel(int maxLevel) const;
+
+            //
+            //  The region in the pixels of a level which is width x
+            //  height (rounded out and clipped). The whole level if
+            //  there's no region. Returns false if nothing is left.
+            //
+
+            bool regionAtLevel(int level, int width, int height, int& rx0, int& ry0, int& rx1, int& ry1) const;
+
+            //
+            //  Appended to the FB identifier when a subset (scaled,
+            //  region or consumed channels) was asked for so caches don't
+            //  confuse it with the whole image. Empty if the request is
+            //  for the whole image.
+            //
+
+            std::string subsetIdentifier() const;
+
             //
             //  If either is non-empty return the layer/view
             //  requested. Note: layers are things like diffuse, views are
@@ -349,6 +396,23 @@ namespace TwkFB
             StringVector views;
             StringVector channels;
 
+            //
+            //  If not empty, the caller will only use these channels
+            //  (named as they are in the returned FBs). Readers which
+            //  can should skip decoding (and reading) the others; if
+            //  none of them exist read as if this were empty.
+            //
+
+            StringVector consumedChannels;
+
+            //
+            //  True if the caller uses the named channel. An unqualified
+            //  name also matches any layer/view qualified name ending in
+            //  it (e.g. "R" and "diffuse.R") in either direction.
+            //
+
+            bool consumesChannel(const std::string& name) const;
+
             //
             //  If decode parameters exist
             //
@@ -156,6 +156,10 @@ namespace TwkFB
     //  in the to buffer. Pass in the same pointer for from and to for
     //  in-place operation.
     //
+    //  Large images are done in bands of scanlines on the TwkFB thread
+    //  pool so func may be called from several threads at once and
+    //  must not modify data.
+    //
 
     TWKFB_EXPORT void applyTransform(const FrameBuffer* from, FrameBuffer* to, ColorTransformFunc func, void* data);
 
@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __TwkFB__Resize__h__
+#define __TwkFB__Resize__h__
+#include <TwkFB/dll_defs.h>
+#include <TwkFB/FrameBuffer.h>
+
+namespace TwkFB
+{
+
+    //
+    //  Separable resize filters. Box averages the pixels each output
+    //  pixel covers (nearest neighbor when enlarging), Triangle is
+    //  bilinear, Mitchell the Mitchell-Netravali cubic (B = C = 1/3)
+    //  and Lanczos3 a three lobe windowed sinc. The last two are
+    //  sharper but can ring; values going to integer types are clamped.
+    //
+
+    enum ResizeFilter
+    {
+        BoxFilter,
+        TriangleFilter,
+        MitchellFilter,
+        Lanczos3Filter
+    };
+
+    //
+    //  Resizes each plane of from into the matching plane of to, which
+    //  the caller allocates like for nearestNeighborResize(). Each plane
+    //  is scaled by its own size so subsampled chroma planes of planar
+    //  YUV images work as is. The planes of to can have any unpacked
+    //  data type, packed planes of from are unpacked first. Filtering is
+    //  done in float over bands of output scanlines on the TwkFB thread
+    //  pool.
+    //
+
+    TWKFB_EXPORT void filteredResize(const FrameBuffer* from, FrameBuffer* to, ResizeFilter filter = MitchellFilter);
+
+    //
+    //  Returns a new width x height image with the planes of from
+    //  scaled in proportion to its first one (so 4:2:0 stays 4:2:0) in
+    //  the same data types, except packed planes which come back HALF.
+    //
+
+    TWKFB_EXPORT FrameBuffer* filteredResize(const FrameBuffer* from, int width, int height, ResizeFilter filter = MitchellFilter);
+
+    TWKFB_EXPORT const char* resizeFilterName(ResizeFilter);
+
+} // namespace TwkFB
+
+#endif // __TwkFB__Resize__h__
@@ -0,0 +1,164 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __TwkFB__SIMDKernels__h__
+#define __TwkFB__SIMDKernels__h__
+#include <TwkFB/dll_defs.h>
+#include <TwkFB/Operations.h>
+#include <stddef.h>
+
+namespace TwkFB
+{
+    namespace SIMD
+    {
+
+        //
+        //  Vectorized batch kernels for the per value conversions and the
+        //  common ColorTransformFuncs used by Operations. The instruction
+        //  set is picked at run time: AVX2 (with FMA and F16C) or SSE4.1
+        //  on x86_64, otherwise none (Scalar) in which case the callers
+        //  use their existing loops. RV_TWKFB_SIMD=scalar|sse4|avx2 caps
+        //  the level, mostly for comparing results and benchmarking.
+        //
+
+        enum Level
+        {
+            Scalar,
+            SSE41,
+            AVX2
+        };
+
+        TWKFB_EXPORT Level detectedLevel();
+        TWKFB_EXPORT Level level();
+        TWKFB_EXPORT const char* levelName(Level);
+
+        //
+        //  Can't be raised above detectedLevel()
+        //
+
+        TWKFB_EXPORT void setLevel(Level);
+
+        //
+        //  Converts n values. Integers are normalized to [0, 1] and
+        //  floating values going to integers are clamped and rounded to
+        //  nearest. Returns false without touching out if there's no
+        //  kernel for the pair at the current level (the half
+        //  conversions need AVX2).
+        //
+
+        enum ValueType
+        {
+            U8,
+            U16,
+            Half,
+            Float,
+            NumValueTypes
+        };
+
+        TWKFB_EXPORT bool convert(ValueType fromType, const void* in, ValueType toType, void* out, size_t n);
+
+        //
+        //  Batch versions of the ColorTransformFuncs. mask says which of
+        //  the (interleaved) channels are transformed like the bool
+        //  arrays passed to them. values holds the per channel exponents
+        //  of Power and constants the curve of the LogC kinds (see
+        //  Operations.cpp) or a row major Mat44f for Matrix.
+        //
+        //  Blocks holding values the kernels don't handle (NaNs,
+        //  infinities, inputs outside the domain of a curve) are handed
+        //  to fallback, as is any remainder, so the results stay within
+        //  float rounding of calling fallback on everything. Returns
+        //  false if there's no kernel for the kind, channel count and
+        //  level.
+        //
+
+        enum TransformKind
+        {
+            SRGBToLinear,
+            LinearToSRGB,
+            Rec709ToLinear,
+            LinearToRec709,
+            CineonLogToLinear,
+            LinearToCineonLog,
+            LogCToLinear,
+            LinearToLogC,
+            Power,
+            Premult,
+            Unpremult,
+            Matrix,
+            NumTransformKinds
+        };
+
+        struct TransformParams
+        {
+            bool mask[4];
+            float values[4];
+            float constants[16];
+        };
+
+        TWKFB_EXPORT bool transform(TransformKind kind, const TransformParams& params, const float* in, float* out, int nchannels,
+                                    size_t nelements, ColorTransformFunc fallback, void* data);
+
+        //
+        //  The two passes of the separable resize filters (see
+        //  Resize.h). weightedSum sets out[i] to the sum over k < nrows
+        //  of weights[k] * rows[k][i] for n values. filterPixels computes
+        //  npixels 4 channel pixels from the row in: pixel i is the sum
+        //  over k < ntaps of weights[i * ntaps + k] times input pixel
+        //  first[i] + k. Both return false if there's no kernel at the
+        //  current level.
+        //
+
+        TWKFB_EXPORT bool weightedSum(const float* const* rows, const float* weights, int nrows, float* out, size_t n);
+
+        TWKFB_EXPORT bool filterPixels(const float* in, float* out, int nchannels, size_t npixels, const int* first, const float* weights,
+                                       int ntaps);
+
+        //
+        //  Filled 10 and 12 bit DPX/Cineon unpacking (see the unpackDPX
+        //  functions in FastConversion.h). unpack10 reads n 32 bit words
+        //  each holding an RGB pixel, unpack12 n pixels of three 16 bit
+        //  words. msbPadded is filling method B (the padding bits are
+        //  the most significant ones) and swap byte swaps the words
+        //  first. out holds one pointer for the interleaved layouts or
+        //  the R, G and B ones for the planar layouts.
+        //
+        //  10 bit values v go to 16 bits like 65535 * v / 1023 rounded
+        //  down and to 8 bits like min((v + 1) >> 2, 255). The 12 bit
+        //  method A words are passed through to 16 bits and shifted
+        //  down by 8, method B values are shifted up by 4 or down by 4.
+        //  Returns false if there's no kernel for the layout at the
+        //  current level (unpack12 only has the planar ones).
+        //
+
+        enum UnpackLayout
+        {
+            UnpackRGB8,
+            UnpackRGBA8,
+            UnpackRGB16,
+            UnpackRGBA16,
+            UnpackPlanar8,
+            UnpackPlanar16,
+            UnpackA2BGR10,
+            NumUnpackLayouts
+        };
+
+        TWKFB_EXPORT bool unpack10(const void* in, UnpackLayout layout, void* const* out, size_t n, bool msbPadded, bool swap);
+
+        TWKFB_EXPORT bool unpack12(const void* in, UnpackLayout layout, void* const* out, size_t n, bool msbPadded, bool swap);
+
+        //
+        //  Shifts n 16 bit values left by shift (0 to 15) bits, which is
+        //  how 9 to 15 bit planar samples become 16 bit ones (see
+        //  planarN_to_planar16() in FastConversion.h). Returns false if
+        //  there's no kernel at the current level.
+        //
+
+        TWKFB_EXPORT bool shiftLeft16(const void* in, void* out, size_t n, int shift);
+
+    } // namespace SIMD
+} // namespace TwkFB
+
+#endif // __TwkFB__SIMDKernels__h__
@@ -11,12 +11,18 @@
 #include <TwkFB/IO.h>
 #include <iostream>
 
+namespace TwkUtil
+{
+    class FileStream;
+}
+
 namespace TwkFB
 {
 
     //
     //  This class provides an interface to RV in order to talk to FBIO
-    //  objects which use TwkUtil::FileStream
+    //  objects which use TwkUtil::FileStream. Apart from StandardIO the
+    //  IOTypes map onto the FileStream::Types in order.
     //
 
     class TWKFB_EXPORT StreamingFrameBufferIO : public FrameBufferIO
@@ -29,7 +35,8 @@ namespace TwkFB
             UnbufferedIO,
             MemoryMappedIO,
             AsyncBufferedIO,
-            AsyncUnbufferedIO
+            AsyncUnbufferedIO,
+            IOUringIO
         };
 
         StreamingFrameBufferIO(const std::string& identifier, const std::string& sortKey, IOType type = StandardIO,
@@ -56,6 +63,15 @@ namespace TwkFB
 
         void iomaxAsync(size_t t) { m_iomaxAsync = t; }
 
+        //
+        //  Takes over the mapping of a MemoryMap stream. FrameBuffers
+        //  can point straight into the file with the returned owner
+        //  keeping it mapped (see FrameBuffer::setDataOwner()). Returns
+        //  an empty pointer if the stream isn't memory mapped.
+        //
+
+        static FrameBuffer::DataOwnerPtr adoptMemoryMap(TwkUtil::FileStream&);
+
     protected:
         IOType m_iotype;
         size_t m_iosize;
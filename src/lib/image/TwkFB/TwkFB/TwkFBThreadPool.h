@@ -12,17 +12,100 @@
 #include <TwkFB/dll_defs.h>
 #include "IlmThreadPool.h"
 #include <stddef.h> // for size_t
+#include <functional>
 
 namespace TwkFB
 {
     namespace ThreadPool
     {
 
+        //
+        //  The pool is the one executor for decode work in the process.
+        //  It runs the tasks added here and by parallelFor() and, once
+        //  initialize() has been called, OpenEXR's chunk decompression
+        //  too: it is installed as the provider of the IlmThread global
+        //  pool, so Imf::setGlobalThreadCount() only changes how many
+        //  chunks OpenEXR keeps in flight, not the number of threads.
+        //
+        //  Each worker has its own queue and steals from the others
+        //  when it runs dry. Tasks added from a worker are run right
+        //  away by that worker, so a task that waits on tasks of its
+        //  own (an EXR read in a parallelFor band) can't deadlock the
+        //  pool.
+        //
+        //  The size is a quarter of the CPUs (at most 8), the threads
+        //  handing work to the pool do their share too.
+        //  setNumThreads() resizes it (rv's -exrcpus). The
+        //  RV_DECODE_THREAD_COUNT (or the older RV_MEMCPY_THREAD_COUNT)
+        //  environment variable overrides both.
+        //
+        //  shutdown() runs what's queued and joins the workers, tasks
+        //  added after that run on the thread adding them. Stop the
+        //  threads feeding the pool first.
+        //
+
         TWKFB_EXPORT void initialize();
         TWKFB_EXPORT void shutdown();
+        TWKFB_EXPORT void setNumThreads(size_t n);
         TWKFB_EXPORT size_t getNumThreads();
         TWKFB_EXPORT void addTask(ILMTHREAD_NAMESPACE::Task* task);
 
+        //
+        //  Calls f(b, e) over sub-ranges of [begin, end) concurrently on
+        //  the pool and the calling thread and returns when they are all
+        //  done. Sub-ranges are at least grain long, so small ranges are
+        //  run directly by the caller. The first exception thrown by f is
+        //  rethrown once every sub-range has finished.
+        //
+        //  Called from a pool task the whole range is run by that task.
+        //
+
+        typedef std::function<void(size_t, size_t)> RangeFunction;
+
+        TWKFB_EXPORT void parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& f);
+
+        //
+        //  Libraries that only take a thread count (FFmpeg codecs) get
+        //  their share of the pool from codecThreadCount(): the pool
+        //  size split between the client threads (the IPGraph eval
+        //  threads) that may be decoding at the same time.
+        //
+
+        TWKFB_EXPORT void setNumClientThreads(size_t n);
+        TWKFB_EXPORT size_t codecThreadCount();
+
+        //
+        //  Per subsystem metrics. tasks counts the tasks run by the
+        //  workers and inlineTasks those run by the thread adding them
+        //  (pool tasks, or no workers), seconds is the time spent in
+        //  both. Subsystems sizing their own threads from the pool
+        //  report them with addExternalThreads(), which counts the
+        //  requests and the threads. RV_DECODE_THREAD_STATS prints them
+        //  on shutdown().
+        //
+
+        enum Subsystem
+        {
+            TwkFBSubsystem,
+            EXRSubsystem,
+            FFmpegSubsystem,
+            NumSubsystems
+        };
+
+        struct SubsystemStats
+        {
+            size_t tasks;
+            size_t inlineTasks;
+            double seconds;
+            size_t externalRequests;
+            size_t externalThreads;
+        };
+
+        TWKFB_EXPORT const char* subsystemName(Subsystem);
+        TWKFB_EXPORT SubsystemStats stats(Subsystem);
+        TWKFB_EXPORT void resetStats();
+        TWKFB_EXPORT void addExternalThreads(Subsystem, size_t n);
+
     } // namespace ThreadPool
 } // namespace TwkFB
 
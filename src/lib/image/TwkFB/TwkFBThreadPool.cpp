@@ -13,27 +13,486 @@
 #include <IlmThreadPool.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
 
 namespace TwkFB
 {
     namespace ThreadPool
     {
 
-        static ILMTHREAD_NAMESPACE::ThreadPool memcpyThreadPool;
-        static size_t numThreads;
+        namespace
+        {
+            using ILMTHREAD_NAMESPACE::Task;
+
+            typedef std::chrono::steady_clock Clock;
+
+            struct Counters
+            {
+                std::atomic<size_t> tasks;
+                std::atomic<size_t> inlineTasks;
+                std::atomic<size_t> nanoseconds;
+                std::atomic<size_t> externalRequests;
+                std::atomic<size_t> externalThreads;
+            };
+
+            Counters counters[NumSubsystems];
+
+            thread_local bool onWorker = false;
+
+            void run(Task* task, Subsystem subsystem, bool inlined)
+            {
+                const Clock::time_point start = Clock::now();
+
+                task->execute();
+
+                Counters& c = counters[subsystem];
+                (inlined ? c.inlineTasks : c.tasks)++;
+                c.nanoseconds += size_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+                //
+                //  Deleting the task tells its TaskGroup it's done
+                //
+
+                delete task;
+            }
+
+            class Executor
+            {
+            public:
+                Executor()
+                    : m_queued(0)
+                    , m_outstanding(0)
+                    , m_next(0)
+                    , m_stopping(false)
+                {
+                }
+
+                size_t size() const
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_stopping ? 0 : m_workers.size();
+                }
+
+                void start(size_t n)
+                {
+                    stop();
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = false;
+
+                    for (size_t i = 0; i < n; i++)
+                        m_workers.emplace_back(new Worker);
+                    for (size_t i = 0; i < n; i++)
+                        m_workers[i]->thread = std::thread(&Executor::work, this, i);
+                }
+
+                //
+                //  Tasks submitted from here on run inline. The workers
+                //  run what's queued before they exit, anything left
+                //  after they're joined is run here.
+                //
+
+                void stop()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stopping = true;
+                    }
+
+                    m_wake.notify_all();
+
+                    //
+                    //  Only start() and stop() change m_workers and
+                    //  they're called from one thread
+                    //
+
+                    for (size_t i = 0; i < m_workers.size(); i++)
+                        m_workers[i]->thread.join();
+
+                    for (size_t i = 0; i < m_workers.size(); i++)
+                    {
+                        for (Item item; take(i, item);)
+                            complete(item, true);
+                    }
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_workers.clear();
+                }
+
+                void submit(Task* task, Subsystem subsystem)
+                {
+                    if (!onWorker)
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+
+                        if (!m_stopping && !m_workers.empty())
+                        {
+                            Worker& w = *m_workers[m_next++ % m_workers.size()];
+                            std::lock_guard<std::mutex> queueLock(w.mutex);
+                            w.queue.push_back(Item(task, subsystem));
+                            m_queued++;
+                            m_outstanding++;
+                            lock.unlock();
+                            m_wake.notify_one();
+                            return;
+                        }
+                    }
+
+                    run(task, subsystem, true);
+                }
+
+                //
+                //  Waits for everything submitted so far to have run
+                //
+
+                void finish()
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_idle.wait(lock, [this] { return m_outstanding == 0; });
+                }
+
+            private:
+                struct Item
+                {
+                    Item(Task* t = 0, Subsystem s = TwkFBSubsystem)
+                        : task(t)
+                        , subsystem(s)
+                    {
+                    }
+
+                    Task* task;
+                    Subsystem subsystem;
+                };
+
+                struct Worker
+                {
+                    std::mutex mutex;
+                    std::deque<Item> queue;
+                    std::thread thread;
+                };
+
+                //
+                //  Own queue from the front, the others' from the back
+                //
+
+                bool take(size_t index, Item& item)
+                {
+                    const size_t n = m_workers.size();
+
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        Worker& w = *m_workers[(index + k) % n];
+                        std::lock_guard<std::mutex> lock(w.mutex);
+
+                        if (w.queue.empty())
+                            continue;
+
+                        if (k == 0)
+                        {
+                            item = w.queue.front();
+                            w.queue.pop_front();
+                        }
+                        else
+                        {
+                            item = w.queue.back();
+                            w.queue.pop_back();
+                        }
+
+                        return true;
+                    }
+
+                    return false;
+                }
+
+                void complete(const Item& item, bool inlined)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_queued--;
+                    }
+
+                    run(item.task, item.subsystem, inlined);
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (--m_outstanding == 0)
+                        m_idle.notify_all();
+                }
+
+                void work(size_t index)
+                {
+                    onWorker = true;
+
+                    for (;;)
+                    {
+                        Item item;
+
+                        if (take(index, item))
+                        {
+                            complete(item, false);
+                            continue;
+                        }
+
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_wake.wait(lock, [this] { return m_queued > 0 || m_stopping; });
+                        if (m_queued == 0 && m_stopping)
+                            return;
+                    }
+                }
+
+                std::vector<std::unique_ptr<Worker>> m_workers;
+                mutable std::mutex m_mutex;
+                std::condition_variable m_wake;
+                std::condition_variable m_idle;
+                size_t m_queued;
+                size_t m_outstanding;
+                size_t m_next;
+                bool m_stopping;
+            };
+
+            //
+            //  Never deleted: OpenEXR's global pool may outlive the
+            //  statics of this file
+            //
+
+            Executor& executor()
+            {
+                static Executor* e = new Executor;
+                return *e;
+            }
+
+            //
+            //  Hands OpenEXR's tasks to the executor. The thread count
+            //  OpenEXR is given only sets how many chunks it decodes at
+            //  once (the pool size until it's set).
+            //
+
+            class EXRProvider : public ILMTHREAD_NAMESPACE::ThreadPoolProvider
+            {
+            public:
+                EXRProvider()
+                    : m_count(-1)
+                {
+                }
+
+                virtual int numThreads() const
+                {
+                    const int count = m_count;
+                    return executor().size() == 0 ? 0 : (count < 0 ? int(executor().size()) : count);
+                }
+
+                virtual void setNumThreads(int count) { m_count = count; }
+
+                virtual void addTask(Task* task) { executor().submit(task, EXRSubsystem); }
+
+                virtual void finish() { executor().finish(); }
+
+            private:
+                std::atomic<int> m_count;
+            };
+
+            std::atomic<size_t> numThreads(0);
+            std::atomic<size_t> numClientThreads(1);
+
+            const char* threadCountVariable()
+            {
+                const char* threadCount = getenv("RV_DECODE_THREAD_COUNT");
+                return threadCount ? threadCount : getenv("RV_MEMCPY_THREAD_COUNT");
+            }
+
+        } // namespace
 
         void initialize()
         {
-            const char* memcpyThreadCount = getenv("RV_MEMCPY_THREAD_COUNT");
-            numThreads = memcpyThreadCount ? (size_t)atoi(memcpyThreadCount) : std::min(TwkUtil::SystemInfo::numCPUs() / 4, (size_t)8);
-            memcpyThreadPool.setNumThreads(numThreads);
+            const char* threadCount = threadCountVariable();
+            numThreads = threadCount ? (size_t)atoi(threadCount) : std::min(TwkUtil::SystemInfo::numCPUs() / 4, (size_t)8);
+            executor().start(numThreads);
+
+            ILMTHREAD_NAMESPACE::ThreadPool::globalThreadPool().setThreadProvider(new EXRProvider);
+        }
+
+        void setNumThreads(size_t n)
+        {
+            if (threadCountVariable() || n == numThreads)
+                return;
+
+            numThreads = n;
+            executor().start(n);
         }
 
-        void shutdown() { memcpyThreadPool.setNumThreads(0); }
+        void shutdown()
+        {
+            if (getenv("RV_DECODE_THREAD_STATS"))
+            {
+                for (int i = 0; i < NumSubsystems; i++)
+                {
+                    const SubsystemStats s = stats(Subsystem(i));
+                    std::cout << "INFO: decode pool: " << subsystemName(Subsystem(i)) << ": " << s.tasks << " tasks, " << s.inlineTasks
+                              << " inline, " << s.seconds << " sec, " << s.externalThreads << " threads in " << s.externalRequests
+                              << " requests" << std::endl;
+                }
+            }
+
+            executor().stop();
+        }
 
         size_t getNumThreads() { return numThreads; }
 
-        void addTask(ILMTHREAD_NAMESPACE::Task* task) { memcpyThreadPool.addTask(task); }
+        void addTask(ILMTHREAD_NAMESPACE::Task* task) { executor().submit(task, TwkFBSubsystem); }
+
+        void setNumClientThreads(size_t n) { numClientThreads = n ? n : 1; }
+
+        size_t codecThreadCount() { return std::max((numThreads + 1) / numClientThreads, size_t(1)); }
+
+        const char* subsystemName(Subsystem s)
+        {
+            switch (s)
+            {
+            case TwkFBSubsystem:
+                return "TwkFB";
+            case EXRSubsystem:
+                return "OpenEXR";
+            case FFmpegSubsystem:
+                return "FFmpeg";
+            default:
+                return "unknown";
+            }
+        }
+
+        SubsystemStats stats(Subsystem s)
+        {
+            const Counters& c = counters[s];
+            SubsystemStats r;
+            r.tasks = c.tasks;
+            r.inlineTasks = c.inlineTasks;
+            r.seconds = double(c.nanoseconds) / 1e9;
+            r.externalRequests = c.externalRequests;
+            r.externalThreads = c.externalThreads;
+            return r;
+        }
+
+        void resetStats()
+        {
+            for (int i = 0; i < NumSubsystems; i++)
+            {
+                Counters& c = counters[i];
+                c.tasks = 0;
+                c.inlineTasks = 0;
+                c.nanoseconds = 0;
+                c.externalRequests = 0;
+                c.externalThreads = 0;
+            }
+        }
+
+        void addExternalThreads(Subsystem s, size_t n)
+        {
+            counters[s].externalRequests++;
+            counters[s].externalThreads += n;
+        }
+
+        namespace
+        {
+
+            struct RangeErrors
+            {
+                std::mutex mutex;
+                std::exception_ptr first;
+
+                void capture()
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!first)
+                        first = std::current_exception();
+                }
+            };
+
+            class RangeTask : public ILMTHREAD_NAMESPACE::Task
+            {
+            public:
+                RangeTask(ILMTHREAD_NAMESPACE::TaskGroup* group, const RangeFunction& f, size_t b, size_t e, RangeErrors& errors)
+                    : ILMTHREAD_NAMESPACE::Task(group)
+                    , m_function(f)
+                    , m_begin(b)
+                    , m_end(e)
+                    , m_errors(errors)
+                {
+                }
+
+                virtual void execute()
+                {
+                    try
+                    {
+                        m_function(m_begin, m_end);
+                    }
+                    catch (...)
+                    {
+                        m_errors.capture();
+                    }
+                }
+
+            private:
+                const RangeFunction& m_function;
+                size_t m_begin;
+                size_t m_end;
+                RangeErrors& m_errors;
+            };
+
+        } // namespace
+
+        void parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& f)
+        {
+            if (end <= begin)
+                return;
+
+            const size_t n = end - begin;
+            const size_t maxChunks = numThreads.load() + 1;
+            const size_t chunks = std::min(maxChunks, grain ? n / grain : n);
+
+            if (chunks <= 1 || onWorker)
+            {
+                f(begin, end);
+                return;
+            }
+
+            const size_t chunkSize = (n + chunks - 1) / chunks;
+            RangeErrors errors;
+
+            {
+                ILMTHREAD_NAMESPACE::TaskGroup taskGroup;
+
+                for (size_t b = begin + chunkSize; b < end; b += chunkSize)
+                {
+                    addTask(new RangeTask(&taskGroup, f, b, std::min(b + chunkSize, end), errors));
+                }
+
+                //
+                //  The first chunk is ours
+                //
+
+                try
+                {
+                    f(begin, begin + chunkSize);
+                }
+                catch (...)
+                {
+                    errors.capture();
+                }
+
+                // ~TaskGroup waits for the rest
+            }
+
+            if (errors.first)
+                std::rethrow_exception(errors.first);
+        }
 
     } // namespace ThreadPool
 } // namespace TwkFB
@@ -16,6 +16,7 @@
 
 #include <TwkFBAux/FBAux.h>
 #include <TwkFB/Operations.h>
+#include <TwkFB/Resize.h>
 #include <TwkExc/Exception.h>
 #include <iostream>
 #include <TwkUtil/Timer.h>
@@ -700,4 +701,57 @@ resize(const FrameBuffer* src, FrameBuffer* dst)
             delete tempFB;
     }
 
+    void resize(const FrameBuffer* src, FrameBuffer* dst, Interpolation method)
+    {
+        TwkFB::ResizeFilter filter;
+
+        switch (method)
+        {
+        case BoxInterpolation:
+            filter = TwkFB::BoxFilter;
+            break;
+        case TriangleInterpolation:
+            filter = TwkFB::TriangleFilter;
+            break;
+        case MitchellInterpolation:
+            filter = TwkFB::MitchellFilter;
+            break;
+        case Lanczos3Interpolation:
+            filter = TwkFB::Lanczos3Filter;
+            break;
+        default:
+            resize(src, dst);
+            return;
+        }
+
+        //
+        //  The filters can't write packed pixels
+        //
+
+        for (const FrameBuffer* d = dst; d; d = d->nextPlane())
+        {
+            if (d->dataType() >= FrameBuffer::PACKED_R10_G10_B10_X2)
+            {
+                resize(src, dst);
+                return;
+            }
+        }
+
+        TwkFB::filteredResize(src, dst, filter);
+
+        for (; src && dst; src = src->nextPlane(), dst = dst->nextPlane())
+        {
+            if (src->uncrop())
+            {
+                const double xfactor = double(dst->width()) / double(src->width());
+                const double yfactor = double(dst->height()) / double(src->height());
+
+                dst->setUncrop(int(double(src->uncropWidth()) * xfactor), int(double(src->uncropHeight()) * yfactor),
+                               int(double(src->uncropX()) * xfactor), int(double(src->uncropY()) * yfactor));
+            }
+
+            dst->setPixelAspectRatio(src->pixelAspectRatio());
+        }
+    }
+
 } // namespace TwkFBAux
@@ -19,11 +19,22 @@ namespace TwkFBAux
     enum Interpolation
     {
         LinearInterpolation,
-        AreaInterpolation
+        AreaInterpolation,
+        BoxInterpolation,
+        TriangleInterpolation,
+        MitchellInterpolation,
+        Lanczos3Interpolation
     };
 
     TWKFBAUX_EXPORT void resize(const FrameBuffer* src, FrameBuffer* dst);
 
+    //
+    //  Box, Triangle, Mitchell and Lanczos3 use the TwkFB filtered
+    //  resize, the others the above.
+    //
+
+    TWKFBAUX_EXPORT void resize(const FrameBuffer* src, FrameBuffer* dst, Interpolation method);
+
 } // namespace TwkFBAux
 
 #endif // __TwkFBAux__FBAux__h__
@@ -0,0 +1,651 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <TwkMovie/MediaInfoIndex.h>
+#include <TwkFB/Attribute.h>
+#include <TwkUtil/File.h>
+#include <TwkUtil/FNV1a.h>
+#include <boost/filesystem/operations.hpp>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _MSC_VER
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace TwkMovie
+{
+    using namespace std;
+    using namespace TwkFB;
+    using namespace TwkMath;
+
+    namespace
+    {
+
+        //
+        //  Bump the version whenever the layout of an entry changes,
+        //  older entries are then misses and get rewritten.
+        //
+
+        const char magic[4] = {'R', 'V', 'M', 'I'};
+        const uint32_t version = 1;
+
+        enum AttributeType
+        {
+            StringType,
+            IntType,
+            FloatType,
+            DoubleType,
+            BoolType,
+            Vec2iType,
+            Vec2fType,
+            Vec3fType,
+            Mat33fType,
+            Mat44fType,
+            StringVectorType
+        };
+
+        struct Counters
+        {
+            Counters()
+                : hits(0)
+                , misses(0)
+                , stale(0)
+                , stores(0)
+            {
+            }
+
+            ~Counters()
+            {
+                if (getenv("RV_MEDIA_INFO_INDEX_STATS"))
+                    MediaInfoIndex::outputStats(cout);
+            }
+
+            atomic<size_t> hits;
+            atomic<size_t> misses;
+            atomic<size_t> stale;
+            atomic<size_t> stores;
+        };
+
+        Counters& counters()
+        {
+            static Counters c;
+            return c;
+        }
+
+        mutex directoryMutex;
+        string defaultDirectory;
+
+        string entryPath(const string& dir, const string& path, const char* extension = ".rvmi")
+        {
+            ostringstream str;
+            str << dir << "/" << hex << TwkUtil::FNV1a64(path.data(), path.size()) << extension;
+            return str.str();
+        }
+
+        //
+        //  Plain native endian binary, the index is local to the
+        //  machine that wrote it.
+        //
+
+        class Writer
+        {
+        public:
+            Writer(ostream& o)
+                : m_out(o)
+            {
+            }
+
+            template <typename T> void write(const T& v) { m_out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+
+            void write(const string& s)
+            {
+                write(uint32_t(s.size()));
+                m_out.write(s.data(), s.size());
+            }
+
+            void write(const vector<string>& v)
+            {
+                write(uint32_t(v.size()));
+                for (size_t i = 0; i < v.size(); i++)
+                    write(v[i]);
+            }
+
+            void write(const FBInfo::ChannelInfoVector& v)
+            {
+                write(uint32_t(v.size()));
+
+                for (size_t i = 0; i < v.size(); i++)
+                {
+                    write(v[i].name);
+                    write(int32_t(v[i].type));
+                }
+            }
+
+            void write(const FBAttribute* a)
+            {
+                write(a->name());
+
+                if (const StringAttribute* ta = dynamic_cast<const StringAttribute*>(a))
+                    writeValue(StringType, ta->value());
+                else if (const IntAttribute* ta = dynamic_cast<const IntAttribute*>(a))
+                    writeValue(IntType, int32_t(ta->value()));
+                else if (const FloatAttribute* ta = dynamic_cast<const FloatAttribute*>(a))
+                    writeValue(FloatType, ta->value());
+                else if (const TypedFBAttribute<double>* ta = dynamic_cast<const TypedFBAttribute<double>*>(a))
+                    writeValue(DoubleType, ta->value());
+                else if (const TypedFBAttribute<bool>* ta = dynamic_cast<const TypedFBAttribute<bool>*>(a))
+                    writeValue(BoolType, uint8_t(ta->value()));
+                else if (const TypedFBAttribute<Vec2i>* ta = dynamic_cast<const TypedFBAttribute<Vec2i>*>(a))
+                    writeValue(Vec2iType, ta->value());
+                else if (const Vec2fAttribute* ta = dynamic_cast<const Vec2fAttribute*>(a))
+                    writeValue(Vec2fType, ta->value());
+                else if (const TypedFBAttribute<Vec3f>* ta = dynamic_cast<const TypedFBAttribute<Vec3f>*>(a))
+                    writeValue(Vec3fType, ta->value());
+                else if (const Mat33fAttribute* ta = dynamic_cast<const Mat33fAttribute*>(a))
+                    writeValue(Mat33fType, ta->value());
+                else if (const Mat44fAttribute* ta = dynamic_cast<const Mat44fAttribute*>(a))
+                    writeValue(Mat44fType, ta->value());
+                else if (const StringVectorAttribute* ta = dynamic_cast<const StringVectorAttribute*>(a))
+                    writeValue(StringVectorType, ta->value());
+                else
+                    writeValue(StringType, a->valueAsString());
+            }
+
+            void write(const FBInfo& info)
+            {
+                write(int32_t(info.width));
+                write(int32_t(info.height));
+                write(int32_t(info.uncropWidth));
+                write(int32_t(info.uncropHeight));
+                write(int32_t(info.uncropX));
+                write(int32_t(info.uncropY));
+                write(info.pixelAspect);
+                write(int32_t(info.numChannels));
+                write(int32_t(info.dataType));
+                write(int32_t(info.orientation));
+                write(info.views);
+                write(info.defaultView);
+                write(info.layers);
+                write(info.channelInfos);
+
+                write(uint32_t(info.viewInfos.size()));
+
+                for (size_t i = 0; i < info.viewInfos.size(); i++)
+                {
+                    const FBInfo::ViewInfo& view = info.viewInfos[i];
+                    write(view.name);
+                    write(uint32_t(view.layers.size()));
+
+                    for (size_t q = 0; q < view.layers.size(); q++)
+                    {
+                        write(view.layers[q].name);
+                        write(view.layers[q].channels);
+                    }
+
+                    write(view.otherChannels);
+                }
+
+                const FrameBuffer::AttributeVector& attrs = info.proxy.attributes();
+                write(uint32_t(attrs.size()));
+                for (size_t i = 0; i < attrs.size(); i++)
+                    write(static_cast<const FBAttribute*>(attrs[i]));
+            }
+
+            void write(const MovieInfo& info)
+            {
+                write(static_cast<const FBInfo&>(info));
+                write(uint8_t(info.video));
+                write(int32_t(info.start));
+                write(int32_t(info.end));
+                write(int32_t(info.inc));
+                write(info.fps);
+                write(info.quality);
+                write(uint8_t(info.audio));
+                write(info.audioSampleRate);
+                write(uint8_t(info.slowRandomAccess));
+                write(info.audioLanguages);
+                write(info.textLanguages);
+
+                write(uint32_t(info.audioChannels.size()));
+                for (size_t i = 0; i < info.audioChannels.size(); i++)
+                    write(int32_t(info.audioChannels[i]));
+
+                write(uint8_t(info.hasSlate));
+                if (info.hasSlate)
+                    write(info.slate);
+            }
+
+        private:
+            template <typename T> void writeValue(AttributeType t, const T& v)
+            {
+                write(uint8_t(t));
+                write(v);
+            }
+
+            ostream& m_out;
+        };
+
+        class Reader
+        {
+        public:
+            Reader(istream& i)
+                : m_in(i)
+            {
+            }
+
+            bool ok() const { return !m_in.fail(); }
+
+            template <typename T> void read(T& v) { m_in.read(reinterpret_cast<char*>(&v), sizeof(T)); }
+
+            template <typename T> T get()
+            {
+                T v = T();
+                read(v);
+                return v;
+            }
+
+            //
+            //  A corrupt count would otherwise allocate forever
+            //
+
+            uint32_t count()
+            {
+                const uint32_t n = get<uint32_t>();
+
+                if (n > (1u << 24))
+                    m_in.setstate(ios::failbit);
+                return ok() ? n : 0;
+            }
+
+            void read(string& s)
+            {
+                s.resize(count());
+                if (!s.empty())
+                    m_in.read(&s[0], s.size());
+            }
+
+            string getString()
+            {
+                string s;
+                read(s);
+                return s;
+            }
+
+            void read(vector<string>& v)
+            {
+                v.resize(count());
+                for (size_t i = 0; i < v.size() && ok(); i++)
+                    read(v[i]);
+            }
+
+            vector<string> getStrings()
+            {
+                vector<string> v;
+                read(v);
+                return v;
+            }
+
+            void read(FBInfo::ChannelInfoVector& v)
+            {
+                v.resize(count());
+
+                for (size_t i = 0; i < v.size() && ok(); i++)
+                {
+                    read(v[i].name);
+                    v[i].type = FrameBuffer::DataType(get<int32_t>());
+                }
+            }
+
+            void readAttribute(FrameBuffer& fb)
+            {
+                const string name = getString();
+
+                switch (get<uint8_t>())
+                {
+                case StringType:
+                    fb.newAttribute(name, getString());
+                    break;
+                case IntType:
+                    fb.newAttribute(name, int(get<int32_t>()));
+                    break;
+                case FloatType:
+                    fb.newAttribute(name, get<float>());
+                    break;
+                case DoubleType:
+                    fb.newAttribute(name, get<double>());
+                    break;
+                case BoolType:
+                    fb.newAttribute(name, get<uint8_t>() != 0);
+                    break;
+                case Vec2iType:
+                    fb.newAttribute(name, get<Vec2i>());
+                    break;
+                case Vec2fType:
+                    fb.newAttribute(name, get<Vec2f>());
+                    break;
+                case Vec3fType:
+                    fb.newAttribute(name, get<Vec3f>());
+                    break;
+                case Mat33fType:
+                    fb.newAttribute(name, get<Mat33f>());
+                    break;
+                case Mat44fType:
+                    fb.newAttribute(name, get<Mat44f>());
+                    break;
+                case StringVectorType:
+                    fb.newAttribute(name, getStrings());
+                    break;
+                default:
+                    m_in.setstate(ios::failbit);
+                }
+            }
+
+            void read(FBInfo& info)
+            {
+                info.width = get<int32_t>();
+                info.height = get<int32_t>();
+                info.uncropWidth = get<int32_t>();
+                info.uncropHeight = get<int32_t>();
+                info.uncropX = get<int32_t>();
+                info.uncropY = get<int32_t>();
+                read(info.pixelAspect);
+                info.numChannels = get<int32_t>();
+                info.dataType = FrameBuffer::DataType(get<int32_t>());
+                info.orientation = FrameBuffer::Orientation(get<int32_t>());
+                read(info.views);
+                read(info.defaultView);
+                read(info.layers);
+                read(info.channelInfos);
+
+                info.viewInfos.resize(count());
+
+                for (size_t i = 0; i < info.viewInfos.size() && ok(); i++)
+                {
+                    FBInfo::ViewInfo& view = info.viewInfos[i];
+                    read(view.name);
+                    view.layers.resize(count());
+
+                    for (size_t q = 0; q < view.layers.size() && ok(); q++)
+                    {
+                        read(view.layers[q].name);
+                        read(view.layers[q].channels);
+                    }
+
+                    read(view.otherChannels);
+                }
+
+                info.proxy.clearAttributes();
+                for (uint32_t i = 0, n = count(); i < n && ok(); i++)
+                    readAttribute(info.proxy);
+            }
+
+            void read(MovieInfo& info)
+            {
+                read(static_cast<FBInfo&>(info));
+                info.video = get<uint8_t>() != 0;
+                info.start = get<int32_t>();
+                info.end = get<int32_t>();
+                info.inc = get<int32_t>();
+                read(info.fps);
+                read(info.quality);
+                info.audio = get<uint8_t>() != 0;
+                read(info.audioSampleRate);
+                info.slowRandomAccess = get<uint8_t>() != 0;
+                read(info.audioLanguages);
+                read(info.textLanguages);
+
+                info.audioChannels.resize(count());
+                for (size_t i = 0; i < info.audioChannels.size(); i++)
+                    info.audioChannels[i] = TwkAudio::Channels(get<int32_t>());
+
+                info.hasSlate = get<uint8_t>() != 0;
+                if (info.hasSlate)
+                    read(info.slate);
+            }
+
+        private:
+            istream& m_in;
+        };
+
+        bool currentStamp(const string& path, MediaInfoIndex::Stamp& stamp)
+        {
+#ifdef _MSC_VER
+            struct _stat64 sb;
+#else
+            struct stat sb;
+#endif
+            if (TwkUtil::stat(path.c_str(), &sb) != 0)
+                return false;
+
+            stamp.path = path;
+            stamp.mtime = int64_t(sb.st_mtime);
+            stamp.size = uint64_t(sb.st_size);
+            return true;
+        }
+
+    } // namespace
+
+    bool MediaInfoIndex::enabled() { return !directory().empty(); }
+
+    string MediaInfoIndex::directory()
+    {
+        if (const char* dir = getenv("RV_MEDIA_INFO_INDEX"))
+        {
+            return strcmp(dir, "off") ? dir : "";
+        }
+
+        lock_guard<mutex> lock(directoryMutex);
+        return defaultDirectory;
+    }
+
+    void MediaInfoIndex::setDefaultDirectory(const string& dir)
+    {
+        lock_guard<mutex> lock(directoryMutex);
+        defaultDirectory = dir;
+    }
+
+    string MediaInfoIndex::sidecarFile(const string& path, const string& extension)
+    {
+        const string dir = directory();
+        return dir.empty() ? dir : entryPath(dir, path, extension.c_str());
+    }
+
+    bool MediaInfoIndex::contains(const string& path)
+    {
+        const string dir = directory();
+        return !dir.empty() && TwkUtil::fileExists(entryPath(dir, path).c_str());
+    }
+
+    bool MediaInfoIndex::find(const string& path, Entry& entry)
+    {
+        const string dir = directory();
+
+        if (dir.empty())
+            return false;
+
+        ifstream file(entryPath(dir, path).c_str(), ios::binary);
+        bool found = false;
+
+        if (file)
+        {
+            Reader reader(file);
+            char m[4];
+            file.read(m, 4);
+
+            if (reader.ok() && !memcmp(m, magic, 4) && reader.get<uint32_t>() == version)
+            {
+                reader.read(entry.path);
+                reader.read(entry.plugin);
+
+                entry.stamps.resize(reader.count());
+
+                for (size_t i = 0; i < entry.stamps.size() && reader.ok(); i++)
+                {
+                    reader.read(entry.stamps[i].path);
+                    reader.read(entry.stamps[i].mtime);
+                    reader.read(entry.stamps[i].size);
+                }
+
+                reader.read(entry.info);
+
+                entry.frames.resize(reader.count());
+                entry.files.resize(entry.frames.size());
+
+                for (size_t i = 0; i < entry.frames.size() && reader.ok(); i++)
+                {
+                    entry.frames[i] = reader.get<int32_t>();
+                    reader.read(entry.files[i]);
+                }
+
+                //
+                //  The hash could collide
+                //
+
+                found = reader.ok() && entry.path == path;
+            }
+        }
+
+        ++(found ? counters().hits : counters().misses);
+        return found;
+    }
+
+    void MediaInfoIndex::store(const Entry& entry)
+    {
+        const string dir = directory();
+
+        if (dir.empty())
+            return;
+
+        //
+        //  Written next to the entry and renamed over it so readers
+        //  (maybe in other processes) never see half an entry.
+        //
+
+        const string path = entryPath(dir, entry.path);
+        ostringstream tmp;
+        tmp << path << "." << getpid() << ".tmp";
+
+        try
+        {
+            boost::filesystem::create_directories(boost::filesystem::path(UNICODE_STR(dir)));
+
+            {
+                ofstream file(tmp.str().c_str(), ios::binary | ios::trunc);
+                Writer writer(file);
+
+                file.write(magic, 4);
+                writer.write(version);
+                writer.write(entry.path);
+                writer.write(entry.plugin);
+
+                writer.write(uint32_t(entry.stamps.size()));
+
+                for (size_t i = 0; i < entry.stamps.size(); i++)
+                {
+                    writer.write(entry.stamps[i].path);
+                    writer.write(entry.stamps[i].mtime);
+                    writer.write(entry.stamps[i].size);
+                }
+
+                writer.write(entry.info);
+
+                writer.write(uint32_t(entry.frames.size()));
+
+                for (size_t i = 0; i < entry.frames.size(); i++)
+                {
+                    writer.write(int32_t(entry.frames[i]));
+                    writer.write(entry.files[i]);
+                }
+
+                if (!file)
+                    throw runtime_error("write failed");
+            }
+
+            boost::filesystem::rename(boost::filesystem::path(UNICODE_STR(tmp.str())), boost::filesystem::path(UNICODE_STR(path)));
+            ++counters().stores;
+        }
+        catch (const std::exception& exc)
+        {
+            cerr << "WARNING: media info index: cannot write " << path << ": " << exc.what() << endl;
+            ::remove(tmp.str().c_str());
+        }
+    }
+
+    void MediaInfoIndex::remove(const string& path)
+    {
+        const string dir = directory();
+
+        if (!dir.empty())
+            ::remove(entryPath(dir, path).c_str());
+    }
+
+    bool MediaInfoIndex::validate(const string& path, const StampVector& stamps)
+    {
+        for (size_t i = 0; i < stamps.size(); i++)
+        {
+            Stamp s;
+
+            if (!currentStamp(stamps[i].path, s) || s.mtime != stamps[i].mtime || s.size != stamps[i].size)
+            {
+                remove(path);
+                ++counters().stale;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool MediaInfoIndex::addStamp(const string& path, StampVector& stamps)
+    {
+        Stamp s;
+
+        if (!currentStamp(path, s))
+            return false;
+
+        stamps.push_back(s);
+        return true;
+    }
+
+    MediaInfoIndex::Stats MediaInfoIndex::stats()
+    {
+        const Counters& c = counters();
+        Stats s;
+        s.hits = c.hits;
+        s.misses = c.misses;
+        s.stale = c.stale;
+        s.stores = c.stores;
+        return s;
+    }
+
+    void MediaInfoIndex::resetStats()
+    {
+        Counters& c = counters();
+        c.hits = 0;
+        c.misses = 0;
+        c.stale = 0;
+        c.stores = 0;
+    }
+
+    void MediaInfoIndex::outputStats(ostream& out)
+    {
+        const Stats s = stats();
+
+        out << "INFO: media info index " << (enabled() ? directory() : string("(disabled)")) << ": " << s.hits << " hits, " << s.misses
+            << " misses, " << s.stale << " stale, " << s.stores << " stored" << endl;
+    }
+
+} // namespace TwkMovie
@@ -0,0 +1,131 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __TwkMovie__MediaInfoIndex__h__
+#define __TwkMovie__MediaInfoIndex__h__
+#include <TwkMovie/Movie.h>
+#include <TwkMovie/dll_defs.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace TwkMovie
+{
+
+    //
+    //  class MediaInfoIndex
+    //
+    //  A persistent index of what opening a piece of media found out:
+    //  the MovieInfo (channel, layer and view lists and the proxy
+    //  attributes), the frames of a sequence with the file behind
+    //  each one and the identifier of the plugin which read it.
+    //
+    //  Entries are keyed by path and carry the modification time and
+    //  size of the files they were made from (for a sequence its
+    //  directory and the frames whose headers were read). A reader
+    //  can use an entry without looking at the media at all and
+    //  validate() it later, the first time it reads an image, so
+    //  opening a session of unchanged media doesn't touch the file
+    //  server.
+    //
+    //  Each entry is a small file in directory() named after a hash
+    //  of its path. RV_MEDIA_INFO_INDEX sets the directory ("off"
+    //  disables the index), otherwise the application provides one
+    //  with setDefaultDirectory(). RV_MEDIA_INFO_INDEX_STATS prints
+    //  the stats at exit.
+    //
+    //  Only the common attribute types (string, int, float, double,
+    //  bool, Vec2i, Vec2f, Vec3f, Mat33f, Mat44f and string vectors)
+    //  are stored as is, the others come back as their string value.
+    //
+
+    class TWKMOVIE_EXPORT MediaInfoIndex
+    {
+    public:
+        struct Stamp
+        {
+            Stamp()
+                : mtime(0)
+                , size(0)
+            {
+            }
+
+            std::string path;
+            int64_t mtime;
+            uint64_t size;
+        };
+
+        typedef std::vector<Stamp> StampVector;
+        typedef std::vector<int> FrameVector;
+        typedef std::vector<std::string> FileVector;
+
+        struct Entry
+        {
+            std::string path;   /// movie file or sequence pattern
+            std::string plugin; /// identifier of the plugin that read it
+            StampVector stamps;
+            MovieInfo info;
+            FrameVector frames; /// sequence frame numbers
+            FileVector files;   /// the file of each frame
+        };
+
+        struct Stats
+        {
+            size_t hits;   /// lookups answered by the index
+            size_t misses; /// lookups with no usable entry
+            size_t stale;  /// entries found out of date by validate()
+            size_t stores; /// entries written
+        };
+
+        static bool enabled();
+        static std::string directory();
+
+        //
+        //  Used unless RV_MEDIA_INFO_INDEX is set
+        //
+
+        static void setDefaultDirectory(const std::string&);
+
+        //
+        //  contains() only checks for the entry file, find() reads it.
+        //  Neither looks at the media.
+        //
+
+        static bool contains(const std::string& path);
+        static bool find(const std::string& path, Entry&);
+        static void store(const Entry&);
+        static void remove(const std::string& path);
+
+        //
+        //  Compares the stamps with the files on disk, removing the
+        //  entry for path if any of them changed.
+        //
+
+        static bool validate(const std::string& path, const StampVector&);
+
+        //
+        //  Appends the current stamp of file (or directory) path,
+        //  returns false if it can't be stat'd.
+        //
+
+        static bool addStamp(const std::string& path, StampVector&);
+
+        //
+        //  Where other caches keyed by media path keep their files,
+        //  next to the entries ("" if the index is disabled). The
+        //  caller owns the file format and its validation.
+        //
+
+        static std::string sidecarFile(const std::string& path, const std::string& extension);
+
+        static Stats stats();
+        static void resetStats();
+        static void outputStats(std::ostream&);
+    };
+
+} // namespace TwkMovie
+
+#endif // __TwkMovie__MediaInfoIndex__h__
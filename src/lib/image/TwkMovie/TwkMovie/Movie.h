@@ -455,6 +455,14 @@ namespace TwkMovie
 
         virtual void invalidateFileSystemInfo() { return; }
 
+        //
+        //  For media with slow random access: the frames of the keyframe
+        //  at or before frame and of the next one (one past the end if
+        //  there's none). Returns false if the movie doesn't know them.
+        //
+
+        virtual bool keyframesAround(int frame, int& before, int& after) const { return false; }
+
         //
         //  "values" are named fields in the derived classes. Since we
         //  can't look into their headers but we know they exist use this
@@ -83,6 +83,7 @@ namespace IPCore
         virtual ~ICCIPNode();
 
         virtual IPImage* evaluate(const Context& context);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImage* evaluateDisplay(const Context& context);
         virtual IPImage* evaluateLinearize(const Context& context);
         virtual IPImage* evaluateTransform(const Context& context);
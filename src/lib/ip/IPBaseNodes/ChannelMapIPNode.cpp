@@ -44,13 +44,22 @@ namespace IPCore
 
     IPImage* ChannelMapIPNode::evaluate(const Context& context)
     {
-        IPImage* head = IPNode::evaluate(context);
+        StringProperty* chmap = m_channels;
+
+        //
+        //  Only the mapped channels need to be read by the source
+        //
+
+        Context mapContext = context;
+
+        if (!chmap->empty() && chmap->front() != "")
+            mapContext.consumedChannels = chmap->valueContainer();
+
+        IPImage* head = IPNode::evaluate(mapContext);
         if (!head)
             return IPImage::newNoImage(this, "No Input");
         int frame = context.frame;
 
-        StringProperty* chmap = m_channels;
-
         if (!chmap->empty())
         {
             ostringstream str;
@@ -111,10 +120,20 @@ namespace IPCore
 
     IPImageID* ChannelMapIPNode::evaluateIdentifier(const Context& context)
     {
-        IPImageID* imgid = IPNode::evaluateIdentifier(context);
-
         StringProperty* chmap = m_channels;
 
+        //
+        //  Has to match evaluate() since the source ids include the
+        //  consumed channels
+        //
+
+        Context mapContext = context;
+
+        if (!chmap->empty() && chmap->front() != "")
+            mapContext.consumedChannels = chmap->valueContainer();
+
+        IPImageID* imgid = IPNode::evaluateIdentifier(mapContext);
+
         IPImageID* i = imgid;
         ostringstream str;
 
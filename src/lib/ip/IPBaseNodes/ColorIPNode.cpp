@@ -187,6 +187,8 @@ namespace IPCore
         m_lumLUTfb->idstream() << h << ":" << size_t(m_lumLUTfb);
     }
 
+    bool ColorIPNode::readsInputAlpha() const { return propertyValue<IntProperty>(m_colorUnpremult, 0) != 0; }
+
     IPImage* ColorIPNode::evaluate(const Context& context)
     {
         IPImage* head = IPNode::evaluate(context);
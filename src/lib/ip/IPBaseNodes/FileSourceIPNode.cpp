@@ -24,6 +24,7 @@
 #include <TwkMath/Function.h>
 #include <TwkMath/Vec2.h>
 #include <TwkMath/Mat44.h>
+#include <TwkMovie/MediaInfoIndex.h>
 #include <TwkMovie/ResamplingMovie.h>
 #include <TwkMovie/MovieIO.h>
 #include <TwkMovie/MovieReader.h>
@@ -39,6 +40,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <mutex>
 
 #include <boost/algorithm/string/regex.hpp>
 #include <boost/functional/hash.hpp>
@@ -311,6 +313,8 @@ namespace IPCore
         m_balance = declareProperty<FloatProperty>("group.balance", 0.0f, ainfo);
         m_crossover = declareProperty<FloatProperty>("group.crossover", 0.0f, ainfo);
         m_readAllChannels = declareProperty<IntProperty>("request.readAllChannels", 0);
+        m_readResolution = declareProperty<FloatProperty>("request.resolution", 1.0f);
+        m_readRegion = declareProperty<IntProperty>("request.region");
         m_rangeStart = 0;
 
         const bool progressiveSourceLoading = Application::optionValue<bool>("progressiveSourceLoading", false);
@@ -628,6 +632,32 @@ namespace IPCore
         }
 
         result.poorRandomAccessPerformance = slow || result.poorRandomAccessPerformance;
+
+        if (!slow || result.framesToKeyframe != -1)
+            return;
+
+        MediaPointer media;
+        {
+            const QReadLocker readLock(&m_mediaMutex);
+
+            if (m_mediaVector.empty())
+                return;
+
+            ImageComponent selection;
+            media = getMediaFromContext(selection, context);
+        }
+
+        int before = 0;
+        int after = 0;
+
+        if (Movie* mov = movieForThread(media.get(), context))
+        {
+            if (mov->keyframesAround(context.frame, before, after) && before <= context.frame && after > context.frame)
+            {
+                result.framesSinceKeyframe = context.frame - before;
+                result.framesToKeyframe = after - context.frame;
+            }
+        }
     }
 
     FileSourceIPNode::MediaPointer FileSourceIPNode::getMediaFromContext(ImageComponent& selection, const Context& context) const
@@ -847,6 +877,45 @@ namespace IPCore
         request.missing = context.missing;
         request.allChannels = (m_readAllChannels->front() ? true : false);
 
+        //
+        //  A source too big for a texture is scaled down after it's read
+        //  (see getTilingInfo()) so let readers which can (tiled EXR and
+        //  TIFF levels, JPEG, HTJ2K) skip the detail instead.
+        //  request.resolution and request.region ask for a proxy or crop
+        //  of the image.
+        //
+
+        float resolution = m_readResolution->empty() ? 1.0f : m_readResolution->front();
+        resolution = min(resolution, getTilingInfo(mov->info().uncropWidth, mov->info().uncropHeight).scale);
+        request.resolution = resolution > 0.0f && resolution < 1.0f ? resolution : 0.0f;
+
+        if (m_readRegion->size() == 4)
+        {
+            request.x0 = (*m_readRegion)[0];
+            request.y0 = (*m_readRegion)[1];
+            request.x1 = (*m_readRegion)[2];
+            request.y1 = (*m_readRegion)[3];
+        }
+        else
+        {
+            request.x0 = request.y0 = request.x1 = request.y1 = 0;
+        }
+
+        //
+        //  The display thread only evaluates when the look ahead didn't
+        //  get to the frame first, so have the reader use every core it
+        //  can.
+        //
+
+        request.parallelDecode = (context.thread & DisplayThread) != 0;
+
+        //
+        //  Channels a channel map downstream will keep. Readers which
+        //  can (EXR) skip the rest.
+        //
+
+        request.consumedChannels = context.consumedChannels;
+
         //
         //  Limit requested views to ones this movie actually provides.
         //  Otherwise the movie reader may fallback to a "default" view,
@@ -1200,14 +1269,31 @@ namespace IPCore
 
         TilingInfo tilingInfo = getTilingInfo(fullFB->width(), fullFB->height());
 
+        //
+        //  The reader may have done some or all of the scaling asked for
+        //  in setupRequest(). The id has the source's scale either way so
+        //  it matches identifiersAtFrame().
+        //
+
+        float idScale = tilingInfo.scale;
+
+        if (request.hasResolution())
+        {
+            idScale = min(idScale, getTilingInfo(mov->info().uncropWidth, mov->info().uncropHeight).scale);
+        }
+
         if (tilingInfo.scale < 1.0f)
         {
             FrameBuffer* scaledFB = resizeFB(fullFB, tilingInfo.scale);
-            scaledFB->idstream() << "*" << tilingInfo.scale;
             delete fullFB;
             fullFB = scaledFB;
         }
 
+        if (idScale < 1.0f)
+        {
+            fullFB->idstream() << "*" << idScale;
+        }
+
         // For debugging, use different tiling layouts based on frame number:
         // frame 1 : 1x1
         // frame 2 : 2x2
@@ -1368,6 +1454,13 @@ namespace IPCore
                         aTilePlaneFB->setScanlineSize(aFullPlaneFB->scanlineSize());
                         aTilePlaneFB->setScanlinePaddedSize(aFullPlaneFB->scanlinePaddedSize());
 
+                        // Pixels of a memory mapped file aren't owned by
+                        // any of the tiles, they all keep the mapping.
+                        if (aFullPlaneFB->dataOwner())
+                        {
+                            aTilePlaneFB->setDataOwner(aFullPlaneFB->dataOwner());
+                        }
+
                         if (isMasterBuffer)
                         {
                             // Flag the master buffer (first tile) so it knows
@@ -2301,7 +2394,7 @@ namespace IPCore
             updateHasAudioStatus();
         }
 
-        if (p == m_readAllChannels || p == m_imageComponent || p == m_eyeViews)
+        if (p == m_readAllChannels || p == m_readResolution || p == m_readRegion || p == m_imageComponent || p == m_eyeViews)
         {
             if (group())
                 group()->flushIDsOfGroup();
@@ -2705,10 +2798,17 @@ namespace IPCore
 
     FileSourceIPNode::Movie* FileSourceIPNode::openMovie(const string& filename)
     {
+        static std::once_flag indexOnce;
+        std::call_once(indexOnce,
+                       [] { MediaInfoIndex::setDefaultDirectory(Bundle::mainBundle()->cacheItemPath("MediaInfoIndex", "")); });
+
         // Ensure file exists and is accessible by the current user before
-        // continuing
+        // continuing. Indexed media is checked when it's first read
+        // instead, finding the first file of a sequence scans its
+        // directory.
         //
-        if (!TwkUtil::pathIsURL(filename) && TwkUtil::extension(filename) != "movieproc")
+        if (!TwkUtil::pathIsURL(filename) && TwkUtil::extension(filename) != "movieproc"
+            && !MediaInfoIndex::contains(TwkUtil::pathConform(filename)))
         {
             const auto firstFileInSeq = TwkUtil::firstFileInPattern(filename.c_str());
             const char* pathToTest = firstFileInSeq.empty() ? filename.c_str() : firstFileInSeq.c_str();
@@ -29,6 +29,7 @@ namespace IPCore
         virtual ~AudioAddIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual size_t audioFillBuffer(const AudioContext&);
 
@@ -27,6 +27,7 @@ namespace IPCore
         virtual ~ChannelMapIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual void propertyChanged(const Property*);
 
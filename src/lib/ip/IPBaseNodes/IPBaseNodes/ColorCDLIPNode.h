@@ -24,6 +24,7 @@ namespace IPCore
         virtual ~ColorCDLIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual void copyNode(const IPNode* node);
         virtual void propertyChanged(const Property* property);
         virtual void readCompleted(const std::string& type, unsigned int version);
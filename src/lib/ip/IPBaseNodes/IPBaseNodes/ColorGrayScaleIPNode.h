@@ -20,6 +20,7 @@ namespace IPCore
         virtual ~ColorGrayScaleIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         IntProperty* m_active;
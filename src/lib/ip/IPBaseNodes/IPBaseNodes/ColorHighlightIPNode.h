@@ -25,6 +25,7 @@ namespace IPCore
         virtual ~ColorHighlightIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         IntProperty* m_active;
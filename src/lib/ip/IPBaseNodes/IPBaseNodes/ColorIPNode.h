@@ -33,6 +33,7 @@ namespace IPCore
         virtual ~ColorIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const;
         virtual void propertyChanged(const Property* property);
         virtual void readCompleted(const std::string&, unsigned int);
 
@@ -20,6 +20,7 @@ namespace IPCore
         virtual ~ColorLinearToSRGBIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
     };
@@ -20,6 +20,7 @@ namespace IPCore
         virtual ~ColorSRGBToLinearIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
     };
@@ -25,6 +25,7 @@ namespace IPCore
         virtual ~ColorShadowIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         IntProperty* m_active;
@@ -24,6 +24,7 @@ namespace IPCore
         virtual ~ColorTemperatureIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
         enum
         {
@@ -25,6 +25,7 @@ namespace IPCore
         virtual ~ColorVibranceIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         FloatProperty* m_ColorVibrance;
@@ -50,6 +50,7 @@ namespace IPCore
 
         virtual ~CropIPNode();
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual ImageStructureInfo imageStructureInfo(const Context&) const;
 
         virtual void propertyChanged(const Property*);
@@ -242,6 +242,8 @@ namespace IPCore
         FloatProperty* m_balance;
         FloatProperty* m_crossover;
         IntProperty* m_readAllChannels;
+        FloatProperty* m_readResolution;
+        IntProperty* m_readRegion;
         StringVector m_allViews;
         StringSet m_viewNameSet;
         Mutex m_audioMutex;
@@ -22,6 +22,7 @@ namespace IPCore
         virtual ~FilterGaussianIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         FloatProperty* m_sigma; // this is 2 * sigma * sigma in the equation
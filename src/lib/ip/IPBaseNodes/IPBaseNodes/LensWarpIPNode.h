@@ -27,6 +27,7 @@ namespace IPCore
 
         virtual ~LensWarpIPNode();
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual ImageStructureInfo imageStructureInfo(const Context&) const;
         virtual void readCompleted(const std::string&, unsigned int);
         virtual void propertyChanged(const Property*);
@@ -29,6 +29,7 @@ namespace IPCore
         virtual ~LinearizeIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const;
 
         void setTransfer(const std::string&);
         void setPrimaries(const std::string&);
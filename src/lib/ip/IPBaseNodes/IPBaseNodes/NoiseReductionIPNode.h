@@ -27,6 +27,7 @@ namespace IPCore
         virtual ~NoiseReductionIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         IntProperty* m_active;
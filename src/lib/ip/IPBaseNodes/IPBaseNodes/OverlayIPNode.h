@@ -98,6 +98,7 @@ namespace IPCore
         virtual ~OverlayIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
         virtual void propertyChanged(const Property*);
         virtual void readCompleted(const std::string&, unsigned int);
@@ -185,6 +185,7 @@ namespace IPCore
         virtual ~PaintIPNode();
 
         IPImage* evaluate(const Context& context) override;
+        bool readsInputAlpha() const override { return false; }
 
         void propertyChanged(const Property* proprety) override;
         void readCompleted(const std::string& typeName, unsigned int version) override;
@@ -27,6 +27,7 @@ namespace IPCore
 
         virtual ~PrimaryConvertIPNode();
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         bool active() const;
 
     private:
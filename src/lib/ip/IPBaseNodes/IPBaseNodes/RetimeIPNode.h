@@ -36,6 +36,7 @@ namespace IPCore
         virtual ~RetimeIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual ImageStructureInfo imageStructureInfo(const Context&) const;
 
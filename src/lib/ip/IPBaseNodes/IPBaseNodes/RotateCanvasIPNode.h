@@ -28,6 +28,7 @@ namespace IPCore
 
         virtual ~RotateCanvasIPNode();
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual ImageStructureInfo imageStructureInfo(const Context&) const;
 
         virtual void propertyChanged(const Property*);
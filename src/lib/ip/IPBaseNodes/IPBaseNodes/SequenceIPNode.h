@@ -60,6 +60,7 @@ namespace IPCore
         virtual void setInputs(const IPNodes&);
         virtual ImageRangeInfo imageRangeInfo() const;
         virtual ImageStructureInfo imageStructureInfo(const Context&) const;
+        virtual bool readsInputAlpha() const;
         virtual void mediaInfo(const Context&, MediaInfoVector&) const;
         virtual void mapInputToEvalFrames(size_t inputIndex, const FrameVector& in, FrameVector& out) const;
 
@@ -34,6 +34,7 @@ namespace IPCore
         //
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual void prepareForWrite();
         virtual void writeCompleted();
         virtual void readCompleted(const std::string&, unsigned int);
@@ -34,6 +34,7 @@ namespace IPCore
         virtual ~SwitchIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual void testEvaluate(const Context&, TestEvaluationResult&);
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual void metaEvaluate(const Context&, MetaEvalVisitor&);
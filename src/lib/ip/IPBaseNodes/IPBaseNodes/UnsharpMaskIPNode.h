@@ -26,6 +26,7 @@ namespace IPCore
         virtual ~UnsharpMaskIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     private:
         IntProperty* m_active;
@@ -26,6 +26,7 @@ namespace IPCore
         virtual ~YCToRGBIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
         void setConversion(const std::string&);
 
@@ -176,6 +176,17 @@ namespace IPCore
         return "File";
     }
 
+    bool LinearizeIPNode::readsInputAlpha() const
+    {
+        //
+        //  "File" only premultiplies if the reader says the image is
+        //  unpremultiplied. Readers which honor consumedChannels (EXR)
+        //  never do and the rest return alpha regardless.
+        //
+
+        return propertyValue(m_alphaTypeName, "File") == "Unpremultiplied";
+    }
+
     IPImage* LinearizeIPNode::evaluate(const Context& context)
     {
         const bool active = propertyValue<IntProperty>(m_active, 1) != 0;
@@ -442,6 +442,17 @@ namespace IPCore
         return root;
     }
 
+    bool SequenceIPNode::readsInputAlpha() const
+    {
+        for (size_t i = 0; i < m_inputsBlendingModes->size(); i++)
+        {
+            if (IPImage::getBlendModeFromString((*m_inputsBlendingModes)[i].c_str()) != IPImage::Replace)
+                return true;
+        }
+
+        return false;
+    }
+
     IPImageID* SequenceIPNode::evaluateIdentifier(const Context& context)
     {
         lazyBuildState();
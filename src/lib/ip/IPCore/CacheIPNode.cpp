@@ -14,6 +14,7 @@
 #include <TwkFB/Cache.h>
 #include <TwkMath/Frustum.h>
 #include <TwkUtil/sgcHop.h>
+#include <TwkUtil/Timer.h>
 
 namespace IPCore
 {
@@ -68,6 +69,43 @@ namespace IPCore
         m_performDownSample = declareProperty<IntProperty>("render.downSampling", 1);
     }
 
+    //
+    //  An IPImage holding the cached fb of id (or nothing if fb is 0)
+    //
+
+    static IPImage* newCachedImage(const IPNode* snode, const IPImageID* id, TwkFB::FrameBuffer* fb)
+    {
+        IPImage* img = fb ? (new IPImage(snode, IPImage::BlendRenderType, fb)) : (new IPImage(snode));
+
+        // Transfer the noIntermediate flag from the IPImageID to the
+        // associated IPImage.
+        if (id->noIntermediate)
+        {
+            img->noIntermediate = true;
+        }
+
+        if (!fb)
+            return img;
+
+        if (const TwkFB::TypedFBVectorAttribute<float>* transformMatrixAtt =
+                dynamic_cast<const TwkFB::TypedFBVectorAttribute<float>*>(fb->findAttribute("TransformMatrix")))
+        {
+            if (transformMatrixAtt && transformMatrixAtt->value().size() == 16)
+            {
+                std::vector<float> txMatCoeffs;
+                for (int rowIndex = 0; rowIndex < 4; rowIndex++)
+                {
+                    for (int colIndex = 0; colIndex < 4; colIndex++)
+                    {
+                        img->transformMatrix(rowIndex, colIndex) = transformMatrixAtt->value()[rowIndex * 4 + colIndex];
+                    }
+                }
+            }
+        }
+
+        return img;
+    }
+
     //
     //  Converts an IPImageID tree into a IPImage tree by looking up the
     //  ids in the cache and creating IPImages to hold them. Should be
@@ -95,34 +133,7 @@ namespace IPCore
             {
                 DB("IPImageTreeFromIDTree: calling checkOut " << id->id);
                 TwkFB::FrameBuffer* fb = context.cache.checkOut(id->id);
-                const IPNode* snode = node->sourceNode();
-                img = fb ? (new IPImage(snode, IPImage::BlendRenderType, fb)) : (new IPImage(snode));
-
-                // Transfer the noIntermediate flag from the IPImageID to the
-                // associated IPImage.
-                if (id->noIntermediate)
-                {
-                    img->noIntermediate = true;
-                }
-
-                if (fb)
-                {
-                    if (const TwkFB::TypedFBVectorAttribute<float>* transformMatrixAtt =
-                            dynamic_cast<const TwkFB::TypedFBVectorAttribute<float>*>(fb->findAttribute("TransformMatrix")))
-                    {
-                        if (transformMatrixAtt && transformMatrixAtt->value().size() == 16)
-                        {
-                            std::vector<float> txMatCoeffs;
-                            for (int rowIndex = 0; rowIndex < 4; rowIndex++)
-                            {
-                                for (int colIndex = 0; colIndex < 4; colIndex++)
-                                {
-                                    img->transformMatrix(rowIndex, colIndex) = transformMatrixAtt->value()[rowIndex * 4 + colIndex];
-                                }
-                            }
-                        }
-                    }
-                }
+                img = newCachedImage(node->sourceNode(), id, fb);
             }
             catch (...)
             {
@@ -144,6 +155,92 @@ namespace IPCore
         }
     };
 
+    //
+    //  Same as IPImageTreeFromIDTree but for the display thread: looks
+    //  the ids up in the items of the frame pinned by
+    //  FBCache::pinFrameItems() so it doesn't need the cache lock. Each
+    //  IPImage holds a pin of its own, they're let go when the tree is
+    //  checked in or deleted. Every id has to be found.
+    //
+
+    struct IPImageTreeFromPinnedItems
+    {
+        IPImageTreeFromPinnedItems(const FBCache::FBVector& fbs, const CacheIPNode* n)
+            : items(fbs)
+            , missed(false)
+            , node(n)
+        {
+        }
+
+        const FBCache::FBVector& items;
+        bool missed;
+        const CacheIPNode* node;
+
+        IPImage* operator()(IPImageID* id)
+        {
+            for (size_t i = 0; i < items.size(); i++)
+            {
+                TwkFB::FrameBuffer* fb = items[i];
+
+                if (fb->identifier() == id->id && fb->cachePin())
+                {
+                    IPImage* img = newCachedImage(node->sourceNode(), id, fb);
+                    img->cachePinned = true;
+                    return img;
+                }
+            }
+
+            DB("IPImageTreeFromPinnedItems: " << id->id << " isn't an item of the frame");
+            missed = true;
+            return newCachedImage(node->sourceNode(), id, 0);
+        }
+    };
+
+    //
+    //  The display thread doesn't wait on the cache lock for a frame
+    //  that's cached: it pins the items of the frame and builds the
+    //  IPImage tree from those. Returns 0 if the frame isn't cached or
+    //  some of the ids aren't items of it (or are held compressed).
+    //
+
+    static IPImage* pinnedImageTree(const IPNode::Context& context, IPImageID* idTree, const CacheIPNode* node)
+    {
+        FBCache::FBVector items;
+
+        if (!context.cache.pinFrameItems(context.baseFrame, items))
+            return 0;
+
+        IPImageTreeFromPinnedItems F(items, node);
+        IPImage* root = transform_ip<IPImage, IPImageID, IPImageTreeFromPinnedItems>(idTree, F);
+        FBCache::unpinItems(items);
+
+        if (F.missed)
+        {
+            delete root;
+            return 0;
+        }
+
+        return root;
+    }
+
+    //
+    //  Decompresses the items of an IPImageID tree held compressed by
+    //  the cache so checkOut() doesn't do it under the cache lock. Has
+    //  to be called without the cache lock (see FBCache::expand()).
+    //
+
+    struct ExpandCompressedItem
+    {
+        ExpandCompressedItem(const IPNode::Context& c)
+            : context(c)
+        {
+        }
+
+        const IPNode::Context& context;
+
+        void operator()(IPImageID* id) { context.cache.expand(id->id); }
+    };
+
     //
     //  Assign source shaders. This has to be the last pass in case we
     //  reused a cached fb (it can get deleted out from under the
@@ -191,6 +288,27 @@ namespace IPCore
         }
     };
 
+    //
+    //  Adds up the size of the fbs in an IPImage tree. Should be called
+    //  by foreach_ip
+    //
+
+    struct SumImageFBBytes
+    {
+        SumImageFBBytes()
+            : bytes(0)
+        {
+        }
+
+        size_t bytes;
+
+        void operator()(IPImage* img)
+        {
+            if (img->fb)
+                bytes += img->fb->totalImageSize();
+        }
+    };
+
     //
     //  Complicated: this thing tries to check out the fb in the image. If
     //  it can, it swaps the cached one for the evaluated one. Otherwise,
@@ -198,11 +316,12 @@ namespace IPCore
 
     struct UseCacheImageIfExists
     {
-        UseCacheImageIfExists(const IPNode::Context& c, bool m, IPNode::ThreadType t, IPImage* r)
+        UseCacheImageIfExists(const IPNode::Context& c, bool m, IPNode::ThreadType t, IPImage* r, const string& s)
             : context(c)
             , missing(m)
             , thread(t)
             , root(r)
+            , source(s)
         {
         }
 
@@ -210,6 +329,7 @@ namespace IPCore
         const IPNode::Context& context;
         IPImage* root;
         IPNode::ThreadType thread;
+        const string& source;
 
         void operator()(IPImage* img)
         {
@@ -263,7 +383,7 @@ namespace IPCore
 
                 if (context.cacheNode)
                 {
-                    context.cache.add(cfb, context.baseFrame, false, context.cacheNode);
+                    context.cache.add(cfb, context.baseFrame, false, context.cacheNode, source);
                 }
                 else
                 {
@@ -283,6 +403,18 @@ namespace IPCore
                 DB("UseCacheImageIfExists: calling add, thread " << context.thread << ":" << context.threadNum << " id "
                                                                  << fb->identifier());
 
+                //
+                //  A source over its quota may leave this one out. The
+                //  frame is then cached without it and the fb goes away
+                //  with the image.
+                //
+                if (!context.cacheNode && !context.cache.reserveForSource(source, fb->totalImageSize(), context.baseFrame))
+                {
+                    DB("UseCacheImageIfExists: " << source << " over quota, not caching " << fb->identifier());
+                    TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
+                    return;
+                }
+
                 //
                 //  If we're going to possibly shove the fb into the cache, make
                 //  sure we are not at least already overflowing.
@@ -298,7 +430,7 @@ namespace IPCore
                 //  discard a frame when the cache fills during playback (we ask
                 //  for the same frame twice).  Further investigation needed.
                 //
-                bool addSucceeded = context.cache.add(fb, context.baseFrame, true, context.cacheNode);
+                bool addSucceeded = context.cache.add(fb, context.baseFrame, true, context.cacheNode, source);
                 DB("UseCacheImageIfExists: add succeeded: " << addSucceeded);
 
                 if (!addSucceeded && thread == IPNode::CacheEvalThread)
@@ -360,14 +492,16 @@ namespace IPCore
 
     struct AddToCacheAtFrame
     {
-        AddToCacheAtFrame(const IPNode::Context& c, bool m)
+        AddToCacheAtFrame(const IPNode::Context& c, bool m, const string& s)
             : context(c)
             , missing(m)
+            , source(s)
         {
         }
 
         const IPNode::Context& context;
         bool missing;
+        const string& source;
 
         void operator()(IPImage* img)
         {
@@ -377,10 +511,10 @@ namespace IPCore
                 img->missingLocalFrame = context.frame;
             }
 
-            // NOTE: already checked out
-            if (img->fb)
+            // NOTE: already checked out, or pinned as an item of this frame
+            if (img->fb && !img->cachePinned)
             {
-                context.cache.add(img->fb, context.baseFrame, false, context.cacheNode);
+                context.cache.add(img->fb, context.baseFrame, false, context.cacheNode, source);
             }
         }
     };
@@ -414,6 +548,7 @@ namespace IPCore
         IPImageID* idTree = 0;
         bool missing = false;
         bool missed = false;
+        const string sourceName = m_sourceNode ? m_sourceNode->name() : name();
         bool profile = (thread & DisplayThread) && graph()->needsProfilingSamples();
 
         PROFILE_SAMPLE(profile, evalIDStart);
@@ -460,14 +595,29 @@ namespace IPCore
 
         PROFILE_SAMPLE(profile, cacheQueryStart);
 
-        TWK_CACHE_LOCK(context.cache, "thread=" << thread);
+        context.cache.pageInFrame(context.baseFrame, idTree);
 
-        IPImageTreeFromIDTree F(context, this);
+        if (context.cache.compressionEnabled())
+        {
+            ExpandCompressedItem E(context);
+            foreach_ip(idTree, E);
+        }
 
-        DB("evaluate: calling transform_ip with callable "
-           "IPImageTreeFromIDTree ");
-        IPImage* root = transform_ip<IPImage, IPImageID, IPImageTreeFromIDTree>(idTree, F);
-        missed = F.missed || missed;
+        const bool pinnable = (thread & DisplayThread) && !context.cacheNode && !missed;
+        IPImage* root = pinnable ? pinnedImageTree(context, idTree, this) : 0;
+        const bool pinned = root != 0;
+
+        if (!pinned)
+        {
+            TWK_CACHE_LOCK(context.cache, "thread=" << thread);
+
+            IPImageTreeFromIDTree F(context, this);
+
+            DB("evaluate: calling transform_ip with callable "
+               "IPImageTreeFromIDTree ");
+            root = transform_ip<IPImage, IPImageID, IPImageTreeFromIDTree>(idTree, F);
+            missed = F.missed || missed;
+        }
 
         if (missed)
         {
@@ -520,6 +670,8 @@ namespace IPCore
 
             PROFILE_SAMPLE(profile, cacheEvalStart);
 
+            TwkUtil::Timer evalTimer(true);
+
             if (!missing)
             {
                 root = inNode->evaluate(context);
@@ -531,8 +683,34 @@ namespace IPCore
                 root = inNode->evaluate(mcontext);
             }
 
+            //
+            //  Let the cache know what it cost to make these so it can
+            //  weigh which frames to cache and free. Missing frames are
+            //  placeholders so they don't count.
+            //
+
+            const double evalSeconds = evalTimer.stop();
+
+            if (!missing)
+            {
+                SumImageFBBytes Fbytes;
+                foreach_ip(root, Fbytes);
+
+                TWK_CACHE_LOCK(context.cache, "thread=" << thread);
+                context.cache.recordEvaluation(sourceName, context.baseFrame, evalSeconds, Fbytes.bytes);
+                TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
+
+                //
+                //  Make room for them by compressing other frames now,
+                //  free() won't do it under the lock.
+                //
+
+                if (context.cache.compressionEnabled())
+                    context.cache.compressAhead(Fbytes.bytes);
+            }
+
             DB("evaluate: calling UseCacheImageIfExists");
-            UseCacheImageIfExists Fcache(context, missing, thread, root);
+            UseCacheImageIfExists Fcache(context, missing, thread, root, sourceName);
             foreach_ip(root, Fcache);
 
             PROFILE_SAMPLE(profile, cacheEvalEnd);
@@ -543,11 +721,13 @@ namespace IPCore
             //  All of the fbs were in the cache. Append them to the image
             //  list. Also, add them back into the cache for this
             //  frame. This makes sure all ids for the current frame are
-            //  recorded.
+            //  recorded. Pinned ones already are, and the cache isn't
+            //  locked for them.
             //
-            AddToCacheAtFrame A(context, missing);
+            AddToCacheAtFrame A(context, missing, sourceName);
             foreach_ip(root, A);
-            TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
+            if (!pinned)
+                TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
             delete idTree; // clean up previously used identifiers
 
             PROFILE_SAMPLE(profile, cacheQueryEnd);
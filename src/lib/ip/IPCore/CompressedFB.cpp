@@ -0,0 +1,297 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/CompressedFB.h>
+#include <TwkFB/Attribute.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <TwkUtil/sgcHop.h>
+#include <algorithm>
+#include <string.h>
+#include <zlib.h>
+
+namespace IPCore
+{
+    using namespace std;
+    using namespace TwkFB;
+    using namespace ILMTHREAD_NAMESPACE;
+
+    namespace
+    {
+
+        //
+        //  Chunk size is a trade off between parallelism and ratio. 1MB
+        //  gives 64 chunks for a 4K RGBA half image.
+        //
+
+        const size_t chunkSize = 1024 * 1024;
+
+        void shuffle(const unsigned char* in, unsigned char* out, size_t n, size_t elementSize)
+        {
+            const size_t count = n / elementSize;
+
+            for (size_t b = 0; b < elementSize; b++)
+            {
+                unsigned char* o = out + b * count;
+                const unsigned char* i = in + b;
+
+                for (size_t e = 0; e < count; e++, i += elementSize)
+                    o[e] = *i;
+            }
+
+            //
+            //  Anything left over that isn't a whole element
+            //
+
+            memcpy(out + count * elementSize, in + count * elementSize, n - count * elementSize);
+        }
+
+        void unshuffle(const unsigned char* in, unsigned char* out, size_t n, size_t elementSize)
+        {
+            const size_t count = n / elementSize;
+
+            for (size_t b = 0; b < elementSize; b++)
+            {
+                const unsigned char* i = in + b * count;
+                unsigned char* o = out + b;
+
+                for (size_t e = 0; e < count; e++, o += elementSize)
+                    *o = i[e];
+            }
+
+            memcpy(out + count * elementSize, in + count * elementSize, n - count * elementSize);
+        }
+
+    } // namespace
+
+    class EncodeChunkTask : public Task
+    {
+    public:
+        EncodeChunkTask(TaskGroup* group, const unsigned char* in, CompressedFB::Chunk& chunk)
+            : Task(group)
+            , m_in(in)
+            , m_chunk(chunk)
+        {
+        }
+
+        virtual void execute() { CompressedFB::encode(m_in, m_chunk); }
+
+    private:
+        const unsigned char* m_in;
+        CompressedFB::Chunk& m_chunk;
+    };
+
+    class DecodeChunkTask : public Task
+    {
+    public:
+        DecodeChunkTask(TaskGroup* group, const CompressedFB::Chunk& chunk, unsigned char* out, char& ok)
+            : Task(group)
+            , m_chunk(chunk)
+            , m_out(out)
+            , m_ok(ok)
+        {
+        }
+
+        virtual void execute() { m_ok = CompressedFB::decode(m_chunk, m_out); }
+
+    private:
+        const CompressedFB::Chunk& m_chunk;
+        unsigned char* m_out;
+        char& m_ok;
+    };
+
+    CompressedFB::CompressedFB()
+        : m_size(0)
+        , m_rawSize(0)
+    {
+    }
+
+    CompressedFB::~CompressedFB() {}
+
+    void CompressedFB::encode(const unsigned char* in, Chunk& chunk)
+    {
+        vector<unsigned char> shuffled(chunk.rawSize);
+        shuffle(in, &shuffled.front(), chunk.rawSize, chunk.elementSize);
+
+        chunk.bytes.resize(deflateBound(0, chunk.rawSize) + 64);
+
+        z_stream z;
+        memset(&z, 0, sizeof(z));
+
+        bool ok = false;
+
+        if (deflateInit2(&z, Z_BEST_SPEED, Z_DEFLATED, 15, 8, Z_RLE) == Z_OK)
+        {
+            z.next_in = &shuffled.front();
+            z.avail_in = uInt(chunk.rawSize);
+            z.next_out = &chunk.bytes.front();
+            z.avail_out = uInt(chunk.bytes.size());
+
+            ok = deflate(&z, Z_FINISH) == Z_STREAM_END && z.total_out < chunk.rawSize;
+            chunk.bytes.resize(z.total_out);
+            deflateEnd(&z);
+        }
+
+        if (!ok)
+        {
+            chunk.stored = true;
+            chunk.bytes.swap(shuffled);
+        }
+
+        //
+        //  Don't hold on to the slack from deflateBound()
+        //
+
+        vector<unsigned char>(chunk.bytes).swap(chunk.bytes);
+    }
+
+    bool CompressedFB::decode(const Chunk& chunk, unsigned char* out)
+    {
+        if (chunk.stored)
+        {
+            unshuffle(&chunk.bytes.front(), out, chunk.rawSize, chunk.elementSize);
+            return true;
+        }
+
+        //
+        //  Single byte elements need no unshuffling, so inflate straight
+        //  into the plane.
+        //
+
+        vector<unsigned char> shuffled;
+        unsigned char* dst = out;
+
+        if (chunk.elementSize > 1)
+        {
+            shuffled.resize(chunk.rawSize);
+            dst = &shuffled.front();
+        }
+
+        z_stream z;
+        memset(&z, 0, sizeof(z));
+
+        if (inflateInit(&z) != Z_OK)
+            return false;
+
+        z.next_in = const_cast<unsigned char*>(&chunk.bytes.front());
+        z.avail_in = uInt(chunk.bytes.size());
+        z.next_out = dst;
+        z.avail_out = uInt(chunk.rawSize);
+
+        const bool ok = inflate(&z, Z_FINISH) == Z_STREAM_END && z.total_out == chunk.rawSize;
+        inflateEnd(&z);
+
+        if (ok && chunk.elementSize > 1)
+            unshuffle(dst, out, chunk.rawSize, chunk.elementSize);
+
+        return ok;
+    }
+
+    CompressedFB* CompressedFB::compress(const FrameBuffer* fb)
+    {
+        HOP_PROF_FUNC();
+
+        if (!fb->isRootPlane() || fb->findAttribute("ProxyBuffers") || fb->findAttribute("ProxyBufferOwnerPtr"))
+        {
+            return 0;
+        }
+
+        CompressedFB* c = new CompressedFB();
+        size_t plane = 0;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane(), plane++)
+        {
+            if (!p->allocSize())
+                continue;
+
+            if (!p->hasData())
+            {
+                delete c;
+                return 0;
+            }
+
+            const size_t elementSize = max(size_t(p->bytesPerChannel()), size_t(1));
+            const size_t step = chunkSize - chunkSize % elementSize;
+
+            for (size_t offset = 0; offset < p->allocSize(); offset += step)
+            {
+                Chunk chunk;
+                chunk.plane = plane;
+                chunk.offset = offset;
+                chunk.rawSize = min(step, p->allocSize() - offset);
+                chunk.elementSize = elementSize;
+                chunk.stored = false;
+                c->m_chunks.push_back(chunk);
+            }
+
+            c->m_rawSize += p->allocSize();
+        }
+
+        {
+            TaskGroup taskGroup;
+            const FrameBuffer* p = fb;
+            size_t currentPlane = 0;
+
+            for (size_t i = 0; i < c->m_chunks.size(); i++)
+            {
+                Chunk& chunk = c->m_chunks[i];
+
+                for (; currentPlane < chunk.plane; currentPlane++)
+                    p = p->nextPlane();
+
+                TwkFB::ThreadPool::addTask(new EncodeChunkTask(&taskGroup, p->pixels<unsigned char>() + chunk.offset, chunk));
+            }
+
+            //
+            //  TaskGroup destructor waits for the tasks to finish
+            //
+        }
+
+        for (size_t i = 0; i < c->m_chunks.size(); i++)
+            c->m_size += c->m_chunks[i].bytes.size() + sizeof(Chunk);
+
+        //
+        //  Not worth the decode time if it saves less than 1/8
+        //
+
+        if (c->m_chunks.empty() || c->m_size > c->m_rawSize - c->m_rawSize / 8)
+        {
+            delete c;
+            return 0;
+        }
+
+        return c;
+    }
+
+    bool CompressedFB::decompress(FrameBuffer* fb) const
+    {
+        HOP_PROF_FUNC();
+
+        //
+        //  Not vector<bool>, each task writes a byte of its own
+        //
+
+        vector<char> ok(m_chunks.size(), 0);
+
+        {
+            TaskGroup taskGroup;
+            FrameBuffer* p = fb;
+            size_t currentPlane = 0;
+
+            for (size_t i = 0; i < m_chunks.size(); i++)
+            {
+                const Chunk& chunk = m_chunks[i];
+
+                for (; currentPlane < chunk.plane; currentPlane++)
+                    p = p->nextPlane();
+
+                TwkFB::ThreadPool::addTask(
+                    new DecodeChunkTask(&taskGroup, chunk, p->pixels<unsigned char>() + chunk.offset, ok[i]));
+            }
+        }
+
+        return find(ok.begin(), ok.end(), 0) == ok.end();
+    }
+
+} // namespace IPCore
@@ -7,6 +7,7 @@
 //******************************************************************************
 #include <IPCore/DisplayIPNode.h>
 #include <IPCore/Exception.h>
+#include <IPCore/IPGraph.h>
 #include <IPCore/ShaderCommon.h>
 #include <ImfRgbaYca.h>
 #include <ImfChromaticities.h>
@@ -16,6 +17,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <stl_ext/string_algo.h>
 #include <TwkFB/Operations.h>
 #include <IPCore/IPProperty.h>
@@ -40,6 +42,7 @@ namespace IPCore
 
     DisplayIPNode::DisplayIPNode(const std::string& name, const NodeDefinition* def, IPGraph* g, GroupIPNode* group)
         : LUTIPNode(name, def, g, group)
+        , m_inputsReadAlpha(0)
     {
         setMaxInputs(1);
         setHasLinearTransform(true); // fits to aspect
@@ -233,36 +236,43 @@ namespace IPCore
         }
     };
 
-    IPImage* DisplayIPNode::evaluate(const Context& context)
+    namespace
     {
-        int frame = context.frame;
 
-        IPImage* root = IPNode::evaluate(context);
+        //
+        //  Finds any node on the inputs which uses alpha
+        //
 
-        if (!root)
-            return IPImage::newNoImage(this, "No Input");
-        if (root->isBlank() || root->isNoImage())
-            return root;
-        if (propertyValue(m_active, 1) == 0)
-            return root;
+        class ReadsAlphaVisitor : public IPNode::NodeVisitor
+        {
+        public:
+            ReadsAlphaVisitor()
+                : found(false)
+            {
+            }
 
-        bool linear2sRGB = propertyValue(m_srgb, 0) != 0;
-        bool linear2Rec709 = propertyValue(m_rec709, 0) != 0;
-        float displayGamma = propertyValue(m_gamma, 1.0f);
-        bool outOfRange = propertyValue(m_outOfRange, 0) != 0;
-        int dither = propertyValue(m_dither, 0);
-        bool ditherLast = propertyValue(m_ditherLast, 1) != 0;
-        string bgtype = "none";
-        Vec3f bgcolor = Vec3f(0.18);
-        bool chromaActive = propertyValue(m_chromaActive, 0) != 0;
+            bool found;
+            std::set<IPNode*> visited;
+
+            virtual void enter(IPNode* n)
+            {
+                visited.insert(n);
+                if (n->readsInputAlpha())
+                    found = true;
+            }
+
+            virtual bool traverseChild(size_t, IPNode*, IPNode* child) { return !found && !visited.count(child); }
+        };
 
-        Mat44f C, Ca, B;
+    } // namespace
+
+    Mat44f DisplayIPNode::channelMatrix() const
+    {
+        Mat44f Ca;
 
         string order = propertyValue(m_channelOrder, "");
         int flood = propertyValue(m_channelFlood, 0);
 
-        string overrideColorspace = propertyValue(m_overrideColorspace, "");
-
         if (order != "")
         {
             Mat44f M(0.0);
@@ -332,6 +342,96 @@ namespace IPCore
             Ca = F * Ca;
         }
 
+        return Ca;
+    }
+
+    bool DisplayIPNode::inputsReadAlpha() const
+    {
+        //
+        //  Walking the inputs every evaluation adds up with a big
+        //  sequence or stack, so the answer is kept until the graph
+        //  changes.
+        //
+
+        const size_t serial = graph() ? graph()->stateSerial() : 0;
+        const size_t known = m_inputsReadAlpha;
+
+        if (serial && known >> 1 == serial)
+            return known & 1;
+
+        ReadsAlphaVisitor visitor;
+
+        for (size_t i = 0; i < inputs().size() && !visitor.found; i++)
+        {
+            inputs()[i]->visitRecursive(visitor);
+        }
+
+        m_inputsReadAlpha = serial << 1 | (visitor.found ? 1 : 0);
+        return visitor.found;
+    }
+
+    IPNode::Context DisplayIPNode::inputContext(const Context& context) const
+    {
+        //
+        //  If the channel order/flood never reads alpha and nothing
+        //  between here and the sources composites or premultiplies
+        //  with it the sources don't need to decode alpha. Color nodes
+        //  mix R, G and B so only alpha can be dropped.
+        //
+
+        if (!context.consumedChannels.empty() || propertyValue(m_active, 1) == 0)
+            return context;
+
+        const Mat44f Ca = channelMatrix();
+
+        for (int i = 0; i < 4; i++)
+        {
+            if (Ca(i, 3) != 0.0f)
+                return context;
+        }
+
+        if (inputsReadAlpha())
+            return context;
+
+        Context c = context;
+        c.consumedChannels.push_back("R");
+        c.consumedChannels.push_back("G");
+        c.consumedChannels.push_back("B");
+        return c;
+    }
+
+    IPImageID* DisplayIPNode::evaluateIdentifier(const Context& context)
+    {
+        return IPNode::evaluateIdentifier(inputContext(context));
+    }
+
+    IPImage* DisplayIPNode::evaluate(const Context& context)
+    {
+        int frame = context.frame;
+
+        IPImage* root = IPNode::evaluate(inputContext(context));
+
+        if (!root)
+            return IPImage::newNoImage(this, "No Input");
+        if (root->isBlank() || root->isNoImage())
+            return root;
+        if (propertyValue(m_active, 1) == 0)
+            return root;
+
+        bool linear2sRGB = propertyValue(m_srgb, 0) != 0;
+        bool linear2Rec709 = propertyValue(m_rec709, 0) != 0;
+        float displayGamma = propertyValue(m_gamma, 1.0f);
+        bool outOfRange = propertyValue(m_outOfRange, 0) != 0;
+        int dither = propertyValue(m_dither, 0);
+        bool ditherLast = propertyValue(m_ditherLast, 1) != 0;
+        string bgtype = "none";
+        Vec3f bgcolor = Vec3f(0.18);
+        bool chromaActive = propertyValue(m_chromaActive, 0) != 0;
+        string overrideColorspace = propertyValue(m_overrideColorspace, "");
+
+        Mat44f C, B;
+        Mat44f Ca = channelMatrix();
+
         if (chromaActive)
         {
             Vec2fProperty* vp;
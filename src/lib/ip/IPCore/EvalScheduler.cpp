@@ -0,0 +1,255 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/EvalScheduler.h>
+#include <IPCore/FBCache.h>
+#include <IPCore/IPImage.h>
+#include <TwkUtil/sgcHop.h>
+
+namespace IPCore
+{
+    using namespace std;
+
+    EvalScheduler::Group::Group()
+        : m_pending(0)
+        , m_failed(false)
+    {
+        pthread_mutex_init(&m_mutex, 0);
+        pthread_cond_init(&m_cond, 0);
+    }
+
+    EvalScheduler::Group::~Group()
+    {
+        pthread_cond_destroy(&m_cond);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    void EvalScheduler::Group::add(size_t n)
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_pending += n;
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    void EvalScheduler::Group::done(bool ok)
+    {
+        pthread_mutex_lock(&m_mutex);
+        if (!ok)
+            m_failed = true;
+        if (--m_pending == 0)
+            pthread_cond_broadcast(&m_cond);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    void EvalScheduler::Group::wait()
+    {
+        pthread_mutex_lock(&m_mutex);
+        while (m_pending)
+            pthread_cond_wait(&m_cond, &m_mutex);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    bool EvalScheduler::Group::finished() const
+    {
+        pthread_mutex_lock(&m_mutex);
+        bool b = m_pending == 0;
+        pthread_mutex_unlock(&m_mutex);
+        return b;
+    }
+
+    EvalScheduler::EvalScheduler(FBCache& cache)
+        : m_cache(cache)
+        , m_numTasks(0)
+        , m_numPriority(0)
+        , m_tasksRun(0)
+        , m_tasksStolen(0)
+    {
+    }
+
+    EvalScheduler::~EvalScheduler() { setNumQueues(0); }
+
+    void EvalScheduler::setNumQueues(size_t n)
+    {
+        for (size_t i = n; i < m_queues.size(); i++)
+            delete m_queues[i];
+
+        size_t old = m_queues.size();
+        m_queues.resize(n);
+
+        for (size_t i = old; i < n; i++)
+            m_queues[i] = new Queue();
+    }
+
+    EvalScheduler::Task* EvalScheduler::popBack(Queue& q)
+    {
+        Task* t = 0;
+
+        pthread_mutex_lock(&q.mutex);
+
+        if (!q.tasks.empty())
+        {
+            t = q.tasks.back();
+            q.tasks.pop_back();
+        }
+
+        pthread_mutex_unlock(&q.mutex);
+        return t;
+    }
+
+    EvalScheduler::Task* EvalScheduler::popFront(Queue& q)
+    {
+        Task* t = 0;
+
+        pthread_mutex_lock(&q.mutex);
+
+        if (!q.tasks.empty())
+        {
+            t = q.tasks.front();
+            q.tasks.pop_front();
+        }
+
+        pthread_mutex_unlock(&q.mutex);
+        return t;
+    }
+
+    void EvalScheduler::push(size_t queue, Task* t)
+    {
+        if (queue >= m_queues.size())
+        {
+            pushPriority(t);
+            return;
+        }
+
+        Queue& q = *m_queues[queue];
+        pthread_mutex_lock(&q.mutex);
+        q.tasks.push_back(t);
+        m_numTasks++;
+        pthread_mutex_unlock(&q.mutex);
+    }
+
+    void EvalScheduler::pushPriority(Task* t)
+    {
+        pthread_mutex_lock(&m_priority.mutex);
+        m_priority.tasks.push_back(t);
+        m_numPriority++;
+        pthread_mutex_unlock(&m_priority.mutex);
+    }
+
+    EvalScheduler::Task* EvalScheduler::nextPriority()
+    {
+        if (m_numPriority > 0)
+        {
+            if (Task* t = popFront(m_priority))
+            {
+                m_numPriority--;
+                return t;
+            }
+        }
+
+        return 0;
+    }
+
+    EvalScheduler::Task* EvalScheduler::next(size_t queue)
+    {
+        if (Task* t = nextPriority())
+            return t;
+
+        if (m_numTasks == 0)
+            return 0;
+
+        const size_t n = m_queues.size();
+
+        if (queue < n)
+        {
+            if (Task* t = popBack(*m_queues[queue]))
+            {
+                m_numTasks--;
+                return t;
+            }
+        }
+
+        //
+        //  Steal the oldest task of the next thread that has any. The
+        //  owner works from the other end so we rarely contend for the
+        //  same task.
+        //
+
+        for (size_t i = 1; i <= n; i++)
+        {
+            const size_t victim = (queue + i) % n;
+
+            if (victim == queue)
+                continue;
+
+            if (Task* t = popFront(*m_queues[victim]))
+            {
+                m_numTasks--;
+                m_tasksStolen++;
+                return t;
+            }
+        }
+
+        return 0;
+    }
+
+    void EvalScheduler::run(Task* t, size_t queue, IPNode::ThreadType type)
+    {
+        HOP_PROF_FUNC();
+
+        //
+        //  Per-thread resources (e.g. movie readers) are picked by
+        //  thread number, so evaluate as the thread running the task.
+        //
+
+        t->context.thread = type;
+        t->context.threadNum = queue;
+
+        bool ok = true;
+
+        try
+        {
+            IPImage* img = t->node->evaluate(t->context);
+
+            TWK_CACHE_LOCK(m_cache, "");
+            m_cache.checkInAndDelete(img);
+            TWK_CACHE_UNLOCK(m_cache, "");
+        }
+        catch (...)
+        {
+            //
+            //  The frame's own evaluation will run into the same problem
+            //  and deal with it.
+            //
+
+            ok = false;
+        }
+
+        Group* g = t->group;
+        delete t;
+        m_tasksRun++;
+        g->done(ok);
+    }
+
+    void EvalScheduler::complete(Group& group, size_t queue, IPNode::ThreadType type)
+    {
+        while (!group.finished())
+        {
+            if (Task* t = queue == 0 ? nextPriority() : next(queue))
+            {
+                run(t, queue, type);
+            }
+            else
+            {
+                //
+                //  Whatever is left of the group is being run by other
+                //  threads.
+                //
+
+                group.wait();
+            }
+        }
+    }
+
+} // namespace IPCore
@@ -7,14 +7,29 @@
 //******************************************************************************
 
 #include <IPCore/FBCache.h>
+#include <IPCore/FBDiskCache.h>
+#include <IPCore/CompressedFB.h>
 #include <IPCore/IPGraph.h>
 #include <IPCore/IPImage.h>
 #include <IPCore/Application.h>
+#include <TwkFB/Exception.h>
 #include <TwkUtil/EnvVar.h>
 #include <TwkUtil/ThreadName.h>
 #include <TwkUtil/Timer.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 static ENVVAR_BOOL(evActiveTailCaching, "RV_ACTIVE_TAIL_CACHING", false);
+static ENVVAR_STRING(evDiskCacheDir, "RV_DISK_CACHE_DIR", "");
+static ENVVAR_INT(evDiskCacheSize, "RV_DISK_CACHE_SIZE", 8192);
+static ENVVAR_BOOL(evCacheCompression, "RV_CACHE_COMPRESSION", false);
+static ENVVAR_INT(evCacheCompressionWindow, "RV_CACHE_COMPRESSION_WINDOW", 0);
+static ENVVAR_BOOL(evCacheCostAware, "RV_CACHE_COST_AWARE", true);
+static ENVVAR_BOOL(evCacheFairShare, "RV_CACHE_FAIR_SHARE", false);
+static ENVVAR_BOOL(evCacheScrubPrefetch, "RV_CACHE_SCRUB_PREFETCH", true);
 
 namespace IPCore
 {
@@ -750,1607 +765,3244 @@ namespace IPCore
         return name;
     }
 
-    FBCache::FBCache(IPGraph* g)
-        : TwkFB::Cache()
-        , m_graph(g)
-        , m_displayFrame(NAF)
-        , m_displayInc(0)
-        , m_displayFPS(0)
-        , m_minFrame(NAF)
-        , m_maxFrame(NAF)
-        , m_inFrame(NAF)
-        , m_outFrame(NAF)
-        , m_cacheFrame(NAF)
-        , m_freeMode(ConservativeFreeMode)
-        , m_overflowBoundary(0)
-        , m_utilityStateChanged(false)
-        , m_targetCacheFrameUtility(utilityMax)
-        , m_lookBehindFraction(25.0)
-        , m_activeTailCachingEnabled(false)
-        , m_cacheStatsDisabled(false)
-        , m_cacheStatsDirty(true)
+    //
+    //  The FrameIndex holds the frame-level bookkeeping of the FBCache:
+    //  which cached items each frame uses, and which frames use each
+    //  item.
+    //
+    //  Items are interned to small integer ids and each frame's items are
+    //  kept in a flat array. The frame side is split into shards by frame
+    //  range (blocks of 1 << ShardFrameBits frames), each shard with its
+    //  own reader/writer lock.
+    //
+    //  Notes:
+    //
+    //  * All modifications are made with the TwkFB::Cache mutex held, so
+    //    writers are already serialized. Writers only take a shard's
+    //    write lock for the short time it takes to modify a frame's
+    //    array.
+    //
+    //  * contains(), items() and pinItems() only take a shard's read
+    //    lock, so they can be called from the display thread without
+    //    locking the cache. The FrameBuffers items() returns can be
+    //    deleted by a writer freeing the frame right after, so using
+    //    them needs the cache lock. pinItems() pins them before the
+    //    read lock is let go: a writer can still take them out of the
+    //    frame but the cache won't delete them or release their pixels
+    //    (see TwkFB::Cache::retirePins()).
+    //
+    //  * The frames being cached (FBCache::m_framesBeingCached) are not
+    //    part of the index: only caching threads look at them, always
+    //    with the cache lock held, so they stay in a hash table under
+    //    that lock.
+    //
+    //  * The item side (frames that use an item) is only ever touched
+    //    with the cache mutex held, so it needs no locking of its own.
+    //
+
+    class FrameIndex
     {
-        m_cacheEdges = new CacheEdges(this);
-        m_perNodeCache = new PerNodeCache(this);
-        pthread_mutex_init(&m_statMutex, 0);
+    public:
+        typedef TwkFB::FrameBuffer FrameBuffer;
+        typedef FBCache::FBVector FBVector;
+        typedef FBCache::FrameVector FrameVector;
+        typedef unsigned int ItemID;
 
-        m_cacheStatsDisabled = IPCore::App()->optionValue<bool>("disableCacheStats", false);
+        FrameIndex();
+        ~FrameIndex();
 
-        m_activeTailCachingEnabled = evActiveTailCaching.getValue();
-        if (m_activeTailCachingEnabled)
+        //
+        //  Readers: no cache lock required
+        //
+
+        bool contains(int frame) const;
+        bool items(int frame, FBVector& fbs) const;
+        bool pinItems(int frame, FBVector& fbs) const;
+
+        size_t size() const { return m_numFrames; }
+
+        //
+        //  Writers and item queries: cache lock required
+        //
+
+        bool insert(int frame, FrameBuffer* fb);
+        bool erase(int frame, const FrameBuffer* fb);
+        bool eraseItem(const FrameBuffer* fb, FrameVector& frames);
+        void clear();
+
+        bool contains(int frame, const FrameBuffer* fb) const;
+        size_t numFramesOfItem(const FrameBuffer* fb) const;
+        void framesOfItem(const FrameBuffer* fb, FrameVector& frames) const;
+        void sortedFrames(FrameVector& frames) const;
+
+    private:
+        enum
         {
-            cout << "INFO: Active tail caching enabled" << std::endl;
-        }
+            ShardBits = 4,
+            ShardFrameBits = 6,
+            NumShards = 1 << ShardBits
+        };
+
+        struct FrameItem
+        {
+            ItemID id;
+            FrameBuffer* fb;
+        };
+
+        typedef std::vector<FrameItem> FrameItems;
+        typedef std::unordered_map<int, FrameItems> FrameItemsMap;
+
+        struct Shard
+        {
+            mutable std::shared_mutex lock;
+            FrameItemsMap frames;
+        };
+
+        struct Item
+        {
+            FrameBuffer* fb;
+            FrameVector frames; // sorted
+        };
+
+        typedef std::unordered_map<const FrameBuffer*, ItemID> ItemIDMap;
+        typedef std::vector<Item> ItemVector;
+        typedef std::vector<ItemID> ItemIDVector;
+
+        Shard& shard(int frame) { return m_shards[(unsigned int)(frame) >> ShardFrameBits & (NumShards - 1)]; }
+
+        const Shard& shard(int frame) const { return m_shards[(unsigned int)(frame) >> ShardFrameBits & (NumShards - 1)]; }
+
+        ItemID intern(FrameBuffer* fb);
+        void release(ItemID id);
+
+    private:
+        Shard m_shards[NumShards];
+        ItemIDMap m_itemIDs;
+        ItemVector m_items;
+        ItemIDVector m_freeItemIDs;
+        std::atomic<size_t> m_numFrames;
+    };
+
+    FrameIndex::FrameIndex()
+        : m_numFrames(0)
+    {
     }
 
-    FBCache::~FBCache()
+    FrameIndex::~FrameIndex() {}
+
+    bool FrameIndex::contains(int frame) const
     {
-        lock();
-        clearInternal();
-        delete m_cacheEdges;
-        delete m_perNodeCache;
-        unlock();
-        pthread_mutex_destroy(&m_statMutex);
+        const Shard& s = shard(frame);
+        std::shared_lock<std::shared_mutex> l(s.lock);
+
+        return s.frames.find(frame) != s.frames.end();
     }
 
-    bool FBCache::hasPartialFrameCache(int frame) const
+    bool FrameIndex::items(int frame, FBVector& fbs) const
     {
-        FBVector cached;
+        const Shard& s = shard(frame);
+        std::shared_lock<std::shared_mutex> l(s.lock);
 
-        (void)frameItems(frame, cached);
-        for (int i = 0; i < cached.size(); ++i)
+        FrameItemsMap::const_iterator i = s.frames.find(frame);
+        if (i == s.frames.end())
+            return false;
+
+        for (size_t q = 0; q < i->second.size(); ++q)
+            fbs.push_back(i->second[q].fb);
+
+        return true;
+    }
+
+    bool FrameIndex::pinItems(int frame, FBVector& fbs) const
+    {
+        const Shard& s = shard(frame);
+        std::shared_lock<std::shared_mutex> l(s.lock);
+
+        FrameItemsMap::const_iterator i = s.frames.find(frame);
+        if (i == s.frames.end())
+            return false;
+
+        const size_t n = fbs.size();
+
+        for (size_t q = 0; q < i->second.size(); ++q)
         {
-            ItemFrames::const_iterator ifi = m_itemMap.find(cached[i]);
-            if (ifi != m_itemMap.end())
-            {
-                //
-                //  Some of the items in this map are just "references"
-                //  to images cached originally for other frames.  If
-                //  so, they will be referenced by more than one frame.
-                //  If on the other hand, there is exactly one frame
-                //  referencing this image, we know it is this one, and
-                //  the frame is truly "partially cached".
-                //
-                if (1 == ifi->second.size())
-                    return true;
-            }
+            FrameBuffer* fb = i->second[q].fb;
+            if (fb->cachePin())
+                fbs.push_back(fb);
         }
 
-        return false;
+        return fbs.size() > n;
     }
 
-    void FBCache::setMemoryUsage(size_t bytes)
+    FrameIndex::ItemID FrameIndex::intern(FrameBuffer* fb)
     {
-        size_t oldCapacity = capacity();
-        TwkFB::Cache::setMemoryUsage(bytes);
+        ItemIDMap::iterator i = m_itemIDs.find(fb);
+        if (i != m_itemIDs.end())
+            return i->second;
 
-        if (capacity() != oldCapacity)
+        ItemID id;
+
+        if (!m_freeItemIDs.empty())
         {
-            DBL(DB_SIZE, "setMemoryUsage() bytes " << bytes << " was " << oldCapacity << " used " << used());
-            m_utilityStateChanged = true;
-            m_overflowBoundary = 0;
+            id = m_freeItemIDs.back();
+            m_freeItemIDs.pop_back();
         }
+        else
+        {
+            id = ItemID(m_items.size());
+            m_items.push_back(Item());
+        }
+
+        m_items[id].fb = fb;
+        m_items[id].frames.clear();
+        m_itemIDs[fb] = id;
+        return id;
     }
 
-    bool FBCache::overflowing() const
+    void FrameIndex::release(ItemID id)
     {
-        //
-        //  overflowing() is used to tell whether we can continue
-        //  caching additional frames, so if we previously exceeded the
-        //  cache size when caching a frame, and set m_overflowBoundary
-        //  to the cache size we were at before we cached that frame,
-        //  use that size instead of the max size.
-        //
-        //  If we've never exceeded the cache size before, assume we're
-        //  not overflowing.
-        //
-        //  _But_ if we have trash items to free, assume we're not
-        //  overflowing even if the cache is full.
-        //
-        size_t u = used();
-        size_t o = m_overflowBoundary;
-        return (0 != o) ? (u >= o && (trashCount() == 0)) : false;
+        Item& item = m_items[id];
+        m_itemIDs.erase(item.fb);
+        item.fb = 0;
+        item.frames.clear();
+        m_freeItemIDs.push_back(id);
     }
 
-    struct FramePromoter
+    bool FrameIndex::contains(int frame, const FrameBuffer* fb) const
     {
-        FramePromoter(FBCache& c)
-            : cache(c)
-            , missedOne(false)
+        ItemIDMap::const_iterator i = m_itemIDs.find(fb);
+        if (i == m_itemIDs.end())
+            return false;
+
+        const FrameVector& frames = m_items[i->second].frames;
+        return std::binary_search(frames.begin(), frames.end(), frame);
+    }
+
+    size_t FrameIndex::numFramesOfItem(const FrameBuffer* fb) const
+    {
+        ItemIDMap::const_iterator i = m_itemIDs.find(fb);
+        return (i != m_itemIDs.end()) ? m_items[i->second].frames.size() : 0;
+    }
+
+    void FrameIndex::framesOfItem(const FrameBuffer* fb, FrameVector& frames) const
+    {
+        ItemIDMap::const_iterator i = m_itemIDs.find(fb);
+
+        if (i != m_itemIDs.end())
+            frames = m_items[i->second].frames;
+        else
+            frames.clear();
+    }
+
+    bool FrameIndex::insert(int frame, FrameBuffer* fb)
+    {
+        ItemID id = intern(fb);
+        FrameVector& frames = m_items[id].frames;
+        FrameVector::iterator fi = std::lower_bound(frames.begin(), frames.end(), frame);
+
+        if (fi != frames.end() && *fi == frame)
+            return false;
+
+        frames.insert(fi, frame);
+
+        Shard& s = shard(frame);
+        std::unique_lock<std::shared_mutex> l(s.lock);
+
+        FrameItems& items = s.frames[frame];
+        if (items.empty())
+            ++m_numFrames;
+
+        FrameItem item;
+        item.id = id;
+        item.fb = fb;
+        items.push_back(item);
+
+        return true;
+    }
+
+    bool FrameIndex::erase(int frame, const FrameBuffer* fb)
+    {
+        ItemIDMap::iterator i = m_itemIDs.find(fb);
+        if (i == m_itemIDs.end())
+            return false;
+
+        ItemID id = i->second;
+        FrameVector& frames = m_items[id].frames;
+        FrameVector::iterator fi = std::lower_bound(frames.begin(), frames.end(), frame);
+
+        if (fi == frames.end() || *fi != frame)
+            return false;
+
+        frames.erase(fi);
+        if (frames.empty())
+            release(id);
+
+        Shard& s = shard(frame);
+        std::unique_lock<std::shared_mutex> l(s.lock);
+
+        FrameItemsMap::iterator q = s.frames.find(frame);
+        if (q != s.frames.end())
         {
+            FrameItems& items = q->second;
+
+            for (size_t n = 0; n < items.size(); ++n)
+            {
+                if (items[n].id == id)
+                {
+                    items[n] = items.back();
+                    items.pop_back();
+                    break;
+                }
+            }
+
+            if (items.empty())
+            {
+                s.frames.erase(q);
+                --m_numFrames;
+            }
         }
 
-        FBCache& cache;
-        FBCache::IDSet ids;
-        bool missedOne;
+        return true;
+    }
 
-        void operator()(IPImageID* idp)
+    bool FrameIndex::eraseItem(const FrameBuffer* fb, FrameVector& frames)
+    {
+        ItemIDMap::iterator i = m_itemIDs.find(fb);
+        if (i == m_itemIDs.end())
+            return false;
+
+        ItemID id = i->second;
+        frames = m_items[id].frames;
+        release(id);
+
+        for (size_t f = 0; f < frames.size(); ++f)
         {
-            DBL(DB_PROMOTE, "FramePromoter idp " << idp << ", fb id " << idp->id);
+            Shard& s = shard(frames[f]);
+            std::unique_lock<std::shared_mutex> l(s.lock);
 
-            if (missedOne || idp->id == "")
-                return;
+            FrameItemsMap::iterator q = s.frames.find(frames[f]);
+            if (q == s.frames.end())
+                continue;
 
-            if (!cache.isCached(idp->id))
+            FrameItems& items = q->second;
+
+            for (size_t n = 0; n < items.size(); ++n)
             {
-                missedOne = true;
-                DBL(DB_PROMOTE, "    missed!");
+                if (items[n].id == id)
+                {
+                    items[n] = items.back();
+                    items.pop_back();
+                    break;
+                }
             }
-            else
+
+            if (items.empty())
             {
-                ids.insert(idp->id);
-                DBL(DB_PROMOTE, "    hit!");
+                s.frames.erase(q);
+                --m_numFrames;
             }
         }
-    };
 
-    bool FBCache::promoteFrame(int frame, IPImageID* idTree)
+        return true;
+    }
+
+    void FrameIndex::clear()
     {
-        FramePromoter fp(*this);
+        for (size_t i = 0; i < NumShards; ++i)
+        {
+            std::unique_lock<std::shared_mutex> l(m_shards[i].lock);
+            m_shards[i].frames.clear();
+        }
 
-        foreach_ip(idTree, fp);
-        DBL(DB_PROMOTE, "promoteFrame " << frame << ", " << fp.ids.size() << " cached, missedOne " << fp.missedOne);
+        m_itemIDs.clear();
+        m_items.clear();
+        m_freeItemIDs.clear();
+        m_numFrames = 0;
+    }
 
-        if (fp.missedOne)
-            return false;
+    void FrameIndex::sortedFrames(FrameVector& frames) const
+    {
+        frames.clear();
+        frames.reserve(m_numFrames);
 
         //
-        //  Add fbs to list of fbs for this frame.
+        //  Writers hold the cache lock, and so do we, so no need to lock
+        //  the shards here.
         //
-        for (IDSet::iterator i = fp.ids.begin(); i != fp.ids.end(); ++i)
+
+        for (size_t i = 0; i < NumShards; ++i)
         {
-            referenceFrame(frame, m_map[*i]);
+            const FrameItemsMap& fmap = m_shards[i].frames;
+
+            for (FrameItemsMap::const_iterator q = fmap.begin(); q != fmap.end(); ++q)
+            {
+                frames.push_back(q->first);
+            }
         }
-        m_cacheEdges->addCacheEdge(frame);
 
-        return true;
+        std::sort(frames.begin(), frames.end());
     }
 
-    bool FBCache::add(FrameBuffer* fb, int frame, bool force, const IPNode* node)
+    //
+    //  The CostModel keeps track of how long it takes to evaluate
+    //  (read, decode, etc) the cached images of each source at each
+    //  frame and how big they are. The utility function uses it to
+    //  favor caching frames which are expensive to produce and freeing
+    //  those which are cheap to produce again for the memory they hold.
+    //
+    //  Per source the model is an exponentially weighted average of the
+    //  samples. Per frame it's the sum of the latest sample of each
+    //  source evaluated at that frame. Frames that have never been
+    //  evaluated use the cost of the nearest frame that has (which is
+    //  likely to have the same sources). Only the maxFrames frames
+    //  nearest the last one recorded are kept.
+    //
+    //  All functions require the cache lock.
+    //
+
+    class CostModel
     {
-        if (node)
-        {
-            if (!fb->inCache())
-                TwkFB::Cache::add(fb, true);
-            bool added = m_perNodeCache->add(fb, node);
-            if (added)
-                m_graph->textureCacheUpdated()();
-            //
-            //  Allways return true, since the fb _is_ cached at this point.
-            //
-            return true;
-        }
-        DB("add() frame " << frame << " (fb " << fb << ", " << fb->identifier() << ") force " << force << " frame in cache "
-                          << isFrameCached(frame));
-        if (frame == NAF)
+    public:
+        typedef FBCache::SourceCost SourceCost;
+        typedef FBCache::SourceCostVector SourceCostVector;
+
+        CostModel()
+            : m_meanSeconds(0)
+            , m_meanBytes(0)
+            , m_samples(0)
         {
-            cout << "Frame == NAF" << endl;
-            abort();
         }
-        bool itemInCache = m_itemMap.count(fb) > 0;
-        bool partiallyCached = hasPartialFrameCache(frame);
 
-        /*
-        FrameMap::const_iterator i = m_frames.find(frame);
-        if (i != m_frames.end()) cerr << "FRAME " << frame << ", " <<
-        i->second.size() << " items" << endl;
-        */
+        void record(const string& source, int frame, double seconds, size_t bytes);
 
-        DB("    itemInCache " << itemInCache << " this frame in itemMap entry: " << m_itemMap[fb].count(frame));
-        if (itemInCache && m_itemMap[fb].count(frame) > 0)
-        {
-            //
-            //  This frame is already referenced for this fb. Make sure
-            //  its also referenced by this frame. But if this is the
-            //  *first* item for this frame and the cache is already full,
-            //  we need to return false immediately.
-            //
+        //
+        //  Cost of frame relative to the average frame. For caching it's
+        //  in seconds, for freeing it's in seconds per byte. Clamped so
+        //  that distance from the display frame still dominates.
+        //
 
-            DB("    m_frames count " << m_frames[frame].count(fb->identifier()));
-            if (m_full && !partiallyCached)
-                return false;
+        float cachingFactor(int frame) const;
+        float freeingFactor(int frame) const;
 
-            DBL(DB_REF, "add() possibly reffing " << fb << " " << fb->identifier());
-            referenceFrame(frame, fb);
+        //
+        //  Evaluation time of frame in seconds, 0 if nothing's known
+        //
 
-            checkMetadata();
-            return true;
-        }
+        float frameSeconds(int frame) const;
 
-        DB("add()     cached " << fb->inCache());
-        DB("add()     current " << m_currentBytes << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
+        void stats(SourceCostVector&, float& meanSeconds, float& meanBytes) const;
 
-        if (!fb->inCache())
+        void clear();
+
+    private:
+        struct Sample
         {
-            if ((fb->totalImageSize() + used()) > capacity())
-            //
-            //  If cache is overflowing, try to make room by freeing
-            //  trash fbs first.
-            //
-            {
-                freeTrash(fb->totalImageSize());
-            }
+            string source;
+            float seconds;
+            float bytes;
+        };
 
-            if ((fb->totalImageSize() + used()) > capacity() && (0 == m_overflowBoundary || used() < m_overflowBoundary))
-            //
-            //  If the above didn't help, and we're going to overflow
-            //  the cache with this addition, set the overfloat boundary
-            //  to the current cache size.
-            //
-            {
-                m_overflowBoundary = used();
-            }
+        typedef vector<Sample> Samples;
+        typedef std::map<int, Samples> FrameSamples;
+        typedef std::map<string, SourceCost> SourceMap;
 
-            //
-            //  If the frame is partially complete, just let it cache the
-            //  rest of it.  And we always allow caching of a single
-            //  frame, no matter how big it is.
-            //
+        bool frameCost(int frame, float& seconds, float& bytes) const;
 
-            bool forceadd = partiallyCached || force || m_map.size() == 0;
+        static float clampFactor(float f) { return min(max(f, 0.25f), 4.0f); }
 
-            DB("attempting TwkFB::add() forceadd " << forceadd << " partially cached " << partiallyCached);
-            m_targetCacheFrameUtility = utility(frame, FOR_CACHING);
-            bool notfull = TwkFB::Cache::add(fb, forceadd);
-            //
-            //  Note that TwkFB::Cache::add may or may not have added
-            //  the fb.  If "notfull" then it added the fb (or it was already
-            //  there).  if "!notfull" then the cache is full and add()
-            //  added the fb anyway if and only if "forceadd".
-            //
+        static const size_t maxFrames = 4096;
 
-            if (forceadd || notfull)
-            //
-            //  Then the fb was added to the cache, or was already
-            //  there, even if the cache is full.
-            //
-            {
-                if (Cache::debug())
-                    cout << "ADDED: " << fb << " : " << fb->identifier() << endl;
-                DB("add() forceadd || notfull, " << fb);
-                DB("    added frame " << frame << " id " << fb->identifier());
+    private:
+        FrameSamples m_frames;
+        SourceMap m_sources;
+        double m_meanSeconds;
+        double m_meanBytes;
+        size_t m_samples;
+    };
 
-                DBL(DB_REF, "add() (2) possibly reffing " << fb << " " << fb->identifier());
-                referenceFrame(frame, fb);
+    //
+    //  Weight of a new sample in the averages
+    //
 
-                if (Cache::debug())
-                {
-                    for (IDSet::iterator i = m_frames[frame].begin(); i != m_frames[frame].end(); ++i)
-                    {
-                        cout << "  " << frame << " --> " << *i << endl;
-                    }
-                }
+    static const double costAlpha = 0.1;
 
-                setCacheStatsDirty();
-                if (isFrameCached(frame))
-                {
-                    DBL(DB_EDGES, "add() calling addCacheEdge (1)" << frame << ", " << m_frames[frame].size() << " ids for this frame");
-                    m_cacheEdges->addCacheEdge(frame);
-                }
+    void CostModel::record(const string& source, int frame, double seconds, size_t bytes)
+    {
+        SourceCost& sc = m_sources[source];
 
-                //
-                // Err? Code that calls this add() thinks we only
-                // return false if we didn't add the fb to the cache.
-                // but we did add it, even if the cache is full.  so
-                // return true.
-                //
-                // return notfull;
-                checkMetadata();
-                return true;
-            }
-            else
-            {
-                checkMetadata();
-                return false;
-            }
+        if (sc.samples == 0)
+        {
+            sc.source = source;
+            sc.seconds = seconds;
+            sc.bytes = bytes;
         }
         else
         {
-            DB("add() fb was in cache " << fb);
-            DBL(DB_REF, "add() (3) possibly reffing " << fb << " " << fb->identifier());
-            referenceFrame(frame, fb);
-
-            setCacheStatsDirty();
-            if (isFrameCached(frame))
-            {
-                m_cacheEdges->addCacheEdge(frame);
-                DBL(DB_EDGES, "add() calling addCacheEdge (2)" << frame << ", " << m_frames[frame].size() << " ids for this frame");
-            }
+            sc.seconds += costAlpha * (seconds - sc.seconds);
+            sc.bytes += costAlpha * (double(bytes) - sc.bytes);
         }
 
-        checkMetadata();
-        return true;
-    }
-
-    void FBCache::flushPerNodeCache(const IPNode* node) { m_perNodeCache->add(0, node); }
-
-    TwkFB::FrameBuffer* FBCache::perNodeCacheContents(const IPNode* node) const { return m_perNodeCache->fbOfNode(node); }
+        sc.samples++;
 
-    bool FBCache::freeIDSet(const IDSet& idset, int frame)
-    {
-        DB("freeIDSet frame " << frame << " cached: " << isFrameCached(frame));
+        Samples& samples = m_frames[frame];
+        size_t i = 0;
 
-        IDSet myIDset = idset;
-        set<string> idsToFlush;
+        for (; i < samples.size() && samples[i].source != source; i++)
+            ;
 
-        for (IDSet::const_iterator id = myIDset.begin(); id != myIDset.end(); ++id)
+        if (i == samples.size())
         {
-            FBMap::iterator i = m_map.find(*id);
+            samples.push_back(Sample());
+            samples.back().source = source;
+        }
 
-            if (i != m_map.end())
-            {
-                FrameBuffer* fb = i->second;
-                ItemFrames::iterator item = m_itemMap.find(fb);
+        samples[i].seconds = seconds;
+        samples[i].bytes = bytes;
 
-                if (item != m_itemMap.end())
-                {
-                    //
-                    //  First remmove frame from m_itemMap for this id
-                    //
-                    if (item->second.count(frame))
-                    {
-                        item->second.erase(frame);
-                    }
+        //
+        //  Forget whichever end is further from the frame
+        //
 
-                    //
-                    //  Now remove id from m_frames map entry for this
-                    //  frame.
-                    //
-                    IDSet& idsetForFrame = m_frames[frame];
-                    if (idsetForFrame.count(*id))
-                    {
-                        idsetForFrame.erase(*id);
-                        DBL(DB_REF, "freeIDSet() dereferencing");
-                        dereferenceFB(fb);
-                    }
+        while (m_frames.size() > maxFrames)
+        {
+            if (frame - m_frames.begin()->first > m_frames.rbegin()->first - frame)
+                m_frames.erase(m_frames.begin());
+            else
+                m_frames.erase(--m_frames.end());
+        }
 
-                    //
-                    //  If that was the last frame that reffed this id,
-                    //  mark id for flushing from all FBCache
-                    //  (frame-level) data structures.
-                    //
-                    if (item->second.empty())
-                    {
-                        DB("freeIDSet() add to flush list: " << *id);
-                        idsToFlush.insert(*id);
-                    }
-                }
-            }
+        float frameSeconds, frameBytes;
+        frameCost(frame, frameSeconds, frameBytes);
+
+        if (m_samples == 0)
+        {
+            m_meanSeconds = frameSeconds;
+            m_meanBytes = frameBytes;
         }
-        DB("freeIDSet() ready to flush " << idsToFlush.size() << " ids");
-        for (set<string>::iterator itf = idsToFlush.begin(); itf != idsToFlush.end(); ++itf)
+        else
         {
-            DB("freeIDSet() flushing: " << *itf);
-            flush(*itf);
+            m_meanSeconds += costAlpha * (frameSeconds - m_meanSeconds);
+            m_meanBytes += costAlpha * (frameBytes - m_meanBytes);
         }
 
-        DB("freeIDSet done with frame " << frame << " cached: " << isFrameCached(frame));
-
-        return true;
+        m_samples++;
     }
 
-    //  XXX  these freeInRange functions no longer free anything,
-    //  they're used only to clear frame-level info from the data
-    //  structures.  should be rewritten or replaced.
-    //  In the current usage we don't want them to free anything since
-    //  it's used to clear the cache when turning off the cache, and you
-    //  might just turn it on again.
-
-    bool FBCache::freeInRangeForwards(size_t bytes, FrameVector& toBeErased, int minFrame, int maxFrame, bool greedy)
+    bool CostModel::frameCost(int frame, float& seconds, float& bytes) const
     {
-        DBL(DB_FREE, "free forwards " << minFrame << " - " << maxFrame << " greedy " << greedy);
-
-        bool enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
+        if (m_frames.empty())
+            return false;
 
-        size_t targetBytes = (m_maxBytes > bytes) ? m_maxBytes - bytes : 0;
+        FrameSamples::const_iterator i = m_frames.lower_bound(frame);
 
-        for (FrameMap::iterator fi = m_frames.begin(); fi != m_frames.end() && (!enough || greedy); ++fi)
+        if (i == m_frames.end())
         {
-            int frame = fi->first;
-
-            //
-            //  Note that this range must be inclusive, since functions
-            //  that call this one believe it to be inclusive.
-            //
-            if (frame >= minFrame && frame <= maxFrame)
-            {
-                //
-                //  Iterate over the ids that were cached for this frame
-                //
-
-                const IDSet& idset = fi->second;
+            --i;
+        }
+        else if (i->first != frame && i != m_frames.begin())
+        {
+            FrameSamples::const_iterator p = i;
+            --p;
+            if (frame - p->first < i->first - frame)
+                i = p;
+        }
 
-                if (freeIDSet(idset, frame))
-                {
-                    toBeErased.push_back(frame);
-                }
-                //
-                //  At best freeIDSet just flushes ids from the frame-level
-                //  data structures, adding them to the Cache-level
-                //  TrashCan, so call freeTrash to "really" free something.
-                //
-                /*
-                if (m_currentBytes > targetBytes)
-                {
-                    TwkFB::Cache::freeTrash (m_currentBytes - targetBytes);
-                }
-                */
+        seconds = 0;
+        bytes = 0;
 
-                enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
-            }
+        for (size_t q = 0; q < i->second.size(); q++)
+        {
+            seconds += i->second[q].seconds;
+            bytes += i->second[q].bytes;
         }
 
-        setCacheStatsDirty();
-
-        return (m_maxBytes - m_currentBytes >= bytes);
+        return true;
     }
 
-    bool FBCache::freeInRangeBackwards(size_t bytes, FrameVector& toBeErased, int minFrame, int maxFrame, bool greedy)
+    float CostModel::cachingFactor(int frame) const
     {
-        DBL(DB_FREE, "free backwards " << minFrame << " - " << maxFrame << " greedy " << greedy);
-
-        bool enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
-
-        size_t targetBytes = (m_maxBytes > bytes) ? m_maxBytes - bytes : 0;
-
-        for (FrameMap::reverse_iterator fi = m_frames.rbegin(); fi != m_frames.rend() && (!enough || greedy); ++fi)
-        {
-            int frame = fi->first;
-
-            //
-            //  Note that this range must be inclusive, since functions
-            //  that call this one believe it to be inclusive.
-            //
-            if (frame >= minFrame && frame <= maxFrame)
-            {
-                //
-                //  Iterate over the ids that were cached for this frame
-                //
-
-                const IDSet& idset = fi->second;
-
-                if (freeIDSet(idset, frame))
-                {
-                    toBeErased.push_back(frame);
-                }
-                //
-                //  At best freeIDSet just flushes ids from the frame-level
-                //  data structures, adding them to the Cache-level
-                //  TrashCan, so call freeTrash to "really" free something.
-                //
-                /*
-                if (m_currentBytes > targetBytes)
-                {
-                    TwkFB::Cache::freeTrash (m_currentBytes - targetBytes);
-                }
-                */
+        float seconds, bytes;
 
-                enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
-            }
-        }
-
-        setCacheStatsDirty();
+        if (m_meanSeconds <= 0.0 || !frameCost(frame, seconds, bytes))
+            return 1.0;
 
-        return (m_maxBytes - m_currentBytes >= bytes);
+        return clampFactor(seconds / m_meanSeconds);
     }
 
-    namespace
+    float CostModel::frameSeconds(int frame) const
     {
+        float seconds, bytes;
+        return frameCost(frame, seconds, bytes) ? seconds : 0.0f;
+    }
 
-        struct FrameCompare
-        {
-            FrameCompare(int df)
-                : dFrame(df)
-            {
-            }
-
-            bool operator()(int a, int b) { return (abs(dFrame - a) > abs(dFrame - b)); }
+    float CostModel::freeingFactor(int frame) const
+    {
+        float seconds, bytes;
 
-            int dFrame;
-        };
+        if (m_meanSeconds <= 0.0 || m_meanBytes <= 0.0 || !frameCost(frame, seconds, bytes) || bytes <= 0)
+            return 1.0;
 
-    }; // namespace
+        return clampFactor((seconds / bytes) / (m_meanSeconds / m_meanBytes));
+    }
 
-    void FBCache::clearFrameCaches()
+    void CostModel::stats(SourceCostVector& sources, float& meanSeconds, float& meanBytes) const
     {
-        m_framesScheduledForFreeing.clear();
-        m_framesBeingCached.clear();
+        sources.clear();
 
-        FrameVector sortedFrames;
-        for (FrameMap::iterator i = m_frames.begin(); i != m_frames.end(); ++i)
-        {
-            sortedFrames.push_back(i->first);
-        }
-        FrameCompare compOp(m_displayFrame);
-        std::sort(sortedFrames.begin(), sortedFrames.end(), compOp);
-
-        for (int i = 0; i < sortedFrames.size(); ++i)
+        for (SourceMap::const_iterator i = m_sources.begin(); i != m_sources.end(); ++i)
         {
-            freeIDSet(m_frames[sortedFrames[i]], sortedFrames[i]);
+            sources.push_back(i->second);
         }
 
-        /* CBB
-
-           It's possible that the above sorting, which helps things go into and
-        out of the TrashCan in the right order (IE prevent thrashing), is
-           unnecessary.  Maybe promotion just needs to be smarter.  If we figure
-           that out, we should go back to the below instead of sorting.
-
-        for (FrameMap::iterator i = m_frames.begin();
-             i != m_frames.end();
-             ++i)
-        {
-            freeIDSet(i->second, i->first);
-        }
-        */
+        meanSeconds = m_meanSeconds;
+        meanBytes = m_meanBytes;
+    }
 
+    void CostModel::clear()
+    {
         m_frames.clear();
-        m_cacheEdges->clear();
-        setCacheStatsDirty();
+        m_sources.clear();
+        m_meanSeconds = 0;
+        m_meanBytes = 0;
+        m_samples = 0;
     }
 
-    void FBCache::clearInternal()
-    {
-        DBL(DB_CLEAR,
-            "clearInternal() current " << m_currentBytes << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
+    FBCache::FBCache(IPGraph* g)
+        : TwkFB::Cache()
+        , m_graph(g)
+        , m_displayFrame(NAF)
+        , m_displayInc(0)
+        , m_displayFPS(0)
+        , m_minFrame(NAF)
+        , m_maxFrame(NAF)
+        , m_inFrame(NAF)
+        , m_outFrame(NAF)
+        , m_cacheFrame(NAF)
+        , m_freeMode(ConservativeFreeMode)
+        , m_overflowBoundary(0)
+        , m_utilityStateChanged(false)
+        , m_utilityEpoch(1)
+        , m_targetCacheFrameUtility(utilityMax)
+        , m_lookBehindFraction(25.0)
+        , m_activeTailCachingEnabled(false)
+        , m_cacheStatsDisabled(false)
+        , m_cacheStatsDirty(true)
+        , m_diskCache(0)
+        , m_compressionEnabled(false)
+        , m_compressionWindow(0)
+        , m_compressedBytes(0)
+        , m_compressedRawBytes(0)
+        , m_costAwareCaching(true)
+        , m_fairShareCaching(false)
+        , m_scrubPrefetch(true)
+        , m_prefetchRequested(0)
+        , m_prefetchHits(0)
+    {
+        m_cacheEdges = new CacheEdges(this);
+        m_perNodeCache = new PerNodeCache(this);
+        m_frameIndex = new FrameIndex();
+        m_costModel = new CostModel();
+        pthread_mutex_init(&m_statMutex, 0);
+        pthread_cond_init(&m_expandCond, 0);
 
-        clearFrameCaches();
-        //
-        //  We no longer clear the lower-level cache here, since it has
-        //  a trash collection scheme that should let us reuse fb's that
-        //  are now associated with different frames.
-        //
-        // TwkFB::Cache::clearInternal();
+        m_cacheStatsDisabled = IPCore::App()->optionValue<bool>("disableCacheStats", false);
+
+        m_activeTailCachingEnabled = evActiveTailCaching.getValue();
+        if (m_activeTailCachingEnabled)
+        {
+            cout << "INFO: Active tail caching enabled" << std::endl;
+        }
+
+        if (!evDiskCacheDir.getValue().empty())
+        {
+            setDiskCache(evDiskCacheDir.getValue(), size_t(max(evDiskCacheSize.getValue(), 0)) * 1024 * 1024);
+        }
+
+        m_compressionEnabled = evCacheCompression.getValue();
+        m_compressionWindow = evCacheCompressionWindow.getValue();
+        m_costAwareCaching = evCacheCostAware.getValue();
+        m_fairShareCaching = evCacheFairShare.getValue();
+        m_scrubPrefetch = evCacheScrubPrefetch.getValue();
+        if (m_compressionEnabled)
+        {
+            cout << "INFO: Cache compression enabled" << std::endl;
+        }
     }
 
-    void FBCache::clearAllButFrame(int frame, bool force)
+    FBCache::~FBCache()
     {
-        DBL(DB_CLEAR, "clearAllButFrame() frame " << frame << " m_frames size " << m_frames.size() << " current " << m_currentBytes
-                                                  << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
+        lock();
+        clearInternal();
+        delete m_cacheEdges;
+        delete m_perNodeCache;
+        delete m_frameIndex;
+        delete m_costModel;
+        delete m_diskCache;
 
         //
-        //  This only clears frame-level data unless "force" is true.
+        //  The compressed fbs themselves are deleted by the base class
         //
 
-        if (m_frames.size() == 0 || (m_frames.size() == 1 && m_frames.begin()->first == frame))
+        for (map<const FrameBuffer*, CompressedFB*>::iterator i = m_compressed.begin(); i != m_compressed.end(); ++i)
+        {
+            delete i->second;
+        }
+
+        m_compressed.clear();
+        unlock();
+        pthread_mutex_destroy(&m_statMutex);
+        pthread_cond_destroy(&m_expandCond);
+    }
+
+    bool FBCache::hasPartialFrameCache(int frame) const
+    {
+        FBVector cached;
+
+        (void)frameItems(frame, cached);
+        for (int i = 0; i < cached.size(); ++i)
         {
             //
-            //  Nothing to do.
+            //  Some of the items in this frame are just "references"
+            //  to images cached originally for other frames.  If
+            //  so, they will be referenced by more than one frame.
+            //  If on the other hand, there is exactly one frame
+            //  referencing this image, we know it is this one, and
+            //  the frame is truly "partially cached".
             //
-            if (force)
-                TwkFB::Cache::freeTrash(m_currentBytes);
-            return;
+            if (1 == m_frameIndex->numFramesOfItem(cached[i]))
+                return true;
         }
 
-        FrameVector toBeErased;
+        return false;
+    }
 
-        freeInRangeForwards(numeric_limits<size_t>::max(), toBeErased, m_minFrame, frame - 1, true);
+    bool FBCache::isFrameCached(int frame) const { return m_frameIndex->contains(frame); }
 
-        freeInRangeBackwards(numeric_limits<size_t>::max(), toBeErased, frame + 1, m_maxFrame - 1, true);
+    int FBCache::framesInItemMap(FrameBuffer* fb) const { return m_frameIndex->numFramesOfItem(fb); }
 
-        for (size_t i = 0; i < toBeErased.size(); i++)
+    void FBCache::setMemoryUsage(size_t bytes)
+    {
+        size_t oldCapacity = capacity();
+        TwkFB::Cache::setMemoryUsage(bytes);
+
+        if (capacity() != oldCapacity)
         {
-            int si = toBeErased[i];
-            m_frames.erase(si);
-            m_cacheEdges->removeCacheEdge(si);
+            DBL(DB_SIZE, "setMemoryUsage() bytes " << bytes << " was " << oldCapacity << " used " << used());
+            setUtilityStateChanged();
+            m_overflowBoundary = 0;
         }
-        if (force)
-            TwkFB::Cache::freeTrash(m_currentBytes);
     }
 
-    //
-    //  The value of the utility function determines caching policy:
-    //
-    //  * we try to cache frames with high utility
-    //  * we try to free frames with low utility
-    //  * we never cache frames with utility == 0.0
-    //
-    //  A valid utility function has these properties:
-    //
-    //  * produces values in the range: [0.0, utilityMax]
-    //  * for a given set of cached frames, the utility functions
-    //    extrema must occur on one of these frames: max/min, in/out,
-    //    displayFrame, a frame the lies on the edge of a region of
-    //    cached frames.
-    //
+    bool FBCache::overflowing() const
+    {
+        //
+        //  overflowing() is used to tell whether we can continue
+        //  caching additional frames, so if we previously exceeded the
+        //  cache size when caching a frame, and set m_overflowBoundary
+        //  to the cache size we were at before we cached that frame,
+        //  use that size instead of the max size.
+        //
+        //  If we've never exceeded the cache size before, assume we're
+        //  not overflowing.
+        //
+        //  _But_ if we have trash items to free, assume we're not
+        //  overflowing even if the cache is full.
+        //
+        size_t u = used();
+        size_t o = m_overflowBoundary;
+        return (0 != o) ? (u >= o && (trashCount() == 0)) : false;
+    }
 
-    inline float FBCache::utility(int frame, UtilityMode mode)
+    struct FramePromoter
     {
-        if (m_graph->cachingMode() == IPGraph::GreedyCache)
+        FramePromoter(FBCache& c, int f)
+            : cache(c)
+            , frame(f)
+            , missedOne(false)
         {
-            //
-            //  Region Cache
-            //
-            float d;
+        }
 
-            if (m_inFrame > frame)
-            {
-                d = (m_cacheOutsideRegion) ? 1.0 / (1.0 + m_inFrame - frame) : 0.0;
-            }
-            else if (m_outFrame <= frame)
-            {
-                d = (m_cacheOutsideRegion) ? 1.0 / (2.0 + frame - m_outFrame) : 0.0;
-            }
-            else if (frame == m_inFrame)
+        FBCache& cache;
+        int frame;
+        FBCache::IDSet ids;
+        bool missedOne;
+
+        void operator()(IPImageID* idp)
+        {
+            DBL(DB_PROMOTE, "FramePromoter idp " << idp << ", fb id " << idp->id);
+
+            if (missedOne || idp->id == "")
+                return;
+
+            if (!cache.isCached(idp->id))
             {
-                d = utilityMax;
+                missedOne = true;
+                DBL(DB_PROMOTE, "    missed!");
             }
             else
             {
-                d = 1.0 + 1.0 / abs(frame - m_inFrame);
+                ids.insert(idp->id);
+                DBL(DB_PROMOTE, "    hit!");
             }
+        }
+    };
 
-            DBL(DB_UTIL, "utility(" << frame << ") = " << d << ", dsp " << m_displayFrame << " cacheOutside " << m_cacheOutsideRegion);
-            return d;
+    struct FramePager
+    {
+        FramePager(FBCache& c, int f)
+            : cache(c)
+            , frame(f)
+        {
         }
 
-        //
-        //  Lookahead Cache
-        //
+        FBCache& cache;
+        int frame;
 
-        if (m_displayFrame == frame)
-            return utilityMax;
+        void operator()(IPImageID* idp) { cache.pageIn(idp->id, frame); }
+    };
 
-        int lastFrame = m_outFrame - 1;
-        int firstFrame = m_inFrame;
-        bool forward = (frame > m_displayFrame);
+    void FBCache::pageInFrame(int frame, IPImageID* idTree)
+    {
+        if (!m_diskCache)
+            return;
+
+        FramePager fp(*this, frame);
+        foreach_ip(idTree, fp);
+    }
+
+    bool FBCache::promoteFrame(int frame, IPImageID* idTree)
+    {
+        FramePromoter fp(*this, frame);
+
+        foreach_ip(idTree, fp);
+        DBL(DB_PROMOTE, "promoteFrame " << frame << ", " << fp.ids.size() << " cached, missedOne " << fp.missedOne);
+
+        if (fp.missedOne)
+            return false;
 
-        const float fact =
-            (mode == FOR_CACHING && !isActiveTailCachingEnabled()) ? 0.001f : min(max(m_lookBehindFraction / 100.0f, 0.001f), 0.999f);
         //
-        //  we apply fact if frame is in direction of playback,
-        //  ffact incorporates that policy
+        //  Add fbs to list of fbs for this frame.
         //
-
-        float ffact = fact;
-        if ((m_displayInc < 0 && forward) || (m_displayInc > 0 && !forward))
+        for (IDSet::iterator i = fp.ids.begin(); i != fp.ids.end(); ++i)
         {
-            ffact = 1.0 - fact;
+            referenceFrame(frame, m_map[*i]);
         }
+        m_cacheEdges->addCacheEdge(frame);
 
-        float d;
-        if (frame < firstFrame)
+        return true;
+    }
+
+    bool FBCache::add(FrameBuffer* fb, int frame, bool force, const IPNode* node, const string& source)
+    {
+        //
+        //  Decoded frames held by the movie readers come out of the
+        //  same memory budget.
+        //
+
+        updateCapacity();
+
+        if (node)
         {
-            d = (m_cacheOutsideRegion) ? 1.0 / (1.0 + firstFrame - frame) : 0.0;
+            if (!fb->inCache())
+                TwkFB::Cache::add(fb, true);
+            bool added = m_perNodeCache->add(fb, node);
+            if (added)
+                m_graph->textureCacheUpdated()();
+            //
+            //  Allways return true, since the fb _is_ cached at this point.
+            //
+            return true;
         }
-        else if (frame > lastFrame)
+        DB("add() frame " << frame << " (fb " << fb << ", " << fb->identifier() << ") force " << force << " frame in cache "
+                          << isFrameCached(frame));
+        if (frame == NAF)
         {
-            d = (m_cacheOutsideRegion) ? 1.0 / (1.0 + frame - lastFrame) : 0.0;
+            cout << "Frame == NAF" << endl;
+            abort();
         }
-        else
+        bool itemInCache = m_frameIndex->numFramesOfItem(fb) > 0;
+        bool partiallyCached = hasPartialFrameCache(frame);
+
+        DB("    itemInCache " << itemInCache << " this frame in item's frames: " << m_frameIndex->contains(frame, fb));
+        if (itemInCache && m_frameIndex->contains(frame, fb))
         {
             //
-            //  If we are in the in/out range, but the display frame is not, we
-            //  want to cache "relative" to the _next_ display frame if we
-            //  start playback, which will be the in point.
+            //  This frame is already referenced for this fb. Make sure
+            //  its also referenced by this frame. But if this is the
+            //  *first* item for this frame and the cache is already full,
+            //  we need to return false immediately.
             //
 
-            int testFrame = m_displayFrame;
-            if (m_displayFrame < firstFrame || m_displayFrame > lastFrame)
-                testFrame = firstFrame;
+            if (m_full && !partiallyCached)
+                return false;
 
-            d = ffact * fabs(float(frame - testFrame));
+            DBL(DB_REF, "add() possibly reffing " << fb << " " << fb->identifier());
+            attributeItem(fb, source);
+            referenceFrame(frame, fb);
 
-            //
-            //  Since frame is within the in/out range, test the "modulo"
-            //  distances that wrap round the front or back of the
-            //  range.  Add one, or a distance of zero is possible.
-            //
-            float dRoundFront = 1 + testFrame - firstFrame + lastFrame - frame;
-            float dRoundBack = 1 + lastFrame - testFrame + frame - firstFrame;
+            checkMetadata();
+            return true;
+        }
 
-            //
-            //  apply fact if this alternate path is "forward"
-            //
+        DB("add()     cached " << fb->inCache());
+        DB("add()     current " << m_currentBytes << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
+
+        if (!fb->inCache())
+        {
+            if ((fb->totalImageSize() + used()) > capacity())
+            //
+            //  If cache is overflowing, try to make room by freeing
+            //  trash fbs first.
+            //
+            {
+                freeTrash(fb->totalImageSize());
+            }
+
+            if ((fb->totalImageSize() + used()) > capacity() && (0 == m_overflowBoundary || used() < m_overflowBoundary))
+            //
+            //  If the above didn't help, and we're going to overflow
+            //  the cache with this addition, set the overfloat boundary
+            //  to the current cache size.
+            //
+            {
+                m_overflowBoundary = used();
+            }
+
+            //
+            //  If the frame is partially complete, just let it cache the
+            //  rest of it.  And we always allow caching of a single
+            //  frame, no matter how big it is.
+            //
+
+            bool forceadd = partiallyCached || force || m_map.size() == 0;
+
+            DB("attempting TwkFB::add() forceadd " << forceadd << " partially cached " << partiallyCached);
+            m_targetCacheFrameUtility = utility(frame, FOR_CACHING);
+            bool notfull = TwkFB::Cache::add(fb, forceadd);
+            //
+            //  Note that TwkFB::Cache::add may or may not have added
+            //  the fb.  If "notfull" then it added the fb (or it was already
+            //  there).  if "!notfull" then the cache is full and add()
+            //  added the fb anyway if and only if "forceadd".
+            //
+
+            if (forceadd || notfull)
+            //
+            //  Then the fb was added to the cache, or was already
+            //  there, even if the cache is full.
+            //
+            {
+                if (Cache::debug())
+                    cout << "ADDED: " << fb << " : " << fb->identifier() << endl;
+                DB("add() forceadd || notfull, " << fb);
+                DB("    added frame " << frame << " id " << fb->identifier());
+
+                DBL(DB_REF, "add() (2) possibly reffing " << fb << " " << fb->identifier());
+                attributeItem(fb, source);
+                referenceFrame(frame, fb);
+
+                if (Cache::debug())
+                {
+                    FBVector fbs;
+                    frameItems(frame, fbs);
+
+                    for (FBVector::iterator i = fbs.begin(); i != fbs.end(); ++i)
+                    {
+                        cout << "  " << frame << " --> " << (*i)->identifier() << endl;
+                    }
+                }
+
+                setCacheStatsDirty();
+                if (isFrameCached(frame))
+                {
+                    DBL(DB_EDGES, "add() calling addCacheEdge (1)" << frame);
+                    m_cacheEdges->addCacheEdge(frame);
+                }
+
+                //
+                // Err? Code that calls this add() thinks we only
+                // return false if we didn't add the fb to the cache.
+                // but we did add it, even if the cache is full.  so
+                // return true.
+                //
+                // return notfull;
+                checkMetadata();
+                return true;
+            }
+            else
+            {
+                checkMetadata();
+                return false;
+            }
+        }
+        else
+        {
+            DB("add() fb was in cache " << fb);
+            DBL(DB_REF, "add() (3) possibly reffing " << fb << " " << fb->identifier());
+            attributeItem(fb, source);
+            referenceFrame(frame, fb);
+
+            setCacheStatsDirty();
+            if (isFrameCached(frame))
+            {
+                m_cacheEdges->addCacheEdge(frame);
+                DBL(DB_EDGES, "add() calling addCacheEdge (2)" << frame);
+            }
+        }
+
+        checkMetadata();
+        return true;
+    }
+
+    void FBCache::flushPerNodeCache(const IPNode* node) { m_perNodeCache->add(0, node); }
+
+    TwkFB::FrameBuffer* FBCache::perNodeCacheContents(const IPNode* node) const { return m_perNodeCache->fbOfNode(node); }
+
+    bool FBCache::freeFrame(int frame)
+    {
+        DB("freeFrame frame " << frame << " cached: " << isFrameCached(frame));
+
+        FBVector fbs;
+        set<string> idsToFlush;
+
+        m_frameIndex->items(frame, fbs);
+
+        for (FBVector::iterator i = fbs.begin(); i != fbs.end(); ++i)
+        {
+            FrameBuffer* fb = *i;
+
+            //
+            //  Remove the frame from the fb's entry and the fb from the
+            //  frame's entry in the frame index.
+            //
+            if (m_frameIndex->erase(frame, fb))
+            {
+                DBL(DB_REF, "freeFrame() dereferencing");
+                noteFrameItem(frame, fb, false);
+                dereferenceFB(fb);
+            }
+
+            //
+            //  If that was the last frame that reffed this id,
+            //  mark id for flushing from all FBCache
+            //  (frame-level) data structures.
+            //
+            if (m_frameIndex->numFramesOfItem(fb) == 0)
+            {
+                DB("freeFrame() add to flush list: " << fb->identifier());
+                noteItemUnreferenced(fb);
+                noteLastFrameOfItem(fb, frame);
+                idsToFlush.insert(fb->identifier());
+            }
+        }
+
+        DB("freeFrame() ready to flush " << idsToFlush.size() << " ids");
+        for (set<string>::iterator itf = idsToFlush.begin(); itf != idsToFlush.end(); ++itf)
+        {
+            DB("freeFrame() flushing: " << *itf);
+            flush(*itf);
+        }
+
+        DB("freeFrame done with frame " << frame << " cached: " << isFrameCached(frame));
+
+        return true;
+    }
+
+    //  XXX  these freeInRange functions no longer free anything,
+    //  they're used only to clear frame-level info from the data
+    //  structures.  should be rewritten or replaced.
+    //  In the current usage we don't want them to free anything since
+    //  it's used to clear the cache when turning off the cache, and you
+    //  might just turn it on again.
+
+    bool FBCache::freeInRangeForwards(size_t bytes, FrameVector& toBeErased, int minFrame, int maxFrame, bool greedy)
+    {
+        DBL(DB_FREE, "free forwards " << minFrame << " - " << maxFrame << " greedy " << greedy);
+
+        bool enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
+
+        size_t targetBytes = (m_maxBytes > bytes) ? m_maxBytes - bytes : 0;
+
+        FrameVector frames;
+        m_frameIndex->sortedFrames(frames);
+
+        for (FrameVector::iterator fi = frames.begin(); fi != frames.end() && (!enough || greedy); ++fi)
+        {
+            int frame = *fi;
+
+            //
+            //  Note that this range must be inclusive, since functions
+            //  that call this one believe it to be inclusive.
+            //
+            if (frame >= minFrame && frame <= maxFrame)
+            {
+                //
+                //  Free the ids that were cached for this frame
+                //
+
+                if (freeFrame(frame))
+                {
+                    toBeErased.push_back(frame);
+                }
+                //
+                //  At best freeFrame just flushes ids from the frame-level
+                //  data structures, adding them to the Cache-level
+                //  TrashCan, so call freeTrash to "really" free something.
+                //
+                /*
+                if (m_currentBytes > targetBytes)
+                {
+                    TwkFB::Cache::freeTrash (m_currentBytes - targetBytes);
+                }
+                */
+
+                enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
+            }
+        }
+
+        setCacheStatsDirty();
+
+        return (m_maxBytes - m_currentBytes >= bytes);
+    }
+
+    bool FBCache::freeInRangeBackwards(size_t bytes, FrameVector& toBeErased, int minFrame, int maxFrame, bool greedy)
+    {
+        DBL(DB_FREE, "free backwards " << minFrame << " - " << maxFrame << " greedy " << greedy);
+
+        bool enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
+
+        size_t targetBytes = (m_maxBytes > bytes) ? m_maxBytes - bytes : 0;
+
+        FrameVector frames;
+        m_frameIndex->sortedFrames(frames);
+
+        for (FrameVector::reverse_iterator fi = frames.rbegin(); fi != frames.rend() && (!enough || greedy); ++fi)
+        {
+            int frame = *fi;
+
+            //
+            //  Note that this range must be inclusive, since functions
+            //  that call this one believe it to be inclusive.
+            //
+            if (frame >= minFrame && frame <= maxFrame)
+            {
+                //
+                //  Free the ids that were cached for this frame
+                //
+
+                if (freeFrame(frame))
+                {
+                    toBeErased.push_back(frame);
+                }
+                //
+                //  At best freeFrame just flushes ids from the frame-level
+                //  data structures, adding them to the Cache-level
+                //  TrashCan, so call freeTrash to "really" free something.
+                //
+                /*
+                if (m_currentBytes > targetBytes)
+                {
+                    TwkFB::Cache::freeTrash (m_currentBytes - targetBytes);
+                }
+                */
+
+                enough = m_currentBytes < m_maxBytes && (m_maxBytes - m_currentBytes >= bytes);
+            }
+        }
+
+        setCacheStatsDirty();
+
+        return (m_maxBytes - m_currentBytes >= bytes);
+    }
+
+    namespace
+    {
+
+        struct FrameCompare
+        {
+            FrameCompare(int df)
+                : dFrame(df)
+            {
+            }
+
+            bool operator()(int a, int b) { return (abs(dFrame - a) > abs(dFrame - b)); }
+
+            int dFrame;
+        };
+
+    }; // namespace
+
+    void FBCache::clearFrameCaches()
+    {
+        m_framesScheduledForFreeing.clear();
+        m_framesBeingCached.clear();
+
+        FrameVector sortedFrames;
+        m_frameIndex->sortedFrames(sortedFrames);
+        FrameCompare compOp(m_displayFrame);
+        std::sort(sortedFrames.begin(), sortedFrames.end(), compOp);
+
+        for (int i = 0; i < sortedFrames.size(); ++i)
+        {
+            freeFrame(sortedFrames[i]);
+        }
+
+        /* CBB
+
+           It's possible that the above sorting, which helps things go into and
+        out of the TrashCan in the right order (IE prevent thrashing), is
+           unnecessary.  Maybe promotion just needs to be smarter.  If we figure
+           that out, we should go back to the below instead of sorting.
+
+        FrameVector frames;
+        m_frameIndex->sortedFrames(frames);
+
+        for (int i = 0; i < frames.size(); ++i)
+        {
+            freeFrame(frames[i]);
+        }
+        */
+
+        m_frameIndex->clear();
+        m_cacheEdges->clear();
+
+        for (SourceAccountMap::iterator i = m_sourceAccounts.begin(); i != m_sourceAccounts.end(); ++i)
+        {
+            i->second.used = 0;
+            i->second.leftOut.clear();
+            i->second.frames.clear();
+            i->second.order.clear();
+            i->second.orderOf.clear();
+        }
+
+        setCacheStatsDirty();
+    }
+
+    void FBCache::clearInternal()
+    {
+        DBL(DB_CLEAR,
+            "clearInternal() current " << m_currentBytes << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
+
+        clearFrameCaches();
+
+        //
+        //  Frame numbers may mean something else after this (the graph
+        //  is usually being edited), so start over measuring costs.
+        //
+
+        m_costModel->clear();
+        m_prefetchRanks.clear();
+        m_prefetchedFrames.clear();
+
+        //
+        //  We no longer clear the lower-level cache here, since it has
+        //  a trash collection scheme that should let us reuse fb's that
+        //  are now associated with different frames.
+        //
+        // TwkFB::Cache::clearInternal();
+    }
+
+    void FBCache::clearAllButFrame(int frame, bool force)
+    {
+        DBL(DB_CLEAR, "clearAllButFrame() frame " << frame << " frames " << m_frameIndex->size() << " current " << m_currentBytes
+                                                  << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
+
+        //
+        //  This only clears frame-level data unless "force" is true.
+        //
+
+        if (m_frameIndex->size() == 0 || (m_frameIndex->size() == 1 && isFrameCached(frame)))
+        {
+            //
+            //  Nothing to do.
+            //
+            if (force)
+                TwkFB::Cache::freeTrash(m_currentBytes);
+            return;
+        }
+
+        FrameVector toBeErased;
+
+        freeInRangeForwards(numeric_limits<size_t>::max(), toBeErased, m_minFrame, frame - 1, true);
+
+        freeInRangeBackwards(numeric_limits<size_t>::max(), toBeErased, frame + 1, m_maxFrame - 1, true);
+
+        for (size_t i = 0; i < toBeErased.size(); i++)
+        {
+            m_cacheEdges->removeCacheEdge(toBeErased[i]);
+        }
+        if (force)
+            TwkFB::Cache::freeTrash(m_currentBytes);
+    }
+
+    //
+    //  The value of the utility function determines caching policy:
+    //
+    //  * we try to cache frames with high utility
+    //  * we try to free frames with low utility
+    //  * we never cache frames with utility == 0.0
+    //
+    //  A valid utility function has these properties:
+    //
+    //  * produces values in the range: [0.0, utilityMax]
+    //  * for a given set of cached frames, the utility functions
+    //    extrema must occur on one of these frames: max/min, in/out,
+    //    displayFrame, a frame the lies on the edge of a region of
+    //    cached frames.
+    //
+
+    inline float FBCache::utility(int frame, UtilityMode mode)
+    {
+        if (m_graph->cachingMode() == IPGraph::GreedyCache)
+        {
+            //
+            //  Region Cache
+            //
+            float d;
+
+            if (m_inFrame > frame)
+            {
+                d = (m_cacheOutsideRegion) ? 1.0 / (1.0 + m_inFrame - frame) : 0.0;
+            }
+            else if (m_outFrame <= frame)
+            {
+                d = (m_cacheOutsideRegion) ? 1.0 / (2.0 + frame - m_outFrame) : 0.0;
+            }
+            else if (frame == m_inFrame)
+            {
+                d = utilityMax;
+            }
+            else
+            {
+                d = 1.0 + costFactor(frame, mode) / abs(frame - m_inFrame);
+            }
+
+            if (d > 0.0)
+                d = max(d, prefetchUtility(frame, mode));
+
+            DBL(DB_UTIL, "utility(" << frame << ") = " << d << ", dsp " << m_displayFrame << " cacheOutside " << m_cacheOutsideRegion);
+            return d;
+        }
+
+        //
+        //  Lookahead Cache
+        //
+
+        if (m_displayFrame == frame)
+            return utilityMax;
+
+        int lastFrame = m_outFrame - 1;
+        int firstFrame = m_inFrame;
+        bool forward = (frame > m_displayFrame);
+
+        const float fact = forwardWeight(mode);
+        //
+        //  we apply fact if frame is in direction of playback,
+        //  ffact incorporates that policy
+        //
+
+        float ffact = fact;
+        if ((m_displayInc < 0 && forward) || (m_displayInc > 0 && !forward))
+        {
+            ffact = 1.0 - fact;
+        }
+
+        float d;
+        if (frame < firstFrame)
+        {
+            d = (m_cacheOutsideRegion) ? 1.0 / (1.0 + firstFrame - frame) : 0.0;
+        }
+        else if (frame > lastFrame)
+        {
+            d = (m_cacheOutsideRegion) ? 1.0 / (1.0 + frame - lastFrame) : 0.0;
+        }
+        else
+        {
+            //
+            //  If we are in the in/out range, but the display frame is not, we
+            //  want to cache "relative" to the _next_ display frame if we
+            //  start playback, which will be the in point.
+            //
+
+            int testFrame = m_displayFrame;
+            if (m_displayFrame < firstFrame || m_displayFrame > lastFrame)
+                testFrame = firstFrame;
+
+            d = ffact * fabs(float(frame - testFrame));
+
+            //
+            //  Since frame is within the in/out range, test the "modulo"
+            //  distances that wrap round the front or back of the
+            //  range.  Add one, or a distance of zero is possible.
+            //
+            float dRoundFront = 1 + testFrame - firstFrame + lastFrame - frame;
+            float dRoundBack = 1 + lastFrame - testFrame + frame - firstFrame;
+
+            //
+            //  apply fact if this alternate path is "forward"
+            //
             if (m_displayInc < 0)
                 dRoundFront *= fact, dRoundBack *= (1.0 - fact);
             else
-                dRoundFront *= (1.0 - fact), dRoundBack *= fact;
+                dRoundFront *= (1.0 - fact), dRoundBack *= fact;
+
+            DBL(DB_UTIL, "d " << 1.0 / d << " drf " << 1.0 / dRoundFront << " drb " << 1.0 / dRoundBack << " ffact " << ffact << " inc "
+                              << m_displayInc << " fwd " << forward);
+
+            if (dRoundFront < d)
+                d = dRoundFront;
+            if (dRoundBack < d)
+                d = dRoundBack;
+
+            //
+            //  Rank by slack: take off the frames played while this one
+            //  is evaluated (weighted like the forward distance).
+            //
+
+            const float lead = deadlineLead(frame, mode);
+            if (lead > 0.0f)
+                d = max(d - fact * lead, min(d, fact));
+
+            d = 1.0 + costFactor(frame, mode) / d;
+            d = max(d, prefetchUtility(frame, mode));
+        }
+
+        DBL(DB_UTIL, "utility(" << frame << ") = " << d << ", dsp " << m_displayFrame << " cacheOutside " << m_cacheOutsideRegion);
+        return d;
+    }
+
+    float FBCache::costFactor(int frame, UtilityMode mode) const
+    {
+        if (!m_costAwareCaching)
+            return 1.0;
+        return mode == FOR_CACHING ? m_costModel->cachingFactor(frame) : m_costModel->freeingFactor(frame);
+    }
+
+    //
+    //  Frames of playback that go by while frame is evaluated. Only
+    //  frames ahead have a deadline and only while playing.
+    //
+
+    float FBCache::deadlineLead(int frame, UtilityMode mode) const
+    {
+        if (!m_costAwareCaching || mode != FOR_CACHING || m_displayInc == 0 || m_displayFPS <= 0)
+            return 0.0;
+
+        if ((m_displayInc > 0) != (frame > m_displayFrame))
+            return 0.0;
+
+        return m_costModel->frameSeconds(frame) * m_displayFPS * abs(m_displayInc);
+    }
+
+    //
+    //  Weight utility() gives the distance of frames in the direction
+    //  of play
+    //
+
+    float FBCache::forwardWeight(UtilityMode mode) const
+    {
+        return (mode == FOR_CACHING && !isActiveTailCachingEnabled()) ? 0.001f
+                                                                      : min(max(m_lookBehindFraction / 100.0f, 0.001f), 0.999f);
+    }
+
+    //
+    //  A predicted scrub frame is worth as much as the frame rank + 1
+    //  frames ahead in the direction of play, when caching and when
+    //  freeing.
+    //
+
+    float FBCache::prefetchUtility(int frame, UtilityMode mode) const
+    {
+        if (m_prefetchRanks.empty())
+            return 0.0;
+
+        map<int, int>::const_iterator i = m_prefetchRanks.find(frame);
+
+        if (i == m_prefetchRanks.end())
+            return 0.0;
+
+        return 1.0 + costFactor(frame, mode) / (forwardWeight(mode) * float(i->second + 1));
+    }
+
+    void FBCache::setPrefetchFrames(const vector<int>& frames)
+    {
+        if (!m_scrubPrefetch && m_prefetchRanks.empty())
+            return;
+
+        map<int, int> ranks;
+
+        if (m_scrubPrefetch)
+        {
+            for (size_t i = 0; i < frames.size(); i++)
+                ranks.insert(make_pair(frames[i], int(i)));
+        }
+
+        //
+        //  Forget prefetched frames that were freed before they were
+        //  shown.
+        //
+
+        for (set<int>::iterator i = m_prefetchedFrames.begin(); i != m_prefetchedFrames.end();)
+        {
+            if (isFrameCached(*i) || m_framesBeingCached.count(*i))
+                ++i;
+            else
+                m_prefetchedFrames.erase(i++);
+        }
+
+        if (ranks != m_prefetchRanks)
+        {
+            m_prefetchRanks.swap(ranks);
+            setUtilityStateChanged();
+        }
+    }
+
+    void FBCache::recordEvaluation(const string& source, int frame, double seconds, size_t bytes)
+    {
+        m_costModel->record(source, frame, seconds, bytes);
+        setCacheStatsDirty();
+    }
+
+    void FBCache::setSourceQuota(const string& source, size_t bytes)
+    {
+        SourceAccount& a = m_sourceAccounts[source];
+        a.quota = bytes;
+        a.leftOut.clear();
+        setCacheStatsDirty();
+    }
+
+    void FBCache::setSourceWeight(const string& source, float weight)
+    {
+        m_sourceAccounts[source].weight = max(weight, 0.001f);
+        setCacheStatsDirty();
+    }
+
+    void FBCache::attributeItem(const FrameBuffer* fb, const string& source)
+    {
+        if (source.empty() || m_itemSources.count(fb))
+            return;
+
+        m_itemSources[fb] = source;
+
+        //
+        //  Already held for some frame (added before we knew where it
+        //  came from), so count it now.
+        //
+
+        if (m_frameIndex->numFramesOfItem(fb) > 0)
+        {
+            FrameVector frames;
+            m_frameIndex->framesOfItem(fb, frames);
+
+            for (size_t i = 0; i < frames.size(); i++)
+                noteFrameItem(frames[i], fb, true);
+
+            noteItemReferenced(fb);
+        }
+    }
+
+    void FBCache::noteItemReferenced(const FrameBuffer* fb)
+    {
+        map<const FrameBuffer*, string>::const_iterator i = m_itemSources.find(fb);
+
+        if (i != m_itemSources.end())
+            m_sourceAccounts[i->second].used += fb->totalImageSize();
+    }
+
+    void FBCache::noteItemUnreferenced(const FrameBuffer* fb)
+    {
+        map<const FrameBuffer*, string>::const_iterator i = m_itemSources.find(fb);
+
+        if (i != m_itemSources.end())
+        {
+            SourceAccount& a = m_sourceAccounts[i->second];
+            a.used -= min(a.used, fb->totalImageSize());
+
+            //
+            //  There may be room for what was left out now
+            //
+
+            a.leftOut.clear();
+        }
+    }
+
+    void FBCache::noteFrameItem(int frame, const FrameBuffer* fb, bool added)
+    {
+        map<const FrameBuffer*, string>::const_iterator i = m_itemSources.find(fb);
+
+        if (i == m_itemSources.end())
+            return;
+
+        SourceAccount& a = m_sourceAccounts[i->second];
+
+        if (added)
+        {
+            //
+            //  A frame new to the source goes into the order now if the
+            //  order is current, otherwise the next rebuild picks it up
+            //
+
+            if (a.frames[frame]++ == 0 && a.orderEpoch == m_utilityEpoch)
+                a.orderOf[frame] = a.order.insert(make_pair(utility(frame, FOR_FREEING), frame));
+        }
+        else
+        {
+            map<int, int>::iterator f = a.frames.find(frame);
+
+            if (f == a.frames.end() || --f->second > 0)
+                return;
+
+            a.frames.erase(f);
+
+            map<int, FrameOrder::iterator>::iterator o = a.orderOf.find(frame);
+
+            if (o != a.orderOf.end())
+            {
+                a.order.erase(o->second);
+                a.orderOf.erase(o);
+            }
+        }
+    }
+
+    void FBCache::updateFrameOrder(SourceAccount& a)
+    {
+        if (a.orderEpoch == m_utilityEpoch)
+            return;
+
+        a.order.clear();
+        a.orderOf.clear();
+
+        for (map<int, int>::const_iterator i = a.frames.begin(); i != a.frames.end(); ++i)
+            a.orderOf[i->first] = a.order.insert(make_pair(utility(i->first, FOR_FREEING), i->first));
+
+        a.orderEpoch = m_utilityEpoch;
+    }
+
+    bool FBCache::leftOutForQuota(int frame) const
+    {
+        for (SourceAccountMap::const_iterator i = m_sourceAccounts.begin(); i != m_sourceAccounts.end(); ++i)
+        {
+            if (i->second.leftOut.count(frame))
+                return true;
+        }
+
+        return false;
+    }
+
+    size_t FBCache::sourceFairShare(const string& source) const
+    {
+        SourceAccountMap::const_iterator si = m_sourceAccounts.find(source);
+        const float weight = si != m_sourceAccounts.end() ? si->second.weight : 1.0f;
+        float totalWeight = 0.0;
+
+        //
+        //  Only the sources that hold something (or are about to) split
+        //  the capacity.
+        //
+
+        for (SourceAccountMap::const_iterator i = m_sourceAccounts.begin(); i != m_sourceAccounts.end(); ++i)
+        {
+            if (i->second.used > 0 || i->first == source)
+                totalWeight += i->second.weight;
+        }
+
+        if (si == m_sourceAccounts.end())
+            totalWeight += weight;
+
+        size_t share = size_t(double(m_maxBytes) * weight / totalWeight);
+
+        if (si != m_sourceAccounts.end() && si->second.quota && si->second.quota < share)
+            share = si->second.quota;
+
+        return share;
+    }
+
+    float FBCache::sourcePressure(const string& source) const
+    {
+        SourceAccountMap::const_iterator i = m_sourceAccounts.find(source);
+
+        if (i == m_sourceAccounts.end() || i->second.used == 0)
+            return 0.0;
+
+        const size_t share = sourceFairShare(source);
+        return share ? float(double(i->second.used) / double(share)) : 4.0f;
+    }
+
+    float FBCache::framePressure(int frame) const
+    {
+        //
+        //  How far over its share is the greediest source of the frame,
+        //  clamped so that distance from the display frame still
+        //  matters.
+        //
+
+        if (m_sourceAccounts.size() < 2)
+            return 1.0;
+
+        FBVector fbs;
+        m_frameIndex->items(frame, fbs);
+
+        float pressure = 1.0;
+
+        for (size_t i = 0; i < fbs.size(); i++)
+        {
+            map<const FrameBuffer*, string>::const_iterator si = m_itemSources.find(fbs[i]);
+
+            if (si != m_itemSources.end())
+                pressure = max(pressure, sourcePressure(si->second));
+        }
+
+        return min(pressure, 4.0f);
+    }
+
+    size_t FBCache::freeSourceItems(const string& source, size_t bytes, int excludeFrame, float maxUtility)
+    {
+        //
+        //  Dereference the items of source from the frames of least
+        //  utility (lower than maxUtility) until bytes worth of its
+        //  items are no longer held by any frame. The other items of
+        //  those frames stay, so the frames become partially cached.
+        //
+
+        SourceAccountMap::iterator ai = m_sourceAccounts.find(source);
+
+        if (ai == m_sourceAccounts.end())
+            return 0;
+
+        SourceAccount& account = ai->second;
+        updateFrameOrder(account);
+
+        //
+        //  Dereferencing takes frames out of the order, so pick them
+        //  first. Utilities are as of the last change of the display
+        //  frame, range or prefetch, the cost model may have moved a
+        //  little since.
+        //
+
+        FrameVector candidates;
+
+        for (FrameOrder::const_iterator i = account.order.begin(); i != account.order.end() && i->first < maxUtility; ++i)
+        {
+            const int f = i->second;
+
+            if (f != excludeFrame && f != m_displayFrame && !m_framesBeingCached.count(f))
+                candidates.push_back(f);
+        }
+
+        FBVector fbs;
+        size_t freed = 0;
+
+        for (size_t i = 0; i < candidates.size() && freed < bytes; i++)
+        {
+            const int f = candidates[i];
+
+            fbs.clear();
+            m_frameIndex->items(f, fbs);
+
+            for (size_t q = 0; q < fbs.size(); q++)
+            {
+                FrameBuffer* fb = fbs[q];
+                map<const FrameBuffer*, string>::const_iterator si = m_itemSources.find(fb);
+
+                if (si == m_itemSources.end() || si->second != source)
+                    continue;
+
+                dereferenceFrame(f, fb);
+
+                if (m_frameIndex->numFramesOfItem(fb) == 0)
+                    freed += fb->totalImageSize();
+            }
+        }
+
+        if (freed)
+            setCacheStatsDirty();
+
+        DBL(DB_FREE, "freeSourceItems " << source << " wanted " << bytes << " freed " << freed);
+
+        return freed;
+    }
+
+    void FBCache::freeOverShareSources(size_t bytes)
+    {
+        if (m_sourceAccounts.size() < 2)
+            return;
+
+        size_t freed = 0;
+
+        for (SourceAccountMap::const_iterator i = m_sourceAccounts.begin(); i != m_sourceAccounts.end() && freed < bytes; ++i)
+        {
+            const size_t share = sourceFairShare(i->first);
+
+            if (i->second.used <= share)
+                continue;
+
+            //
+            //  The further over its share, the more useful the frames a
+            //  source has to give up.
+            //
+
+            const float pressure = min(sourcePressure(i->first), 4.0f);
+            const size_t want = min(i->second.used - share, bytes - freed);
+
+            freed += freeSourceItems(i->first, want, NAF, m_targetCacheFrameUtility * pressure);
+        }
+    }
+
+    bool FBCache::reserveForSource(const string& source, size_t bytes, int frame)
+    {
+        SourceAccountMap::iterator i = m_sourceAccounts.find(source);
+
+        if (i == m_sourceAccounts.end() || i->second.quota == 0 || i->second.used + bytes <= i->second.quota)
+        {
+            return true;
+        }
+
+        const size_t over = i->second.used + bytes - i->second.quota;
+
+        if (freeSourceItems(source, over, frame, utility(frame, FOR_CACHING)) >= over)
+            return true;
+
+        //
+        //  Never leave out what's on screen
+        //
+
+        if (frame == m_displayFrame)
+            return true;
+
+        //
+        //  The frame won't be any more complete next time, so don't
+        //  pick it as a cache target again until the quota changes or
+        //  the source lets go of something.
+        //
+
+        i->second.leftOut.insert(frame);
+        return false;
+    }
+
+    FBCache::CacheFrame FBCache::findBestCacheTarget()
+    {
+        int targetCacheFrame = NAF;
+        float targetCacheFrameUtility = utilityMin;
+
+        CacheEdges::EdgeVector edges;
+        m_cacheEdges->possibleCacheTargets(edges);
+        CacheFrame result;
+
+        //
+        //  First find caching target frame.
+        //
+        for (CacheEdges::EdgeVector::iterator i = edges.begin(); i != edges.end(); ++i)
+        {
+            int f = i->frame, f2 = NAF;
+            CacheEdges::EdgeType type = i->type;
+
+            DBL(DB_EDGES, " f " << f << " type " << m_cacheEdges->typeToText(type));
+
+            //
+            //  Skip (in the right direction) past any frame we're
+            //  already attempting to cache, or that is scheduled
+            //  for freeing.
+            //
+            if (CacheEdges::LeftOnly == type)
+            {
+                while (isFrameCached(f) || m_framesBeingCached.count(f) || m_framesScheduledForFreeing.count(f) || f == m_displayFrame
+                       || leftOutForQuota(f))
+                    --f;
+            }
+            else if (CacheEdges::RightOnly == type)
+            {
+                while (isFrameCached(f) || m_framesBeingCached.count(f) || m_framesScheduledForFreeing.count(f) || f == m_displayFrame
+                       || leftOutForQuota(f))
+                    ++f;
+            }
+            else if (CacheEdges::BothSides == type)
+            {
+                f2 = f;
+                while (isFrameCached(f) || m_framesBeingCached.count(f) || m_framesScheduledForFreeing.count(f) || f == m_displayFrame
+                       || leftOutForQuota(f))
+                    --f;
+                while (isFrameCached(f2) || m_framesBeingCached.count(f2) || m_framesScheduledForFreeing.count(f2) || f2 == m_displayFrame
+                       || leftOutForQuota(f2))
+                    ++f2;
+            }
+            else
+                continue; /* unexpected type !*/
+
+            DBL(DB_EDGES, " f " << f << " f2 " << f2);
+            if (f >= m_minFrame && f < m_maxFrame && !isFrameCached(f))
+            {
+                float u = utility(f, FOR_CACHING);
+                DBL(DB_EDGES, "consider frame for caching: frame " << f << " utility " << u << " target " << targetCacheFrame << " utility "
+                                                                   << targetCacheFrameUtility);
+                if (u > targetCacheFrameUtility)
+                {
+                    targetCacheFrame = f;
+                    targetCacheFrameUtility = u;
+                    result.inc = (type == CacheEdges::RightOnly) ? 1 : -1;
+                }
+            }
+            if (NAF != f2 && f2 >= m_minFrame && f2 < m_maxFrame && !isFrameCached(f2))
+            {
+                float u = utility(f2, FOR_CACHING);
+                DBL(DB_EDGES, "consider frame for caching: frame " << f << " utility " << u << " target " << targetCacheFrame << " utility "
+                                                                   << targetCacheFrameUtility);
+                if (u > targetCacheFrameUtility)
+                {
+                    targetCacheFrame = f2;
+                    targetCacheFrameUtility = u;
+                    result.inc = 1;
+                }
+            }
+        }
+
+        //
+        //  Predicted scrub frames aren't necessarily next to anything
+        //  cached. They're cached one at a time (inc 0) so a sparse
+        //  prediction doesn't fill in the frames between.
+        //
+
+        for (map<int, int>::const_iterator i = m_prefetchRanks.begin(); i != m_prefetchRanks.end(); ++i)
+        {
+            int f = i->first;
+
+            if (f < m_minFrame || f >= m_maxFrame || f == m_displayFrame || isFrameCached(f) || m_framesBeingCached.count(f)
+                || m_framesScheduledForFreeing.count(f) || leftOutForQuota(f))
+            {
+                continue;
+            }
+
+            float u = utility(f, FOR_CACHING);
+
+            if (u > targetCacheFrameUtility)
+            {
+                targetCacheFrame = f;
+                targetCacheFrameUtility = u;
+                result.inc = 0;
+            }
+        }
+
+        result.frame = targetCacheFrame;
+        result.utility = targetCacheFrameUtility;
+
+        return result;
+    }
+
+    FBCache::CacheFrame FBCache::findBestFreeTarget(const CacheFrame& cacheTarget)
+    {
+        //
+        //  Then find freeing target frame.
+        //
+        int targetFreeFrame = NAF;
+        float targetFreeFrameUtility = utilityMax;
+        float targetCacheFrameUtility = cacheTarget.utility;
+
+        CacheFrame result;
+
+        CacheEdges::EdgeVector edges;
+        m_cacheEdges->possibleFreeTargets(edges);
+
+        for (CacheEdges::EdgeVector::iterator i = edges.begin(); i != edges.end(); ++i)
+        {
+            int f = i->frame;
+            CacheEdges::EdgeType type = i->type;
+
+            //
+            //  Skip (in the right direction) past any frame we've
+            //  already scheduled for freeing.  Note we go in the
+            //  opposite direction because the direction describes
+            //  where free frames lie and we're looking for cached
+            //  frames.
+            //
+            if (CacheEdges::LeftOnly == type)
+            {
+                while (m_framesScheduledForFreeing.count(f))
+                    ++f;
+            }
+            else if (CacheEdges::RightOnly == type)
+            {
+                while (m_framesScheduledForFreeing.count(f))
+                    --f;
+            }
+            else if (CacheEdges::BothSides == type)
+            {
+                //  There are free frames on both sides of this one,
+                //  so we only need to test this one.
+
+                if (m_framesScheduledForFreeing.count(f))
+                    continue;
+            }
+            else
+                continue; /* unexpected type !*/
+
+            considerFrameForFreeing(f, targetFreeFrame, targetFreeFrameUtility);
+        }
+
+        result.frame = targetFreeFrame;
+        result.utility = targetFreeFrameUtility;
+
+        return result;
+    }
+
+    void FBCache::initCacheFreePair(int cacheFrame, int freeFrame)
+    {
+        if (NAF != cacheFrame)
+        {
+            m_framesBeingCached[cacheFrame] = freeFrame;
+            if (NAF != freeFrame)
+            {
+                m_framesScheduledForFreeing.insert(freeFrame);
+            }
+
+            DB(endl
+               << "************** initiateCachingOfFrame cacheTarget " << cacheFrame << " freeTarget " << freeFrame << " over "
+               << overflowing());
+            DB("    freeingList size " << m_framesScheduledForFreeing.size() << " cachingList size " << m_framesBeingCached.size());
+            //  DB ("    target cached " << isFrameCached(targetCacheFrame));
+        }
+    }
+
+    void FBCache::initiateCachingOfBestFrameGroup(FrameVector& frames, int maxGroupSize)
+    {
+        frames.clear();
+
+        CacheFrame cacheTarget = findBestCacheTarget();
+
+        if (0.0 == cacheTarget.utility || cacheTarget.frame == NAF)
+            return;
+
+        CacheFrame freeTarget = findBestFreeTarget(cacheTarget);
+
+        if (overflowing())
+        {
+            if (isActiveTailCachingEnabled())
+            {
+                if (freeTarget.utility >= cacheTarget.utility)
+                    return;
+            }
+            else
+            {
+                if (freeTarget.utility >= (utility(cacheTarget.frame, FOR_FREEING) - 0.001))
+                    return;
+            }
+        }
+
+        //
+        //  We have at least one frame to cache, see if we have more ...
+        //
+
+        int cacheFrameCount = 1;
+        initCacheFreePair(cacheTarget.frame, freeTarget.frame);
+
+        if (0 == cacheTarget.inc)
+        {
+            if (m_prefetchedFrames.insert(cacheTarget.frame).second)
+            {
+                m_prefetchRequested++;
+                setCacheStatsDirty();
+            }
+
+            maxGroupSize = 1;
+        }
+
+        for (int testFrame = cacheTarget.frame + cacheTarget.inc; cacheFrameCount < maxGroupSize;
+             testFrame += cacheTarget.inc, ++cacheFrameCount)
+        {
+            if (m_framesBeingCached.count(testFrame) || m_framesScheduledForFreeing.count(testFrame) || testFrame == m_displayFrame
+                || isFrameCached(testFrame))
+            {
+                break;
+            }
+
+            //
+            //  testFrame is cachable, now see if we can find corresponding free
+            //  target.
+            //
+
+            CacheFrame testCF(testFrame, utility(testFrame, FOR_CACHING));
+
+            if (testCF.utility == 0.0)
+                break;
+
+            CacheFrame freeCF = findBestFreeTarget(testCF);
+
+            if (overflowing())
+            {
+                if (isActiveTailCachingEnabled())
+                {
+                    if (freeCF.utility >= testCF.utility)
+                        break;
+                }
+                else
+                {
+                    if (freeCF.utility >= (utility(testFrame, FOR_FREEING) - 0.001))
+                        break;
+                }
+            }
+
+            initCacheFreePair(testCF.frame, freeCF.frame);
+        }
+        //  if (cacheFrameCount > 1) cerr << "cacheFrameCount " <<
+        //  cacheFrameCount << endl;
+
+        //
+        //  Now fill return vector of frame numbers to cache, always in
+        //  decreasing order.
+        //
+
+        for (int f = (cacheTarget.inc > 0) ? cacheTarget.frame + cacheFrameCount - 1 : cacheTarget.frame, lim = f - cacheFrameCount;
+             f > lim; --f)
+        {
+            frames.push_back(f);
+        }
+
+        return;
+    }
+
+    void FBCache::completeCachingOfFrame(int frame)
+    {
+        DB("----- completeCachingOfFrame " << frame);
+        std::unordered_map<int, int>::iterator i = m_framesBeingCached.find(frame);
+        if (i != m_framesBeingCached.end())
+        {
+            DB("-----     found in beingCached map");
+            if (NAF != i->second)
+            {
+                DB("removing " << i->second << " from scheduledForFreeing list");
+                m_framesScheduledForFreeing.erase(i->second);
+            }
+            m_framesBeingCached.erase(i);
+        }
+    }
+
+    void FBCache::considerFrameForFreeing(int f, int& targetFrame, float& targetUtility)
+    {
+        DBL(DB_EDGES, "considerFrameForFreeing: frame " << f << " target " << targetFrame << " utility " << targetUtility);
+        if (f < m_minFrame || f >= m_maxFrame || m_framesBeingCached.count(f) || f == m_displayFrame)
+        {
+            return;
+        }
+
+        if (isFrameCached(f))
+        //
+        //  Consider this frame for freeing
+        //
+        {
+            float u = utility(f, FOR_FREEING);
+
+            if (m_fairShareCaching)
+                u /= framePressure(f);
+
+            if (u < targetUtility)
+            {
+                targetFrame = f;
+                targetUtility = u;
+                DBL(DB_EDGES, "considerFrameForFreeing: targeting new frame " << f << " utility " << u);
+            }
+        }
+    }
+
+    //
+    //  free() really tries to ensure that the amount of space requested
+    //  is available in the cache.  so it may free nothing if that space
+    //  is already available, or it may free more than requested if the
+    //  cache is over-full.
+    //
+    bool FBCache::free(size_t inbytes) { return freeInternal(inbytes, true); }
+
+    bool FBCache::freeInternal(size_t inbytes, bool freeMemory)
+    {
+        DBL(DB_FREE, "free() " << inbytes << " current " << m_currentBytes << " max " << m_maxBytes << " "
+                               << double(m_currentBytes) / double(m_maxBytes));
+        if (m_maxBytes > m_currentBytes && m_maxBytes - m_currentBytes >= inbytes)
+        {
+            return true;
+        }
+
+        size_t targetBytes = (m_maxBytes > inbytes) ? m_maxBytes - inbytes : 0;
+        if (freeMemory)
+        {
+            TwkFB::Cache::freeTrash(m_currentBytes - targetBytes);
+        }
+
+        //
+        //  Compressing items far from the display frame is cheaper than
+        //  throwing frames away but it's not done here, under the lock:
+        //  the caching threads call compressAhead() before adding.
+        //
+
+        //
+        //  Then take from the sources holding more than their share
+        //  before freeing whole frames.
+        //
+
+        if (freeMemory && m_fairShareCaching && (m_maxBytes < m_currentBytes || m_maxBytes - m_currentBytes < inbytes))
+        {
+            freeOverShareSources(m_currentBytes + inbytes - m_maxBytes);
+
+            if (m_currentBytes > targetBytes)
+                TwkFB::Cache::freeTrash(m_currentBytes - targetBytes);
+        }
+
+        size_t incoming = m_currentBytes;
+
+        std::set<int> alreadyTried;
+        bool enough = true;
+
+        CacheEdges::EdgeVector edges;
+
+        while (m_maxBytes < m_currentBytes || m_maxBytes - m_currentBytes < inbytes)
+        {
+            m_cacheEdges->possibleFreeTargets(edges);
+            int targetFreeFrame = NAF;
+            float targetFreeFrameUtility = m_targetCacheFrameUtility;
+
+            for (CacheEdges::EdgeVector::iterator i = edges.begin(); i != edges.end(); ++i)
+            {
+                int f = i->frame;
+                CacheEdges::EdgeType type = i->type;
+
+                //
+                //  Skip (in the right direction) past any frame we've
+                //  already attempted to free.  Note we go in the
+                //  opposite direction because the directions describes
+                //  where free frames lie and we're looking for cached
+                //  frames.
+                //
+                if (CacheEdges::LeftOnly == type)
+                {
+                    while (alreadyTried.count(f) || m_framesBeingCached.count(f))
+                    {
+                        ++f;
+                    }
+                }
+                else if (CacheEdges::RightOnly == type)
+                {
+                    while (alreadyTried.count(f) || m_framesBeingCached.count(f))
+                    {
+                        --f;
+                    }
+                }
+                else if (CacheEdges::BothSides == type)
+                {
+                    //  There are free frames on both sides of this one,
+                    //  so we only need to test this one.
+
+                    if (alreadyTried.count(f))
+                        continue;
+                }
+                else
+                    continue; /* unexpected type !*/
+
+                considerFrameForFreeing(f, targetFreeFrame, targetFreeFrameUtility);
+            }
+            DBL(DB_FREE,
+                "free targetFreeFrame " << targetFreeFrame << " utility " << targetFreeFrameUtility << " < " << m_targetCacheFrameUtility);
+
+            if (NAF == targetFreeFrame)
+            //
+            //  There's no frame we can legitimately free (that has a
+            //  utility less than the m_targetCacheFrameUtility).
+            //
+            {
+                enough = false;
+                break;
+            }
+            alreadyTried.insert(targetFreeFrame);
+            //
+            //  Free the ids that were cached for this frame, this may
+            //  free nothing of other frames are using these ids.
+            //
+            freeFrame(targetFreeFrame);
+
+            DBL(DB_FREE, "free m_currentBytes " << m_currentBytes << " targetBytes " << targetBytes);
+            //
+            //  At best freeFrame just flushes ids from the frame-level
+            //  data structures, adding them to the Cache-level
+            //  TrashCan, so call freeTrash to "really" free something.
+            //
+            if (freeMemory && m_currentBytes > targetBytes)
+            {
+                TwkFB::Cache::freeTrash(m_currentBytes - targetBytes);
+            }
+        }
+
+        checkMetadata();
+
+        if (Cache::debug())
+            showCacheContents();
+
+        setCacheStatsDirty();
+
+        for (std::set<int>::iterator i = alreadyTried.begin(); i != alreadyTried.end(); ++i)
+        {
+            DB("    frame " << *i << " still cached: " << isFrameCached(*i));
+            m_cacheEdges->removeCacheEdge(*i);
+        }
+
+        bool ok = (m_maxBytes - m_currentBytes >= inbytes);
+
+        DBL(DB_FREE, "free() complete" << " current " << m_currentBytes << " max " << m_maxBytes << ", "
+                                       << double(m_currentBytes) / double(m_maxBytes) << ", ok " << ok);
+
+        return ok;
+    }
+
+    void FBCache::emergencyFree()
+    {
+        DBL(DB_FREE, "******************* emergencyFree " << " current " << m_currentBytes << " max " << m_maxBytes << " "
+                                                          << double(m_currentBytes) / double(m_maxBytes) << " trash count "
+                                                          << trashCount());
+
+        if (m_maxBytes < m_currentBytes)
+        {
+            //  Set the utility bar as high as possible (any edge frame with
+            //  utility less than utilityMax will be considered for
+            //  freeing).
+            //
+            m_targetCacheFrameUtility = utilityMax;
+            free(0);
+            DBL(DB_FREE, "******************* emergencyFree " << " current " << m_currentBytes << " max " << m_maxBytes << " "
+                                                              << double(m_currentBytes) / double(m_maxBytes) << " trash count "
+                                                              << trashCount());
+        }
+        setCacheStatsDirty();
+    }
+
+    bool FBCache::cacheStats(CacheStats& c) const
+    {
+        // if (m_cacheStatsDisabled) cerr << "ERROR: cache stats requested, but
+        // have been disabled" << endl;
+
+        LockObject sl(m_statMutex, true);
+
+        if (sl.locked())
+        {
+            c = m_cacheStats;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    void FBCache::setCacheStatsDirty()
+    {
+        if (m_cacheStatsDisabled)
+            return;
+
+        LockObject sl(m_statMutex, true);
+
+        if (sl.locked())
+            m_cacheStatsDirty = true;
+
+        //
+        //  If we failed to lock, something else is setting the dirty flag _or_
+        //  the stats are being updated.  There's a chance here that the flag
+        //  could get out of sync (IE be set to true even though we just called
+        //  setCacheStatsDirty, we just don't care enough that the stats be
+        //  accurate.  We'd rather eliminate the possibility of a perf hit due
+        //  to lock contention.
+        //
+    }
+
+    void FBCache::updateCacheStatsIfDirty()
+    {
+        if (m_cacheStatsDisabled)
+            return;
+
+        LockObject sl(m_statMutex);
+
+        if (!m_cacheStatsDirty)
+            return;
+
+        //
+        //  This returns immediately
+        //
+
+        m_cacheStats.capacity = capacity();
+        m_cacheStats.used = used();
+
+        //
+        //  This requires some work
+        //
+
+        lock();
+        try
+        {
+            computeCachedRangesStat(m_cacheStats.cachedRanges);
+            m_cacheStats.lookAheadSeconds = computeLookAheadSecondsStat(m_cacheStats.cachedRanges);
+
+            if (m_diskCache)
+            {
+                m_cacheStats.diskCapacity = m_diskCache->capacity();
+                m_cacheStats.diskUsed = m_diskCache->used();
+                m_cacheStats.diskHits = m_diskCache->hits();
+                m_cacheStats.diskMisses = m_diskCache->misses();
+            }
+            else
+            {
+                m_cacheStats.diskCapacity = 0;
+                m_cacheStats.diskUsed = 0;
+                m_cacheStats.diskHits = 0;
+                m_cacheStats.diskMisses = 0;
+            }
 
-            DBL(DB_UTIL, "d " << 1.0 / d << " drf " << 1.0 / dRoundFront << " drb " << 1.0 / dRoundBack << " ffact " << ffact << " inc "
-                              << m_displayInc << " fwd " << forward);
+            m_cacheStats.compressedUsed = m_compressedBytes;
+            m_cacheStats.compressedRaw = m_compressedRawBytes;
+
+            m_costModel->stats(m_cacheStats.sourceCosts, m_cacheStats.meanFrameSeconds, m_cacheStats.meanFrameBytes);
+
+            m_cacheStats.prefetchRequested = m_prefetchRequested;
+            m_cacheStats.prefetchHits = m_prefetchHits;
+
+            m_cacheStats.sourceUsage.clear();
+
+            for (SourceAccountMap::const_iterator i = m_sourceAccounts.begin(); i != m_sourceAccounts.end(); ++i)
+            {
+                SourceUsage u;
+                u.source = i->first;
+                u.used = i->second.used;
+                u.quota = i->second.quota;
+                u.fairShare = sourceFairShare(i->first);
+                u.weight = i->second.weight;
+                m_cacheStats.sourceUsage.push_back(u);
+            }
 
-            if (dRoundFront < d)
-                d = dRoundFront;
-            if (dRoundBack < d)
-                d = dRoundBack;
-            d = 1.0 + 1.0 / d;
+            m_cacheStatsDirty = false;
+            unlock();
+        }
+        catch (...)
+        {
+            unlock();
         }
-
-        DBL(DB_UTIL, "utility(" << frame << ") = " << d << ", dsp " << m_displayFrame << " cacheOutside " << m_cacheOutsideRegion);
-        return d;
     }
 
-    FBCache::CacheFrame FBCache::findBestCacheTarget()
+    //------------------------------------------------------------------------------
+    //
+    void FBCache::computeCachedRangesStat(FrameRangeVector& array) const
     {
-        int targetCacheFrame = NAF;
-        float targetCacheFrameUtility = utilityMin;
+        array.clear();
 
-        CacheEdges::EdgeVector edges;
-        m_cacheEdges->possibleCacheTargets(edges);
-        CacheFrame result;
+        FrameVector frames;
+        m_frameIndex->sortedFrames(frames);
 
-        //
-        //  First find caching target frame.
-        //
-        for (CacheEdges::EdgeVector::iterator i = edges.begin(); i != edges.end(); ++i)
+        for (FrameVector::const_iterator i = frames.begin(); i != frames.end(); ++i)
         {
-            int f = i->frame, f2 = NAF;
-            CacheEdges::EdgeType type = i->type;
-
-            DBL(DB_EDGES, " f " << f << " type " << m_cacheEdges->typeToText(type));
+            int frame = *i;
 
-            //
-            //  Skip (in the right direction) past any frame we're
-            //  already attempting to cache, or that is scheduled
-            //  for freeing.
-            //
-            if (CacheEdges::LeftOnly == type)
-            {
-                while (isFrameCached(f) || m_framesBeingCached.count(f) || m_framesScheduledForFreeing.count(f) || f == m_displayFrame)
-                    --f;
-            }
-            else if (CacheEdges::RightOnly == type)
+            if (array.empty())
             {
-                while (isFrameCached(f) || m_framesBeingCached.count(f) || m_framesScheduledForFreeing.count(f) || f == m_displayFrame)
-                    ++f;
+                array.push_back(make_pair(frame, frame));
             }
-            else if (CacheEdges::BothSides == type)
+            else
             {
-                f2 = f;
-                while (isFrameCached(f) || m_framesBeingCached.count(f) || m_framesScheduledForFreeing.count(f) || f == m_displayFrame)
-                    --f;
-                while (isFrameCached(f2) || m_framesBeingCached.count(f2) || m_framesScheduledForFreeing.count(f2) || f2 == m_displayFrame)
-                    ++f2;
+                FrameRange& range = array.back();
+
+                if (range.second == frame - 1)
+                {
+                    range.second = frame;
+                }
+                else
+                {
+                    array.push_back(make_pair(frame, frame));
+                }
             }
-            else
-                continue; /* unexpected type !*/
+        }
+    }
 
-            DBL(DB_EDGES, " f " << f << " f2 " << f2);
-            if (f >= m_minFrame && f < m_maxFrame && !isFrameCached(f))
+    //------------------------------------------------------------------------------
+    //
+    float FBCache::computeLookAheadSecondsStat(const FrameRangeVector& vecFrameRange) const
+    {
+        if (m_displayFrame == NAF || m_inFrame == NAF || m_outFrame == NAF || m_displayInc == 0 || vecFrameRange.empty())
+        {
+            return 0.0f;
+        }
+
+        // Determine the look ahead time in seconds from the display frame
+        if (m_displayInc > 0)
+        {
+            // Positive increment
+            for (FrameRangeVector::const_iterator i = vecFrameRange.begin(); i != vecFrameRange.end(); ++i)
             {
-                float u = utility(f, FOR_CACHING);
-                DBL(DB_EDGES, "consider frame for caching: frame " << f << " utility " << u << " target " << targetCacheFrame << " utility "
-                                                                   << targetCacheFrameUtility);
-                if (u > targetCacheFrameUtility)
+                // Locate the range where the display frame is located if any
+                if (m_displayFrame >= i->first && m_displayFrame <= i->second)
                 {
-                    targetCacheFrame = f;
-                    targetCacheFrameUtility = u;
-                    result.inc = (type == CacheEdges::RightOnly) ? 1 : -1;
+                    // Locate the last matching range wrt m_displayInc
+                    FrameRangeVector::const_iterator endFrameRangeIter = i;
+                    while (i != vecFrameRange.end() && (i->first <= (endFrameRangeIter->second + m_displayInc)))
+                    {
+                        endFrameRangeIter = i;
+                        i++;
+                    };
+
+                    return (endFrameRangeIter->second - m_displayFrame) / m_displayFPS;
                 }
             }
-            if (NAF != f2 && f2 >= m_minFrame && f2 < m_maxFrame && !isFrameCached(f2))
+        }
+        else
+        {
+            // Negative increment
+            for (FrameRangeVector::const_reverse_iterator i = vecFrameRange.rbegin(); i != vecFrameRange.rend(); ++i)
             {
-                float u = utility(f2, FOR_CACHING);
-                DBL(DB_EDGES, "consider frame for caching: frame " << f << " utility " << u << " target " << targetCacheFrame << " utility "
-                                                                   << targetCacheFrameUtility);
-                if (u > targetCacheFrameUtility)
+                // Locate the range where the display frame is located if any
+                if (m_displayFrame >= i->first && m_displayFrame <= i->second)
                 {
-                    targetCacheFrame = f2;
-                    targetCacheFrameUtility = u;
-                    result.inc = 1;
+                    // Locate the last matching range wrt m_displayInc
+                    FrameRangeVector::const_reverse_iterator endFrameRangeIter = i;
+                    while (i != vecFrameRange.rend() && (i->second <= (endFrameRangeIter->first + m_displayInc)))
+                    {
+                        endFrameRangeIter = i;
+                        i++;
+                    };
+
+                    return (m_displayFrame - endFrameRangeIter->first) / m_displayFPS;
                 }
             }
         }
 
-        result.frame = targetCacheFrame;
-        result.utility = targetCacheFrameUtility;
-
-        return result;
+        return 0.0f;
     }
 
-    FBCache::CacheFrame FBCache::findBestFreeTarget(const CacheFrame& cacheTarget)
+    struct CheckInEach
     {
-        //
-        //  Then find freeing target frame.
-        //
-        int targetFreeFrame = NAF;
-        float targetFreeFrameUtility = utilityMax;
-        float targetCacheFrameUtility = cacheTarget.utility;
-
-        CacheFrame result;
+        CheckInEach(FBCache& c)
+            : cache(c)
+        {
+        }
 
-        CacheEdges::EdgeVector edges;
-        m_cacheEdges->possibleFreeTargets(edges);
+        FBCache& cache;
 
-        for (CacheEdges::EdgeVector::iterator i = edges.begin(); i != edges.end(); ++i)
+        void operator()(IPImage* l)
         {
-            int f = i->frame;
-            CacheEdges::EdgeType type = i->type;
-
-            //
-            //  Skip (in the right direction) past any frame we've
-            //  already scheduled for freeing.  Note we go in the
-            //  opposite direction because the direction describes
-            //  where free frames lie and we're looking for cached
-            //  frames.
-            //
-            if (CacheEdges::LeftOnly == type)
-            {
-                while (m_framesScheduledForFreeing.count(f))
-                    ++f;
-            }
-            else if (CacheEdges::RightOnly == type)
+            DB("checkInAndDelete() fb " << l->fb << " in cache " << ((l->fb) ? l->fb->inCache() : 0));
+            if (l->fb && l->cachePinned)
             {
-                while (m_framesScheduledForFreeing.count(f))
-                    --f;
+                l->fb->cacheUnpin();
+                l->cachePinned = false;
+                l->fb = 0;
             }
-            else if (CacheEdges::BothSides == type)
+            else if (l->fb && l->fb->inCache())
             {
-                //  There are free frames on both sides of this one,
-                //  so we only need to test this one.
-
-                if (m_framesScheduledForFreeing.count(f))
-                    continue;
+                DB("checkInAndDelete() fb " << l->fb << " ref count " << cache.fbReferenceCount(l->fb) << " frames in itemMap "
+                                            << cache.framesInItemMap(l->fb));
+                cache.Cache::checkIn(l->fb);
+                l->fb = 0;
             }
-            else
-                continue; /* unexpected type !*/
-
-            considerFrameForFreeing(f, targetFreeFrame, targetFreeFrameUtility);
         }
+    };
 
-        result.frame = targetFreeFrame;
-        result.utility = targetFreeFrameUtility;
-
-        return result;
+    void FBCache::checkInAndDelete(IPImage* img)
+    {
+        if (img)
+        {
+            CheckInEach checkInEach(*this);
+            foreach_ip(img, checkInEach);
+            delete img;
+        }
     }
 
-    void FBCache::initCacheFreePair(int cacheFrame, int freeFrame)
+    void FBCache::checkInAndDelete(const IPImageVector& images)
     {
-        if (NAF != cacheFrame)
-        {
-            m_framesBeingCached[cacheFrame] = freeFrame;
-            if (NAF != freeFrame)
-            {
-                m_framesScheduledForFreeing.insert(freeFrame);
-            }
+        for (size_t i = 0; i < images.size(); i++)
+            checkInAndDelete(images[i]);
+    }
 
-            DB(endl
-               << "************** initiateCachingOfFrame cacheTarget " << cacheFrame << " freeTarget " << freeFrame << " over "
-               << overflowing());
-            DB("    freeingList size " << m_framesScheduledForFreeing.size() << " cachingList size " << m_framesBeingCached.size());
-            //  DB ("    target cached " << isFrameCached(targetCacheFrame));
-        }
+    /*
+
+    I think this is wrong.  can't just clear thes caches without
+    dereferencing fbs, etc.
+
+    void
+    FBCache::clearFrameInfo()
+    {
+        lock();
+        m_framesScheduledForFreeing.clear();
+        m_framesBeingCached.clear();
+        m_frameIndex->clear();
+        m_cacheEdges->clear();
+        unlock();
     }
+    */
 
-    void FBCache::initiateCachingOfBestFrameGroup(FrameVector& frames, int maxGroupSize)
+    bool FBCache::frameItems(int frame, FBVector& items) const { return m_frameIndex->items(frame, items); }
+
+    bool FBCache::pinFrameItems(int frame, FBVector& items) const { return m_frameIndex->pinItems(frame, items); }
+
+    void FBCache::unpinItems(const FBVector& items)
     {
-        frames.clear();
+        for (size_t i = 0; i < items.size(); i++)
+            items[i]->cacheUnpin();
+    }
 
-        CacheFrame cacheTarget = findBestCacheTarget();
+    //
+    //  Update frame-level caching.  Note that we only reference a FB once, no
+    //  matter how many times it's used by this frame.
+    //
 
-        if (0.0 == cacheTarget.utility || cacheTarget.frame == NAF)
-            return;
+    //
+    //  Collect cached FBs from IPImage
+    //
+    struct IDSetCollector
+    {
+        IDSetCollector(FBCache::IDSet& s)
+            : ids(s)
+        {
+        }
 
-        CacheFrame freeTarget = findBestFreeTarget(cacheTarget);
+        FBCache::IDSet& ids;
 
-        if (overflowing())
+        void operator()(IPImage* img)
         {
-            if (isActiveTailCachingEnabled())
-            {
-                if (freeTarget.utility >= cacheTarget.utility)
-                    return;
-            }
-            else
+            if (img->fb && img->fb->inCache())
             {
-                if (freeTarget.utility >= (utility(cacheTarget.frame, FOR_FREEING) - 0.001))
-                    return;
+                ids.insert(img->fb->identifier());
             }
         }
+    };
 
+    void FBCache::trimFBsOfFrame(int frame, IPImage* img)
+    {
+        DB("trimFBsOfFrame " << frame);
         //
-        //  We have at least one frame to cache, see if we have more ...
+        //  Build set of IDs of FBs used by this frame (according to incoming
+        //  image).
         //
 
-        int cacheFrameCount = 1;
-        initCacheFreePair(cacheTarget.frame, freeTarget.frame);
-
-        for (int testFrame = cacheTarget.frame + cacheTarget.inc; cacheFrameCount < maxGroupSize;
-             testFrame += cacheTarget.inc, ++cacheFrameCount)
-        {
-            if (m_framesBeingCached.count(testFrame) || m_framesScheduledForFreeing.count(testFrame) || testFrame == m_displayFrame
-                || isFrameCached(testFrame))
-            {
-                break;
-            }
-
-            //
-            //  testFrame is cachable, now see if we can find corresponding free
-            //  target.
-            //
+        IDSet imgIDs;
+        IDSetCollector collector(imgIDs);
+        foreach_ip(img, collector);
 
-            CacheFrame testCF(testFrame, utility(testFrame, FOR_CACHING));
+        //
+        //  For each FB the cache thinks this frame uses, if it's not in the
+        //  incoming list, remove it from frame-level caching for this frame.
+        //
 
-            if (testCF.utility == 0.0)
-                break;
+        FBVector frameFBs;
+        FBVector derefFBs;
 
-            CacheFrame freeCF = findBestFreeTarget(testCF);
+        frameItems(frame, frameFBs);
 
-            if (overflowing())
+        for (FBVector::iterator i = frameFBs.begin(); i != frameFBs.end(); ++i)
+        {
+            if (imgIDs.count((*i)->identifier()) == 0)
             {
-                if (isActiveTailCachingEnabled())
-                {
-                    if (freeCF.utility >= testCF.utility)
-                        break;
-                }
-                else
-                {
-                    if (freeCF.utility >= (utility(testFrame, FOR_FREEING) - 0.001))
-                        break;
-                }
+                derefFBs.push_back(*i);
             }
-
-            initCacheFreePair(testCF.frame, freeCF.frame);
         }
-        //  if (cacheFrameCount > 1) cerr << "cacheFrameCount " <<
-        //  cacheFrameCount << endl;
+        for (FBVector::iterator i = derefFBs.begin(); i != derefFBs.end(); ++i)
+        {
+            dereferenceFrame(frame, *i);
+        }
+        DB("trimFBsOfFrame " << frame << " complete");
+    }
 
+    void FBCache::dereferenceFrame(int frame, FrameBuffer* fb)
+    {
         //
-        //  Now fill return vector of frame numbers to cache, always in
-        //  decreasing order.
+        //  We assume fb is cached.
         //
 
-        for (int f = (cacheTarget.inc > 0) ? cacheTarget.frame + cacheFrameCount - 1 : cacheTarget.frame, lim = f - cacheFrameCount;
-             f > lim; --f)
+        DB("dereferernceFrame frame " << frame << " fb " << fb << " id " << fb->identifier() << " reffed: "
+                                      << m_frameIndex->contains(frame, fb) << " refcount " << fbReferenceCount(fb));
+
+        //  Remove frame from list of frames _using_ this FB, and FB from
+        //  the list of those _used by_ this Frame.
+        //
+        if (m_frameIndex->erase(frame, fb))
         {
-            frames.push_back(f);
-        }
+            noteFrameItem(frame, fb, false);
 
-        return;
-    }
+            //  DeReference FB so it can be discarded from cache if this was
+            //  last external ref.
+            //
+            dereferenceFB(fb);
 
-    void FBCache::completeCachingOfFrame(int frame)
-    {
-        DB("----- completeCachingOfFrame " << frame);
-        std::map<int, int>::iterator i = m_framesBeingCached.find(frame);
-        if (i != m_framesBeingCached.end())
-        {
-            DB("-----     found in beingCached map");
-            if (NAF != i->second)
+            if (m_frameIndex->numFramesOfItem(fb) == 0)
             {
-                DB("removing " << i->second << " from scheduledForFreeing list");
-                m_framesScheduledForFreeing.erase(i->second);
+                noteItemUnreferenced(fb);
+                noteLastFrameOfItem(fb, frame);
             }
-            m_framesBeingCached.erase(i);
+
+            if (!isFrameCached(frame))
+                m_cacheEdges->removeCacheEdge(frame);
+
+            DB("frame " << frame << " de-reffed '" << fb->identifier() << "' new count " << fbReferenceCount(fb));
         }
     }
 
-    void FBCache::considerFrameForFreeing(int f, int& targetFrame, float& targetUtility)
+    bool FBCache::referenceFrame(int frame, FrameBuffer* fb)
     {
-        DBL(DB_EDGES, "considerFrameForFreeing: frame " << f << " target " << targetFrame << " utility " << targetUtility);
-        if (f < m_minFrame || f >= m_maxFrame || m_framesBeingCached.count(f) || f == m_displayFrame)
-        {
-            return;
-        }
+        DB("referenceFrame frame " << frame << " fb " << fb << " id " << fb->identifier() << " already reffed: "
+                                   << m_frameIndex->contains(frame, fb) << " refcount " << fbReferenceCount(fb));
 
-        if (isFrameCached(f))
-        //
-        //  Consider this frame for freeing
+        //  Add frame to list of frames that use this FB, and FB to the
+        //  list of those used by this Frame.
         //
+        if (m_frameIndex->insert(frame, fb))
         {
-            float u = utility(f, FOR_FREEING);
+            noteFrameItem(frame, fb, true);
 
-            if (u < targetUtility)
-            {
-                targetFrame = f;
-                targetUtility = u;
-                DBL(DB_EDGES, "considerFrameForFreeing: targeting new frame " << f << " utility " << u);
-            }
-        }
-    }
+            //  Reference FB so will not be discarded from cache, until we
+            //  decide to discard this frame.
+            //
+            referenceFB(fb);
 
-    //
-    //  free() really tries to ensure that the amount of space requested
-    //  is available in the cache.  so it may free nothing if that space
-    //  is already available, or it may free more than requested if the
-    //  cache is over-full.
-    //
-    bool FBCache::free(size_t inbytes) { return freeInternal(inbytes, true); }
+            if (m_frameIndex->numFramesOfItem(fb) == 1)
+                noteItemReferenced(fb);
 
-    bool FBCache::freeInternal(size_t inbytes, bool freeMemory)
-    {
-        DBL(DB_FREE, "free() " << inbytes << " current " << m_currentBytes << " max " << m_maxBytes << " "
-                               << double(m_currentBytes) / double(m_maxBytes));
-        if (m_maxBytes > m_currentBytes && m_maxBytes - m_currentBytes >= inbytes)
-        {
             return true;
         }
+        return false;
+    }
 
-        size_t targetBytes = (m_maxBytes > inbytes) ? m_maxBytes - inbytes : 0;
-        if (freeMemory)
-        {
-            TwkFB::Cache::freeTrash(m_currentBytes - targetBytes);
-        }
-
-        size_t incoming = m_currentBytes;
+    bool FBCache::flush(const IDString& idstring)
+    {
+        DBL(DB_FLUSH, "flush() " << idstring);
+        FBMap::iterator i = m_map.find(idstring);
         FrameVector toBeErased;
 
-        std::set<int> alreadyTried;
-        bool enough = true;
-
-        CacheEdges::EdgeVector edges;
-
-        while (m_maxBytes < m_currentBytes || m_maxBytes - m_currentBytes < inbytes)
+        if (i != m_map.end())
         {
-            m_cacheEdges->possibleFreeTargets(edges);
-            int targetFreeFrame = NAF;
-            float targetFreeFrameUtility = m_targetCacheFrameUtility;
+            FrameBuffer* fb = i->second;
+            FrameVector fset;
 
-            for (CacheEdges::EdgeVector::iterator i = edges.begin(); i != edges.end(); ++i)
+            //
+            //  Remove the fb from the frame index now, since the deref
+            //  below may lead us back to FBCache::flush, and if so we
+            //  want to be sure that the fb is no longer found at that
+            //  time.
+            //
+            if (m_frameIndex->eraseItem(fb, fset))
             {
-                int f = i->frame;
-                CacheEdges::EdgeType type = i->type;
+                DBL(DB_FLUSH, "flush() fset size " << fset.size());
 
+                if (!fset.empty())
+                {
+                    noteItemUnreferenced(fb);
+                    noteLastFrameOfItem(fb, fset.back());
+                }
+
+                for (FrameVector::iterator fs = fset.begin(); fs != fset.end(); ++fs)
                 //
-                //  Skip (in the right direction) past any frame we've
-                //  already attempted to free.  Note we go in the
-                //  opposite direction because the directions describes
-                //  where free frames lie and we're looking for cached
-                //  frames.
+                //  For every frame that referenced this fb
                 //
-                if (CacheEdges::LeftOnly == type)
                 {
-                    while (alreadyTried.count(f) || m_framesBeingCached.count(f))
-                    {
-                        ++f;
-                    }
+                    noteFrameItem(*fs, fb, false);
+
+                    if (!isFrameCached(*fs))
+                        toBeErased.push_back(*fs);
+
+                    DBL(DB_FLUSH | DB_REF, "flush() dereferencing");
+                    dereferenceFB(fb);
                 }
-                else if (CacheEdges::RightOnly == type)
+            }
+            for (FrameVector::iterator fvi = toBeErased.begin(); fvi != toBeErased.end(); ++fvi)
+            {
+                m_cacheEdges->removeCacheEdge(*fvi);
+            }
+
+            /*
+            //
+            //  Don't call Cache::flush here, since we want to hold on
+            //  to frame bufferes as long as possible (until we need the
+            //  memory).  The dereference above will (probably) push the
+            //  fb into the TrashCan, from which it can be reclaimed if
+            //  another frame wants to use it.
+            //
+            bool ret = Cache::flush(idstring);
+
+            #ifdef DB_LEVEL
+                std::set<std::string> ids;
+                for (FrameMap::iterator fmi = m_frames.begin(); fmi !=
+            m_frames.end(); ++fmi)
                 {
-                    while (alreadyTried.count(f) || m_framesBeingCached.count(f))
+                    IDSet& idset = fmi->second;
+                    for (IDSet::iterator i = idset.begin(); i != idset.end();
+            ++i)
                     {
-                        --f;
+                        ids.insert(*i);
                     }
                 }
-                else if (CacheEdges::BothSides == type)
-                {
-                    //  There are free frames on both sides of this one,
-                    //  so we only need to test this one.
+                std::set<std::string> cids;
+                DBL (DB_FLUSH, "after flushing (ret " << ret << ") " << idstring
+            <<
+                        ", FBCache holds " << ids.size() << " ids, Cache holds "
+            << m_map.size()); #endif
 
-                    if (alreadyTried.count(f))
-                        continue;
-                }
-                else
-                    continue; /* unexpected type !*/
+            return ret;
+            */
+            return true;
+        }
 
-                considerFrameForFreeing(f, targetFreeFrame, targetFreeFrameUtility);
-            }
-            DBL(DB_FREE,
-                "free targetFreeFrame " << targetFreeFrame << " utility " << targetFreeFrameUtility << " < " << m_targetCacheFrameUtility);
+        return false;
+    }
 
-            if (NAF == targetFreeFrame)
-            //
-            //  There's no frame we can legitimately free (that has a
-            //  utility less than the m_targetCacheFrameUtility).
-            //
-            {
-                enough = false;
-                break;
-            }
-            alreadyTried.insert(targetFreeFrame);
-            //
-            //  Free the ids that were cached for this frame, this may
-            //  free nothing of other frames are using these ids.
-            //
-            FrameMap::iterator fi = m_frames.find(targetFreeFrame);
-            const IDSet& idset = fi->second;
+    void FBCache::setDiskCache(const string& directory, size_t bytes)
+    {
+        lock();
+        delete m_diskCache;
+        m_diskCache = 0;
+        m_lastFrameOfItem.clear();
+
+        if (!directory.empty() && bytes)
+        {
+            m_diskCache = new FBDiskCache(directory, bytes);
 
-            if (freeIDSet(idset, targetFreeFrame))
+            if (m_diskCache->isValid())
             {
-                toBeErased.push_back(targetFreeFrame);
+                cout << "INFO: Disk cache of " << (m_diskCache->capacity() >> 20) << "MB in " << directory << endl;
             }
-
-            DBL(DB_FREE, "free m_currentBytes " << m_currentBytes << " targetBytes " << targetBytes);
-            //
-            //  At best freeIDSet just flushes ids from the frame-level
-            //  data structures, adding them to the Cache-level
-            //  TrashCan, so call freeTrash to "really" free something.
-            //
-            if (freeMemory && m_currentBytes > targetBytes)
+            else
             {
-                TwkFB::Cache::freeTrash(m_currentBytes - targetBytes);
+                delete m_diskCache;
+                m_diskCache = 0;
             }
         }
 
-        for (int i = 0; i < toBeErased.size(); i++)
-        {
-            m_frames.erase(toBeErased[i]);
-        }
-        checkMetadata();
+        unlock();
+        setCacheStatsDirty();
+    }
+
+    bool FBCache::aboutToDeleteFB(FrameBuffer* fb)
+    {
+        //
+        //  Per-node (texture) cache items and anything still referenced
+        //  by a frame never get here, so this is just the trash. A
+        //  compressed fb has no pixels, it's not worth decompressing it
+        //  when trying to free memory.
+        //
+        //  The disk cache's writer thread copies the fb and deletes it,
+        //  so nothing is written with the cache lock held.
+        //
+
+        if (!m_diskCache || m_compressed.count(fb) || !FBDiskCache::isStorable(fb))
+            return false;
 
-        if (Cache::debug())
-            showCacheContents();
+        //
+        //  The disk tier evicts by the utility of the last frame that
+        //  used the fb, as it is now. Its writer thread can't ask.
+        //
 
-        setCacheStatsDirty();
+        map<const FrameBuffer*, int>::const_iterator i = m_lastFrameOfItem.find(fb);
+        const float u = i == m_lastFrameOfItem.end() ? 0.0f : utility(i->second, FOR_FREEING);
 
-        for (std::set<int>::iterator i = alreadyTried.begin(); i != alreadyTried.end(); ++i)
-        {
-            DB("    frame " << *i << " still cached: " << isFrameCached(*i));
-            m_cacheEdges->removeCacheEdge(*i);
-        }
+        forgetFB(fb);
 
-        bool ok = (m_maxBytes - m_currentBytes >= inbytes);
+        if (m_diskCache->add(fb, u))
+            setCacheStatsDirty();
+        else
+            delete fb;
 
-        DBL(DB_FREE, "free() complete" << " current " << m_currentBytes << " max " << m_maxBytes << ", "
-                                       << double(m_currentBytes) / double(m_maxBytes) << ", ok " << ok);
+        return true;
+    }
 
-        return ok;
+    void FBCache::noteLastFrameOfItem(const FrameBuffer* fb, int frame)
+    {
+        if (m_diskCache)
+            m_lastFrameOfItem[fb] = frame;
     }
 
-    void FBCache::emergencyFree()
+    bool FBCache::pageIn(const IDString& id, int frame)
     {
-        DBL(DB_FREE, "******************* emergencyFree " << " current " << m_currentBytes << " max " << m_maxBytes << " "
-                                                          << double(m_currentBytes) / double(m_maxBytes) << " trash count "
-                                                          << trashCount());
+        if (!m_diskCache || id.empty())
+            return false;
 
-        if (m_maxBytes < m_currentBytes)
+        lock();
+        const bool wanted = !isCached(id) && m_diskCache->contains(id);
+        unlock();
+
+        if (!wanted)
+            return false;
+
+        //
+        //  Copied out of the slab without the cache lock, another thread
+        //  may have cached it in the meantime.
+        //
+
+        FrameBuffer* fb = m_diskCache->pageIn(id);
+
+        if (!fb)
+            return false;
+
+        lock();
+
+        bool added = false;
+
+        if (!isCached(id))
         {
-            //  Set the utility bar as high as possible (any edge frame with
-            //  utility less than utilityMax will be considered for
-            //  freeing).
             //
-            m_targetCacheFrameUtility = utilityMax;
-            free(0);
-            DBL(DB_FREE, "******************* emergencyFree " << " current " << m_currentBytes << " max " << m_maxBytes << " "
-                                                              << double(m_currentBytes) / double(m_maxBytes) << " trash count "
-                                                              << trashCount());
-        }
-        setCacheStatsDirty();
-    }
+            //  Only make room for it if it's worth more than what we'd
+            //  have to free, same as a freshly evaluated fb.
+            //
 
-    bool FBCache::cacheStats(CacheStats& c) const
-    {
-        // if (m_cacheStatsDisabled) cerr << "ERROR: cache stats requested, but
-        // have been disabled" << endl;
+            m_targetCacheFrameUtility = utility(frame, FOR_CACHING);
+            added = TwkFB::Cache::add(fb, m_map.empty());
 
-        LockObject sl(m_statMutex, true);
+            if (added)
+            {
+                //
+                //  Nothing references it yet, so put it in the trash like
+                //  any other unreferenced fb. checkOut() or
+                //  referenceFrame() take it back out.
+                //
 
-        if (sl.locked())
-        {
-            c = m_cacheStats;
-            return true;
+                referenceFB(fb);
+                dereferenceFB(fb);
+            }
         }
-        else
+
+        unlock();
+
+        if (!added)
         {
+            delete fb;
             return false;
         }
+
+        DB("pageIn() frame " << frame << " id " << id);
+        setCacheStatsDirty();
+        return true;
     }
 
-    void FBCache::setCacheStatsDirty()
+    void FBCache::flushDiskCache(const IDString& id)
     {
-        if (m_cacheStatsDisabled)
-            return;
+        if (m_diskCache)
+            m_diskCache->flush(id);
+    }
 
-        LockObject sl(m_statMutex, true);
+    void FBCache::setCompressionEnabled(bool b)
+    {
+        lock();
 
-        if (sl.locked())
-            m_cacheStatsDirty = true;
+        m_compressionEnabled = b;
 
-        //
-        //  If we failed to lock, something else is setting the dirty flag _or_
-        //  the stats are being updated.  There's a chance here that the flag
-        //  could get out of sync (IE be set to true even though we just called
-        //  setCacheStatsDirty, we just don't care enough that the stats be
-        //  accurate.  We'd rather eliminate the possibility of a perf hit due
-        //  to lock contention.
-        //
+        if (!b)
+        {
+            //
+            //  Leave what's already compressed alone, it'll be
+            //  decompressed when it's needed.
+            //
+
+            m_incompressible.clear();
+        }
+
+        unlock();
     }
 
-    void FBCache::updateCacheStatsIfDirty()
+    bool FBCache::inPlayWindow(int frame) const
     {
-        if (m_cacheStatsDisabled)
-            return;
+        if (m_displayFrame == NAF)
+            return false;
 
-        LockObject sl(m_statMutex);
+        int window = m_compressionWindow;
 
-        if (!m_cacheStatsDirty)
-            return;
+        if (window <= 0)
+            window = max(int(m_displayFPS + 0.5f), 1);
+
+        int ahead = (m_displayInc < 0) ? m_displayFrame - frame : frame - m_displayFrame;
 
         //
-        //  This returns immediately
+        //  Frames behind the display frame come around again when
+        //  looping over the in/out range.
         //
 
-        m_cacheStats.capacity = capacity();
-        m_cacheStats.used = used();
+        if (ahead < 0 && frame >= m_inFrame && frame < m_outFrame)
+            ahead += m_outFrame - m_inFrame;
+
+        return ahead >= 0 && ahead <= window;
+    }
 
+    bool FBCache::isCompressible(FrameBuffer* fb, size_t pins)
+    {
         //
-        //  This requires some work
+        //  Only compress fbs that nothing but the frames (and the pins
+        //  of compressAhead()) is holding on to: no check outs, no
+        //  per-node cache.
         //
 
+        return !m_compressed.count(fb) && !m_incompressible.count(fb)
+               && fbReferenceCount(fb) == size_t(m_frameIndex->numFramesOfItem(fb)) + 1 + pins;
+    }
+
+    size_t FBCache::compressAhead(size_t bytes)
+    {
         lock();
-        try
-        {
-            computeCachedRangesStat(m_cacheStats.cachedRanges);
-            m_cacheStats.lookAheadSeconds = computeLookAheadSecondsStat(m_cacheStats.cachedRanges);
 
-            m_cacheStatsDirty = false;
-            unlock();
-        }
-        catch (...)
+        if (!m_compressionEnabled || (m_maxBytes > m_currentBytes && m_maxBytes - m_currentBytes >= bytes))
         {
             unlock();
+            return 0;
         }
-    }
 
-    //------------------------------------------------------------------------------
-    //
-    void FBCache::computeCachedRangesStat(FrameRangeVector& array) const
-    {
-        array.clear();
+        const size_t wanted = m_currentBytes + bytes - m_maxBytes;
 
-        for (FrameMap::const_iterator i = m_frames.begin(); i != m_frames.end(); ++i)
-        {
-            int frame = i->first;
+        //
+        //  What compressing an fb will save isn't known until it's done,
+        //  guess from what's been compressed so far (half to start with).
+        //
 
-            if (array.empty())
-            {
-                array.push_back(make_pair(frame, frame));
-            }
-            else
-            {
-                FrameRange& range = array.back();
+        const double ratio = m_compressedRawBytes ? double(m_compressedBytes) / double(m_compressedRawBytes) : 0.5;
 
-                if (range.second == frame - 1)
-                {
-                    range.second = frame;
-                }
-                else
-                {
-                    array.push_back(make_pair(frame, frame));
-                }
-            }
-        }
-    }
+        FrameVector frames;
+        m_frameIndex->sortedFrames(frames);
 
-    //------------------------------------------------------------------------------
-    //
-    float FBCache::computeLookAheadSecondsStat(const FrameRangeVector& vecFrameRange) const
-    {
-        if (m_displayFrame == NAF || m_inFrame == NAF || m_outFrame == NAF || m_displayInc == 0 || vecFrameRange.empty())
-        {
-            return 0.0f;
-        }
+        vector<pair<float, int>> candidates;
+        candidates.reserve(frames.size());
 
-        // Determine the look ahead time in seconds from the display frame
-        if (m_displayInc > 0)
+        for (size_t i = 0; i < frames.size(); i++)
         {
-            // Positive increment
-            for (FrameRangeVector::const_iterator i = vecFrameRange.begin(); i != vecFrameRange.end(); ++i)
-            {
-                // Locate the range where the display frame is located if any
-                if (m_displayFrame >= i->first && m_displayFrame <= i->second)
-                {
-                    // Locate the last matching range wrt m_displayInc
-                    FrameRangeVector::const_iterator endFrameRangeIter = i;
-                    while (i != vecFrameRange.end() && (i->first <= (endFrameRangeIter->second + m_displayInc)))
-                    {
-                        endFrameRangeIter = i;
-                        i++;
-                    };
+            const int f = frames[i];
 
-                    return (endFrameRangeIter->second - m_displayFrame) / m_displayFPS;
-                }
-            }
+            if (!inPlayWindow(f) && !frameIsBeingCached(f))
+                candidates.push_back(make_pair(utility(f, FOR_FREEING), f));
         }
-        else
-        {
-            // Negative increment
-            for (FrameRangeVector::const_reverse_iterator i = vecFrameRange.rbegin(); i != vecFrameRange.rend(); ++i)
-            {
-                // Locate the range where the display frame is located if any
-                if (m_displayFrame >= i->first && m_displayFrame <= i->second)
-                {
-                    // Locate the last matching range wrt m_displayInc
-                    FrameRangeVector::const_reverse_iterator endFrameRangeIter = i;
-                    while (i != vecFrameRange.rend() && (i->second <= (endFrameRangeIter->first + m_displayInc)))
-                    {
-                        endFrameRangeIter = i;
-                        i++;
-                    };
 
-                    return (m_displayFrame - endFrameRangeIter->first) / m_displayFPS;
-                }
-            }
-        }
+        sort(candidates.begin(), candidates.end());
 
-        return 0.0f;
-    }
+        double expected = 0;
+        FBVector fbs;
+        FBVector pinned;
 
-    struct CheckInEach
-    {
-        CheckInEach(FBCache& c)
-            : cache(c)
+        for (size_t i = 0; i < candidates.size() && expected < double(wanted); i++)
         {
-        }
-
-        FBCache& cache;
+            fbs.clear();
+            m_frameIndex->items(candidates[i].second, fbs);
 
-        void operator()(IPImage* l)
-        {
-            DB("checkInAndDelete() fb " << l->fb << " in cache " << ((l->fb) ? l->fb->inCache() : 0));
-            if (l->fb && l->fb->inCache())
+            for (size_t q = 0; q < fbs.size(); q++)
             {
-                DB("checkInAndDelete() fb " << l->fb << " ref count " << cache.fbReferenceCount(l->fb) << " frames in itemMap "
-                                            << cache.framesInItemMap(l->fb));
-                cache.Cache::checkIn(l->fb);
-                l->fb = 0;
-            }
-        }
-    };
-
-    void FBCache::checkInAndDelete(IPImage* img)
-    {
-        if (img)
-        {
-            CheckInEach checkInEach(*this);
-            foreach_ip(img, checkInEach);
-            delete img;
-        }
-    }
+                FrameBuffer* fb = fbs[q];
 
-    void FBCache::checkInAndDelete(const IPImageVector& images)
-    {
-        for (size_t i = 0; i < images.size(); i++)
-            checkInAndDelete(images[i]);
-    }
+                if (fb->isCacheLocked() || !isCompressible(fb, 0))
+                    continue;
 
-    /*
+                //
+                //  Checking it out keeps it from being freed or
+                //  compressed by another thread while the lock is let go
+                //
 
-    I think this is wrong.  can't just clear thes caches without
-    dereferencing fbs, etc.
+                TwkFB::Cache::checkOut(fb);
+                pinned.push_back(fb);
+                expected += double(fb->totalImageSize()) * (1.0 - ratio);
+            }
+        }
 
-    void
-    FBCache::clearFrameInfo()
-    {
-        lock();
-        m_framesScheduledForFreeing.clear();
-        m_framesBeingCached.clear();
-        m_frames.clear();
-        m_cacheEdges->clear();
         unlock();
-    }
-    */
 
-    bool FBCache::frameItems(int frame, FBVector& items) const
-    {
-        if (m_frames.empty())
-            return false;
+        vector<CompressedFB*> compressed(pinned.size(), (CompressedFB*)0);
+
+        for (size_t i = 0; i < pinned.size(); i++)
+            compressed[i] = CompressedFB::compress(pinned[i]);
+
+        lock();
 
-        FrameMap::const_iterator i = m_frames.find(frame);
-        bool missed = false;
-        bool found = false;
+        size_t saved = 0;
 
-        if (i != m_frames.end())
+        for (size_t i = 0; i < pinned.size(); i++)
         {
-            const IDSet& idset = i->second;
-
-            for (IDSet::const_iterator id = idset.begin(); id != idset.end(); ++id)
-            {
-                //
-                //  Is the id still in the cache? If so add it to the
-                //  items vector. Otherwise make a note of the fact that
-                //  there was a cache miss and continue.
-                //
+            FrameBuffer* fb = pinned[i];
 
-                FBMap::const_iterator mi = m_map.find(*id);
+            //
+            //  Something else may have checked it out or the display
+            //  thread pinned it meanwhile. Retired, it can't be pinned
+            //  again until it's expanded.
+            //
 
-                if (mi == m_map.end())
-                {
-                    missed = true;
-                }
-                else
-                {
-                    found = true;
-                    if (mi->second)
-                        items.push_back(mi->second);
-                }
+            if (isCompressible(fb, 1) && (!compressed[i] || retirePins(fb)))
+            {
+                saved += commitCompressed(fb, compressed[i]);
             }
+            else
+            {
+                delete compressed[i];
+            }
+
+            TwkFB::Cache::checkIn(fb);
         }
 
-        return !missed && found;
-    }
+        DBL(DB_FREE, "compressAhead() wanted " << wanted << " saved " << saved);
 
-    //
-    //  Update frame-level caching.  Note that we only reference a FB once, no
-    //  matter how many times it's used by this frame.
-    //
+        if (saved)
+            setCacheStatsDirty();
+        unlock();
 
-    //
-    //  Collect cached FBs from IPImage
-    //
-    struct IDSetCollector
+        return saved;
+    }
+
+    size_t FBCache::commitCompressed(FrameBuffer* fb, CompressedFB* c)
     {
-        IDSetCollector(FBCache::IDSet& s)
-            : ids(s)
+        if (!c)
         {
+            m_incompressible.insert(fb);
+            return 0;
         }
 
-        FBCache::IDSet& ids;
+        fb->releaseData();
+        m_compressed[fb] = c;
 
-        void operator()(IPImage* img)
+        const size_t saved = c->rawSize() - c->size();
+        m_compressedBytes += c->size();
+        m_compressedRawBytes += c->rawSize();
+        m_currentBytes -= saved;
+        m_full = (m_currentBytes >= m_maxBytes);
+
+        return saved;
+    }
+
+    bool FBCache::finishExpand(FrameBuffer* fb, bool ok)
+    {
+        map<const FrameBuffer*, CompressedFB*>::iterator i = m_compressed.find(fb);
+
+        if (!ok)
         {
-            if (img->fb && img->fb->inCache())
-            {
-                ids.insert(img->fb->identifier());
-            }
+            //
+            //  Stays compressed (and without pixels) until it's dropped
+            //
+
+            fb->releaseData();
+            return false;
         }
-    };
 
-    void FBCache::trimFBsOfFrame(int frame, IPImage* img)
+        CompressedFB* c = i->second;
+
+        m_compressedBytes -= c->size();
+        m_compressedRawBytes -= c->rawSize();
+        m_currentBytes += c->rawSize() - c->size();
+        m_full = (m_currentBytes >= m_maxBytes);
+
+        delete c;
+        m_compressed.erase(i);
+        restorePins(fb);
+        setCacheStatsDirty();
+        return true;
+    }
+
+    void FBCache::dropItem(const IDString& id)
     {
-        DB("trimFBsOfFrame " << frame);
         //
-        //  Build set of IDs of FBs used by this frame (according to incoming
-        //  image).
+        //  An item that can't be decompressed has to be decoded again:
+        //  take it out of its frames and then out of the cache.
         //
 
-        IDSet imgIDs;
-        IDSetCollector collector(imgIDs);
-        foreach_ip(img, collector);
+        cerr << "ERROR: FBCache: failed to decompress " << id << ", dropping it" << endl;
+        flush(id);
+        TwkFB::Cache::flush(id);
+    }
 
-        //
-        //  For each FB the cache thinks this frame uses, if it's not in the
-        //  incoming list, remove it from frame-level caching for this frame.
-        //
+    void FBCache::expand(const IDString& id)
+    {
+        lock();
 
-        IDSet& frameIDs = m_frames[frame];
-        FBVector derefFBs;
+        FBMap::iterator i = m_map.find(id);
 
-        for (IDSet::iterator i = frameIDs.begin(); i != frameIDs.end(); ++i)
+        if (i == m_map.end() || !m_compressed.count(i->second) || m_expanding.count(i->second))
         {
-            if (imgIDs.count(*i) == 0)
-            {
-                derefFBs.push_back(m_map[*i]);
-            }
+            unlock();
+            return;
         }
-        for (FBVector::iterator i = derefFBs.begin(); i != derefFBs.end(); ++i)
+
+        FrameBuffer* fb = i->second;
+        const CompressedFB* c = m_compressed[fb];
+        m_expanding.insert(fb);
+        TwkFB::Cache::checkOut(fb);
+
+        unlock();
+
+        bool ok = false;
+
+        try
         {
-            dereferenceFrame(frame, *i);
+            fb->reallocateData();
+            ok = c->decompress(fb);
+        }
+        catch (...)
+        {
+            ok = false;
         }
-        DB("trimFBsOfFrame " << frame << " complete");
-    }
 
-    void FBCache::dereferenceFrame(int frame, FrameBuffer* fb)
-    {
+        lock();
+
         //
-        //  We assume fb is cached.
+        //  If it failed it stays compressed, the next checkOut() drops
+        //  it.
         //
 
-        bool reffed = (m_frames[frame].count(fb->identifier()) != 0);
+        finishExpand(fb, ok);
+        m_expanding.erase(fb);
+        TwkFB::Cache::checkIn(fb);
+        pthread_cond_broadcast(&m_expandCond);
 
-        DB("dereferernceFrame frame " << frame << " fb " << fb << " id " << fb->identifier() << " reffed: " << reffed << " refcount "
-                                      << fbReferenceCount(fb));
+        unlock();
+    }
 
-        if (reffed)
-        {
-            //  Remove frame from list of frames _using_ this FB.
-            ///
-            m_itemMap[fb].erase(frame);
+    bool FBCache::expandItem(FrameBuffer* fb)
+    {
+        //
+        //  Called with the lock once no expand() of the fb is under way,
+        //  decompresses what wasn't expanded beforehand.
+        //
 
-            //  Remove FB's identifier from list of those _used by_ this Frame.
-            //
-            m_frames[frame].erase(fb->identifier());
+        if (!m_compressed.count(fb))
+            return true;
 
-            //  DeReference FB so it can be discarded from cache if this was
-            //  last external ref.
-            //
-            dereferenceFB(fb);
-            DB("frame " << frame << " size " << m_frames[frame].size() << " de-reffed '" << fb->identifier() << "' new count "
-                        << fbReferenceCount(fb));
-        }
+        fb->reallocateData();
+        return finishExpand(fb, m_compressed[fb]->decompress(fb));
     }
 
-    bool FBCache::referenceFrame(int frame, FrameBuffer* fb)
+    size_t FBCache::cachedSize(const FrameBuffer* fb) const
     {
-        bool reffed = (m_frames[frame].count(fb->identifier()) != 0);
+        map<const FrameBuffer*, CompressedFB*>::const_iterator i = m_compressed.find(fb);
+        return i == m_compressed.end() ? fb->totalImageSize() : i->second->size();
+    }
 
-        DB("referenceFrame frame " << frame << " fb " << fb << " id " << fb->identifier() << " already reffed: " << reffed << " refcount "
-                                   << fbReferenceCount(fb));
+    void FBCache::forgetFB(FrameBuffer* fb)
+    {
+        map<const FrameBuffer*, CompressedFB*>::iterator i = m_compressed.find(fb);
 
-        if (!reffed)
+        if (i != m_compressed.end())
         {
-            //  Add frame to list of frames that use this FB.
-            ///
-            m_itemMap[fb].insert(frame);
-
-            //  Add FB's identifier to list of those used by this Frame.
-            //
-            m_frames[frame].insert(fb->identifier());
-
-            //  Reference FB so will not be discarded from cache, until we
-            //  decide to discard this frame.
-            //
-            referenceFB(fb);
-
-            return true;
+            m_compressedBytes -= i->second->size();
+            m_compressedRawBytes -= i->second->rawSize();
+            delete i->second;
+            m_compressed.erase(i);
         }
-        return false;
+
+        m_incompressible.erase(fb);
+        m_itemSources.erase(fb);
+        m_lastFrameOfItem.erase(fb);
     }
 
-    bool FBCache::flush(const IDString& idstring)
+    TwkFB::FrameBuffer* FBCache::checkOut(const IDString& id)
     {
-        DBL(DB_FLUSH, "flush() " << idstring);
-        FBMap::iterator i = m_map.find(idstring);
-        FrameVector toBeErased;
+        FBMap::iterator i = m_map.find(id);
 
-        if (i != m_map.end())
+        while (i != m_map.end() && m_expanding.count(i->second))
         {
-            FrameBuffer* fb = i->second;
-            ItemFrames::iterator q = m_itemMap.find(fb);
-
-            if (q != m_itemMap.end())
-            {
-                FrameSet fset = q->second;
-                //
-                //  erase q now, since the deref below may lead us back
-                //  to FBCache::flush, and if so we want to be sure that
-                //  the above find() fails at that time.
-                //
-                m_itemMap.erase(q);
-                DBL(DB_FLUSH, "flush() fset size " << fset.size());
-
-                for (FrameSet::iterator fs = fset.begin(); fs != fset.end(); ++fs)
-                //
-                //  For every frame that references this fb
-                //
-                {
-                    //
-                    //  Get the set of identifiers associated with this
-                    //  frame, and remove this one, if it's in there
-                    //
-                    DBL(DB_FLUSH, "flush() checking idset of frame " << *fs);
-                    IDSet& idset = m_frames[*fs];
-                    if (idset.count(idstring))
-                    {
-                        idset.erase(idstring);
-                        if (idset.empty())
-                            toBeErased.push_back(*fs);
+            pthread_cond_wait(&m_expandCond, &m_mutex);
+            i = m_map.find(id);
+        }
 
-                        DBL(DB_FLUSH | DB_REF, "flush() dereferencing");
-                        dereferenceFB(fb);
-                    }
-                }
-            }
-            for (FrameVector::iterator fvi = toBeErased.begin(); fvi != toBeErased.end(); ++fvi)
-            {
-                m_frames.erase(*fvi);
-                m_cacheEdges->removeCacheEdge(*fvi);
-            }
+        if (i != m_map.end() && !expandItem(i->second))
+        {
+            dropItem(id);
+            return 0;
+        }
 
-            /*
-            //
-            //  Don't call Cache::flush here, since we want to hold on
-            //  to frame bufferes as long as possible (until we need the
-            //  memory).  The dereference above will (probably) push the
-            //  fb into the TrashCan, from which it can be reclaimed if
-            //  another frame wants to use it.
-            //
-            bool ret = Cache::flush(idstring);
+        return TwkFB::Cache::checkOut(id);
+    }
 
-            #ifdef DB_LEVEL
-                std::set<std::string> ids;
-                for (FrameMap::iterator fmi = m_frames.begin(); fmi !=
-            m_frames.end(); ++fmi)
-                {
-                    IDSet& idset = fmi->second;
-                    for (IDSet::iterator i = idset.begin(); i != idset.end();
-            ++i)
-                    {
-                        ids.insert(*i);
-                    }
-                }
-                std::set<std::string> cids;
-                DBL (DB_FLUSH, "after flushing (ret " << ret << ") " << idstring
-            <<
-                        ", FBCache holds " << ids.size() << " ids, Cache holds "
-            << m_map.size()); #endif
+    void FBCache::checkOut(FrameBuffer* fb)
+    {
+        while (m_expanding.count(fb))
+            pthread_cond_wait(&m_expandCond, &m_mutex);
 
-            return ret;
-            */
-            return true;
+        if (!expandItem(fb))
+        {
+            TWK_THROW_STREAM(TwkFB::Exception, "FBCache: failed to decompress " << fb->identifier());
         }
 
-        return false;
+        TwkFB::Cache::checkOut(fb);
     }
 
     bool FBCache::flushIDSetSubstr(const IDSet& subStrings)
@@ -2421,9 +4073,12 @@ namespace IPCore
         {
             cout << "INFO: GC: frames currently active: " << dec;
 
-            for (FrameMap::iterator i = m_frames.begin(); i != m_frames.end(); ++i)
+            FrameVector frames;
+            m_frameIndex->sortedFrames(frames);
+
+            for (FrameVector::iterator i = frames.begin(); i != frames.end(); ++i)
             {
-                cout << " " << i->first;
+                cout << " " << *i;
             }
 
             cout << endl;
@@ -2458,137 +4113,10 @@ namespace IPCore
             }
         }
 
-        vector<FrameBuffer*> garbageItems;
-
-        for (ItemFrames::iterator i = m_itemMap.begin(); i != m_itemMap.end(); ++i)
-        {
-            FrameBuffer* fb = i->first;
-            FrameSet& fset = i->second;
-
-            vector<int> garbageFrames;
-
-            for (FrameSet::iterator q = fset.begin(); q != fset.end(); ++q)
-            {
-                int f = *q;
-
-                FrameMap::iterator fi = m_frames.find(f);
-
-                if (fi != m_frames.end())
-                {
-                    IDSet& ids = fi->second;
-
-                    if (ids.count(fb->identifier()) == 0)
-                    //
-                    //  If the identifier does not appear in this
-                    //  frame's entry, the m_itemMap entry is
-                    //  inconsistant, so mark this frame for removal
-                    //  from the m_itemMap entry.
-                    {
-                        garbageFrames.push_back(f);
-                    }
-                }
-                else
-                {
-                    //
-                    //  Likewise if there is no entry for this frame at
-                    //  all.
-                    //
-                    garbageFrames.push_back(f);
-                }
-            }
-
-            //
-            //  Now remove frames from fb's item map entry that were
-            //  discovered above.
-            //
-            for (size_t q = 0; q < garbageFrames.size(); q++)
-            {
-                if (fset.count(garbageFrames[q]))
-                {
-                    fset.erase(garbageFrames[q]);
-                    //
-                    //  Don't deref here because we don't add a ref when
-                    //  we add frames to fb's entry in m_itemMap
-                    //
-                    //  dereferenceFB(fb);
-                }
-            }
-
-            //
-            //  If this fb is no longer linked to any frame, mark it
-            //  for removal from m_itemMap.
-            //
-            if (fset.empty())
-                garbageItems.push_back(fb);
-        }
-        DB("    found " << garbageItems.size() << " 'garbage' items in m_itemMap");
-
-        if (Cache::debug() && garbageItems.size())
-            cout << "INFO: GC: " << garbageItems.size() << " items found" << endl;
-
-        size_t collected = 0;
-
-        for (size_t i = 0; i < garbageItems.size(); i++)
-        {
-            FrameBuffer* fb = garbageItems[i];
-
-            if (!fb)
-            {
-                // cout << "INFO: GC: no item at " << i << endl;
-                continue;
-            }
-
-            if (fb->isCacheLocked())
-            {
-                // cout << "INFO: GC: lock on " << fb->identifier() << endl;
-                continue;
-            }
-
-            ItemFrames::iterator item = m_itemMap.find(fb);
-
-            if (item != m_itemMap.end())
-            {
-                while (force && fbReferenceCount(fb) > 1)
-                {
-                    DBL(DB_REF, "garbageCollect() dereferencing in GC 2, fb " << fb);
-                    DBL(DB_REF, "                 id " << fb->identifier() << " ref count " << fbReferenceCount(fb));
-                    dereferenceFB(fb);
-                }
-
-                DB("GC: flushing " << fb << " " << fb->identifier() << " with " << item->second.size() << " frames ");
-                if (!flush(fb->identifier()))
-                {
-#if 0
-                cerr << "WARNING: GC: unflushed item " 
-                     << fb->identifier()
-                     << endl;
-#endif
-                }
-                else
-                {
-                    m_itemMap.erase(item);
-                    collected++;
-                }
-            }
-            else
-            {
-                cerr << "WARNING: CACHE GC: found disconnected item " << fb->identifier() << endl;
-            }
-        }
-
-        if (Cache::debug() && collected)
-            cout << "INFO: CACHE GC: collected " << collected << " items" << endl;
-
-#if 0
-    if (!force && collected != garbageItems.size())
-    {
-        cout << "INFO: STOPPING: " << garbageItems.size() << " items were found, "
-             << collected << " of them were collected"
-             << endl;
-
-        exit(-1);
-    }
-#endif
+        //
+        //  The frame index keeps frame->item and item->frame references
+        //  in step, so there are no inconsistent item entries to collect.
+        //
     }
 
     void FBCache::showCacheContents() const
@@ -2608,14 +4136,27 @@ namespace IPCore
     void FBCache::setDisplayFrame(int f)
     {
         if (f != m_displayFrame && m_graph->cachingMode() == IPGraph::BufferCache)
-            m_utilityStateChanged = true;
+            setUtilityStateChanged();
         m_displayFrame = f;
+
+        set<int>::iterator i = m_prefetchedFrames.find(f);
+
+        if (i != m_prefetchedFrames.end())
+        {
+            if (isFrameCached(f))
+            {
+                m_prefetchHits++;
+                setCacheStatsDirty();
+            }
+
+            m_prefetchedFrames.erase(i);
+        }
     }
 
     void FBCache::setDisplayInc(int i)
     {
         if (i != m_displayInc && m_graph->cachingMode() == IPGraph::BufferCache)
-            m_utilityStateChanged = true;
+            setUtilityStateChanged();
         m_displayInc = i;
     }
 
@@ -2624,7 +4165,7 @@ namespace IPCore
         DBL(DB_EDGES, "setInOutFrames " << a << " " << b << " " << c << " " << d << endl);
         if (a != m_inFrame || b != m_outFrame || c != m_minFrame || d != m_maxFrame)
         {
-            m_utilityStateChanged = true;
+            setUtilityStateChanged();
         }
         m_inFrame = a;
         m_outFrame = b;
@@ -2635,7 +4176,7 @@ namespace IPCore
     void FBCache::setLookBehindFraction(float f)
     {
         if (f != m_lookBehindFraction && m_graph->cachingMode() == IPGraph::BufferCache)
-            m_utilityStateChanged = true;
+            setUtilityStateChanged();
         m_lookBehindFraction = f;
     }
 
@@ -2647,7 +4188,7 @@ namespace IPCore
 
             if (m_graph->cachingMode() == IPGraph::BufferCache)
             {
-                m_utilityStateChanged = true;
+                setUtilityStateChanged();
             }
         }
     }
@@ -2656,7 +4197,7 @@ namespace IPCore
     {
         m_perNodeCache->pushItem(name);
 
-        m_utilityStateChanged = true;
+        setUtilityStateChanged();
     }
 
     string FBCache::popCachableOutputItem() { return m_perNodeCache->popItem(); }
@@ -0,0 +1,563 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/FBDiskCache.h>
+#include <TwkFB/Attribute.h>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#ifndef PLATFORM_WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace IPCore
+{
+    using namespace std;
+    using namespace TwkFB;
+
+    namespace
+    {
+
+        //
+        //  Entries are page aligned in the slab so paging them back in
+        //  never touches a page shared with another entry.
+        //
+
+        const size_t slabAlignment = 4096;
+
+        size_t alignedSize(size_t bytes) { return (bytes + slabAlignment - 1) & ~(slabAlignment - 1); }
+
+        //
+        //  Bytes of fbs waiting for the writer thread
+        //
+
+        const size_t maxQueuedBytes = size_t(256) << 20;
+
+        //
+        //  Tiles and their master buffers reference each other's pixels,
+        //  so they can't be reconstructed from their own planes.
+        //
+
+        bool isProxyBuffer(const FrameBuffer* fb)
+        {
+            return fb->findAttribute("ProxyBuffers") != 0 || fb->findAttribute("ProxyBufferOwnerPtr") != 0;
+        }
+
+    } // namespace
+
+    FBDiskCache::FBDiskCache(const string& directory, size_t bytes)
+        : m_file(-1)
+        , m_data(0)
+        , m_capacity(0)
+        , m_used(0)
+        , m_hits(0)
+        , m_misses(0)
+        , m_queuedBytes(0)
+        , m_writeFlushed(false)
+        , m_stop(false)
+    {
+#ifndef PLATFORM_WINDOWS
+        bytes = bytes & ~(slabAlignment - 1);
+        if (bytes == 0)
+            return;
+
+        ostringstream path;
+        path << directory << "/rv_fbcache_" << getpid() << ".slab";
+        m_path = path.str();
+
+        m_file = open(m_path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+        if (m_file == -1)
+        {
+            cerr << "WARNING: FBDiskCache: cannot create " << m_path << ": " << strerror(errno) << endl;
+            return;
+        }
+
+        //
+        //  Unlink right away, the file lives as long as we keep it open.
+        //
+
+        unlink(m_path.c_str());
+
+        if (ftruncate(m_file, off_t(bytes)) != 0)
+        {
+            cerr << "WARNING: FBDiskCache: cannot reserve " << bytes << " bytes in " << m_path << ": " << strerror(errno) << endl;
+            close(m_file);
+            m_file = -1;
+            return;
+        }
+
+        void* p = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+
+        if (p == MAP_FAILED)
+        {
+            cerr << "WARNING: FBDiskCache: cannot map " << m_path << ": " << strerror(errno) << endl;
+            close(m_file);
+            m_file = -1;
+            return;
+        }
+
+        m_data = (unsigned char*)p;
+        m_capacity = bytes;
+        m_freeExtents[0] = bytes;
+        m_writer = std::thread(&FBDiskCache::writerMain, this);
+#else
+        cerr << "WARNING: FBDiskCache: not supported on this platform" << endl;
+#endif
+    }
+
+    FBDiskCache::~FBDiskCache()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_stop = true;
+        }
+
+        m_queueCond.notify_all();
+
+        if (m_writer.joinable())
+            m_writer.join();
+
+        clear();
+
+#ifndef PLATFORM_WINDOWS
+        if (m_data)
+            munmap(m_data, m_capacity);
+        if (m_file != -1)
+            close(m_file);
+#endif
+    }
+
+    size_t FBDiskCache::used() const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_used;
+    }
+
+    size_t FBDiskCache::hits() const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_hits;
+    }
+
+    size_t FBDiskCache::misses() const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_misses;
+    }
+
+    bool FBDiskCache::contains(const IDString& id) const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        EntryMap::const_iterator i = m_entries.find(id);
+        return i != m_entries.end() && i->second->ready;
+    }
+
+    size_t FBDiskCache::allocate(size_t bytes)
+    {
+        for (ExtentMap::iterator i = m_freeExtents.begin(); i != m_freeExtents.end(); ++i)
+        {
+            if (i->second >= bytes)
+            {
+                size_t offset = i->first;
+                size_t remaining = i->second - bytes;
+
+                m_freeExtents.erase(i);
+                if (remaining)
+                    m_freeExtents[offset + bytes] = remaining;
+
+                m_used += bytes;
+                return offset;
+            }
+        }
+
+        return size_t(-1);
+    }
+
+    void FBDiskCache::release(size_t offset, size_t bytes)
+    {
+        m_used -= bytes;
+
+        ExtentMap::iterator i = m_freeExtents.insert(make_pair(offset, bytes)).first;
+
+        //
+        //  Coalesce with the following and preceding extents
+        //
+
+        ExtentMap::iterator next = i;
+        ++next;
+
+        if (next != m_freeExtents.end() && i->first + i->second == next->first)
+        {
+            i->second += next->second;
+            m_freeExtents.erase(next);
+        }
+
+        if (i != m_freeExtents.begin())
+        {
+            ExtentMap::iterator prev = i;
+            --prev;
+
+            if (prev->first + prev->second == i->first)
+            {
+                prev->second += i->second;
+                m_freeExtents.erase(i);
+            }
+        }
+
+#ifndef PLATFORM_WINDOWS
+        //
+        //  The contents are garbage now, no need to ever write them back.
+        //
+
+        madvise(m_data + offset, bytes, MADV_DONTNEED);
+#endif
+    }
+
+    void FBDiskCache::deleteEntry(Entry* e)
+    {
+        for (size_t q = 0; q < e->planes.size(); q++)
+            delete e->planes[q].attributes;
+
+        release(e->offset, e->size);
+        delete e;
+    }
+
+    void FBDiskCache::removeEntry(EntryMap::iterator i)
+    {
+        Entry* e = i->second;
+
+        m_order.erase(e->order);
+        m_entries.erase(i);
+
+        if (e->busy)
+            e->dead = true;
+        else
+            deleteEntry(e);
+    }
+
+    void FBDiskCache::idle(Entry* e)
+    {
+        if (--e->busy == 0 && e->dead)
+            deleteEntry(e);
+    }
+
+    bool FBDiskCache::evictOne()
+    {
+        //
+        //  Lowest utility first, the oldest of equal ones. Busy entries
+        //  can't go, there are only ever a few of them.
+        //
+
+        for (EvictionOrder::iterator i = m_order.begin(); i != m_order.end(); ++i)
+        {
+            EntryMap::iterator ei = m_entries.find(i->second);
+
+            if (!ei->second->busy)
+            {
+                removeEntry(ei);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool FBDiskCache::isStorable(const FrameBuffer* fb)
+    {
+        if (!fb->isRootPlane() || isProxyBuffer(fb))
+            return false;
+
+        const IDString& id = fb->identifier();
+
+        if (id.empty() || id[0] == '|')
+            return false;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane())
+        {
+            if (isProxyBuffer(p) || (p->allocSize() && !p->pixels<unsigned char>()))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool FBDiskCache::add(FrameBuffer* fb, float utility)
+    {
+        if (!isValid() || !isStorable(fb))
+            return false;
+
+        const size_t bytes = fb->totalImageSize();
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        EntryMap::iterator ei = m_entries.find(fb->identifier());
+
+        if (ei != m_entries.end())
+        {
+            //
+            //  Already in the slab (we paged it in earlier)
+            //
+
+            Entry* e = ei->second;
+            m_order.erase(e->order);
+            e->order = m_order.insert(make_pair(utility, ei->first));
+            return false;
+        }
+
+        //
+        //  The queued fbs are held on top of the FBCache's capacity, so
+        //  only let a few frames wait.
+        //
+
+        if (m_queuedBytes && m_queuedBytes + bytes > maxQueuedBytes)
+            return false;
+
+        for (FBQueue::const_iterator i = m_queue.begin(); i != m_queue.end(); ++i)
+        {
+            if (i->fb->identifier() == fb->identifier())
+                return false;
+        }
+
+        QueuedFB q;
+        q.fb = fb;
+        q.utility = utility;
+        m_queue.push_back(q);
+        m_queuedBytes += bytes;
+        m_queueCond.notify_one();
+        return true;
+    }
+
+    void FBDiskCache::writerMain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true)
+        {
+            m_queueCond.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+
+            if (m_stop)
+                break;
+
+            QueuedFB q = m_queue.front();
+            m_queue.pop_front();
+
+            //
+            //  Out of the queue and not in the slab yet: a flush() of it
+            //  until write() adds its entry only marks it flushed.
+            //
+
+            m_writing = q.fb->identifier();
+            m_writeFlushed = false;
+
+            lock.unlock();
+            write(q.fb, q.utility);
+            const size_t bytes = q.fb->totalImageSize();
+            delete q.fb;
+            lock.lock();
+
+            m_writing.clear();
+            m_queuedBytes -= bytes;
+        }
+    }
+
+    void FBDiskCache::write(FrameBuffer* fb, float utility)
+    {
+        const IDString id = fb->identifier();
+        Entry* e = new Entry;
+        e->size = 0;
+        e->ready = false;
+        e->dead = false;
+        e->busy = 1;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane())
+        {
+            PlaneLayout l;
+            l.coordinateType = p->coordinateType();
+            l.width = p->width();
+            l.height = p->height();
+            l.depth = p->depth();
+            l.numChannels = p->numChannels();
+            l.dataType = p->dataType();
+            l.orientation = p->orientation();
+            l.channelNames = p->channelNames();
+            l.extraScanlines = p->extraScanlines();
+            l.scanlinePixelPadding = p->scanlinePixelPadding();
+            l.uncrop = p->uncrop();
+            l.uncropWidth = p->uncropWidth();
+            l.uncropHeight = p->uncropHeight();
+            l.uncropX = p->uncropX();
+            l.uncropY = p->uncropY();
+            l.offset = e->size;
+            l.size = p->allocSize();
+            l.attributes = new FrameBuffer();
+            p->copyAttributesTo(l.attributes);
+
+            e->planes.push_back(l);
+            e->size += alignedSize(l.size);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+
+            bool stored = !m_writeFlushed && e->size && e->size <= m_capacity && m_entries.find(id) == m_entries.end();
+
+            while (stored && (e->offset = allocate(e->size)) == size_t(-1))
+            {
+                stored = evictOne();
+            }
+
+            if (!stored)
+            {
+                e->busy = 0;
+                e->dead = true;
+                e->size = 0;
+                e->offset = 0;
+            }
+            else
+            {
+                e->order = m_order.insert(make_pair(utility, id));
+                m_entries[id] = e;
+            }
+        }
+
+        if (e->dead)
+        {
+            for (size_t q = 0; q < e->planes.size(); q++)
+                delete e->planes[q].attributes;
+
+            delete e;
+            return;
+        }
+
+        size_t n = 0;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane(), n++)
+        {
+            const PlaneLayout& l = e->planes[n];
+
+            if (l.size)
+                memcpy(m_data + e->offset + l.offset, p->pixels<unsigned char>(), l.size);
+        }
+
+#ifndef PLATFORM_WINDOWS
+        //
+        //  Start writeback now so the dirty pages don't pile up in RAM.
+        //
+
+        msync(m_data + e->offset, e->size, MS_ASYNC);
+#endif
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        e->ready = true;
+        idle(e);
+    }
+
+    FrameBuffer* FBDiskCache::pageIn(const IDString& id)
+    {
+        Entry* e = 0;
+
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            EntryMap::iterator ei = m_entries.find(id);
+
+            if (ei == m_entries.end() || !ei->second->ready)
+            {
+                m_misses++;
+                return 0;
+            }
+
+            //
+            //  Pinned: it can be flushed but not released until we're
+            //  done with it.
+            //
+
+            e = ei->second;
+            e->busy++;
+        }
+
+        FrameBuffer* root = 0;
+
+#ifndef PLATFORM_WINDOWS
+        madvise(m_data + e->offset, e->size, MADV_WILLNEED);
+#endif
+
+        for (size_t q = 0; q < e->planes.size(); q++)
+        {
+            const PlaneLayout& l = e->planes[q];
+
+            FrameBuffer* fb = new FrameBuffer(l.coordinateType, l.width, l.height, l.depth, l.numChannels, l.dataType, 0,
+                                              &l.channelNames, l.orientation, true, l.extraScanlines, l.scanlinePixelPadding);
+
+            if (l.size)
+                memcpy(fb->pixels<unsigned char>(), m_data + e->offset + l.offset, l.size);
+
+            l.attributes->copyAttributesTo(fb);
+            fb->setUncrop(l.uncropWidth, l.uncropHeight, l.uncropX, l.uncropY);
+            fb->setUncropActive(l.uncrop);
+
+            if (root)
+            {
+                root->appendPlane(fb);
+            }
+            else
+            {
+                root = fb;
+                root->setIdentifier(id);
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_hits++;
+        idle(e);
+        return root;
+    }
+
+    void FBDiskCache::flush(const IDString& id)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        EntryMap::iterator ei = m_entries.find(id);
+
+        if (ei != m_entries.end())
+            removeEntry(ei);
+
+        if (m_writing == id)
+            m_writeFlushed = true;
+
+        for (FBQueue::iterator i = m_queue.begin(); i != m_queue.end(); ++i)
+        {
+            if (i->fb->identifier() == id)
+            {
+                m_queuedBytes -= i->fb->totalImageSize();
+                delete i->fb;
+                m_queue.erase(i);
+                break;
+            }
+        }
+    }
+
+    void FBDiskCache::clear()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        while (!m_entries.empty())
+            removeEntry(m_entries.begin());
+
+        if (!m_writing.empty())
+            m_writeFlushed = true;
+
+        for (FBQueue::iterator i = m_queue.begin(); i != m_queue.end(); ++i)
+        {
+            m_queuedBytes -= i->fb->totalImageSize();
+            delete i->fb;
+        }
+
+        m_queue.clear();
+    }
+
+} // namespace IPCore
@@ -25,6 +25,7 @@ namespace IPCore
         virtual ~CacheIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual void flushAllCaches(const FlushContext&);
 
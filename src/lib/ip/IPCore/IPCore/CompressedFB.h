@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__CompressedFB__h__
+#define __IPCore__CompressedFB__h__
+#include <TwkFB/FrameBuffer.h>
+#include <vector>
+
+namespace IPCore
+{
+
+    //
+    //  CompressedFB is a lossless copy of the pixels of all the planes
+    //  of a FrameBuffer. The FBCache keeps one of these for cached fbs
+    //  which are far enough from the display frame that they are not
+    //  going to be needed right away and frees their pixels.
+    //
+    //  Each plane is cut into chunks that are encoded and decoded in
+    //  parallel on the TwkFB thread pool. A chunk is byte-plane shuffled
+    //  (all the first bytes of each channel value, then all the second
+    //  bytes, ...) which groups the well behaved high order bytes of
+    //  half, short and float images together, and then deflated with
+    //  the run-length strategy which is cheap to decode.
+    //
+    //  Only the pixels are stored, the FrameBuffer keeps its structure
+    //  and attributes.
+    //
+
+    class CompressedFB
+    {
+    public:
+        typedef TwkFB::FrameBuffer FrameBuffer;
+
+        ~CompressedFB();
+
+        //
+        //  Returns 0 if the fb can't be compressed or if it wouldn't save
+        //  enough to be worth it.
+        //
+
+        static CompressedFB* compress(const FrameBuffer* fb);
+
+        //
+        //  The planes of fb must have their pixels (see
+        //  FrameBuffer::reallocateData()). Returns false if a chunk
+        //  didn't inflate to its full size, the pixels are then garbage.
+        //
+        //  Neither compress() nor decompress() touch the cache, the
+        //  FBCache calls them without its lock.
+        //
+
+        bool decompress(FrameBuffer* fb) const;
+
+        size_t size() const { return m_size; }
+
+        size_t rawSize() const { return m_rawSize; }
+
+    private:
+        CompressedFB();
+
+        struct Chunk
+        {
+            size_t plane;
+            size_t offset;
+            size_t rawSize;
+            size_t elementSize;
+            bool stored; // bytes are shuffled but not deflated
+            std::vector<unsigned char> bytes;
+        };
+
+        typedef std::vector<Chunk> Chunks;
+
+        static void encode(const unsigned char* in, Chunk& chunk);
+        static bool decode(const Chunk& chunk, unsigned char* out);
+
+        friend class EncodeChunkTask;
+        friend class DecodeChunkTask;
+
+    private:
+        Chunks m_chunks;
+        size_t m_size;
+        size_t m_rawSize;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__CompressedFB__h__
@@ -28,6 +28,7 @@ namespace IPCore
         virtual ~DispTransform2DIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual void propertyChanged(const Property*);
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual Matrix localMatrix(const Context&) const;
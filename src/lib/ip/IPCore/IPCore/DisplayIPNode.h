@@ -9,6 +9,7 @@
 #define __IPCore__DisplayIPNode__h__
 #include <IPCore/IPNode.h>
 #include <IPCore/LUTIPNode.h>
+#include <atomic>
 
 namespace IPCore
 {
@@ -37,8 +38,13 @@ namespace IPCore
         virtual ~DisplayIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual IPImageID* evaluateIdentifier(const Context&);
 
     private:
+        TwkMath::Mat44f channelMatrix() const;
+        Context inputContext(const Context&) const;
+        bool inputsReadAlpha() const;
+
         StringProperty* m_channelOrder;
         IntProperty* m_channelFlood;
         IntProperty* m_premult;
@@ -58,6 +64,13 @@ namespace IPCore
         Vec2fProperty* m_blue;
         Vec2fProperty* m_neutral;
         StringProperty* m_overrideColorspace;
+
+        //
+        //  inputsReadAlpha() as of an IPGraph::stateSerial(): the serial
+        //  times two plus the answer, 0 until it's first asked.
+        //
+
+        mutable std::atomic<size_t> m_inputsReadAlpha;
     };
 
 } // namespace IPCore
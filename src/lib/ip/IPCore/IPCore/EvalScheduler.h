@@ -0,0 +1,159 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__EvalScheduler__h__
+#define __IPCore__EvalScheduler__h__
+#include <IPCore/IPNode.h>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+namespace IPCore
+{
+    class FBCache;
+
+    //
+    //  EvalScheduler spreads the evaluation of a frame over the IPGraph
+    //  eval threads. The thread evaluating a frame pushes one task per
+    //  leaf (CacheIPNode) of the frame onto its own deque and works them
+    //  from the back, while other threads with nothing to do steal from
+    //  the front. Once all the leaves are in the cache the frame itself
+    //  is evaluated as usual and finds them there.
+    //
+    //  Tasks for the display frame go in a separate lane which every
+    //  thread checks before its own deque, so look ahead work gives way
+    //  to the frame on screen at the next task boundary.
+    //
+    //  There is one deque per eval thread, indexed by thread number (0
+    //  is the display thread). The display thread only ever runs tasks
+    //  of the display lane: while it waits for the leaves of its frame
+    //  it helps with those but never picks up look ahead work.
+    //
+
+    class EvalScheduler
+    {
+    public:
+        //
+        //  Counts the outstanding tasks of one frame
+        //
+
+        class Group
+        {
+        public:
+            Group();
+            ~Group();
+
+            void add(size_t n);
+            void done(bool ok);
+
+            //
+            //  Blocks until all the tasks are done
+            //
+
+            void wait();
+
+            bool finished() const;
+
+            bool failed() const { return m_failed; }
+
+        private:
+            mutable pthread_mutex_t m_mutex;
+            pthread_cond_t m_cond;
+            size_t m_pending;
+            bool m_failed;
+        };
+
+        struct Task
+        {
+            Task(IPNode* n, const IPNode::Context& c, Group* g)
+                : node(n)
+                , context(c)
+                , group(g)
+            {
+            }
+
+            IPNode* node;
+            IPNode::Context context;
+            Group* group;
+        };
+
+        EvalScheduler(FBCache&);
+        ~EvalScheduler();
+
+        //
+        //  Must not be called while tasks are queued
+        //
+
+        void setNumQueues(size_t n);
+
+        size_t numQueues() const { return m_queues.size(); }
+
+        void push(size_t queue, Task*);
+        void pushPriority(Task*);
+
+        //
+        //  The next task for the thread owning queue: the display lane
+        //  first, then the newest task of its own deque, then the
+        //  oldest task of another deque. Returns 0 if there's nothing.
+        //
+
+        Task* next(size_t queue);
+
+        //
+        //  The next task of the display lane, 0 if there's none
+        //
+
+        Task* nextPriority();
+
+        bool hasPriorityWork() const { return m_numPriority > 0; }
+
+        bool hasWork() const { return m_numTasks > 0 || m_numPriority > 0; }
+
+        //
+        //  Evaluates the task as thread type on the thread owning queue,
+        //  puts the images in the cache and deletes the task.
+        //
+
+        void run(Task*, size_t queue, IPNode::ThreadType type);
+
+        //
+        //  Run tasks until all of group's are done. On the display
+        //  thread (queue 0) only display lane tasks are run.
+        //
+
+        void complete(Group&, size_t queue, IPNode::ThreadType type);
+
+        size_t tasksRun() const { return m_tasksRun; }
+
+        size_t tasksStolen() const { return m_tasksStolen; }
+
+    private:
+        struct Queue
+        {
+            Queue() { pthread_mutex_init(&mutex, 0); }
+
+            ~Queue() { pthread_mutex_destroy(&mutex); }
+
+            pthread_mutex_t mutex;
+            std::deque<Task*> tasks;
+        };
+
+        Task* popBack(Queue&);
+        Task* popFront(Queue&);
+
+    private:
+        FBCache& m_cache;
+        std::vector<Queue*> m_queues;
+        Queue m_priority;
+        std::atomic<size_t> m_numTasks;
+        std::atomic<size_t> m_numPriority;
+        std::atomic<size_t> m_tasksRun;
+        std::atomic<size_t> m_tasksStolen;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__EvalScheduler__h__
@@ -10,6 +10,7 @@
 #include <TwkFB/Cache.h>
 #include <set>
 #include <map>
+#include <unordered_map>
 
 namespace IPCore
 {
@@ -28,6 +29,10 @@ namespace IPCore
     //
 
     class PerNodeCache;
+    class FrameIndex;
+    class FBDiskCache;
+    class CompressedFB;
+    class CostModel;
 
     class FBCache : public TwkFB::Cache
     {
@@ -35,11 +40,8 @@ namespace IPCore
         typedef TwkFB::FrameBuffer FrameBuffer;
         typedef std::vector<FrameBuffer*> FBVector;
         typedef FrameBuffer::DataType DataType;
-        typedef std::set<int> FrameSet;
-        typedef std::map<FrameBuffer*, FrameSet> ItemFrames;
         typedef std::vector<int> FrameVector;
         typedef std::set<std::string> IDSet;
-        typedef std::map<int, IDSet> FrameMap;
         typedef std::map<size_t, FBVector> FreeLists;
         typedef std::vector<std::string> IDStringVector;
         typedef std::vector<IDStringVector> IDTree;
@@ -62,6 +64,42 @@ namespace IPCore
             HasNoIDs    /// None of the ids are in the cache
         };
 
+        struct SourceCost
+        {
+            std::string source; /// source node name
+            float seconds;      /// average evaluation time per frame
+            float bytes;        /// average bytes cached per frame
+            size_t samples;     /// number of evaluations measured
+
+            SourceCost()
+                : seconds(0.0)
+                , bytes(0.0)
+                , samples(0)
+            {
+            }
+        };
+
+        typedef std::vector<SourceCost> SourceCostVector;
+
+        struct SourceUsage
+        {
+            std::string source; /// source node name
+            size_t used;        /// bytes of items held for frames
+            size_t quota;       /// 0 if the source has no quota
+            size_t fairShare;   /// weighted share of the capacity
+            float weight;       /// fair share weight
+
+            SourceUsage()
+                : used(0)
+                , quota(0)
+                , fairShare(0)
+                , weight(1.0)
+            {
+            }
+        };
+
+        typedef std::vector<SourceUsage> SourceUsageVector;
+
         struct CacheStats
         {
             size_t capacity;               /// as returned by capacity() function
@@ -69,11 +107,33 @@ namespace IPCore
             float lookAheadSeconds;        /// as returned by
                                            /// computeLookAheadSecondsStat()
             FrameRangeVector cachedRanges; /// as returned by computeCachedRangesStat()
+            size_t diskCapacity;           /// capacity of the disk tier (0 if none)
+            size_t diskUsed;               /// bytes held by the disk tier
+            size_t diskHits;               /// fbs paged in from the disk tier
+            size_t diskMisses;             /// lookups the disk tier couldn't satisfy
+            size_t compressedUsed;         /// bytes of used() held compressed
+            size_t compressedRaw;          /// uncompressed size of the above
+            SourceCostVector sourceCosts;  /// measured cost of each source
+            float meanFrameSeconds;        /// average evaluation time of a frame
+            float meanFrameBytes;          /// average bytes cached for a frame
+            SourceUsageVector sourceUsage; /// per source quotas and usage
+            size_t prefetchRequested;      /// predicted scrub frames cached
+            size_t prefetchHits;           /// of those, frames later displayed
 
             CacheStats()
                 : capacity(0)
                 , used(0)
                 , lookAheadSeconds(0.0)
+                , diskCapacity(0)
+                , diskUsed(0)
+                , diskHits(0)
+                , diskMisses(0)
+                , compressedUsed(0)
+                , compressedRaw(0)
+                , meanFrameSeconds(0.0)
+                , meanFrameBytes(0.0)
+                , prefetchRequested(0)
+                , prefetchHits(0)
             {
             }
         };
@@ -104,22 +164,186 @@ namespace IPCore
         //  These functions require calling lock() and unlock() before
         //  calling them.
         //
-        //  frameItems() is a bit complicated. It returns true if all
-        //  items for the frame are in the cache. In addition, it fills
-        //  the passed in FBVector with items that are actually in the
-        //  cache. It does not tell you how many items were missing.
-        //
 
-        bool add(FrameBuffer*, int frame, bool force = false, const IPNode* node = 0);
+        bool add(FrameBuffer*, int frame, bool force = false, const IPNode* node = 0, const std::string& source = std::string());
         bool flush(const IDString&);
         bool flushIDSetSubstr(const IDSet& subStrings);
 
-        bool frameItems(int frame, FBVector& items) const;
+        //
+        //  Disk tier. When enabled, fbs freed to make room are written
+        //  to a slab file in directory (at most bytes of it) and paged
+        //  back in by pageIn() instead of being evaluated again. The
+        //  RV_DISK_CACHE_DIR and RV_DISK_CACHE_SIZE (in MB) environment
+        //  variables enable it at startup. A directory of "" or 0 bytes
+        //  disables it.
+        //
+        //  pageIn() returns true if id was not in the cache but was
+        //  found in the disk tier and added back to the cache. frame is
+        //  the frame being evaluated. It locks the cache itself, only
+        //  for the lookups, so call it WITHOUT the cache lock: the copy
+        //  out of the disk tier is made without it. pageInFrame() does
+        //  the same for every id of idTree. flushDiskCache() discards
+        //  the disk copy of id, call it when the source of id changes on
+        //  disk.
+        //
+
+        void setDiskCache(const std::string& directory, size_t bytes);
+
+        bool hasDiskCache() const { return m_diskCache != 0; }
+
+        bool pageIn(const IDString& id, int frame);
+        void pageInFrame(int frame, IPImageID* idTree);
+        void flushDiskCache(const IDString& id);
+
+        //
+        //  Compressed residency. When enabled, instead of freeing frames
+        //  to make room, the cache first compresses (losslessly) the
+        //  items of the least useful frames outside of the play window
+        //  (the frames about to be displayed). Compressed items stay in
+        //  the cache and are decompressed by checkOut(). The
+        //  RV_CACHE_COMPRESSION environment variable enables it at
+        //  startup and RV_CACHE_COMPRESSION_WINDOW sets the play window
+        //  in frames (by default one second at the display fps).
+        //
+        //  The encoding and decoding are done without the cache lock:
+        //  compressAhead() makes room for bytes more by compressing
+        //  before they're added and expand() decompresses the item with
+        //  id before it's checked out. Like pageIn() call them WITHOUT
+        //  the cache lock. The items being worked on are checked out
+        //  meanwhile, a checkOut() of an item being expanded waits for
+        //  it. checkOut() still decompresses under the lock what wasn't
+        //  expanded beforehand.
+        //
+
+        void setCompressionEnabled(bool b);
+
+        size_t compressAhead(size_t bytes);
+        void expand(const IDString& id);
+
+        bool compressionEnabled() const { return m_compressionEnabled; }
+
+        void setCompressionWindow(int frames) { m_compressionWindow = frames; }
+
+        //
+        //  Same as TwkFB::Cache::checkOut() but the fb is decompressed
+        //  first if it's held compressed. An item that fails to
+        //  decompress is dropped from the cache: checkOut(id) misses and
+        //  checkOut(fb) throws. Checking out changes the
+        //  item's reference count and its place in the LRU so, unlike
+        //  isFrameCached(), it still requires the cache lock. The
+        //  display thread pins the items of a cached frame instead and
+        //  only checks out when some are missing or compressed.
+        //
+
+        FrameBuffer* checkOut(const IDString&);
+        void checkOut(FrameBuffer*);
+
+        //
+        //  Cost model. CacheIPNodes report how long it took to evaluate
+        //  the images of their source at a frame and how many bytes that
+        //  produced. When cost aware caching is on (the default,
+        //  RV_CACHE_COST_AWARE=0 turns it off) utility() scales frame
+        //  distance by the relative cost of the frame: expensive frames
+        //  are cached sooner and frames cheap to make again per byte are
+        //  freed first. While playing, frames ahead are also ranked by
+        //  their slack rather than their distance: the distance less the
+        //  frames played while one of them is evaluated, so a frame that
+        //  would miss its deadline if started later is cached first.
+        //
+
+        void recordEvaluation(const std::string& source, int frame, double seconds, size_t bytes);
+
+        void setCostAwareCaching(bool b) { m_costAwareCaching = b; }
+
+        bool costAwareCaching() const { return m_costAwareCaching; }
+
+        //
+        //  Per source accounting. add() is told which source node an fb
+        //  came from and the bytes of the items a source holds for
+        //  frames are counted against it.
+        //
+        //  A source with a quota (in decoded bytes, 0 for none) frees
+        //  its own items from the frames it needs least to stay under
+        //  it, so it can't push the items of other sources out.
+        //  reserveForSource() does that before an item of source is
+        //  added at frame and returns false if the item should not be
+        //  cached (the frame is then cached without it). Frames left out
+        //  like this are not picked as cache targets again until the
+        //  quota changes or the source's usage goes down.
+        //
+        //  With fair share caching on (RV_CACHE_FAIR_SHARE), each source
+        //  is entitled to a part of the capacity in proportion to its
+        //  weight (1 by default) among the sources holding items. When
+        //  room is needed, sources over their share give up their items
+        //  first, and frames holding them are freed sooner.
+        //
+
+        bool reserveForSource(const std::string& source, size_t bytes, int frame);
+
+        void setSourceQuota(const std::string& source, size_t bytes);
+        void setSourceWeight(const std::string& source, float weight);
 
-        bool isFrameCached(int frame) const { return m_frames.find(frame) != m_frames.end(); }
+        void setFairShareCaching(bool b) { m_fairShareCaching = b; }
+
+        bool fairShareCaching() const { return m_fairShareCaching; }
+
+        //
+        //  Frames the display is predicted to show next while scrubbing,
+        //  most likely first. While predicted, the frame of rank r is
+        //  worth as much as the frame r + 1 frames ahead of the display
+        //  frame, for caching and freeing alike, so predictions are
+        //  interleaved with the start of the look ahead window. They're
+        //  cached each on its own, so sparse predictions don't pull in
+        //  the frames between them. A predicted frame that was cached and
+        //  then displayed counts as a prefetch hit in the stats
+        //  (prefetchRequested and prefetchHits, prefetchCacheInfo() in
+        //  Mu and Python). Turned off with RV_CACHE_SCRUB_PREFETCH=0.
+        //  Requires the cache lock.
+        //
+
+        void setPrefetchFrames(const std::vector<int>& frames);
+
+        void setScrubPrefetch(bool b) { m_scrubPrefetch = b; }
+
+        bool scrubPrefetch() const { return m_scrubPrefetch; }
 
         bool hasPartialFrameCache(int frame) const;
 
+        //
+        //  isFrameCached() does NOT require the cache lock. It only
+        //  takes a reader lock on the part of the frame index that holds
+        //  the frame, so the display thread never waits on caching
+        //  threads to find out if a frame is cached.
+        //
+        //  frameItems() returns true if the frame has items in the
+        //  cache, and fills the passed in FBVector with them. It takes
+        //  the same reader lock but the items are only referenced by the
+        //  frame: a caching thread can free the frame (and delete them)
+        //  as soon as it returns. Call it with the cache lock held.
+        //
+        //  pinFrameItems() is the version for the display thread: it
+        //  doesn't require the cache lock. It pins the items under the
+        //  reader lock, so they're neither deleted nor compressed until
+        //  unpinItems() is called. Items held compressed can't be pinned
+        //  and are left out. Returns true if it pinned any.
+        //
+
+        bool frameItems(int frame, FBVector& items) const;
+        bool pinFrameItems(int frame, FBVector& items) const;
+        static void unpinItems(const FBVector& items);
+
+        //
+        //  If all the given ids are already cached in the low-level fb
+        //  cache, add them to the frame-level caches, so that the
+        //  "frame" is now cached. Requires the cache lock. Ids held by
+        //  the disk tier count as missing: page them in first with
+        //  pageInFrame(), without the lock.
+        //
+
+        bool promoteFrame(int frame, IPImageID* idTree);
+
+        bool isFrameCached(int frame) const;
+
         TreeResults testInCache(const IDTree&);
 
         void setCacheFrame(int f) { m_cacheFrame = f; }
@@ -247,6 +471,19 @@ namespace IPCore
         void initCacheFreePair(int cacheFrame, int freeFrame);
 
         void dereferenceFrame(int frame, FrameBuffer* fb);
+
+        virtual bool aboutToDeleteFB(FrameBuffer* fb);
+        virtual size_t cachedSize(const FrameBuffer* fb) const;
+        virtual void forgetFB(FrameBuffer* fb);
+
+        bool inPlayWindow(int frame) const;
+        bool isCompressible(FrameBuffer* fb, size_t pins);
+        size_t commitCompressed(FrameBuffer* fb, CompressedFB* c);
+        bool finishExpand(FrameBuffer* fb, bool ok);
+        void noteLastFrameOfItem(const FrameBuffer* fb, int frame);
+        bool expandItem(FrameBuffer* fb);
+        void dropItem(const IDString& id);
+
         //
         //  These 3 methods can alter the utility values, so if you call
         //  them you may need to wake up sleeping caching threads.
@@ -264,7 +501,7 @@ namespace IPCore
         virtual void clearInternal();
         virtual bool free(size_t bytes);
         virtual bool freeInternal(size_t bytes, bool freeMemory = true);
-        bool freeIDSet(const IDSet&, int frame);
+        bool freeFrame(int frame);
         bool freeInRangeForwards(size_t, FrameVector&, int, int, bool);
         bool freeInRangeBackwards(size_t, FrameVector&, int, int, bool);
         void setCacheStatsDirty();
@@ -283,6 +520,10 @@ namespace IPCore
         };
 
         float utility(int frames, UtilityMode mode);
+        float costFactor(int frame, UtilityMode mode) const;
+        float deadlineLead(int frame, UtilityMode mode) const;
+        float prefetchUtility(int frame, UtilityMode mode) const;
+        float forwardWeight(UtilityMode mode) const;
 
         int cachedFrameOfLesserUtility(int frame);
 
@@ -290,10 +531,60 @@ namespace IPCore
 
         bool utilityStateChanged() const { return m_utilityStateChanged; };
 
+        void setUtilityStateChanged()
+        {
+            m_utilityStateChanged = true;
+            m_utilityEpoch++;
+        }
+
         void resetUtilityState() { m_utilityStateChanged = false; };
 
         void considerFrameForFreeing(int f, int& targetFrame, float& targetUtility);
 
+        //
+        //  Each source keeps the frames holding its items ordered by
+        //  their utility for freeing, so freeSourceItems() doesn't sort
+        //  the whole frame index on every add. Frames come and go from
+        //  the order as their items do, the order is rebuilt when the
+        //  utilities move (m_utilityEpoch).
+        //
+
+        typedef std::multimap<float, int> FrameOrder;
+
+        struct SourceAccount
+        {
+            size_t used;
+            size_t quota;
+            float weight;
+            std::set<int> leftOut;                        // frames cached without its item
+            std::map<int, int> frames;                    // frame -> number of its items
+            FrameOrder order;                             // frames by utility, as of orderEpoch
+            std::map<int, FrameOrder::iterator> orderOf; // frame -> its place in order
+            size_t orderEpoch;
+
+            SourceAccount()
+                : used(0)
+                , quota(0)
+                , weight(1.0)
+                , orderEpoch(0)
+            {
+            }
+        };
+
+        typedef std::map<std::string, SourceAccount> SourceAccountMap;
+
+        void attributeItem(const FrameBuffer* fb, const std::string& source);
+        void noteItemReferenced(const FrameBuffer* fb);
+        void noteItemUnreferenced(const FrameBuffer* fb);
+        void noteFrameItem(int frame, const FrameBuffer* fb, bool added);
+        void updateFrameOrder(SourceAccount& account);
+        bool leftOutForQuota(int frame) const;
+        size_t sourceFairShare(const std::string& source) const;
+        float sourcePressure(const std::string& source) const;
+        float framePressure(int frame) const;
+        size_t freeSourceItems(const std::string& source, size_t bytes, int excludeFrame, float maxUtility);
+        void freeOverShareSources(size_t bytes);
+
         float lookBehindFraction() { return m_lookBehindFraction; };
 
         void setLookBehindFraction(float f);
@@ -308,14 +599,7 @@ namespace IPCore
 
         void enableActiveTailCaching(const bool enable);
 
-        //
-        //  If all the given ids are already cached in the low-level fb
-        //  cache, add them to the frame-level caches, so that the
-        //  "frame" is now cached.
-        //
-        bool promoteFrame(int frame, IPImageID* idTree);
-
-        int framesInItemMap(FrameBuffer* fb) { return ((m_itemMap.find(fb) != m_itemMap.end()) ? m_itemMap[fb].size() : 0); }
+        int framesInItemMap(FrameBuffer* fb) const;
 
         //
         //  Check metadata of both frame and fb caches and error if any
@@ -325,8 +609,7 @@ namespace IPCore
 
     private:
         IPGraph* m_graph;
-        FrameMap m_frames;
-        ItemFrames m_itemMap;
+        FrameIndex* m_frameIndex;
         int m_cacheFrame;
         int m_cacheWrapFrame;
         int m_displayFrame;
@@ -340,9 +623,10 @@ namespace IPCore
         CacheStats m_cacheStats;
         mutable pthread_mutex_t m_statMutex;
         size_t m_overflowBoundary;
-        std::map<int, int> m_framesBeingCached;
+        std::unordered_map<int, int> m_framesBeingCached; // caching threads only, cache lock
         std::set<int> m_framesScheduledForFreeing;
         bool m_utilityStateChanged;
+        size_t m_utilityEpoch;
         float m_targetCacheFrameUtility;
         CacheEdges* m_cacheEdges;
         PerNodeCache* m_perNodeCache;
@@ -350,6 +634,26 @@ namespace IPCore
         bool m_activeTailCachingEnabled;
         bool m_cacheStatsDisabled;
         bool m_cacheStatsDirty;
+        FBDiskCache* m_diskCache;
+        std::map<const FrameBuffer*, int> m_lastFrameOfItem; // for the disk tier
+        bool m_compressionEnabled;
+        int m_compressionWindow;
+        std::map<const FrameBuffer*, CompressedFB*> m_compressed;
+        std::set<const FrameBuffer*> m_incompressible;
+        std::set<const FrameBuffer*> m_expanding;
+        pthread_cond_t m_expandCond;
+        size_t m_compressedBytes;
+        size_t m_compressedRawBytes;
+        CostModel* m_costModel;
+        bool m_costAwareCaching;
+        SourceAccountMap m_sourceAccounts;
+        std::map<const FrameBuffer*, std::string> m_itemSources;
+        bool m_fairShareCaching;
+        bool m_scrubPrefetch;
+        std::map<int, int> m_prefetchRanks;
+        std::set<int> m_prefetchedFrames;
+        size_t m_prefetchRequested;
+        size_t m_prefetchHits;
 
         static bool m_cacheOutsideRegion;
 
@@ -357,6 +661,7 @@ namespace IPCore
         friend class CacheEdges;
         friend class CheckInEach;
         friend class PerNodeCache;
+        friend class FrameIndex;
     };
 
 } // namespace IPCore
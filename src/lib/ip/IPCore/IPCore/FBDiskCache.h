@@ -0,0 +1,185 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__FBDiskCache__h__
+#define __IPCore__FBDiskCache__h__
+#include <TwkFB/FrameBuffer.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace IPCore
+{
+
+    //
+    //  FBDiskCache is the optional second tier under the FBCache. When
+    //  the FBCache frees an unreferenced FrameBuffer to make room, the
+    //  raw planes are copied into a memory-mapped slab file (usually on
+    //  a local SSD) keyed by the FrameBuffer's identifier. The next time
+    //  that identifier is requested the planes are paged back in instead
+    //  of being decoded again.
+    //
+    //  The slab file is created in the given directory and unlinked
+    //  immediately, so it goes away when the process exits.
+    //
+    //  When the slab is full, entries are evicted in order of the
+    //  FBCache utility of the frame that last used them, lowest first.
+    //  The utility is the one the FBCache had when it evicted the fb
+    //  from memory: the writer thread can't call into the FBCache.
+    //
+    //  The FBDiskCache has its own lock and none of its functions need
+    //  the FBCache lock. Frames are never copied with either lock held:
+    //  add() hands the fb over to a writer thread which copies it into
+    //  the slab and pageIn() copies an entry out after pinning it.
+    //
+
+    class FBDiskCache
+    {
+    public:
+        typedef TwkFB::FrameBuffer FrameBuffer;
+        typedef std::string IDString;
+
+        FBDiskCache(const std::string& directory, size_t bytes);
+        ~FBDiskCache();
+
+        //
+        //  False if the slab file could not be created or mapped. In that
+        //  case the FBDiskCache never holds anything.
+        //
+
+        bool isValid() const { return m_data != 0; }
+
+        size_t capacity() const { return m_capacity; }
+
+        size_t used() const;
+        size_t hits() const;
+        size_t misses() const;
+
+        //
+        //  True if id has been written to the slab.
+        //
+
+        bool contains(const IDString& id) const;
+
+        //
+        //  False if the fb can never be stored (a proxy/tile buffer,
+        //  a plane, no identifier or no pixels).
+        //
+
+        static bool isStorable(const FrameBuffer* fb);
+
+        //
+        //  Takes the fb over and queues it for the writer thread, which
+        //  copies its planes into the slab and deletes it. utility is
+        //  the FBCache utility (for freeing) of the last frame which used
+        //  the fb, it orders eviction. Returns false (the caller keeps
+        //  the fb) if it's not storable, already stored or queued, or too
+        //  many bytes are waiting to be written. An fb already stored
+        //  takes the new utility.
+        //
+
+        bool add(FrameBuffer* fb, float utility);
+
+        //
+        //  Returns a new FrameBuffer with the contents stored for id or 0
+        //  if there is none. The entry stays in the slab so evicting the
+        //  fb again costs nothing.
+        //
+
+        FrameBuffer* pageIn(const IDString& id);
+
+        void flush(const IDString& id);
+        void clear();
+
+    private:
+        struct PlaneLayout
+        {
+            FrameBuffer::CoordinateTypes coordinateType;
+            int width;
+            int height;
+            int depth;
+            int numChannels;
+            FrameBuffer::DataType dataType;
+            FrameBuffer::Orientation orientation;
+            FrameBuffer::StringVector channelNames;
+            int extraScanlines;
+            int scanlinePixelPadding;
+            bool uncrop;
+            int uncropWidth;
+            int uncropHeight;
+            int uncropX;
+            int uncropY;
+            size_t offset; // relative to the entry
+            size_t size;
+            FrameBuffer* attributes; // pixel-less holder of the plane's attributes
+        };
+
+        typedef std::vector<PlaneLayout> PlaneLayouts;
+        typedef std::multimap<float, IDString> EvictionOrder;
+
+        //
+        //  An entry is busy while the writer fills it in or a pageIn()
+        //  copies it out. A busy entry which is flushed is only marked
+        //  dead, whoever makes it idle deletes it.
+        //
+
+        struct Entry
+        {
+            size_t offset;
+            size_t size;
+            PlaneLayouts planes;
+            bool ready;
+            bool dead;
+            int busy;
+            EvictionOrder::iterator order;
+        };
+
+        struct QueuedFB
+        {
+            FrameBuffer* fb;
+            float utility;
+        };
+
+        typedef std::map<IDString, Entry*> EntryMap;
+        typedef std::map<size_t, size_t> ExtentMap;
+        typedef std::deque<QueuedFB> FBQueue;
+
+        size_t allocate(size_t bytes);
+        void release(size_t offset, size_t bytes);
+        bool evictOne();
+        void removeEntry(EntryMap::iterator);
+        void idle(Entry*);
+        void deleteEntry(Entry*);
+        void writerMain();
+        void write(FrameBuffer* fb, float utility);
+
+    private:
+        std::string m_path;
+        int m_file;
+        unsigned char* m_data;
+        size_t m_capacity;
+        size_t m_used;
+        size_t m_hits;
+        size_t m_misses;
+        EntryMap m_entries;
+        EvictionOrder m_order;
+        ExtentMap m_freeExtents;
+        FBQueue m_queue;
+        size_t m_queuedBytes;
+        IDString m_writing;  // id the writer is copying
+        bool m_writeFlushed; // m_writing was flushed meanwhile
+        bool m_stop;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_queueCond;
+        std::thread m_writer;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__FBDiskCache__h__
@@ -139,6 +139,7 @@ namespace IPCore
         virtual bool isMediaActive() const;
         virtual void setMediaActive(bool state);
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual void metaEvaluate(const Context&, MetaEvalVisitor&);
         virtual void visitRecursive(NodeVisitor&);
@@ -12,6 +12,7 @@
 #include <IPCore/IPNode.h>
 #include <IPCore/FBCache.h>
 #include <IPCore/IPProperty.h>
+#include <IPCore/ScrubPredictor.h>
 #include <TwkAudio/AudioCache.h>
 #include <TwkContainer/PropertyContainer.h>
 #include <stl_ext/thread_group.h>
@@ -38,6 +39,7 @@ namespace IPCore
 {
     class AudioTextureIPNode;
     class CacheIPNode;
+    class EvalScheduler;
     class DisplayGroupIPNode;
     class ViewGroupIPNode;
     class DispTransform2DIPNode;
@@ -182,6 +184,15 @@ namespace IPCore
         // graph
         NodeSignal& nodeWillRemoveSignal() { return m_nodeWillRemoveSignal; }
 
+        //
+        //  Bumped whenever a node is added or removed, a node's inputs
+        //  change or a property is changed, created or deleted. A node
+        //  caching something it found by walking its inputs can keep it
+        //  while this stays the same.
+        //
+
+        size_t stateSerial() const { return m_stateSerial; }
+
         //
         //  Work Items
         //
@@ -397,6 +408,17 @@ namespace IPCore
 
         CachingMode cachingMode() const { return m_cacheMode; }
 
+        //
+        //  Set by the session before each display evaluation. While
+        //  scrubbing (not playing) the display frames feed a
+        //  ScrubPredictor whose predictions are handed to the cache as
+        //  prefetch frames.
+        //
+
+        void setScrubbing(bool b) { m_scrubbing = b; }
+
+        bool isScrubbing() const { return m_scrubbing; }
+
         bool isCacheThreadRunning() const;
 
         FBCache& cache() { return m_fbcache; }
@@ -760,6 +782,31 @@ namespace IPCore
 
         void awakenAllCachingThreads();
 
+        //
+        //  Evaluates the leaves (CacheIPNodes) of frame as separate tasks
+        //  shared with the other eval threads so the frame's evaluation
+        //  that follows finds them in the cache. Thread 0 (display) tasks
+        //  go in the priority lane.
+        //
+
+        void evaluateLeavesInParallel(int frame, IPNode::ThreadType thread, size_t id);
+        void awakenCachingThreadsForDisplay();
+
+        //
+        //  Accumulates how long the display thread spent evaluating
+        //  frames the look ahead hadn't cached (printed with
+        //  TWK_CACHE_TIMING_OUTPUT)
+        //
+
+        void reportDisplayEvalLatency(int frame, double seconds);
+
+        //
+        //  Feeds a new display frame to the scrub predictor and passes
+        //  its prediction to the cache. Requires the cache lock.
+        //
+
+        void updateScrubPrefetch(int frame);
+
         void promoteFBsInFrameRange(int beg, int mid, int end, TwkUtil::Timer t);
 
         void setPhysicalDevicesInternal(const VideoModules&);
@@ -807,7 +854,7 @@ namespace IPCore
         bool m_cacheStop;
         ThreadDataVector m_threadData;
         ThreadGroup* m_threadGroup;
-        ThreadGroup* m_threadGroupSingle;
+        ThreadGroup* m_threadGroupSlow;
         mutable pthread_mutex_t m_internalLock;
         mutable pthread_mutex_t m_dispatchLock;
         const IPNode::AudioContext* m_audioRequestContext;
@@ -839,6 +886,7 @@ namespace IPCore
         bool m_frameCacheInvalid;
         bool m_postFirstEval;
         bool m_topologyChanged;
+        std::atomic<size_t> m_stateSerial;
         bool m_cacheTimingOutput;
         AudioConfiguration m_lastAudioConfiguration;
         Timer m_timer;
@@ -849,6 +897,7 @@ namespace IPCore
         static size_t m_minCacheSize;
         static bool m_debugTreeOutput;
         static int m_maxCacheGroupSize;
+        static int m_slowMediaThreads;
         const TwkApp::VideoDevice* m_controlDevice;
         const TwkApp::VideoDevice* m_outputDevice;
         NodeSignal m_newNodeSignal;
@@ -867,6 +916,14 @@ namespace IPCore
         VoidSignal m_mediaLoadingSetEmptySignal;
         NodeSignal m_nodeWillRemoveSignal;
         std::atomic_bool m_evalSlowMedia;
+        EvalScheduler* m_evalScheduler;
+        bool m_parallelLeafEval;
+        size_t m_displayEvalFrames;
+        double m_displayEvalSeconds;
+        double m_displayEvalMaxSeconds;
+        bool m_scrubbing;
+        ScrubPredictor m_scrubPredictor;
+        std::vector<int> m_scrubFrames;
         void* m_jobDispatcher; // opaque pointer SGC::JobDispatcher
         std::atomic_bool m_clearAudioCacheRequested;
 
@@ -57,6 +57,12 @@ namespace IPCore
 
         bool isActive() const;
 
+        //
+        //  The shader source is opaque to us so assume it uses alpha
+        //
+
+        virtual bool readsInputAlpha() const { return isActive(); }
+
     protected:
         void init();
 
@@ -297,6 +297,8 @@ namespace IPCore
                                                  /// stereo eval.
             size_t eye;                          /// request a specific eye (0=left, 1=right, 2=whatever)
             ImageComponent component;            /// defaults to NoComponent
+            StringVector consumedChannels;       /// if not empty the only source channels used
+                                                 /// downstream (set by channel maps)
         };
 
         typedef Context FlushContext;
@@ -342,6 +344,7 @@ namespace IPCore
 
             void operator()(IPImageID* i)
             {
+                c.cache.flushDiskCache(i->id);
                 c.cache.flush(i->id);
                 //
                 //  The above will flush frame related structures, but
@@ -360,10 +363,21 @@ namespace IPCore
         {
             TestEvaluationResult()
                 : poorRandomAccessPerformance(false)
+                , framesSinceKeyframe(-1)
+                , framesToKeyframe(-1)
             {
             }
 
             bool poorRandomAccessPerformance;
+
+            //
+            //  Distance from the frame to the keyframe at or before it
+            //  and to the next one in media with poor random access, -1
+            //  if unknown.
+            //
+
+            int framesSinceKeyframe;
+            int framesToKeyframe;
         };
 
         //
@@ -706,6 +720,17 @@ namespace IPCore
 
         virtual IPImageID* evaluateIdentifier(const Context&);
 
+        //
+        //  True if the node's output color depends on its inputs' alpha
+        //  (compositing, premultiplying, etc). Nodes downstream use this
+        //  to decide if sources can skip decoding alpha (see
+        //  Context::consumedChannels). Any node might, so only nodes
+        //  known not to (color corrections, transforms, groups, sources)
+        //  return false.
+        //
+
+        virtual bool readsInputAlpha() const { return true; }
+
         //
         //  If the node applies transforms hasTransforms() should return
         //  true. Incorrectly reporting the transform will result in a big
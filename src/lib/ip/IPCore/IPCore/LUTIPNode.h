@@ -51,6 +51,7 @@ namespace IPCore
         virtual void writeCompleted();
         virtual void readCompleted(const std::string&, unsigned int);
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
 
     protected:
         void generate3DLUT();
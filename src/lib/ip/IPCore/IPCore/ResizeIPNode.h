@@ -29,6 +29,7 @@ namespace IPCore
 
         virtual ~ResizeIPNode();
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual ImageStructureInfo imageStructureInfo(const Context&) const;
 
         bool isActive();
@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__ScrubPredictor__h__
+#define __IPCore__ScrubPredictor__h__
+#include <TwkUtil/Timer.h>
+#include <deque>
+#include <vector>
+
+namespace IPCore
+{
+
+    //
+    //  ScrubPredictor guesses which frames will be displayed next while
+    //  the user drags the time slider. It is given each new display
+    //  frame and keeps the ones from the last window seconds.
+    //
+    //  The step between display frames grows with the speed of the
+    //  drag (frames in between are never shown), so the predicted
+    //  frames are spaced by the typical recent step: a fast drag gets
+    //  every Nth frame ahead of it instead of the next few. When the
+    //  drag keeps changing direction frames on both sides are
+    //  predicted.
+    //
+
+    class ScrubPredictor
+    {
+    public:
+        ScrubPredictor(size_t maxFrames = 32, double window = 0.5, double horizon = 0.5);
+
+        void addSample(int frame);
+
+        void reset();
+
+        //
+        //  Signed, in frames per second over the window
+        //
+
+        float velocity() const;
+
+        //
+        //  Fills frames with the predicted frames in [minFrame, maxFrame)
+        //  most likely first. Returns the direction of the drag (1 or
+        //  -1) or 0 if it has none or goes both ways.
+        //
+
+        int predict(int minFrame, int maxFrame, std::vector<int>& frames) const;
+
+    private:
+        struct Sample
+        {
+            int frame;
+            double time;
+        };
+
+        typedef std::deque<Sample> Samples;
+
+        int stride() const;
+
+    private:
+        Samples m_samples;
+        TwkUtil::Timer m_timer;
+        size_t m_maxFrames;
+        double m_window;
+        double m_horizon;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__ScrubPredictor__h__
@@ -279,13 +279,7 @@ namespace IPCore
         {
             Time audioSecondsCached;
 
-            void operator=(const FBCache::CacheStats& s)
-            {
-                capacity = s.capacity;
-                used = s.used;
-                lookAheadSeconds = s.lookAheadSeconds;
-                cachedRanges = s.cachedRanges;
-            }
+            void operator=(const FBCache::CacheStats& s) { FBCache::CacheStats::operator=(s); }
         };
 
         struct FBStatus
@@ -30,6 +30,7 @@ namespace IPCore
         virtual ~StereoTransformIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual void metaEvaluate(const Context&, MetaEvalVisitor&);
         virtual void propagateFlushToInputs(const FlushContext&);
@@ -28,6 +28,7 @@ namespace IPCore
         virtual ~Transform2DIPNode();
 
         virtual IPImage* evaluate(const Context&);
+        virtual bool readsInputAlpha() const { return false; }
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual Matrix localMatrix(const Context&) const;
 
@@ -25,12 +25,14 @@
 #include <IPCore/Transform2DIPNode.h>
 #include <IPCore/TextureOutputGroupIPNode.h>
 #include <IPCore/CoreDefinitions.h>
+#include <IPCore/EvalScheduler.h>
 #include <TwkApp/Event.h>
 #include <TwkApp/VideoDevice.h>
 #include <TwkApp/VideoModule.h>
 #include <TwkAudio/Audio.h>
 #include <TwkAudio/Filters.h>
 #include <TwkAudio/Mix.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkMath/Function.h>
 #include <TwkUtil/File.h>
 #include <TwkUtil/ThreadName.h>
@@ -130,6 +132,7 @@ namespace IPCore
     size_t IPGraph::m_minCacheSize = 150 * 1024 * 1024;
     bool IPGraph::m_debugTreeOutput = false;
     int IPGraph::m_maxCacheGroupSize = 0;
+    int IPGraph::m_slowMediaThreads = 1;
 
     static pthread_t notAThread;
 
@@ -243,7 +246,7 @@ namespace IPCore
         , m_viewNode(0)
         , m_viewGroupNode(0)
         , m_threadGroup(0)
-        , m_threadGroupSingle(0)
+        , m_threadGroupSlow(0)
         , m_audioThreadGroup(1, 2)
         , m_cacheMode(NeverCache)
         , m_fbcache(this)
@@ -276,8 +279,15 @@ namespace IPCore
         , m_newFrame(false)
         , m_defaultOutputGroup(0)
         , m_topologyChanged(false)
+        , m_stateSerial(1)
         , m_cacheTimingOutput(false)
         , m_evalSlowMedia(false)
+        , m_evalScheduler(0)
+        , m_parallelLeafEval(true)
+        , m_displayEvalFrames(0)
+        , m_displayEvalSeconds(0)
+        , m_displayEvalMaxSeconds(0)
+        , m_scrubbing(false)
         , m_jobDispatcher(nullptr)
     {
         pthread_mutex_init(&m_internalLock, NULL);
@@ -302,9 +312,23 @@ namespace IPCore
         if (maxSizeStr)
             m_maxCacheGroupSize = atoi(maxSizeStr);
 
+        //
+        //  How many caching threads read media with poor random access,
+        //  each one with its own reader decoding its own groups of
+        //  frames. One (the default) leaves it to thread 1.
+        //
+
+        if (const char* slowThreadsStr = getenv("TWK_SLOW_MEDIA_CACHE_THREADS"))
+            m_slowMediaThreads = max(1, atoi(slowThreadsStr));
+
         if (getenv("TWK_CACHE_TIMING_OUTPUT"))
             m_cacheTimingOutput = true;
 
+        if (getenv("TWK_NO_PARALLEL_LEAF_EVAL"))
+            m_parallelLeafEval = false;
+
+        m_evalScheduler = new EvalScheduler(m_fbcache);
+
         // clear();
         size_t nthreads = Application::optionValue("evalThreads", size_t(1));
         setNumEvalThreads(nthreads);
@@ -335,6 +359,8 @@ namespace IPCore
         finishCachingThread();
         finishAudioThread();
 
+        delete m_evalScheduler;
+
         pthread_mutex_destroy(&m_internalLock);
         pthread_mutex_destroy(&m_audioInternalLock);
         pthread_mutex_destroy(&m_audioFillLock);
@@ -469,6 +495,7 @@ namespace IPCore
             n->setGraph(this);
 
         m_topologyChanged = true;
+        m_stateSerial++;
         m_nodeMap[n->name()] = n;
 
         if (n->hasAudio())
@@ -483,6 +510,7 @@ namespace IPCore
         m_nodeWillRemoveSignal(n);
 
         m_topologyChanged = true;
+        m_stateSerial++;
 
         //
         //  Note: The API to this call provides a pointer, but we are looking up
@@ -553,10 +581,23 @@ namespace IPCore
     {
         finishCachingThread();
         delete m_threadGroup;
-        delete m_threadGroupSingle;
+        delete m_threadGroupSlow;
 
         m_threadData.resize(n);
 
+        //
+        //  One task deque per eval thread, including the display thread
+        //
+
+        m_evalScheduler->setNumQueues(n + 1);
+
+        //
+        //  The eval threads share the decode pool, codecs get their
+        //  part of it
+        //
+
+        TwkFB::ThreadPool::setNumClientThreads(n);
+
         //
         //  IDs start at 1, because display thread is ID 0
         //
@@ -572,20 +613,28 @@ namespace IPCore
         ThreadGroup::data_vector datas;
 
         //
-        //  Single thread group, ID 1, for caching h264, etc.
+        //  Slow media thread group, ID 1 (or the first
+        //  TWK_SLOW_MEDIA_CACHE_THREADS IDs), for caching h264, etc.
         //
 
+        const size_t nslow = min(n, size_t(m_slowMediaThreads));
+
         funcs.resize(0);
         datas.resize(0);
-        funcs.push_back((ThreadGroup::thread_function)evalThreadTrampoline);
-        datas.push_back(&m_threadData[0]);
 
-        m_threadGroupSingle = new ThreadGroup(1, 8, 0, &funcs, &datas);
+        for (size_t i = 0; i < nslow; i++)
+        {
+            funcs.push_back((ThreadGroup::thread_function)evalThreadTrampoline);
+            datas.push_back(&m_threadData[i]);
+        }
+
+        m_threadGroupSlow = new ThreadGroup(nslow, 8, 0, &funcs, &datas);
 
         //
-        //  Other caching threads.
+        //  Other caching threads. They stay parked while the media has
+        //  poor random access.
         //
-        if (n <= 1)
+        if (n <= nslow)
         {
             m_threadGroup = 0;
             return;
@@ -594,13 +643,13 @@ namespace IPCore
         funcs.resize(0);
         datas.resize(0);
 
-        for (size_t i = 1; i < n; i++)
+        for (size_t i = nslow; i < n; i++)
         {
             funcs.push_back((ThreadGroup::thread_function)evalThreadTrampoline);
             datas.push_back(&m_threadData[i]);
         }
 
-        m_threadGroup = new ThreadGroup(n - 1, 8, 0, &funcs, &datas);
+        m_threadGroup = new ThreadGroup(n - nslow, 8, 0, &funcs, &datas);
     }
 
     void IPGraph::initializeIPTree(const VideoModules& modules)
@@ -1348,7 +1397,7 @@ IPGraph::findNodesByAbstractPath(int frame,
         bool doDispatch = true;
         if (m_editing || isMediaLoading()
             || (m_fbcache.minFrame() == minFrame && m_fbcache.maxFrame() == maxFrame && m_fbcache.inFrame() == inframe
-                && m_fbcache.outFrame() == outframe && m_fbcache.capacity() == memUsage && m_cacheMode == mode && isCacheThreadRunning()))
+                && m_fbcache.outFrame() == outframe && m_fbcache.budget() == memUsage && m_cacheMode == mode && isCacheThreadRunning()))
         {
             doDispatch = false;
         }
@@ -1572,6 +1621,22 @@ IPGraph::findNodesByAbstractPath(int frame,
         }
     }
 
+    void IPGraph::updateScrubPrefetch(int frame)
+    {
+        if (!m_scrubbing || !m_fbcache.scrubPrefetch() || m_cacheMode == NeverCache)
+        {
+            m_scrubPredictor.reset();
+            m_scrubFrames.clear();
+        }
+        else
+        {
+            m_scrubPredictor.addSample(frame);
+            m_scrubPredictor.predict(m_fbcache.minFrame(), m_fbcache.maxFrame(), m_scrubFrames);
+        }
+
+        m_fbcache.setPrefetchFrames(m_scrubFrames);
+    }
+
     IPGraph::EvalResult IPGraph::evaluateAtFrame(int frame, bool forDisplay)
     {
         if (!m_rootNode)
@@ -1616,15 +1681,20 @@ IPGraph::findNodesByAbstractPath(int frame,
             if (m_newFrame)
             {
                 m_fbcache.setDisplayFrame(frame);
+                updateScrubPrefetch(frame);
             }
         }
         PROFILE_SAMPLE(setDisplayFrameEnd);
 
+        TWK_CACHE_UNLOCK(m_fbcache, "");
+
+        //
+        //  isFrameCached() only locks the part of the frame index that
+        //  holds this frame, so it doesn't need the cache lock.
+        //
         PROFILE_SAMPLE(frameCachedTestStart);
         bool isCached = m_fbcache.isFrameCached(frame);
         PROFILE_SAMPLE(frameCachedTestEnd);
-
-        TWK_CACHE_UNLOCK(m_fbcache, "");
         // DB ("evaluateAtFrame f " << frame << " forDisplay " << forDisplay <<
         // " isCached " << isCached);
         PROFILE_SAMPLE(cacheTestEnd);
@@ -1675,8 +1745,18 @@ IPGraph::findNodesByAbstractPath(int frame,
 
                 try
                 {
+                    TwkUtil::Timer timer;
+                    timer.start();
+
+                    //
+                    //  Have any idle caching threads read the missing
+                    //  leaves alongside us.
+                    //
+
+                    evaluateLeavesInParallel(frame, IPNode::DisplayCacheEvalThread, 0);
                     img = evaluate(frame, IPNode::DisplayCacheEvalThread);
                     status = EvalNormal;
+                    reportDisplayEvalLatency(frame, timer.elapsed());
                 }
                 catch (std::exception& exc)
                 {
@@ -1749,7 +1829,12 @@ IPGraph::findNodesByAbstractPath(int frame,
             try
             {
                 DBL(DB_CACHE, "overrun: evaling in display thread, frame " << frame);
+                TwkUtil::Timer timer;
+                timer.start();
+                if (!willPause)
+                    evaluateLeavesInParallel(frame, IPNode::DisplayCacheEvalThread, 0);
                 img = evaluate(frame, IPNode::DisplayCacheEvalThread);
+                reportDisplayEvalLatency(frame, timer.elapsed());
                 if (willPause)
                     status = EvalBufferNeedsRefill;
             }
@@ -1862,9 +1947,9 @@ IPGraph::findNodesByAbstractPath(int frame,
 
             //
             //  Don't bother if there's nothing in the low-level cache
-            //  that can be reused.
+            //  or the disk tier that can be reused.
             //
-            if (m_fbcache.trashCount() <= 0)
+            if (m_fbcache.trashCount() <= 0 && !m_fbcache.hasDiskCache())
             {
                 DBL(DB_PROMOTE, "promoteFBsInFrameRange TrashCan empty");
                 break;
@@ -1893,6 +1978,13 @@ IPGraph::findNodesByAbstractPath(int frame,
 
             if (ok)
             {
+                //
+                //  Ids in the disk tier are copied back without the
+                //  cache lock, promoteFrame() only finds them afterwards
+                //
+
+                m_fbcache.pageInFrame(f, idTree);
+
                 TWK_CACHE_LOCK(m_fbcache, "promoting");
                 bool promoted = m_fbcache.promoteFrame(f, idTree);
                 TWK_CACHE_UNLOCK(m_fbcache, "promoting");
@@ -2055,11 +2147,16 @@ IPGraph::findNodesByAbstractPath(int frame,
             }
         }
 
-        m_threadGroupSingle->dispatch(0, 0);
+        const size_t nslow = min(m_threadData.size(), size_t(m_slowMediaThreads));
+
+        for (size_t i = 0; i < nslow; i++)
+        {
+            m_threadGroupSlow->dispatch(0, 0);
+        }
 
         if (!m_evalSlowMedia)
         {
-            for (size_t i = 1; i < m_threadData.size(); i++)
+            for (size_t i = nslow; i < m_threadData.size(); i++)
             {
                 m_threadGroup->dispatch(0, 0);
             }
@@ -2076,8 +2173,8 @@ IPGraph::findNodesByAbstractPath(int frame,
         finishCachingThreadASync();
         if (m_threadGroup)
             m_threadGroup->control_wait();
-        if (m_threadGroupSingle)
-            m_threadGroupSingle->control_wait();
+        if (m_threadGroupSlow)
+            m_threadGroupSlow->control_wait();
         lockInternal();
         m_cacheStop = false;
         unlockInternal();
@@ -2087,6 +2184,130 @@ IPGraph::findNodesByAbstractPath(int frame,
         DBL(DB_DISP, "finishCachingThread end");
     }
 
+    namespace
+    {
+
+        //
+        //  Makes a task for each CacheIPNode reached when evaluating a
+        //  frame. Nothing below a CacheIPNode is visited.
+        //
+
+        class CacheLeafCollector : public IPNode::MetaEvalVisitor
+        {
+        public:
+            typedef std::vector<EvalScheduler::Task*> Tasks;
+
+            CacheLeafCollector(EvalScheduler::Group* g)
+                : group(g)
+            {
+            }
+
+            virtual void enter(const IPNode::Context& c, IPNode* node)
+            {
+                if (!dynamic_cast<CacheIPNode*>(node))
+                    return;
+
+                for (size_t i = 0; i < tasks.size(); i++)
+                {
+                    const IPNode::Context& t = tasks[i]->context;
+                    if (tasks[i]->node == node && t.frame == c.frame && t.eye == c.eye)
+                        return;
+                }
+
+                tasks.push_back(new EvalScheduler::Task(node, c, group));
+            }
+
+            virtual bool traverseChild(const IPNode::Context&, size_t, IPNode* parent, IPNode*)
+            {
+                return dynamic_cast<CacheIPNode*>(parent) == 0;
+            }
+
+            EvalScheduler::Group* group;
+            Tasks tasks;
+        };
+
+    } // namespace
+
+    void IPGraph::evaluateLeavesInParallel(int frame, IPNode::ThreadType thread, size_t id)
+    {
+        //
+        //  Media with poor random access is only read by one thread.
+        //
+
+        if (!m_parallelLeafEval || !m_rootNode || m_evalSlowMedia || m_threadData.empty())
+            return;
+
+        HOP_PROF_FUNC();
+
+        EvalScheduler::Group group;
+        CacheLeafCollector collector(&group);
+        IPNode::Context context(frame, frame, m_fbcache.displayFPS(), 0, 0, thread, id, m_fbcache, false);
+
+        m_rootNode->metaEvaluate(context, collector);
+
+        const CacheLeafCollector::Tasks& tasks = collector.tasks;
+
+        if (tasks.size() < 2)
+        {
+            for (size_t i = 0; i < tasks.size(); i++)
+                delete tasks[i];
+            return;
+        }
+
+        group.add(tasks.size());
+
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            if (id == 0)
+                m_evalScheduler->pushPriority(tasks[i]);
+            else
+                m_evalScheduler->push(id, tasks[i]);
+        }
+
+        if (id == 0)
+            awakenCachingThreadsForDisplay();
+
+        m_evalScheduler->complete(group, id, thread);
+    }
+
+    void IPGraph::reportDisplayEvalLatency(int frame, double seconds)
+    {
+        m_displayEvalFrames++;
+        m_displayEvalSeconds += seconds;
+        m_displayEvalMaxSeconds = std::max(m_displayEvalMaxSeconds, seconds);
+
+        if (m_cacheTimingOutput)
+        {
+            stringstream out;
+            out << "Display thread evaluated frame " << frame << " in " << (1000.0 * seconds) << " ms (mean "
+                << (1000.0 * m_displayEvalSeconds / double(m_displayEvalFrames)) << " ms, max " << (1000.0 * m_displayEvalMaxSeconds)
+                << " ms over " << m_displayEvalFrames << " frames)" << endl;
+            cerr << out.str();
+        }
+    }
+
+    void IPGraph::awakenCachingThreadsForDisplay()
+    {
+        //
+        //  Same as awakenAllCachingThreads() but regardless of utility:
+        //  idle caching threads pick up the display frame's tasks first.
+        //
+
+        if (m_editing || isMediaLoading() || m_cacheMode == NeverCache || !cacheThreadContinue())
+            return;
+
+        LockObject dl(m_dispatchLock, true);
+
+        if (dl.locked())
+        {
+            if (m_threadGroupSlow)
+                m_threadGroupSlow->awaken_all_workers();
+
+            if (m_threadGroup && !m_evalSlowMedia)
+                m_threadGroup->awaken_all_workers();
+        }
+    }
+
     void IPGraph::awakenAllCachingThreads()
     {
         if (m_editing || isMediaLoading() || m_cacheMode == NeverCache)
@@ -2104,8 +2325,8 @@ IPGraph::findNodesByAbstractPath(int frame,
 
                 DBL(DB_DISP, "IPGraph::awakenAllCachingThreads workers arise !");
                 m_fbcache.resetUtilityState();
-                if (m_threadGroupSingle)
-                    m_threadGroupSingle->awaken_all_workers();
+                if (m_threadGroupSlow)
+                    m_threadGroupSlow->awaken_all_workers();
 
                 if (m_threadGroup && !m_evalSlowMedia)
                     m_threadGroup->awaken_all_workers();
@@ -2248,7 +2469,8 @@ IPGraph::findNodesByAbstractPath(int frame,
 
         FBCache::FrameVector frames;
 
-        int maxGroupSize = getMaxGroupSize(m_evalSlowMedia);
+        bool slowGroups = m_evalSlowMedia;
+        int maxGroupSize = getMaxGroupSize(slowGroups);
 
         if (m_rootNode)
         {
@@ -2329,13 +2551,30 @@ IPGraph::findNodesByAbstractPath(int frame,
                     continue;
                 }
 
+                //
+                //  Then help with the leaves of frames being evaluated by
+                //  other threads (the display frame's first) before
+                //  starting on a new one.
+                //
+
+                if (m_evalScheduler->hasWork())
+                {
+                    if (EvalScheduler::Task* task = m_evalScheduler->next(id))
+                    {
+                        m_evalScheduler->run(task, id, IPNode::CacheEvalThread);
+                        continue;
+                    }
+                }
+
                 bool skipThisFrame = false;
+                bool newGroup = false;
 
                 if (frames.empty())
                 {
                     TWK_CACHE_LOCK(m_fbcache, "");
                     m_fbcache.initiateCachingOfBestFrameGroup(frames, maxGroupSize);
                     TWK_CACHE_UNLOCK(m_fbcache, "");
+                    newGroup = true;
                 }
 
                 if (frames.empty())
@@ -2348,18 +2587,24 @@ IPGraph::findNodesByAbstractPath(int frame,
 
                 //
                 //  Run a test evaluation to see if we can do this frame random
-                //  access. If not we only allow thread 1 to evaluate.
-                //  (Thread 0 is the display thread.)
+                //  access. If not we only allow thread 1 to evaluate, or the
+                //  first TWK_SLOW_MEDIA_CACHE_THREADS threads. (Thread 0 is the
+                //  display thread.)
                 //
-                //  We also force 20-frame block caching when random access is
-                //  poor.
+                //  We also force block caching when random access is poor (20
+                //  frames or a GOP, whichever is longer), so each of those
+                //  threads decodes its own run of GOPs with its own reader.
+                //  A group is cut short before the next keyframe, so the
+                //  group after it starts on one instead of having another
+                //  thread decode the same GOP prefix again.
 
                 if (NAF != frame)
                 {
                     bool poorPerf = false;
+                    TestEvalResult r;
                     try
                     {
-                        TestEvalResult r = testEvaluate(frame, IPNode::CacheEvalThread, id);
+                        r = testEvaluate(frame, IPNode::CacheEvalThread, id);
                         poorPerf = r.poorRandomAccessPerformance;
                     }
                     catch (std::exception& exc)
@@ -2374,10 +2619,18 @@ IPGraph::findNodesByAbstractPath(int frame,
                     }
                     DB("after testEvaluate, skipThisFrame " << skipThisFrame);
 
-                    if (id == 1)
+                    if (id <= m_slowMediaThreads)
                     {
-                        m_evalSlowMedia = poorPerf;
-                        if (maxGroupSize != getMaxGroupSize(poorPerf))
+                        //
+                        //  Thread 1 alone sets the flag that parks the
+                        //  other caching threads, so the slow media threads
+                        //  don't overwrite each other's results.
+                        //
+
+                        if (id == 1)
+                            m_evalSlowMedia = poorPerf;
+
+                        if (slowGroups != poorPerf)
                         //
                         //  Since we're changing our "blocking" policy, don't
                         //  bother trying to cache whatever frame(s) the old
@@ -2393,9 +2646,32 @@ IPGraph::findNodesByAbstractPath(int frame,
                             }
                             TWK_CACHE_UNLOCK(m_fbcache, "");
                             frames.clear();
+                            slowGroups = poorPerf;
                             maxGroupSize = getMaxGroupSize(poorPerf);
                             continue;
                         }
+
+                        if (poorPerf && newGroup && r.framesToKeyframe > 0)
+                        {
+                            if (m_maxCacheGroupSize == 0)
+                                maxGroupSize = max(getMaxGroupSize(true), r.framesSinceKeyframe + r.framesToKeyframe);
+
+                            const int keyframe = frame + r.framesToKeyframe;
+                            FBCache::FrameVector::iterator end = frames.begin();
+                            while (end != frames.end() && *end >= keyframe)
+                                ++end;
+
+                            if (end != frames.begin())
+                            {
+                                TWK_CACHE_LOCK(m_fbcache, "");
+                                for (FBCache::FrameVector::iterator i = frames.begin(); i != end; ++i)
+                                {
+                                    m_fbcache.completeCachingOfFrame(*i);
+                                }
+                                TWK_CACHE_UNLOCK(m_fbcache, "");
+                                frames.erase(frames.begin(), end);
+                            }
+                        }
                     }
                     else if (poorPerf)
                     {
@@ -2428,6 +2704,13 @@ IPGraph::findNodesByAbstractPath(int frame,
                     //
                     DB("bad target frame: frame " << frame << " skip " << skipThisFrame);
 
+                    //
+                    //  Other threads may still have leaves to share
+                    //
+
+                    if (NAF == frame && m_evalScheduler->hasWork())
+                        continue;
+
                     break;
                 }
 
@@ -2511,6 +2794,7 @@ IPGraph::findNodesByAbstractPath(int frame,
                 try
                 {
                     DB("thread " << id << " evaluate frame " << frame << ", overflowing " << m_fbcache.overflowing());
+                    evaluateLeavesInParallel(frame, IPNode::CacheEvalThread, id);
                     IPImage* img = evaluate(frame, IPNode::CacheEvalThread, id);
 
                     TWK_CACHE_LOCK(m_fbcache, "");
@@ -2628,7 +2912,7 @@ IPGraph::findNodesByAbstractPath(int frame,
             float elap = timer->elapsed();
             out << "Caching thread " << id << " END" << ", " << framesCached << " frames (" << (1000.0 * elap / float(framesCached))
                 << " ms/frame, " << texturesCached << " textures, " << (1000.0 * elap) << " total), last frame: " << lastFrameCached
-                << endl;
+                << ", leaf tasks " << m_evalScheduler->tasksRun() << " (" << m_evalScheduler->tasksStolen() << " stolen)" << endl;
             cerr << out.str();
         }
         delete timer;
@@ -3396,6 +3680,7 @@ IPGraph::findNodesByAbstractPath(int frame,
 
     void IPGraph::propertyChanged(const Property* p)
     {
+        m_stateSerial++;
         m_propertyChangedSignal(p);
 
         ostringstream str;
@@ -3437,6 +3722,8 @@ IPGraph::findNodesByAbstractPath(int frame,
 
     void IPGraph::inputsChanged(IPNode* n)
     {
+        m_stateSerial++;
+
         if (n && !n->group()) // top level only
         {
             TwkApp::GenericStringEvent event("graph-node-inputs-changed", this, n->name());
@@ -3473,6 +3760,8 @@ IPGraph::findNodesByAbstractPath(int frame,
 
     void IPGraph::newPropertyCreated(const Property* p)
     {
+        m_stateSerial++;
+
         ostringstream str;
         const IPNode* pc = dynamic_cast<const IPNode*>(p->container());
         const Component* c = pc->componentOf(p);
@@ -3503,6 +3792,8 @@ IPGraph::findNodesByAbstractPath(int frame,
 
     void IPGraph::propertyDeleted(const std::string& name)
     {
+        m_stateSerial++;
+
         TwkApp::GenericStringEvent event("graph-property-did-delete", this, name);
         sendEvent(event);
     }
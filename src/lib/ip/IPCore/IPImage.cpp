@@ -67,6 +67,7 @@ namespace IPCore
         samplerType = Rect2DSampler;
         hashCount = 0;
         isHistogram = false;
+        cachePinned = false;
         isCropped = false;
         cropStartX = 0;
         cropStartY = 0;
@@ -358,7 +359,12 @@ namespace IPCore
 
     void IPImage::clear()
     {
-        if (fb && !fb->inCache())
+        if (fb && cachePinned)
+        {
+            fb->cacheUnpin();
+            cachePinned = false;
+        }
+        else if (fb && !fb->inCache())
         {
             if (!fb->hasStaticRef() || fb->staticUnRef())
             {
@@ -0,0 +1,135 @@
+//
+// Copyright (C) 2026 Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/ScrubPredictor.h>
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+
+namespace IPCore
+{
+    using namespace std;
+
+    ScrubPredictor::ScrubPredictor(size_t maxFrames, double window, double horizon)
+        : m_timer(true)
+        , m_maxFrames(maxFrames)
+        , m_window(window)
+        , m_horizon(horizon)
+    {
+    }
+
+    void ScrubPredictor::addSample(int frame)
+    {
+        const double now = m_timer.elapsed();
+
+        if (!m_samples.empty() && m_samples.back().frame == frame)
+            return;
+
+        Sample s;
+        s.frame = frame;
+        s.time = now;
+        m_samples.push_back(s);
+
+        //
+        //  Keep at least the previous frame so a drag that starts after
+        //  a pause has a direction.
+        //
+
+        while (m_samples.size() > 2 && now - m_samples.front().time > m_window)
+            m_samples.pop_front();
+
+        if (m_samples.size() == 2 && now - m_samples.front().time > m_window * 4)
+            m_samples.pop_front();
+    }
+
+    void ScrubPredictor::reset() { m_samples.clear(); }
+
+    float ScrubPredictor::velocity() const
+    {
+        if (m_samples.size() < 2)
+            return 0;
+
+        const Sample& a = m_samples.front();
+        const Sample& b = m_samples.back();
+        const double dt = b.time - a.time;
+
+        return dt > 0 ? float(double(b.frame - a.frame) / dt) : 0.0f;
+    }
+
+    int ScrubPredictor::stride() const
+    {
+        vector<int> steps;
+
+        for (size_t i = 1; i < m_samples.size(); i++)
+        {
+            steps.push_back(abs(m_samples[i].frame - m_samples[i - 1].frame));
+        }
+
+        if (steps.empty())
+            return 1;
+
+        nth_element(steps.begin(), steps.begin() + steps.size() / 2, steps.end());
+        return max(steps[steps.size() / 2], 1);
+    }
+
+    int ScrubPredictor::predict(int minFrame, int maxFrame, vector<int>& frames) const
+    {
+        frames.clear();
+
+        if (m_samples.size() < 2)
+            return 0;
+
+        //
+        //  How consistently the drag went one way: 1 or -1 if every step
+        //  did, near 0 if it went back and forth.
+        //
+
+        int travel = 0;
+        int distance = 0;
+
+        for (size_t i = 1; i < m_samples.size(); i++)
+        {
+            const int d = m_samples[i].frame - m_samples[i - 1].frame;
+            travel += d;
+            distance += abs(d);
+        }
+
+        if (distance == 0)
+            return 0;
+
+        const float consistency = float(travel) / float(distance);
+        const int dir = consistency > 0 ? 1 : -1;
+        const int step = stride();
+        const int last = m_samples.back().frame;
+        const bool bothWays = fabs(consistency) < 0.5f;
+
+        //
+        //  Enough frames to cover where the drag will be horizon seconds
+        //  from now, no fewer than a handful.
+        //
+
+        size_t count = size_t(fabs(velocity()) * m_horizon / double(step));
+        count = min(max(count, size_t(4)), m_maxFrames);
+
+        for (size_t i = 1; frames.size() < count; i++)
+        {
+            const int ahead = last + dir * step * int(i);
+            const int behind = last - dir * step * int(i);
+            const bool aheadIn = ahead >= minFrame && ahead < maxFrame;
+            const bool behindIn = bothWays && behind >= minFrame && behind < maxFrame;
+
+            if (!aheadIn && !behindIn)
+                break;
+
+            if (aheadIn)
+                frames.push_back(ahead);
+            if (behindIn && frames.size() < count)
+                frames.push_back(behind);
+        }
+
+        return bothWays ? 0 : dir;
+    }
+
+} // namespace IPCore
@@ -2964,6 +2964,7 @@ namespace IPCore
             checkInDisplayImage();
             checkInPreDisplayImage();
 
+            graph().setScrubbing(!isPlaying());
             result = graph().evaluateAtFrame(m_frame, true);
             m_displayImage = result.second;
 
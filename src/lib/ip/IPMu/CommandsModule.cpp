@@ -1059,6 +1059,19 @@ namespace IPMu
         s->askForRedraw(true);
     }
 
+    //
+    //  Like setCacheOutsideRegion: stop the caching threads and start
+    //  them again so they pick their targets under the new settings
+    //
+
+    static void restartCaching(Session* s)
+    {
+        Session::CachingMode mode = s->cachingMode();
+        s->setCaching(Session::NeverCache);
+        s->setCaching(mode);
+        s->askForRedraw(true);
+    }
+
     NODE_IMPLEMENTATION(isCaching, bool)
     {
         bool b = Session::currentSession()->isCaching();
@@ -1149,6 +1162,142 @@ namespace IPMu
         NODE_RETURN(tuple);
     }
 
+    NODE_IMPLEMENTATION(setSourceCacheQuota, void)
+    {
+        Session* s = Session::currentSession();
+        StringType::String* name = NODE_ARG_OBJECT(0, StringType::String);
+        const int64 bytes = NODE_ARG(1, int64);
+
+        if (!name)
+            throwBadArgumentException(NODE_THIS, NODE_THREAD, "setSourceCacheQuota: nil source name");
+
+        FBCache& cache = s->graph().cache();
+        cache.lock();
+        cache.setSourceQuota(name->c_str(), bytes > 0 ? size_t(bytes) : 0);
+        cache.unlock();
+
+        restartCaching(s);
+    }
+
+    NODE_IMPLEMENTATION(setSourceCacheWeight, void)
+    {
+        Session* s = Session::currentSession();
+        StringType::String* name = NODE_ARG_OBJECT(0, StringType::String);
+        const float weight = NODE_ARG(1, float);
+
+        if (!name)
+            throwBadArgumentException(NODE_THIS, NODE_THREAD, "setSourceCacheWeight: nil source name");
+
+        FBCache& cache = s->graph().cache();
+        cache.lock();
+        cache.setSourceWeight(name->c_str(), weight);
+        cache.unlock();
+
+        restartCaching(s);
+    }
+
+    NODE_IMPLEMENTATION(setFairShareCaching, void)
+    {
+        Session* s = Session::currentSession();
+        FBCache& cache = s->graph().cache();
+        cache.lock();
+        cache.setFairShareCaching(NODE_ARG(0, bool));
+        cache.unlock();
+
+        restartCaching(s);
+    }
+
+    NODE_IMPLEMENTATION(fairShareCaching, bool)
+    {
+        Session* s = Session::currentSession();
+        NODE_RETURN(s->graph().cache().fairShareCaching());
+    }
+
+    NODE_IMPLEMENTATION(setScrubPrefetch, void)
+    {
+        Session* s = Session::currentSession();
+        FBCache& cache = s->graph().cache();
+        cache.lock();
+        cache.setScrubPrefetch(NODE_ARG(0, bool));
+        cache.unlock();
+    }
+
+    NODE_IMPLEMENTATION(scrubPrefetch, bool)
+    {
+        Session* s = Session::currentSession();
+        NODE_RETURN(s->graph().cache().scrubPrefetch());
+    }
+
+    NODE_IMPLEMENTATION(prefetchCacheInfo, Pointer)
+    {
+        Session* s = Session::currentSession();
+        const Class* itype = static_cast<const Class*>(NODE_THIS.type());
+
+        struct Info
+        {
+            int64 requested;
+            int64 hits;
+            bool enabled;
+        };
+
+        Session::CacheStats stats = s->cacheStats();
+
+        ClassInstance* obj = ClassInstance::allocate(itype);
+        Info* info = reinterpret_cast<Info*>(obj->structure());
+
+        info->enabled = s->graph().cache().scrubPrefetch();
+        info->requested = stats.prefetchRequested;
+        info->hits = stats.prefetchHits;
+
+        NODE_RETURN(obj);
+    }
+
+    NODE_IMPLEMENTATION(sourceCacheInfo, Pointer)
+    {
+        MuLangContext* c = TwkApp::muContext();
+        Session* s = Session::currentSession();
+        const DynamicArrayType* dtype = static_cast<const DynamicArrayType*>(NODE_THIS.type());
+        DynamicArray* array = new DynamicArray(dtype, 1);
+        const Class* itype = static_cast<const Class*>(dtype->elementType());
+
+        struct Info
+        {
+            Pointer source;
+            int64 used;
+            int64 quota;
+            int64 fairShare;
+            float weight;
+            float seconds;
+        };
+
+        Session::CacheStats stats = s->cacheStats();
+        const FBCache::SourceUsageVector& usage = stats.sourceUsage;
+
+        array->resize(usage.size());
+
+        for (size_t i = 0; i < usage.size(); i++)
+        {
+            ClassInstance* obj = ClassInstance::allocate(itype);
+            array->element<ClassInstance*>(i) = obj;
+            Info* info = reinterpret_cast<Info*>(obj->structure());
+
+            info->source = c->stringType()->allocate(usage[i].source);
+            info->used = usage[i].used;
+            info->quota = usage[i].quota;
+            info->fairShare = usage[i].fairShare;
+            info->weight = usage[i].weight;
+            info->seconds = 0.0;
+
+            for (size_t q = 0; q < stats.sourceCosts.size(); q++)
+            {
+                if (stats.sourceCosts[q].source == usage[i].source)
+                    info->seconds = stats.sourceCosts[q].seconds;
+            }
+        }
+
+        NODE_RETURN(array);
+    }
+
     NODE_IMPLEMENTATION(fullScreenMode, void) { Session::currentSession()->fullScreenMode(NODE_ARG(0, bool)); }
 
     NODE_IMPLEMENTATION(isFullScreen, bool) { NODE_RETURN(Session::currentSession()->isFullScreen()); }
@@ -5410,6 +5559,21 @@ namespace IPMu
         fields[2] = make_pair(string("frame"), context->intType());
         context->arrayType(context->structType(0, "MetaEvalInfo", fields), 1, 0);
 
+        fields.resize(6);
+        fields[0] = make_pair(string("source"), context->stringType());
+        fields[1] = make_pair(string("used"), context->int64Type());
+        fields[2] = make_pair(string("quota"), context->int64Type());
+        fields[3] = make_pair(string("fairShare"), context->int64Type());
+        fields[4] = make_pair(string("weight"), context->floatType());
+        fields[5] = make_pair(string("seconds"), context->floatType());
+        context->arrayType(context->structType(0, "SourceCacheInfo", fields), 1, 0);
+
+        fields.resize(3);
+        fields[0] = make_pair(string("requested"), context->int64Type());
+        fields[1] = make_pair(string("hits"), context->int64Type());
+        fields[2] = make_pair(string("enabled"), context->boolType());
+        context->structType(0, "PrefetchCacheInfo", fields);
+
         fields.resize(5);
         fields[0] = make_pair(string("extension"), context->stringType());
         fields[1] = make_pair(string("description"), context->stringType());
@@ -5695,6 +5859,26 @@ namespace IPMu
 
             new Function(c, "audioCacheInfo", audioCacheInfo, None, Return, "(float,int[])", End),
 
+            new Function(c, "setSourceCacheQuota", setSourceCacheQuota, None, Return, "void", Parameters,
+                         new Param(c, "sourceName", "string"), new Param(c, "bytes", "int64"), End),
+
+            new Function(c, "setSourceCacheWeight", setSourceCacheWeight, None, Return, "void", Parameters,
+                         new Param(c, "sourceName", "string"), new Param(c, "weight", "float"), End),
+
+            new Function(c, "setFairShareCaching", setFairShareCaching, None, Return, "void", Parameters,
+                         new Param(c, "fairShare", "bool"), End),
+
+            new Function(c, "fairShareCaching", fairShareCaching, None, Return, "bool", End),
+
+            new Function(c, "sourceCacheInfo", sourceCacheInfo, None, Return, "SourceCacheInfo[]", End),
+
+            new Function(c, "setScrubPrefetch", setScrubPrefetch, None, Return, "void", Parameters, new Param(c, "prefetch", "bool"),
+                         End),
+
+            new Function(c, "scrubPrefetch", scrubPrefetch, None, Return, "bool", End),
+
+            new Function(c, "prefetchCacheInfo", prefetchCacheInfo, None, Return, "PrefetchCacheInfo", End),
+
             new Function(c, "isBuffering", isBuffering, None, Return, "bool", End),
 
             new Function(c, "inc", inc, None, Return, "int", End),
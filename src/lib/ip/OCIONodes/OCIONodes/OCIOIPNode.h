@@ -46,6 +46,7 @@ namespace IPCore
 
         virtual ~OCIOIPNode();
         virtual IPImage* evaluate(const Context& context);
+        virtual bool readsInputAlpha() const { return false; }
         std::string stringProp(const std::string&, const std::string&) const;
         int intProp(const std::string&, int) const;
 
@@ -0,0 +1,494 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestDPXUnpack.h>
+
+#include <IOcin/Read10Bit.h>
+#include <TwkFB/FastConversion.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/SIMDKernels.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <TwkUtil/Timer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using namespace TwkFB;
+
+    const size_t width = 4096;
+    const size_t height = 2160;
+    const size_t tryCount = 3;
+
+    enum Output
+    {
+        RGB16,
+        RGBA16,
+        RGB8,
+        RGBA8,
+        Planar16,
+        Planar8,
+        A2BGR10
+    };
+
+    struct Format
+    {
+        const char* name;
+        int bits;
+        Output output;
+    };
+
+    Format formats[] = {
+        {"10 bit -> RGB16", 10, RGB16},           {"10 bit -> RGBA16", 10, RGBA16},         {"10 bit -> RGB8", 10, RGB8},
+        {"10 bit -> RGBA8", 10, RGBA8},           {"10 bit -> planar RGB16", 10, Planar16}, {"10 bit -> planar RGB8", 10, Planar8},
+        {"10 bit -> A2BGR10", 10, A2BGR10},       {"12 bit -> planar RGB16", 12, Planar16}, {"12 bit -> planar RGB8", 12, Planar8},
+    };
+
+    const char* packingNames[] = {"packed", "method A", "method B"};
+
+    //
+    //  Bytes per pixel of an output, the planar ones are three planes
+    //  of width * height values one after the other.
+    //
+
+    size_t pixelSize(Output output)
+    {
+        switch (output)
+        {
+        case RGB8:
+        case Planar8:
+            return 3;
+        case RGBA8:
+        case A2BGR10:
+            return 4;
+        case RGB16:
+        case Planar16:
+            return 6;
+        default:
+            return 8;
+        }
+    }
+
+    void unpack(const Format& f, bool mp, size_t width, size_t height, const uint8_t* in, std::vector<uint8_t>& out, int packing,
+                bool swap)
+    {
+        const size_t inStride = unpackDPX_rowSize(width, f.bits, packing);
+        const size_t plane = width * height;
+        uint8_t* o = &out[0];
+        uint16_t* o16 = reinterpret_cast<uint16_t*>(o);
+
+        switch (f.output)
+        {
+        case RGB16:
+        case RGBA16:
+        {
+            const int nc = f.output == RGB16 ? 3 : 4;
+            (mp ? unpackDPX10_to_RGB16_MP : unpackDPX10_to_RGB16)(width, height, in, inStride, o16, width * nc * 2, nc, packing, swap);
+            break;
+        }
+        case RGB8:
+        case RGBA8:
+        {
+            const int nc = f.output == RGB8 ? 3 : 4;
+            (mp ? unpackDPX10_to_RGB8_MP : unpackDPX10_to_RGB8)(width, height, in, inStride, o, width * nc, nc, packing, swap);
+            break;
+        }
+        case Planar16:
+            if (f.bits == 10)
+                (mp ? unpackDPX10_to_planarRGB16_MP : unpackDPX10_to_planarRGB16)(width, height, in, inStride, o16, o16 + plane,
+                                                                                  o16 + plane * 2, width * 2, packing, swap);
+            else
+                (mp ? unpackDPX12_to_planarRGB16_MP : unpackDPX12_to_planarRGB16)(width, height, in, inStride, o16, o16 + plane,
+                                                                                  o16 + plane * 2, width * 2, packing, swap);
+            break;
+        case Planar8:
+            if (f.bits == 10)
+                (mp ? unpackDPX10_to_planarRGB8_MP : unpackDPX10_to_planarRGB8)(width, height, in, inStride, o, o + plane, o + plane * 2,
+                                                                                width, packing, swap);
+            else
+                (mp ? unpackDPX12_to_planarRGB8_MP : unpackDPX12_to_planarRGB8)(width, height, in, inStride, o, o + plane, o + plane * 2,
+                                                                                width, packing, swap);
+            break;
+        case A2BGR10:
+            (mp ? unpackDPX10_to_A2BGR10_MP : unpackDPX10_to_A2BGR10)(width, height, in, inStride, reinterpret_cast<uint32_t*>(o),
+                                                                      width * 4, packing, swap);
+            break;
+        }
+    }
+
+    double secondsPerFrame(const Format& f, bool mp, const uint8_t* in, std::vector<uint8_t>& out, int packing, bool swap)
+    {
+        TwkUtil::Timer timer(true);
+
+        for (size_t t = 0; t < tryCount; t++)
+        {
+            unpack(f, mp, width, height, in, out, packing, swap);
+        }
+
+        return timer.elapsed() / tryCount;
+    }
+
+    //
+    //  What the bitfield readers made of filled method A words: R in
+    //  the top ten bits, 16 bit values from 65535 * v / 1023.
+    //
+
+    bool matchesBitfieldReader(const uint8_t* in, const std::vector<uint8_t>& out)
+    {
+        const uint16_t* o = reinterpret_cast<const uint16_t*>(&out[0]);
+
+        for (size_t i = 0; i < width * height; i++)
+        {
+            uint32_t w;
+            memcpy(&w, in + i * 4, sizeof(w));
+
+            for (int c = 0; c < 3; c++)
+            {
+                const uint32_t v = (w >> (22 - 10 * c)) & 0x3ff;
+                if (o[i * 3 + c] != uint16_t(double(65535l * v) / 1023.0l))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    void put32(uint8_t* row, size_t i, uint32_t w, bool swap)
+    {
+        if (swap)
+            w = (w >> 24) | ((w >> 8) & 0xff00) | ((w << 8) & 0xff0000) | (w << 24);
+        memcpy(row + i * sizeof(w), &w, sizeof(w));
+    }
+
+    //
+    //  Writes count 10 or 12 bit components to a row the way a DPX
+    //  writer lays them out.
+    //
+
+    void packRow(const uint16_t* values, size_t count, int bits, int packing, bool swap, uint8_t* row)
+    {
+        if (packing == DPX_UNPACK_PACKED)
+        {
+            uint64_t buffer = 0;
+            int nbits = 0;
+            size_t word = 0;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                buffer |= uint64_t(values[i]) << nbits;
+                nbits += bits;
+
+                if (nbits >= 32)
+                {
+                    put32(row, word++, uint32_t(buffer), swap);
+                    buffer >>= 32;
+                    nbits -= 32;
+                }
+            }
+
+            if (nbits)
+                put32(row, word, uint32_t(buffer), swap);
+        }
+        else if (bits == 10)
+        {
+            for (size_t i = 0; i < count / 3; i++)
+            {
+                const uint32_t w = (uint32_t(values[i * 3]) << 20) | (uint32_t(values[i * 3 + 1]) << 10) | values[i * 3 + 2];
+                put32(row, i, packing == DPX_UNPACK_FILLED_A ? w << 2 : w, swap);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                uint16_t w = packing == DPX_UNPACK_FILLED_A ? uint16_t(values[i] << 4) : values[i];
+                if (swap)
+                    w = uint16_t((w >> 8) | (w << 8));
+                memcpy(row + i * sizeof(w), &w, sizeof(w));
+            }
+        }
+    }
+
+    //
+    //  What a component v has to come out as
+    //
+
+    uint32_t expectedValue(const Format& f, uint32_t v)
+    {
+        const bool eightBit = f.output == RGB8 || f.output == RGBA8 || f.output == Planar8;
+
+        if (f.bits == 12)
+            return eightBit ? v >> 4 : v << 4;
+        if (f.output == A2BGR10)
+            return v;
+        return eightBit ? std::min((v + 1) >> 2, 255u) : uint32_t(double(65535l * v) / 1023.0l);
+    }
+
+    bool matchesValues(const Format& f, size_t w, size_t h, const std::vector<uint16_t>& values, const std::vector<uint8_t>& out)
+    {
+        const uint16_t* out16 = reinterpret_cast<const uint16_t*>(&out[0]);
+        const uint32_t* out32 = reinterpret_cast<const uint32_t*>(&out[0]);
+        const size_t plane = w * h;
+
+        for (size_t i = 0; i < plane; i++)
+        {
+            if ((f.output == RGBA16 && out16[i * 4 + 3] != 65535) || (f.output == RGBA8 && out[i * 4 + 3] != 255))
+            {
+                return false;
+            }
+
+            for (int c = 0; c < 3; c++)
+            {
+                uint32_t o = 0;
+
+                switch (f.output)
+                {
+                case RGB16:
+                    o = out16[i * 3 + c];
+                    break;
+                case RGBA16:
+                    o = out16[i * 4 + c];
+                    break;
+                case RGB8:
+                    o = out[i * 3 + c];
+                    break;
+                case RGBA8:
+                    o = out[i * 4 + c];
+                    break;
+                case Planar16:
+                    o = out16[c * plane + i];
+                    break;
+                case Planar8:
+                    o = out[c * plane + i];
+                    break;
+                case A2BGR10:
+                    o = (out32[i] >> (10 * c)) & 0x3ff;
+                    break;
+                }
+
+                if (o != expectedValue(f, values[i * 3 + c]))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    //
+    //  Two pixels, (0x3ff, 0x200, 0x001) and (0x155, 0x2aa, 0x000),
+    //  written out by hand in each packing.
+    //
+
+    bool matchesHandBuiltWords()
+    {
+        static const uint32_t words[3][2] = {{0x401803ff, 0x0002aa55}, {0xffe00004, 0x556aa000}, {0x3ff80001, 0x155aa800}};
+        static const uint16_t rgb16[6] = {65535, 32799, 64, 21845, 43690, 0};
+        static const uint8_t rgb8[6] = {255, 128, 0, 85, 170, 0};
+        static const uint32_t a2bgr10[2] = {0x3ff | (0x200 << 10) | (0x001 << 20), 0x155 | (0x2aa << 10)};
+
+        for (int packing = DPX_UNPACK_PACKED; packing <= DPX_UNPACK_FILLED_B; packing++)
+        {
+            for (int swap = 0; swap < 2; swap++)
+            {
+                uint8_t in[8];
+                uint16_t out16[6];
+                uint8_t out8[6];
+                uint32_t out32[2];
+
+                put32(in, 0, words[packing][0], swap);
+                put32(in, 1, words[packing][1], swap);
+
+                unpackDPX10_to_RGB16(2, 1, in, sizeof(in), out16, sizeof(out16), 3, packing, swap);
+                unpackDPX10_to_RGB8(2, 1, in, sizeof(in), out8, sizeof(out8), 3, packing, swap);
+                unpackDPX10_to_A2BGR10(2, 1, in, sizeof(in), out32, sizeof(out32), packing, swap);
+
+                if (memcmp(out16, rgb16, sizeof(rgb16)) || memcmp(out8, rgb8, sizeof(rgb8)) || memcmp(out32, a2bgr10, sizeof(a2bgr10)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //
+    //  Every output format, packing and byte order against values
+    //  computed from the components: an odd width so the SIMD kernels
+    //  run their main loop and their tail.
+    //
+
+    bool matchesBuiltImages(bool mp)
+    {
+        const size_t w = 37;
+        const size_t h = 5;
+
+        for (size_t i = 0; i < sizeof(formats) / sizeof(Format); i++)
+        {
+            const Format& f = formats[i];
+            std::vector<uint16_t> values(w * h * 3);
+
+            for (size_t j = 0; j < values.size(); j++)
+            {
+                values[j] = uint16_t(j % 7 ? (j * 613) & ((1 << f.bits) - 1) : (1 << f.bits) - 1);
+            }
+
+            for (int packing = DPX_UNPACK_PACKED; packing <= DPX_UNPACK_FILLED_B; packing++)
+            {
+                const size_t stride = unpackDPX_rowSize(w, f.bits, packing);
+
+                for (int swap = 0; swap < 2; swap++)
+                {
+                    std::vector<uint8_t> in(stride * h);
+                    std::vector<uint8_t> out(w * h * pixelSize(f.output));
+
+                    for (size_t y = 0; y < h; y++)
+                    {
+                        packRow(&values[y * w * 3], w * 3, f.bits, packing, swap, &in[y * stride]);
+                    }
+
+                    unpack(f, mp, w, h, &in[0], out, packing, swap);
+
+                    if (!matchesValues(f, w, h, values, out))
+                    {
+                        printf("%s %s %s gives the wrong values\n", f.name, packingNames[packing], swap ? "swapped" : "native");
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //
+    //  The 10 bit RGBA and CbYCrY layouts DPX reads with Read10Bit:
+    //  the same four filled method A words hold three RGBA pixels or
+    //  six 4:2:2 pixels.
+    //
+
+    bool matchesRGBAandYUVReaders()
+    {
+        static const uint32_t words[4] = {0xffe00004, 0x556aa000, 0xffe00004, 0x556aa000};
+        static const uint16_t rgba16[12] = {65535, 32799, 64, 21845, 43690, 0, 65535, 32799, 64, 21845, 43690, 0};
+        static const uint8_t rgba8[12] = {255, 128, 0, 85, 170, 0, 255, 128, 0, 85, 170, 0};
+        static const uint8_t y8[6] = {128, 85, 0, 128, 85, 0};
+        static const uint8_t u8[3] = {255, 170, 0};
+        static const uint8_t v8[3] = {0, 255, 170};
+
+        for (int swap = 0; swap < 2; swap++)
+        {
+            uint8_t in[16];
+
+            for (size_t i = 0; i < 4; i++)
+                put32(in, i, words[i], swap);
+
+            FrameBuffer rgba16fb, rgba8fb, yuvfb;
+            Read10Bit::readRGBA16("rgba16", in, rgba16fb, 3, 1, sizeof(in), true, swap);
+            Read10Bit::readRGBA8("rgba8", in, rgba8fb, 3, 1, sizeof(in), true, swap);
+            Read10Bit::readYCrYCb8_422_PLANAR("yuv", in, yuvfb, 6, 1, sizeof(in), swap);
+
+            const FrameBuffer* U = yuvfb.nextPlane();
+            const FrameBuffer* V = U ? U->nextPlane() : 0;
+
+            if (memcmp(rgba16fb.scanline<uint16_t>(0), rgba16, sizeof(rgba16)) || memcmp(rgba8fb.scanline<uint8_t>(0), rgba8, sizeof(rgba8))
+                || !V || memcmp(yuvfb.scanline<uint8_t>(0), y8, sizeof(y8)) || memcmp(U->scanline<uint8_t>(0), u8, sizeof(u8))
+                || memcmp(V->scanline<uint8_t>(0), v8, sizeof(v8)))
+            {
+                printf("10 bit RGBA/YUV %s gives the wrong values\n", swap ? "swapped" : "native");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+} // namespace
+
+bool TestDPXUnpack()
+{
+    const SIMD::Level detected = SIMD::detectedLevel();
+    bool ok = true;
+
+    printf("Test TestDPXUnpack (%s)\n", SIMD::levelName(detected));
+
+    TwkFB::ThreadPool::initialize();
+
+    //
+    //  Known values first, at each SIMD level
+    //
+
+    for (int level = 0; level < 2; level++)
+    {
+        SIMD::setLevel(level ? detected : SIMD::Scalar);
+
+        const bool words = matchesHandBuiltWords();
+        const bool images = matchesBuiltImages(false) && matchesBuiltImages(true);
+
+        printf("%-8s hand built words %s, built images %s\n", level ? "simd" : "scalar", words ? "ok" : "MISMATCH",
+               images ? "ok" : "MISMATCH");
+        ok = ok && words && images;
+    }
+
+    SIMD::setLevel(detected);
+
+    const bool rgbaYUV = matchesRGBAandYUVReaders();
+    printf("10 bit RGBA and CbYCrY readers %s\n", rgbaYUV ? "ok" : "MISMATCH");
+    ok = ok && rgbaYUV;
+
+    //
+    //  Big enough for any packing, every value shows up
+    //
+
+    std::vector<uint8_t> in(width * height * 6);
+    uint32_t seed = 1;
+
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        in[i] = uint8_t(seed >> 24);
+    }
+
+    for (size_t i = 0; i < sizeof(formats) / sizeof(Format); i++)
+    {
+        const Format& f = formats[i];
+        const size_t outSize = width * height * pixelSize(f.output);
+        std::vector<uint8_t> reference(outSize), simd(outSize), mp(outSize);
+
+        for (int packing = DPX_UNPACK_PACKED; packing <= DPX_UNPACK_FILLED_B; packing++)
+        {
+            for (int swap = 0; swap < 2; swap++)
+            {
+                SIMD::setLevel(SIMD::Scalar);
+                const double scalarSeconds = secondsPerFrame(f, false, &in[0], reference, packing, swap);
+                SIMD::setLevel(detected);
+
+                const double simdSeconds = secondsPerFrame(f, false, &in[0], simd, packing, swap);
+                const double mpSeconds = secondsPerFrame(f, true, &in[0], mp, packing, swap);
+
+                bool agrees = simd == reference && mp == reference;
+
+                if (f.bits == 10 && f.output == RGB16 && packing == DPX_UNPACK_FILLED_A && !swap)
+                {
+                    agrees = agrees && matchesBitfieldReader(&in[0], reference);
+                }
+
+                printf("%-24s %-8s %-7s scalar %f simd %f mp %f sec/frame (%.0f Mpixel/s mp)%s\n", f.name, packingNames[packing],
+                       swap ? "swapped" : "native", scalarSeconds, simdSeconds, mpSeconds, double(width * height) / mpSeconds / 1e6,
+                       agrees ? "" : " MISMATCH");
+
+                ok = ok && agrees;
+            }
+        }
+    }
+
+    TwkFB::ThreadPool::shutdown();
+
+    return ok;
+}
@@ -0,0 +1,18 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Checks the FastConversion.h DPX/Cineon unpack functions against
+//  hand built words and against small images packed by the test in
+//  every packing and byte order, and the Read10Bit RGBA and CbYCrY
+//  readers against hand built pixels. Then measures their throughput
+//  on a 4K frame for each output format, packing and byte order:
+//  scalar, with the SIMD kernels and the _MP versions, checking that
+//  they all agree and that filled method A 10 bit data gives the values
+//  the old bitfield readers did. Returns false if anything is wrong.
+//
+
+bool TestDPXUnpack();
@@ -0,0 +1,298 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestDecodedFrame.h>
+
+#include <IPCore/CompressedFB.h>
+#include <MovieFFMpeg/DecodedFrame.h>
+#include <TwkFB/FrameBuffer.h>
+
+extern "C"
+{
+#include <libavutil/frame.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/mem.h>
+#include <libavutil/pixdesc.h>
+}
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    using namespace TwkFB;
+    using namespace TwkMovie;
+    using namespace std;
+
+    const int width = 1001;
+    const int height = 17;
+    const int padding = 37;
+
+    void freePlane(void* freed, uint8_t* data)
+    {
+        av_free(data);
+        ++*static_cast<int*>(freed);
+    }
+
+    int planeHeight(const AVPixFmtDescriptor* desc, int p)
+    {
+        return p == 1 || p == 2 ? AV_CEIL_RSHIFT(height, desc->log2_chroma_h) : height;
+    }
+
+    int planeSamples(const AVPixFmtDescriptor* desc, int p)
+    {
+        const int w = p == 1 || p == 2 ? AV_CEIL_RSHIFT(width, desc->log2_chroma_w) : width;
+        return desc->comp[1].plane == 1 && desc->comp[2].plane == 1 && p == 1 ? w * 2 : w;
+    }
+
+    //
+    //  Smooth enough for CompressedFB to think it's worth compressing
+    //
+
+    unsigned int sampleValue(int p, int x, int y, int bits) { return unsigned(x / 8 + y + p * 101) & ((1u << bits) - 1); }
+
+    //
+    //  Like a decoder's frame, rows padded past the width and one buffer
+    //  per plane which counts its frees in freed
+    //
+
+    AVFrame* makeFrame(AVPixelFormat format, int* freed)
+    {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+        const int bits = desc->comp[0].depth;
+        AVFrame* frame = av_frame_alloc();
+        frame->format = format;
+        frame->width = width;
+        frame->height = height;
+
+        if (av_image_fill_linesizes(frame->linesize, format, width + padding) < 0)
+        {
+            av_frame_free(&frame);
+            return 0;
+        }
+
+        for (int p = 0; p < av_pix_fmt_count_planes(format); p++)
+        {
+            const size_t size = size_t(frame->linesize[p]) * planeHeight(desc, p);
+            uint8_t* data = static_cast<uint8_t*>(av_malloc(size));
+            memset(data, 0, size);
+            frame->buf[p] = av_buffer_create(data, size, freePlane, freed, 0);
+            frame->data[p] = data;
+
+            for (int y = 0; y < planeHeight(desc, p); y++)
+            {
+                for (int x = 0; x < planeSamples(desc, p); x++)
+                {
+                    if (bits > 8)
+                        reinterpret_cast<uint16_t*>(data + y * frame->linesize[p])[x] = sampleValue(p, x, y, bits);
+                    else
+                        data[y * frame->linesize[p] + x] = sampleValue(p, x, y, bits);
+                }
+            }
+        }
+
+        return frame;
+    }
+
+    //
+    //  The samples of every plane of fb are the ones makeFrame() wrote
+    //  shifted by shift
+    //
+
+    bool samplesMatch(const char* what, const FrameBuffer* fb, const AVPixFmtDescriptor* desc, int shift)
+    {
+        const int bits = desc->comp[0].depth;
+        int p = 0;
+
+        for (const FrameBuffer* plane = fb; plane; plane = plane->nextPlane(), p++)
+        {
+            for (int y = 0; y < planeHeight(desc, p); y++)
+            {
+                for (int x = 0; x < planeSamples(desc, p); x++)
+                {
+                    const unsigned int value = bits > 8 ? plane->scanline<uint16_t>(y)[x] : plane->scanline<unsigned char>(y)[x];
+
+                    if (value != sampleValue(p, x, y, bits) << shift)
+                    {
+                        printf("%s: plane %d pixel %d,%d is %u, expected %u\n", what, p, x, y, value, sampleValue(p, x, y, bits) << shift);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool wrapsUnsharedFrame(AVPixelFormat format)
+    {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+        const int bits = desc->comp[0].depth;
+        const int numPlanes = av_pix_fmt_count_planes(format);
+        const int shift = bits > 8 ? 16 - bits : 0;
+        int freed = 0;
+        AVFrame* frame = makeFrame(format, &freed);
+        uint8_t* data[4] = {frame->data[0], frame->data[1], frame->data[2], frame->data[3]};
+        int linesize[4] = {frame->linesize[0], frame->linesize[1], frame->linesize[2], frame->linesize[3]};
+        bool ok = true;
+
+        FrameBuffer* fb = wrapDecodedFrame(frame, width, height, FrameBuffer::TOPLEFT);
+
+        if (!fb)
+        {
+            printf("%s: an unshared frame wasn't wrapped\n", desc->name);
+            av_frame_free(&frame);
+            return false;
+        }
+
+        if (frame->buf[0] || frame->data[0])
+        {
+            printf("%s: the wrapped frame still holds its buffers\n", desc->name);
+            ok = false;
+        }
+
+        if (int(fb->numPlanes()) != numPlanes)
+        {
+            printf("%s: %d planes, expected %d\n", desc->name, int(fb->numPlanes()), numPlanes);
+            delete fb;
+            av_frame_free(&frame);
+            return false;
+        }
+
+        int p = 0;
+
+        for (const FrameBuffer* plane = fb; plane; plane = plane->nextPlane(), p++)
+        {
+            if (plane->pixels<unsigned char>() != data[p] || int(plane->scanlinePaddedSize()) != linesize[p])
+            {
+                printf("%s: plane %d was copied or its rows don't match the frame's\n", desc->name, p);
+                ok = false;
+            }
+        }
+
+        ok = samplesMatch(desc->name, fb, desc, shift) && ok;
+
+        //
+        //  What the FBCache does with an fb far from the display frame
+        //  and again when it's needed
+        //
+
+        IPCore::CompressedFB* compressed = IPCore::CompressedFB::compress(fb);
+
+        if (!compressed)
+        {
+            printf("%s: the wrapped frame wasn't compressed\n", desc->name);
+            ok = false;
+        }
+        else
+        {
+            fb->releaseData();
+
+            if (freed != numPlanes)
+            {
+                printf("%s: releaseData() freed %d of %d buffers\n", desc->name, freed, numPlanes);
+                ok = false;
+            }
+
+            fb->reallocateData();
+
+            if (!compressed->decompress(fb))
+            {
+                printf("%s: the wrapped frame didn't decompress\n", desc->name);
+                ok = false;
+            }
+
+            p = 0;
+
+            for (const FrameBuffer* plane = fb; plane; plane = plane->nextPlane(), p++)
+            {
+                if (int(plane->scanlinePaddedSize()) != linesize[p])
+                {
+                    printf("%s: plane %d lost its padded rows\n", desc->name, p);
+                    ok = false;
+                }
+            }
+
+            ok = samplesMatch(desc->name, fb, desc, shift) && ok;
+            delete compressed;
+        }
+
+        delete fb;
+        av_frame_free(&frame);
+
+        if (freed != numPlanes)
+        {
+            printf("%s: %d of %d buffers were freed\n", desc->name, freed, numPlanes);
+            ok = false;
+        }
+
+        return ok;
+    }
+
+    bool leavesSharedFrame(AVPixelFormat format)
+    {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+        const int numPlanes = av_pix_fmt_count_planes(format);
+        int freed = 0;
+        AVFrame* frame = makeFrame(format, &freed);
+        AVFrame* other = av_frame_alloc();
+        av_frame_ref(other, frame);
+        bool ok = true;
+
+        if (FrameBuffer* fb = wrapDecodedFrame(frame, width, height, FrameBuffer::TOPLEFT))
+        {
+            printf("%s: a shared frame was wrapped\n", desc->name);
+            delete fb;
+            ok = false;
+        }
+        else
+        {
+            if (!frame->buf[0] || frame->data[0] != other->data[0])
+            {
+                printf("%s: the shared frame lost its buffers\n", desc->name);
+                ok = false;
+            }
+
+            const uint16_t* row = reinterpret_cast<const uint16_t*>(other->data[0] + (height - 1) * other->linesize[0]);
+
+            if (row[width - 1] != sampleValue(0, width - 1, height - 1, desc->comp[0].depth))
+            {
+                printf("%s: the shared frame's samples were shifted\n", desc->name);
+                ok = false;
+            }
+        }
+
+        av_frame_free(&frame);
+
+        if (freed)
+        {
+            printf("%s: buffers were freed while another frame references them\n", desc->name);
+            ok = false;
+        }
+
+        av_frame_free(&other);
+
+        if (freed != numPlanes)
+        {
+            printf("%s: %d of %d buffers were freed\n", desc->name, freed, numPlanes);
+            ok = false;
+        }
+
+        return ok;
+    }
+
+} // namespace
+
+bool TestDecodedFrame()
+{
+    printf("Test TestDecodedFrame\n");
+
+    bool ok = wrapsUnsharedFrame(AV_PIX_FMT_YUV420P10LE);
+    ok = wrapsUnsharedFrame(AV_PIX_FMT_NV12) && ok;
+    ok = leavesSharedFrame(AV_PIX_FMT_YUV420P10LE) && ok;
+
+    return ok;
+}
@@ -0,0 +1,17 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Checks that wrapDecodedFrame() takes the buffers of an unshared
+//  yuv420p10le or nv12 frame without copying them, shifts the 10 bit
+//  samples to the top of their 16 bits in place and frees the buffers
+//  with the FrameBuffer, that it leaves a frame something else
+//  references alone, and that the wrapped planes survive the FBCache's
+//  compress, releaseData() and decompress round trip with their padded
+//  rows. Returns false if not.
+//
+
+bool TestDecodedFrame();
@@ -0,0 +1,199 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestExrConsumedChannels.h>
+
+#include <IOexr/IOexr.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/IO.h>
+
+#include <ImfRgba.h>
+#include <ImfRgbaFile.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace TwkFB;
+
+    typedef FrameBufferIO::ReadRequest ReadRequest;
+
+    const int width = 64;
+    const int height = 48;
+    const char* filename = "TestExrConsumedChannels.exr";
+
+    bool matchesHelpers()
+    {
+        ReadRequest request;
+
+        if (!request.consumesChannel("A") || !request.consumesChannel("diffuse.R"))
+        {
+            printf("empty consumed channels don't consume everything\n");
+            return false;
+        }
+
+        request.consumedChannels.push_back("R");
+        request.consumedChannels.push_back("G");
+        request.consumedChannels.push_back("B");
+
+        if (!request.consumesChannel("R") || !request.consumesChannel("diffuse.G") || !request.consumesChannel("left.diffuse.B")
+            || request.consumesChannel("A") || request.consumesChannel("diffuse.A") || request.consumesChannel("Z"))
+        {
+            printf("RGB doesn't consume exactly R, G and B\n");
+            return false;
+        }
+
+        ReadRequest layered;
+        layered.consumedChannels.push_back("diffuse.R");
+        layered.consumedChannels.push_back("diffuse.A");
+
+        if (!layered.consumesChannel("diffuse.R") || !layered.consumesChannel("A") || layered.consumesChannel("specular.R")
+            || layered.consumesChannel("G"))
+        {
+            printf("qualified names match the wrong channels\n");
+            return false;
+        }
+
+        //
+        //  Same set in any order is the same subset
+        //
+
+        ReadRequest reordered;
+        reordered.consumedChannels.push_back("B");
+        reordered.consumedChannels.push_back("R");
+        reordered.consumedChannels.push_back("G");
+        reordered.consumedChannels.push_back("R");
+
+        if (request.subsetIdentifier().empty() || request.subsetIdentifier() != reordered.subsetIdentifier()
+            || request.subsetIdentifier() == layered.subsetIdentifier())
+        {
+            printf("consumed channel identifiers are %s and %s\n", request.subsetIdentifier().c_str(),
+                   reordered.subsetIdentifier().c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    void writeExr()
+    {
+        std::vector<Imf::Rgba> pixels(width * height);
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                pixels[y * width + x] = Imf::Rgba(float(x) / width, float(y) / height, 0.5f, 0.25f);
+            }
+        }
+
+        Imf::RgbaOutputFile file(filename, width, height, Imf::WRITE_RGBA);
+        file.setFrameBuffer(&pixels.front(), 1, width);
+        file.writePixels(height);
+    }
+
+    //
+    //  All channel names in fb and its planes
+    //
+
+    std::vector<std::string> channelsOf(const FrameBuffer* fb)
+    {
+        std::vector<std::string> names;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane())
+        {
+            for (int c = 0; c < p->numChannels(); c++)
+                names.push_back(p->channelName(c));
+        }
+
+        return names;
+    }
+
+    bool hasChannel(const std::vector<std::string>& names, const std::string& name)
+    {
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (names[i] == name)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool readsChannels(const IOexr& io, const ReadRequest& request, const char* what, bool alpha)
+    {
+        FrameBufferIO::FrameBufferVector fbs;
+        io.readImages(fbs, filename, request);
+
+        bool ok = true;
+
+        if (fbs.size() != 1)
+        {
+            printf("%s read returned %d images\n", what, int(fbs.size()));
+            ok = false;
+        }
+        else
+        {
+            const std::vector<std::string> names = channelsOf(fbs.front());
+
+            if (!hasChannel(names, "R") || !hasChannel(names, "G") || !hasChannel(names, "B") || hasChannel(names, "A") != alpha
+                || names.size() != (alpha ? 4 : 3))
+            {
+                printf("%s read has %d channels%s alpha\n", what, int(names.size()), hasChannel(names, "A") ? " with" : " without");
+                ok = false;
+            }
+
+            if (fbs.front()->width() != width || fbs.front()->height() != height)
+            {
+                printf("%s read is %dx%d\n", what, fbs.front()->width(), fbs.front()->height());
+                ok = false;
+            }
+        }
+
+        for (size_t i = 0; i < fbs.size(); i++)
+            delete fbs[i];
+
+        return ok;
+    }
+
+} // namespace
+
+bool TestExrConsumedChannels()
+{
+    printf("Test TestExrConsumedChannels\n");
+
+    bool ok = matchesHelpers();
+
+    writeExr();
+
+    IOexr io;
+
+    ok = readsChannels(io, ReadRequest(), "whole", true) && ok;
+
+    ReadRequest rgb;
+    rgb.consumedChannels.push_back("R");
+    rgb.consumedChannels.push_back("G");
+    rgb.consumedChannels.push_back("B");
+    ok = readsChannels(io, rgb, "RGB", false) && ok;
+
+    ReadRequest rgba = rgb;
+    rgba.consumedChannels.push_back("A");
+    ok = readsChannels(io, rgba, "RGBA", true) && ok;
+
+    //
+    //  None of the consumed channels exist so everything is read
+    //
+
+    ReadRequest missing;
+    missing.consumedChannels.push_back("Z");
+    ok = readsChannels(io, missing, "missing", true) && ok;
+
+    remove(filename);
+
+    return ok;
+}
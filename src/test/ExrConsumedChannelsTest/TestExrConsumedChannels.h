@@ -0,0 +1,13 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Checks ReadRequest channel matching and that IOexr only decodes
+//  the consumed channels of an RGBA file (and doesn't put alpha back
+//  when RGB alone is consumed). Returns false if anything differs.
+//
+
+bool TestExrConsumedChannels();
@@ -0,0 +1,192 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestFileStream.h>
+
+#include <TwkUtil/FileStream.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace TwkUtil;
+
+    std::string tempName(int i)
+    {
+        return (std::filesystem::temp_directory_path() / ("FileStreamTest_" + std::to_string(i) + ".bin")).string();
+    }
+
+    std::vector<char> contents(size_t size, unsigned int seed)
+    {
+        std::vector<char> data(size);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            data[i] = char(seed >> 24);
+        }
+
+        return data;
+    }
+
+    void writeFile(const std::string& name, const std::vector<char>& data)
+    {
+        std::ofstream out(name.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(&data[0], data.size());
+    }
+
+    bool matches(const FileStream& stream, const std::vector<char>& data, size_t offset = 0)
+    {
+        return stream.data() && size_t(stream.size()) == data.size() - offset
+               && !memcmp(stream.data(), &data[offset], data.size() - offset);
+    }
+
+    bool check(const char* what, bool ok)
+    {
+        printf("%-40s %s\n", what, ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+} // namespace
+
+bool TestFileStream()
+{
+    printf("Test TestFileStream\n");
+
+    //
+    //  Sizes around the 512 byte O_DIRECT blocks and the chunks
+    //
+
+    const size_t sizes[] = {1, 511, 512, 61440, 61441, 3 * 61440 + 7, 1 << 20, (5 << 20) + 123};
+    const size_t numFiles = sizeof(sizes) / sizeof(sizes[0]);
+    std::vector<std::string> names;
+    std::vector<std::vector<char>> data;
+
+    for (size_t i = 0; i < numFiles; i++)
+    {
+        names.push_back(tempName(int(i)));
+        data.push_back(contents(sizes[i], unsigned(i + 1)));
+        writeFile(names.back(), data.back());
+    }
+
+    bool ok = true;
+
+    {
+        bool single = true;
+
+        for (size_t i = 0; i < numFiles; i++)
+        {
+            FileStream a(names[i], FileStream::IOUring);
+            FileStream b(names[i], FileStream::IOUring, 4096 * 3 + 100, 3);
+            single = single && matches(a, data[i]) && matches(b, data[i]);
+        }
+
+        ok = check("one file at a time", single) && ok;
+    }
+
+    {
+        const size_t last = numFiles - 1;
+        FileStream aligned(names[last], 4096, 0, FileStream::IOUring);
+        FileStream unaligned(names[last], 1000, 0, FileStream::IOUring);
+        ok = check("start offset", matches(aligned, data[last], 4096) && matches(unaligned, data[last], 1000)) && ok;
+    }
+
+    {
+        std::vector<FileStream*> streams;
+        FileStream::readMany(names, streams, 8192, 8);
+
+        bool batch = streams.size() == numFiles;
+
+        for (size_t i = 0; batch && i < numFiles; i++)
+        {
+            batch = matches(*streams[i], data[i]);
+        }
+
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            delete streams[i];
+        }
+
+        ok = check("readMany", batch) && ok;
+    }
+
+    {
+        std::vector<std::string> missing(names);
+        missing.insert(missing.begin() + 2, tempName(100));
+        std::vector<FileStream*> streams;
+        bool threw = false;
+
+        try
+        {
+            FileStream::readMany(missing, streams);
+        }
+        catch (...)
+        {
+            threw = true;
+        }
+
+        ok = check("readMany with a missing file", threw && streams.empty()) && ok;
+    }
+
+    {
+        FileStream::readAhead(names);
+
+        //
+        //  The files kept count until a FileStream takes them
+        //
+
+        size_t total = 0;
+
+        for (size_t i = 0; i < numFiles; i++)
+            total += sizes[i];
+
+        bool counted = FileStream::readAheadBytes() == total;
+        bool ahead = true;
+
+        for (size_t i = 0; i < numFiles; i++)
+        {
+            FileStream stream(names[i], FileStream::IOUring);
+            ahead = ahead && matches(stream, data[i]);
+        }
+
+        counted = counted && FileStream::readAheadBytes() == 0;
+
+        //
+        //  A file changed after it was read ahead is read again
+        //
+
+        FileStream::readAhead(names);
+
+        std::vector<char> changed = contents(sizes[3] + 1, 1000);
+        writeFile(names[3], changed);
+
+        FileStream stream(names[3], FileStream::IOUring);
+        ahead = ahead && matches(stream, changed);
+        counted = counted && FileStream::readAheadBytes() == total - sizes[3];
+
+        for (size_t i = 0; i < numFiles; i++)
+        {
+            FileStream taken(names[i], FileStream::IOUring);
+        }
+
+        counted = counted && FileStream::readAheadBytes() == 0;
+
+        ok = check("readAhead", ahead) && ok;
+        ok = check("readAhead bytes", counted) && ok;
+    }
+
+    for (size_t i = 0; i < numFiles; i++)
+    {
+        std::remove(names[i].c_str());
+    }
+
+    return ok;
+}
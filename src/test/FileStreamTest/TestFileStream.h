@@ -0,0 +1,15 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Reads files through FileStream::IOUring (or what it falls back to)
+//  one at a time, in a readMany() batch and after readAhead(): odd
+//  sizes, odd chunk sizes, a start offset, a missing file and a file
+//  changed after it was read ahead. Returns false if any of the data
+//  read is wrong.
+//
+
+bool TestFileStream();
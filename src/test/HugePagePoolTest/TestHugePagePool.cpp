@@ -0,0 +1,155 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestHugePagePool.h>
+
+#include <TwkUtil/HugePagePool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace TwkUtil;
+
+    const size_t MB = 1024 * 1024;
+    const size_t Page = HugePagePool::HugePageSize;
+
+    bool aligned(const void* p) { return p && size_t(p) % Page == 0; }
+
+    bool check(const char* what, bool ok)
+    {
+        printf("%-40s %s\n", what, ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+} // namespace
+
+bool TestHugePagePool()
+{
+    printf("Test TestHugePagePool\n");
+
+    bool ok = true;
+
+    {
+        //
+        //  Multiples of 2MB up to 32MB, then 16 classes per power of two
+        //
+
+        bool classes = HugePagePool::sizeClass(0) == Page && HugePagePool::sizeClass(1) == Page
+                       && HugePagePool::sizeClass(Page) == Page && HugePagePool::sizeClass(Page + 1) == 2 * Page
+                       && HugePagePool::sizeClass(32 * MB) == 32 * MB && HugePagePool::sizeClass(33 * MB) == 34 * MB
+                       && HugePagePool::sizeClass(64 * MB + 1) == 68 * MB && HugePagePool::sizeClass(129 * MB) == 136 * MB;
+
+        for (size_t size = 1; size < 512 * MB; size = size * 3 + 1)
+        {
+            const size_t c = HugePagePool::sizeClass(size);
+            classes = classes && c >= size && c % Page == 0 && c - size < std::max(Page, c / 16);
+        }
+
+        ok = check("sizeClass", classes) && ok;
+    }
+
+    {
+        HugePagePool pool(64 * MB, false, false);
+
+        void* a = pool.alloc(3 * MB);
+        void* b = pool.alloc(Page);
+        memset(a, 1, 3 * MB);
+        memset(b, 2, Page);
+
+        HugePagePool::Stats s = pool.stats();
+        bool stats = aligned(a) && aligned(b) && s.allocs == 2 && s.misses == 2 && s.usedBlocks == 2 && s.usedBytes == 3 * MB + Page
+                     && s.usedClassBytes == 3 * Page && s.freeBlocks == 0 && s.freeBytes == 0;
+
+        //
+        //  A freed block is handed out again for its own size class only
+        //
+
+        int local = 0;
+        bool reuse = pool.dealloc(a) && !pool.dealloc(&local) && !pool.dealloc(0);
+
+        s = pool.stats();
+        stats = stats && s.usedBlocks == 1 && s.usedBytes == Page && s.freeBlocks == 1 && s.freeBytes == 2 * Page;
+
+        void* c = pool.alloc(Page);
+        reuse = reuse && c != a;
+
+        void* d = pool.alloc(2 * Page - 1);
+        reuse = reuse && d == a;
+
+        s = pool.stats();
+        stats = stats && s.allocs == 4 && s.hits + s.remoteHits == 1 && s.misses == 3 && s.usedBlocks == 3 && s.freeBlocks == 0
+                && s.freeBytes == 0 && s.evictions == 0 && s.hitRate() == 0.25f;
+
+        reuse = pool.dealloc(b) && pool.dealloc(c) && pool.dealloc(d) && reuse;
+
+        s = pool.stats();
+        stats = stats && s.usedBlocks == 0 && s.usedBytes == 0 && s.usedClassBytes == 0 && s.freeBlocks == 3 && s.freeBytes == 4 * Page
+                && s.fragmentation() == 1.0f;
+
+        ok = check("alloc/dealloc reuse", reuse) && ok;
+        ok = check("stats", stats) && ok;
+    }
+
+    {
+        //
+        //  Blocks allocated on many threads, so in different arenas,
+        //  then all freed at once into a pool with room for a few
+        //
+
+        const size_t poolBlocks = 4;
+        const size_t numThreads = 16;
+        const size_t perThread = 4;
+        const size_t rounds = 50;
+
+        HugePagePool pool(poolBlocks * Page, false, false);
+        bool limited = true;
+
+        for (size_t r = 0; r < rounds; r++)
+        {
+            std::atomic<size_t> allocated(0);
+            std::atomic<bool> overflow(false);
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < numThreads; t++)
+            {
+                threads.push_back(std::thread(
+                    [&]()
+                    {
+                        void* blocks[perThread];
+
+                        for (size_t i = 0; i < perThread; i++)
+                            blocks[i] = pool.alloc(Page);
+
+                        for (allocated++; allocated < numThreads;)
+                            std::this_thread::yield();
+
+                        for (size_t i = 0; i < perThread; i++)
+                        {
+                            if (!pool.dealloc(blocks[i]) || pool.stats().freeBytes > poolBlocks * Page)
+                                overflow = true;
+                        }
+                    }));
+            }
+
+            for (size_t t = 0; t < threads.size(); t++)
+                threads[t].join();
+
+            const HugePagePool::Stats s = pool.stats();
+            limited = limited && !overflow && s.usedBlocks == 0 && s.freeBytes <= poolBlocks * Page && s.freeBytes == s.freeBlocks * Page
+                      && s.misses == s.evictions + s.freeBlocks;
+        }
+
+        ok = check("pool size under concurrent frees", limited) && ok;
+    }
+
+    return ok;
+}
@@ -0,0 +1,14 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Allocates and frees blocks through a TwkUtil::HugePagePool: reuse of
+//  a freed block, the size classes, the stats, and many threads freeing
+//  at once into a small pool which must never hold more than its size.
+//  Returns false if any of those is wrong.
+//
+
+bool TestHugePagePool();
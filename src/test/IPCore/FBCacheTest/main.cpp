@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <IPCore/FBCache.h>
+#include <IPCore/IPGraph.h>
+#include <IPCore/IPImage.h>
+#include <TwkFB/FrameBuffer.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace IPCore;
+using namespace TwkFB;
+
+namespace
+{
+    const int numFrames = 8;
+    const int size = 256;
+
+    string frameID(int frame)
+    {
+        ostringstream str;
+        str << "FBCacheTest/frame" << frame;
+        return str.str();
+    }
+
+    FrameBuffer* makeFrame(int frame)
+    {
+        FrameBuffer* fb = new FrameBuffer(size, size, 1, FrameBuffer::UCHAR);
+        fb->setIdentifier(frameID(frame));
+
+        for (int y = 0; y < size; y++)
+        {
+            unsigned char* row = fb->scanline<unsigned char>(y);
+
+            for (int x = 0; x < size; x++)
+                row[x] = (unsigned char)(x + y + frame);
+        }
+
+        return fb;
+    }
+
+    bool frameMatches(const FrameBuffer* fb, int frame)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            const unsigned char* row = fb->scanline<unsigned char>(y);
+
+            for (int x = 0; x < size; x++)
+            {
+                if (row[x] != (unsigned char)(x + y + frame))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    //
+    //  What IPGraph::promoteFBsInFrameRange() does for a frame: page its
+    //  ids in without the cache lock, then promote it with the lock
+    //  held. The disk tier's writer thread may not have written the
+    //  frame yet, so try again for a while.
+    //
+
+    bool promote(FBCache& cache, int frame)
+    {
+        IPImageID id(frameID(frame));
+        const chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::seconds(10);
+
+        while (chrono::steady_clock::now() < deadline)
+        {
+            cache.pageInFrame(frame, &id);
+
+            TWK_CACHE_LOCK(cache, "test");
+            const bool promoted = cache.promoteFrame(frame, &id);
+            TWK_CACHE_UNLOCK(cache, "test");
+
+            if (promoted)
+                return true;
+
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+
+        return false;
+    }
+
+} // namespace
+
+TEST_CASE("test promoting frames held by the disk cache")
+{
+    IPGraph graph(0);
+    FBCache& cache = graph.cache();
+
+    cache.setDiskCache(".", size_t(64) << 20);
+    REQUIRE(cache.hasDiskCache());
+
+    TWK_CACHE_LOCK(cache, "test");
+    cache.setMemoryUsage(size_t(64) << 20);
+
+    for (int f = 0; f < numFrames; f++)
+        REQUIRE(cache.add(makeFrame(f), f));
+
+    //
+    //  Unreferenced, the items go to the trash and freeing the trash
+    //  hands them to the disk tier.
+    //
+
+    cache.clearFrameCaches();
+    cache.freeAllTrash();
+
+    for (int f = 0; f < numFrames; f++)
+        CHECK(!cache.isCached(frameID(f)));
+
+    TWK_CACHE_UNLOCK(cache, "test");
+
+    for (int f = 0; f < numFrames; f++)
+    {
+        REQUIRE(promote(cache, f));
+        CHECK(cache.isFrameCached(f));
+
+        TWK_CACHE_LOCK(cache, "test");
+        FrameBuffer* fb = cache.checkOut(frameID(f));
+        REQUIRE(fb);
+        CHECK(frameMatches(fb, f));
+        cache.checkIn(fb);
+        TWK_CACHE_UNLOCK(cache, "test");
+    }
+
+    TWK_CACHE_LOCK(cache, "test");
+    cache.clearFrameCaches();
+    TWK_CACHE_UNLOCK(cache, "test");
+    cache.setDiskCache("", 0);
+}
+
+TEST_CASE("test pinned frame items outlive their frame")
+{
+    IPGraph graph(0);
+    FBCache& cache = graph.cache();
+    const int frame = 1;
+
+    TWK_CACHE_LOCK(cache, "test");
+    cache.setMemoryUsage(size_t(64) << 20);
+    REQUIRE(cache.add(makeFrame(frame), frame));
+    TWK_CACHE_UNLOCK(cache, "test");
+
+    //
+    //  What the display thread does, without the cache lock
+    //
+
+    FBCache::FBVector items;
+    REQUIRE(cache.pinFrameItems(frame, items));
+    REQUIRE(items.size() == 1);
+
+    TWK_CACHE_LOCK(cache, "test");
+    cache.clearFrameCaches();
+    cache.freeAllTrash();
+    CHECK(!cache.isFrameCached(frame));
+    CHECK(cache.isCached(frameID(frame)));
+    TWK_CACHE_UNLOCK(cache, "test");
+
+    CHECK(frameMatches(items.front(), frame));
+    FBCache::unpinItems(items);
+
+    TWK_CACHE_LOCK(cache, "test");
+    cache.freeAllTrash();
+    CHECK(!cache.isCached(frameID(frame)));
+    TWK_CACHE_UNLOCK(cache, "test");
+}
@@ -0,0 +1,275 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestJpegSubset.h>
+
+#include <IOjpeg/IOjpeg.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/IO.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include <jpeglib.h>
+}
+
+namespace
+{
+    using namespace TwkFB;
+
+    typedef FrameBufferIO::ReadRequest ReadRequest;
+
+    const int width = 256;
+    const int height = 192;
+    const char* filename = "TestJpegSubset.jpg";
+
+    //
+    //  Smooth so the DCT scaling and a box filter of the whole image
+    //  come out close
+    //
+
+    void writeJpeg()
+    {
+        std::vector<unsigned char> pixels(width * height * 3);
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                unsigned char* p = &pixels[(y * width + x) * 3];
+                p[0] = (unsigned char)(x * 255 / (width - 1));
+                p[1] = (unsigned char)(y * 255 / (height - 1));
+                p[2] = (unsigned char)((x + y) * 255 / (width + height - 2));
+            }
+        }
+
+        FILE* file = fopen(filename, "wb");
+        jpeg_compress_struct cinfo;
+        jpeg_error_mgr jerr;
+        cinfo.err = jpeg_std_error(&jerr);
+        jpeg_create_compress(&cinfo);
+        jpeg_stdio_dest(&cinfo, file);
+        cinfo.image_width = width;
+        cinfo.image_height = height;
+        cinfo.input_components = 3;
+        cinfo.in_color_space = JCS_RGB;
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, 100, TRUE);
+        jpeg_start_compress(&cinfo, TRUE);
+
+        while (cinfo.next_scanline < cinfo.image_height)
+        {
+            JSAMPROW row = &pixels[cinfo.next_scanline * width * 3];
+            jpeg_write_scanlines(&cinfo, &row, 1);
+        }
+
+        jpeg_finish_compress(&cinfo);
+        jpeg_destroy_compress(&cinfo);
+        fclose(file);
+    }
+
+    //
+    //  Pixel x, y (from the top left) of an uncropped RGB8 fb
+    //
+
+    const unsigned char* pixelAt(const FrameBuffer& fb, int x, int y)
+    {
+        const int row = fb.height() - 1 - (y - fb.uncropY());
+        return fb.scanline<unsigned char>(row) + (x - fb.uncropX()) * 3;
+    }
+
+    bool matchesHelpers()
+    {
+        ReadRequest request;
+
+        if (request.hasResolution() || request.hasRegion() || !request.subsetIdentifier().empty() || request.reductionLevel(8) != 0)
+        {
+            printf("default request isn't the whole image\n");
+            return false;
+        }
+
+        struct Level
+        {
+            float resolution;
+            int maxLevel;
+            int level;
+        };
+
+        const Level levels[] = {{1.0f, 8, 0}, {0.75f, 8, 0}, {0.5f, 8, 1}, {0.3f, 8, 1}, {0.25f, 8, 2}, {0.01f, 8, 6}, {0.01f, 3, 3}};
+
+        for (size_t i = 0; i < sizeof(levels) / sizeof(Level); i++)
+        {
+            request.resolution = levels[i].resolution;
+
+            if (request.reductionLevel(levels[i].maxLevel) != levels[i].level)
+            {
+                printf("resolution %g gives level %d not %d\n", levels[i].resolution, request.reductionLevel(levels[i].maxLevel),
+                       levels[i].level);
+                return false;
+            }
+        }
+
+        //
+        //  Rounded out at the level and clipped to it
+        //
+
+        request.resolution = 0.0f;
+        request.x0 = 3;
+        request.y0 = 5;
+        request.x1 = 10;
+        request.y1 = 300;
+
+        int x0, y0, x1, y1;
+
+        if (!request.regionAtLevel(1, 128, 96, x0, y0, x1, y1) || x0 != 1 || y0 != 2 || x1 != 5 || y1 != 96)
+        {
+            printf("region at level 1 is %d,%d-%d,%d\n", x0, y0, x1, y1);
+            return false;
+        }
+
+        request.x0 = 200;
+        request.x1 = 210;
+
+        if (request.regionAtLevel(1, 64, 48, x0, y0, x1, y1))
+        {
+            printf("region outside the level isn't empty\n");
+            return false;
+        }
+
+        const std::string regionID = request.subsetIdentifier();
+        request.resolution = 0.5f;
+
+        if (regionID.empty() || request.subsetIdentifier().empty() || regionID == request.subsetIdentifier())
+        {
+            printf("subsets share an identifier\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool matchesResolution(const IOjpeg& io, const FrameBuffer& full)
+    {
+        ReadRequest request;
+        request.resolution = 0.5f;
+
+        FrameBuffer fb;
+        io.readImage(fb, filename, request);
+
+        if (fb.width() != width / 2 || fb.height() != height / 2 || fb.uncropWidth() != fb.width() || fb.uncropHeight() != fb.height()
+            || fb.uncropX() != 0 || fb.uncropY() != 0)
+        {
+            printf("half resolution read is %dx%d (%dx%d at %d,%d)\n", fb.width(), fb.height(), fb.uncropWidth(), fb.uncropHeight(),
+                   fb.uncropX(), fb.uncropY());
+            return false;
+        }
+
+        for (int y = 0; y < fb.height(); y++)
+        {
+            for (int x = 0; x < fb.width(); x++)
+            {
+                const unsigned char* p = pixelAt(fb, x, y);
+
+                for (int c = 0; c < 3; c++)
+                {
+                    const int box = (pixelAt(full, x * 2, y * 2)[c] + pixelAt(full, x * 2 + 1, y * 2)[c] + pixelAt(full, x * 2, y * 2 + 1)[c]
+                                     + pixelAt(full, x * 2 + 1, y * 2 + 1)[c] + 2)
+                                    / 4;
+
+                    if (std::abs(int(p[c]) - box) > 4)
+                    {
+                        printf("half resolution pixel %d,%d channel %d is %d not %d\n", x, y, c, int(p[c]), box);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool matchesRegion(const IOjpeg& io, const FrameBuffer& full)
+    {
+        ReadRequest request;
+        request.x0 = 45;
+        request.y0 = 37;
+        request.x1 = 201;
+        request.y1 = 150;
+
+        FrameBuffer fb;
+        io.readImage(fb, filename, request);
+
+        //
+        //  Any superset of the region, placed by the uncrop
+        //
+
+        if (fb.uncropWidth() != width || fb.uncropHeight() != height || fb.uncropX() > request.x0 || fb.uncropY() > request.y0
+            || fb.uncropX() + fb.width() < request.x1 || fb.uncropY() + fb.height() < request.y1 || fb.uncropY() + fb.height() > height)
+        {
+            printf("region read is %dx%d (%dx%d at %d,%d)\n", fb.width(), fb.height(), fb.uncropWidth(), fb.uncropHeight(), fb.uncropX(),
+                   fb.uncropY());
+            return false;
+        }
+
+        //
+        //  Chroma upsampling at the edges of the decoded columns can
+        //  differ a little from the whole image
+        //
+
+        for (int y = request.y0; y < request.y1; y++)
+        {
+            for (int x = request.x0; x < request.x1; x++)
+            {
+                const unsigned char* p = pixelAt(fb, x, y);
+                const unsigned char* q = pixelAt(full, x, y);
+
+                for (int c = 0; c < 3; c++)
+                {
+                    if (std::abs(int(p[c]) - int(q[c])) > 2)
+                    {
+                        printf("region pixel %d,%d channel %d is %d not %d\n", x, y, c, int(p[c]), int(q[c]));
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+} // namespace
+
+bool TestJpegSubset()
+{
+    printf("Test TestJpegSubset\n");
+
+    bool ok = matchesHelpers();
+
+    writeJpeg();
+
+    IOjpeg io;
+    FrameBuffer full;
+    io.readImage(full, filename, ReadRequest());
+
+    if (full.width() != width || full.height() != height || full.numChannels() != 3 || full.needsUncrop())
+    {
+        printf("whole image read is %dx%d with %d channels\n", full.width(), full.height(), full.numChannels());
+        ok = false;
+    }
+    else
+    {
+        ok = matchesResolution(io, full) && ok;
+        ok = matchesRegion(io, full) && ok;
+    }
+
+    remove(filename);
+
+    return ok;
+}
@@ -0,0 +1,14 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Checks the ReadRequest resolution and region helpers and that
+//  IOjpeg's reduced resolution and region reads return the size,
+//  uncrop and pixels of the same part of a whole image read. Returns
+//  false if anything differs.
+//
+
+bool TestJpegSubset();
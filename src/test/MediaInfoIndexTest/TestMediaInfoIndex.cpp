@@ -0,0 +1,251 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestMediaInfoIndex.h>
+
+#include <TwkMovie/MediaInfoIndex.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    using namespace TwkMovie;
+    using namespace TwkFB;
+    using namespace std;
+
+    const char* indexDirectory = "TestMediaInfoIndex.dir";
+    const char* pattern = "TestMediaInfoIndex.1-2#.exr";
+    const char* frameFiles[] = {"TestMediaInfoIndex.0001.exr", "TestMediaInfoIndex.0002.exr"};
+
+    void writeFile(const char* name, const char* contents, bool append = false)
+    {
+        ofstream file(name, append ? ios::app : ios::trunc);
+        file << contents;
+    }
+
+    FBInfo::ChannelInfo channel(const char* name)
+    {
+        FBInfo::ChannelInfo c;
+        c.name = name;
+        c.type = FrameBuffer::HALF;
+        return c;
+    }
+
+    bool makeEntry(MediaInfoIndex::Entry& entry)
+    {
+        entry.path = pattern;
+        entry.plugin = "IOexr";
+
+        MovieInfo& info = entry.info;
+        info.width = 1920;
+        info.height = 1080;
+        info.uncropWidth = 2048;
+        info.uncropHeight = 1152;
+        info.uncropX = 64;
+        info.uncropY = 36;
+        info.pixelAspect = 2.0f;
+        info.numChannels = 4;
+        info.dataType = FrameBuffer::HALF;
+        info.orientation = FrameBuffer::TOPLEFT;
+        info.start = 1;
+        info.end = 2;
+        info.inc = 1;
+        info.fps = 23.976;
+        info.views.push_back("left");
+        info.views.push_back("right");
+        info.defaultView = "left";
+        info.layers.push_back("diffuse");
+
+        const char* names[] = {"R", "G", "B", "A"};
+
+        for (int i = 0; i < 4; i++)
+            info.channelInfos.push_back(channel(names[i]));
+
+        FBInfo::ViewInfo view;
+        view.name = "left";
+        view.layers.resize(1);
+        view.layers[0].name = "diffuse";
+        view.layers[0].channels = info.channelInfos;
+        info.viewInfos.push_back(view);
+
+        info.proxy.newAttribute<string>("EXR/compression", "PIZ");
+        info.proxy.newAttribute<int>("EXR/version", 2);
+        info.proxy.newAttribute<float>("FPS", 23.976f);
+
+        for (int i = 0; i < 2; i++)
+        {
+            writeFile(frameFiles[i], "frame");
+            entry.frames.push_back(i + 1);
+            entry.files.push_back(frameFiles[i]);
+        }
+
+        return MediaInfoIndex::addStamp(".", entry.stamps) && MediaInfoIndex::addStamp(frameFiles[0], entry.stamps)
+               && MediaInfoIndex::addStamp(frameFiles[1], entry.stamps);
+    }
+
+    bool sameEntry(const MediaInfoIndex::Entry& a, const MediaInfoIndex::Entry& b)
+    {
+        const MovieInfo& ai = a.info;
+        const MovieInfo& bi = b.info;
+
+        if (a.path != b.path || a.plugin != b.plugin || a.frames != b.frames || a.files != b.files
+            || a.stamps.size() != b.stamps.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.stamps.size(); i++)
+        {
+            if (a.stamps[i].path != b.stamps[i].path || a.stamps[i].mtime != b.stamps[i].mtime || a.stamps[i].size != b.stamps[i].size)
+                return false;
+        }
+
+        if (ai.width != bi.width || ai.height != bi.height || ai.uncropWidth != bi.uncropWidth || ai.uncropHeight != bi.uncropHeight
+            || ai.uncropX != bi.uncropX || ai.uncropY != bi.uncropY || ai.pixelAspect != bi.pixelAspect
+            || ai.numChannels != bi.numChannels || ai.dataType != bi.dataType || ai.orientation != bi.orientation
+            || ai.start != bi.start || ai.end != bi.end || ai.inc != bi.inc || ai.fps != bi.fps || ai.views != bi.views
+            || ai.defaultView != bi.defaultView || ai.layers != bi.layers || ai.channelInfos.size() != bi.channelInfos.size()
+            || ai.viewInfos.size() != bi.viewInfos.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < ai.channelInfos.size(); i++)
+        {
+            if (ai.channelInfos[i].name != bi.channelInfos[i].name || ai.channelInfos[i].type != bi.channelInfos[i].type)
+                return false;
+        }
+
+        if (bi.viewInfos.empty() || bi.viewInfos[0].name != "left" || bi.viewInfos[0].layers.size() != 1
+            || bi.viewInfos[0].layers[0].name != "diffuse" || bi.viewInfos[0].layers[0].channels.size() != 4)
+        {
+            return false;
+        }
+
+        return bi.proxy.hasAttribute("EXR/compression") && bi.proxy.attribute<string>("EXR/compression") == "PIZ"
+               && bi.proxy.hasAttribute("EXR/version") && bi.proxy.attribute<int>("EXR/version") == 2 && bi.proxy.hasAttribute("FPS")
+               && bi.proxy.attribute<float>("FPS") == 23.976f;
+    }
+
+    bool roundTrips()
+    {
+        MediaInfoIndex::Entry entry;
+
+        if (!makeEntry(entry))
+        {
+            printf("ERROR: couldn't stamp the test files\n");
+            return false;
+        }
+
+        MediaInfoIndex::store(entry);
+
+        MediaInfoIndex::Entry found;
+
+        if (!MediaInfoIndex::contains(pattern) || !MediaInfoIndex::find(pattern, found))
+        {
+            printf("stored entry for %s wasn't found in %s\n", pattern, MediaInfoIndex::directory().c_str());
+            return false;
+        }
+
+        if (!sameEntry(entry, found))
+        {
+            printf("entry for %s doesn't read back the same\n", pattern);
+            return false;
+        }
+
+        MediaInfoIndex::Entry missing;
+
+        if (MediaInfoIndex::find("TestMediaInfoIndex.unindexed.exr", missing))
+        {
+            printf("found an entry that was never stored\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    //
+    //  A changed file and then a missing one each make validate()
+    //  drop the entry, an unchanged one keeps it
+    //
+
+    bool invalidates()
+    {
+        MediaInfoIndex::Entry entry;
+        bool ok = true;
+
+        if (!makeEntry(entry))
+        {
+            printf("ERROR: couldn't stamp the test files\n");
+            return false;
+        }
+
+        MediaInfoIndex::store(entry);
+
+        if (!MediaInfoIndex::validate(pattern, entry.stamps) || !MediaInfoIndex::contains(pattern))
+        {
+            printf("unchanged entry didn't validate\n");
+            ok = false;
+        }
+
+        writeFile(frameFiles[1], " rendered again", true);
+
+        if (MediaInfoIndex::validate(pattern, entry.stamps) || MediaInfoIndex::contains(pattern))
+        {
+            printf("entry validated after %s changed\n", frameFiles[1]);
+            ok = false;
+        }
+
+        makeEntry(entry);
+        MediaInfoIndex::store(entry);
+        remove(frameFiles[0]);
+
+        if (MediaInfoIndex::validate(pattern, entry.stamps) || MediaInfoIndex::contains(pattern))
+        {
+            printf("entry validated after %s was removed\n", frameFiles[0]);
+            ok = false;
+        }
+
+        return ok;
+    }
+
+} // namespace
+
+bool TestMediaInfoIndex()
+{
+    printf("Test TestMediaInfoIndex\n");
+
+    MediaInfoIndex::setDefaultDirectory(indexDirectory);
+
+    if (!MediaInfoIndex::enabled())
+    {
+        printf("RV_MEDIA_INFO_INDEX is off, nothing to test\n");
+        return true;
+    }
+
+    MediaInfoIndex::resetStats();
+
+    bool ok = roundTrips();
+    ok = invalidates() && ok;
+
+    const MediaInfoIndex::Stats stats = MediaInfoIndex::stats();
+
+    if (stats.stores != 3 || stats.hits != 1 || stats.misses != 1 || stats.stale != 2)
+    {
+        printf("stats are %d stores, %d hits, %d misses, %d stale\n", int(stats.stores), int(stats.hits), int(stats.misses),
+               int(stats.stale));
+        ok = false;
+    }
+
+    MediaInfoIndex::remove(pattern);
+    remove(frameFiles[0]);
+    remove(frameFiles[1]);
+    remove(indexDirectory);
+
+    return ok;
+}
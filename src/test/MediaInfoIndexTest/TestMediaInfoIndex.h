@@ -0,0 +1,13 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Stores a MediaInfoIndex entry and checks it reads back the same,
+//  then that validate() rejects and removes it once a stamped file
+//  changes or goes away. Returns false if anything differs.
+//
+
+bool TestMediaInfoIndex();
@@ -0,0 +1,459 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestPacketIndex.h>
+
+#include <MovieFFMpeg/PacketIndex.h>
+#include <TwkMovie/MediaInfoIndex.h>
+#include <TwkUtil/Timer.h>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/frame.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace TwkMovie;
+    using namespace std;
+
+    const int width = 320;
+    const int height = 240;
+    const int gopSize = 96;
+    const char* indexDirectory = "TestPacketIndex.dir";
+    const char* filename = "TestPacketIndex.ts";
+
+    //
+    //  No B frames so decode order is presentation order
+    //
+
+    bool writeMovie(int frames)
+    {
+        const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+        AVFormatContext* format = 0;
+
+        if (!codec || avformat_alloc_output_context2(&format, 0, "mpegts", filename) < 0)
+            return false;
+
+        AVStream* stream = avformat_new_stream(format, 0);
+        AVCodecContext* encoder = avcodec_alloc_context3(codec);
+        encoder->width = width;
+        encoder->height = height;
+        encoder->time_base = AVRational{1, 25};
+        encoder->framerate = AVRational{25, 1};
+        encoder->pix_fmt = AV_PIX_FMT_YUV420P;
+        encoder->gop_size = gopSize;
+        encoder->max_b_frames = 0;
+
+        bool ok = stream && avcodec_open2(encoder, codec, 0) >= 0 && avcodec_parameters_from_context(stream->codecpar, encoder) >= 0
+                  && avio_open(&format->pb, filename, AVIO_FLAG_WRITE) >= 0;
+
+        if (ok)
+        {
+            stream->time_base = encoder->time_base;
+            ok = avformat_write_header(format, 0) >= 0;
+        }
+
+        AVFrame* frame = av_frame_alloc();
+        AVPacket* packet = av_packet_alloc();
+        frame->format = AV_PIX_FMT_YUV420P;
+        frame->width = width;
+        frame->height = height;
+        ok = ok && av_frame_get_buffer(frame, 0) >= 0;
+
+        for (int i = 0; ok && i <= frames; i++)
+        {
+            AVFrame* in = 0;
+
+            if (i < frames)
+            {
+                ok = av_frame_make_writable(frame) >= 0;
+
+                for (int p = 0; ok && p < 3; p++)
+                {
+                    const int h = p ? height / 2 : height;
+                    const int w = p ? width / 2 : width;
+
+                    for (int y = 0; y < h; y++)
+                    {
+                        for (int x = 0; x < w; x++)
+                            frame->data[p][y * frame->linesize[p] + x] = uint8_t(x + y * (p + 1) + i * 3);
+                    }
+                }
+
+                frame->pts = i;
+                in = frame;
+            }
+
+            ok = ok && avcodec_send_frame(encoder, in) >= 0;
+
+            while (ok && avcodec_receive_packet(encoder, packet) == 0)
+            {
+                av_packet_rescale_ts(packet, encoder->time_base, stream->time_base);
+                packet->stream_index = stream->index;
+                ok = av_interleaved_write_frame(format, packet) >= 0;
+            }
+        }
+
+        if (ok)
+            ok = av_write_trailer(format) >= 0;
+
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&encoder);
+        if (format->pb)
+            avio_closep(&format->pb);
+        avformat_free_context(format);
+
+        return ok;
+    }
+
+    //
+    //  The timestamp of every video packet, and of the keyframes
+    //  among them, as the demuxer reports them
+    //
+
+    bool demuxMovie(vector<int64_t>& timestamps, vector<int64_t>& keyframes)
+    {
+        AVFormatContext* format = 0;
+
+        if (avformat_open_input(&format, filename, 0, 0) != 0)
+            return false;
+
+        timestamps.clear();
+        keyframes.clear();
+
+        AVPacket* packet = av_packet_alloc();
+
+        if (avformat_find_stream_info(format, 0) >= 0)
+        {
+            while (av_read_frame(format, packet) >= 0)
+            {
+                const int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+
+                if (packet->stream_index == 0 && ts != AV_NOPTS_VALUE)
+                {
+                    timestamps.push_back(ts);
+                    if (packet->flags & AV_PKT_FLAG_KEY)
+                        keyframes.push_back(ts);
+                }
+
+                av_packet_unref(packet);
+            }
+        }
+
+        av_packet_free(&packet);
+        avformat_close_input(&format);
+
+        return !keyframes.empty();
+    }
+
+    bool waitUntilComplete(const PacketIndex& index)
+    {
+        for (int i = 0; i < 3000 && !index.complete(); i++)
+            this_thread::sleep_for(chrono::milliseconds(10));
+
+        return index.complete();
+    }
+
+    //
+    //  Every packet's lookup gives the last keyframe at or before it and
+    //  the first one after it
+    //
+
+    bool findsKeyframes(const PacketIndex& index, const vector<int64_t>& timestamps, const vector<int64_t>& keyframes, const char* what)
+    {
+        for (size_t i = 0; i < timestamps.size(); i++)
+        {
+            int64_t expected = keyframes.front();
+
+            for (size_t k = 0; k < keyframes.size() && keyframes[k] <= timestamps[i]; k++)
+                expected = keyframes[k];
+
+            PacketIndex::Keyframe keyframe;
+
+            if (!index.keyframeBefore(0, timestamps[i], keyframe) || keyframe.ts != expected)
+            {
+                printf("%s index gives keyframe %lld for %lld, expected %lld\n", what, (long long)keyframe.ts, (long long)timestamps[i],
+                       (long long)expected);
+                return false;
+            }
+
+            vector<int64_t>::const_iterator next = upper_bound(keyframes.begin(), keyframes.end(), timestamps[i]);
+            const bool found = index.keyframeAfter(0, timestamps[i], keyframe);
+
+            if (found != (next != keyframes.end()) || (found && keyframe.ts != *next))
+            {
+                printf("%s index gives next keyframe %lld for %lld, expected %lld\n", what, found ? (long long)keyframe.ts : -1LL,
+                       (long long)timestamps[i], next != keyframes.end() ? (long long)*next : -1LL);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool fileExists(const string& name) { return bool(ifstream(name.c_str())); }
+
+    bool buildsLoadsAndInvalidates()
+    {
+        vector<int64_t> timestamps;
+        vector<int64_t> keyframes;
+        const vector<int> streams(1, 0);
+        bool ok = true;
+
+        if (!writeMovie(gopSize * 4 + 17) || !demuxMovie(timestamps, keyframes))
+        {
+            printf("ERROR: couldn't write %s\n", filename);
+            return false;
+        }
+
+        const string sidecar = MediaInfoIndex::sidecarFile(filename, ".rvpi");
+        remove(sidecar.c_str());
+
+        {
+            shared_ptr<PacketIndex> index = PacketIndex::acquire(filename, streams);
+
+            if (index->loaded() || !waitUntilComplete(*index) || !findsKeyframes(*index, timestamps, keyframes, "built"))
+            {
+                printf("building the index of %s failed\n", filename);
+                ok = false;
+            }
+
+            if (PacketIndex::acquire(filename, streams) != index || PacketIndex::numShared() != 1)
+            {
+                printf("readers of %s don't share one index\n", filename);
+                ok = false;
+            }
+        }
+
+        //
+        //  The last reader letting go drops the shared entry
+        //
+
+        if (PacketIndex::numShared() != 0)
+        {
+            printf("%d indexes are still shared after their readers let go\n", int(PacketIndex::numShared()));
+            ok = false;
+        }
+
+        if (!fileExists(sidecar))
+        {
+            printf("no sidecar index %s was saved\n", sidecar.c_str());
+            return false;
+        }
+
+        {
+            shared_ptr<PacketIndex> index = PacketIndex::acquire(filename, streams);
+
+            if (!index->loaded() || !index->complete() || !findsKeyframes(*index, timestamps, keyframes, "loaded"))
+            {
+                printf("the sidecar index of %s wasn't loaded back\n", filename);
+                ok = false;
+            }
+        }
+
+        //
+        //  A rewritten movie has another size, the sidecar is ignored
+        //  and rebuilt
+        //
+
+        if (!writeMovie(gopSize * 2 + 5) || !demuxMovie(timestamps, keyframes))
+        {
+            printf("ERROR: couldn't rewrite %s\n", filename);
+            return false;
+        }
+
+        {
+            shared_ptr<PacketIndex> index = PacketIndex::acquire(filename, streams);
+
+            if (index->loaded() || !waitUntilComplete(*index) || !findsKeyframes(*index, timestamps, keyframes, "rebuilt"))
+            {
+                printf("the index of the rewritten %s wasn't rebuilt\n", filename);
+                ok = false;
+            }
+        }
+
+        remove(sidecar.c_str());
+        return ok;
+    }
+
+    //
+    //  Seeks to each target and decodes until it's reached, either
+    //  with the demuxer's timestamp seek or a byte seek to the
+    //  indexed keyframe. Returns the number of targets not reached
+    //  exactly.
+    //
+
+    int seekToTargets(const PacketIndex* index, const vector<int64_t>& targets, double& seconds, size_t& decoded)
+    {
+        AVFormatContext* format = 0;
+
+        if (avformat_open_input(&format, filename, 0, 0) != 0)
+            return int(targets.size());
+
+        const AVCodec* codec = 0;
+        AVCodecContext* decoder = 0;
+
+        if (avformat_find_stream_info(format, 0) >= 0 && (codec = avcodec_find_decoder(format->streams[0]->codecpar->codec_id)))
+        {
+            decoder = avcodec_alloc_context3(codec);
+            avcodec_parameters_to_context(decoder, format->streams[0]->codecpar);
+
+            if (avcodec_open2(decoder, codec, 0) < 0)
+                avcodec_free_context(&decoder);
+        }
+
+        if (!decoder)
+        {
+            avformat_close_input(&format);
+            return int(targets.size());
+        }
+
+        AVPacket* packet = av_packet_alloc();
+        AVFrame* frame = av_frame_alloc();
+        int missed = 0;
+
+        seconds = 0;
+        decoded = 0;
+
+        for (size_t t = 0; t < targets.size(); t++)
+        {
+            TwkUtil::Timer timer(true);
+            PacketIndex::Keyframe keyframe;
+
+            avcodec_flush_buffers(decoder);
+
+            if (!index || !index->keyframeBefore(0, targets[t], keyframe))
+                av_seek_frame(format, 0, targets[t], AVSEEK_FLAG_BACKWARD);
+            else if (keyframe.pos < 0 || av_seek_frame(format, 0, keyframe.pos, AVSEEK_FLAG_BYTE) < 0)
+                av_seek_frame(format, 0, keyframe.dts != AV_NOPTS_VALUE ? keyframe.dts : keyframe.ts, AVSEEK_FLAG_BACKWARD);
+
+            int64_t reached = AV_NOPTS_VALUE;
+
+            while (reached == AV_NOPTS_VALUE && av_read_frame(format, packet) >= 0)
+            {
+                if (packet->stream_index == 0 && avcodec_send_packet(decoder, packet) >= 0)
+                {
+                    while (avcodec_receive_frame(decoder, frame) == 0)
+                    {
+                        decoded++;
+
+                        if (reached == AV_NOPTS_VALUE && frame->best_effort_timestamp >= targets[t])
+                            reached = frame->best_effort_timestamp;
+                    }
+                }
+
+                av_packet_unref(packet);
+            }
+
+            seconds += timer.elapsed();
+
+            if (reached != targets[t])
+                missed++;
+        }
+
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&decoder);
+        avformat_close_input(&format);
+
+        return missed;
+    }
+
+    //
+    //  Prints the seek latency with and without the index. Only a
+    //  seek to the indexed keyframe has to land on every target.
+    //
+
+    bool measuresSeeks()
+    {
+        vector<int64_t> timestamps;
+        vector<int64_t> keyframes;
+
+        if (!writeMovie(gopSize * 6) || !demuxMovie(timestamps, keyframes))
+        {
+            printf("ERROR: couldn't write %s\n", filename);
+            return false;
+        }
+
+        //
+        //  Late in each GOP and jumping back and forth
+        //
+
+        vector<int64_t> targets;
+
+        for (size_t i = gopSize - 7; i < timestamps.size(); i += gopSize * 2)
+            targets.push_back(timestamps[i]);
+
+        for (size_t i = gopSize * 2 - 11; i < timestamps.size(); i += gopSize * 2)
+            targets.push_back(timestamps[i]);
+
+        shared_ptr<PacketIndex> index = PacketIndex::acquire(filename, vector<int>(1, 0));
+
+        if (!waitUntilComplete(*index))
+        {
+            printf("indexing %s didn't finish\n", filename);
+            return false;
+        }
+
+        double demuxerSeconds = 0;
+        double indexSeconds = 0;
+        size_t demuxerDecoded = 0;
+        size_t indexDecoded = 0;
+
+        const int demuxerMissed = seekToTargets(0, targets, demuxerSeconds, demuxerDecoded);
+        const int indexMissed = seekToTargets(index.get(), targets, indexSeconds, indexDecoded);
+
+        const double n = double(targets.size());
+
+        printf("%d seeks, demuxer %f ms %.1f frames decoded %d missed, packet index %f ms %.1f frames decoded %d missed\n",
+               int(targets.size()), 1000.0 * demuxerSeconds / n, demuxerDecoded / n, demuxerMissed, 1000.0 * indexSeconds / n,
+               indexDecoded / n, indexMissed);
+
+        if (indexMissed)
+        {
+            printf("seeking to the indexed keyframe missed %d of %d targets\n", indexMissed, int(targets.size()));
+            return false;
+        }
+
+        return true;
+    }
+
+} // namespace
+
+bool TestPacketIndex()
+{
+    printf("Test TestPacketIndex\n");
+
+    MediaInfoIndex::setDefaultDirectory(indexDirectory);
+
+    if (!MediaInfoIndex::enabled())
+    {
+        printf("RV_MEDIA_INFO_INDEX is off, nothing to test\n");
+        return true;
+    }
+
+    bool ok = buildsLoadsAndInvalidates();
+    ok = measuresSeeks() && ok;
+
+    remove(MediaInfoIndex::sidecarFile(filename, ".rvpi").c_str());
+    remove(filename);
+    remove(indexDirectory);
+
+    return ok;
+}
@@ -0,0 +1,16 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Writes a long GOP MPEG-TS movie and checks the keyframes its
+//  PacketIndex finds, that the index is saved and loaded back as a
+//  .rvpi sidecar, that rewriting the movie rebuilds it and that the
+//  shared indexes are dropped when their last reader lets go. Prints
+//  the seek to frame latency of the demuxer's own seek and of a seek
+//  to the indexed keyframe. Returns false if anything differs.
+//
+
+bool TestPacketIndex();
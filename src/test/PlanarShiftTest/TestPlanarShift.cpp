@@ -0,0 +1,219 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestPlanarShift.h>
+
+#include <TwkFB/FastConversion.h>
+#include <TwkFB/SIMDKernels.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <TwkUtil/Timer.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    using namespace TwkFB;
+
+    const size_t width = 3840;
+    const size_t height = 2160;
+    const size_t tryCount = 3;
+
+    //
+    //  Decoders pad their rows, the FrameBuffers don't
+    //
+
+    const size_t inPadding = 64;
+
+    //
+    //  Widths which aren't a multiple of any SIMD width, so the kernels'
+    //  scalar tails run on every row. The output rows are followed by a
+    //  guard the shift must not touch.
+    //
+
+    const size_t oddWidths[] = {1001, 1921};
+    const size_t oddHeight = 17;
+    const size_t outGuard = 32;
+    const uint16_t guardValue = 0xdead;
+
+    struct Format
+    {
+        const char* name;
+        int bits;
+        int log2ChromaW;
+        int log2ChromaH;
+    };
+
+    Format formats[] = {
+        {"yuv420p10le", 10, 1, 1},
+        {"yuv422p10le", 10, 1, 0},
+        {"yuv444p12le", 12, 0, 0},
+        {"gbrp16le", 16, 0, 0},
+    };
+
+    struct Plane
+    {
+        size_t width;
+        size_t height;
+        std::vector<uint16_t> in;
+        std::vector<uint16_t> out;
+
+        size_t inStride() const { return (width + inPadding) * 2; }
+
+        size_t outStride() const { return width * 2; }
+    };
+
+    void shift(const Format& f, bool mp, std::vector<Plane>& planes)
+    {
+        for (size_t p = 0; p < planes.size(); p++)
+        {
+            Plane& pl = planes[p];
+            (mp ? planarN_to_planar16_MP : planarN_to_planar16)(pl.width, pl.height, &pl.in[0], pl.inStride(), &pl.out[0], pl.outStride(),
+                                                                  f.bits);
+        }
+    }
+
+    //
+    //  So each pass has to write every pixel itself
+    //
+
+    void clearOutput(std::vector<Plane>& planes)
+    {
+        for (size_t p = 0; p < planes.size(); p++)
+        {
+            planes[p].out.assign(planes[p].out.size(), guardValue);
+        }
+    }
+
+    double secondsPerFrame(const Format& f, bool mp, std::vector<Plane>& planes)
+    {
+        clearOutput(planes);
+        TwkUtil::Timer timer(true);
+
+        for (size_t t = 0; t < tryCount; t++)
+        {
+            shift(f, mp, planes);
+        }
+
+        return timer.elapsed() / tryCount;
+    }
+
+    bool matchesReference(const Format& f, const std::vector<Plane>& planes)
+    {
+        for (size_t p = 0; p < planes.size(); p++)
+        {
+            const Plane& pl = planes[p];
+
+            for (size_t y = 0; y < pl.height; y++)
+            {
+                for (size_t x = 0; x < pl.width; x++)
+                {
+                    const uint16_t v = pl.in[y * (pl.width + inPadding) + x];
+                    if (pl.out[y * pl.width + x] != uint16_t(v << (16 - f.bits)))
+                        return false;
+                }
+            }
+
+            for (size_t i = pl.width * pl.height; i < pl.out.size(); i++)
+            {
+                if (pl.out[i] != guardValue)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    void makePlanes(const Format& f, size_t w, size_t h, std::vector<Plane>& planes)
+    {
+        uint32_t seed = 1;
+
+        for (size_t p = 0; p < planes.size(); p++)
+        {
+            Plane& pl = planes[p];
+            pl.width = p ? (w + (1 << f.log2ChromaW) - 1) >> f.log2ChromaW : w;
+            pl.height = p ? (h + (1 << f.log2ChromaH) - 1) >> f.log2ChromaH : h;
+            pl.in.resize((pl.width + inPadding) * pl.height);
+            pl.out.assign(pl.width * pl.height + outGuard, guardValue);
+
+            for (size_t j = 0; j < pl.in.size(); j++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                pl.in[j] = uint16_t((seed >> 16) & ((1u << f.bits) - 1));
+            }
+        }
+    }
+
+    bool oddWidthsMatch(const Format& f, SIMD::Level detected)
+    {
+        bool ok = true;
+
+        for (size_t i = 0; i < sizeof(oddWidths) / sizeof(size_t); i++)
+        {
+            std::vector<Plane> planes(3);
+            makePlanes(f, oddWidths[i], oddHeight, planes);
+
+            SIMD::setLevel(SIMD::Scalar);
+            shift(f, false, planes);
+            bool agrees = matchesReference(f, planes);
+            SIMD::setLevel(detected);
+
+            clearOutput(planes);
+            shift(f, false, planes);
+            agrees = agrees && matchesReference(f, planes);
+
+            clearOutput(planes);
+            shift(f, true, planes);
+            agrees = agrees && matchesReference(f, planes);
+
+            if (!agrees)
+                printf("%-12s MISMATCH at width %zu\n", f.name, oddWidths[i]);
+
+            ok = ok && agrees;
+        }
+
+        return ok;
+    }
+
+} // namespace
+
+bool TestPlanarShift()
+{
+    const SIMD::Level detected = SIMD::detectedLevel();
+    bool ok = true;
+
+    printf("Test TestPlanarShift (%s)\n", SIMD::levelName(detected));
+
+    TwkFB::ThreadPool::initialize();
+
+    for (size_t i = 0; i < sizeof(formats) / sizeof(Format); i++)
+    {
+        const Format& f = formats[i];
+        std::vector<Plane> planes(3);
+        makePlanes(f, width, height, planes);
+
+        SIMD::setLevel(SIMD::Scalar);
+        const double scalarSeconds = secondsPerFrame(f, false, planes);
+        bool agrees = matchesReference(f, planes);
+        SIMD::setLevel(detected);
+
+        const double simdSeconds = secondsPerFrame(f, false, planes);
+        agrees = agrees && matchesReference(f, planes);
+
+        const double mpSeconds = secondsPerFrame(f, true, planes);
+        agrees = agrees && matchesReference(f, planes);
+
+        printf("%-12s scalar %f simd %f mp %f sec/frame (%.0f Mpixel/s mp)%s\n", f.name, scalarSeconds, simdSeconds, mpSeconds,
+               double(width * height) / mpSeconds / 1e6, agrees ? "" : " MISMATCH");
+
+        const bool oddAgrees = oddWidthsMatch(f, detected);
+        ok = ok && agrees && oddAgrees;
+    }
+
+    TwkFB::ThreadPool::shutdown();
+
+    return ok;
+}
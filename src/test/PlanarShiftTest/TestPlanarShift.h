@@ -0,0 +1,17 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Measures the throughput of planarN_to_planar16() on a UHD frame for
+//  the planar layouts FFmpeg decoders hand MovieFFMpeg (yuv420p10le,
+//  yuv422p10le, yuv444p12le and gbrp16le): scalar, with the SIMD
+//  kernels and the _MP version. Checks that they all give v << (16 -
+//  bits), what sws_scale() gives, there and at odd widths where the
+//  kernels' scalar tails run, without writing past the end of the
+//  rows. Returns false if not.
+//
+
+bool TestPlanarShift();
@@ -0,0 +1,195 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestResize.h>
+
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/Resize.h>
+#include <TwkFB/SIMDKernels.h>
+#include <TwkUtil/Timer.h>
+#include <half.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    using namespace TwkFB;
+
+    const size_t tryCount = 3;
+
+    struct Case
+    {
+        const char* name;
+        int fromWidth;
+        int fromHeight;
+        int toWidth;
+        int toHeight;
+        FrameBuffer::DataType type;
+        bool planar420;
+    };
+
+    Case cases[] = {
+        {"8K -> 2K RGBA float", 7680, 4320, 1920, 1080, FrameBuffer::FLOAT, false},
+        {"8K -> 2K RGBA half", 7680, 4320, 1920, 1080, FrameBuffer::HALF, false},
+        {"8K -> 2K 4:2:0 ushort", 7680, 4320, 1920, 1080, FrameBuffer::USHORT, true},
+        {"4K -> HD RGBA float", 3840, 2160, 1920, 1080, FrameBuffer::FLOAT, false},
+        {"4K -> HD RGBA half", 3840, 2160, 1920, 1080, FrameBuffer::HALF, false},
+        {"4K -> HD 4:2:0 ushort", 3840, 2160, 1920, 1080, FrameBuffer::USHORT, true},
+    };
+
+    ResizeFilter filters[] = {BoxFilter, TriangleFilter, MitchellFilter, Lanczos3Filter};
+
+    float sourceValue(size_t x, size_t y) { return float((x * 7 + y * 131) % 997) / 997.0f; }
+
+    void setValue(FrameBuffer* fb, int y, size_t i, float v)
+    {
+        switch (fb->dataType())
+        {
+        case FrameBuffer::USHORT:
+            fb->scanline<unsigned short>(y)[i] = (unsigned short)(v * 65535.0f + 0.5f);
+            break;
+        case FrameBuffer::HALF:
+            fb->scanline<half>(y)[i] = half(v);
+            break;
+        default:
+            fb->scanline<float>(y)[i] = v;
+            break;
+        }
+    }
+
+    float value(const FrameBuffer* fb, int y, size_t i)
+    {
+        switch (fb->dataType())
+        {
+        case FrameBuffer::USHORT:
+            return fb->scanline<unsigned short>(y)[i] / 65535.0f;
+        case FrameBuffer::HALF:
+            return fb->scanline<half>(y)[i];
+        default:
+            return fb->scanline<float>(y)[i];
+        }
+    }
+
+    FrameBuffer* newPlane(int w, int h, int nc, FrameBuffer::DataType type, bool flat)
+    {
+        FrameBuffer* fb = new FrameBuffer(w, h, nc, type);
+        const size_t n = size_t(w) * nc;
+
+        for (int y = 0; y < h; y++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                setValue(fb, y, i, flat ? 0.25f : sourceValue(i, y));
+            }
+        }
+
+        return fb;
+    }
+
+    FrameBuffer* newSource(const Case& c, bool flat)
+    {
+        if (!c.planar420)
+            return newPlane(c.fromWidth, c.fromHeight, 4, c.type, flat);
+
+        FrameBuffer* fb = newPlane(c.fromWidth, c.fromHeight, 1, c.type, flat);
+        fb->appendPlane(newPlane(c.fromWidth / 2, c.fromHeight / 2, 1, c.type, flat));
+        fb->appendPlane(newPlane(c.fromWidth / 2, c.fromHeight / 2, 1, c.type, flat));
+        return fb;
+    }
+
+    //
+    //  Largest difference between matching values of two images of the
+    //  same structure or from 0.25 if b is null
+    //
+
+    double difference(const FrameBuffer* a, const FrameBuffer* b)
+    {
+        double e = 0;
+
+        for (; a; a = a->nextPlane(), b = b ? b->nextPlane() : 0)
+        {
+            const size_t n = size_t(a->width()) * a->numChannels();
+
+            for (int y = 0; y < a->height(); y++)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const double v = b ? value(b, y, i) : 0.25;
+                    e = std::max(e, std::fabs(value(a, y, i) - v));
+                }
+            }
+        }
+
+        return e;
+    }
+
+} // namespace
+
+bool TestResize()
+{
+    using namespace TwkFB;
+
+    const SIMD::Level detected = SIMD::detectedLevel();
+    bool ok = true;
+
+    printf("Test TestResize (%s)\n", SIMD::levelName(detected));
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(Case); i++)
+    {
+        const Case& c = cases[i];
+        FrameBuffer* in = newSource(c, false);
+        FrameBuffer* flatIn = newSource(c, true);
+
+        for (size_t f = 0; f < sizeof(filters) / sizeof(ResizeFilter); f++)
+        {
+            const ResizeFilter filter = filters[f];
+
+            SIMD::setLevel(SIMD::Scalar);
+            FrameBuffer* reference = filteredResize(in, c.toWidth, c.toHeight, filter);
+            SIMD::setLevel(detected);
+
+            FrameBuffer* out = 0;
+            TwkUtil::Timer timer(true);
+
+            for (size_t t = 0; t < tryCount; t++)
+            {
+                delete out;
+                out = filteredResize(in, c.toWidth, c.toHeight, filter);
+            }
+
+            const double seconds = timer.elapsed() / tryCount;
+            const double mpixels = double(c.fromWidth) * c.fromHeight / seconds / 1e6;
+
+            FrameBuffer* flatOut = filteredResize(flatIn, c.toWidth, c.toHeight, filter);
+
+            //
+            //  Half has 11 bits, the others are within float rounding of
+            //  the scalar passes
+            //
+
+            const double tolerance = c.type == FrameBuffer::HALF ? 2e-3 : 1e-4;
+            const double flatError = difference(flatOut, 0);
+            const double simdError = difference(reference, out);
+            const bool agrees = flatError <= tolerance && simdError <= tolerance;
+
+            printf("%-24s %-9s %f sec/frame (%.0f Mpixel/s, flat err %g, simd err %g)%s\n", c.name, resizeFilterName(filter), seconds,
+                   mpixels, flatError, simdError, agrees ? "" : " MISMATCH");
+
+            ok = ok && agrees;
+
+            delete flatOut;
+            delete out;
+            delete reference;
+        }
+
+        delete flatIn;
+        delete in;
+    }
+
+    return ok;
+}
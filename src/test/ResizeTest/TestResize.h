@@ -0,0 +1,14 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Measures the throughput of the TwkFB resize filters going from 8K
+//  to 2K and from 4K to HD for RGBA float and half and 4:2:0 planar
+//  images, and checks that a flat image stays flat and that the SIMD
+//  results agree with the scalar ones. Returns false if not.
+//
+
+bool TestResize();
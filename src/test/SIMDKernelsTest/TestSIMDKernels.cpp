@@ -0,0 +1,242 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestSIMDKernels.h>
+
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/Operations.h>
+#include <TwkFB/SIMDKernels.h>
+#include <TwkMath/Mat44.h>
+#include <TwkUtil/Timer.h>
+#include <half.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    using namespace TwkFB;
+    using namespace TwkMath;
+
+    const int width = 3840;
+    const int height = 2160;
+    const size_t tryCount = 10;
+
+    enum Mode
+    {
+        Convert,
+        Transform,
+        Resample
+    };
+
+    struct Op
+    {
+        const char* name;
+        Mode mode;
+        FrameBuffer::DataType from;
+        FrameBuffer::DataType to;
+        ColorTransformFunc func;
+        void* data;
+    };
+
+    bool rgbMask[4] = {true, true, true, false};
+    float gammas[4] = {2.2f, 2.2f, 2.2f, 1.0f};
+    Mat44f matrix(0.4124f, 0.3576f, 0.1805f, 0.0f, 0.2126f, 0.7152f, 0.0722f, 0.0f, 0.0193f, 0.1192f, 0.9505f, 0.0f, 0.0f, 0.0f, 0.0f,
+                  1.0f);
+
+    Op ops[] = {
+        {"copyConvert uchar -> float", Convert, FrameBuffer::UCHAR, FrameBuffer::FLOAT, 0, 0},
+        {"copyConvert ushort -> half", Convert, FrameBuffer::USHORT, FrameBuffer::HALF, 0, 0},
+        {"copyConvert half -> float", Convert, FrameBuffer::HALF, FrameBuffer::FLOAT, 0, 0},
+        {"copyConvert float -> half", Convert, FrameBuffer::FLOAT, FrameBuffer::HALF, 0, 0},
+        {"copyConvert float -> uchar", Convert, FrameBuffer::FLOAT, FrameBuffer::UCHAR, 0, 0},
+        {"copyConvert half -> ushort", Convert, FrameBuffer::HALF, FrameBuffer::USHORT, 0, 0},
+        {"resample float -> ushort", Resample, FrameBuffer::FLOAT, FrameBuffer::USHORT, 0, 0},
+        {"sRGBtoLinear float -> float", Transform, FrameBuffer::FLOAT, FrameBuffer::FLOAT, sRGBtoLinearTransform, rgbMask},
+        {"linearToSRGB float -> uchar", Transform, FrameBuffer::FLOAT, FrameBuffer::UCHAR, linearToSRGBTransform, rgbMask},
+        {"Rec709toLinear half -> half", Transform, FrameBuffer::HALF, FrameBuffer::HALF, Rec709toLinearTransform, rgbMask},
+        {"logLinear ushort -> float", Transform, FrameBuffer::USHORT, FrameBuffer::FLOAT, logLinearTransform, rgbMask},
+        {"linearLog float -> ushort", Transform, FrameBuffer::FLOAT, FrameBuffer::USHORT, linearLogTransform, rgbMask},
+        {"gamma float -> float", Transform, FrameBuffer::FLOAT, FrameBuffer::FLOAT, gammaTransform, gammas},
+        {"linearColor float -> float", Transform, FrameBuffer::FLOAT, FrameBuffer::FLOAT, linearColorTransform, &matrix},
+        {"premult half -> half", Transform, FrameBuffer::HALF, FrameBuffer::HALF, premultTransform, 0},
+    };
+
+    //
+    //  A bit of everything: mostly [0, 1] with some values below 0
+    //  and above 1 like a scene referred image.
+    //
+
+    float sourceValue(size_t i) { return float((i * 7919) % 1000) / 900.0f - 0.05f; }
+
+    FrameBuffer* newSource(FrameBuffer::DataType type)
+    {
+        FrameBuffer* fb = new FrameBuffer(width, height, 4, type);
+        const size_t n = size_t(width) * height * 4;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const float v = sourceValue(i);
+
+            switch (type)
+            {
+            case FrameBuffer::UCHAR:
+                fb->pixels<unsigned char>()[i] = (unsigned char)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f);
+                break;
+            case FrameBuffer::USHORT:
+                fb->pixels<unsigned short>()[i] = (unsigned short)(std::min(std::max(v, 0.0f), 1.0f) * 65535.0f);
+                break;
+            case FrameBuffer::HALF:
+                fb->pixels<half>()[i] = half(v);
+                break;
+            default:
+                fb->pixels<float>()[i] = v;
+                break;
+            }
+        }
+
+        return fb;
+    }
+
+    float value(const FrameBuffer* fb, size_t i)
+    {
+        switch (fb->dataType())
+        {
+        case FrameBuffer::UCHAR:
+            return fb->pixels<unsigned char>()[i] / 255.0f;
+        case FrameBuffer::USHORT:
+            return fb->pixels<unsigned short>()[i] / 65535.0f;
+        case FrameBuffer::HALF:
+            return fb->pixels<half>()[i];
+        default:
+            return fb->pixels<float>()[i];
+        }
+    }
+
+    //
+    //  Integers can be off by one (the scalar paths truncate in some
+    //  places), floating values by about a unit in the last place.
+    //
+
+    bool agree(const FrameBuffer* a, const FrameBuffer* b, double& maxError)
+    {
+        const size_t n = size_t(width) * height * 4;
+        bool ok = true;
+        maxError = 0;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const double x = value(a, i);
+            const double y = value(b, i);
+
+            if (std::isnan(x) || std::isnan(y))
+            {
+                ok = ok && std::isnan(x) && std::isnan(y);
+                continue;
+            }
+
+            double e = std::fabs(x - y);
+            double tolerance = 0;
+
+            switch (a->dataType())
+            {
+            case FrameBuffer::UCHAR:
+                tolerance = 1.0 / 255.0 + 1e-6;
+                break;
+            case FrameBuffer::USHORT:
+                tolerance = 1.0 / 65535.0 + 1e-7;
+                break;
+            case FrameBuffer::HALF:
+                tolerance = std::max(std::fabs(x), 1e-3) * 2e-3;
+                e = e / tolerance * 2e-3;
+                break;
+            default:
+                tolerance = std::max(std::fabs(x), 1e-3) * 1e-5;
+                e = e / tolerance * 1e-5;
+                break;
+            }
+
+            ok = ok && std::fabs(x - y) <= tolerance;
+            maxError = std::max(maxError, e);
+        }
+
+        return ok;
+    }
+
+    FrameBuffer* run(const Op& op, const FrameBuffer* in, double& seconds)
+    {
+        FrameBuffer* out = 0;
+        TwkUtil::Timer timer(true);
+
+        for (size_t i = 0; i < tryCount; i++)
+        {
+            delete out;
+
+            if (op.mode == Convert)
+            {
+                out = copyConvert(in, op.to);
+                continue;
+            }
+
+            out = new FrameBuffer(width, height, 4, op.to);
+
+            if (op.mode == Resample)
+                resample(in, out);
+            else
+                applyTransform(in, out, op.func, op.data);
+        }
+
+        seconds = timer.elapsed() / tryCount;
+        return out;
+    }
+
+} // namespace
+
+bool TestSIMDKernels()
+{
+    using namespace TwkFB;
+
+    const SIMD::Level detected = SIMD::detectedLevel();
+    bool ok = true;
+
+    printf("Test TestSIMDKernels (%s)\n", SIMD::levelName(detected));
+
+    for (size_t i = 0; i < sizeof(ops) / sizeof(Op); i++)
+    {
+        const Op& op = ops[i];
+        FrameBuffer* in = newSource(op.from);
+
+        SIMD::setLevel(SIMD::Scalar);
+        double scalarTime = 0;
+        FrameBuffer* reference = run(op, in, scalarTime);
+
+        printf("%-30s scalar: %f sec/frame", op.name, scalarTime);
+
+        for (int level = SIMD::SSE41; level <= detected; level++)
+        {
+            SIMD::setLevel(SIMD::Level(level));
+            double time = 0;
+            double maxError = 0;
+            FrameBuffer* out = run(op, in, time);
+            const bool agrees = agree(reference, out, maxError);
+
+            printf("  %s: %f sec/frame (x%.1f, max err %g)%s", SIMD::levelName(SIMD::Level(level)), time, scalarTime / time, maxError,
+                   agrees ? "" : " MISMATCH");
+
+            ok = ok && agrees;
+            delete out;
+        }
+
+        printf("\n");
+
+        delete reference;
+        delete in;
+    }
+
+    SIMD::setLevel(detected);
+    return ok;
+}
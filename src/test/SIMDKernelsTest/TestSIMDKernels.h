@@ -0,0 +1,13 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Times the TwkFB conversions and transforms at each SIMD level the
+//  CPU has against the scalar ones and checks they agree. Returns
+//  false if they don't.
+//
+
+bool TestSIMDKernels();
@@ -0,0 +1,210 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestThreadPool.h>
+
+#include <TwkFB/TwkFBThreadPool.h>
+
+#include <IlmThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace TwkFB;
+
+    //
+    //  Each index of an outer range and of the inner ranges started
+    //  from it is run exactly once, from several threads at a time
+    //
+
+    bool runsNested()
+    {
+        const size_t numCallers = 4;
+        const size_t outer = 512;
+        const size_t inner = 64;
+        std::atomic<size_t> bad(0);
+        std::vector<std::thread> callers;
+
+        for (size_t t = 0; t < numCallers; t++)
+        {
+            callers.emplace_back(
+                [&]
+                {
+                    for (int pass = 0; pass < 20; pass++)
+                    {
+                        std::vector<std::atomic<int>> counts(outer * inner);
+
+                        for (size_t i = 0; i < counts.size(); i++)
+                            counts[i] = 0;
+
+                        ThreadPool::parallelFor(0, outer, 8,
+                                                [&](size_t b, size_t e)
+                                                {
+                                                    for (size_t i = b; i < e; i++)
+                                                    {
+                                                        ThreadPool::parallelFor(0, inner, 4,
+                                                                                [&](size_t ib, size_t ie)
+                                                                                {
+                                                                                    for (size_t j = ib; j < ie; j++)
+                                                                                        counts[i * inner + j]++;
+                                                                                });
+                                                    }
+                                                });
+
+                        for (size_t i = 0; i < counts.size(); i++)
+                        {
+                            if (counts[i] != 1)
+                                bad++;
+                        }
+                    }
+                });
+        }
+
+        for (size_t t = 0; t < callers.size(); t++)
+            callers[t].join();
+
+        if (bad)
+        {
+            printf("nested parallelFor ran %d indices other than once\n", int(bad));
+            return false;
+        }
+
+        return true;
+    }
+
+    bool propagatesExceptions()
+    {
+        const size_t n = 1000;
+        std::atomic<size_t> ran(0);
+        bool caught = false;
+
+        try
+        {
+            ThreadPool::parallelFor(0, n, 10,
+                                    [&](size_t b, size_t e)
+                                    {
+                                        ran += e - b;
+                                        if (b <= n / 2 && n / 2 < e)
+                                            throw std::runtime_error("range failed");
+                                    });
+        }
+        catch (std::runtime_error&)
+        {
+            caught = true;
+        }
+
+        if (!caught || ran != n)
+        {
+            printf("parallelFor %s the exception after running %d of %d\n", caught ? "rethrew" : "didn't rethrow", int(ran.load()),
+                   int(n));
+            return false;
+        }
+
+        return true;
+    }
+
+    class CountTask : public ILMTHREAD_NAMESPACE::Task
+    {
+    public:
+        CountTask(ILMTHREAD_NAMESPACE::TaskGroup* group, std::atomic<size_t>& count)
+            : ILMTHREAD_NAMESPACE::Task(group)
+            , m_count(count)
+        {
+        }
+
+        virtual void execute()
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            m_count++;
+        }
+
+    private:
+        std::atomic<size_t>& m_count;
+    };
+
+    //
+    //  Everything queued when shutdown() is called has run when it
+    //  returns, everything after runs inline
+    //
+
+    bool shutsDown()
+    {
+        const size_t n = 200;
+        std::atomic<size_t> count(0);
+        bool ok = true;
+
+        {
+            ILMTHREAD_NAMESPACE::TaskGroup group;
+
+            for (size_t i = 0; i < n; i++)
+                ThreadPool::addTask(new CountTask(&group, count));
+
+            ThreadPool::shutdown();
+
+            if (count != n)
+            {
+                printf("shutdown left %d of %d tasks\n", int(n - count), int(n));
+                ok = false;
+            }
+        }
+
+        ThreadPool::resetStats();
+
+        {
+            ILMTHREAD_NAMESPACE::TaskGroup group;
+            ThreadPool::addTask(new CountTask(&group, count));
+        }
+
+        std::vector<int> values(100, 0);
+        ThreadPool::parallelFor(0, values.size(), 1,
+                                [&](size_t b, size_t e)
+                                {
+                                    for (size_t i = b; i < e; i++)
+                                        values[i]++;
+                                });
+
+        const ThreadPool::SubsystemStats stats = ThreadPool::stats(ThreadPool::TwkFBSubsystem);
+
+        if (count != n + 1 || stats.tasks != 0 || stats.inlineTasks == 0)
+        {
+            printf("after shutdown %d tasks ran on workers and %d inline\n", int(stats.tasks), int(stats.inlineTasks));
+            ok = false;
+        }
+
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (values[i] != 1)
+            {
+                printf("parallelFor after shutdown ran index %d %d times\n", int(i), values[i]);
+                ok = false;
+                break;
+            }
+        }
+
+        return ok;
+    }
+
+} // namespace
+
+bool TestThreadPool()
+{
+    printf("Test TestThreadPool\n");
+
+    ThreadPool::initialize();
+    ThreadPool::setNumThreads(4);
+
+    bool ok = runsNested();
+    ok = propagatesExceptions() && ok;
+    ok = shutsDown() && ok;
+
+    return ok;
+}
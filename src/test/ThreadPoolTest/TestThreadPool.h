@@ -0,0 +1,14 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Checks the TwkFB decode pool: parallelFor (nested and from several
+//  threads) runs each index once, rethrows the first exception after
+//  every range has run, and shutdown() runs the queued tasks with
+//  later ones run inline. Returns false if anything differs.
+//
+
+bool TestThreadPool();
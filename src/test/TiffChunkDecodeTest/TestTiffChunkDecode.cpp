@@ -0,0 +1,503 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestTiffChunkDecode.h>
+
+#include <IOtiff/IOtiff.h>
+#include <IOtiff/TiffChunkDecoder.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <TwkUtil/Timer.h>
+
+#include <tiffio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using namespace TwkFB;
+
+    const uint32_t width = 2048;
+    const uint32_t height = 512;
+    const uint32_t rowsPerStrip = 16;
+    const uint32_t tileSize = 128;
+    const char* filename = "TestTiffChunkDecode.tif";
+
+    struct Compression
+    {
+        const char* name;
+        unsigned short tag;
+        bool predicts;
+    };
+
+    Compression compressions[] = {
+        {"none", COMPRESSION_NONE, false},
+        {"LZW", COMPRESSION_LZW, true},
+        {"deflate", COMPRESSION_ADOBE_DEFLATE, true},
+        {"PackBits", COMPRESSION_PACKBITS, false},
+    };
+
+    //
+    //  Smooth with a little noise, like a scan
+    //
+
+    void fillImage(std::vector<unsigned char>& pixels, int bits, bool floating)
+    {
+        const size_t n = pixels.size() / (bits / 8);
+        uint32_t seed = 1;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const double v = 0.5 + 0.4 * std::sin(double(i) * 0.0007) + double(seed >> 28) / 4096.0;
+
+            if (bits == 8)
+                pixels[i] = (unsigned char)(v * 255.0);
+            else if (bits == 16)
+                reinterpret_cast<uint16_t*>(&pixels[0])[i] = uint16_t(v * 65535.0);
+            else if (floating)
+                reinterpret_cast<float*>(&pixels[0])[i] = float(v);
+            else
+                reinterpret_cast<uint32_t*>(&pixels[0])[i] = uint32_t(v * 4e9);
+        }
+    }
+
+    bool writeImage(const Compression& c, unsigned short predictor, int bits, int spp, bool bigEndian, bool tiled)
+    {
+        TIFF* tif = TIFFOpen(filename, bigEndian ? "wb" : "wl");
+
+        if (!tif)
+            return false;
+
+        TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
+        TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
+        TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bits);
+        TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, spp);
+        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, spp == 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK);
+        TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+        TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, predictor == PREDICTOR_FLOATINGPOINT ? SAMPLEFORMAT_IEEEFP : SAMPLEFORMAT_UINT);
+        TIFFSetField(tif, TIFFTAG_COMPRESSION, c.tag);
+
+        if (c.predicts)
+            TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+
+        std::vector<unsigned char> pixels(size_t(width) * height * spp * bits / 8);
+        fillImage(pixels, bits, predictor == PREDICTOR_FLOATINGPOINT);
+
+        const size_t rowBytes = size_t(width) * spp * bits / 8;
+        bool ok = true;
+
+        if (tiled)
+        {
+            TIFFSetField(tif, TIFFTAG_TILEWIDTH, tileSize);
+            TIFFSetField(tif, TIFFTAG_TILELENGTH, tileSize);
+
+            const size_t tileRowBytes = size_t(tileSize) * spp * bits / 8;
+            std::vector<unsigned char> tile(tileRowBytes * tileSize);
+
+            for (uint32_t y = 0; ok && y < height; y += tileSize)
+            {
+                for (uint32_t x = 0; ok && x < width; x += tileSize)
+                {
+                    for (uint32_t r = 0; r < tileSize; r++)
+                    {
+                        memcpy(&tile[r * tileRowBytes], &pixels[(y + r) * rowBytes + x * spp * bits / 8], tileRowBytes);
+                    }
+
+                    ok = TIFFWriteTile(tif, &tile[0], x, y, 0, 0) >= 0;
+                }
+            }
+        }
+        else
+        {
+            TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+
+            for (uint32_t s = 0; ok && s < height / rowsPerStrip; s++)
+            {
+                ok = TIFFWriteEncodedStrip(tif, s, &pixels[s * rowsPerStrip * rowBytes], rowsPerStrip * rowBytes) >= 0;
+            }
+        }
+
+        TIFFClose(tif);
+        return ok;
+    }
+
+    //
+    //  Decodes the image both ways, returns false if they differ
+    //
+
+    bool compare(TiffChunkFormat format, bool tiled, double& libtiffSeconds, double& poolSeconds)
+    {
+        TIFF* tif = TIFFOpen(filename, "r");
+
+        if (!tif)
+            return false;
+
+        format.byteSwapped = TIFFIsByteSwapped(tif) != 0;
+
+        const uint32_t chunks = tiled ? TIFFNumberOfTiles(tif) : TIFFNumberOfStrips(tif);
+        const size_t chunkSize = tiled ? TIFFTileSize(tif) : TIFFStripSize(tif);
+        const size_t rowBytes = tiled ? TIFFTileRowSize(tif) : TIFFScanlineSize(tif);
+        const size_t rows = tiled ? tileSize : rowsPerStrip;
+
+        std::vector<std::vector<unsigned char>> raw(chunks);
+        std::vector<unsigned char> reference(chunkSize * chunks);
+        std::vector<unsigned char> decoded(chunkSize * chunks);
+
+        for (uint32_t i = 0; i < chunks; i++)
+        {
+            raw[i].resize(TIFFGetStrileByteCount(tif, i));
+
+            if (tiled)
+                TIFFReadRawTile(tif, i, &raw[i][0], raw[i].size());
+            else
+                TIFFReadRawStrip(tif, i, &raw[i][0], raw[i].size());
+        }
+
+        TwkUtil::Timer timer(true);
+
+        for (uint32_t i = 0; i < chunks; i++)
+        {
+            if (tiled)
+                TIFFReadEncodedTile(tif, i, &reference[i * chunkSize], chunkSize);
+            else
+                TIFFReadEncodedStrip(tif, i, &reference[i * chunkSize], chunkSize);
+        }
+
+        libtiffSeconds = timer.elapsed();
+        TIFFClose(tif);
+
+        std::atomic<bool> ok(true);
+        timer.start();
+
+        ThreadPool::parallelFor(0, chunks, 1,
+                                [&](size_t b, size_t e)
+                                {
+                                    for (size_t i = b; i < e; i++)
+                                    {
+                                        if (!decodeTiffChunk(format, &raw[i][0], raw[i].size(), &decoded[i * chunkSize], rowBytes, rows))
+                                            ok = false;
+                                    }
+                                });
+
+        poolSeconds = timer.elapsed();
+
+        return ok && decoded == reference;
+    }
+
+    //
+    //  Odd sizes so the last strip and the last row and column of
+    //  tiles are partial
+    //
+
+    const uint32_t placementWidth = 301;
+    const uint32_t placementHeight = 203;
+    const uint32_t placementTileSize = 64;
+
+    struct Placement
+    {
+        const char* name;
+        int bits;
+        int spp;
+        bool separate;
+        bool tiled;
+        unsigned short orientation;
+        bool region;
+    };
+
+    unsigned int sampleValue(uint32_t x, uint32_t y, int c, int bits)
+    {
+        const unsigned int v = x * 131u + y * 257u + unsigned(c) * 4099u;
+        return bits == 8 ? (v & 0xff) : (v & 0xffff);
+    }
+
+    void storeSample(unsigned char* p, unsigned int v, int bits)
+    {
+        if (bits == 8)
+            *p = (unsigned char)v;
+        else
+            *reinterpret_cast<uint16_t*>(p) = uint16_t(v);
+    }
+
+    bool writePlacementImage(const Placement& pl)
+    {
+        TIFF* tif = TIFFOpen(filename, "w");
+
+        if (!tif)
+            return false;
+
+        TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, placementWidth);
+        TIFFSetField(tif, TIFFTAG_IMAGELENGTH, placementHeight);
+        TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, pl.bits);
+        TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, pl.spp);
+        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+        TIFFSetField(tif, TIFFTAG_PLANARCONFIG, pl.separate ? PLANARCONFIG_SEPARATE : PLANARCONFIG_CONTIG);
+        TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, SAMPLEFORMAT_UINT);
+        TIFFSetField(tif, TIFFTAG_ORIENTATION, pl.orientation);
+        TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+
+        const int bytes = pl.bits / 8;
+        const int planes = pl.separate ? pl.spp : 1;
+        const int interleaved = pl.separate ? 1 : pl.spp;
+        bool ok = true;
+
+        if (pl.tiled)
+        {
+            TIFFSetField(tif, TIFFTAG_TILEWIDTH, placementTileSize);
+            TIFFSetField(tif, TIFFTAG_TILELENGTH, placementTileSize);
+
+            std::vector<unsigned char> tile(size_t(placementTileSize) * placementTileSize * interleaved * bytes);
+
+            for (int p = 0; ok && p < planes; p++)
+            {
+                for (uint32_t ty = 0; ok && ty < placementHeight; ty += placementTileSize)
+                {
+                    for (uint32_t tx = 0; ok && tx < placementWidth; tx += placementTileSize)
+                    {
+                        std::fill(tile.begin(), tile.end(), 0);
+
+                        for (uint32_t y = ty; y < ty + placementTileSize && y < placementHeight; y++)
+                        {
+                            for (uint32_t x = tx; x < tx + placementTileSize && x < placementWidth; x++)
+                            {
+                                for (int c = 0; c < interleaved; c++)
+                                {
+                                    const size_t i = ((y - ty) * placementTileSize + (x - tx)) * interleaved + c;
+                                    storeSample(&tile[i * bytes], sampleValue(x, y, p + c, pl.bits), pl.bits);
+                                }
+                            }
+                        }
+
+                        ok = TIFFWriteTile(tif, &tile[0], tx, ty, 0, p) >= 0;
+                    }
+                }
+            }
+        }
+        else
+        {
+            TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+
+            std::vector<unsigned char> row(size_t(placementWidth) * interleaved * bytes);
+
+            for (int p = 0; ok && p < planes; p++)
+            {
+                for (uint32_t y = 0; ok && y < placementHeight; y++)
+                {
+                    for (uint32_t x = 0; x < placementWidth; x++)
+                    {
+                        for (int c = 0; c < interleaved; c++)
+                            storeSample(&row[(x * interleaved + c) * bytes], sampleValue(x, y, p + c, pl.bits), pl.bits);
+                    }
+
+                    ok = TIFFWriteScanline(tif, &row[0], y, p) >= 0;
+                }
+            }
+        }
+
+        TIFFClose(tif);
+        return ok;
+    }
+
+    std::vector<const FrameBuffer*> planesOf(const FrameBuffer& fb)
+    {
+        std::vector<const FrameBuffer*> planes;
+
+        for (const FrameBuffer* p = &fb; p; p = p->nextPlane())
+            planes.push_back(p);
+
+        return planes;
+    }
+
+    //
+    //  a at x, y is b at x + dx, y + dy in every plane
+    //
+
+    bool samePixels(const FrameBuffer& a, const FrameBuffer& b, int dx, int dy)
+    {
+        const std::vector<const FrameBuffer*> ap = planesOf(a);
+        const std::vector<const FrameBuffer*> bp = planesOf(b);
+
+        if (ap.size() != bp.size())
+            return false;
+
+        for (size_t p = 0; p < ap.size(); p++)
+        {
+            if (ap[p]->dataType() != bp[p]->dataType() || ap[p]->numChannels() != bp[p]->numChannels()
+                || ap[p]->width() + dx > bp[p]->width() || ap[p]->height() + dy > bp[p]->height())
+            {
+                return false;
+            }
+
+            const size_t rowBytes = size_t(ap[p]->width()) * ap[p]->pixelSize();
+
+            for (int y = 0; y < ap[p]->height(); y++)
+            {
+                if (memcmp(&ap[p]->pixel<unsigned char>(0, y), &bp[p]->pixel<unsigned char>(dx, y + dy), rowBytes))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    //
+    //  The chunked read of each layout lands where the serial readers
+    //  put it: same structure, orientation, uncrop and pixels
+    //
+
+    bool matchesSerialPlacement()
+    {
+        const Placement placements[] = {
+            {"strips top left", 8, 3, false, false, ORIENTATION_TOPLEFT, false},
+            {"strips bottom left", 8, 3, false, false, ORIENTATION_BOTLEFT, false},
+            {"strips top right", 8, 3, false, false, ORIENTATION_TOPRIGHT, false},
+            {"strips separate", 8, 3, true, false, ORIENTATION_TOPLEFT, false},
+            {"strips 16 bit as planes", 16, 3, false, false, ORIENTATION_TOPLEFT, false},
+            {"tiles top left", 8, 4, false, true, ORIENTATION_TOPLEFT, false},
+            {"tiles bottom right", 8, 4, false, true, ORIENTATION_BOTRIGHT, false},
+            {"tiles separate", 16, 3, true, true, ORIENTATION_TOPLEFT, false},
+            {"tiles region", 8, 3, false, true, ORIENTATION_TOPLEFT, true},
+            {"tiles separate region", 8, 3, true, true, ORIENTATION_TOPLEFT, true},
+        };
+
+        bool ok = true;
+
+        for (size_t i = 0; i < sizeof(placements) / sizeof(Placement); i++)
+        {
+            const Placement& pl = placements[i];
+
+            if (!writePlacementImage(pl))
+            {
+                printf("ERROR: couldn't write %s %s\n", pl.name, filename);
+                ok = false;
+                continue;
+            }
+
+            IOtiff io;
+            FrameBufferIO::ReadRequest request;
+
+            if (pl.region)
+            {
+                request.x0 = 70;
+                request.y0 = 100;
+                request.x1 = 200;
+                request.y1 = 203;
+            }
+
+            FrameBuffer serial;
+            io.readImage(serial, filename, request);
+
+            request.parallelDecode = true;
+            ThreadPool::resetStats();
+
+            FrameBuffer chunked;
+            io.readImage(chunked, filename, request);
+
+            const ThreadPool::SubsystemStats stats = ThreadPool::stats(ThreadPool::TwkFBSubsystem);
+
+            if (stats.tasks + stats.inlineTasks == 0)
+            {
+                printf("%s: chunks weren't decoded on the pool\n", pl.name);
+                ok = false;
+            }
+
+            if (chunked.width() != serial.width() || chunked.height() != serial.height() || chunked.orientation() != serial.orientation()
+                || chunked.uncropWidth() != serial.uncropWidth() || chunked.uncropHeight() != serial.uncropHeight()
+                || chunked.uncropX() != serial.uncropX() || chunked.uncropY() != serial.uncropY() || !samePixels(chunked, serial, 0, 0))
+            {
+                printf("%s: chunked read is %dx%d orientation %d, serial %dx%d orientation %d MISMATCH\n", pl.name, chunked.width(),
+                       chunked.height(), int(chunked.orientation()), serial.width(), serial.height(), int(serial.orientation()));
+                ok = false;
+                continue;
+            }
+
+            if (pl.region)
+            {
+                FrameBuffer whole;
+                io.readImage(whole, filename, FrameBufferIO::ReadRequest());
+
+                if (chunked.width() >= whole.width() || chunked.uncropWidth() != whole.width()
+                    || !samePixels(chunked, whole, chunked.uncropX(), chunked.uncropY()))
+                {
+                    printf("%s: region at %d,%d doesn't match the whole image\n", pl.name, chunked.uncropX(), chunked.uncropY());
+                    ok = false;
+                }
+            }
+        }
+
+        return ok;
+    }
+
+} // namespace
+
+bool TestTiffChunkDecode()
+{
+    bool ok = true;
+
+    printf("Test TestTiffChunkDecode\n");
+
+    TIFFSetWarningHandler(0);
+    ThreadPool::initialize();
+    ThreadPool::setNumThreads(4);
+
+    const unsigned short predictors[] = {PREDICTOR_NONE, PREDICTOR_HORIZONTAL, PREDICTOR_FLOATINGPOINT};
+    const int sampleBits[] = {8, 16, 32};
+    const int sampleCounts[] = {1, 3};
+
+    for (size_t c = 0; c < sizeof(compressions) / sizeof(Compression); c++)
+    {
+        for (size_t p = 0; p < 3; p++)
+        {
+            if (p > 0 && !compressions[c].predicts)
+                continue;
+
+            for (size_t b = 0; b < 3; b++)
+            {
+                for (size_t s = 0; s < 2; s++)
+                {
+                    for (int layout = 0; layout < 4; layout++)
+                    {
+                        const bool tiled = layout & 1;
+                        const bool bigEndian = (layout & 2) != 0;
+                        const TiffChunkFormat format = {compressions[c].tag, predictors[p], sampleBits[b], sampleCounts[s], false};
+
+                        if (!canDecodeTiffChunk(format))
+                            continue;
+
+                        if (!writeImage(compressions[c], predictors[p], sampleBits[b], sampleCounts[s], bigEndian, tiled))
+                        {
+                            printf("ERROR: couldn't write %s\n", filename);
+                            ok = false;
+                            continue;
+                        }
+
+                        double libtiffSeconds = 0;
+                        double poolSeconds = 0;
+                        const bool agrees = compare(format, tiled, libtiffSeconds, poolSeconds);
+
+                        printf("%-8s predictor %d %2d bit x %d %-6s %-10s libtiff %f pool %f sec%s\n", compressions[c].name,
+                               int(predictors[p]), sampleBits[b], sampleCounts[s], tiled ? "tiles" : "strips",
+                               bigEndian ? "big endian" : "little", libtiffSeconds, poolSeconds, agrees ? "" : " MISMATCH");
+
+                        ok = ok && agrees;
+                    }
+                }
+            }
+        }
+    }
+
+    ok = matchesSerialPlacement() && ok;
+
+    remove(filename);
+    ThreadPool::shutdown();
+
+    return ok;
+}
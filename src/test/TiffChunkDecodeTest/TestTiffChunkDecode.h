@@ -0,0 +1,18 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Writes striped and tiled TIFFs with each compression, predictor,
+//  sample size and byte order TiffChunkDecoder.h handles and checks
+//  that decoding their raw chunks gives what libtiff does. Prints how
+//  long libtiff takes to decode them one after the other and how long
+//  decoding them on the TwkFB::ThreadPool takes. Then checks IOtiff's
+//  chunked reads land where its serial readers put them for each
+//  orientation, planar layout, region and partial last strip or tile.
+//  Returns false if anything differs.
+//
+
+bool TestTiffChunkDecode();
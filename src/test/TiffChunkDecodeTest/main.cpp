@@ -0,0 +1,9 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <TestTiffChunkDecode.h>
+
+int main(int argc, char* argv[]) { return TestTiffChunkDecode() ? 0 : 1; }